@@ -6,6 +6,14 @@ dnl Function to detect if libqcow dependencies are available
 AC_DEFUN([AX_LIBQCOW_CHECK_LOCAL],
   [dnl Check for internationalization functions in libqcow/libqcow_i18n.c
   AC_CHECK_FUNCS([bindtextdomain])
+
+  dnl Check for headers and functions used by the mapping index in libqcow/libqcow_mapping_index.c
+  AC_CHECK_HEADERS([fcntl.h sys/mman.h sys/stat.h unistd.h])
+  AC_CHECK_FUNCS([fstat mmap munmap rename stat])
+  AC_CHECK_MEMBERS([struct stat.st_mtim.tv_nsec, struct stat.st_mtimespec.tv_nsec],,,[#include <sys/stat.h>])
+
+  dnl Check for headers and functions used by the read deadlines in libqcow/libqcow_read_control.c
+  AC_CHECK_FUNCS([clock_gettime time])
 ])
 
 dnl Function to check if DLL support is needed
@@ -0,0 +1,2189 @@
+/*
+ * Cache pool functions
+ *
+ * Copyright (C) 2010-2026, Joachim Metz <joachim.metz@gmail.com>
+ *
+ * Refer to AUTHORS for acknowledgements.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <common.h>
+#include <memory.h>
+#include <types.h>
+
+#if defined( HAVE_SYS_STAT_H )
+#include <sys/stat.h>
+#endif
+
+#include "libqcow_cache_pool.h"
+#include "libqcow_cluster_block.h"
+#include "libqcow_definitions.h"
+#include "libqcow_libcerror.h"
+#include "libqcow_libcthreads.h"
+#include "libqcow_types.h"
+
+
+/* Creates a cache pool shard
+ * Make sure the value cache_pool_shard is referencing, is set to NULL
+ * The maximum size is the size of the memory the cached values of the shard can use
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_cache_pool_shard_initialize(
+     libqcow_cache_pool_shard_t **cache_pool_shard,
+     size64_t maximum_size,
+     libcerror_error_t **error )
+{
+	libqcow_cache_pool_shard_t *safe_cache_pool_shard = NULL;
+	static char *function                             = "libqcow_cache_pool_shard_initialize";
+	size64_t number_of_buckets                        = 0;
+	size_t buckets_size                               = 0;
+
+	if( cache_pool_shard == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid cache pool shard.",
+		 function );
+
+		return( -1 );
+	}
+	if( *cache_pool_shard != NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_ALREADY_SET,
+		 "%s: invalid cache pool shard value already set.",
+		 function );
+
+		return( -1 );
+	}
+	safe_cache_pool_shard = memory_allocate_structure(
+	                         libqcow_cache_pool_shard_t );
+
+	if( safe_cache_pool_shard == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_INSUFFICIENT,
+		 "%s: unable to create cache pool shard.",
+		 function );
+
+		goto on_error;
+	}
+	if( memory_set(
+	     safe_cache_pool_shard,
+	     0,
+	     sizeof( libqcow_cache_pool_shard_t ) ) == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_SET_FAILED,
+		 "%s: unable to clear cache pool shard.",
+		 function );
+
+		memory_free(
+		 safe_cache_pool_shard );
+
+		return( -1 );
+	}
+	/* Use about a bucket per 64 KiB cluster block that fits in the shard
+	 */
+	number_of_buckets = maximum_size / 65536;
+
+	if( number_of_buckets < LIBQCOW_CACHE_POOL_MINIMUM_NUMBER_OF_BUCKETS )
+	{
+		number_of_buckets = LIBQCOW_CACHE_POOL_MINIMUM_NUMBER_OF_BUCKETS;
+	}
+	else if( number_of_buckets > LIBQCOW_CACHE_POOL_MAXIMUM_NUMBER_OF_BUCKETS )
+	{
+		number_of_buckets = LIBQCOW_CACHE_POOL_MAXIMUM_NUMBER_OF_BUCKETS;
+	}
+	buckets_size = sizeof( libqcow_cache_pool_entry_t * ) * (size_t) number_of_buckets;
+
+	safe_cache_pool_shard->buckets = (libqcow_cache_pool_entry_t **) memory_allocate(
+	                                                                  buckets_size );
+
+	if( safe_cache_pool_shard->buckets == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_INSUFFICIENT,
+		 "%s: unable to create buckets.",
+		 function );
+
+		goto on_error;
+	}
+	if( memory_set(
+	     safe_cache_pool_shard->buckets,
+	     0,
+	     buckets_size ) == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_SET_FAILED,
+		 "%s: unable to clear buckets.",
+		 function );
+
+		goto on_error;
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_initialize(
+	     &( safe_cache_pool_shard->read_write_lock ),
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+		 "%s: unable to initialize read/write lock.",
+		 function );
+
+		goto on_error;
+	}
+#endif
+	safe_cache_pool_shard->maximum_size      = maximum_size;
+	safe_cache_pool_shard->number_of_buckets = (int) number_of_buckets;
+
+	*cache_pool_shard = safe_cache_pool_shard;
+
+	return( 1 );
+
+on_error:
+	if( safe_cache_pool_shard != NULL )
+	{
+		if( safe_cache_pool_shard->buckets != NULL )
+		{
+			memory_free(
+			 safe_cache_pool_shard->buckets );
+		}
+		memory_free(
+		 safe_cache_pool_shard );
+	}
+	return( -1 );
+}
+
+/* Frees a cache pool shard and its cached values
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_cache_pool_shard_free(
+     libqcow_cache_pool_shard_t **cache_pool_shard,
+     libcerror_error_t **error )
+{
+	libqcow_cache_pool_entry_t *cache_pool_entry = NULL;
+	libqcow_cache_pool_entry_t *next_entry       = NULL;
+	static char *function                        = "libqcow_cache_pool_shard_free";
+	int result                                   = 1;
+
+	if( cache_pool_shard == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid cache pool shard.",
+		 function );
+
+		return( -1 );
+	}
+	if( *cache_pool_shard != NULL )
+	{
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+		if( libcthreads_read_write_lock_free(
+		     &( ( *cache_pool_shard )->read_write_lock ),
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+			 "%s: unable to free read/write lock.",
+			 function );
+
+			result = -1;
+		}
+#endif
+		cache_pool_entry = ( *cache_pool_shard )->first_entry;
+
+		while( cache_pool_entry != NULL )
+		{
+			next_entry = cache_pool_entry->next_entry;
+
+			if( libqcow_cluster_block_free(
+			     &( cache_pool_entry->cluster_block ),
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+				 "%s: unable to free cluster block.",
+				 function );
+
+				result = -1;
+			}
+			memory_free(
+			 cache_pool_entry );
+
+			cache_pool_entry = next_entry;
+		}
+		memory_free(
+		 ( *cache_pool_shard )->buckets );
+
+		memory_free(
+		 *cache_pool_shard );
+
+		*cache_pool_shard = NULL;
+	}
+	return( result );
+}
+
+/* Retrieves the entry of a value in a specific bucket of the shard
+ * This function is not multi-thread safe acquire write lock of the shard before call
+ * Returns 1 if successful, 0 if no such entry or -1 on error
+ */
+int libqcow_cache_pool_shard_get_entry(
+     libqcow_cache_pool_shard_t *cache_pool_shard,
+     int bucket_index,
+     libqcow_file_identity_t *file_identity,
+     uint8_t value_type,
+     uint64_t offset,
+     libqcow_cache_pool_entry_t **cache_pool_entry,
+     libcerror_error_t **error )
+{
+	libqcow_cache_pool_entry_t *safe_cache_pool_entry = NULL;
+	static char *function                             = "libqcow_cache_pool_shard_get_entry";
+
+	if( cache_pool_shard == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid cache pool shard.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( bucket_index < 0 )
+	 || ( bucket_index >= cache_pool_shard->number_of_buckets ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid bucket index value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	if( file_identity == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file identity.",
+		 function );
+
+		return( -1 );
+	}
+	if( cache_pool_entry == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid cache pool entry.",
+		 function );
+
+		return( -1 );
+	}
+	safe_cache_pool_entry = cache_pool_shard->buckets[ bucket_index ];
+
+	while( safe_cache_pool_entry != NULL )
+	{
+		if( ( safe_cache_pool_entry->offset == offset )
+		 && ( safe_cache_pool_entry->value_type == value_type )
+		 && ( safe_cache_pool_entry->file_identity.inode_number == file_identity->inode_number )
+		 && ( safe_cache_pool_entry->file_identity.device_number == file_identity->device_number )
+		 && ( safe_cache_pool_entry->file_identity.size == file_identity->size ) )
+		{
+			*cache_pool_entry = safe_cache_pool_entry;
+
+			return( 1 );
+		}
+		safe_cache_pool_entry = safe_cache_pool_entry->next_bucket_entry;
+	}
+	return( 0 );
+}
+
+/* Removes an entry from the shard
+ * The cluster block of the entry is freed when it is no longer pinned
+ * This function is not multi-thread safe acquire write lock of the shard before call
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_cache_pool_shard_remove_entry(
+     libqcow_cache_pool_shard_t *cache_pool_shard,
+     libqcow_cache_pool_entry_t *cache_pool_entry,
+     libcerror_error_t **error )
+{
+	libqcow_cache_pool_entry_t *bucket_entry = NULL;
+	static char *function                    = "libqcow_cache_pool_shard_remove_entry";
+	int result                               = 1;
+
+	if( cache_pool_shard == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid cache pool shard.",
+		 function );
+
+		return( -1 );
+	}
+	if( cache_pool_entry == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid cache pool entry.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( cache_pool_entry->bucket_index < 0 )
+	 || ( cache_pool_entry->bucket_index >= cache_pool_shard->number_of_buckets ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid cache pool entry - bucket index value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	if( cache_pool_shard->buckets[ cache_pool_entry->bucket_index ] == cache_pool_entry )
+	{
+		cache_pool_shard->buckets[ cache_pool_entry->bucket_index ] = cache_pool_entry->next_bucket_entry;
+	}
+	else
+	{
+		bucket_entry = cache_pool_shard->buckets[ cache_pool_entry->bucket_index ];
+
+		while( bucket_entry != NULL )
+		{
+			if( bucket_entry->next_bucket_entry == cache_pool_entry )
+			{
+				bucket_entry->next_bucket_entry = cache_pool_entry->next_bucket_entry;
+
+				break;
+			}
+			bucket_entry = bucket_entry->next_bucket_entry;
+		}
+	}
+	if( cache_pool_entry->previous_entry != NULL )
+	{
+		cache_pool_entry->previous_entry->next_entry = cache_pool_entry->next_entry;
+	}
+	else
+	{
+		cache_pool_shard->first_entry = cache_pool_entry->next_entry;
+	}
+	if( cache_pool_entry->next_entry != NULL )
+	{
+		cache_pool_entry->next_entry->previous_entry = cache_pool_entry->previous_entry;
+	}
+	else
+	{
+		cache_pool_shard->last_entry = cache_pool_entry->previous_entry;
+	}
+	cache_pool_shard->size              -= cache_pool_entry->value_size;
+	cache_pool_shard->number_of_entries -= 1;
+
+	if( libqcow_cluster_block_free(
+	     &( cache_pool_entry->cluster_block ),
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+		 "%s: unable to free cluster block.",
+		 function );
+
+		result = -1;
+	}
+	memory_free(
+	 cache_pool_entry );
+
+	return( result );
+}
+
+/* Creates a cache pool
+ * Make sure the value cache_pool is referencing, is set to NULL
+ * The maximum size is the size of the memory the cached values can use
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_cache_pool_initialize(
+     libqcow_cache_pool_t **cache_pool,
+     size64_t maximum_size,
+     libcerror_error_t **error )
+{
+	libqcow_internal_cache_pool_t *internal_cache_pool = NULL;
+	static char *function                              = "libqcow_cache_pool_initialize";
+	size64_t number_of_shards                          = 0;
+	size64_t shard_maximum_size                        = 0;
+	int shard_index                                    = 0;
+
+	if( cache_pool == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid cache pool.",
+		 function );
+
+		return( -1 );
+	}
+	if( *cache_pool != NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_ALREADY_SET,
+		 "%s: invalid cache pool value already set.",
+		 function );
+
+		return( -1 );
+	}
+	if( maximum_size == 0 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_ZERO_OR_LESS,
+		 "%s: invalid maximum size value zero or less.",
+		 function );
+
+		return( -1 );
+	}
+	internal_cache_pool = memory_allocate_structure(
+	                       libqcow_internal_cache_pool_t );
+
+	if( internal_cache_pool == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_INSUFFICIENT,
+		 "%s: unable to create cache pool.",
+		 function );
+
+		goto on_error;
+	}
+	if( memory_set(
+	     internal_cache_pool,
+	     0,
+	     sizeof( libqcow_internal_cache_pool_t ) ) == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_SET_FAILED,
+		 "%s: unable to clear cache pool.",
+		 function );
+
+		memory_free(
+		 internal_cache_pool );
+
+		return( -1 );
+	}
+	/* Every shard evicts within its own part of the maximum size, hence a small
+	 * cache pool is not divided into shards that cannot hold a reasonable number of values
+	 */
+	number_of_shards = maximum_size / LIBQCOW_CACHE_POOL_MINIMUM_SHARD_SIZE;
+
+	if( number_of_shards < 1 )
+	{
+		number_of_shards = 1;
+	}
+	else if( number_of_shards > LIBQCOW_CACHE_POOL_MAXIMUM_NUMBER_OF_SHARDS )
+	{
+		number_of_shards = LIBQCOW_CACHE_POOL_MAXIMUM_NUMBER_OF_SHARDS;
+	}
+	internal_cache_pool->shards = (libqcow_cache_pool_shard_t **) memory_allocate(
+	                                                               sizeof( libqcow_cache_pool_shard_t * ) * (size_t) number_of_shards );
+
+	if( internal_cache_pool->shards == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_INSUFFICIENT,
+		 "%s: unable to create shards.",
+		 function );
+
+		goto on_error;
+	}
+	if( memory_set(
+	     internal_cache_pool->shards,
+	     0,
+	     sizeof( libqcow_cache_pool_shard_t * ) * (size_t) number_of_shards ) == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_SET_FAILED,
+		 "%s: unable to clear shards.",
+		 function );
+
+		memory_free(
+		 internal_cache_pool->shards );
+
+		internal_cache_pool->shards = NULL;
+
+		goto on_error;
+	}
+	internal_cache_pool->number_of_shards = (int) number_of_shards;
+
+	for( shard_index = 0;
+	     shard_index < internal_cache_pool->number_of_shards;
+	     shard_index++ )
+	{
+		/* The last shard contains the remainder of the maximum size
+		 */
+		shard_maximum_size = maximum_size / number_of_shards;
+
+		if( shard_index == ( internal_cache_pool->number_of_shards - 1 ) )
+		{
+			shard_maximum_size += maximum_size % number_of_shards;
+		}
+		if( libqcow_cache_pool_shard_initialize(
+		     &( internal_cache_pool->shards[ shard_index ] ),
+		     shard_maximum_size,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+			 "%s: unable to create shard: %d.",
+			 function,
+			 shard_index );
+
+			goto on_error;
+		}
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_initialize(
+	     &( internal_cache_pool->read_write_lock ),
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+		 "%s: unable to initialize read/write lock.",
+		 function );
+
+		goto on_error;
+	}
+	if( libcthreads_mutex_initialize(
+	     &( internal_cache_pool->load_mutex ),
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+		 "%s: unable to initialize load mutex.",
+		 function );
+
+		goto on_error;
+	}
+	if( libcthreads_condition_initialize(
+	     &( internal_cache_pool->load_condition ),
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+		 "%s: unable to initialize load condition.",
+		 function );
+
+		goto on_error;
+	}
+#endif
+	internal_cache_pool->maximum_size         = maximum_size;
+	internal_cache_pool->number_of_references = 1;
+
+	*cache_pool = (libqcow_cache_pool_t *) internal_cache_pool;
+
+	return( 1 );
+
+on_error:
+	if( internal_cache_pool != NULL )
+	{
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+		if( internal_cache_pool->load_mutex != NULL )
+		{
+			libcthreads_mutex_free(
+			 &( internal_cache_pool->load_mutex ),
+			 NULL );
+		}
+		if( internal_cache_pool->read_write_lock != NULL )
+		{
+			libcthreads_read_write_lock_free(
+			 &( internal_cache_pool->read_write_lock ),
+			 NULL );
+		}
+#endif
+		if( internal_cache_pool->shards != NULL )
+		{
+			for( shard_index = 0;
+			     shard_index < internal_cache_pool->number_of_shards;
+			     shard_index++ )
+			{
+				libqcow_cache_pool_shard_free(
+				 &( internal_cache_pool->shards[ shard_index ] ),
+				 NULL );
+			}
+			memory_free(
+			 internal_cache_pool->shards );
+		}
+		memory_free(
+		 internal_cache_pool );
+	}
+	return( -1 );
+}
+
+/* Frees a cache pool
+ * Releases a reference to the cache pool, the cache pool and its cached values
+ * are freed when the last reference is released
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_cache_pool_free(
+     libqcow_cache_pool_t **cache_pool,
+     libcerror_error_t **error )
+{
+	libqcow_internal_cache_pool_t *internal_cache_pool = NULL;
+	static char *function                              = "libqcow_cache_pool_free";
+	int number_of_references                           = 0;
+	int result                                         = 1;
+	int shard_index                                    = 0;
+
+	if( cache_pool == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid cache pool.",
+		 function );
+
+		return( -1 );
+	}
+	if( *cache_pool == NULL )
+	{
+		return( 1 );
+	}
+	internal_cache_pool = (libqcow_internal_cache_pool_t *) *cache_pool;
+	*cache_pool         = NULL;
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_grab_for_write(
+	     internal_cache_pool->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab read/write lock for writing.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	internal_cache_pool->number_of_references -= 1;
+
+	number_of_references = internal_cache_pool->number_of_references;
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_release_for_write(
+	     internal_cache_pool->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release read/write lock for writing.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	if( number_of_references > 0 )
+	{
+		return( 1 );
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_free(
+	     &( internal_cache_pool->read_write_lock ),
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+		 "%s: unable to free read/write lock.",
+		 function );
+
+		result = -1;
+	}
+	if( libcthreads_condition_free(
+	     &( internal_cache_pool->load_condition ),
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+		 "%s: unable to free load condition.",
+		 function );
+
+		result = -1;
+	}
+	if( libcthreads_mutex_free(
+	     &( internal_cache_pool->load_mutex ),
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+		 "%s: unable to free load mutex.",
+		 function );
+
+		result = -1;
+	}
+#endif
+	for( shard_index = 0;
+	     shard_index < internal_cache_pool->number_of_shards;
+	     shard_index++ )
+	{
+		if( libqcow_cache_pool_shard_free(
+		     &( internal_cache_pool->shards[ shard_index ] ),
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+			 "%s: unable to free shard: %d.",
+			 function,
+			 shard_index );
+
+			result = -1;
+		}
+	}
+	memory_free(
+	 internal_cache_pool->shards );
+
+	memory_free(
+	 internal_cache_pool );
+
+	return( result );
+}
+
+/* Adds a reference to a cache pool
+ * The reference is released by libqcow_cache_pool_free
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_cache_pool_reference(
+     libqcow_cache_pool_t *cache_pool,
+     libcerror_error_t **error )
+{
+	libqcow_internal_cache_pool_t *internal_cache_pool = NULL;
+	static char *function                              = "libqcow_cache_pool_reference";
+	int result                                         = 1;
+
+	if( cache_pool == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid cache pool.",
+		 function );
+
+		return( -1 );
+	}
+	internal_cache_pool = (libqcow_internal_cache_pool_t *) cache_pool;
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_grab_for_write(
+	     internal_cache_pool->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab read/write lock for writing.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	if( internal_cache_pool->number_of_references == INT_MAX )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_EXCEEDS_MAXIMUM,
+		 "%s: invalid cache pool - number of references value exceeds maximum.",
+		 function );
+
+		result = -1;
+	}
+	else
+	{
+		internal_cache_pool->number_of_references += 1;
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_release_for_write(
+	     internal_cache_pool->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release read/write lock for writing.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	return( result );
+}
+
+/* Retrieves the size of the memory used by the cached values
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_cache_pool_get_size(
+     libqcow_cache_pool_t *cache_pool,
+     size64_t *size,
+     libcerror_error_t **error )
+{
+	libqcow_cache_pool_shard_t *cache_pool_shard       = NULL;
+	libqcow_internal_cache_pool_t *internal_cache_pool = NULL;
+	static char *function                              = "libqcow_cache_pool_get_size";
+	size64_t safe_size                                 = 0;
+	int shard_index                                    = 0;
+
+	if( cache_pool == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid cache pool.",
+		 function );
+
+		return( -1 );
+	}
+	internal_cache_pool = (libqcow_internal_cache_pool_t *) cache_pool;
+
+	if( size == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid size.",
+		 function );
+
+		return( -1 );
+	}
+	for( shard_index = 0;
+	     shard_index < internal_cache_pool->number_of_shards;
+	     shard_index++ )
+	{
+		cache_pool_shard = internal_cache_pool->shards[ shard_index ];
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+		if( libcthreads_read_write_lock_grab_for_read(
+		     cache_pool_shard->read_write_lock,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+			 "%s: unable to grab read/write lock for reading.",
+			 function );
+
+			return( -1 );
+		}
+#endif
+		safe_size += cache_pool_shard->size;
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+		if( libcthreads_read_write_lock_release_for_read(
+		     cache_pool_shard->read_write_lock,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+			 "%s: unable to release read/write lock for reading.",
+			 function );
+
+			return( -1 );
+		}
+#endif
+	}
+	*size = safe_size;
+
+	return( 1 );
+}
+
+/* Retrieves the identity of a file
+ * Returns 1 if successful, 0 if not available or -1 on error
+ */
+int libqcow_cache_pool_get_file_identity(
+     const char *filename,
+     libqcow_file_identity_t *file_identity,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_cache_pool_get_file_identity";
+
+#if defined( HAVE_SYS_STAT_H ) && defined( HAVE_STAT ) && !defined( WINAPI )
+	struct stat file_statistics;
+#endif
+
+	if( filename == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid filename.",
+		 function );
+
+		return( -1 );
+	}
+	if( file_identity == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file identity.",
+		 function );
+
+		return( -1 );
+	}
+	/* The inode number does not identify a file on Windows
+	 */
+#if defined( HAVE_SYS_STAT_H ) && defined( HAVE_STAT ) && !defined( WINAPI )
+	if( stat(
+	     filename,
+	     &file_statistics ) != 0 )
+	{
+		return( 0 );
+	}
+	file_identity->device_number = (uint64_t) file_statistics.st_dev;
+	file_identity->inode_number  = (uint64_t) file_statistics.st_ino;
+	file_identity->size          = (size64_t) file_statistics.st_size;
+
+	return( 1 );
+#else
+	return( 0 );
+#endif
+}
+
+/* Retrieves the shard and bucket index of a value
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_internal_cache_pool_get_shard(
+     libqcow_internal_cache_pool_t *internal_cache_pool,
+     libqcow_file_identity_t *file_identity,
+     uint8_t value_type,
+     uint64_t offset,
+     int *shard_index,
+     int *bucket_index,
+     libcerror_error_t **error )
+{
+	libqcow_cache_pool_shard_t *cache_pool_shard = NULL;
+	static char *function                        = "libqcow_internal_cache_pool_get_shard";
+	uint64_t hash                                = 0;
+	int safe_shard_index                         = 0;
+
+	if( internal_cache_pool == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid cache pool.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( internal_cache_pool->number_of_shards <= 0 )
+	 || ( internal_cache_pool->shards == NULL ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid cache pool - number of shards value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	if( file_identity == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file identity.",
+		 function );
+
+		return( -1 );
+	}
+	if( shard_index == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid shard index.",
+		 function );
+
+		return( -1 );
+	}
+	if( bucket_index == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid bucket index.",
+		 function );
+
+		return( -1 );
+	}
+	/* Combine the values with a multiplicative hash and mix the result
+	 * compressed cluster blocks are aligned to 512 bytes
+	 */
+	hash  = file_identity->inode_number * 0x9e3779b97f4a7c15ULL;
+	hash ^= file_identity->device_number + ( hash << 6 ) + ( hash >> 2 );
+	hash ^= file_identity->size + ( hash << 6 ) + ( hash >> 2 );
+	hash ^= ( ( offset >> 9 ) | ( (uint64_t) value_type << 56 ) ) * 0x9e3779b97f4a7c15ULL;
+	hash ^= hash >> 33;
+	hash *= 0xff51afd7ed558ccdULL;
+	hash ^= hash >> 33;
+
+	/* The upper bits select the shard and the lower bits the bucket within the shard
+	 */
+	safe_shard_index = (int) ( ( hash >> 32 ) % (uint64_t) internal_cache_pool->number_of_shards );
+
+	cache_pool_shard = internal_cache_pool->shards[ safe_shard_index ];
+
+	if( ( cache_pool_shard == NULL )
+	 || ( cache_pool_shard->number_of_buckets <= 0 ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid cache pool - missing shard: %d.",
+		 function,
+		 safe_shard_index );
+
+		return( -1 );
+	}
+	*shard_index  = safe_shard_index;
+	*bucket_index = (int) ( ( hash & 0xffffffffUL ) % (uint64_t) cache_pool_shard->number_of_buckets );
+
+	return( 1 );
+}
+
+/* Retrieves a cluster block
+ * The cluster block is pinned and must be unpinned with libqcow_cache_pool_unpin_cluster_block
+ * Returns 1 if successful, 0 if the cluster block is not cached or -1 on error
+ */
+int libqcow_cache_pool_get_cluster_block(
+     libqcow_cache_pool_t *cache_pool,
+     libqcow_file_identity_t *file_identity,
+     uint8_t value_type,
+     uint64_t offset,
+     libqcow_cluster_block_t **cluster_block,
+     libcerror_error_t **error )
+{
+	libqcow_cache_pool_entry_t *cache_pool_entry       = NULL;
+	libqcow_cache_pool_shard_t *cache_pool_shard       = NULL;
+	libqcow_internal_cache_pool_t *internal_cache_pool = NULL;
+	static char *function                              = "libqcow_cache_pool_get_cluster_block";
+	int bucket_index                                   = 0;
+	int result                                         = 0;
+	int shard_index                                    = 0;
+
+	if( cache_pool == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid cache pool.",
+		 function );
+
+		return( -1 );
+	}
+	internal_cache_pool = (libqcow_internal_cache_pool_t *) cache_pool;
+
+	if( cluster_block == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid cluster block.",
+		 function );
+
+		return( -1 );
+	}
+	if( libqcow_internal_cache_pool_get_shard(
+	     internal_cache_pool,
+	     file_identity,
+	     value_type,
+	     offset,
+	     &shard_index,
+	     &bucket_index,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+		 "%s: unable to retrieve shard.",
+		 function );
+
+		return( -1 );
+	}
+	cache_pool_shard = internal_cache_pool->shards[ shard_index ];
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_grab_for_write(
+	     cache_pool_shard->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab read/write lock for writing.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	result = libqcow_cache_pool_shard_get_entry(
+	          cache_pool_shard,
+	          bucket_index,
+	          file_identity,
+	          value_type,
+	          offset,
+	          &cache_pool_entry,
+	          error );
+
+	if( result == -1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+		 "%s: unable to retrieve entry.",
+		 function );
+
+		goto on_error;
+	}
+	else if( result != 0 )
+	{
+		if( libqcow_cluster_block_pin(
+		     cache_pool_entry->cluster_block,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+			 "%s: unable to pin cluster block.",
+			 function );
+
+			goto on_error;
+		}
+		/* Move the entry to the front of the least recently used list
+		 */
+		if( cache_pool_entry->previous_entry != NULL )
+		{
+			cache_pool_entry->previous_entry->next_entry = cache_pool_entry->next_entry;
+
+			if( cache_pool_entry->next_entry != NULL )
+			{
+				cache_pool_entry->next_entry->previous_entry = cache_pool_entry->previous_entry;
+			}
+			else
+			{
+				cache_pool_shard->last_entry = cache_pool_entry->previous_entry;
+			}
+			cache_pool_entry->previous_entry = NULL;
+			cache_pool_entry->next_entry     = cache_pool_shard->first_entry;
+
+			cache_pool_shard->first_entry->previous_entry = cache_pool_entry;
+			cache_pool_shard->first_entry                 = cache_pool_entry;
+		}
+		*cluster_block = cache_pool_entry->cluster_block;
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_release_for_write(
+	     cache_pool_shard->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release read/write lock for writing.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	return( result );
+
+on_error:
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	libcthreads_read_write_lock_release_for_write(
+	 cache_pool_shard->read_write_lock,
+	 NULL );
+#endif
+	return( -1 );
+}
+
+/* Retrieves a cluster block or begins loading it
+ * If the cluster block is not cached and another thread is loading it, waits for that load
+ * to end and retrieves the cluster block again, hence concurrent misses on the same cluster
+ * block result in a single load
+ * The cluster block is pinned and must be unpinned with libqcow_cache_pool_unpin_cluster_block
+ * Returns 1 if successful, 0 if the cluster block is not cached or -1 on error
+ * If 0 is returned the caller loads the cluster block and must end the load with
+ * libqcow_cache_pool_end_load, also when loading failed
+ */
+int libqcow_cache_pool_get_cluster_block_or_begin_load(
+     libqcow_cache_pool_t *cache_pool,
+     libqcow_file_identity_t *file_identity,
+     uint8_t value_type,
+     uint64_t offset,
+     libqcow_cluster_block_t **cluster_block,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_cache_pool_get_cluster_block_or_begin_load";
+	uint8_t is_loading    = 0;
+	int result            = 0;
+
+	do
+	{
+		result = libqcow_cache_pool_get_cluster_block(
+		          cache_pool,
+		          file_identity,
+		          value_type,
+		          offset,
+		          cluster_block,
+		          error );
+
+		if( result == -1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+			 "%s: unable to retrieve cluster block.",
+			 function );
+
+			goto on_error;
+		}
+		else if( ( result != 0 )
+		      || ( is_loading != 0 ) )
+		{
+			break;
+		}
+		/* The cluster block is retrieved again after the load began, since another
+		 * thread can have ended its load in between
+		 */
+		result = libqcow_cache_pool_begin_load(
+		          cache_pool,
+		          file_identity,
+		          value_type,
+		          offset,
+		          error );
+
+		if( result == -1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+			 "%s: unable to begin load.",
+			 function );
+
+			return( -1 );
+		}
+		else if( result != 0 )
+		{
+			is_loading = 1;
+		}
+	}
+	while( 1 );
+
+	if( ( result != 0 )
+	 && ( is_loading != 0 ) )
+	{
+		if( libqcow_cache_pool_end_load(
+		     cache_pool,
+		     file_identity,
+		     value_type,
+		     offset,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+			 "%s: unable to end load.",
+			 function );
+
+			libqcow_cache_pool_unpin_cluster_block(
+			 cache_pool,
+			 cluster_block,
+			 NULL );
+
+			return( -1 );
+		}
+	}
+	return( result );
+
+on_error:
+	if( is_loading != 0 )
+	{
+		libqcow_cache_pool_end_load(
+		 cache_pool,
+		 file_identity,
+		 value_type,
+		 offset,
+		 NULL );
+	}
+	return( -1 );
+}
+
+/* Begins loading a value
+ * If another thread is loading the same value, waits for that load to end
+ * Returns 1 if the load began, 0 if another load of the value ended or -1 on error
+ */
+int libqcow_cache_pool_begin_load(
+     libqcow_cache_pool_t *cache_pool,
+     libqcow_file_identity_t *file_identity,
+     uint8_t value_type,
+     uint64_t offset,
+     libcerror_error_t **error )
+{
+	static char *function                              = "libqcow_cache_pool_begin_load";
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	libqcow_cache_pool_load_t *cache_pool_load         = NULL;
+	libqcow_internal_cache_pool_t *internal_cache_pool = NULL;
+	int result                                         = 1;
+#endif
+
+	if( cache_pool == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid cache pool.",
+		 function );
+
+		return( -1 );
+	}
+	if( file_identity == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file identity.",
+		 function );
+
+		return( -1 );
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	internal_cache_pool = (libqcow_internal_cache_pool_t *) cache_pool;
+
+	if( libcthreads_mutex_grab(
+	     internal_cache_pool->load_mutex,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab load mutex.",
+		 function );
+
+		return( -1 );
+	}
+	do
+	{
+		cache_pool_load = internal_cache_pool->first_load;
+
+		while( cache_pool_load != NULL )
+		{
+			if( ( cache_pool_load->offset == offset )
+			 && ( cache_pool_load->value_type == value_type )
+			 && ( cache_pool_load->file_identity.inode_number == file_identity->inode_number )
+			 && ( cache_pool_load->file_identity.device_number == file_identity->device_number )
+			 && ( cache_pool_load->file_identity.size == file_identity->size ) )
+			{
+				break;
+			}
+			cache_pool_load = cache_pool_load->next_load;
+		}
+		if( cache_pool_load == NULL )
+		{
+			break;
+		}
+		result = 0;
+
+		if( libcthreads_condition_wait(
+		     internal_cache_pool->load_condition,
+		     internal_cache_pool->load_mutex,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_GENERIC,
+			 "%s: unable to wait for load condition.",
+			 function );
+
+			goto on_error;
+		}
+	}
+	while( 1 );
+
+	if( result != 0 )
+	{
+		cache_pool_load = memory_allocate_structure(
+		                   libqcow_cache_pool_load_t );
+
+		if( cache_pool_load == NULL )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_MEMORY,
+			 LIBCERROR_MEMORY_ERROR_INSUFFICIENT,
+			 "%s: unable to create load.",
+			 function );
+
+			goto on_error;
+		}
+		cache_pool_load->file_identity.device_number = file_identity->device_number;
+		cache_pool_load->file_identity.inode_number  = file_identity->inode_number;
+		cache_pool_load->file_identity.size          = file_identity->size;
+		cache_pool_load->value_type                  = value_type;
+		cache_pool_load->offset                      = offset;
+		cache_pool_load->next_load                   = internal_cache_pool->first_load;
+
+		internal_cache_pool->first_load = cache_pool_load;
+	}
+	if( libcthreads_mutex_release(
+	     internal_cache_pool->load_mutex,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release load mutex.",
+		 function );
+
+		return( -1 );
+	}
+	return( result );
+
+on_error:
+	libcthreads_mutex_release(
+	 internal_cache_pool->load_mutex,
+	 NULL );
+
+	return( -1 );
+#else
+	/* Without multi-thread support there are no concurrent loads
+	 */
+	return( 1 );
+#endif
+}
+
+/* Ends loading a value
+ * Threads that wait for the load are woken up
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_cache_pool_end_load(
+     libqcow_cache_pool_t *cache_pool,
+     libqcow_file_identity_t *file_identity,
+     uint8_t value_type,
+     uint64_t offset,
+     libcerror_error_t **error )
+{
+	static char *function                              = "libqcow_cache_pool_end_load";
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	libqcow_cache_pool_load_t *cache_pool_load         = NULL;
+	libqcow_cache_pool_load_t *previous_load           = NULL;
+	libqcow_internal_cache_pool_t *internal_cache_pool = NULL;
+	int result                                         = 1;
+#endif
+
+	if( cache_pool == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid cache pool.",
+		 function );
+
+		return( -1 );
+	}
+	if( file_identity == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file identity.",
+		 function );
+
+		return( -1 );
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	internal_cache_pool = (libqcow_internal_cache_pool_t *) cache_pool;
+
+	if( libcthreads_mutex_grab(
+	     internal_cache_pool->load_mutex,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab load mutex.",
+		 function );
+
+		return( -1 );
+	}
+	cache_pool_load = internal_cache_pool->first_load;
+
+	while( cache_pool_load != NULL )
+	{
+		if( ( cache_pool_load->offset == offset )
+		 && ( cache_pool_load->value_type == value_type )
+		 && ( cache_pool_load->file_identity.inode_number == file_identity->inode_number )
+		 && ( cache_pool_load->file_identity.device_number == file_identity->device_number )
+		 && ( cache_pool_load->file_identity.size == file_identity->size ) )
+		{
+			break;
+		}
+		previous_load   = cache_pool_load;
+		cache_pool_load = cache_pool_load->next_load;
+	}
+	if( cache_pool_load == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: missing load.",
+		 function );
+
+		result = -1;
+	}
+	else
+	{
+		if( previous_load != NULL )
+		{
+			previous_load->next_load = cache_pool_load->next_load;
+		}
+		else
+		{
+			internal_cache_pool->first_load = cache_pool_load->next_load;
+		}
+		memory_free(
+		 cache_pool_load );
+
+		if( libcthreads_condition_broadcast(
+		     internal_cache_pool->load_condition,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+			 "%s: unable to broadcast load condition.",
+			 function );
+
+			result = -1;
+		}
+	}
+	if( libcthreads_mutex_release(
+	     internal_cache_pool->load_mutex,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release load mutex.",
+		 function );
+
+		return( -1 );
+	}
+	return( result );
+#else
+	return( 1 );
+#endif
+}
+
+/* Sets a cluster block
+ * The cache pool takes over the cluster block if successful, the cluster block is pinned
+ * and must be unpinned with libqcow_cache_pool_unpin_cluster_block
+ * Least recently used cluster blocks of the same shard that are not pinned are evicted
+ * to keep the size of the cached values of the shard within its maximum size
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_cache_pool_set_cluster_block(
+     libqcow_cache_pool_t *cache_pool,
+     libqcow_file_identity_t *file_identity,
+     uint8_t value_type,
+     uint64_t offset,
+     libqcow_cluster_block_t *cluster_block,
+     size_t value_size,
+     libcerror_error_t **error )
+{
+	libqcow_cache_pool_entry_t *cache_pool_entry       = NULL;
+	libqcow_cache_pool_entry_t *previous_entry         = NULL;
+	libqcow_cache_pool_shard_t *cache_pool_shard       = NULL;
+	libqcow_internal_cache_pool_t *internal_cache_pool = NULL;
+	static char *function                              = "libqcow_cache_pool_set_cluster_block";
+	int bucket_index                                   = 0;
+	int result                                         = 0;
+	int shard_index                                    = 0;
+
+	if( cache_pool == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid cache pool.",
+		 function );
+
+		return( -1 );
+	}
+	internal_cache_pool = (libqcow_internal_cache_pool_t *) cache_pool;
+
+	if( ( value_type != LIBQCOW_CACHE_POOL_VALUE_TYPE_CLUSTER_BLOCK )
+	 && ( value_type != LIBQCOW_CACHE_POOL_VALUE_TYPE_COMPRESSED_CLUSTER_BLOCK ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_UNSUPPORTED_VALUE,
+		 "%s: unsupported value type.",
+		 function );
+
+		return( -1 );
+	}
+	if( cluster_block == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid cluster block.",
+		 function );
+
+		return( -1 );
+	}
+	if( cluster_block->number_of_pins != 0 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid cluster block - already pinned.",
+		 function );
+
+		return( -1 );
+	}
+	if( value_size == 0 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_ZERO_OR_LESS,
+		 "%s: invalid value size value zero or less.",
+		 function );
+
+		return( -1 );
+	}
+	if( libqcow_internal_cache_pool_get_shard(
+	     internal_cache_pool,
+	     file_identity,
+	     value_type,
+	     offset,
+	     &shard_index,
+	     &bucket_index,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+		 "%s: unable to retrieve shard.",
+		 function );
+
+		return( -1 );
+	}
+	cache_pool_shard = internal_cache_pool->shards[ shard_index ];
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_grab_for_write(
+	     cache_pool_shard->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab read/write lock for writing.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	if( cache_pool_shard->number_of_entries == INT_MAX )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_EXCEEDS_MAXIMUM,
+		 "%s: invalid cache pool - number of entries value exceeds maximum.",
+		 function );
+
+		goto on_error;
+	}
+	/* Another file on the same base file can have cached the cluster block concurrently
+	 */
+	result = libqcow_cache_pool_shard_get_entry(
+	          cache_pool_shard,
+	          bucket_index,
+	          file_identity,
+	          value_type,
+	          offset,
+	          &cache_pool_entry,
+	          error );
+
+	if( result == -1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+		 "%s: unable to retrieve entry.",
+		 function );
+
+		goto on_error;
+	}
+	else if( result != 0 )
+	{
+		if( libqcow_cache_pool_shard_remove_entry(
+		     cache_pool_shard,
+		     cache_pool_entry,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_REMOVE_FAILED,
+			 "%s: unable to remove entry.",
+			 function );
+
+			goto on_error;
+		}
+		cache_pool_entry = NULL;
+	}
+	/* Evict the least recently used entries that are not pinned
+	 */
+	cache_pool_entry = cache_pool_shard->last_entry;
+
+	while( ( cache_pool_entry != NULL )
+	    && ( ( cache_pool_shard->size + value_size ) > cache_pool_shard->maximum_size ) )
+	{
+		previous_entry = cache_pool_entry->previous_entry;
+
+		if( cache_pool_entry->cluster_block->number_of_pins == 0 )
+		{
+			if( libqcow_cache_pool_shard_remove_entry(
+			     cache_pool_shard,
+			     cache_pool_entry,
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_REMOVE_FAILED,
+				 "%s: unable to remove entry.",
+				 function );
+
+				goto on_error;
+			}
+		}
+		cache_pool_entry = previous_entry;
+	}
+	cache_pool_entry = memory_allocate_structure(
+	                    libqcow_cache_pool_entry_t );
+
+	if( cache_pool_entry == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_INSUFFICIENT,
+		 "%s: unable to create entry.",
+		 function );
+
+		goto on_error;
+	}
+	if( memory_set(
+	     cache_pool_entry,
+	     0,
+	     sizeof( libqcow_cache_pool_entry_t ) ) == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_SET_FAILED,
+		 "%s: unable to clear entry.",
+		 function );
+
+		memory_free(
+		 cache_pool_entry );
+
+		goto on_error;
+	}
+	cache_pool_entry->file_identity.device_number = file_identity->device_number;
+	cache_pool_entry->file_identity.inode_number  = file_identity->inode_number;
+	cache_pool_entry->file_identity.size          = file_identity->size;
+	cache_pool_entry->value_type                  = value_type;
+	cache_pool_entry->offset                      = offset;
+	cache_pool_entry->cluster_block               = cluster_block;
+	cache_pool_entry->value_size                  = value_size;
+	cache_pool_entry->bucket_index                = bucket_index;
+	cache_pool_entry->next_bucket_entry           = cache_pool_shard->buckets[ bucket_index ];
+	cache_pool_entry->next_entry                  = cache_pool_shard->first_entry;
+
+	cache_pool_shard->buckets[ bucket_index ] = cache_pool_entry;
+
+	if( cache_pool_shard->first_entry != NULL )
+	{
+		cache_pool_shard->first_entry->previous_entry = cache_pool_entry;
+	}
+	else
+	{
+		cache_pool_shard->last_entry = cache_pool_entry;
+	}
+	cache_pool_shard->first_entry = cache_pool_entry;
+
+	cache_pool_shard->size              += value_size;
+	cache_pool_shard->number_of_entries += 1;
+
+	/* A cluster block that was not pinned before cannot fail to pin
+	 */
+	cluster_block->number_of_pins         = 1;
+	cluster_block->cache_pool_shard_index = shard_index;
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_release_for_write(
+	     cache_pool_shard->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release read/write lock for writing.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	return( 1 );
+
+on_error:
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	libcthreads_read_write_lock_release_for_write(
+	 cache_pool_shard->read_write_lock,
+	 NULL );
+#endif
+	return( -1 );
+}
+
+/* Pins a cluster block of the cache pool
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_cache_pool_pin_cluster_block(
+     libqcow_cache_pool_t *cache_pool,
+     libqcow_cluster_block_t *cluster_block,
+     libcerror_error_t **error )
+{
+	libqcow_cache_pool_shard_t *cache_pool_shard       = NULL;
+	libqcow_internal_cache_pool_t *internal_cache_pool = NULL;
+	static char *function                              = "libqcow_cache_pool_pin_cluster_block";
+	int result                                         = 1;
+
+	if( cache_pool == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid cache pool.",
+		 function );
+
+		return( -1 );
+	}
+	internal_cache_pool = (libqcow_internal_cache_pool_t *) cache_pool;
+
+	if( cluster_block == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid cluster block.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( cluster_block->cache_pool_shard_index < 0 )
+	 || ( cluster_block->cache_pool_shard_index >= internal_cache_pool->number_of_shards ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid cluster block - cache pool shard index value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	cache_pool_shard = internal_cache_pool->shards[ cluster_block->cache_pool_shard_index ];
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_grab_for_write(
+	     cache_pool_shard->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab read/write lock for writing.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	if( libqcow_cluster_block_pin(
+	     cluster_block,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to pin cluster block.",
+		 function );
+
+		result = -1;
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_release_for_write(
+	     cache_pool_shard->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release read/write lock for writing.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	return( result );
+}
+
+/* Unpins a cluster block of the cache pool
+ * The pins are protected by the lock of the shard that contains the cluster block
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_cache_pool_unpin_cluster_block(
+     libqcow_cache_pool_t *cache_pool,
+     libqcow_cluster_block_t **cluster_block,
+     libcerror_error_t **error )
+{
+	libqcow_cache_pool_shard_t *cache_pool_shard       = NULL;
+	libqcow_internal_cache_pool_t *internal_cache_pool = NULL;
+	static char *function                              = "libqcow_cache_pool_unpin_cluster_block";
+	int result                                         = 1;
+
+	if( cache_pool == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid cache pool.",
+		 function );
+
+		return( -1 );
+	}
+	internal_cache_pool = (libqcow_internal_cache_pool_t *) cache_pool;
+
+	if( cluster_block == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid cluster block.",
+		 function );
+
+		return( -1 );
+	}
+	if( *cluster_block == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid cluster block value.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( ( *cluster_block )->cache_pool_shard_index < 0 )
+	 || ( ( *cluster_block )->cache_pool_shard_index >= internal_cache_pool->number_of_shards ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid cluster block - cache pool shard index value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	cache_pool_shard = internal_cache_pool->shards[ ( *cluster_block )->cache_pool_shard_index ];
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_grab_for_write(
+	     cache_pool_shard->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab read/write lock for writing.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	if( libqcow_cluster_block_unpin(
+	     cluster_block,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to unpin cluster block.",
+		 function );
+
+		result = -1;
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_release_for_write(
+	     cache_pool_shard->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release read/write lock for writing.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	return( result );
+}
+
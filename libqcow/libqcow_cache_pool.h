@@ -0,0 +1,308 @@
+/*
+ * Cache pool functions
+ *
+ * Copyright (C) 2010-2026, Joachim Metz <joachim.metz@gmail.com>
+ *
+ * Refer to AUTHORS for acknowledgements.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#if !defined( _LIBQCOW_INTERNAL_CACHE_POOL_H )
+#define _LIBQCOW_INTERNAL_CACHE_POOL_H
+
+#include <common.h>
+#include <types.h>
+
+#include "libqcow_cluster_block.h"
+#include "libqcow_extern.h"
+#include "libqcow_libcerror.h"
+#include "libqcow_libcthreads.h"
+#include "libqcow_types.h"
+
+#if defined( __cplusplus )
+extern "C" {
+#endif
+
+typedef struct libqcow_file_identity libqcow_file_identity_t;
+
+struct libqcow_file_identity
+{
+	/* The device number
+	 */
+	uint64_t device_number;
+
+	/* The inode number
+	 */
+	uint64_t inode_number;
+
+	/* The (file) size
+	 */
+	size64_t size;
+};
+
+typedef struct libqcow_cache_pool_entry libqcow_cache_pool_entry_t;
+
+struct libqcow_cache_pool_entry
+{
+	/* The identity of the file that contains the value
+	 */
+	libqcow_file_identity_t file_identity;
+
+	/* The value type
+	 */
+	uint8_t value_type;
+
+	/* The (file) offset of the value
+	 */
+	uint64_t offset;
+
+	/* The cluster block
+	 */
+	libqcow_cluster_block_t *cluster_block;
+
+	/* The size of the memory used by the cluster block
+	 */
+	size_t value_size;
+
+	/* The index of the bucket that contains the entry
+	 */
+	int bucket_index;
+
+	/* The next entry in the same bucket
+	 */
+	libqcow_cache_pool_entry_t *next_bucket_entry;
+
+	/* The previous (more recently used) entry
+	 */
+	libqcow_cache_pool_entry_t *previous_entry;
+
+	/* The next (less recently used) entry
+	 */
+	libqcow_cache_pool_entry_t *next_entry;
+};
+
+typedef struct libqcow_cache_pool_load libqcow_cache_pool_load_t;
+
+struct libqcow_cache_pool_load
+{
+	/* The identity of the file that contains the value
+	 */
+	libqcow_file_identity_t file_identity;
+
+	/* The value type
+	 */
+	uint8_t value_type;
+
+	/* The (file) offset of the value
+	 */
+	uint64_t offset;
+
+	/* The next load
+	 */
+	libqcow_cache_pool_load_t *next_load;
+};
+
+typedef struct libqcow_cache_pool_shard libqcow_cache_pool_shard_t;
+
+struct libqcow_cache_pool_shard
+{
+	/* The maximum size of the memory used by the cached values of the shard
+	 */
+	size64_t maximum_size;
+
+	/* The size of the memory used by the cached values of the shard
+	 */
+	size64_t size;
+
+	/* The number of entries
+	 */
+	int number_of_entries;
+
+	/* The number of buckets
+	 */
+	int number_of_buckets;
+
+	/* The buckets, indexed by the hash of the file identity and offset
+	 */
+	libqcow_cache_pool_entry_t **buckets;
+
+	/* The most recently used entry
+	 */
+	libqcow_cache_pool_entry_t *first_entry;
+
+	/* The least recently used entry
+	 */
+	libqcow_cache_pool_entry_t *last_entry;
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	/* The read/write lock
+	 */
+	libcthreads_read_write_lock_t *read_write_lock;
+#endif
+};
+
+typedef struct libqcow_internal_cache_pool libqcow_internal_cache_pool_t;
+
+struct libqcow_internal_cache_pool
+{
+	/* The maximum size of the memory used by the cached values
+	 */
+	size64_t maximum_size;
+
+	/* The number of references
+	 */
+	int number_of_references;
+
+	/* The number of shards
+	 */
+	int number_of_shards;
+
+	/* The shards, indexed by the hash of the file identity and offset
+	 * Every shard has its own lock, buckets and least recently used list
+	 */
+	libqcow_cache_pool_shard_t **shards;
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	/* The read/write lock
+	 */
+	libcthreads_read_write_lock_t *read_write_lock;
+
+	/* The values that are being loaded
+	 */
+	libqcow_cache_pool_load_t *first_load;
+
+	/* The mutex that protects the values that are being loaded
+	 */
+	libcthreads_mutex_t *load_mutex;
+
+	/* The condition that is signalled when a load ended
+	 */
+	libcthreads_condition_t *load_condition;
+#endif
+};
+
+int libqcow_cache_pool_shard_initialize(
+     libqcow_cache_pool_shard_t **cache_pool_shard,
+     size64_t maximum_size,
+     libcerror_error_t **error );
+
+int libqcow_cache_pool_shard_free(
+     libqcow_cache_pool_shard_t **cache_pool_shard,
+     libcerror_error_t **error );
+
+int libqcow_cache_pool_shard_get_entry(
+     libqcow_cache_pool_shard_t *cache_pool_shard,
+     int bucket_index,
+     libqcow_file_identity_t *file_identity,
+     uint8_t value_type,
+     uint64_t offset,
+     libqcow_cache_pool_entry_t **cache_pool_entry,
+     libcerror_error_t **error );
+
+int libqcow_cache_pool_shard_remove_entry(
+     libqcow_cache_pool_shard_t *cache_pool_shard,
+     libqcow_cache_pool_entry_t *cache_pool_entry,
+     libcerror_error_t **error );
+
+LIBQCOW_EXTERN \
+int libqcow_cache_pool_initialize(
+     libqcow_cache_pool_t **cache_pool,
+     size64_t maximum_size,
+     libcerror_error_t **error );
+
+LIBQCOW_EXTERN \
+int libqcow_cache_pool_free(
+     libqcow_cache_pool_t **cache_pool,
+     libcerror_error_t **error );
+
+int libqcow_cache_pool_reference(
+     libqcow_cache_pool_t *cache_pool,
+     libcerror_error_t **error );
+
+LIBQCOW_EXTERN \
+int libqcow_cache_pool_get_size(
+     libqcow_cache_pool_t *cache_pool,
+     size64_t *size,
+     libcerror_error_t **error );
+
+int libqcow_cache_pool_get_file_identity(
+     const char *filename,
+     libqcow_file_identity_t *file_identity,
+     libcerror_error_t **error );
+
+int libqcow_internal_cache_pool_get_shard(
+     libqcow_internal_cache_pool_t *internal_cache_pool,
+     libqcow_file_identity_t *file_identity,
+     uint8_t value_type,
+     uint64_t offset,
+     int *shard_index,
+     int *bucket_index,
+     libcerror_error_t **error );
+
+int libqcow_cache_pool_get_cluster_block(
+     libqcow_cache_pool_t *cache_pool,
+     libqcow_file_identity_t *file_identity,
+     uint8_t value_type,
+     uint64_t offset,
+     libqcow_cluster_block_t **cluster_block,
+     libcerror_error_t **error );
+
+int libqcow_cache_pool_get_cluster_block_or_begin_load(
+     libqcow_cache_pool_t *cache_pool,
+     libqcow_file_identity_t *file_identity,
+     uint8_t value_type,
+     uint64_t offset,
+     libqcow_cluster_block_t **cluster_block,
+     libcerror_error_t **error );
+
+int libqcow_cache_pool_begin_load(
+     libqcow_cache_pool_t *cache_pool,
+     libqcow_file_identity_t *file_identity,
+     uint8_t value_type,
+     uint64_t offset,
+     libcerror_error_t **error );
+
+int libqcow_cache_pool_end_load(
+     libqcow_cache_pool_t *cache_pool,
+     libqcow_file_identity_t *file_identity,
+     uint8_t value_type,
+     uint64_t offset,
+     libcerror_error_t **error );
+
+int libqcow_cache_pool_set_cluster_block(
+     libqcow_cache_pool_t *cache_pool,
+     libqcow_file_identity_t *file_identity,
+     uint8_t value_type,
+     uint64_t offset,
+     libqcow_cluster_block_t *cluster_block,
+     size_t value_size,
+     libcerror_error_t **error );
+
+int libqcow_cache_pool_pin_cluster_block(
+     libqcow_cache_pool_t *cache_pool,
+     libqcow_cluster_block_t *cluster_block,
+     libcerror_error_t **error );
+
+int libqcow_cache_pool_unpin_cluster_block(
+     libqcow_cache_pool_t *cache_pool,
+     libqcow_cluster_block_t **cluster_block,
+     libcerror_error_t **error );
+
+#if defined( __cplusplus )
+}
+#endif
+
+#endif /* !defined( _LIBQCOW_INTERNAL_CACHE_POOL_H ) */
+
@@ -0,0 +1,382 @@
+/*
+ * Backing chain index functions
+ *
+ * Copyright (C) 2010-2026, Joachim Metz <joachim.metz@gmail.com>
+ *
+ * Refer to AUTHORS for acknowledgements.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <common.h>
+#include <memory.h>
+#include <types.h>
+
+#include "libqcow_chain_index.h"
+#include "libqcow_libcerror.h"
+
+/* Creates a chain index
+ * Make sure the value chain_index is referencing, is set to NULL
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_chain_index_initialize(
+     libqcow_chain_index_t **chain_index,
+     int number_of_entries,
+     uint32_t offset_bit_shift,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_chain_index_initialize";
+	size_t entries_size   = 0;
+
+	if( chain_index == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid chain index.",
+		 function );
+
+		return( -1 );
+	}
+	if( *chain_index != NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_ALREADY_SET,
+		 "%s: invalid chain index value already set.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( number_of_entries <= 0 )
+	 || ( (size_t) number_of_entries > ( (size_t) MEMORY_MAXIMUM_ALLOCATION_SIZE / sizeof( libqcow_chain_index_entry_t ) ) ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid number of entries value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	if( offset_bit_shift > 63 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid offset bit shift value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	*chain_index = memory_allocate_structure(
+	                libqcow_chain_index_t );
+
+	if( *chain_index == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_INSUFFICIENT,
+		 "%s: unable to create chain index.",
+		 function );
+
+		goto on_error;
+	}
+	if( memory_set(
+	     *chain_index,
+	     0,
+	     sizeof( libqcow_chain_index_t ) ) == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_SET_FAILED,
+		 "%s: unable to clear chain index.",
+		 function );
+
+		memory_free(
+		 *chain_index );
+
+		*chain_index = NULL;
+
+		return( -1 );
+	}
+	entries_size = sizeof( libqcow_chain_index_entry_t ) * number_of_entries;
+
+	( *chain_index )->entries = (libqcow_chain_index_entry_t *) memory_allocate(
+	                                                              entries_size );
+
+	if( ( *chain_index )->entries == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_INSUFFICIENT,
+		 "%s: unable to create entries.",
+		 function );
+
+		goto on_error;
+	}
+	/* An entry with a size of 0 is unused
+	 */
+	if( memory_set(
+	     ( *chain_index )->entries,
+	     0,
+	     entries_size ) == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_SET_FAILED,
+		 "%s: unable to clear entries.",
+		 function );
+
+		goto on_error;
+	}
+	( *chain_index )->number_of_entries = number_of_entries;
+	( *chain_index )->offset_bit_shift  = offset_bit_shift;
+
+	return( 1 );
+
+on_error:
+	if( *chain_index != NULL )
+	{
+		if( ( *chain_index )->entries != NULL )
+		{
+			memory_free(
+			 ( *chain_index )->entries );
+		}
+		memory_free(
+		 *chain_index );
+
+		*chain_index = NULL;
+	}
+	return( -1 );
+}
+
+/* Frees a chain index
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_chain_index_free(
+     libqcow_chain_index_t **chain_index,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_chain_index_free";
+
+	if( chain_index == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid chain index.",
+		 function );
+
+		return( -1 );
+	}
+	if( *chain_index != NULL )
+	{
+		if( ( *chain_index )->entries != NULL )
+		{
+			memory_free(
+			 ( *chain_index )->entries );
+		}
+		memory_free(
+		 *chain_index );
+
+		*chain_index = NULL;
+	}
+	return( 1 );
+}
+
+/* Retrieves the entry that contains a specific offset
+ * The entry is adjusted to start at the offset
+ * Returns 1 if successful, 0 if no such entry or -1 on error
+ */
+int libqcow_chain_index_get_entry_by_offset(
+     libqcow_chain_index_t *chain_index,
+     off64_t offset,
+     libqcow_chain_index_entry_t *chain_index_entry,
+     libcerror_error_t **error )
+{
+	libqcow_chain_index_entry_t *entry = NULL;
+	static char *function              = "libqcow_chain_index_get_entry_by_offset";
+	uint64_t relative_offset           = 0;
+	int entry_index                    = 0;
+
+	if( chain_index == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid chain index.",
+		 function );
+
+		return( -1 );
+	}
+	if( offset < 0 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_LESS_THAN_ZERO,
+		 "%s: invalid offset value less than zero.",
+		 function );
+
+		return( -1 );
+	}
+	if( chain_index_entry == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid chain index entry.",
+		 function );
+
+		return( -1 );
+	}
+	entry_index = (int) ( ( (uint64_t) offset >> chain_index->offset_bit_shift ) % (uint64_t) chain_index->number_of_entries );
+
+	entry = &( chain_index->entries[ entry_index ] );
+
+	if( ( entry->size == 0 )
+	 || ( offset < entry->offset ) )
+	{
+		return( 0 );
+	}
+	relative_offset = (uint64_t) ( offset - entry->offset );
+
+	if( relative_offset >= entry->size )
+	{
+		return( 0 );
+	}
+	chain_index_entry->offset               = offset;
+	chain_index_entry->size                 = entry->size - relative_offset;
+	chain_index_entry->file                 = entry->file;
+	chain_index_entry->cluster_block_offset = entry->cluster_block_offset;
+	chain_index_entry->cluster_block_flags  = entry->cluster_block_flags;
+
+	if( entry->file != NULL )
+	{
+		chain_index_entry->cluster_block_data_offset = entry->cluster_block_data_offset + relative_offset;
+	}
+	else
+	{
+		chain_index_entry->cluster_block_data_offset = 0;
+	}
+	return( 1 );
+}
+
+/* Sets an entry
+ * The entry is stored for every offset it contains, replacing previous entries
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_chain_index_set_entry(
+     libqcow_chain_index_t *chain_index,
+     libqcow_chain_index_entry_t *chain_index_entry,
+     libcerror_error_t **error )
+{
+	static char *function      = "libqcow_chain_index_set_entry";
+	uint64_t first_block_index = 0;
+	uint64_t last_block_index  = 0;
+	uint64_t block_index       = 0;
+	int entry_index            = 0;
+	int number_of_blocks       = 0;
+
+	if( chain_index == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid chain index.",
+		 function );
+
+		return( -1 );
+	}
+	if( chain_index_entry == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid chain index entry.",
+		 function );
+
+		return( -1 );
+	}
+	if( chain_index_entry->offset < 0 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_LESS_THAN_ZERO,
+		 "%s: invalid chain index entry - offset value less than zero.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( chain_index_entry->size == 0 )
+	 || ( chain_index_entry->size > (size64_t) ( INT64_MAX - chain_index_entry->offset ) ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid chain index entry - size value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	first_block_index = (uint64_t) chain_index_entry->offset >> chain_index->offset_bit_shift;
+	last_block_index  = ( (uint64_t) chain_index_entry->offset + chain_index_entry->size - 1 ) >> chain_index->offset_bit_shift;
+
+	/* There is no need to store the entry more than once per index entry
+	 */
+	for( block_index = first_block_index;
+	     block_index <= last_block_index;
+	     block_index++ )
+	{
+		if( number_of_blocks >= chain_index->number_of_entries )
+		{
+			break;
+		}
+		entry_index = (int) ( block_index % (uint64_t) chain_index->number_of_entries );
+
+		if( memory_copy(
+		     &( chain_index->entries[ entry_index ] ),
+		     chain_index_entry,
+		     sizeof( libqcow_chain_index_entry_t ) ) == NULL )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_MEMORY,
+			 LIBCERROR_MEMORY_ERROR_COPY_FAILED,
+			 "%s: unable to copy chain index entry.",
+			 function );
+
+			return( -1 );
+		}
+		number_of_blocks++;
+	}
+	return( 1 );
+}
+
@@ -0,0 +1,108 @@
+/*
+ * Backing chain index functions
+ *
+ * Copyright (C) 2010-2026, Joachim Metz <joachim.metz@gmail.com>
+ *
+ * Refer to AUTHORS for acknowledgements.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#if !defined( _LIBQCOW_CHAIN_INDEX_H )
+#define _LIBQCOW_CHAIN_INDEX_H
+
+#include <common.h>
+#include <types.h>
+
+#include "libqcow_libcerror.h"
+#include "libqcow_types.h"
+
+#if defined( __cplusplus )
+extern "C" {
+#endif
+
+typedef struct libqcow_chain_index_entry libqcow_chain_index_entry_t;
+
+struct libqcow_chain_index_entry
+{
+	/* The (storage media) offset of the resolved range
+	 */
+	off64_t offset;
+
+	/* The size of the resolved range
+	 */
+	size64_t size;
+
+	/* The file (layer) of the backing chain that contains the data of the range
+	 * Contains NULL if the range contains zero bytes
+	 */
+	libqcow_file_t *file;
+
+	/* The cluster block (file) offset in the file
+	 */
+	uint64_t cluster_block_offset;
+
+	/* The data offset, within the cluster block, of the start of the range
+	 */
+	uint64_t cluster_block_data_offset;
+
+	/* The cluster block flags
+	 */
+	uint32_t cluster_block_flags;
+};
+
+typedef struct libqcow_chain_index libqcow_chain_index_t;
+
+struct libqcow_chain_index
+{
+	/* The number of bits of the (storage media) offset that map to the same entry
+	 */
+	uint32_t offset_bit_shift;
+
+	/* The number of entries
+	 */
+	int number_of_entries;
+
+	/* The entries, indexed by offset
+	 */
+	libqcow_chain_index_entry_t *entries;
+};
+
+int libqcow_chain_index_initialize(
+     libqcow_chain_index_t **chain_index,
+     int number_of_entries,
+     uint32_t offset_bit_shift,
+     libcerror_error_t **error );
+
+int libqcow_chain_index_free(
+     libqcow_chain_index_t **chain_index,
+     libcerror_error_t **error );
+
+int libqcow_chain_index_get_entry_by_offset(
+     libqcow_chain_index_t *chain_index,
+     off64_t offset,
+     libqcow_chain_index_entry_t *chain_index_entry,
+     libcerror_error_t **error );
+
+int libqcow_chain_index_set_entry(
+     libqcow_chain_index_t *chain_index,
+     libqcow_chain_index_entry_t *chain_index_entry,
+     libcerror_error_t **error );
+
+#if defined( __cplusplus )
+}
+#endif
+
+#endif /* !defined( _LIBQCOW_CHAIN_INDEX_H ) */
+
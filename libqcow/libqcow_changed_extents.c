@@ -0,0 +1,377 @@
+/*
+ * Changed extents functions
+ *
+ * Copyright (C) 2010-2026, Joachim Metz <joachim.metz@gmail.com>
+ *
+ * Refer to AUTHORS for acknowledgements.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <common.h>
+#include <memory.h>
+#include <types.h>
+
+#include "libqcow_changed_extents.h"
+#include "libqcow_libcerror.h"
+#include "libqcow_types.h"
+
+/* Creates changed extents
+ * Make sure the value changed_extents is referencing, is set to NULL
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_changed_extents_initialize(
+     libqcow_changed_extents_t **changed_extents,
+     libcerror_error_t **error )
+{
+	libqcow_internal_changed_extents_t *internal_changed_extents = NULL;
+	static char *function                                        = "libqcow_changed_extents_initialize";
+
+	if( changed_extents == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid changed extents.",
+		 function );
+
+		return( -1 );
+	}
+	if( *changed_extents != NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_ALREADY_SET,
+		 "%s: invalid changed extents value already set.",
+		 function );
+
+		return( -1 );
+	}
+	internal_changed_extents = memory_allocate_structure(
+	                            libqcow_internal_changed_extents_t );
+
+	if( internal_changed_extents == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_INSUFFICIENT,
+		 "%s: unable to create changed extents.",
+		 function );
+
+		return( -1 );
+	}
+	if( memory_set(
+	     internal_changed_extents,
+	     0,
+	     sizeof( libqcow_internal_changed_extents_t ) ) == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_SET_FAILED,
+		 "%s: unable to clear changed extents.",
+		 function );
+
+		memory_free(
+		 internal_changed_extents );
+
+		return( -1 );
+	}
+	*changed_extents = (libqcow_changed_extents_t *) internal_changed_extents;
+
+	return( 1 );
+}
+
+/* Frees changed extents
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_changed_extents_free(
+     libqcow_changed_extents_t **changed_extents,
+     libcerror_error_t **error )
+{
+	libqcow_internal_changed_extents_t *internal_changed_extents = NULL;
+	static char *function                                        = "libqcow_changed_extents_free";
+
+	if( changed_extents == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid changed extents.",
+		 function );
+
+		return( -1 );
+	}
+	if( *changed_extents != NULL )
+	{
+		internal_changed_extents = (libqcow_internal_changed_extents_t *) *changed_extents;
+		*changed_extents         = NULL;
+
+		if( internal_changed_extents->extents != NULL )
+		{
+			memory_free(
+			 internal_changed_extents->extents );
+		}
+		memory_free(
+		 internal_changed_extents );
+	}
+	return( 1 );
+}
+
+/* Appends an extent
+ * The extent must not start before the end of the last extent,
+ * an extent that directly follows the last extent is merged with it
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_changed_extents_append_extent(
+     libqcow_changed_extents_t *changed_extents,
+     off64_t offset,
+     size64_t size,
+     libcerror_error_t **error )
+{
+	libqcow_changed_extent_t *extent                             = NULL;
+	libqcow_changed_extent_t *extents                            = NULL;
+	libqcow_internal_changed_extents_t *internal_changed_extents = NULL;
+	static char *function                                        = "libqcow_changed_extents_append_extent";
+	int number_of_allocated_extents                              = 0;
+
+	if( changed_extents == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid changed extents.",
+		 function );
+
+		return( -1 );
+	}
+	internal_changed_extents = (libqcow_internal_changed_extents_t *) changed_extents;
+
+	if( offset < 0 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_LESS_THAN_ZERO,
+		 "%s: invalid offset value less than zero.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( size == 0 )
+	 || ( size > (size64_t) ( INT64_MAX - offset ) ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid size value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	if( internal_changed_extents->number_of_extents > 0 )
+	{
+		extent = &( internal_changed_extents->extents[ internal_changed_extents->number_of_extents - 1 ] );
+
+		if( offset < (off64_t) ( extent->offset + extent->size ) )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+			 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+			 "%s: invalid offset value out of bounds.",
+			 function );
+
+			return( -1 );
+		}
+		if( offset == (off64_t) ( extent->offset + extent->size ) )
+		{
+			extent->size += size;
+
+			return( 1 );
+		}
+	}
+	if( internal_changed_extents->number_of_extents >= internal_changed_extents->number_of_allocated_extents )
+	{
+		if( internal_changed_extents->number_of_allocated_extents >= ( INT_MAX / 2 ) )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+			 "%s: invalid number of allocated extents value out of bounds.",
+			 function );
+
+			return( -1 );
+		}
+		number_of_allocated_extents = internal_changed_extents->number_of_allocated_extents * 2;
+
+		if( number_of_allocated_extents == 0 )
+		{
+			number_of_allocated_extents = 16;
+		}
+		if( (size_t) number_of_allocated_extents > ( (size_t) MEMORY_MAXIMUM_ALLOCATION_SIZE / sizeof( libqcow_changed_extent_t ) ) )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_VALUE_EXCEEDS_MAXIMUM,
+			 "%s: invalid number of allocated extents value exceeds maximum allocation size.",
+			 function );
+
+			return( -1 );
+		}
+		extents = (libqcow_changed_extent_t *) memory_reallocate(
+		                                        internal_changed_extents->extents,
+		                                        sizeof( libqcow_changed_extent_t ) * number_of_allocated_extents );
+
+		if( extents == NULL )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_MEMORY,
+			 LIBCERROR_MEMORY_ERROR_INSUFFICIENT,
+			 "%s: unable to resize extents.",
+			 function );
+
+			return( -1 );
+		}
+		internal_changed_extents->extents                     = extents;
+		internal_changed_extents->number_of_allocated_extents = number_of_allocated_extents;
+	}
+	extent = &( internal_changed_extents->extents[ internal_changed_extents->number_of_extents ] );
+
+	extent->offset = offset;
+	extent->size   = size;
+
+	internal_changed_extents->number_of_extents += 1;
+
+	return( 1 );
+}
+
+/* Retrieves the number of extents
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_changed_extents_get_number_of_extents(
+     libqcow_changed_extents_t *changed_extents,
+     int *number_of_extents,
+     libcerror_error_t **error )
+{
+	libqcow_internal_changed_extents_t *internal_changed_extents = NULL;
+	static char *function                                        = "libqcow_changed_extents_get_number_of_extents";
+
+	if( changed_extents == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid changed extents.",
+		 function );
+
+		return( -1 );
+	}
+	internal_changed_extents = (libqcow_internal_changed_extents_t *) changed_extents;
+
+	if( number_of_extents == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid number of extents.",
+		 function );
+
+		return( -1 );
+	}
+	*number_of_extents = internal_changed_extents->number_of_extents;
+
+	return( 1 );
+}
+
+/* Retrieves a specific extent
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_changed_extents_get_extent_by_index(
+     libqcow_changed_extents_t *changed_extents,
+     int extent_index,
+     off64_t *offset,
+     size64_t *size,
+     libcerror_error_t **error )
+{
+	libqcow_changed_extent_t *extent                             = NULL;
+	libqcow_internal_changed_extents_t *internal_changed_extents = NULL;
+	static char *function                                        = "libqcow_changed_extents_get_extent_by_index";
+
+	if( changed_extents == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid changed extents.",
+		 function );
+
+		return( -1 );
+	}
+	internal_changed_extents = (libqcow_internal_changed_extents_t *) changed_extents;
+
+	if( ( extent_index < 0 )
+	 || ( extent_index >= internal_changed_extents->number_of_extents ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid extent index value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	if( offset == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid offset.",
+		 function );
+
+		return( -1 );
+	}
+	if( size == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid size.",
+		 function );
+
+		return( -1 );
+	}
+	extent = &( internal_changed_extents->extents[ extent_index ] );
+
+	*offset = extent->offset;
+	*size   = extent->size;
+
+	return( 1 );
+}
+
@@ -0,0 +1,100 @@
+/*
+ * Changed extents functions
+ *
+ * Copyright (C) 2010-2026, Joachim Metz <joachim.metz@gmail.com>
+ *
+ * Refer to AUTHORS for acknowledgements.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#if !defined( _LIBQCOW_INTERNAL_CHANGED_EXTENTS_H )
+#define _LIBQCOW_INTERNAL_CHANGED_EXTENTS_H
+
+#include <common.h>
+#include <types.h>
+
+#include "libqcow_extern.h"
+#include "libqcow_libcerror.h"
+#include "libqcow_types.h"
+
+#if defined( __cplusplus )
+extern "C" {
+#endif
+
+typedef struct libqcow_changed_extent libqcow_changed_extent_t;
+
+struct libqcow_changed_extent
+{
+	/* The (storage media) offset
+	 */
+	off64_t offset;
+
+	/* The size
+	 */
+	size64_t size;
+};
+
+typedef struct libqcow_internal_changed_extents libqcow_internal_changed_extents_t;
+
+struct libqcow_internal_changed_extents
+{
+	/* The number of extents
+	 */
+	int number_of_extents;
+
+	/* The number of allocated extents
+	 */
+	int number_of_allocated_extents;
+
+	/* The extents, sorted by offset
+	 */
+	libqcow_changed_extent_t *extents;
+};
+
+int libqcow_changed_extents_initialize(
+     libqcow_changed_extents_t **changed_extents,
+     libcerror_error_t **error );
+
+LIBQCOW_EXTERN \
+int libqcow_changed_extents_free(
+     libqcow_changed_extents_t **changed_extents,
+     libcerror_error_t **error );
+
+int libqcow_changed_extents_append_extent(
+     libqcow_changed_extents_t *changed_extents,
+     off64_t offset,
+     size64_t size,
+     libcerror_error_t **error );
+
+LIBQCOW_EXTERN \
+int libqcow_changed_extents_get_number_of_extents(
+     libqcow_changed_extents_t *changed_extents,
+     int *number_of_extents,
+     libcerror_error_t **error );
+
+LIBQCOW_EXTERN \
+int libqcow_changed_extents_get_extent_by_index(
+     libqcow_changed_extents_t *changed_extents,
+     int extent_index,
+     off64_t *offset,
+     size64_t *size,
+     libcerror_error_t **error );
+
+#if defined( __cplusplus )
+}
+#endif
+
+#endif /* !defined( _LIBQCOW_INTERNAL_CHANGED_EXTENTS_H ) */
+
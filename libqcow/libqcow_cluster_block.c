@@ -137,7 +137,106 @@ on_error:
 	return( -1 );
 }
 
+/* Creates a cluster block that wraps memory mapped data
+ * The data is not copied and must remain valid for the lifetime of the cluster block
+ * Make sure the value cluster_block is referencing, is set to NULL
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_cluster_block_initialize_mapped(
+     libqcow_cluster_block_t **cluster_block,
+     uint8_t *data,
+     size_t data_size,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_cluster_block_initialize_mapped";
+
+	if( cluster_block == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid cluster block.",
+		 function );
+
+		return( -1 );
+	}
+	if( *cluster_block != NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_ALREADY_SET,
+		 "%s: invalid cluster block value already set.",
+		 function );
+
+		return( -1 );
+	}
+	if( data == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid data.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( data_size == 0 )
+	 || ( data_size > (size_t) SSIZE_MAX ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid data size value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	*cluster_block = memory_allocate_structure(
+	                  libqcow_cluster_block_t );
+
+	if( *cluster_block == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_INSUFFICIENT,
+		 "%s: unable to create cluster block.",
+		 function );
+
+		return( -1 );
+	}
+	if( memory_set(
+	     *cluster_block,
+	     0,
+	     sizeof( libqcow_cluster_block_t ) ) == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_SET_FAILED,
+		 "%s: unable to clear cluster block.",
+		 function );
+
+		memory_free(
+		 *cluster_block );
+
+		*cluster_block = NULL;
+
+		return( -1 );
+	}
+	( *cluster_block )->data           = data;
+	( *cluster_block )->data_size      = data_size;
+	( *cluster_block )->data_is_mapped = 1;
+
+	return( 1 );
+}
+
 /* Frees a cluster block
+ * If the cluster block is pinned it is marked as released and freed by the last unpin
  * Returns 1 if successful or -1 on error
  */
 int libqcow_cluster_block_free(
@@ -160,6 +259,14 @@ int libqcow_cluster_block_free(
 	}
 	if( *cluster_block != NULL )
 	{
+		if( ( *cluster_block )->number_of_pins > 0 )
+		{
+			( *cluster_block )->is_released = 1;
+
+			*cluster_block = NULL;
+
+			return( 1 );
+		}
 		if( ( *cluster_block )->compressed_data != NULL )
 		{
 			memory_free(
@@ -170,7 +277,8 @@ int libqcow_cluster_block_free(
 			memory_free(
 			 ( *cluster_block )->encrypted_data );
 		}
-		if( ( *cluster_block )->data != NULL )
+		if( ( ( *cluster_block )->data != NULL )
+		 && ( ( *cluster_block )->data_is_mapped == 0 ) )
 		{
 			if( memory_set(
 			     ( *cluster_block )->data,
@@ -197,6 +305,121 @@ int libqcow_cluster_block_free(
 	return( result );
 }
 
+/* Pins a cluster block
+ * A pinned cluster block is not freed until it is unpinned
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_cluster_block_pin(
+     libqcow_cluster_block_t *cluster_block,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_cluster_block_pin";
+
+	if( cluster_block == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid cluster block.",
+		 function );
+
+		return( -1 );
+	}
+	if( cluster_block->is_released != 0 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid cluster block - already released.",
+		 function );
+
+		return( -1 );
+	}
+	if( cluster_block->number_of_pins == INT_MAX )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_EXCEEDS_MAXIMUM,
+		 "%s: invalid cluster block - number of pins value exceeds maximum.",
+		 function );
+
+		return( -1 );
+	}
+	cluster_block->number_of_pins += 1;
+
+	return( 1 );
+}
+
+/* Unpins a cluster block
+ * Frees the cluster block if it was released while pinned and this was the last pin
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_cluster_block_unpin(
+     libqcow_cluster_block_t **cluster_block,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_cluster_block_unpin";
+
+	if( cluster_block == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid cluster block.",
+		 function );
+
+		return( -1 );
+	}
+	if( *cluster_block == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid cluster block.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( *cluster_block )->number_of_pins <= 0 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid cluster block - not pinned.",
+		 function );
+
+		return( -1 );
+	}
+	( *cluster_block )->number_of_pins -= 1;
+
+	if( ( ( *cluster_block )->number_of_pins == 0 )
+	 && ( ( *cluster_block )->is_released != 0 ) )
+	{
+		if( libqcow_cluster_block_free(
+		     cluster_block,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+			 "%s: unable to free cluster block.",
+			 function );
+
+			return( -1 );
+		}
+	}
+	*cluster_block = NULL;
+
+	return( 1 );
+}
+
 /* Reads cluster block
  * Returns 1 if successful or -1 on error
  */
@@ -231,6 +454,17 @@ int libqcow_cluster_block_read(
 
 		return( -1 );
 	}
+	if( cluster_block->data_is_mapped != 0 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_UNSUPPORTED_VALUE,
+		 "%s: invalid cluster block - unsupported memory mapped data.",
+		 function );
+
+		return( -1 );
+	}
 #if defined( HAVE_DEBUG_OUTPUT )
 	if( libcnotify_verbose != 0 )
 	{
@@ -51,6 +51,23 @@ struct libqcow_cluster_block
 	/* The data size
 	 */
 	size_t data_size;
+
+	/* Value to indicate the data is memory mapped and not owned by the cluster block
+	 */
+	uint8_t data_is_mapped;
+
+	/* The number of pins
+	 */
+	int number_of_pins;
+
+	/* Value to indicate the cluster block was released while pinned
+	 */
+	uint8_t is_released;
+
+	/* The index of the cache pool shard that contains the cluster block
+	 * The pins of a cluster block in a cache pool are protected by the lock of the shard
+	 */
+	int cache_pool_shard_index;
 };
 
 int libqcow_cluster_block_initialize(
@@ -58,10 +75,24 @@ int libqcow_cluster_block_initialize(
      size_t data_size,
      libcerror_error_t **error );
 
+int libqcow_cluster_block_initialize_mapped(
+     libqcow_cluster_block_t **cluster_block,
+     uint8_t *data,
+     size_t data_size,
+     libcerror_error_t **error );
+
 int libqcow_cluster_block_free(
      libqcow_cluster_block_t **cluster_block,
      libcerror_error_t **error );
 
+int libqcow_cluster_block_pin(
+     libqcow_cluster_block_t *cluster_block,
+     libcerror_error_t **error );
+
+int libqcow_cluster_block_unpin(
+     libqcow_cluster_block_t **cluster_block,
+     libcerror_error_t **error );
+
 int libqcow_cluster_block_read(
      libqcow_cluster_block_t *cluster_block,
      libbfio_handle_t *file_io_handle,
@@ -129,6 +129,11 @@ int libqcow_cluster_table_free(
 			memory_free(
 			 ( *cluster_table )->references );
 		}
+		if( ( *cluster_table )->subcluster_bitmaps != NULL )
+		{
+			memory_free(
+			 ( *cluster_table )->subcluster_bitmaps );
+		}
 		memory_free(
 		 *cluster_table );
 
@@ -137,6 +142,171 @@ int libqcow_cluster_table_free(
 	return( 1 );
 }
 
+/* Clones a cluster table
+ * The references of the destination cluster table are owned by it, also when
+ * the references of the source cluster table are (memory mapped) reference data
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_cluster_table_clone(
+     libqcow_cluster_table_t **destination_cluster_table,
+     libqcow_cluster_table_t *source_cluster_table,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_cluster_table_clone";
+	int reference_index   = 0;
+
+	if( destination_cluster_table == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid destination cluster table.",
+		 function );
+
+		return( -1 );
+	}
+	if( *destination_cluster_table != NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_ALREADY_SET,
+		 "%s: invalid destination cluster table value already set.",
+		 function );
+
+		return( -1 );
+	}
+	if( source_cluster_table == NULL )
+	{
+		*destination_cluster_table = NULL;
+
+		return( 1 );
+	}
+	if( ( source_cluster_table->number_of_references <= 0 )
+	 || ( (size_t) source_cluster_table->number_of_references > ( (size_t) MEMORY_MAXIMUM_ALLOCATION_SIZE / sizeof( uint64_t ) ) ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid source cluster table - number of references value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( source_cluster_table->references == NULL )
+	 && ( source_cluster_table->references_data == NULL ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid source cluster table - missing references.",
+		 function );
+
+		return( -1 );
+	}
+	if( libqcow_cluster_table_initialize(
+	     destination_cluster_table,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+		 "%s: unable to create destination cluster table.",
+		 function );
+
+		goto on_error;
+	}
+	( *destination_cluster_table )->references = (uint64_t *) memory_allocate(
+	                                                           sizeof( uint64_t ) * source_cluster_table->number_of_references );
+
+	if( ( *destination_cluster_table )->references == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_INSUFFICIENT,
+		 "%s: unable to create destination references.",
+		 function );
+
+		goto on_error;
+	}
+	if( source_cluster_table->references != NULL )
+	{
+		if( memory_copy(
+		     ( *destination_cluster_table )->references,
+		     source_cluster_table->references,
+		     sizeof( uint64_t ) * source_cluster_table->number_of_references ) == NULL )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_MEMORY,
+			 LIBCERROR_MEMORY_ERROR_COPY_FAILED,
+			 "%s: unable to copy references.",
+			 function );
+
+			goto on_error;
+		}
+	}
+	else
+	{
+		for( reference_index = 0;
+		     reference_index < source_cluster_table->number_of_references;
+		     reference_index++ )
+		{
+			byte_stream_copy_to_uint64_big_endian(
+			 &( source_cluster_table->references_data[ (size_t) reference_index * 8 ] ),
+			 ( *destination_cluster_table )->references[ reference_index ] );
+		}
+	}
+	if( source_cluster_table->subcluster_bitmaps != NULL )
+	{
+		( *destination_cluster_table )->subcluster_bitmaps = (uint64_t *) memory_allocate(
+		                                                                   sizeof( uint64_t ) * source_cluster_table->number_of_references );
+
+		if( ( *destination_cluster_table )->subcluster_bitmaps == NULL )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_MEMORY,
+			 LIBCERROR_MEMORY_ERROR_INSUFFICIENT,
+			 "%s: unable to create destination subcluster bitmaps.",
+			 function );
+
+			goto on_error;
+		}
+		if( memory_copy(
+		     ( *destination_cluster_table )->subcluster_bitmaps,
+		     source_cluster_table->subcluster_bitmaps,
+		     sizeof( uint64_t ) * source_cluster_table->number_of_references ) == NULL )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_MEMORY,
+			 LIBCERROR_MEMORY_ERROR_COPY_FAILED,
+			 "%s: unable to copy subcluster bitmaps.",
+			 function );
+
+			goto on_error;
+		}
+	}
+	( *destination_cluster_table )->number_of_references = source_cluster_table->number_of_references;
+
+	return( 1 );
+
+on_error:
+	if( *destination_cluster_table != NULL )
+	{
+		libqcow_cluster_table_free(
+		 destination_cluster_table,
+		 NULL );
+	}
+	return( -1 );
+}
+
 /* Retrieves the number of references in the cluster table
  * Returns 1 if successful or -1 on error
  */
@@ -196,7 +366,8 @@ int libqcow_cluster_table_get_reference_by_index(
 
 		return( -1 );
 	}
-	if( cluster_table->references == NULL )
+	if( ( cluster_table->references == NULL )
+	 && ( cluster_table->references_data == NULL ) )
 	{
 		libcerror_error_set(
 		 error,
@@ -230,12 +401,156 @@ int libqcow_cluster_table_get_reference_by_index(
 
 		return( -1 );
 	}
-	*reference = cluster_table->references[ reference_index ];
+	if( cluster_table->references != NULL )
+	{
+		*reference = cluster_table->references[ reference_index ];
+	}
+	else
+	{
+		byte_stream_copy_to_uint64_big_endian(
+		 &( cluster_table->references_data[ (size_t) reference_index * 8 ] ),
+		 *reference );
+	}
+	return( 1 );
+}
+
+/* Retrieves a specific subcluster allocation bitmap from the cluster table
+ * The lower 32 bits contain the allocation status and the upper 32 bits
+ * the reads as zero status of the subclusters
+ * Returns 1 if successful, 0 if the cluster table has no subcluster bitmaps or -1 on error
+ */
+int libqcow_cluster_table_get_subcluster_bitmap_by_index(
+     libqcow_cluster_table_t *cluster_table,
+     int reference_index,
+     uint64_t *subcluster_bitmap,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_cluster_table_get_subcluster_bitmap_by_index";
+
+	if( cluster_table == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid cluster table.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( reference_index < 0 )
+	 || ( reference_index >= cluster_table->number_of_references ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid reference index value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	if( subcluster_bitmap == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid subcluster bitmap.",
+		 function );
+
+		return( -1 );
+	}
+	if( cluster_table->subcluster_bitmaps == NULL )
+	{
+		return( 0 );
+	}
+	*subcluster_bitmap = cluster_table->subcluster_bitmaps[ reference_index ];
+
+	return( 1 );
+}
+
+/* Sets the reference data of the cluster table
+ * The references are decoded from the data on access, which allows the data
+ * to be memory mapped. The data is not copied and must remain valid for
+ * the lifetime of the cluster table
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_cluster_table_set_references_data(
+     libqcow_cluster_table_t *cluster_table,
+     const uint8_t *references_data,
+     size_t references_data_size,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_cluster_table_set_references_data";
+
+	if( cluster_table == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid cluster table.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( cluster_table->references != NULL )
+	 || ( cluster_table->references_data != NULL ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_ALREADY_SET,
+		 "%s: invalid cluster table - references already set.",
+		 function );
+
+		return( -1 );
+	}
+	if( references_data == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid references data.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( references_data_size == 0 )
+	 || ( references_data_size > (size_t) SSIZE_MAX )
+	 || ( ( references_data_size % 8 ) != 0 ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid references data size value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( references_data_size / 8 ) > (size_t) INT_MAX )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_EXCEEDS_MAXIMUM,
+		 "%s: invalid number of references value exceeds maximum.",
+		 function );
+
+		return( -1 );
+	}
+	cluster_table->references_data      = references_data;
+	cluster_table->number_of_references = (int) ( references_data_size / 8 );
 
 	return( 1 );
 }
 
 /* Reads the cluster table
+ * The entry size is 8 for regular and 16 for extended level 2 table entries,
+ * which contain a subcluster allocation bitmap after the reference
  * Returns 1 if successful or -1 on error
  */
 int libqcow_cluster_table_read(
@@ -243,11 +558,13 @@ int libqcow_cluster_table_read(
      libbfio_handle_t *file_io_handle,
      off64_t file_offset,
      size_t cluster_table_size,
+     size_t entry_size,
      libcerror_error_t **error )
 {
 	uint8_t *cluster_table_data      = NULL;
 	static char *function            = "libqcow_cluster_table_read";
 	size_t cluster_table_data_offset = 0;
+	size_t number_of_references      = 0;
 	ssize_t read_count               = 0;
 	int cluster_table_index          = 0;
 
@@ -262,7 +579,8 @@ int libqcow_cluster_table_read(
 
 		return( -1 );
 	}
-	if( cluster_table->references != NULL )
+	if( ( cluster_table->references != NULL )
+	 || ( cluster_table->references_data != NULL ) )
 	{
 		libcerror_error_set(
 		 error,
@@ -273,9 +591,21 @@ int libqcow_cluster_table_read(
 
 		return( -1 );
 	}
+	if( ( entry_size != 8 )
+	 && ( entry_size != 16 ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_UNSUPPORTED_VALUE,
+		 "%s: unsupported entry size.",
+		 function );
+
+		return( -1 );
+	}
 	if( ( cluster_table_size == 0 )
 	 || ( cluster_table_size > (size_t) MEMORY_MAXIMUM_ALLOCATION_SIZE )
-	 || ( ( cluster_table_size % 8 ) != 0 ) )
+	 || ( ( cluster_table_size % entry_size ) != 0 ) )
 	{
 		libcerror_error_set(
 		 error,
@@ -286,7 +616,9 @@ int libqcow_cluster_table_read(
 
 		return( -1 );
 	}
-	if( ( cluster_table_size / 8 ) > (size_t) INT_MAX )
+	number_of_references = cluster_table_size / entry_size;
+
+	if( number_of_references > (size_t) INT_MAX )
 	{
 		libcerror_error_set(
 		 error,
@@ -298,7 +630,7 @@ int libqcow_cluster_table_read(
 		return( -1 );
 	}
 	cluster_table->references = (uint64_t *) memory_allocate(
-	                                          cluster_table_size );
+	                                          sizeof( uint64_t ) * number_of_references );
 
 	if( cluster_table->references == NULL )
 	{
@@ -311,7 +643,24 @@ int libqcow_cluster_table_read(
 
 		goto on_error;
 	}
-	cluster_table->number_of_references = (int) ( cluster_table_size / 8 );
+	if( entry_size == 16 )
+	{
+		cluster_table->subcluster_bitmaps = (uint64_t *) memory_allocate(
+		                                                  sizeof( uint64_t ) * number_of_references );
+
+		if( cluster_table->subcluster_bitmaps == NULL )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_MEMORY,
+			 LIBCERROR_MEMORY_ERROR_INSUFFICIENT,
+			 "%s: unable to create subcluster bitmaps.",
+			 function );
+
+			goto on_error;
+		}
+	}
+	cluster_table->number_of_references = (int) number_of_references;
 
 	cluster_table_data = (uint8_t *) memory_allocate(
 	                                  cluster_table_size );
@@ -389,6 +738,25 @@ int libqcow_cluster_table_read(
 			 ( cluster_table->references )[ cluster_table_index ] );
 		}
 #endif
+		if( cluster_table->subcluster_bitmaps != NULL )
+		{
+			byte_stream_copy_to_uint64_big_endian(
+			 &( cluster_table_data[ cluster_table_data_offset ] ),
+			 ( cluster_table->subcluster_bitmaps )[ cluster_table_index ] );
+
+			cluster_table_data_offset += 8;
+
+#if defined( HAVE_DEBUG_OUTPUT )
+			if( libcnotify_verbose != 0 )
+			{
+				libcnotify_printf(
+				 "%s: cluster table subcluster bitmap: %03d\t: 0x%016" PRIx64 "\n",
+				 function,
+				 cluster_table_index,
+				 ( cluster_table->subcluster_bitmaps )[ cluster_table_index ] );
+			}
+#endif
+		}
 	}
 #if defined( HAVE_DEBUG_OUTPUT )
 	if( libcnotify_verbose != 0 )
@@ -410,6 +778,13 @@ on_error:
 		memory_free(
 		 cluster_table_data );
 	}
+	if( cluster_table->subcluster_bitmaps != NULL )
+	{
+		memory_free(
+		 cluster_table->subcluster_bitmaps );
+
+		cluster_table->subcluster_bitmaps = NULL;
+	}
 	if( cluster_table->references != NULL )
 	{
 		memory_free(
@@ -417,6 +792,8 @@ on_error:
 
 		cluster_table->references = NULL;
 	}
+	cluster_table->number_of_references = 0;
+
 	return( -1 );
 }
 
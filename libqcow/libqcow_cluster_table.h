@@ -43,6 +43,16 @@ struct libqcow_cluster_table
 	/* The references
 	 */
 	uint64_t *references;
+
+	/* The (memory mapped) reference data
+	 * The references are stored in big-endian and are not owned by the cluster table
+	 */
+	const uint8_t *references_data;
+
+	/* The subcluster allocation bitmaps
+	 * Only set for extended level 2 table entries
+	 */
+	uint64_t *subcluster_bitmaps;
 };
 
 int libqcow_cluster_table_initialize(
@@ -53,6 +63,11 @@ int libqcow_cluster_table_free(
      libqcow_cluster_table_t **cluster_table,
      libcerror_error_t **error );
 
+int libqcow_cluster_table_clone(
+     libqcow_cluster_table_t **destination_cluster_table,
+     libqcow_cluster_table_t *source_cluster_table,
+     libcerror_error_t **error );
+
 int libqcow_cluster_table_get_number_of_references(
      libqcow_cluster_table_t *cluster_table,
      int *number_of_references,
@@ -64,11 +79,24 @@ int libqcow_cluster_table_get_reference_by_index(
      uint64_t *reference,
      libcerror_error_t **error );
 
+int libqcow_cluster_table_get_subcluster_bitmap_by_index(
+     libqcow_cluster_table_t *cluster_table,
+     int reference_index,
+     uint64_t *subcluster_bitmap,
+     libcerror_error_t **error );
+
+int libqcow_cluster_table_set_references_data(
+     libqcow_cluster_table_t *cluster_table,
+     const uint8_t *references_data,
+     size_t references_data_size,
+     libcerror_error_t **error );
+
 int libqcow_cluster_table_read(
      libqcow_cluster_table_t *cluster_table,
      libbfio_handle_t *file_io_handle,
      off64_t file_offset,
      size_t cluster_table_size,
+     size_t entry_size,
      libcerror_error_t **error );
 
 #if defined( __cplusplus )
@@ -0,0 +1,919 @@
+/*
+ * Cursor functions
+ *
+ * Copyright (C) 2010-2026, Joachim Metz <joachim.metz@gmail.com>
+ *
+ * Refer to AUTHORS for acknowledgements.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <common.h>
+#include <memory.h>
+#include <types.h>
+
+#include "libqcow_cursor.h"
+#include "libqcow_definitions.h"
+#include "libqcow_file.h"
+#include "libqcow_file_header.h"
+#include "libqcow_libcerror.h"
+#include "libqcow_libcthreads.h"
+#include "libqcow_types.h"
+
+/* Creates a cursor
+ * Make sure the value cursor is referencing, is set to NULL
+ * This function is not multi-thread safe acquire write lock of the file before call
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_cursor_initialize(
+     libqcow_cursor_t **cursor,
+     libqcow_file_t *file,
+     libcerror_error_t **error )
+{
+	libqcow_internal_cursor_t *internal_cursor = NULL;
+	libqcow_internal_file_t *internal_file     = NULL;
+	static char *function                      = "libqcow_cursor_initialize";
+
+	if( cursor == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid cursor.",
+		 function );
+
+		return( -1 );
+	}
+	if( *cursor != NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_ALREADY_SET,
+		 "%s: invalid cursor value already set.",
+		 function );
+
+		return( -1 );
+	}
+	if( file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	internal_file = (libqcow_internal_file_t *) file;
+
+	if( internal_file->file_header == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid file - missing file header.",
+		 function );
+
+		return( -1 );
+	}
+	internal_cursor = memory_allocate_structure(
+	                   libqcow_internal_cursor_t );
+
+	if( internal_cursor == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_INSUFFICIENT,
+		 "%s: unable to create cursor.",
+		 function );
+
+		goto on_error;
+	}
+	if( memory_set(
+	     internal_cursor,
+	     0,
+	     sizeof( libqcow_internal_cursor_t ) ) == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_SET_FAILED,
+		 "%s: unable to clear cursor.",
+		 function );
+
+		memory_free(
+		 internal_cursor );
+
+		return( -1 );
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_initialize(
+	     &( internal_cursor->read_write_lock ),
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+		 "%s: unable to initialize read/write lock.",
+		 function );
+
+		goto on_error;
+	}
+#endif
+	internal_cursor->file       = file;
+	internal_cursor->media_size = internal_file->file_header->media_size;
+
+	*cursor = (libqcow_cursor_t *) internal_cursor;
+
+	return( 1 );
+
+on_error:
+	if( internal_cursor != NULL )
+	{
+		memory_free(
+		 internal_cursor );
+	}
+	return( -1 );
+}
+
+/* Frees a cursor
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_cursor_free(
+     libqcow_cursor_t **cursor,
+     libcerror_error_t **error )
+{
+	libqcow_internal_cursor_t *internal_cursor = NULL;
+	libqcow_internal_file_t *internal_file     = NULL;
+	static char *function                      = "libqcow_cursor_free";
+	int result                                 = 1;
+
+	if( cursor == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid cursor.",
+		 function );
+
+		return( -1 );
+	}
+	if( *cursor == NULL )
+	{
+		return( 1 );
+	}
+	internal_cursor = (libqcow_internal_cursor_t *) *cursor;
+	internal_file   = (libqcow_internal_file_t *) internal_cursor->file;
+	*cursor         = NULL;
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_grab_for_write(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab read/write lock for writing.",
+		 function );
+
+		result = -1;
+	}
+	else
+#endif
+	{
+		internal_file->number_of_open_cursors -= 1;
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+		if( libcthreads_read_write_lock_release_for_write(
+		     internal_file->read_write_lock,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+			 "%s: unable to release read/write lock for writing.",
+			 function );
+
+			result = -1;
+		}
+#endif
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_free(
+	     &( internal_cursor->read_write_lock ),
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+		 "%s: unable to free read/write lock.",
+		 function );
+
+		result = -1;
+	}
+#endif
+	if( internal_cursor->readahead_data != NULL )
+	{
+		memory_free(
+		 internal_cursor->readahead_data );
+	}
+	memory_free(
+	 internal_cursor );
+
+	return( result );
+}
+
+/* Reads (media) data at a specific offset from the file into a buffer
+ * The read is stopped when the file was signalled to abort since the abort generation was retrieved
+ * The current offset of the file is not changed
+ * This function is not multi-thread safe acquire write lock of the cursor before call
+ * Returns the number of bytes read or -1 on error
+ */
+ssize_t libqcow_internal_cursor_read_buffer_from_file(
+         libqcow_internal_cursor_t *internal_cursor,
+         uint8_t *buffer,
+         size_t buffer_size,
+         off64_t offset,
+         uint32_t abort_generation,
+         libcerror_error_t **error )
+{
+	static char *function = "libqcow_internal_cursor_read_buffer_from_file";
+	ssize_t read_count    = 0;
+
+	if( internal_cursor == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid cursor.",
+		 function );
+
+		return( -1 );
+	}
+	if( internal_cursor->file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid cursor - missing file.",
+		 function );
+
+		return( -1 );
+	}
+	/* The file cannot be closed while the cursor is open
+	 */
+	read_count = libqcow_internal_file_read_buffer_at_offset(
+	              (libqcow_internal_file_t *) internal_cursor->file,
+	              buffer,
+	              buffer_size,
+	              offset,
+	              NULL,
+	              abort_generation,
+	              error );
+
+	if( read_count == -1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_IO,
+		 LIBCERROR_IO_ERROR_READ_FAILED,
+		 "%s: unable to read buffer from file.",
+		 function );
+
+		return( -1 );
+	}
+	return( read_count );
+}
+
+/* Reads (media) data from the current offset of the cursor into a buffer
+ * Sequential reads are served from the readahead data of the cursor, which is
+ * read from the file in increasingly larger parts, so that the read/write lock
+ * of the file is only grabbed when the readahead data is exhausted
+ * This function is not multi-thread safe acquire write lock before call
+ * Returns the number of bytes read or -1 on error
+ */
+ssize_t libqcow_internal_cursor_read_buffer(
+         libqcow_internal_cursor_t *internal_cursor,
+         void *buffer,
+         size_t buffer_size,
+         libcerror_error_t **error )
+{
+	static char *function     = "libqcow_internal_cursor_read_buffer";
+	size_t buffer_offset      = 0;
+	size_t read_size          = 0;
+	ssize_t read_count        = 0;
+	off64_t data_offset       = 0;
+	uint32_t abort_generation = 0;
+
+	if( internal_cursor == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid cursor.",
+		 function );
+
+		return( -1 );
+	}
+	if( internal_cursor->current_offset < 0 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid cursor - current offset value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	if( buffer == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid buffer.",
+		 function );
+
+		return( -1 );
+	}
+	if( buffer_size > (size_t) SSIZE_MAX )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_EXCEEDS_MAXIMUM,
+		 "%s: invalid buffer size value exceeds maximum.",
+		 function );
+
+		return( -1 );
+	}
+	if( (size64_t) internal_cursor->current_offset >= internal_cursor->media_size )
+	{
+		return( 0 );
+	}
+	if( (size64_t) buffer_size > ( internal_cursor->media_size - internal_cursor->current_offset ) )
+	{
+		buffer_size = (size_t) ( internal_cursor->media_size - internal_cursor->current_offset );
+	}
+	/* The read is stopped when the file is signalled to abort after this point
+	 */
+	if( libqcow_internal_file_get_abort_generation(
+	     (libqcow_internal_file_t *) internal_cursor->file,
+	     &abort_generation,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+		 "%s: unable to retrieve abort generation.",
+		 function );
+
+		return( -1 );
+	}
+	while( buffer_offset < buffer_size )
+	{
+		read_size = buffer_size - buffer_offset;
+
+		if( ( internal_cursor->readahead_data_size > 0 )
+		 && ( internal_cursor->current_offset >= internal_cursor->readahead_offset )
+		 && ( internal_cursor->current_offset < (off64_t) ( internal_cursor->readahead_offset + internal_cursor->readahead_data_size ) ) )
+		{
+			data_offset = internal_cursor->current_offset - internal_cursor->readahead_offset;
+
+			if( read_size > ( internal_cursor->readahead_data_size - (size_t) data_offset ) )
+			{
+				read_size = internal_cursor->readahead_data_size - (size_t) data_offset;
+			}
+			if( memory_copy(
+			     &( ( (uint8_t *) buffer )[ buffer_offset ] ),
+			     &( internal_cursor->readahead_data[ data_offset ] ),
+			     read_size ) == NULL )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_MEMORY,
+				 LIBCERROR_MEMORY_ERROR_COPY_FAILED,
+				 "%s: unable to copy readahead data.",
+				 function );
+
+				return( -1 );
+			}
+			read_count = (ssize_t) read_size;
+		}
+		else
+		{
+			if( internal_cursor->current_offset != internal_cursor->sequential_offset )
+			{
+				internal_cursor->readahead_size = 0;
+			}
+			else if( internal_cursor->readahead_size == 0 )
+			{
+				internal_cursor->readahead_size = LIBQCOW_CURSOR_MINIMUM_READAHEAD_SIZE;
+			}
+			else if( internal_cursor->readahead_size < LIBQCOW_CURSOR_MAXIMUM_READAHEAD_SIZE )
+			{
+				internal_cursor->readahead_size *= 2;
+			}
+			/* Random reads and reads that are at least the size of the readahead
+			 * are read directly into the buffer
+			 */
+			if( ( internal_cursor->readahead_size == 0 )
+			 || ( read_size >= internal_cursor->readahead_size ) )
+			{
+				read_count = libqcow_internal_cursor_read_buffer_from_file(
+				              internal_cursor,
+				              &( ( (uint8_t *) buffer )[ buffer_offset ] ),
+				              read_size,
+				              internal_cursor->current_offset,
+				              abort_generation,
+				              error );
+
+				if( read_count == -1 )
+				{
+					libcerror_error_set(
+					 error,
+					 LIBCERROR_ERROR_DOMAIN_IO,
+					 LIBCERROR_IO_ERROR_READ_FAILED,
+					 "%s: unable to read buffer from file.",
+					 function );
+
+					return( -1 );
+				}
+			}
+			else
+			{
+				if( internal_cursor->readahead_data == NULL )
+				{
+					internal_cursor->readahead_data = (uint8_t *) memory_allocate(
+					                                               sizeof( uint8_t ) * LIBQCOW_CURSOR_MAXIMUM_READAHEAD_SIZE );
+
+					if( internal_cursor->readahead_data == NULL )
+					{
+						libcerror_error_set(
+						 error,
+						 LIBCERROR_ERROR_DOMAIN_MEMORY,
+						 LIBCERROR_MEMORY_ERROR_INSUFFICIENT,
+						 "%s: unable to create readahead data.",
+						 function );
+
+						return( -1 );
+					}
+				}
+				internal_cursor->readahead_data_size = 0;
+
+				read_count = libqcow_internal_cursor_read_buffer_from_file(
+				              internal_cursor,
+				              internal_cursor->readahead_data,
+				              internal_cursor->readahead_size,
+				              internal_cursor->current_offset,
+				              abort_generation,
+				              error );
+
+				if( read_count == -1 )
+				{
+					libcerror_error_set(
+					 error,
+					 LIBCERROR_ERROR_DOMAIN_IO,
+					 LIBCERROR_IO_ERROR_READ_FAILED,
+					 "%s: unable to read readahead data from file.",
+					 function );
+
+					return( -1 );
+				}
+				internal_cursor->readahead_offset    = internal_cursor->current_offset;
+				internal_cursor->readahead_data_size = (size_t) read_count;
+
+				if( read_count > (ssize_t) read_size )
+				{
+					read_count = (ssize_t) read_size;
+				}
+				if( memory_copy(
+				     &( ( (uint8_t *) buffer )[ buffer_offset ] ),
+				     internal_cursor->readahead_data,
+				     (size_t) read_count ) == NULL )
+				{
+					libcerror_error_set(
+					 error,
+					 LIBCERROR_ERROR_DOMAIN_MEMORY,
+					 LIBCERROR_MEMORY_ERROR_COPY_FAILED,
+					 "%s: unable to copy readahead data.",
+					 function );
+
+					return( -1 );
+				}
+			}
+		}
+		if( read_count == 0 )
+		{
+			break;
+		}
+		buffer_offset                     += (size_t) read_count;
+		internal_cursor->current_offset   += (off64_t) read_count;
+		internal_cursor->sequential_offset = internal_cursor->current_offset;
+	}
+	return( (ssize_t) buffer_offset );
+}
+
+/* Reads (media) data of the cursor from the current offset into a buffer
+ * Returns the number of bytes read or -1 on error
+ */
+ssize_t libqcow_cursor_read_buffer(
+         libqcow_cursor_t *cursor,
+         void *buffer,
+         size_t buffer_size,
+         libcerror_error_t **error )
+{
+	libqcow_internal_cursor_t *internal_cursor = NULL;
+	static char *function                      = "libqcow_cursor_read_buffer";
+	ssize_t read_count                         = 0;
+
+	if( cursor == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid cursor.",
+		 function );
+
+		return( -1 );
+	}
+	internal_cursor = (libqcow_internal_cursor_t *) cursor;
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_grab_for_write(
+	     internal_cursor->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab read/write lock for writing.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	read_count = libqcow_internal_cursor_read_buffer(
+		      internal_cursor,
+		      buffer,
+		      buffer_size,
+		      error );
+
+	if( read_count == -1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_IO,
+		 LIBCERROR_IO_ERROR_READ_FAILED,
+		 "%s: unable to read buffer.",
+		 function );
+
+		read_count = -1;
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_release_for_write(
+	     internal_cursor->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release read/write lock for writing.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	return( read_count );
+}
+
+/* Reads (media) data of the cursor at a specific offset
+ * Returns the number of bytes read or -1 on error
+ */
+ssize_t libqcow_cursor_read_buffer_at_offset(
+         libqcow_cursor_t *cursor,
+         void *buffer,
+         size_t buffer_size,
+         off64_t offset,
+         libcerror_error_t **error )
+{
+	libqcow_internal_cursor_t *internal_cursor = NULL;
+	static char *function                      = "libqcow_cursor_read_buffer_at_offset";
+	ssize_t read_count                         = 0;
+
+	if( cursor == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid cursor.",
+		 function );
+
+		return( -1 );
+	}
+	internal_cursor = (libqcow_internal_cursor_t *) cursor;
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_grab_for_write(
+	     internal_cursor->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab read/write lock for writing.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	if( libqcow_internal_cursor_seek_offset(
+	     internal_cursor,
+	     offset,
+	     SEEK_SET,
+	     error ) == -1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_IO,
+		 LIBCERROR_IO_ERROR_SEEK_FAILED,
+		 "%s: unable to seek offset.",
+		 function );
+
+		read_count = -1;
+	}
+	else
+	{
+		read_count = libqcow_internal_cursor_read_buffer(
+			      internal_cursor,
+			      buffer,
+			      buffer_size,
+			      error );
+
+		if( read_count == -1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_IO,
+			 LIBCERROR_IO_ERROR_READ_FAILED,
+			 "%s: unable to read buffer.",
+			 function );
+
+			read_count = -1;
+		}
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_release_for_write(
+	     internal_cursor->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release read/write lock for writing.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	return( read_count );
+}
+
+/* Seeks a certain offset of the (media) data of the cursor
+ * This function is not multi-thread safe acquire write lock before call
+ * Returns the offset if seek is successful or -1 on error
+ */
+off64_t libqcow_internal_cursor_seek_offset(
+         libqcow_internal_cursor_t *internal_cursor,
+         off64_t offset,
+         int whence,
+         libcerror_error_t **error )
+{
+	static char *function = "libqcow_internal_cursor_seek_offset";
+
+	if( internal_cursor == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid cursor.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( whence != SEEK_CUR )
+	 && ( whence != SEEK_END )
+	 && ( whence != SEEK_SET ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_UNSUPPORTED_VALUE,
+		 "%s: unsupported whence.",
+		 function );
+
+		return( -1 );
+	}
+	if( whence == SEEK_CUR )
+	{
+		offset += internal_cursor->current_offset;
+	}
+	else if( whence == SEEK_END )
+	{
+		offset += (off64_t) internal_cursor->media_size;
+	}
+	if( offset < 0 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid offset value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	internal_cursor->current_offset = offset;
+
+	return( offset );
+}
+
+/* Seeks a certain offset of the (media) data of the cursor
+ * Returns the offset if seek is successful or -1 on error
+ */
+off64_t libqcow_cursor_seek_offset(
+         libqcow_cursor_t *cursor,
+         off64_t offset,
+         int whence,
+         libcerror_error_t **error )
+{
+	libqcow_internal_cursor_t *internal_cursor = NULL;
+	static char *function                      = "libqcow_cursor_seek_offset";
+
+	if( cursor == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid cursor.",
+		 function );
+
+		return( -1 );
+	}
+	internal_cursor = (libqcow_internal_cursor_t *) cursor;
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_grab_for_write(
+	     internal_cursor->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab read/write lock for writing.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	offset = libqcow_internal_cursor_seek_offset(
+	          internal_cursor,
+	          offset,
+	          whence,
+	          error );
+
+	if( offset == -1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_IO,
+		 LIBCERROR_IO_ERROR_SEEK_FAILED,
+		 "%s: unable to seek offset.",
+		 function );
+
+		offset = -1;
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_release_for_write(
+	     internal_cursor->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release read/write lock for writing.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	return( offset );
+}
+
+/* Retrieves the current offset of the (media) data of the cursor
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_cursor_get_offset(
+     libqcow_cursor_t *cursor,
+     off64_t *offset,
+     libcerror_error_t **error )
+{
+	libqcow_internal_cursor_t *internal_cursor = NULL;
+	static char *function                      = "libqcow_cursor_get_offset";
+
+	if( cursor == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid cursor.",
+		 function );
+
+		return( -1 );
+	}
+	internal_cursor = (libqcow_internal_cursor_t *) cursor;
+
+	if( offset == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid offset.",
+		 function );
+
+		return( -1 );
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_grab_for_read(
+	     internal_cursor->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab read/write lock for reading.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	*offset = internal_cursor->current_offset;
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_release_for_read(
+	     internal_cursor->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release read/write lock for reading.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	return( 1 );
+}
+
@@ -0,0 +1,146 @@
+/*
+ * Cursor functions
+ *
+ * Copyright (C) 2010-2026, Joachim Metz <joachim.metz@gmail.com>
+ *
+ * Refer to AUTHORS for acknowledgements.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#if !defined( _LIBQCOW_INTERNAL_CURSOR_H )
+#define _LIBQCOW_INTERNAL_CURSOR_H
+
+#include <common.h>
+#include <types.h>
+
+#include "libqcow_extern.h"
+#include "libqcow_libcerror.h"
+#include "libqcow_libcthreads.h"
+#include "libqcow_types.h"
+
+#if defined( __cplusplus )
+extern "C" {
+#endif
+
+typedef struct libqcow_internal_cursor libqcow_internal_cursor_t;
+
+struct libqcow_internal_cursor
+{
+	/* The file that contains the cursor
+	 */
+	libqcow_file_t *file;
+
+	/* The media size
+	 */
+	size64_t media_size;
+
+	/* The current (storage media) offset
+	 */
+	off64_t current_offset;
+
+	/* The (storage media) offset at which the previous read ended
+	 * Used to detect sequential reads
+	 */
+	off64_t sequential_offset;
+
+	/* The readahead data
+	 */
+	uint8_t *readahead_data;
+
+	/* The (storage media) offset of the readahead data
+	 */
+	off64_t readahead_offset;
+
+	/* The number of bytes in the readahead data
+	 */
+	size_t readahead_data_size;
+
+	/* The readahead size
+	 * Contains 0 if the reads are not sequential
+	 */
+	size_t readahead_size;
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	/* The read/write lock
+	 */
+	libcthreads_read_write_lock_t *read_write_lock;
+#endif
+};
+
+int libqcow_cursor_initialize(
+     libqcow_cursor_t **cursor,
+     libqcow_file_t *file,
+     libcerror_error_t **error );
+
+LIBQCOW_EXTERN \
+int libqcow_cursor_free(
+     libqcow_cursor_t **cursor,
+     libcerror_error_t **error );
+
+ssize_t libqcow_internal_cursor_read_buffer_from_file(
+         libqcow_internal_cursor_t *internal_cursor,
+         uint8_t *buffer,
+         size_t buffer_size,
+         off64_t offset,
+         uint32_t abort_generation,
+         libcerror_error_t **error );
+
+ssize_t libqcow_internal_cursor_read_buffer(
+         libqcow_internal_cursor_t *internal_cursor,
+         void *buffer,
+         size_t buffer_size,
+         libcerror_error_t **error );
+
+LIBQCOW_EXTERN \
+ssize_t libqcow_cursor_read_buffer(
+         libqcow_cursor_t *cursor,
+         void *buffer,
+         size_t buffer_size,
+         libcerror_error_t **error );
+
+LIBQCOW_EXTERN \
+ssize_t libqcow_cursor_read_buffer_at_offset(
+         libqcow_cursor_t *cursor,
+         void *buffer,
+         size_t buffer_size,
+         off64_t offset,
+         libcerror_error_t **error );
+
+off64_t libqcow_internal_cursor_seek_offset(
+         libqcow_internal_cursor_t *internal_cursor,
+         off64_t offset,
+         int whence,
+         libcerror_error_t **error );
+
+LIBQCOW_EXTERN \
+off64_t libqcow_cursor_seek_offset(
+         libqcow_cursor_t *cursor,
+         off64_t offset,
+         int whence,
+         libcerror_error_t **error );
+
+LIBQCOW_EXTERN \
+int libqcow_cursor_get_offset(
+     libqcow_cursor_t *cursor,
+     off64_t *offset,
+     libcerror_error_t **error );
+
+#if defined( __cplusplus )
+}
+#endif
+
+#endif /* !defined( _LIBQCOW_INTERNAL_CURSOR_H ) */
+
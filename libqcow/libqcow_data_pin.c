@@ -0,0 +1,259 @@
+/*
+ * Data pin functions
+ *
+ * Copyright (C) 2010-2026, Joachim Metz <joachim.metz@gmail.com>
+ *
+ * Refer to AUTHORS for acknowledgements.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <common.h>
+#include <memory.h>
+#include <types.h>
+
+#include "libqcow_cache_pool.h"
+#include "libqcow_cluster_block.h"
+#include "libqcow_data_pin.h"
+#include "libqcow_file.h"
+#include "libqcow_libcerror.h"
+#include "libqcow_libcthreads.h"
+#include "libqcow_types.h"
+
+/* Creates a data pin
+ * Make sure the value data_pin is referencing, is set to NULL
+ * The cluster block must already be pinned, the data pin takes over that pin
+ * and the parent data pin if set
+ * The cache pool is set if the cluster block was pinned in the cache pool
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_data_pin_initialize(
+     libqcow_data_pin_t **data_pin,
+     libqcow_file_t *file,
+     libqcow_cluster_block_t *cluster_block,
+     libqcow_cache_pool_t *cache_pool,
+     libqcow_data_pin_t *parent_data_pin,
+     libcerror_error_t **error )
+{
+	libqcow_internal_data_pin_t *internal_data_pin = NULL;
+	static char *function                          = "libqcow_data_pin_initialize";
+
+	if( data_pin == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid data pin.",
+		 function );
+
+		return( -1 );
+	}
+	if( *data_pin != NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_ALREADY_SET,
+		 "%s: invalid data pin value already set.",
+		 function );
+
+		return( -1 );
+	}
+	if( file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( cluster_block == NULL )
+	 && ( parent_data_pin == NULL ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid cluster block and parent data pin.",
+		 function );
+
+		return( -1 );
+	}
+	internal_data_pin = memory_allocate_structure(
+	                     libqcow_internal_data_pin_t );
+
+	if( internal_data_pin == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_INSUFFICIENT,
+		 "%s: unable to create data pin.",
+		 function );
+
+		return( -1 );
+	}
+	if( memory_set(
+	     internal_data_pin,
+	     0,
+	     sizeof( libqcow_internal_data_pin_t ) ) == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_SET_FAILED,
+		 "%s: unable to clear data pin.",
+		 function );
+
+		memory_free(
+		 internal_data_pin );
+
+		return( -1 );
+	}
+	internal_data_pin->file            = file;
+	internal_data_pin->cluster_block   = cluster_block;
+	internal_data_pin->cache_pool      = cache_pool;
+	internal_data_pin->parent_data_pin = parent_data_pin;
+
+	*data_pin = (libqcow_data_pin_t *) internal_data_pin;
+
+	return( 1 );
+}
+
+/* Frees a data pin
+ * Releases the pinned data, after which the data pointer is no longer valid
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_data_pin_free(
+     libqcow_data_pin_t **data_pin,
+     libcerror_error_t **error )
+{
+	libqcow_internal_data_pin_t *internal_data_pin = NULL;
+	libqcow_internal_file_t *internal_file         = NULL;
+	static char *function                          = "libqcow_data_pin_free";
+	int result                                     = 1;
+
+	if( data_pin == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid data pin.",
+		 function );
+
+		return( -1 );
+	}
+	if( *data_pin == NULL )
+	{
+		return( 1 );
+	}
+	internal_data_pin = (libqcow_internal_data_pin_t *) *data_pin;
+	internal_file     = (libqcow_internal_file_t *) internal_data_pin->file;
+	*data_pin         = NULL;
+
+	if( internal_data_pin->parent_data_pin != NULL )
+	{
+		if( libqcow_data_pin_free(
+		     &( internal_data_pin->parent_data_pin ),
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+			 "%s: unable to free parent data pin.",
+			 function );
+
+			result = -1;
+		}
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_grab_for_write(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab read/write lock for writing.",
+		 function );
+
+		memory_free(
+		 internal_data_pin );
+
+		return( -1 );
+	}
+#endif
+	if( internal_data_pin->cache_pool != NULL )
+	{
+		if( libqcow_cache_pool_unpin_cluster_block(
+		     internal_data_pin->cache_pool,
+		     &( internal_data_pin->cluster_block ),
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+			 "%s: unable to unpin cache pool cluster block.",
+			 function );
+
+			result = -1;
+		}
+	}
+	else if( internal_data_pin->cluster_block != NULL )
+	{
+		if( libqcow_cluster_block_unpin(
+		     &( internal_data_pin->cluster_block ),
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+			 "%s: unable to unpin cluster block.",
+			 function );
+
+			result = -1;
+		}
+	}
+	internal_file->number_of_data_pins -= 1;
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_release_for_write(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release read/write lock for writing.",
+		 function );
+
+		result = -1;
+	}
+#endif
+	memory_free(
+	 internal_data_pin );
+
+	return( result );
+}
+
@@ -0,0 +1,77 @@
+/*
+ * Data pin functions
+ *
+ * Copyright (C) 2010-2026, Joachim Metz <joachim.metz@gmail.com>
+ *
+ * Refer to AUTHORS for acknowledgements.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#if !defined( _LIBQCOW_INTERNAL_DATA_PIN_H )
+#define _LIBQCOW_INTERNAL_DATA_PIN_H
+
+#include <common.h>
+#include <types.h>
+
+#include "libqcow_cluster_block.h"
+#include "libqcow_extern.h"
+#include "libqcow_libcerror.h"
+#include "libqcow_types.h"
+
+#if defined( __cplusplus )
+extern "C" {
+#endif
+
+typedef struct libqcow_internal_data_pin libqcow_internal_data_pin_t;
+
+struct libqcow_internal_data_pin
+{
+	/* The file that owns the pinned data
+	 */
+	libqcow_file_t *file;
+
+	/* The pinned cluster block
+	 */
+	libqcow_cluster_block_t *cluster_block;
+
+	/* The cache pool that contains the pinned cluster block
+	 * Contains NULL if the cluster block is not in a cache pool
+	 */
+	libqcow_cache_pool_t *cache_pool;
+
+	/* The data pin of the parent (backing) file
+	 */
+	libqcow_data_pin_t *parent_data_pin;
+};
+
+int libqcow_data_pin_initialize(
+     libqcow_data_pin_t **data_pin,
+     libqcow_file_t *file,
+     libqcow_cluster_block_t *cluster_block,
+     libqcow_cache_pool_t *cache_pool,
+     libqcow_data_pin_t *parent_data_pin,
+     libcerror_error_t **error );
+
+LIBQCOW_EXTERN \
+int libqcow_data_pin_free(
+     libqcow_data_pin_t **data_pin,
+     libcerror_error_t **error );
+
+#if defined( __cplusplus )
+}
+#endif
+
+#endif /* !defined( _LIBQCOW_INTERNAL_DATA_PIN_H ) */
+
@@ -0,0 +1,427 @@
+/*
+ * Decode job functions
+ *
+ * Copyright (C) 2010-2026, Joachim Metz <joachim.metz@gmail.com>
+ *
+ * Refer to AUTHORS for acknowledgements.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <common.h>
+#include <memory.h>
+#include <types.h>
+
+#include "libqcow_compression.h"
+#include "libqcow_decode_job.h"
+#include "libqcow_definitions.h"
+#include "libqcow_encryption.h"
+#include "libqcow_file.h"
+#include "libqcow_file_io_pool.h"
+#include "libqcow_libbfio.h"
+#include "libqcow_libcerror.h"
+#include "libqcow_types.h"
+#include "libqcow_unused.h"
+
+/* Creates a decode job
+ * Make sure the value decode_job is referencing, is set to NULL
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_decode_job_initialize(
+     libqcow_decode_job_t **decode_job,
+     libqcow_file_t *file,
+     uint8_t decode_type,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_decode_job_initialize";
+
+	if( decode_job == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid decode job.",
+		 function );
+
+		return( -1 );
+	}
+	if( *decode_job != NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_ALREADY_SET,
+		 "%s: invalid decode job value already set.",
+		 function );
+
+		return( -1 );
+	}
+	if( file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( decode_type != LIBQCOW_DECODE_JOB_TYPE_DECOMPRESS )
+	 && ( decode_type != LIBQCOW_DECODE_JOB_TYPE_DECRYPT )
+	 && ( decode_type != LIBQCOW_DECODE_JOB_TYPE_READ_COMPRESSED )
+	 && ( decode_type != LIBQCOW_DECODE_JOB_TYPE_READ_ENCRYPTED ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_UNSUPPORTED_VALUE,
+		 "%s: unsupported decode type.",
+		 function );
+
+		return( -1 );
+	}
+	*decode_job = memory_allocate_structure(
+	               libqcow_decode_job_t );
+
+	if( *decode_job == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_INSUFFICIENT,
+		 "%s: unable to create decode job.",
+		 function );
+
+		goto on_error;
+	}
+	if( memory_set(
+	     *decode_job,
+	     0,
+	     sizeof( libqcow_decode_job_t ) ) == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_SET_FAILED,
+		 "%s: unable to clear decode job.",
+		 function );
+
+		goto on_error;
+	}
+	( *decode_job )->file        = file;
+	( *decode_job )->decode_type = decode_type;
+
+	return( 1 );
+
+on_error:
+	if( *decode_job != NULL )
+	{
+		memory_free(
+		 *decode_job );
+
+		*decode_job = NULL;
+	}
+	return( -1 );
+}
+
+/* Frees a decode job
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_decode_job_free(
+     libqcow_decode_job_t **decode_job,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_decode_job_free";
+
+	if( decode_job == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid decode job.",
+		 function );
+
+		return( -1 );
+	}
+	if( *decode_job != NULL )
+	{
+		if( ( *decode_job )->decode_error != NULL )
+		{
+			libcerror_error_free(
+			 &( ( *decode_job )->decode_error ) );
+		}
+		memory_free(
+		 *decode_job );
+
+		*decode_job = NULL;
+	}
+	return( 1 );
+}
+
+/* Runs a decode job
+ * The decode does not modify the file and does not require the read/write lock
+ * of the file, the file IO handles are taken from the file IO pool
+ * and the encryption context of the file is copied
+ * The caller must make sure the file is not closed during the decode
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_decode_job_run(
+     libqcow_decode_job_t *decode_job,
+     libcerror_error_t **error )
+{
+	libbfio_handle_t *file_io_handle                 = NULL;
+	libqcow_encryption_context_t *encryption_context = NULL;
+	libqcow_internal_file_t *internal_file           = NULL;
+	static char *function                            = "libqcow_decode_job_run";
+	size_t data_size                                 = 0;
+	ssize_t read_count                               = 0;
+	int result                                       = 1;
+
+	if( decode_job == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid decode job.",
+		 function );
+
+		return( -1 );
+	}
+	if( decode_job->file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid decode job - missing file.",
+		 function );
+
+		return( -1 );
+	}
+	if( decode_job->buffer == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid decode job - missing buffer.",
+		 function );
+
+		return( -1 );
+	}
+	internal_file = (libqcow_internal_file_t *) decode_job->file;
+
+	if( ( decode_job->decode_type == LIBQCOW_DECODE_JOB_TYPE_DECOMPRESS )
+	 || ( decode_job->decode_type == LIBQCOW_DECODE_JOB_TYPE_DECRYPT ) )
+	{
+		if( decode_job->data == NULL )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+			 "%s: invalid decode job - missing data.",
+			 function );
+
+			return( -1 );
+		}
+	}
+	switch( decode_job->decode_type )
+	{
+		case LIBQCOW_DECODE_JOB_TYPE_DECOMPRESS:
+			data_size = decode_job->buffer_size;
+
+			if( libqcow_decompress_data(
+			     decode_job->data,
+			     decode_job->data_size,
+			     LIBQCOW_COMPRESSION_METHOD_DEFLATE,
+			     decode_job->buffer,
+			     &data_size,
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_ENCRYPTION,
+				 LIBCERROR_ENCRYPTION_ERROR_GENERIC,
+				 "%s: unable to decompress data.",
+				 function );
+
+				return( -1 );
+			}
+			break;
+
+		case LIBQCOW_DECODE_JOB_TYPE_DECRYPT:
+			/* The AES contexts of the file cannot be used by multiple threads at the same time
+			 * and the encryption context does not change while the file is open
+			 */
+			if( libqcow_encryption_clone(
+			     &encryption_context,
+			     internal_file->encryption_context,
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+				 "%s: unable to create encryption context.",
+				 function );
+
+				return( -1 );
+			}
+			/* The data is encrypted per sector of 512 bytes, where the block key
+			 * is the (media) sector number
+			 */
+			if( libqcow_encryption_crypt(
+			     encryption_context,
+			     LIBQCOW_ENCYPTION_CRYPT_MODE_DECRYPT,
+			     decode_job->data,
+			     decode_job->data_size,
+			     decode_job->buffer,
+			     decode_job->buffer_size,
+			     (uint64_t) decode_job->offset / 512,
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_ENCRYPTION,
+				 LIBCERROR_ENCRYPTION_ERROR_GENERIC,
+				 "%s: unable to decrypt data.",
+				 function );
+
+				result = -1;
+			}
+			if( libqcow_encryption_free(
+			     &encryption_context,
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+				 "%s: unable to free encryption context.",
+				 function );
+
+				result = -1;
+			}
+			break;
+
+		case LIBQCOW_DECODE_JOB_TYPE_READ_COMPRESSED:
+		case LIBQCOW_DECODE_JOB_TYPE_READ_ENCRYPTED:
+			/* The file IO pool is not freed while the file is open
+			 */
+			if( libqcow_file_io_pool_grab_handle(
+			     internal_file->file_io_pool,
+			     &file_io_handle,
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+				 "%s: unable to grab file IO handle from file IO pool.",
+				 function );
+
+				return( -1 );
+			}
+			if( decode_job->decode_type == LIBQCOW_DECODE_JOB_TYPE_READ_COMPRESSED )
+			{
+				read_count = libqcow_internal_file_read_compressed_buffer_at_offset(
+				              internal_file,
+				              file_io_handle,
+				              (uint64_t) decode_job->file_offset,
+				              (uint64_t) decode_job->offset & internal_file->cluster_block_bit_mask,
+				              decode_job->buffer,
+				              decode_job->buffer_size,
+				              error );
+			}
+			else
+			{
+				read_count = libqcow_internal_file_read_encrypted_buffer_at_offset(
+				              internal_file,
+				              file_io_handle,
+				              decode_job->file_offset,
+				              decode_job->offset,
+				              decode_job->buffer,
+				              decode_job->buffer_size,
+				              error );
+			}
+			if( read_count != (ssize_t) decode_job->buffer_size )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_IO,
+				 LIBCERROR_IO_ERROR_READ_FAILED,
+				 "%s: unable to read: %" PRIzd " bytes at offset: %" PRIi64 " (0x%08" PRIx64 ").",
+				 function,
+				 decode_job->buffer_size,
+				 decode_job->offset,
+				 decode_job->offset );
+
+				result = -1;
+			}
+			if( libqcow_file_io_pool_release_handle(
+			     internal_file->file_io_pool,
+			     file_io_handle,
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+				 "%s: unable to release file IO handle to file IO pool.",
+				 function );
+
+				result = -1;
+			}
+			break;
+
+		default:
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_UNSUPPORTED_VALUE,
+			 "%s: invalid decode job - unsupported decode type.",
+			 function );
+
+			return( -1 );
+	}
+	return( result );
+}
+
+/* The scheduler callback function of a decode job
+ * The decode error is retained by the decode job
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_decode_job_callback(
+     libqcow_decode_job_t *decode_job,
+     void *arguments LIBQCOW_ATTRIBUTE_UNUSED )
+{
+	LIBQCOW_UNREFERENCED_PARAMETER( arguments )
+
+	if( decode_job == NULL )
+	{
+		return( -1 );
+	}
+	if( libqcow_decode_job_run(
+	     decode_job,
+	     &( decode_job->decode_error ) ) != 1 )
+	{
+		return( -1 );
+	}
+	return( 1 );
+}
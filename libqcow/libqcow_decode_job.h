@@ -0,0 +1,102 @@
+/*
+ * Decode job functions
+ *
+ * Copyright (C) 2010-2026, Joachim Metz <joachim.metz@gmail.com>
+ *
+ * Refer to AUTHORS for acknowledgements.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#if !defined( _LIBQCOW_DECODE_JOB_H )
+#define _LIBQCOW_DECODE_JOB_H
+
+#include <common.h>
+#include <types.h>
+
+#include "libqcow_libcerror.h"
+#include "libqcow_types.h"
+
+#if defined( __cplusplus )
+extern "C" {
+#endif
+
+typedef struct libqcow_decode_job libqcow_decode_job_t;
+
+struct libqcow_decode_job
+{
+	/* The file that contains the data
+	 */
+	libqcow_file_t *file;
+
+	/* The decode type
+	 */
+	uint8_t decode_type;
+
+	/* The encoded data, used to decompress or decrypt
+	 */
+	const uint8_t *data;
+
+	/* The encoded data size
+	 */
+	size_t data_size;
+
+	/* The buffer that receives the decoded data
+	 */
+	uint8_t *buffer;
+
+	/* The buffer size
+	 */
+	size_t buffer_size;
+
+	/* The file offset, of the encrypted range or of the compressed cluster block, used to read
+	 */
+	off64_t file_offset;
+
+	/* The (media) offset of the decoded data
+	 */
+	off64_t offset;
+
+	/* The error of the decode
+	 */
+	libcerror_error_t *decode_error;
+
+	/* The next decode job
+	 */
+	libqcow_decode_job_t *next_decode_job;
+};
+
+int libqcow_decode_job_initialize(
+     libqcow_decode_job_t **decode_job,
+     libqcow_file_t *file,
+     uint8_t decode_type,
+     libcerror_error_t **error );
+
+int libqcow_decode_job_free(
+     libqcow_decode_job_t **decode_job,
+     libcerror_error_t **error );
+
+int libqcow_decode_job_run(
+     libqcow_decode_job_t *decode_job,
+     libcerror_error_t **error );
+
+int libqcow_decode_job_callback(
+     libqcow_decode_job_t *decode_job,
+     void *arguments );
+
+#if defined( __cplusplus )
+}
+#endif
+
+#endif /* !defined( _LIBQCOW_DECODE_JOB_H ) */
@@ -164,6 +164,20 @@ int libqcow_encryption_free(
 	}
 	if( *context != NULL )
 	{
+		if( memory_set(
+		     ( *context )->key,
+		     0,
+		     16 ) == NULL )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_MEMORY,
+			 LIBCERROR_MEMORY_ERROR_SET_FAILED,
+			 "%s: unable to clear key.",
+			 function );
+
+			result = -1;
+		}
 		if( libcaes_context_free(
 		     &( ( *context )->decryption_context ),
 		     error ) != 1 )
@@ -198,6 +212,90 @@ int libqcow_encryption_free(
 	return( result );
 }
 
+/* Clones an encryption context
+ * The AES contexts cannot be used by multiple threads at the same time,
+ * the clone has AES contexts of its own with the same key
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_encryption_clone(
+     libqcow_encryption_context_t **destination_context,
+     libqcow_encryption_context_t *source_context,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_encryption_clone";
+
+	if( destination_context == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid destination context.",
+		 function );
+
+		return( -1 );
+	}
+	if( *destination_context != NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_ALREADY_SET,
+		 "%s: invalid destination context value already set.",
+		 function );
+
+		return( -1 );
+	}
+	if( source_context == NULL )
+	{
+		*destination_context = NULL;
+
+		return( 1 );
+	}
+	if( libqcow_encryption_initialize(
+	     destination_context,
+	     source_context->method,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+		 "%s: unable to create destination context.",
+		 function );
+
+		goto on_error;
+	}
+	if( source_context->key_is_set != 0 )
+	{
+		if( libqcow_encryption_set_keys(
+		     *destination_context,
+		     source_context->key,
+		     16,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+			 "%s: unable to set keys in destination context.",
+			 function );
+
+			goto on_error;
+		}
+	}
+	return( 1 );
+
+on_error:
+	if( *destination_context != NULL )
+	{
+		libqcow_encryption_free(
+		 destination_context,
+		 NULL );
+	}
+	return( -1 );
+}
+
 /* Sets the de- and encryption keys
  * Returns 1 if successful or -1 on error
  */
@@ -285,6 +383,22 @@ int libqcow_encryption_set_keys(
 
 		return( -1 );
 	}
+	if( memory_copy(
+	     context->key,
+	     key,
+	     16 ) == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_COPY_FAILED,
+		 "%s: unable to copy key.",
+		 function );
+
+		return( -1 );
+	}
+	context->key_is_set = 1;
+
 	return( 1 );
 }
 
@@ -53,6 +53,14 @@ struct libqcow_encryption_context
 	/* The (AES) encryption context
 	 */
 	libcaes_context_t *encryption_context;
+
+	/* The key
+	 */
+	uint8_t key[ 16 ];
+
+	/* Value to indicate the key is set
+	 */
+	uint8_t key_is_set;
 };
 
 int libqcow_encryption_initialize(
@@ -64,6 +72,11 @@ int libqcow_encryption_free(
      libqcow_encryption_context_t **context,
      libcerror_error_t **error );
 
+int libqcow_encryption_clone(
+     libqcow_encryption_context_t **destination_context,
+     libqcow_encryption_context_t *source_context,
+     libcerror_error_t **error );
+
 int libqcow_encryption_set_keys(
      libqcow_encryption_context_t *context,
      const uint8_t *key,
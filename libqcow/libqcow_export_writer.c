@@ -0,0 +1,1578 @@
+/*
+ * Export writer functions
+ *
+ * Copyright (C) 2010-2026, Joachim Metz <joachim.metz@gmail.com>
+ *
+ * Refer to AUTHORS for acknowledgements.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <common.h>
+#include <byte_stream.h>
+#include <memory.h>
+#include <types.h>
+
+#include "libqcow_definitions.h"
+#include "libqcow_export_writer.h"
+#include "libqcow_io_handle.h"
+#include "libqcow_libbfio.h"
+#include "libqcow_libcerror.h"
+#include "libqcow_libcthreads.h"
+
+#include "qcow_file_header.h"
+
+/* Creates an export chunk
+ * Make sure the value export_chunk is referencing, is set to NULL
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_export_chunk_initialize(
+     libqcow_export_chunk_t **export_chunk,
+     off64_t offset,
+     size_t data_size,
+     size_t cluster_block_size,
+     libcerror_error_t **error )
+{
+	static char *function     = "libqcow_export_chunk_initialize";
+	size_t allocated_size     = 0;
+
+	if( export_chunk == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid export chunk.",
+		 function );
+
+		return( -1 );
+	}
+	if( *export_chunk != NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_ALREADY_SET,
+		 "%s: invalid export chunk value already set.",
+		 function );
+
+		return( -1 );
+	}
+	if( offset < 0 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_LESS_THAN_ZERO,
+		 "%s: invalid offset value less than zero.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( cluster_block_size == 0 )
+	 || ( cluster_block_size > (size_t) MEMORY_MAXIMUM_ALLOCATION_SIZE ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid cluster block size value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( data_size == 0 )
+	 || ( data_size > ( (size_t) MEMORY_MAXIMUM_ALLOCATION_SIZE - cluster_block_size ) ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid data size value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	allocated_size = data_size;
+
+	if( ( allocated_size % cluster_block_size ) != 0 )
+	{
+		allocated_size += cluster_block_size - ( allocated_size % cluster_block_size );
+	}
+	*export_chunk = memory_allocate_structure(
+	                 libqcow_export_chunk_t );
+
+	if( *export_chunk == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_INSUFFICIENT,
+		 "%s: unable to create export chunk.",
+		 function );
+
+		goto on_error;
+	}
+	if( memory_set(
+	     *export_chunk,
+	     0,
+	     sizeof( libqcow_export_chunk_t ) ) == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_SET_FAILED,
+		 "%s: unable to clear export chunk.",
+		 function );
+
+		memory_free(
+		 *export_chunk );
+
+		*export_chunk = NULL;
+
+		return( -1 );
+	}
+	( *export_chunk )->data = (uint8_t *) memory_allocate(
+	                                       sizeof( uint8_t ) * allocated_size );
+
+	if( ( *export_chunk )->data == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_INSUFFICIENT,
+		 "%s: unable to create data.",
+		 function );
+
+		goto on_error;
+	}
+	/* The data is read into the chunk hence only the padding needs to be cleared
+	 */
+	if( allocated_size > data_size )
+	{
+		if( memory_set(
+		     &( ( ( *export_chunk )->data )[ data_size ] ),
+		     0,
+		     allocated_size - data_size ) == NULL )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_MEMORY,
+			 LIBCERROR_MEMORY_ERROR_SET_FAILED,
+			 "%s: unable to clear data padding.",
+			 function );
+
+			goto on_error;
+		}
+	}
+	( *export_chunk )->offset    = offset;
+	( *export_chunk )->data_size = data_size;
+
+	return( 1 );
+
+on_error:
+	if( *export_chunk != NULL )
+	{
+		if( ( *export_chunk )->data != NULL )
+		{
+			memory_free(
+			 ( *export_chunk )->data );
+		}
+		memory_free(
+		 *export_chunk );
+
+		*export_chunk = NULL;
+	}
+	return( -1 );
+}
+
+/* Frees an export chunk
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_export_chunk_free(
+     libqcow_export_chunk_t **export_chunk,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_export_chunk_free";
+
+	if( export_chunk == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid export chunk.",
+		 function );
+
+		return( -1 );
+	}
+	if( *export_chunk != NULL )
+	{
+		if( ( *export_chunk )->data != NULL )
+		{
+			memory_free(
+			 ( *export_chunk )->data );
+		}
+		memory_free(
+		 *export_chunk );
+
+		*export_chunk = NULL;
+	}
+	return( 1 );
+}
+
+/* Creates an export writer
+ * Make sure the value export_writer is referencing, is set to NULL
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_export_writer_initialize(
+     libqcow_export_writer_t **export_writer,
+     libbfio_handle_t *file_io_handle,
+     int export_format,
+     size64_t media_size,
+     libcerror_error_t **error )
+{
+	static char *function              = "libqcow_export_writer_initialize";
+	size64_t level1_table_size         = 0;
+	size64_t level2_table_media_size   = 0;
+	size64_t number_of_level1_entries  = 0;
+
+	if( export_writer == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid export writer.",
+		 function );
+
+		return( -1 );
+	}
+	if( *export_writer != NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_ALREADY_SET,
+		 "%s: invalid export writer value already set.",
+		 function );
+
+		return( -1 );
+	}
+	if( file_io_handle == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file IO handle.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( export_format != LIBQCOW_EXPORT_FORMAT_RAW )
+	 && ( export_format != LIBQCOW_EXPORT_FORMAT_QCOW2 ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_UNSUPPORTED_VALUE,
+		 "%s: unsupported export format.",
+		 function );
+
+		return( -1 );
+	}
+	if( media_size > (size64_t) INT64_MAX )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid media size value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	*export_writer = memory_allocate_structure(
+	                  libqcow_export_writer_t );
+
+	if( *export_writer == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_INSUFFICIENT,
+		 "%s: unable to create export writer.",
+		 function );
+
+		goto on_error;
+	}
+	if( memory_set(
+	     *export_writer,
+	     0,
+	     sizeof( libqcow_export_writer_t ) ) == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_SET_FAILED,
+		 "%s: unable to clear export writer.",
+		 function );
+
+		memory_free(
+		 *export_writer );
+
+		*export_writer = NULL;
+
+		return( -1 );
+	}
+	( *export_writer )->file_io_handle     = file_io_handle;
+	( *export_writer )->export_format      = export_format;
+	( *export_writer )->media_size         = media_size;
+	( *export_writer )->cluster_block_size = (size_t) 1 << LIBQCOW_EXPORT_NUMBER_OF_CLUSTER_BLOCK_BITS;
+
+	if( export_format == LIBQCOW_EXPORT_FORMAT_QCOW2 )
+	{
+		/* A level 2 table is stored in a single cluster block
+		 */
+		level2_table_media_size  = (size64_t) ( ( *export_writer )->cluster_block_size / 8 ) * ( *export_writer )->cluster_block_size;
+		number_of_level1_entries = media_size / level2_table_media_size;
+
+		if( ( media_size % level2_table_media_size ) != 0 )
+		{
+			number_of_level1_entries += 1;
+		}
+		if( number_of_level1_entries > (size64_t) ( MEMORY_MAXIMUM_ALLOCATION_SIZE / sizeof( uint64_t ) ) )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+			 "%s: invalid number of level 1 table references value out of bounds.",
+			 function );
+
+			goto on_error;
+		}
+		( *export_writer )->number_of_level1_table_references = (uint32_t) number_of_level1_entries;
+
+		/* The file header is stored in the first cluster block followed by the level 1 table
+		 */
+		level1_table_size = number_of_level1_entries * 8;
+
+		if( ( level1_table_size % ( *export_writer )->cluster_block_size ) != 0 )
+		{
+			level1_table_size += ( *export_writer )->cluster_block_size - ( level1_table_size % ( *export_writer )->cluster_block_size );
+		}
+		( *export_writer )->level1_table_offset       = (uint64_t) ( *export_writer )->cluster_block_size;
+		( *export_writer )->next_cluster_block_offset = ( *export_writer )->level1_table_offset + level1_table_size;
+
+		if( number_of_level1_entries > 0 )
+		{
+			( *export_writer )->level2_tables = (uint64_t **) memory_allocate(
+			                                                   sizeof( uint64_t * ) * (size_t) number_of_level1_entries );
+
+			if( ( *export_writer )->level2_tables == NULL )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_MEMORY,
+				 LIBCERROR_MEMORY_ERROR_INSUFFICIENT,
+				 "%s: unable to create level 2 tables.",
+				 function );
+
+				goto on_error;
+			}
+			if( memory_set(
+			     ( *export_writer )->level2_tables,
+			     0,
+			     sizeof( uint64_t * ) * (size_t) number_of_level1_entries ) == NULL )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_MEMORY,
+				 LIBCERROR_MEMORY_ERROR_SET_FAILED,
+				 "%s: unable to clear level 2 tables.",
+				 function );
+
+				goto on_error;
+			}
+		}
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_initialize(
+	     &( ( *export_writer )->read_write_lock ),
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+		 "%s: unable to initialize read/write lock.",
+		 function );
+
+		goto on_error;
+	}
+	/* A single write thread keeps the writes in order of the (storage media) offset
+	 */
+	if( libcthreads_thread_pool_create(
+	     &( ( *export_writer )->write_thread_pool ),
+	     NULL,
+	     1,
+	     LIBQCOW_EXPORT_MAXIMUM_NUMBER_OF_QUEUED_CHUNKS,
+	     (int (*)(intptr_t *, void *)) &libqcow_export_writer_write_chunk_callback,
+	     (void *) *export_writer,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+		 "%s: unable to create write thread pool.",
+		 function );
+
+		goto on_error;
+	}
+#endif
+	return( 1 );
+
+on_error:
+	if( *export_writer != NULL )
+	{
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+		if( ( *export_writer )->read_write_lock != NULL )
+		{
+			libcthreads_read_write_lock_free(
+			 &( ( *export_writer )->read_write_lock ),
+			 NULL );
+		}
+#endif
+		if( ( *export_writer )->level2_tables != NULL )
+		{
+			memory_free(
+			 ( *export_writer )->level2_tables );
+		}
+		memory_free(
+		 *export_writer );
+
+		*export_writer = NULL;
+	}
+	return( -1 );
+}
+
+/* Frees an export writer
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_export_writer_free(
+     libqcow_export_writer_t **export_writer,
+     libcerror_error_t **error )
+{
+	static char *function      = "libqcow_export_writer_free";
+	uint32_t level1_table_index = 0;
+	int result                 = 1;
+
+	if( export_writer == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid export writer.",
+		 function );
+
+		return( -1 );
+	}
+	if( *export_writer != NULL )
+	{
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+		/* The write thread pool is normally joined by finalize
+		 */
+		if( ( *export_writer )->write_thread_pool != NULL )
+		{
+			if( libcthreads_thread_pool_join(
+			     &( ( *export_writer )->write_thread_pool ),
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+				 "%s: unable to join write thread pool.",
+				 function );
+
+				result = -1;
+			}
+		}
+		if( libcthreads_read_write_lock_free(
+		     &( ( *export_writer )->read_write_lock ),
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+			 "%s: unable to free read/write lock.",
+			 function );
+
+			result = -1;
+		}
+#endif
+		if( ( *export_writer )->level2_tables != NULL )
+		{
+			for( level1_table_index = 0;
+			     level1_table_index < ( *export_writer )->number_of_level1_table_references;
+			     level1_table_index++ )
+			{
+				if( ( *export_writer )->level2_tables[ level1_table_index ] != NULL )
+				{
+					memory_free(
+					 ( *export_writer )->level2_tables[ level1_table_index ] );
+				}
+			}
+			memory_free(
+			 ( *export_writer )->level2_tables );
+		}
+		if( ( *export_writer )->write_error != NULL )
+		{
+			libcerror_error_free(
+			 &( ( *export_writer )->write_error ) );
+		}
+		memory_free(
+		 *export_writer );
+
+		*export_writer = NULL;
+	}
+	return( result );
+}
+
+/* Determines if writing a chunk has failed
+ * Returns 1 if writing has failed, 0 if not or -1 on error
+ */
+int libqcow_export_writer_has_failed(
+     libqcow_export_writer_t *export_writer,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_export_writer_has_failed";
+	int result            = 0;
+
+	if( export_writer == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid export writer.",
+		 function );
+
+		return( -1 );
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_grab_for_read(
+	     export_writer->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab read/write lock for reading.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	if( export_writer->write_error != NULL )
+	{
+		result = 1;
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_release_for_read(
+	     export_writer->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release read/write lock for reading.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	return( result );
+}
+
+/* Pushes a chunk to be written
+ * The export writer takes over management of the chunk
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_export_writer_push_chunk(
+     libqcow_export_writer_t *export_writer,
+     libqcow_export_chunk_t **export_chunk,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_export_writer_push_chunk";
+	int result            = 1;
+
+	if( export_writer == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid export writer.",
+		 function );
+
+		return( -1 );
+	}
+	if( export_chunk == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid export chunk.",
+		 function );
+
+		return( -1 );
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( export_writer->write_thread_pool == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid export writer - missing write thread pool.",
+		 function );
+
+		return( -1 );
+	}
+	/* The push blocks while the maximum number of chunks is queued
+	 */
+	if( libcthreads_thread_pool_push(
+	     export_writer->write_thread_pool,
+	     (intptr_t *) *export_chunk,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_APPEND_FAILED,
+		 "%s: unable to push chunk onto write thread pool.",
+		 function );
+
+		return( -1 );
+	}
+	*export_chunk = NULL;
+#else
+	if( libqcow_export_writer_write_chunk(
+	     export_writer,
+	     *export_chunk,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_IO,
+		 LIBCERROR_IO_ERROR_WRITE_FAILED,
+		 "%s: unable to write chunk.",
+		 function );
+
+		result = -1;
+	}
+	if( libqcow_export_chunk_free(
+	     export_chunk,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+		 "%s: unable to free chunk.",
+		 function );
+
+		result = -1;
+	}
+#endif
+	return( result );
+}
+
+/* Writes a chunk from the write thread pool
+ * The error of the first chunk that could not be written is retained by the export writer,
+ * subsequent chunks are discarded so that the thread pool keeps consuming the queued chunks
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_export_writer_write_chunk_callback(
+     libqcow_export_chunk_t *export_chunk,
+     libqcow_export_writer_t *export_writer )
+{
+	libcerror_error_t *error = NULL;
+	static char *function    = "libqcow_export_writer_write_chunk_callback";
+	int result               = 0;
+
+	if( export_chunk == NULL )
+	{
+		return( -1 );
+	}
+	if( export_writer == NULL )
+	{
+		libqcow_export_chunk_free(
+		 &export_chunk,
+		 NULL );
+
+		return( -1 );
+	}
+	result = libqcow_export_writer_has_failed(
+	          export_writer,
+	          &error );
+
+	if( result == 0 )
+	{
+		result = libqcow_export_writer_write_chunk(
+		          export_writer,
+		          export_chunk,
+		          &error );
+
+		if( result != 1 )
+		{
+			libcerror_error_set(
+			 &error,
+			 LIBCERROR_ERROR_DOMAIN_IO,
+			 LIBCERROR_IO_ERROR_WRITE_FAILED,
+			 "%s: unable to write chunk at offset: %" PRIi64 " (0x%08" PRIx64 ").",
+			 function,
+			 export_chunk->offset,
+			 export_chunk->offset );
+		}
+	}
+	libqcow_export_chunk_free(
+	 &export_chunk,
+	 NULL );
+
+	if( error != NULL )
+	{
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+		if( libcthreads_read_write_lock_grab_for_write(
+		     export_writer->read_write_lock,
+		     NULL ) != 1 )
+		{
+			libcerror_error_free(
+			 &error );
+
+			return( -1 );
+		}
+#endif
+		if( export_writer->write_error == NULL )
+		{
+			export_writer->write_error = error;
+
+			error = NULL;
+		}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+		libcthreads_read_write_lock_release_for_write(
+		 export_writer->read_write_lock,
+		 NULL );
+#endif
+		if( error != NULL )
+		{
+			libcerror_error_free(
+			 &error );
+		}
+		return( -1 );
+	}
+	return( 1 );
+}
+
+/* Writes a chunk
+ * Cluster blocks that only contain zero bytes are not written
+ * This function is not multi-thread safe and must only be called by the write thread
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_export_writer_write_chunk(
+     libqcow_export_writer_t *export_writer,
+     libqcow_export_chunk_t *export_chunk,
+     libcerror_error_t **error )
+{
+	uint64_t *level2_table         = NULL;
+	static char *function          = "libqcow_export_writer_write_chunk";
+	size_t block_size              = 0;
+	size_t data_offset             = 0;
+	size_t run_data_offset         = 0;
+	size_t run_size                = 0;
+	uint64_t cluster_block_index   = 0;
+	uint64_t level1_table_index    = 0;
+	uint64_t level2_table_index    = 0;
+	uint64_t number_of_level2_refs = 0;
+	off64_t file_offset            = 0;
+	off64_t run_file_offset        = 0;
+	uint8_t is_zero                = 0;
+
+	if( export_writer == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid export writer.",
+		 function );
+
+		return( -1 );
+	}
+	if( export_chunk == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid export chunk.",
+		 function );
+
+		return( -1 );
+	}
+	if( export_chunk->data == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid export chunk - missing data.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( export_chunk->offset < 0 )
+	 || ( ( (uint64_t) export_chunk->offset % export_writer->cluster_block_size ) != 0 )
+	 || ( (size64_t) export_chunk->offset >= export_writer->media_size )
+	 || ( export_chunk->data_size > ( export_writer->media_size - (size64_t) export_chunk->offset ) ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid export chunk - offset value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	number_of_level2_refs = (uint64_t) ( export_writer->cluster_block_size / 8 );
+
+	while( data_offset < export_chunk->data_size )
+	{
+		/* The data is padded to a multitude of the cluster block size
+		 */
+		is_zero = 0;
+
+		if( export_chunk->data[ data_offset ] == 0 )
+		{
+			if( memory_compare(
+			     &( export_chunk->data[ data_offset ] ),
+			     &( export_chunk->data[ data_offset + 1 ] ),
+			     export_writer->cluster_block_size - 1 ) == 0 )
+			{
+				is_zero = 1;
+			}
+		}
+		block_size = export_writer->cluster_block_size;
+
+		if( is_zero == 0 )
+		{
+			if( export_writer->export_format == LIBQCOW_EXPORT_FORMAT_QCOW2 )
+			{
+				cluster_block_index = ( (uint64_t) export_chunk->offset + data_offset ) / export_writer->cluster_block_size;
+				level1_table_index  = cluster_block_index / number_of_level2_refs;
+				level2_table_index  = cluster_block_index % number_of_level2_refs;
+
+				if( level1_table_index >= (uint64_t) export_writer->number_of_level1_table_references )
+				{
+					libcerror_error_set(
+					 error,
+					 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+					 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+					 "%s: invalid level 1 table index value out of bounds.",
+					 function );
+
+					return( -1 );
+				}
+				level2_table = export_writer->level2_tables[ level1_table_index ];
+
+				if( level2_table == NULL )
+				{
+					level2_table = (uint64_t *) memory_allocate(
+					                             export_writer->cluster_block_size );
+
+					if( level2_table == NULL )
+					{
+						libcerror_error_set(
+						 error,
+						 LIBCERROR_ERROR_DOMAIN_MEMORY,
+						 LIBCERROR_MEMORY_ERROR_INSUFFICIENT,
+						 "%s: unable to create level 2 table.",
+						 function );
+
+						return( -1 );
+					}
+					if( memory_set(
+					     level2_table,
+					     0,
+					     export_writer->cluster_block_size ) == NULL )
+					{
+						libcerror_error_set(
+						 error,
+						 LIBCERROR_ERROR_DOMAIN_MEMORY,
+						 LIBCERROR_MEMORY_ERROR_SET_FAILED,
+						 "%s: unable to clear level 2 table.",
+						 function );
+
+						memory_free(
+						 level2_table );
+
+						return( -1 );
+					}
+					export_writer->level2_tables[ level1_table_index ] = level2_table;
+				}
+				level2_table[ level2_table_index ] = export_writer->next_cluster_block_offset;
+
+				file_offset = (off64_t) export_writer->next_cluster_block_offset;
+
+				export_writer->next_cluster_block_offset += export_writer->cluster_block_size;
+			}
+			else
+			{
+				file_offset = export_chunk->offset + (off64_t) data_offset;
+
+				/* The padding of a raw export is not written
+				 */
+				if( block_size > ( export_chunk->data_size - data_offset ) )
+				{
+					block_size = export_chunk->data_size - data_offset;
+				}
+			}
+			if( ( run_size > 0 )
+			 && ( ( run_file_offset + (off64_t) run_size ) == file_offset ) )
+			{
+				run_size += block_size;
+			}
+			else
+			{
+				if( run_size > 0 )
+				{
+					if( libqcow_export_writer_write_data(
+					     export_writer,
+					     &( export_chunk->data[ run_data_offset ] ),
+					     run_size,
+					     run_file_offset,
+					     error ) != 1 )
+					{
+						libcerror_error_set(
+						 error,
+						 LIBCERROR_ERROR_DOMAIN_IO,
+						 LIBCERROR_IO_ERROR_WRITE_FAILED,
+						 "%s: unable to write data.",
+						 function );
+
+						return( -1 );
+					}
+				}
+				run_data_offset = data_offset;
+				run_file_offset = file_offset;
+				run_size        = block_size;
+			}
+		}
+		data_offset += export_writer->cluster_block_size;
+	}
+	if( run_size > 0 )
+	{
+		if( libqcow_export_writer_write_data(
+		     export_writer,
+		     &( export_chunk->data[ run_data_offset ] ),
+		     run_size,
+		     run_file_offset,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_IO,
+			 LIBCERROR_IO_ERROR_WRITE_FAILED,
+			 "%s: unable to write data.",
+			 function );
+
+			return( -1 );
+		}
+	}
+	return( 1 );
+}
+
+/* Writes data at a specific (file) offset
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_export_writer_write_data(
+     libqcow_export_writer_t *export_writer,
+     const uint8_t *data,
+     size_t data_size,
+     off64_t file_offset,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_export_writer_write_data";
+	ssize_t write_count   = 0;
+
+	if( export_writer == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid export writer.",
+		 function );
+
+		return( -1 );
+	}
+	if( data == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid data.",
+		 function );
+
+		return( -1 );
+	}
+	if( data_size > (size_t) SSIZE_MAX )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_EXCEEDS_MAXIMUM,
+		 "%s: invalid data size value exceeds maximum.",
+		 function );
+
+		return( -1 );
+	}
+	write_count = libbfio_handle_write_buffer_at_offset(
+	               export_writer->file_io_handle,
+	               data,
+	               data_size,
+	               file_offset,
+	               error );
+
+	if( write_count != (ssize_t) data_size )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_IO,
+		 LIBCERROR_IO_ERROR_WRITE_FAILED,
+		 "%s: unable to write data at offset: %" PRIi64 " (0x%08" PRIx64 ").",
+		 function,
+		 file_offset,
+		 file_offset );
+
+		return( -1 );
+	}
+	if( ( file_offset + (off64_t) data_size ) > export_writer->end_offset )
+	{
+		export_writer->end_offset = file_offset + (off64_t) data_size;
+	}
+	return( 1 );
+}
+
+/* Finalizes the export
+ * Waits for the queued chunks to be written and writes the metadata
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_export_writer_finalize(
+     libqcow_export_writer_t *export_writer,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_export_writer_finalize";
+
+	if( export_writer == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid export writer.",
+		 function );
+
+		return( -1 );
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( export_writer->write_thread_pool != NULL )
+	{
+		if( libcthreads_thread_pool_join(
+		     &( export_writer->write_thread_pool ),
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+			 "%s: unable to join write thread pool.",
+			 function );
+
+			return( -1 );
+		}
+	}
+#endif
+	/* The write thread has stopped hence the error can be handed over without locking
+	 */
+	if( export_writer->write_error != NULL )
+	{
+		if( ( error != NULL )
+		 && ( *error == NULL ) )
+		{
+			*error = export_writer->write_error;
+
+			export_writer->write_error = NULL;
+		}
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_IO,
+		 LIBCERROR_IO_ERROR_WRITE_FAILED,
+		 "%s: unable to write chunks.",
+		 function );
+
+		return( -1 );
+	}
+	if( libqcow_export_writer_write_metadata(
+	     export_writer,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_IO,
+		 LIBCERROR_IO_ERROR_WRITE_FAILED,
+		 "%s: unable to write metadata.",
+		 function );
+
+		return( -1 );
+	}
+	return( 1 );
+}
+
+/* Writes the metadata
+ * For a raw export this extends the file to the media size, for a QCOW2 export
+ * this writes the level 2 tables, the reference counts, the level 1 table and the file header
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_export_writer_write_metadata(
+     libqcow_export_writer_t *export_writer,
+     libcerror_error_t **error )
+{
+	uint8_t *cluster_block_data                = NULL;
+	uint8_t *level1_table_data                 = NULL;
+	uint64_t *level2_table                     = NULL;
+	static char *function                      = "libqcow_export_writer_write_metadata";
+	size_t level1_table_size                   = 0;
+	size_t number_of_level2_refs               = 0;
+	size_t number_of_reference_counts          = 0;
+	size_t reference_index                     = 0;
+	uint64_t block_index                       = 0;
+	uint64_t cluster_block_index               = 0;
+	uint64_t file_offset                       = 0;
+	uint64_t number_of_cluster_blocks          = 0;
+	uint64_t number_of_reference_count_blocks  = 0;
+	uint64_t number_of_reference_table_blocks  = 0;
+	uint64_t reference_count_table_offset      = 0;
+	uint64_t table_index                       = 0;
+	uint64_t total_number_of_cluster_blocks    = 0;
+	uint64_t value_64bit                       = 0;
+	uint32_t level1_table_index                = 0;
+
+	if( export_writer == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid export writer.",
+		 function );
+
+		return( -1 );
+	}
+	if( export_writer->export_format == LIBQCOW_EXPORT_FORMAT_RAW )
+	{
+		/* Unallocated data at the end of the media is not written
+		 */
+		if( (size64_t) export_writer->end_offset < export_writer->media_size )
+		{
+			cluster_block_data = (uint8_t *) "";
+
+			if( libqcow_export_writer_write_data(
+			     export_writer,
+			     cluster_block_data,
+			     1,
+			     (off64_t) export_writer->media_size - 1,
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_IO,
+				 LIBCERROR_IO_ERROR_WRITE_FAILED,
+				 "%s: unable to write last byte of media.",
+				 function );
+
+				return( -1 );
+			}
+		}
+		return( 1 );
+	}
+	cluster_block_data = (uint8_t *) memory_allocate(
+	                                  export_writer->cluster_block_size );
+
+	if( cluster_block_data == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_INSUFFICIENT,
+		 "%s: unable to create cluster block data.",
+		 function );
+
+		goto on_error;
+	}
+	level1_table_size = (size_t) export_writer->number_of_level1_table_references * 8;
+
+	if( ( level1_table_size % export_writer->cluster_block_size ) != 0 )
+	{
+		level1_table_size += export_writer->cluster_block_size - ( level1_table_size % export_writer->cluster_block_size );
+	}
+	if( level1_table_size > 0 )
+	{
+		level1_table_data = (uint8_t *) memory_allocate(
+		                                 level1_table_size );
+
+		if( level1_table_data == NULL )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_MEMORY,
+			 LIBCERROR_MEMORY_ERROR_INSUFFICIENT,
+			 "%s: unable to create level 1 table data.",
+			 function );
+
+			goto on_error;
+		}
+		if( memory_set(
+		     level1_table_data,
+		     0,
+		     level1_table_size ) == NULL )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_MEMORY,
+			 LIBCERROR_MEMORY_ERROR_SET_FAILED,
+			 "%s: unable to clear level 1 table data.",
+			 function );
+
+			goto on_error;
+		}
+	}
+	/* The level 2 tables are stored after the data
+	 */
+	number_of_level2_refs = export_writer->cluster_block_size / 8;
+	file_offset           = export_writer->next_cluster_block_offset;
+
+	for( level1_table_index = 0;
+	     level1_table_index < export_writer->number_of_level1_table_references;
+	     level1_table_index++ )
+	{
+		level2_table = export_writer->level2_tables[ level1_table_index ];
+
+		if( level2_table == NULL )
+		{
+			continue;
+		}
+		for( reference_index = 0;
+		     reference_index < number_of_level2_refs;
+		     reference_index++ )
+		{
+			value_64bit = level2_table[ reference_index ];
+
+			if( value_64bit != 0 )
+			{
+				value_64bit |= LIBQCOW_EXPORT_REFERENCE_FLAG_COPIED;
+			}
+			byte_stream_copy_from_uint64_big_endian(
+			 &( cluster_block_data[ reference_index * 8 ] ),
+			 value_64bit );
+		}
+		if( libqcow_export_writer_write_data(
+		     export_writer,
+		     cluster_block_data,
+		     export_writer->cluster_block_size,
+		     (off64_t) file_offset,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_IO,
+			 LIBCERROR_IO_ERROR_WRITE_FAILED,
+			 "%s: unable to write level 2 table: %" PRIu32 ".",
+			 function,
+			 level1_table_index );
+
+			goto on_error;
+		}
+		byte_stream_copy_from_uint64_big_endian(
+		 &( level1_table_data[ level1_table_index * 8 ] ),
+		 file_offset | LIBQCOW_EXPORT_REFERENCE_FLAG_COPIED );
+
+		file_offset += export_writer->cluster_block_size;
+	}
+	/* The reference count table and blocks are stored after the level 2 tables
+	 * and must also account for the cluster blocks they occupy themselves
+	 */
+	number_of_cluster_blocks   = file_offset / export_writer->cluster_block_size;
+	number_of_reference_counts = export_writer->cluster_block_size / 2;
+
+	do
+	{
+		total_number_of_cluster_blocks = number_of_cluster_blocks
+		                               + number_of_reference_count_blocks
+		                               + number_of_reference_table_blocks;
+
+		block_index = ( total_number_of_cluster_blocks + number_of_reference_counts - 1 ) / number_of_reference_counts;
+		table_index = ( ( block_index * 8 ) + export_writer->cluster_block_size - 1 ) / export_writer->cluster_block_size;
+
+		if( ( block_index == number_of_reference_count_blocks )
+		 && ( table_index == number_of_reference_table_blocks ) )
+		{
+			break;
+		}
+		number_of_reference_count_blocks = block_index;
+		number_of_reference_table_blocks = table_index;
+	}
+	while( 1 );
+
+	reference_count_table_offset = file_offset;
+	file_offset                 += number_of_reference_table_blocks * export_writer->cluster_block_size;
+
+	for( table_index = 0;
+	     table_index < number_of_reference_table_blocks;
+	     table_index++ )
+	{
+		if( memory_set(
+		     cluster_block_data,
+		     0,
+		     export_writer->cluster_block_size ) == NULL )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_MEMORY,
+			 LIBCERROR_MEMORY_ERROR_SET_FAILED,
+			 "%s: unable to clear cluster block data.",
+			 function );
+
+			goto on_error;
+		}
+		for( reference_index = 0;
+		     reference_index < number_of_level2_refs;
+		     reference_index++ )
+		{
+			block_index = ( table_index * number_of_level2_refs ) + reference_index;
+
+			if( block_index >= number_of_reference_count_blocks )
+			{
+				break;
+			}
+			byte_stream_copy_from_uint64_big_endian(
+			 &( cluster_block_data[ reference_index * 8 ] ),
+			 file_offset + ( block_index * export_writer->cluster_block_size ) );
+		}
+		if( libqcow_export_writer_write_data(
+		     export_writer,
+		     cluster_block_data,
+		     export_writer->cluster_block_size,
+		     (off64_t) ( reference_count_table_offset + ( table_index * export_writer->cluster_block_size ) ),
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_IO,
+			 LIBCERROR_IO_ERROR_WRITE_FAILED,
+			 "%s: unable to write reference count table.",
+			 function );
+
+			goto on_error;
+		}
+	}
+	/* Every cluster block is referenced once
+	 */
+	for( block_index = 0;
+	     block_index < number_of_reference_count_blocks;
+	     block_index++ )
+	{
+		if( memory_set(
+		     cluster_block_data,
+		     0,
+		     export_writer->cluster_block_size ) == NULL )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_MEMORY,
+			 LIBCERROR_MEMORY_ERROR_SET_FAILED,
+			 "%s: unable to clear cluster block data.",
+			 function );
+
+			goto on_error;
+		}
+		for( reference_index = 0;
+		     reference_index < number_of_reference_counts;
+		     reference_index++ )
+		{
+			cluster_block_index = ( block_index * number_of_reference_counts ) + reference_index;
+
+			if( cluster_block_index >= total_number_of_cluster_blocks )
+			{
+				break;
+			}
+			byte_stream_copy_from_uint16_big_endian(
+			 &( cluster_block_data[ reference_index * 2 ] ),
+			 1 );
+		}
+		if( libqcow_export_writer_write_data(
+		     export_writer,
+		     cluster_block_data,
+		     export_writer->cluster_block_size,
+		     (off64_t) ( file_offset + ( block_index * export_writer->cluster_block_size ) ),
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_IO,
+			 LIBCERROR_IO_ERROR_WRITE_FAILED,
+			 "%s: unable to write reference count block: %" PRIu64 ".",
+			 function,
+			 block_index );
+
+			goto on_error;
+		}
+	}
+	if( level1_table_data != NULL )
+	{
+		if( libqcow_export_writer_write_data(
+		     export_writer,
+		     level1_table_data,
+		     level1_table_size,
+		     (off64_t) export_writer->level1_table_offset,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_IO,
+			 LIBCERROR_IO_ERROR_WRITE_FAILED,
+			 "%s: unable to write level 1 table.",
+			 function );
+
+			goto on_error;
+		}
+		memory_free(
+		 level1_table_data );
+
+		level1_table_data = NULL;
+	}
+	/* The file header is written last so that an incomplete export is not a valid image
+	 */
+	if( memory_set(
+	     cluster_block_data,
+	     0,
+	     export_writer->cluster_block_size ) == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_SET_FAILED,
+		 "%s: unable to clear cluster block data.",
+		 function );
+
+		goto on_error;
+	}
+	if( memory_copy(
+	     ( (qcow_file_header_v2_t *) cluster_block_data )->signature,
+	     qcow_file_signature,
+	     4 ) == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_COPY_FAILED,
+		 "%s: unable to copy signature.",
+		 function );
+
+		goto on_error;
+	}
+	byte_stream_copy_from_uint32_big_endian(
+	 ( (qcow_file_header_v2_t *) cluster_block_data )->format_version,
+	 2 );
+
+	byte_stream_copy_from_uint32_big_endian(
+	 ( (qcow_file_header_v2_t *) cluster_block_data )->number_of_cluster_block_bits,
+	 LIBQCOW_EXPORT_NUMBER_OF_CLUSTER_BLOCK_BITS );
+
+	byte_stream_copy_from_uint64_big_endian(
+	 ( (qcow_file_header_v2_t *) cluster_block_data )->media_size,
+	 export_writer->media_size );
+
+	byte_stream_copy_from_uint32_big_endian(
+	 ( (qcow_file_header_v2_t *) cluster_block_data )->number_of_level1_table_references,
+	 export_writer->number_of_level1_table_references );
+
+	byte_stream_copy_from_uint64_big_endian(
+	 ( (qcow_file_header_v2_t *) cluster_block_data )->level1_table_offset,
+	 export_writer->level1_table_offset );
+
+	byte_stream_copy_from_uint64_big_endian(
+	 ( (qcow_file_header_v2_t *) cluster_block_data )->reference_count_table_offset,
+	 reference_count_table_offset );
+
+	byte_stream_copy_from_uint32_big_endian(
+	 ( (qcow_file_header_v2_t *) cluster_block_data )->reference_count_table_clusters,
+	 (uint32_t) number_of_reference_table_blocks );
+
+	if( libqcow_export_writer_write_data(
+	     export_writer,
+	     cluster_block_data,
+	     export_writer->cluster_block_size,
+	     0,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_IO,
+		 LIBCERROR_IO_ERROR_WRITE_FAILED,
+		 "%s: unable to write file header.",
+		 function );
+
+		goto on_error;
+	}
+	memory_free(
+	 cluster_block_data );
+
+	return( 1 );
+
+on_error:
+	if( level1_table_data != NULL )
+	{
+		memory_free(
+		 level1_table_data );
+	}
+	if( cluster_block_data != NULL )
+	{
+		memory_free(
+		 cluster_block_data );
+	}
+	return( -1 );
+}
+
@@ -0,0 +1,170 @@
+/*
+ * Export writer functions
+ *
+ * Copyright (C) 2010-2026, Joachim Metz <joachim.metz@gmail.com>
+ *
+ * Refer to AUTHORS for acknowledgements.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#if !defined( _LIBQCOW_EXPORT_WRITER_H )
+#define _LIBQCOW_EXPORT_WRITER_H
+
+#include <common.h>
+#include <types.h>
+
+#include "libqcow_libbfio.h"
+#include "libqcow_libcerror.h"
+#include "libqcow_libcthreads.h"
+
+#if defined( __cplusplus )
+extern "C" {
+#endif
+
+typedef struct libqcow_export_chunk libqcow_export_chunk_t;
+
+struct libqcow_export_chunk
+{
+	/* The (storage media) offset of the chunk
+	 */
+	off64_t offset;
+
+	/* The data
+	 * The data is padded with zero bytes to a multitude of the cluster block size
+	 */
+	uint8_t *data;
+
+	/* The data size
+	 */
+	size_t data_size;
+};
+
+typedef struct libqcow_export_writer libqcow_export_writer_t;
+
+struct libqcow_export_writer
+{
+	/* The output file IO handle
+	 */
+	libbfio_handle_t *file_io_handle;
+
+	/* The export format
+	 */
+	int export_format;
+
+	/* The media size
+	 */
+	size64_t media_size;
+
+	/* The cluster block size
+	 */
+	size_t cluster_block_size;
+
+	/* The number of level 1 table references
+	 */
+	uint32_t number_of_level1_table_references;
+
+	/* The level 1 table offset
+	 */
+	uint64_t level1_table_offset;
+
+	/* The level 2 tables, contains the cluster block offsets per level 1 table reference
+	 * A level 2 table is only created when it references cluster blocks
+	 */
+	uint64_t **level2_tables;
+
+	/* The (file) offset of the next cluster block
+	 */
+	uint64_t next_cluster_block_offset;
+
+	/* The end offset of the data written
+	 */
+	off64_t end_offset;
+
+	/* The error of the first chunk that could not be written
+	 */
+	libcerror_error_t *write_error;
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	/* The thread pool that writes the chunks
+	 */
+	libcthreads_thread_pool_t *write_thread_pool;
+
+	/* The read/write lock
+	 */
+	libcthreads_read_write_lock_t *read_write_lock;
+#endif
+};
+
+int libqcow_export_chunk_initialize(
+     libqcow_export_chunk_t **export_chunk,
+     off64_t offset,
+     size_t data_size,
+     size_t cluster_block_size,
+     libcerror_error_t **error );
+
+int libqcow_export_chunk_free(
+     libqcow_export_chunk_t **export_chunk,
+     libcerror_error_t **error );
+
+int libqcow_export_writer_initialize(
+     libqcow_export_writer_t **export_writer,
+     libbfio_handle_t *file_io_handle,
+     int export_format,
+     size64_t media_size,
+     libcerror_error_t **error );
+
+int libqcow_export_writer_free(
+     libqcow_export_writer_t **export_writer,
+     libcerror_error_t **error );
+
+int libqcow_export_writer_has_failed(
+     libqcow_export_writer_t *export_writer,
+     libcerror_error_t **error );
+
+int libqcow_export_writer_push_chunk(
+     libqcow_export_writer_t *export_writer,
+     libqcow_export_chunk_t **export_chunk,
+     libcerror_error_t **error );
+
+int libqcow_export_writer_write_chunk_callback(
+     libqcow_export_chunk_t *export_chunk,
+     libqcow_export_writer_t *export_writer );
+
+int libqcow_export_writer_write_chunk(
+     libqcow_export_writer_t *export_writer,
+     libqcow_export_chunk_t *export_chunk,
+     libcerror_error_t **error );
+
+int libqcow_export_writer_write_data(
+     libqcow_export_writer_t *export_writer,
+     const uint8_t *data,
+     size_t data_size,
+     off64_t file_offset,
+     libcerror_error_t **error );
+
+int libqcow_export_writer_finalize(
+     libqcow_export_writer_t *export_writer,
+     libcerror_error_t **error );
+
+int libqcow_export_writer_write_metadata(
+     libqcow_export_writer_t *export_writer,
+     libcerror_error_t **error );
+
+#if defined( __cplusplus )
+}
+#endif
+
+#endif /* !defined( _LIBQCOW_EXPORT_WRITER_H ) */
+
@@ -0,0 +1,798 @@
+/*
+ * Extent index functions
+ *
+ * Copyright (C) 2010-2026, Joachim Metz <joachim.metz@gmail.com>
+ *
+ * Refer to AUTHORS for acknowledgements.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <common.h>
+#include <memory.h>
+#include <types.h>
+
+#include "libqcow_definitions.h"
+#include "libqcow_extent_index.h"
+#include "libqcow_libcerror.h"
+
+/* Creates an extent index
+ * Make sure the value extent_index is referencing, is set to NULL
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_extent_index_initialize(
+     libqcow_extent_index_t **extent_index,
+     int number_of_level2_tables,
+     int number_of_level2_table_references,
+     size64_t cluster_block_size,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_extent_index_initialize";
+	size_t tables_size    = 0;
+
+	if( extent_index == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid extent index.",
+		 function );
+
+		return( -1 );
+	}
+	if( *extent_index != NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_ALREADY_SET,
+		 "%s: invalid extent index value already set.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( number_of_level2_tables <= 0 )
+	 || ( (size_t) number_of_level2_tables > ( (size_t) MEMORY_MAXIMUM_ALLOCATION_SIZE / sizeof( libqcow_extent_index_table_t ) ) ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid number of level 2 tables value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	if( number_of_level2_table_references <= 0 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid number of level 2 table references value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	if( cluster_block_size == 0 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid cluster block size value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	*extent_index = memory_allocate_structure(
+	                 libqcow_extent_index_t );
+
+	if( *extent_index == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_INSUFFICIENT,
+		 "%s: unable to create extent index.",
+		 function );
+
+		goto on_error;
+	}
+	if( memory_set(
+	     *extent_index,
+	     0,
+	     sizeof( libqcow_extent_index_t ) ) == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_SET_FAILED,
+		 "%s: unable to clear extent index.",
+		 function );
+
+		memory_free(
+		 *extent_index );
+
+		*extent_index = NULL;
+
+		return( -1 );
+	}
+	tables_size = sizeof( libqcow_extent_index_table_t ) * number_of_level2_tables;
+
+	( *extent_index )->level2_tables = (libqcow_extent_index_table_t *) memory_allocate(
+	                                                                     tables_size );
+
+	if( ( *extent_index )->level2_tables == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_INSUFFICIENT,
+		 "%s: unable to create level 2 tables.",
+		 function );
+
+		goto on_error;
+	}
+	if( memory_set(
+	     ( *extent_index )->level2_tables,
+	     0,
+	     tables_size ) == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_SET_FAILED,
+		 "%s: unable to clear level 2 tables.",
+		 function );
+
+		goto on_error;
+	}
+	/* A level 2 table that needs more extents than this is not indexed
+	 * since the extents would use more memory than the level 2 table itself
+	 */
+	( *extent_index )->maximum_number_of_extents = number_of_level2_table_references / 4;
+
+	if( ( *extent_index )->maximum_number_of_extents == 0 )
+	{
+		( *extent_index )->maximum_number_of_extents = 1;
+	}
+	( *extent_index )->cluster_block_size                = cluster_block_size;
+	( *extent_index )->number_of_level2_tables           = number_of_level2_tables;
+	( *extent_index )->number_of_level2_table_references = number_of_level2_table_references;
+
+	return( 1 );
+
+on_error:
+	if( *extent_index != NULL )
+	{
+		if( ( *extent_index )->level2_tables != NULL )
+		{
+			memory_free(
+			 ( *extent_index )->level2_tables );
+		}
+		memory_free(
+		 *extent_index );
+
+		*extent_index = NULL;
+	}
+	return( -1 );
+}
+
+/* Frees an extent index
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_extent_index_free(
+     libqcow_extent_index_t **extent_index,
+     libcerror_error_t **error )
+{
+	static char *function  = "libqcow_extent_index_free";
+	int level2_table_index = 0;
+
+	if( extent_index == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid extent index.",
+		 function );
+
+		return( -1 );
+	}
+	if( *extent_index != NULL )
+	{
+		if( ( *extent_index )->level2_tables != NULL )
+		{
+			for( level2_table_index = 0;
+			     level2_table_index < ( *extent_index )->number_of_level2_tables;
+			     level2_table_index++ )
+			{
+				/* Mapped extents are not owned by the extent index
+				 */
+				if( ( ( ( *extent_index )->level2_tables[ level2_table_index ].flags & LIBQCOW_EXTENT_INDEX_TABLE_FLAG_IS_MAPPED ) == 0 )
+				 && ( ( *extent_index )->level2_tables[ level2_table_index ].extents != NULL ) )
+				{
+					memory_free(
+					 ( *extent_index )->level2_tables[ level2_table_index ].extents );
+				}
+			}
+			memory_free(
+			 ( *extent_index )->level2_tables );
+		}
+		memory_free(
+		 *extent_index );
+
+		*extent_index = NULL;
+	}
+	return( 1 );
+}
+
+/* Appends the cluster block of a level 2 table entry to the extent index
+ * The cluster block is merged into the last extent when it is contiguous
+ * Cluster blocks must be appended in increasing cluster block index order
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_extent_index_append_extent(
+     libqcow_extent_index_t *extent_index,
+     int level2_table_index,
+     int cluster_block_index,
+     uint64_t cluster_block_offset,
+     uint32_t cluster_block_flags,
+     libcerror_error_t **error )
+{
+	libqcow_extent_index_table_t *level2_table = NULL;
+	libqcow_extent_t *extent                   = NULL;
+	libqcow_extent_t *extents                  = NULL;
+	static char *function                      = "libqcow_extent_index_append_extent";
+	uint64_t next_cluster_block_offset         = 0;
+	int number_of_allocated_extents            = 0;
+
+	if( extent_index == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid extent index.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( level2_table_index < 0 )
+	 || ( level2_table_index >= extent_index->number_of_level2_tables ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid level 2 table index value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	if( cluster_block_index < 0 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid cluster block index value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	level2_table = &( extent_index->level2_tables[ level2_table_index ] );
+
+	if( ( level2_table->flags & LIBQCOW_EXTENT_INDEX_TABLE_FLAG_IS_SCANNED ) != 0 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_ALREADY_SET,
+		 "%s: invalid level 2 table: %d - already scanned.",
+		 function,
+		 level2_table_index );
+
+		return( -1 );
+	}
+	if( ( level2_table->flags & LIBQCOW_EXTENT_INDEX_TABLE_FLAG_IS_FRAGMENTED ) != 0 )
+	{
+		return( 1 );
+	}
+	if( level2_table->number_of_extents > 0 )
+	{
+		extent = &( level2_table->extents[ level2_table->number_of_extents - 1 ] );
+
+		if( cluster_block_index < ( extent->first_cluster_block_index + extent->number_of_cluster_blocks ) )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+			 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+			 "%s: invalid cluster block index value out of bounds.",
+			 function );
+
+			return( -1 );
+		}
+		/* Compressed cluster blocks cannot be part of a run
+		 */
+		if( ( cluster_block_index == ( extent->first_cluster_block_index + extent->number_of_cluster_blocks ) )
+		 && ( cluster_block_flags == extent->cluster_block_flags )
+		 && ( ( cluster_block_flags & LIBQCOW_CLUSTER_BLOCK_FLAG_IS_COMPRESSED ) == 0 ) )
+		{
+			if( extent->cluster_block_offset == 0 )
+			{
+				next_cluster_block_offset = 0;
+			}
+			else
+			{
+				next_cluster_block_offset = extent->cluster_block_offset
+				                          + ( (uint64_t) extent->number_of_cluster_blocks * extent_index->cluster_block_size );
+			}
+			if( cluster_block_offset == next_cluster_block_offset )
+			{
+				extent->number_of_cluster_blocks += 1;
+
+				return( 1 );
+			}
+		}
+	}
+	if( level2_table->number_of_extents >= extent_index->maximum_number_of_extents )
+	{
+		/* The level 2 table is too fragmented to be indexed
+		 */
+		if( level2_table->extents != NULL )
+		{
+			memory_free(
+			 level2_table->extents );
+
+			level2_table->extents = NULL;
+		}
+		level2_table->number_of_extents           = 0;
+		level2_table->number_of_allocated_extents = 0;
+		level2_table->flags                      |= LIBQCOW_EXTENT_INDEX_TABLE_FLAG_IS_FRAGMENTED;
+
+		return( 1 );
+	}
+	if( level2_table->number_of_extents >= level2_table->number_of_allocated_extents )
+	{
+		number_of_allocated_extents = level2_table->number_of_allocated_extents * 2;
+
+		if( number_of_allocated_extents == 0 )
+		{
+			number_of_allocated_extents = 16;
+		}
+		if( number_of_allocated_extents > extent_index->maximum_number_of_extents )
+		{
+			number_of_allocated_extents = extent_index->maximum_number_of_extents;
+		}
+		extents = (libqcow_extent_t *) memory_reallocate(
+		                                level2_table->extents,
+		                                sizeof( libqcow_extent_t ) * number_of_allocated_extents );
+
+		if( extents == NULL )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_MEMORY,
+			 LIBCERROR_MEMORY_ERROR_INSUFFICIENT,
+			 "%s: unable to resize extents.",
+			 function );
+
+			return( -1 );
+		}
+		level2_table->extents                     = extents;
+		level2_table->number_of_allocated_extents = number_of_allocated_extents;
+	}
+	extent = &( level2_table->extents[ level2_table->number_of_extents ] );
+
+	extent->first_cluster_block_index = cluster_block_index;
+	extent->number_of_cluster_blocks  = 1;
+	extent->cluster_block_offset      = cluster_block_offset;
+	extent->cluster_block_flags       = cluster_block_flags;
+
+	level2_table->number_of_extents += 1;
+
+	return( 1 );
+}
+
+/* Marks a level 2 table as scanned after all its cluster blocks have been appended
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_extent_index_finalize_level2_table(
+     libqcow_extent_index_t *extent_index,
+     int level2_table_index,
+     libcerror_error_t **error )
+{
+	libqcow_extent_index_table_t *level2_table = NULL;
+	libqcow_extent_t *extents                  = NULL;
+	static char *function                      = "libqcow_extent_index_finalize_level2_table";
+
+	if( extent_index == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid extent index.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( level2_table_index < 0 )
+	 || ( level2_table_index >= extent_index->number_of_level2_tables ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid level 2 table index value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	level2_table = &( extent_index->level2_tables[ level2_table_index ] );
+
+	if( ( level2_table->number_of_extents > 0 )
+	 && ( level2_table->number_of_extents < level2_table->number_of_allocated_extents ) )
+	{
+		extents = (libqcow_extent_t *) memory_reallocate(
+		                                level2_table->extents,
+		                                sizeof( libqcow_extent_t ) * level2_table->number_of_extents );
+
+		if( extents == NULL )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_MEMORY,
+			 LIBCERROR_MEMORY_ERROR_INSUFFICIENT,
+			 "%s: unable to resize extents.",
+			 function );
+
+			return( -1 );
+		}
+		level2_table->extents                     = extents;
+		level2_table->number_of_allocated_extents = level2_table->number_of_extents;
+	}
+	level2_table->flags |= LIBQCOW_EXTENT_INDEX_TABLE_FLAG_IS_SCANNED;
+
+	return( 1 );
+}
+
+/* Sets the extents of a level 2 table that has been scanned before
+ * The extents are referenced and not copied, they must remain available
+ * until the extent index is freed
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_extent_index_set_level2_table_extents(
+     libqcow_extent_index_t *extent_index,
+     int level2_table_index,
+     uint8_t flags,
+     libqcow_extent_t *extents,
+     int number_of_extents,
+     libcerror_error_t **error )
+{
+	libqcow_extent_index_table_t *level2_table = NULL;
+	static char *function                      = "libqcow_extent_index_set_level2_table_extents";
+
+	if( extent_index == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid extent index.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( level2_table_index < 0 )
+	 || ( level2_table_index >= extent_index->number_of_level2_tables ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid level 2 table index value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( flags & ~( LIBQCOW_EXTENT_INDEX_TABLE_FLAG_IS_SCANNED | LIBQCOW_EXTENT_INDEX_TABLE_FLAG_IS_FRAGMENTED ) ) != 0 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_UNSUPPORTED_VALUE,
+		 "%s: unsupported flags: 0x%02" PRIx8 ".",
+		 function,
+		 flags );
+
+		return( -1 );
+	}
+	if( ( flags & LIBQCOW_EXTENT_INDEX_TABLE_FLAG_IS_SCANNED ) == 0 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_UNSUPPORTED_VALUE,
+		 "%s: invalid flags - missing is scanned flag.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( number_of_extents < 0 )
+	 || ( number_of_extents > extent_index->maximum_number_of_extents )
+	 || ( ( ( flags & LIBQCOW_EXTENT_INDEX_TABLE_FLAG_IS_FRAGMENTED ) != 0 )
+	  && ( number_of_extents != 0 ) ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid number of extents value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( extents == NULL )
+	 && ( number_of_extents != 0 ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid extents.",
+		 function );
+
+		return( -1 );
+	}
+	level2_table = &( extent_index->level2_tables[ level2_table_index ] );
+
+	if( ( level2_table->flags != 0 )
+	 || ( level2_table->extents != NULL ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_ALREADY_SET,
+		 "%s: invalid level 2 table: %d - already set.",
+		 function,
+		 level2_table_index );
+
+		return( -1 );
+	}
+	level2_table->flags                       = flags | LIBQCOW_EXTENT_INDEX_TABLE_FLAG_IS_MAPPED;
+	level2_table->number_of_extents           = number_of_extents;
+	level2_table->number_of_allocated_extents = number_of_extents;
+	level2_table->extents                     = extents;
+
+	return( 1 );
+}
+
+/* Determines if a level 2 table has been scanned
+ * Returns 1 if scanned, 0 if not or -1 on error
+ */
+int libqcow_extent_index_is_level2_table_scanned(
+     libqcow_extent_index_t *extent_index,
+     int level2_table_index,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_extent_index_is_level2_table_scanned";
+
+	if( extent_index == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid extent index.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( level2_table_index < 0 )
+	 || ( level2_table_index >= extent_index->number_of_level2_tables ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid level 2 table index value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( extent_index->level2_tables[ level2_table_index ].flags & LIBQCOW_EXTENT_INDEX_TABLE_FLAG_IS_SCANNED ) != 0 )
+	{
+		return( 1 );
+	}
+	return( 0 );
+}
+
+/* Retrieves the number of extents in the extent index
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_extent_index_get_number_of_extents(
+     libqcow_extent_index_t *extent_index,
+     int *number_of_extents,
+     libcerror_error_t **error )
+{
+	static char *function       = "libqcow_extent_index_get_number_of_extents";
+	int level2_table_index      = 0;
+	int safe_number_of_extents  = 0;
+
+	if( extent_index == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid extent index.",
+		 function );
+
+		return( -1 );
+	}
+	if( number_of_extents == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid number of extents.",
+		 function );
+
+		return( -1 );
+	}
+	for( level2_table_index = 0;
+	     level2_table_index < extent_index->number_of_level2_tables;
+	     level2_table_index++ )
+	{
+		if( extent_index->level2_tables[ level2_table_index ].number_of_extents > ( INT_MAX - safe_number_of_extents ) )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_VALUE_EXCEEDS_MAXIMUM,
+			 "%s: invalid number of extents value exceeds maximum.",
+			 function );
+
+			return( -1 );
+		}
+		safe_number_of_extents += extent_index->level2_tables[ level2_table_index ].number_of_extents;
+	}
+	*number_of_extents = safe_number_of_extents;
+
+	return( 1 );
+}
+
+/* Retrieves the cluster block offset and flags of a specific cluster block in a level 2 table
+ * Returns 1 if successful, 0 if the level 2 table is not indexed or -1 on error
+ */
+int libqcow_extent_index_get_cluster_block_by_index(
+     libqcow_extent_index_t *extent_index,
+     int level2_table_index,
+     int cluster_block_index,
+     uint64_t *cluster_block_offset,
+     uint32_t *cluster_block_flags,
+     libcerror_error_t **error )
+{
+	libqcow_extent_index_table_t *level2_table = NULL;
+	libqcow_extent_t *extent                   = NULL;
+	static char *function                      = "libqcow_extent_index_get_cluster_block_by_index";
+	int extent_index_first                     = 0;
+	int extent_index_last                      = 0;
+	int extent_index_middle                    = 0;
+
+	if( extent_index == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid extent index.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( level2_table_index < 0 )
+	 || ( level2_table_index >= extent_index->number_of_level2_tables ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid level 2 table index value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	if( cluster_block_index < 0 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid cluster block index value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	if( cluster_block_offset == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid cluster block offset.",
+		 function );
+
+		return( -1 );
+	}
+	if( cluster_block_flags == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid cluster block flags.",
+		 function );
+
+		return( -1 );
+	}
+	level2_table = &( extent_index->level2_tables[ level2_table_index ] );
+
+	if( ( ( level2_table->flags & LIBQCOW_EXTENT_INDEX_TABLE_FLAG_IS_SCANNED ) == 0 )
+	 || ( ( level2_table->flags & LIBQCOW_EXTENT_INDEX_TABLE_FLAG_IS_FRAGMENTED ) != 0 ) )
+	{
+		return( 0 );
+	}
+	extent_index_last = level2_table->number_of_extents - 1;
+
+	while( extent_index_first <= extent_index_last )
+	{
+		extent_index_middle = extent_index_first + ( ( extent_index_last - extent_index_first ) / 2 );
+
+		extent = &( level2_table->extents[ extent_index_middle ] );
+
+		if( cluster_block_index < extent->first_cluster_block_index )
+		{
+			extent_index_last = extent_index_middle - 1;
+		}
+		else if( cluster_block_index >= ( extent->first_cluster_block_index + extent->number_of_cluster_blocks ) )
+		{
+			extent_index_first = extent_index_middle + 1;
+		}
+		else
+		{
+			*cluster_block_offset = extent->cluster_block_offset;
+			*cluster_block_flags  = extent->cluster_block_flags;
+
+			if( *cluster_block_offset != 0 )
+			{
+				*cluster_block_offset += (uint64_t) ( cluster_block_index - extent->first_cluster_block_index ) * extent_index->cluster_block_size;
+			}
+			return( 1 );
+		}
+	}
+	/* Cluster blocks that were not appended are sparse
+	 */
+	*cluster_block_offset = 0;
+	*cluster_block_flags  = 0;
+
+	return( 1 );
+}
+
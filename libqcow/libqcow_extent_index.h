@@ -0,0 +1,156 @@
+/*
+ * Extent index functions
+ *
+ * Copyright (C) 2010-2026, Joachim Metz <joachim.metz@gmail.com>
+ *
+ * Refer to AUTHORS for acknowledgements.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#if !defined( _LIBQCOW_EXTENT_INDEX_H )
+#define _LIBQCOW_EXTENT_INDEX_H
+
+#include <common.h>
+#include <types.h>
+
+#include "libqcow_libcerror.h"
+
+#if defined( __cplusplus )
+extern "C" {
+#endif
+
+typedef struct libqcow_extent libqcow_extent_t;
+
+struct libqcow_extent
+{
+	/* The first cluster block index, relative to the level 2 table
+	 */
+	int first_cluster_block_index;
+
+	/* The number of cluster blocks
+	 */
+	int number_of_cluster_blocks;
+
+	/* The cluster block (file) offset of the first cluster block
+	 */
+	uint64_t cluster_block_offset;
+
+	/* The cluster block flags
+	 */
+	uint32_t cluster_block_flags;
+};
+
+typedef struct libqcow_extent_index_table libqcow_extent_index_table_t;
+
+struct libqcow_extent_index_table
+{
+	/* The flags
+	 */
+	uint8_t flags;
+
+	/* The number of extents
+	 */
+	int number_of_extents;
+
+	/* The number of allocated extents
+	 */
+	int number_of_allocated_extents;
+
+	/* The extents, sorted by cluster block index
+	 */
+	libqcow_extent_t *extents;
+};
+
+typedef struct libqcow_extent_index libqcow_extent_index_t;
+
+struct libqcow_extent_index
+{
+	/* The cluster block size
+	 */
+	size64_t cluster_block_size;
+
+	/* The number of references per level 2 table
+	 */
+	int number_of_level2_table_references;
+
+	/* The maximum number of extents per level 2 table
+	 */
+	int maximum_number_of_extents;
+
+	/* The number of level 2 tables
+	 */
+	int number_of_level2_tables;
+
+	/* The level 2 tables
+	 */
+	libqcow_extent_index_table_t *level2_tables;
+};
+
+int libqcow_extent_index_initialize(
+     libqcow_extent_index_t **extent_index,
+     int number_of_level2_tables,
+     int number_of_level2_table_references,
+     size64_t cluster_block_size,
+     libcerror_error_t **error );
+
+int libqcow_extent_index_free(
+     libqcow_extent_index_t **extent_index,
+     libcerror_error_t **error );
+
+int libqcow_extent_index_append_extent(
+     libqcow_extent_index_t *extent_index,
+     int level2_table_index,
+     int cluster_block_index,
+     uint64_t cluster_block_offset,
+     uint32_t cluster_block_flags,
+     libcerror_error_t **error );
+
+int libqcow_extent_index_finalize_level2_table(
+     libqcow_extent_index_t *extent_index,
+     int level2_table_index,
+     libcerror_error_t **error );
+
+int libqcow_extent_index_set_level2_table_extents(
+     libqcow_extent_index_t *extent_index,
+     int level2_table_index,
+     uint8_t flags,
+     libqcow_extent_t *extents,
+     int number_of_extents,
+     libcerror_error_t **error );
+
+int libqcow_extent_index_is_level2_table_scanned(
+     libqcow_extent_index_t *extent_index,
+     int level2_table_index,
+     libcerror_error_t **error );
+
+int libqcow_extent_index_get_number_of_extents(
+     libqcow_extent_index_t *extent_index,
+     int *number_of_extents,
+     libcerror_error_t **error );
+
+int libqcow_extent_index_get_cluster_block_by_index(
+     libqcow_extent_index_t *extent_index,
+     int level2_table_index,
+     int cluster_block_index,
+     uint64_t *cluster_block_offset,
+     uint32_t *cluster_block_flags,
+     libcerror_error_t **error );
+
+#if defined( __cplusplus )
+}
+#endif
+
+#endif /* !defined( _LIBQCOW_EXTENT_INDEX_H ) */
+
@@ -20,19 +20,28 @@
  */
 
 #include <common.h>
+#include <byte_stream.h>
 #include <memory.h>
 #include <narrow_string.h>
 #include <types.h>
 #include <wide_string.h>
 
+#include "libqcow_cache_pool.h"
+#include "libqcow_chain_index.h"
+#include "libqcow_changed_extents.h"
 #include "libqcow_cluster_block.h"
 #include "libqcow_cluster_table.h"
 #include "libqcow_codepage.h"
 #include "libqcow_compression.h"
+#include "libqcow_cursor.h"
+#include "libqcow_data_pin.h"
 #include "libqcow_debug.h"
 #include "libqcow_definitions.h"
 #include "libqcow_encryption.h"
+#include "libqcow_export_writer.h"
+#include "libqcow_extent_index.h"
 #include "libqcow_file_header.h"
+#include "libqcow_file_io_pool.h"
 #include "libqcow_i18n.h"
 #include "libqcow_io_handle.h"
 #include "libqcow_file.h"
@@ -43,6 +52,13 @@
 #include "libqcow_libfcache.h"
 #include "libqcow_libfdata.h"
 #include "libqcow_libuna.h"
+#include "libqcow_mapped_file.h"
+#include "libqcow_mapping_index.h"
+#include "libqcow_read_control.h"
+#include "libqcow_read_request.h"
+#include "libqcow_scanner.h"
+#include "libqcow_snapshot.h"
+#include "libqcow_snapshot_values.h"
 
 /* Creates a file
  * Make sure the value file is referencing, is set to NULL
@@ -147,6 +163,19 @@ int libqcow_file_initialize(
 
 		goto on_error;
 	}
+	if( libcthreads_mutex_initialize(
+	     &( internal_file->abort_mutex ),
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+		 "%s: unable to initialize abort mutex.",
+		 function );
+
+		goto on_error;
+	}
 #endif
 	internal_file->is_locked = 1;
 
@@ -157,6 +186,14 @@ int libqcow_file_initialize(
 on_error:
 	if( internal_file != NULL )
 	{
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+		if( internal_file->read_write_lock != NULL )
+		{
+			libcthreads_read_write_lock_free(
+			 &( internal_file->read_write_lock ),
+			 NULL );
+		}
+#endif
 		if( internal_file->io_handle != NULL )
 		{
 			libqcow_io_handle_free(
@@ -227,7 +264,86 @@ int libqcow_file_free(
 
 			result = -1;
 		}
+		if( libcthreads_mutex_free(
+		     &( internal_file->abort_mutex ),
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+			 "%s: unable to free abort mutex.",
+			 function );
+
+			result = -1;
+		}
+#endif
+		if( internal_file->cache_pool != NULL )
+		{
+			if( libqcow_cache_pool_free(
+			     &( internal_file->cache_pool ),
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+				 "%s: unable to free cache pool.",
+				 function );
+
+				result = -1;
+			}
+		}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+		/* A worker can still hold the queue after the last decode job has completed
+		 */
+		if( internal_file->decode_scheduler_queue != NULL )
+		{
+			if( libqcow_scheduler_wait_for_queue(
+			     internal_file->scheduler,
+			     internal_file->decode_scheduler_queue,
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+				 "%s: unable to wait for decode scheduler queue.",
+				 function );
+
+				result = -1;
+			}
+			else if( libqcow_scheduler_queue_free(
+			          &( internal_file->decode_scheduler_queue ),
+			          error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+				 "%s: unable to free decode scheduler queue.",
+				 function );
+
+				result = -1;
+			}
+		}
 #endif
+		if( internal_file->scheduler != NULL )
+		{
+			if( libqcow_scheduler_free(
+			     &( internal_file->scheduler ),
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+				 "%s: unable to free scheduler.",
+				 function );
+
+				result = -1;
+			}
+		}
 		if( libqcow_io_handle_free(
 		     &( internal_file->io_handle ),
 		     error ) != 1 )
@@ -262,6 +378,8 @@ int libqcow_file_free(
 }
 
 /* Signals a file to abort its current activity
+ * Reads in progress stop between cluster blocks and between the layers of the backing chain,
+ * reads that start after the abort was signalled are not affected
  * Returns 1 if successful or -1 on error
  */
 int libqcow_file_signal_abort(
@@ -284,19 +402,40 @@ int libqcow_file_signal_abort(
 	}
 	internal_file = (libqcow_internal_file_t *) file;
 
-	if( internal_file->io_handle == NULL )
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_mutex_grab(
+	     internal_file->abort_mutex,
+	     error ) != 1 )
 	{
 		libcerror_error_set(
 		 error,
 		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
-		 "%s: invalid file - missing IO handle.",
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab abort mutex.",
 		 function );
 
 		return( -1 );
 	}
-	internal_file->io_handle->abort = 1;
+#endif
+	/* Reads in progress have the previous abort generation and stop
+	 */
+	internal_file->abort_generation += 1;
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_mutex_release(
+	     internal_file->abort_mutex,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release abort mutex.",
+		 function );
 
+		return( -1 );
+	}
+#endif
 	return( 1 );
 }
 
@@ -309,9 +448,14 @@ int libqcow_file_open(
      int access_flags,
      libcerror_error_t **error )
 {
+	libqcow_file_identity_t file_identity;
+
 	libbfio_handle_t *file_io_handle       = NULL;
 	libqcow_internal_file_t *internal_file = NULL;
 	static char *function                  = "libqcow_file_open";
+	int file_identity_result               = 0;
+	int mapped_file_opened_in_function     = 0;
+	int result                             = 1;
 
 	if( file == NULL )
 	{
@@ -405,6 +549,45 @@ int libqcow_file_open(
 
 		goto on_error;
 	}
+	if( ( access_flags & LIBQCOW_OPEN_FLAG_MMAP ) != 0 )
+	{
+		if( libqcow_internal_file_open_mapped_file(
+		     internal_file,
+		     filename,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_IO,
+			 LIBCERROR_IO_ERROR_OPEN_FAILED,
+			 "%s: unable to open mapped file.",
+			 function );
+
+			goto on_error;
+		}
+		mapped_file_opened_in_function = 1;
+	}
+	/* The cache pool shares the cluster blocks of files with the same identity
+	 */
+	if( internal_file->cache_pool != NULL )
+	{
+		file_identity_result = libqcow_cache_pool_get_file_identity(
+		                        filename,
+		                        &file_identity,
+		                        error );
+
+		if( file_identity_result == -1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+			 "%s: unable to retrieve file identity.",
+			 function );
+
+			goto on_error;
+		}
+	}
 	if( libqcow_file_open_file_io_handle(
 	     file,
 	     file_io_handle,
@@ -438,6 +621,33 @@ int libqcow_file_open(
 #endif
 	internal_file->file_io_handle_created_in_library = 1;
 
+	if( file_identity_result == 1 )
+	{
+		internal_file->file_identity.device_number = file_identity.device_number;
+		internal_file->file_identity.inode_number  = file_identity.inode_number;
+		internal_file->file_identity.size          = file_identity.size;
+		internal_file->file_identity_is_set        = 1;
+	}
+	/* The extent index is not available for level 2 table entries with subclusters
+	 */
+	if( ( ( access_flags & LIBQCOW_OPEN_FLAG_MAPPING_INDEX ) != 0 )
+	 && ( internal_file->extent_index != NULL ) )
+	{
+		result = libqcow_internal_file_open_mapping_index(
+		          internal_file,
+		          filename,
+		          error );
+
+		if( result != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_IO,
+			 LIBCERROR_IO_ERROR_OPEN_FAILED,
+			 "%s: unable to open mapping index.",
+			 function );
+		}
+	}
 #if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
 	if( libcthreads_read_write_lock_release_for_write(
 	     internal_file->read_write_lock,
@@ -453,9 +663,23 @@ int libqcow_file_open(
 		return( -1 );
 	}
 #endif
+	if( result != 1 )
+	{
+		libqcow_file_close(
+		 file,
+		 NULL );
+
+		return( -1 );
+	}
 	return( 1 );
 
 on_error:
+	if( mapped_file_opened_in_function != 0 )
+	{
+		libqcow_mapped_file_free(
+		 &( internal_file->mapped_file ),
+		 NULL );
+	}
 	if( file_io_handle != NULL )
 	{
 		libbfio_handle_free(
@@ -634,21 +858,21 @@ on_error:
 
 #endif /* defined( HAVE_WIDE_CHARACTER_TYPE ) */
 
-/* Opens a file using a Basic File IO (bfio) handle
+/* Opens a file and the files of its backing chain
+ * The backing files are opened with the same access flags and are closed
+ * together with the file. The cache entries of the files in the backing chain
+ * are apportioned across the files according to how frequently they are accessed
  * Returns 1 if successful or -1 on error
  */
-int libqcow_file_open_file_io_handle(
+int libqcow_file_open_with_backing_chain(
      libqcow_file_t *file,
-     libbfio_handle_t *file_io_handle,
+     const char *filename,
      int access_flags,
      libcerror_error_t **error )
 {
-	libqcow_internal_file_t *internal_file   = NULL;
-	static char *function                    = "libqcow_file_open_file_io_handle";
-	uint8_t file_io_handle_opened_in_library = 0;
-	int bfio_access_flags                    = 0;
-	int file_io_handle_is_open               = 0;
-	int result                               = 0;
+	libqcow_internal_file_t *internal_file = NULL;
+	static char *function                  = "libqcow_file_open_with_backing_chain";
+	int result                             = 0;
 
 	if( file == NULL )
 	{
@@ -663,87 +887,21 @@ int libqcow_file_open_file_io_handle(
 	}
 	internal_file = (libqcow_internal_file_t *) file;
 
-	if( internal_file->file_io_handle != NULL )
-	{
-		libcerror_error_set(
-		 error,
-		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-		 LIBCERROR_RUNTIME_ERROR_VALUE_ALREADY_SET,
-		 "%s: invalid file - file IO handle already set.",
-		 function );
-
-		return( -1 );
-	}
-	if( file_io_handle == NULL )
-	{
-		libcerror_error_set(
-		 error,
-		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
-		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
-		 "%s: invalid file IO handle.",
-		 function );
-
-		return( -1 );
-	}
-	if( ( ( access_flags & LIBQCOW_ACCESS_FLAG_READ ) == 0 )
-	 && ( ( access_flags & LIBQCOW_ACCESS_FLAG_WRITE ) == 0 ) )
-	{
-		libcerror_error_set(
-		 error,
-		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
-		 LIBCERROR_ARGUMENT_ERROR_UNSUPPORTED_VALUE,
-		 "%s: unsupported access flags.",
-		 function );
-
-		return( -1 );
-	}
-	if( ( access_flags & LIBQCOW_ACCESS_FLAG_WRITE ) != 0 )
-	{
-		libcerror_error_set(
-		 error,
-		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
-		 LIBCERROR_ARGUMENT_ERROR_UNSUPPORTED_VALUE,
-		 "%s: write access currently not supported.",
-		 function );
-
-		return( -1 );
-	}
-	if( ( access_flags & LIBQCOW_ACCESS_FLAG_READ ) != 0 )
-	{
-		bfio_access_flags = LIBBFIO_ACCESS_FLAG_READ;
-	}
-	file_io_handle_is_open = libbfio_handle_is_open(
-	                          file_io_handle,
-	                          error );
-
-	if( file_io_handle_is_open == -1 )
+	if( libqcow_internal_file_open_backing_chain(
+	     file,
+	     filename,
+	     access_flags,
+	     0,
+	     error ) != 1 )
 	{
 		libcerror_error_set(
 		 error,
 		 LIBCERROR_ERROR_DOMAIN_IO,
 		 LIBCERROR_IO_ERROR_OPEN_FAILED,
-		 "%s: unable to determine if file IO handle is open.",
+		 "%s: unable to open file with backing chain.",
 		 function );
 
-		goto on_error;
-	}
-	else if( file_io_handle_is_open == 0 )
-	{
-		if( libbfio_handle_open(
-		     file_io_handle,
-		     bfio_access_flags,
-		     error ) != 1 )
-		{
-			libcerror_error_set(
-			 error,
-			 LIBCERROR_ERROR_DOMAIN_IO,
-			 LIBCERROR_IO_ERROR_OPEN_FAILED,
-			 "%s: unable to open file IO handle.",
-			 function );
-
-			goto on_error;
-		}
-		file_io_handle_opened_in_library = 1;
+		return( -1 );
 	}
 #if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
 	if( libcthreads_read_write_lock_grab_for_write(
@@ -757,28 +915,26 @@ int libqcow_file_open_file_io_handle(
 		 "%s: unable to grab read/write lock for writing.",
 		 function );
 
+		libqcow_file_close(
+		 file,
+		 NULL );
+
 		return( -1 );
 	}
 #endif
-	result = libqcow_internal_file_open_read(
+	result = libqcow_internal_file_apportion_cache_budget(
 	          internal_file,
-	          file_io_handle,
 	          error );
 
 	if( result != 1 )
 	{
 		libcerror_error_set(
 		 error,
-		 LIBCERROR_ERROR_DOMAIN_IO,
-		 LIBCERROR_IO_ERROR_READ_FAILED,
-		 "%s: unable to read from file IO handle.",
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to apportion cache budget.",
 		 function );
 	}
-	else
-	{
-		internal_file->file_io_handle                   = file_io_handle;
-		internal_file->file_io_handle_opened_in_library = file_io_handle_opened_in_library;
-	}
 #if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
 	if( libcthreads_read_write_lock_release_for_write(
 	     internal_file->read_write_lock,
@@ -791,30 +947,36 @@ int libqcow_file_open_file_io_handle(
 		 "%s: unable to release read/write lock for writing.",
 		 function );
 
-		return( -1 );
+		result = -1;
 	}
 #endif
-	return( result );
-
-on_error:
-	if( file_io_handle_opened_in_library != 0 )
+	if( result != 1 )
 	{
-		libbfio_handle_close(
-		 file_io_handle,
-		 error );
+		libqcow_file_close(
+		 file,
+		 NULL );
+
+		return( -1 );
 	}
-	return( -1 );
+	return( 1 );
 }
 
-/* Closes a file
- * Returns 0 if successful or -1 on error
+#if defined( HAVE_WIDE_CHARACTER_TYPE )
+
+/* Opens a file and the files of its backing chain
+ * The backing files are opened with the same access flags and are closed
+ * together with the file. The cache entries of the files in the backing chain
+ * are apportioned across the files according to how frequently they are accessed
+ * Returns 1 if successful or -1 on error
  */
-int libqcow_file_close(
+int libqcow_file_open_with_backing_chain_wide(
      libqcow_file_t *file,
+     const wchar_t *filename,
+     int access_flags,
      libcerror_error_t **error )
 {
 	libqcow_internal_file_t *internal_file = NULL;
-	static char *function                  = "libqcow_file_close";
+	static char *function                  = "libqcow_file_open_with_backing_chain_wide";
 	int result                             = 0;
 
 	if( file == NULL )
@@ -830,13 +992,18 @@ int libqcow_file_close(
 	}
 	internal_file = (libqcow_internal_file_t *) file;
 
-	if( internal_file->file_io_handle == NULL )
+	if( libqcow_internal_file_open_backing_chain_wide(
+	     file,
+	     filename,
+	     access_flags,
+	     0,
+	     error ) != 1 )
 	{
 		libcerror_error_set(
 		 error,
-		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
-		 "%s: invalid file - missing file IO handle.",
+		 LIBCERROR_ERROR_DOMAIN_IO,
+		 LIBCERROR_IO_ERROR_OPEN_FAILED,
+		 "%s: unable to open file with backing chain.",
 		 function );
 
 		return( -1 );
@@ -853,885 +1020,880 @@ int libqcow_file_close(
 		 "%s: unable to grab read/write lock for writing.",
 		 function );
 
-		return( -1 );
-	}
-#endif
-#if defined( HAVE_DEBUG_OUTPUT )
-	if( libcnotify_verbose != 0 )
-	{
-		if( internal_file->file_io_handle_created_in_library != 0 )
-		{
-			if( libqcow_debug_print_read_offsets(
-			     internal_file->file_io_handle,
-			     error ) != 1 )
-			{
-				libcerror_error_set(
-				 error,
-				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-				 LIBCERROR_RUNTIME_ERROR_PRINT_FAILED,
-				 "%s: unable to print the read offsets.",
-				 function );
+		libqcow_file_close(
+		 file,
+		 NULL );
 
-				result = -1;
-			}
-		}
+		return( -1 );
 	}
 #endif
-	if( internal_file->file_io_handle_opened_in_library != 0 )
-	{
-		if( libbfio_handle_close(
-		     internal_file->file_io_handle,
-		     error ) != 0 )
-		{
-			libcerror_error_set(
-			 error,
-			 LIBCERROR_ERROR_DOMAIN_IO,
-			 LIBCERROR_IO_ERROR_CLOSE_FAILED,
-			 "%s: unable to close file IO handle.",
-			 function );
-
-			result = -1;
-		}
-		internal_file->file_io_handle_opened_in_library = 0;
-	}
-	if( internal_file->file_io_handle_created_in_library != 0 )
-	{
-		if( libbfio_handle_free(
-		     &( internal_file->file_io_handle ),
-		     error ) != 1 )
-		{
-			libcerror_error_set(
-			 error,
-			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-			 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
-			 "%s: unable to free file IO handle.",
-			 function );
-
-			result = -1;
-		}
-		internal_file->file_io_handle_created_in_library = 0;
-	}
-	internal_file->file_io_handle = NULL;
-	internal_file->current_offset = 0;
-	internal_file->is_locked      = 1;
+	result = libqcow_internal_file_apportion_cache_budget(
+	          internal_file,
+	          error );
 
-	if( libqcow_io_handle_clear(
-	     internal_file->io_handle,
-	     error ) != 1 )
+	if( result != 1 )
 	{
 		libcerror_error_set(
 		 error,
 		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-		 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
-		 "%s: unable to clear IO handle.",
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to apportion cache budget.",
 		 function );
-
-		result = -1;
 	}
-	if( libqcow_file_header_free(
-	     &( internal_file->file_header ),
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_release_for_write(
+	     internal_file->read_write_lock,
 	     error ) != 1 )
 	{
 		libcerror_error_set(
 		 error,
 		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-		 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
-		 "%s: unable to free file header.",
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release read/write lock for writing.",
 		 function );
 
 		result = -1;
 	}
-	if( internal_file->backing_filename != NULL )
+#endif
+	if( result != 1 )
 	{
-		memory_free(
-		 internal_file->backing_filename );
+		libqcow_file_close(
+		 file,
+		 NULL );
 
-		internal_file->backing_filename      = NULL;
-		internal_file->backing_filename_size = 0;
+		return( -1 );
 	}
-	if( libqcow_cluster_table_free(
-	     &( internal_file->level1_table ),
-	     error ) != 1 )
+	return( 1 );
+}
+
+#endif /* defined( HAVE_WIDE_CHARACTER_TYPE ) */
+
+/* Retrieves the path of the backing file
+ * A relative backing filename is relative to the directory that contains the file
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_internal_file_get_backing_file_path(
+     libqcow_internal_file_t *internal_file,
+     const char *filename,
+     char **backing_file_path,
+     size_t *backing_file_path_size,
+     libcerror_error_t **error )
+{
+	char *safe_backing_file_path       = NULL;
+	static char *function              = "libqcow_internal_file_get_backing_file_path";
+	size_t backing_filename_length     = 0;
+	size_t directory_length            = 0;
+	size_t safe_backing_file_path_size = 0;
+
+	if( internal_file == NULL )
 	{
 		libcerror_error_set(
 		 error,
-		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-		 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
-		 "%s: unable to free level 1 table.",
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
 		 function );
 
-		result = -1;
+		return( -1 );
 	}
-	if( libfdata_vector_free(
-	     &( internal_file->level2_table_vector ),
-	     error ) != 1 )
+	if( internal_file->backing_filename == NULL )
 	{
 		libcerror_error_set(
 		 error,
 		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-		 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
-		 "%s: unable to free level2 table vector.",
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid file - missing backing filename.",
 		 function );
 
-		result = -1;
+		return( -1 );
 	}
-	if( libfcache_cache_free(
-	     &( internal_file->level2_table_cache ),
-	     error ) != 1 )
+	if( filename == NULL )
 	{
 		libcerror_error_set(
 		 error,
-		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-		 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
-		 "%s: unable to free level2 table cache.",
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid filename.",
 		 function );
 
-		result = -1;
+		return( -1 );
 	}
-	if( libfdata_vector_free(
-	     &( internal_file->cluster_block_vector ),
-	     error ) != 1 )
+	if( backing_file_path == NULL )
 	{
 		libcerror_error_set(
 		 error,
-		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-		 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
-		 "%s: unable to free cluster block vector.",
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid backing file path.",
 		 function );
 
-		result = -1;
+		return( -1 );
 	}
-	if( libfcache_cache_free(
-	     &( internal_file->cluster_block_cache ),
-	     error ) != 1 )
+	if( *backing_file_path != NULL )
 	{
 		libcerror_error_set(
 		 error,
 		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-		 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
-		 "%s: unable to free cluster block cache.",
+		 LIBCERROR_RUNTIME_ERROR_VALUE_ALREADY_SET,
+		 "%s: invalid backing file path value already set.",
 		 function );
 
-		result = -1;
+		return( -1 );
 	}
-	if( libfcache_cache_free(
-	     &( internal_file->compressed_cluster_block_cache ),
-	     error ) != 1 )
+	if( backing_file_path_size == NULL )
 	{
 		libcerror_error_set(
 		 error,
-		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-		 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
-		 "%s: unable to free compressed cluster block cache.",
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid backing file path size.",
 		 function );
 
-		result = -1;
+		return( -1 );
 	}
-	if( internal_file->encryption_context != NULL )
-	{
-		if( libqcow_encryption_free(
-		     &( internal_file->encryption_context ),
-		     error ) != 1 )
-		{
-			libcerror_error_set(
-			 error,
-			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-			 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
-			 "%s: unable to free encryption context.",
-			 function );
+	backing_filename_length = internal_file->backing_filename_size;
 
-			result = -1;
-		}
+	while( ( backing_filename_length > 0 )
+	    && ( internal_file->backing_filename[ backing_filename_length - 1 ] == 0 ) )
+	{
+		backing_filename_length--;
 	}
-#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
-	if( libcthreads_read_write_lock_release_for_write(
-	     internal_file->read_write_lock,
-	     error ) != 1 )
+	if( backing_filename_length == 0 )
 	{
 		libcerror_error_set(
 		 error,
 		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
-		 "%s: unable to release read/write lock for writing.",
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid file - empty backing filename.",
 		 function );
 
 		return( -1 );
 	}
+#if defined( WINAPI )
+	if( ( internal_file->backing_filename[ 0 ] != (uint8_t) '\\' )
+	 && ( internal_file->backing_filename[ 0 ] != (uint8_t) '/' )
+	 && ( ( backing_filename_length < 2 )
+	  ||  ( internal_file->backing_filename[ 1 ] != (uint8_t) ':' ) ) )
+#else
+	if( internal_file->backing_filename[ 0 ] != (uint8_t) '/' )
 #endif
-	return( result );
-}
-
-/* Opens a file for reading
- * Returns 1 if successful or -1 on error
- */
-int libqcow_internal_file_open_read(
-     libqcow_internal_file_t *internal_file,
-     libbfio_handle_t *file_io_handle,
-     libcerror_error_t **error )
-{
-	static char *function                      = "libqcow_internal_file_open_read";
-	size_t level1_table_size                   = 0;
-	size_t level2_table_size                   = 0;
-	uint32_t number_of_level1_table_references = 0;
-	uint32_t number_of_level2_table_bits       = 0;
-	int entry_index                            = 0;
-
-	if( internal_file == NULL )
 	{
-		libcerror_error_set(
-		 error,
-		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
-		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
-		 "%s: invalid file.",
-		 function );
+		directory_length = narrow_string_length(
+		                    filename );
 
-		return( -1 );
+		while( directory_length > 0 )
+		{
+#if defined( WINAPI )
+			if( ( filename[ directory_length - 1 ] == '\\' )
+			 || ( filename[ directory_length - 1 ] == '/' ) )
+#else
+			if( filename[ directory_length - 1 ] == '/' )
+#endif
+			{
+				break;
+			}
+			directory_length--;
+		}
 	}
-	if( internal_file->io_handle == NULL )
+	safe_backing_file_path_size = directory_length + backing_filename_length + 1;
+
+	if( safe_backing_file_path_size > (size_t) MEMORY_MAXIMUM_ALLOCATION_SIZE )
 	{
 		libcerror_error_set(
 		 error,
 		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
-		 "%s: invalid file - missing IO handle.",
+		 LIBCERROR_RUNTIME_ERROR_VALUE_EXCEEDS_MAXIMUM,
+		 "%s: invalid backing file path size value exceeds maximum.",
 		 function );
 
 		return( -1 );
 	}
-	if( internal_file->file_header != NULL )
+	safe_backing_file_path = narrow_string_allocate(
+	                          safe_backing_file_path_size );
+
+	if( safe_backing_file_path == NULL )
 	{
 		libcerror_error_set(
 		 error,
-		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-		 LIBCERROR_RUNTIME_ERROR_VALUE_ALREADY_SET,
-		 "%s: invalid file - file header value already set.",
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_INSUFFICIENT,
+		 "%s: unable to create backing file path.",
 		 function );
 
-		return( -1 );
+		goto on_error;
 	}
-	if( internal_file->backing_filename != NULL )
+	if( directory_length > 0 )
 	{
-		libcerror_error_set(
-		 error,
-		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-		 LIBCERROR_RUNTIME_ERROR_VALUE_ALREADY_SET,
-		 "%s: invalid file - backing filename value already set.",
-		 function );
+		if( memory_copy(
+		     safe_backing_file_path,
+		     filename,
+		     directory_length ) == NULL )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_MEMORY,
+			 LIBCERROR_MEMORY_ERROR_COPY_FAILED,
+			 "%s: unable to copy directory to backing file path.",
+			 function );
 
-		return( -1 );
+			goto on_error;
+		}
 	}
-	if( internal_file->level1_table != NULL )
+	if( memory_copy(
+	     &( safe_backing_file_path[ directory_length ] ),
+	     internal_file->backing_filename,
+	     backing_filename_length ) == NULL )
 	{
 		libcerror_error_set(
 		 error,
-		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-		 LIBCERROR_RUNTIME_ERROR_VALUE_ALREADY_SET,
-		 "%s: invalid file - level 1 table already set.",
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_COPY_FAILED,
+		 "%s: unable to copy backing filename to backing file path.",
 		 function );
 
-		return( -1 );
+		goto on_error;
 	}
-	if( internal_file->level2_table_vector != NULL )
-	{
-		libcerror_error_set(
-		 error,
-		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-		 LIBCERROR_RUNTIME_ERROR_VALUE_ALREADY_SET,
-		 "%s: invalid file - level2 table vector already set.",
-		 function );
+	safe_backing_file_path[ safe_backing_file_path_size - 1 ] = 0;
 
-		return( -1 );
+	*backing_file_path      = safe_backing_file_path;
+	*backing_file_path_size = safe_backing_file_path_size;
+
+	return( 1 );
+
+on_error:
+	if( safe_backing_file_path != NULL )
+	{
+		memory_free(
+		 safe_backing_file_path );
 	}
-	if( internal_file->level2_table_cache != NULL )
+	return( -1 );
+}
+
+/* Opens a file and, recursively, the files of its backing chain
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_internal_file_open_backing_chain(
+     libqcow_file_t *file,
+     const char *filename,
+     int access_flags,
+     int chain_depth,
+     libcerror_error_t **error )
+{
+	libqcow_file_t *parent_file            = NULL;
+	libqcow_internal_file_t *internal_file = NULL;
+	char *backing_file_path                = NULL;
+	static char *function                  = "libqcow_internal_file_open_backing_chain";
+	size_t backing_file_path_size          = 0;
+
+	if( file == NULL )
 	{
 		libcerror_error_set(
 		 error,
-		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-		 LIBCERROR_RUNTIME_ERROR_VALUE_ALREADY_SET,
-		 "%s: invalid file - level2 table cache already set.",
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
 		 function );
 
 		return( -1 );
 	}
-	if( internal_file->cluster_block_vector != NULL )
+	internal_file = (libqcow_internal_file_t *) file;
+
+	if( ( chain_depth < 0 )
+	 || ( chain_depth > LIBQCOW_MAXIMUM_BACKING_CHAIN_DEPTH ) )
 	{
 		libcerror_error_set(
 		 error,
-		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-		 LIBCERROR_RUNTIME_ERROR_VALUE_ALREADY_SET,
-		 "%s: invalid file - cluster block vector already set.",
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid chain depth value out of bounds.",
 		 function );
 
 		return( -1 );
 	}
-	if( internal_file->cluster_block_cache != NULL )
+	if( libqcow_file_open(
+	     file,
+	     filename,
+	     access_flags,
+	     error ) != 1 )
 	{
 		libcerror_error_set(
 		 error,
-		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-		 LIBCERROR_RUNTIME_ERROR_VALUE_ALREADY_SET,
-		 "%s: invalid file - cluster block cache already set.",
+		 LIBCERROR_ERROR_DOMAIN_IO,
+		 LIBCERROR_IO_ERROR_OPEN_FAILED,
+		 "%s: unable to open file.",
 		 function );
 
 		return( -1 );
 	}
-	if( internal_file->compressed_cluster_block_cache != NULL )
+	if( internal_file->backing_filename == NULL )
+	{
+		return( 1 );
+	}
+	if( chain_depth >= LIBQCOW_MAXIMUM_BACKING_CHAIN_DEPTH )
 	{
 		libcerror_error_set(
 		 error,
 		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-		 LIBCERROR_RUNTIME_ERROR_VALUE_ALREADY_SET,
-		 "%s: invalid file - compressed cluster block cache already set.",
+		 LIBCERROR_RUNTIME_ERROR_VALUE_EXCEEDS_MAXIMUM,
+		 "%s: invalid backing chain depth value exceeds maximum.",
 		 function );
 
-		return( -1 );
+		goto on_error;
 	}
-	if( libbfio_handle_get_size(
-	     file_io_handle,
-	     &( internal_file->size ),
+	if( libqcow_internal_file_get_backing_file_path(
+	     internal_file,
+	     filename,
+	     &backing_file_path,
+	     &backing_file_path_size,
 	     error ) != 1 )
 	{
 		libcerror_error_set(
 		 error,
 		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
 		 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
-		 "%s: unable to retrieve file size.",
+		 "%s: unable to retrieve backing file path.",
 		 function );
 
 		goto on_error;
 	}
-	if( internal_file->size == 0 )
+	if( libqcow_file_initialize(
+	     &parent_file,
+	     error ) != 1 )
 	{
 		libcerror_error_set(
 		 error,
 		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
-		 "%s: invalid file size.",
+		 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+		 "%s: unable to create parent file.",
 		 function );
 
 		goto on_error;
 	}
-#if defined( HAVE_DEBUG_OUTPUT )
-	if( libcnotify_verbose != 0 )
+	if( internal_file->cache_pool != NULL )
 	{
-		libcnotify_printf(
-		 "Reading file header:\n" );
+		if( libqcow_file_set_cache_pool(
+		     parent_file,
+		     internal_file->cache_pool,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+			 "%s: unable to set cache pool in parent file.",
+			 function );
+
+			goto on_error;
+		}
 	}
-#endif
-	if( libqcow_file_header_initialize(
-	     &( internal_file->file_header ),
+	if( libqcow_internal_file_open_backing_chain(
+	     parent_file,
+	     backing_file_path,
+	     access_flags,
+	     chain_depth + 1,
 	     error ) != 1 )
 	{
 		libcerror_error_set(
 		 error,
-		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-		 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
-		 "%s: unable to create file header.",
-		 function );
+		 LIBCERROR_ERROR_DOMAIN_IO,
+		 LIBCERROR_IO_ERROR_OPEN_FAILED,
+		 "%s: unable to open backing file: %s.",
+		 function,
+		 backing_file_path );
 
 		goto on_error;
 	}
-	if( libqcow_file_header_read_file_io_handle(
-	     internal_file->file_header,
-	     file_io_handle,
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_grab_for_write(
+	     internal_file->read_write_lock,
 	     error ) != 1 )
 	{
 		libcerror_error_set(
 		 error,
-		 LIBCERROR_ERROR_DOMAIN_IO,
-		 LIBCERROR_IO_ERROR_READ_FAILED,
-		 "%s: unable to read file header.",
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab read/write lock for writing.",
 		 function );
 
 		goto on_error;
 	}
+#endif
+	internal_file->parent_file                    = parent_file;
+	internal_file->parent_file_created_in_library = 1;
 
-	internal_file->encryption_method  = internal_file->file_header->encryption_method;
-
-	number_of_level1_table_references = internal_file->file_header->number_of_level1_table_references;
-
-	if( internal_file->file_header->format_version == 1 )
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_release_for_write(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
 	{
-		if( internal_file->file_header->number_of_cluster_block_bits > 63 )
-		{
-			libcerror_error_set(
-			 error,
-			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-			 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
-			 "%s: invalid number of cluster block bits value out of bounds.",
-			 function );
-
-			goto on_error;
-		}
-		if( internal_file->file_header->number_of_level2_table_bits > 63 )
-		{
-			libcerror_error_set(
-			 error,
-			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-			 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
-			 "%s: invalid number of cluster block bits value out of bounds.",
-			 function );
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release read/write lock for writing.",
+		 function );
 
-			goto on_error;
-		}
-		number_of_level2_table_bits = internal_file->file_header->number_of_level2_table_bits;
+		parent_file = NULL;
 
-		internal_file->offset_bit_mask           = 0x7fffffffffffffffULL;
-		internal_file->compression_flag_bit_mask = (uint64_t) 1UL << 63;
-		internal_file->compression_bit_shift     = 63 - internal_file->file_header->number_of_cluster_block_bits;
+		goto on_error;
 	}
-	else if( internal_file->file_header->format_version == 2 )
-	{
-		if( ( internal_file->file_header->number_of_cluster_block_bits <= 8 )
-		 || ( internal_file->file_header->number_of_cluster_block_bits > 63 ) )
-		{
-			libcerror_error_set(
-			 error,
-			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-			 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
-			 "%s: invalid number of cluster block bits value out of bounds.",
-			 function );
+#endif
+	memory_free(
+	 backing_file_path );
 
-			goto on_error;
-		}
-		number_of_level2_table_bits = internal_file->file_header->number_of_cluster_block_bits - 3;
+	return( 1 );
 
-		internal_file->offset_bit_mask           = 0x3fffffffffffffffULL;
-		internal_file->compression_flag_bit_mask = (uint64_t) 1UL << 62;
-		internal_file->compression_bit_shift     = 62 - ( internal_file->file_header->number_of_cluster_block_bits - 8 );
+on_error:
+	if( parent_file != NULL )
+	{
+		libqcow_file_free(
+		 &parent_file,
+		 NULL );
 	}
-	else if( internal_file->file_header->format_version == 3 )
+	if( backing_file_path != NULL )
 	{
-		if( ( internal_file->file_header->number_of_cluster_block_bits <= 8 )
-		 || ( internal_file->file_header->number_of_cluster_block_bits > 63 ) )
-		{
-			libcerror_error_set(
-			 error,
-			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-			 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
-			 "%s: invalid number of cluster block bits value out of bounds.",
-			 function );
+		memory_free(
+		 backing_file_path );
+	}
+	libqcow_file_close(
+	 file,
+	 NULL );
 
-			goto on_error;
-		}
-		number_of_level2_table_bits = internal_file->file_header->number_of_cluster_block_bits - 3;
+	return( -1 );
+}
 
-		internal_file->offset_bit_mask           = 0x3ffffffffffffffeULL;
-		internal_file->compression_flag_bit_mask = (uint64_t) 1UL << 62;
-		internal_file->compression_bit_shift     = 62 - ( internal_file->file_header->number_of_cluster_block_bits - 8 );
-		internal_file->sparse_flag_bit_mask      = 0x0000000000000001ULL;
-	}
-	internal_file->level1_index_bit_shift = internal_file->file_header->number_of_cluster_block_bits + number_of_level2_table_bits;
+#if defined( HAVE_WIDE_CHARACTER_TYPE )
 
-	if( internal_file->level1_index_bit_shift > 63 )
+/* Retrieves the path of the backing file
+ * A relative backing filename is relative to the directory that contains the file
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_internal_file_get_backing_file_path_wide(
+     libqcow_internal_file_t *internal_file,
+     const wchar_t *filename,
+     wchar_t **backing_file_path,
+     size_t *backing_file_path_size,
+     libcerror_error_t **error )
+{
+	wchar_t *safe_backing_file_path    = NULL;
+	static char *function              = "libqcow_internal_file_get_backing_file_path_wide";
+	size_t backing_filename_length     = 0;
+	size_t backing_filename_size       = 0;
+	size_t directory_length            = 0;
+	size_t safe_backing_file_path_size = 0;
+	int result                         = 0;
+
+	if( internal_file == NULL )
 	{
 		libcerror_error_set(
 		 error,
-		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-		 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
-		 "%s: invalid level1 index bit shift value out of bounds.",
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
 		 function );
 
-		goto on_error;
+		return( -1 );
 	}
-	internal_file->level2_index_bit_mask  = ~( (uint64_t) -1 << number_of_level2_table_bits );
-	internal_file->cluster_block_bit_mask = ~( (uint64_t) -1 << internal_file->file_header->number_of_cluster_block_bits );
-	internal_file->compression_bit_mask   = ~( (uint64_t) -1 << internal_file->compression_bit_shift );
-	internal_file->cluster_block_size     = (size64_t) 1 << internal_file->file_header->number_of_cluster_block_bits;
+	if( internal_file->backing_filename == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid file - missing backing filename.",
+		 function );
 
-	level2_table_size = (size_t) 1 << number_of_level2_table_bits;
+		return( -1 );
+	}
+	if( filename == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid filename.",
+		 function );
 
-	if( internal_file->file_header->format_version == 1 )
+		return( -1 );
+	}
+	if( backing_file_path == NULL )
 	{
-		if( internal_file->cluster_block_size > ( (size64_t) MEMORY_MAXIMUM_ALLOCATION_SIZE / level2_table_size ) )
-		{
-			libcerror_error_set(
-			 error,
-			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-			 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
-			 "%s: invalid cluster block size value out of bounds.",
-			 function );
-
-			goto on_error;
-		}
-		level1_table_size = (size_t) ( internal_file->cluster_block_size * level2_table_size );
-
-		if( ( internal_file->file_header->media_size / level1_table_size ) > ( (size64_t) UINT32_MAX - 1 ) )
-		{
-			libcerror_error_set(
-			 error,
-			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-			 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
-			 "%s: invalid level1 table size value out of bounds: %zd.",
-			 function, level1_table_size );
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid backing file path.",
+		 function );
 
-			goto on_error;
-		}
-		number_of_level1_table_references = (uint32_t) ( internal_file->file_header->media_size / level1_table_size );
+		return( -1 );
+	}
+	if( *backing_file_path != NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_ALREADY_SET,
+		 "%s: invalid backing file path value already set.",
+		 function );
 
-		if( ( internal_file->file_header->media_size % level1_table_size ) != 0 )
-		{
-			number_of_level1_table_references += 1;
-		}
-		level1_table_size = (size_t) number_of_level1_table_references;
+		return( -1 );
 	}
-	else if( ( internal_file->file_header->format_version == 2 )
-	      || ( internal_file->file_header->format_version == 3 ) )
+	if( backing_file_path_size == NULL )
 	{
-		if( internal_file->cluster_block_size > (size64_t) MEMORY_MAXIMUM_ALLOCATION_SIZE )
-		{
-			libcerror_error_set(
-			 error,
-			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-			 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
-			 "%s: invalid cluster block size value out of bounds.",
-			 function );
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid backing file path size.",
+		 function );
 
-			goto on_error;
-		}
-		level1_table_size = (size_t) number_of_level1_table_references;
+		return( -1 );
 	}
-	if( ( level1_table_size == 0 )
-	 || ( level1_table_size > ( (size_t) MEMORY_MAXIMUM_ALLOCATION_SIZE / 8 ) ) )
+	backing_filename_length = internal_file->backing_filename_size;
+
+	while( ( backing_filename_length > 0 )
+	    && ( internal_file->backing_filename[ backing_filename_length - 1 ] == 0 ) )
+	{
+		backing_filename_length--;
+	}
+	if( backing_filename_length == 0 )
 	{
 		libcerror_error_set(
 		 error,
 		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-		 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
-		 "%s: invalid level1 table size value out of bounds.",
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid file - empty backing filename.",
 		 function );
 
-		goto on_error;
+		return( -1 );
 	}
-	if( ( level2_table_size == 0 )
-	 || ( level2_table_size > ( (size_t) MEMORY_MAXIMUM_ALLOCATION_SIZE / 8 ) ) )
+#if SIZEOF_WCHAR_T == 4
+	result = libuna_utf32_string_size_from_utf8_stream(
+	          internal_file->backing_filename,
+	          backing_filename_length,
+	          &backing_filename_size,
+	          error );
+#elif SIZEOF_WCHAR_T == 2
+	result = libuna_utf16_string_size_from_utf8_stream(
+	          internal_file->backing_filename,
+	          backing_filename_length,
+	          &backing_filename_size,
+	          error );
+#else
+#error Unsupported size of wchar_t
+#endif /* SIZEOF_WCHAR_T */
+
+	if( result != 1 )
 	{
 		libcerror_error_set(
 		 error,
 		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-		 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
-		 "%s: invalid level2 table size value out of bounds.",
+		 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+		 "%s: unable to determine wide string size of backing filename.",
 		 function );
 
-		goto on_error;
+		return( -1 );
 	}
-	level1_table_size *= 8;
-	level2_table_size *= 8;
-
-#if defined( HAVE_DEBUG_OUTPUT )
-	if( libcnotify_verbose != 0 )
+#if defined( WINAPI )
+	if( ( internal_file->backing_filename[ 0 ] != (uint8_t) '\\' )
+	 && ( internal_file->backing_filename[ 0 ] != (uint8_t) '/' )
+	 && ( ( backing_filename_length < 2 )
+	  ||  ( internal_file->backing_filename[ 1 ] != (uint8_t) ':' ) ) )
+#else
+	if( internal_file->backing_filename[ 0 ] != (uint8_t) '/' )
+#endif
 	{
-		libcnotify_printf(
-		 "%s: level 1 table size\t\t\t: %" PRIzd "\n",
-		 function,
-		 level1_table_size );
+		directory_length = wide_string_length(
+		                    filename );
 
-		libcnotify_printf(
-		 "%s: level 2 table size\t\t\t: %" PRIzd "\n",
-		 function,
-		 level2_table_size );
+		while( directory_length > 0 )
+		{
+#if defined( WINAPI )
+			if( ( filename[ directory_length - 1 ] == (wchar_t) '\\' )
+			 || ( filename[ directory_length - 1 ] == (wchar_t) '/' ) )
+#else
+			if( filename[ directory_length - 1 ] == (wchar_t) '/' )
+#endif
+			{
+				break;
+			}
+			directory_length--;
+		}
+	}
+	safe_backing_file_path_size = directory_length + backing_filename_size;
 
-		libcnotify_printf(
-		 "%s: cluster block size\t\t\t: %" PRIu64 "\n",
-		 function,
-		 internal_file->cluster_block_size );
+	if( safe_backing_file_path_size > (size_t) ( MEMORY_MAXIMUM_ALLOCATION_SIZE / sizeof( wchar_t ) ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_EXCEEDS_MAXIMUM,
+		 "%s: invalid backing file path size value exceeds maximum.",
+		 function );
 
-		libcnotify_printf(
-		 "\n" );
+		return( -1 );
 	}
-#endif /* defined( HAVE_DEBUG_OUTPUT ) */
+	safe_backing_file_path = wide_string_allocate(
+	                          safe_backing_file_path_size );
 
-	if( ( internal_file->file_header->backing_filename_offset > 0 )
-	 && ( internal_file->file_header->backing_filename_size > 0 ) )
+	if( safe_backing_file_path == NULL )
 	{
-		if( libqcow_internal_file_open_read_backing_filename(
-		     internal_file,
-		     file_io_handle,
-		     internal_file->file_header->backing_filename_offset,
-		     internal_file->file_header->backing_filename_size,
-		     error ) != 1 )
-		{
-			libcerror_error_set(
-			 error,
-			 LIBCERROR_ERROR_DOMAIN_IO,
-			 LIBCERROR_IO_ERROR_READ_FAILED,
-			 "%s: unable to read backing filename.",
-			 function );
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_INSUFFICIENT,
+		 "%s: unable to create backing file path.",
+		 function );
 
-			goto on_error;
-		}
+		goto on_error;
 	}
-	if( internal_file->encryption_method != LIBQCOW_ENCRYPTION_METHOD_NONE )
+	if( directory_length > 0 )
 	{
-		if( libqcow_encryption_initialize(
-		     &( internal_file->encryption_context ),
-		     internal_file->encryption_method,
-		     error ) != 1 )
-		{
-			libcerror_error_set(
-			 error,
-			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-			 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
-			 "%s: unable to create encryption context.",
-			 function );
-
-			goto on_error;
-		}
-#if defined( HAVE_DEBUG_OUTPUT )
-		if( libcnotify_verbose != 0 )
-		{
-			libcnotify_printf(
-			 "%s: key:\n",
-			 function );
-			libcnotify_print_data(
-			 internal_file->key_data,
-			 16,
-			 0 );
-		}
-#endif
-		if( libqcow_encryption_set_keys(
-		     internal_file->encryption_context,
-		     internal_file->key_data,
-		     16,
-		     error ) != 1 )
+		if( memory_copy(
+		     safe_backing_file_path,
+		     filename,
+		     sizeof( wchar_t ) * directory_length ) == NULL )
 		{
 			libcerror_error_set(
 			 error,
-			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-			 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
-			 "%s: unable to set key data in encryption context.",
+			 LIBCERROR_ERROR_DOMAIN_MEMORY,
+			 LIBCERROR_MEMORY_ERROR_COPY_FAILED,
+			 "%s: unable to copy directory to backing file path.",
 			 function );
 
 			goto on_error;
 		}
 	}
-#if defined( HAVE_DEBUG_OUTPUT )
-	if( libcnotify_verbose != 0 )
-	{
-		libcnotify_printf(
-		 "Reading level 1 table:\n" );
-	}
-#endif
-	if( libqcow_cluster_table_initialize(
-	     &( internal_file->level1_table ),
-	     error ) != 1 )
+#if SIZEOF_WCHAR_T == 4
+	result = libuna_utf32_string_copy_from_utf8_stream(
+	          (libuna_utf32_character_t *) &( safe_backing_file_path[ directory_length ] ),
+	          backing_filename_size,
+	          internal_file->backing_filename,
+	          backing_filename_length,
+	          error );
+#elif SIZEOF_WCHAR_T == 2
+	result = libuna_utf16_string_copy_from_utf8_stream(
+	          (libuna_utf16_character_t *) &( safe_backing_file_path[ directory_length ] ),
+	          backing_filename_size,
+	          internal_file->backing_filename,
+	          backing_filename_length,
+	          error );
+#endif /* SIZEOF_WCHAR_T */
+
+	if( result != 1 )
 	{
 		libcerror_error_set(
 		 error,
 		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-		 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
-		 "%s: unable to create level 1 table.",
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to copy backing filename to backing file path.",
 		 function );
 
 		goto on_error;
 	}
-	if( libqcow_cluster_table_read(
-	     internal_file->level1_table,
-	     file_io_handle,
-	     internal_file->file_header->level1_table_offset,
-	     level1_table_size,
-	     error ) != 1 )
+	*backing_file_path      = safe_backing_file_path;
+	*backing_file_path_size = safe_backing_file_path_size;
+
+	return( 1 );
+
+on_error:
+	if( safe_backing_file_path != NULL )
+	{
+		memory_free(
+		 safe_backing_file_path );
+	}
+	return( -1 );
+}
+
+/* Opens a file and, recursively, the files of its backing chain
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_internal_file_open_backing_chain_wide(
+     libqcow_file_t *file,
+     const wchar_t *filename,
+     int access_flags,
+     int chain_depth,
+     libcerror_error_t **error )
+{
+	libqcow_file_t *parent_file            = NULL;
+	libqcow_internal_file_t *internal_file = NULL;
+	wchar_t *backing_file_path             = NULL;
+	static char *function                  = "libqcow_internal_file_open_backing_chain_wide";
+	size_t backing_file_path_size          = 0;
+
+	if( file == NULL )
 	{
 		libcerror_error_set(
 		 error,
-		 LIBCERROR_ERROR_DOMAIN_IO,
-		 LIBCERROR_IO_ERROR_READ_FAILED,
-		 "%s: unable to read level 1 table.",
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
 		 function );
 
-		goto on_error;
+		return( -1 );
 	}
-/* TODO clone function ? */
-	if( libfdata_vector_initialize(
-	     &( internal_file->level2_table_vector ),
-	     (size64_t) level2_table_size,
-	     (intptr_t *) internal_file->io_handle,
-	     NULL,
-	     NULL,
-	     (int (*)(intptr_t *, intptr_t *, libfdata_vector_t *, libfdata_cache_t *, int, int, off64_t, size64_t, uint32_t, uint8_t, libcerror_error_t **)) &libqcow_io_handle_read_level2_table,
-	     NULL,
-	     LIBFDATA_DATA_HANDLE_FLAG_NON_MANAGED,
-	     error ) != 1 )
+	internal_file = (libqcow_internal_file_t *) file;
+
+	if( ( chain_depth < 0 )
+	 || ( chain_depth > LIBQCOW_MAXIMUM_BACKING_CHAIN_DEPTH ) )
 	{
 		libcerror_error_set(
 		 error,
-		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-		 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
-		 "%s: unable to create level2 table vector.",
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid chain depth value out of bounds.",
 		 function );
 
-		goto on_error;
+		return( -1 );
 	}
-	if( libfdata_vector_append_segment(
-	     internal_file->level2_table_vector,
-	     &entry_index,
-	     0,
-	     0,
-	     internal_file->size,
-	     0,
+	if( libqcow_file_open_wide(
+	     file,
+	     filename,
+	     access_flags,
 	     error ) != 1 )
 	{
 		libcerror_error_set(
 		 error,
-		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-		 LIBCERROR_RUNTIME_ERROR_APPEND_FAILED,
-		 "%s: unable to append segment to level2 table vector.",
+		 LIBCERROR_ERROR_DOMAIN_IO,
+		 LIBCERROR_IO_ERROR_OPEN_FAILED,
+		 "%s: unable to open file.",
 		 function );
 
-		goto on_error;
+		return( -1 );
 	}
-	if( libfcache_cache_initialize(
-	     &( internal_file->level2_table_cache ),
-	     LIBQCOW_MAXIMUM_CACHE_ENTRIES_LEVEL2_TABLES,
-	     error ) != 1 )
+	if( internal_file->backing_filename == NULL )
+	{
+		return( 1 );
+	}
+	if( chain_depth >= LIBQCOW_MAXIMUM_BACKING_CHAIN_DEPTH )
 	{
 		libcerror_error_set(
 		 error,
 		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-		 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
-		 "%s: unable to create level2 table cache.",
+		 LIBCERROR_RUNTIME_ERROR_VALUE_EXCEEDS_MAXIMUM,
+		 "%s: invalid backing chain depth value exceeds maximum.",
 		 function );
 
 		goto on_error;
 	}
-/* TODO clone function ? */
-	if( libfdata_vector_initialize(
-	     &( internal_file->cluster_block_vector ),
-	     internal_file->cluster_block_size,
-	     (intptr_t *) internal_file->io_handle,
-	     NULL,
-	     NULL,
-	     (int (*)(intptr_t *, intptr_t *, libfdata_vector_t *, libfdata_cache_t *, int, int, off64_t, size64_t, uint32_t, uint8_t, libcerror_error_t **)) &libqcow_io_handle_read_cluster_block,
-	     NULL,
-	     LIBFDATA_DATA_HANDLE_FLAG_NON_MANAGED,
+	if( libqcow_internal_file_get_backing_file_path_wide(
+	     internal_file,
+	     filename,
+	     &backing_file_path,
+	     &backing_file_path_size,
 	     error ) != 1 )
 	{
 		libcerror_error_set(
 		 error,
 		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-		 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
-		 "%s: unable to create cluster block vector.",
+		 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+		 "%s: unable to retrieve backing file path.",
 		 function );
 
 		goto on_error;
 	}
-	if( libfdata_vector_append_segment(
-	     internal_file->cluster_block_vector,
-	     &entry_index,
-	     0,
-	     0,
-	     internal_file->size,
-	     0,
+	if( libqcow_file_initialize(
+	     &parent_file,
 	     error ) != 1 )
 	{
 		libcerror_error_set(
 		 error,
 		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-		 LIBCERROR_RUNTIME_ERROR_APPEND_FAILED,
-		 "%s: unable to append segment to cluster block vector.",
+		 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+		 "%s: unable to create parent file.",
 		 function );
 
 		goto on_error;
 	}
-	if( libfcache_cache_initialize(
-	     &( internal_file->cluster_block_cache ),
-	     LIBQCOW_MAXIMUM_CACHE_ENTRIES_CLUSTER_BLOCKS,
+	if( libqcow_internal_file_open_backing_chain_wide(
+	     parent_file,
+	     backing_file_path,
+	     access_flags,
+	     chain_depth + 1,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_IO,
+		 LIBCERROR_IO_ERROR_OPEN_FAILED,
+		 "%s: unable to open backing file: %ls.",
+		 function,
+		 backing_file_path );
+
+		goto on_error;
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_grab_for_write(
+	     internal_file->read_write_lock,
 	     error ) != 1 )
 	{
 		libcerror_error_set(
 		 error,
 		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-		 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
-		 "%s: unable to create cluster block cache.",
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab read/write lock for writing.",
 		 function );
 
 		goto on_error;
 	}
-	if( libfcache_cache_initialize(
-	     &( internal_file->compressed_cluster_block_cache ),
-	     LIBQCOW_MAXIMUM_CACHE_ENTRIES_CLUSTER_BLOCKS,
+#endif
+	internal_file->parent_file                    = parent_file;
+	internal_file->parent_file_created_in_library = 1;
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_release_for_write(
+	     internal_file->read_write_lock,
 	     error ) != 1 )
 	{
 		libcerror_error_set(
 		 error,
 		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-		 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
-		 "%s: unable to create compressed cluster block cache.",
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release read/write lock for writing.",
 		 function );
 
+		parent_file = NULL;
+
 		goto on_error;
 	}
-	internal_file->is_locked = 0;
+#endif
+	memory_free(
+	 backing_file_path );
 
 	return( 1 );
 
 on_error:
-	if( internal_file->cluster_block_cache != NULL )
-	{
-		libfcache_cache_free(
-		 &( internal_file->cluster_block_cache ),
-		 NULL );
-	}
-	if( internal_file->cluster_block_vector != NULL )
-	{
-		libfdata_vector_free(
-		 &( internal_file->cluster_block_vector ),
-		 NULL );
-	}
-	if( internal_file->level2_table_cache != NULL )
-	{
-		libfcache_cache_free(
-		 &( internal_file->level2_table_cache ),
-		 NULL );
-	}
-	if( internal_file->level2_table_vector != NULL )
-	{
-		libfdata_vector_free(
-		 &( internal_file->level2_table_vector ),
-		 NULL );
-	}
-	if( internal_file->level1_table != NULL )
+	if( parent_file != NULL )
 	{
-		libqcow_cluster_table_free(
-		 &( internal_file->level1_table ),
-		 NULL );
-	}
-	if( internal_file->encryption_context != NULL )
-	{
-		libqcow_encryption_free(
-		 &( internal_file->encryption_context ),
+		libqcow_file_free(
+		 &parent_file,
 		 NULL );
 	}
-	if( internal_file->backing_filename != NULL )
+	if( backing_file_path != NULL )
 	{
 		memory_free(
-		 internal_file->backing_filename );
-
-		internal_file->backing_filename = NULL;
+		 backing_file_path );
 	}
-	internal_file->backing_filename_size = 0;
+	libqcow_file_close(
+	 file,
+	 NULL );
 
-	if( internal_file->file_header != NULL )
-	{
-		libqcow_file_header_free(
-		 &( internal_file->file_header ),
-		 NULL );
-	}
 	return( -1 );
 }
 
-/* Reads the backing filename
+#endif /* defined( HAVE_WIDE_CHARACTER_TYPE ) */
+
+/* Resizes the level 2 table and cluster block caches
+ * This function is not multi-thread safe acquire write lock before call
  * Returns 1 if successful or -1 on error
  */
-int libqcow_internal_file_open_read_backing_filename(
+int libqcow_internal_file_resize_caches(
      libqcow_internal_file_t *internal_file,
-     libbfio_handle_t *file_io_handle,
-     off64_t backing_filename_offset,
-     uint32_t backing_filename_size,
+     int maximum_level2_table_cache_entries,
+     int maximum_cluster_block_cache_entries,
      libcerror_error_t **error )
 {
-	static char *function = "libqcow_internal_file_open_read_backing_filename";
-	ssize_t read_count    = 0;
+	static char *function = "libqcow_internal_file_resize_caches";
 
 	if( internal_file == NULL )
 	{
@@ -1744,114 +1906,118 @@ int libqcow_internal_file_open_read_backing_filename(
 
 		return( -1 );
 	}
-	if( internal_file->backing_filename != NULL )
+	if( ( internal_file->level2_table_cache == NULL )
+	 || ( internal_file->cluster_block_cache == NULL )
+	 || ( internal_file->compressed_cluster_block_cache == NULL ) )
 	{
 		libcerror_error_set(
 		 error,
 		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-		 LIBCERROR_RUNTIME_ERROR_VALUE_ALREADY_SET,
-		 "%s: invalid file - backing filename value already set.",
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid file - missing caches.",
 		 function );
 
 		return( -1 );
 	}
-	if( ( backing_filename_size == 0 )
-	 || ( backing_filename_size > MEMORY_MAXIMUM_ALLOCATION_SIZE ) )
+	if( maximum_level2_table_cache_entries <= 0 )
 	{
 		libcerror_error_set(
 		 error,
 		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
-		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
-		 "%s: invalid backing filename size value out of bounds.",
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_ZERO_OR_LESS,
+		 "%s: invalid maximum level 2 table cache entries value zero or less.",
 		 function );
 
-		goto on_error;
+		return( -1 );
 	}
-	internal_file->backing_filename = (uint8_t *) memory_allocate(
-	                                               sizeof( uint8_t ) * backing_filename_size );
-
-	if( internal_file->backing_filename == NULL )
+	if( maximum_cluster_block_cache_entries <= 0 )
 	{
 		libcerror_error_set(
 		 error,
-		 LIBCERROR_ERROR_DOMAIN_MEMORY,
-		 LIBCERROR_MEMORY_ERROR_INSUFFICIENT,
-		 "%s: unable to create backing filename.",
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_ZERO_OR_LESS,
+		 "%s: invalid maximum cluster block cache entries value zero or less.",
 		 function );
 
-		goto on_error;
-	}
-	internal_file->backing_filename_size = (size_t) backing_filename_size;
-
-#if defined( HAVE_DEBUG_OUTPUT )
-	if( libcnotify_verbose != 0 )
-	{
-		libcnotify_printf(
-		 "%s: reading backing filename at offset: %" PRIu64 " (0x%08" PRIx64 ")\n",
-		 function,
-		 backing_filename_offset,
-		 backing_filename_offset );
+		return( -1 );
 	}
-#endif
-	read_count = libbfio_handle_read_buffer_at_offset(
-		      file_io_handle,
-		      internal_file->backing_filename,
-		      (size_t) backing_filename_size,
-		      backing_filename_offset,
-		      error );
-
-	if( read_count != (ssize_t) backing_filename_size )
+	if( maximum_level2_table_cache_entries != internal_file->maximum_level2_table_cache_entries )
 	{
-		libcerror_error_set(
-		 error,
-		 LIBCERROR_ERROR_DOMAIN_IO,
-		 LIBCERROR_IO_ERROR_READ_FAILED,
-		 "%s: unable to read backing filename data at offset: %" PRIu64 " (0x%08" PRIx64 ").",
-		 function,
-		 backing_filename_offset,
-		 backing_filename_offset );
+		if( libfcache_cache_resize(
+		     internal_file->level2_table_cache,
+		     maximum_level2_table_cache_entries,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_RESIZE_FAILED,
+			 "%s: unable to resize level2 table cache.",
+			 function );
 
-		goto on_error;
+			return( -1 );
+		}
+		internal_file->maximum_level2_table_cache_entries = maximum_level2_table_cache_entries;
 	}
-#if defined( HAVE_DEBUG_OUTPUT )
-	if( libcnotify_verbose != 0 )
+	if( maximum_cluster_block_cache_entries != internal_file->maximum_cluster_block_cache_entries )
 	{
-		libcnotify_printf(
-		 "%s: backing filename data:\n",
-		 function );
-		libcnotify_print_data(
-		 internal_file->backing_filename,
-		 (size_t) backing_filename_size,
-		 0 );
-	}
-#endif
-	return( 1 );
+		if( libfcache_cache_resize(
+		     internal_file->cluster_block_cache,
+		     maximum_cluster_block_cache_entries,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_RESIZE_FAILED,
+			 "%s: unable to resize cluster block cache.",
+			 function );
 
-on_error:
-	if( internal_file->backing_filename != NULL )
-	{
-		memory_free(
-		 internal_file->backing_filename );
+			return( -1 );
+		}
+		if( libfcache_cache_resize(
+		     internal_file->compressed_cluster_block_cache,
+		     maximum_cluster_block_cache_entries,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_RESIZE_FAILED,
+			 "%s: unable to resize compressed cluster block cache.",
+			 function );
 
-		internal_file->backing_filename = NULL;
+			return( -1 );
+		}
+		internal_file->maximum_cluster_block_cache_entries = maximum_cluster_block_cache_entries;
 	}
-	internal_file->backing_filename_size = 0;
-
-	return( -1 );
+	return( 1 );
 }
 
-/* Determines if the file is locked
- * Returns 1 if locked, 0 if not or -1 on error
+/* Apportions the cache entries across the files of the backing chain that were opened in the library
+ * Every file receives a share of the cache entries of a single file proportional to the number
+ * of cluster blocks read from it, but at least the minimum number of cache entries
+ * This function is not multi-thread safe acquire write lock before call
+ * Returns 1 if successful or -1 on error
  */
-int libqcow_file_is_locked(
-     libqcow_file_t *file,
+int libqcow_internal_file_apportion_cache_budget(
+     libqcow_internal_file_t *internal_file,
      libcerror_error_t **error )
 {
-	libqcow_internal_file_t *internal_file = NULL;
-	static char *function                  = "libqcow_file_is_locked";
-	uint8_t is_locked                      = 0;
+	libqcow_internal_file_t *layer_files[ LIBQCOW_MAXIMUM_BACKING_CHAIN_DEPTH + 1 ];
+	uint64_t number_of_cluster_block_reads[ LIBQCOW_MAXIMUM_BACKING_CHAIN_DEPTH + 1 ];
+
+	libqcow_internal_file_t *layer_file        = NULL;
+	libqcow_internal_file_t *parent_layer_file = NULL;
+	static char *function                      = "libqcow_internal_file_apportion_cache_budget";
+	uint64_t total_number_of_reads             = 0;
+	int layer_index                            = 0;
+	int maximum_cluster_block_cache_entries    = 0;
+	int maximum_level2_table_cache_entries     = 0;
+	int number_of_layers                       = 0;
+	int result                                 = 1;
 
-	if( file == NULL )
+	if( internal_file == NULL )
 	{
 		libcerror_error_set(
 		 error,
@@ -1862,65 +2028,175 @@ int libqcow_file_is_locked(
 
 		return( -1 );
 	}
-	internal_file = (libqcow_internal_file_t *) file;
+	layer_file = internal_file;
 
-#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
-	if( libcthreads_read_write_lock_grab_for_read(
-	     internal_file->read_write_lock,
-	     error ) != 1 )
+	while( layer_file != NULL )
 	{
-		libcerror_error_set(
-		 error,
-		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
-		 "%s: unable to grab read/write lock for reading.",
-		 function );
-
-		return( -1 );
-	}
-#endif
-	is_locked = internal_file->is_locked;
+		if( number_of_layers > LIBQCOW_MAXIMUM_BACKING_CHAIN_DEPTH )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_VALUE_EXCEEDS_MAXIMUM,
+			 "%s: invalid backing chain depth value exceeds maximum.",
+			 function );
 
-#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
-	if( libcthreads_read_write_lock_release_for_read(
-	     internal_file->read_write_lock,
-	     error ) != 1 )
-	{
-		libcerror_error_set(
-		 error,
-		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
-		 "%s: unable to release read/write lock for reading.",
-		 function );
+			return( -1 );
+		}
+		if( layer_file != internal_file )
+		{
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+			if( libcthreads_read_write_lock_grab_for_read(
+			     layer_file->read_write_lock,
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+				 "%s: unable to grab read/write lock for reading.",
+				 function );
 
-		return( -1 );
+				return( -1 );
+			}
+#endif
+		}
+		layer_files[ number_of_layers ]                   = layer_file;
+		number_of_cluster_block_reads[ number_of_layers ] = layer_file->number_of_cluster_block_reads;
+
+		total_number_of_reads += layer_file->number_of_cluster_block_reads + 1;
+
+		number_of_layers++;
+
+		parent_layer_file = NULL;
+
+		if( layer_file->parent_file_created_in_library != 0 )
+		{
+			parent_layer_file = (libqcow_internal_file_t *) layer_file->parent_file;
+		}
+		if( layer_file != internal_file )
+		{
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+			if( libcthreads_read_write_lock_release_for_read(
+			     layer_file->read_write_lock,
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+				 "%s: unable to release read/write lock for reading.",
+				 function );
+
+				return( -1 );
+			}
+#endif
+		}
+		layer_file = parent_layer_file;
 	}
+	for( layer_index = 0;
+	     layer_index < number_of_layers;
+	     layer_index++ )
+	{
+		layer_file = layer_files[ layer_index ];
+
+		maximum_level2_table_cache_entries = (int) ( ( (uint64_t) LIBQCOW_MAXIMUM_CACHE_ENTRIES_LEVEL2_TABLES * ( number_of_cluster_block_reads[ layer_index ] + 1 ) ) / total_number_of_reads );
+
+		if( maximum_level2_table_cache_entries < LIBQCOW_MINIMUM_CACHE_ENTRIES_LEVEL2_TABLES )
+		{
+			maximum_level2_table_cache_entries = LIBQCOW_MINIMUM_CACHE_ENTRIES_LEVEL2_TABLES;
+		}
+		maximum_cluster_block_cache_entries = (int) ( ( (uint64_t) LIBQCOW_MAXIMUM_CACHE_ENTRIES_CLUSTER_BLOCKS * ( number_of_cluster_block_reads[ layer_index ] + 1 ) ) / total_number_of_reads );
+
+		if( maximum_cluster_block_cache_entries < LIBQCOW_MINIMUM_CACHE_ENTRIES_CLUSTER_BLOCKS )
+		{
+			maximum_cluster_block_cache_entries = LIBQCOW_MINIMUM_CACHE_ENTRIES_CLUSTER_BLOCKS;
+		}
+		if( layer_file != internal_file )
+		{
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+			if( libcthreads_read_write_lock_grab_for_write(
+			     layer_file->read_write_lock,
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+				 "%s: unable to grab read/write lock for writing.",
+				 function );
+
+				return( -1 );
+			}
 #endif
-	return( is_locked );
+		}
+		if( libqcow_internal_file_resize_caches(
+		     layer_file,
+		     maximum_level2_table_cache_entries,
+		     maximum_cluster_block_cache_entries,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_RESIZE_FAILED,
+			 "%s: unable to resize caches of file: %d in backing chain.",
+			 function,
+			 layer_index );
+
+			result = -1;
+		}
+		/* Older reads count less towards the next apportioning
+		 */
+		layer_file->number_of_cluster_block_reads /= 2;
+
+		if( layer_file != internal_file )
+		{
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+			if( libcthreads_read_write_lock_release_for_write(
+			     layer_file->read_write_lock,
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+				 "%s: unable to release read/write lock for writing.",
+				 function );
+
+				return( -1 );
+			}
+#endif
+		}
+		if( result != 1 )
+		{
+			return( -1 );
+		}
+	}
+	internal_file->number_of_reads_since_cache_budget_update = 0;
+
+	return( 1 );
 }
 
-/* Retrieves the cluster block offset for a specific offset
+/* Opens a file using a Basic File IO (bfio) handle
+ * The file IO handle is only cloned to read concurrently when the access flags
+ * contain LIBQCOW_OPEN_FLAG_CLONE_FILE_IO_HANDLE
  * Returns 1 if successful or -1 on error
  */
-int libqcow_internal_file_get_cluster_block_offset(
-     libqcow_internal_file_t *internal_file,
+int libqcow_file_open_file_io_handle(
+     libqcow_file_t *file,
      libbfio_handle_t *file_io_handle,
-     off64_t offset,
-     uint64_t *cluster_block_offset,
-     uint64_t *cluster_block_data_offset,
-     uint32_t *cluster_block_flags,
+     int access_flags,
      libcerror_error_t **error )
 {
-	libqcow_cluster_table_t *level2_table = NULL;
-	static char *function                 = "libqcow_internal_file_get_cluster_block_offset";
-	off64_t element_data_offset           = 0;
-	uint64_t level1_table_index           = 0;
-	uint64_t level2_table_index           = 0;
-	uint64_t level2_table_offset          = 0;
-	uint64_t safe_cluster_block_offset    = 0;
-	uint32_t safe_cluster_block_flags     = 0;
+	libqcow_internal_file_t *internal_file   = NULL;
+	static char *function                    = "libqcow_file_open_file_io_handle";
+	uint8_t file_io_handle_opened_in_library = 0;
+	int bfio_access_flags                    = 0;
+	int file_io_handle_is_open               = 0;
+	int result                               = 0;
 
-	if( internal_file == NULL )
+	if( file == NULL )
 	{
 		libcerror_error_set(
 		 error,
@@ -1931,265 +2207,167 @@ int libqcow_internal_file_get_cluster_block_offset(
 
 		return( -1 );
 	}
-	if( internal_file->file_header == NULL )
+	internal_file = (libqcow_internal_file_t *) file;
+
+	if( internal_file->file_io_handle != NULL )
 	{
 		libcerror_error_set(
 		 error,
 		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
-		 "%s: invalid file - missing file header.",
+		 LIBCERROR_RUNTIME_ERROR_VALUE_ALREADY_SET,
+		 "%s: invalid file - file IO handle already set.",
 		 function );
 
 		return( -1 );
 	}
-	if( offset < 0 )
+	if( file_io_handle == NULL )
 	{
 		libcerror_error_set(
 		 error,
-		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-		 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
-		 "%s: invalid offset value out of bounds.",
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file IO handle.",
 		 function );
 
 		return( -1 );
 	}
-	if( cluster_block_offset == NULL )
+	if( ( ( access_flags & LIBQCOW_ACCESS_FLAG_READ ) == 0 )
+	 && ( ( access_flags & LIBQCOW_ACCESS_FLAG_WRITE ) == 0 ) )
 	{
 		libcerror_error_set(
 		 error,
 		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
-		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
-		 "%s: invalid cluster block offset.",
+		 LIBCERROR_ARGUMENT_ERROR_UNSUPPORTED_VALUE,
+		 "%s: unsupported access flags.",
 		 function );
 
 		return( -1 );
 	}
-	if( cluster_block_data_offset == NULL )
+	if( ( access_flags & LIBQCOW_ACCESS_FLAG_WRITE ) != 0 )
 	{
 		libcerror_error_set(
 		 error,
 		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
-		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
-		 "%s: invalid cluster block data offset.",
+		 LIBCERROR_ARGUMENT_ERROR_UNSUPPORTED_VALUE,
+		 "%s: write access currently not supported.",
 		 function );
 
 		return( -1 );
 	}
-	if( cluster_block_flags == NULL )
+	if( ( access_flags & LIBQCOW_ACCESS_FLAG_READ ) != 0 )
+	{
+		bfio_access_flags = LIBBFIO_ACCESS_FLAG_READ;
+	}
+	file_io_handle_is_open = libbfio_handle_is_open(
+	                          file_io_handle,
+	                          error );
+
+	if( file_io_handle_is_open == -1 )
 	{
 		libcerror_error_set(
 		 error,
-		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
-		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
-		 "%s: invalid cluster block flags.",
+		 LIBCERROR_ERROR_DOMAIN_IO,
+		 LIBCERROR_IO_ERROR_OPEN_FAILED,
+		 "%s: unable to determine if file IO handle is open.",
 		 function );
 
-		return( -1 );
+		goto on_error;
 	}
-	level1_table_index = offset >> internal_file->level1_index_bit_shift;
-
-#if defined( HAVE_DEBUG_OUTPUT )
-	if( libcnotify_verbose != 0 )
+	else if( file_io_handle_is_open == 0 )
 	{
-		libcnotify_printf(
-		 "%s: level 1 table index\t: %" PRIu64 "\n",
-		 function,
-		 level1_table_index );
+		if( libbfio_handle_open(
+		     file_io_handle,
+		     bfio_access_flags,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_IO,
+			 LIBCERROR_IO_ERROR_OPEN_FAILED,
+			 "%s: unable to open file IO handle.",
+			 function );
+
+			goto on_error;
+		}
+		file_io_handle_opened_in_library = 1;
 	}
-#endif
-	if( level1_table_index > (uint64_t) INT_MAX )
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_grab_for_write(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
 	{
 		libcerror_error_set(
 		 error,
 		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-		 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
-		 "%s: invalid level 1 table index value out of bounds.",
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab read/write lock for writing.",
 		 function );
 
 		return( -1 );
 	}
-	if( libqcow_cluster_table_get_reference_by_index(
-	     internal_file->level1_table,
-	     (int) level1_table_index,
-	     &level2_table_offset,
-	     error ) != 1 )
+#endif
+	internal_file->access_flags = access_flags;
+
+	result = libqcow_internal_file_open_read(
+	          internal_file,
+	          file_io_handle,
+	          error );
+
+	if( result != 1 )
 	{
 		libcerror_error_set(
 		 error,
-		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-		 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
-		 "%s: unable to retrieve level 2 table offset: %" PRIi64 " from level 1 table.",
-		 function,
-		 level1_table_index );
+		 LIBCERROR_ERROR_DOMAIN_IO,
+		 LIBCERROR_IO_ERROR_READ_FAILED,
+		 "%s: unable to read from file IO handle.",
+		 function );
 
-		return( -1 );
+		internal_file->access_flags = 0;
 	}
-#if defined( HAVE_DEBUG_OUTPUT )
-	if( libcnotify_verbose != 0 )
+	else
 	{
-		libcnotify_printf(
-		 "%s: level 2 table offset\t: 0x%08" PRIx64 "\n",
-		 function,
-		 level2_table_offset );
+		internal_file->file_io_handle                   = file_io_handle;
+		internal_file->file_io_handle_opened_in_library = file_io_handle_opened_in_library;
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_release_for_write(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release read/write lock for writing.",
+		 function );
 
-		libcnotify_printf(
-		 "\n" );
+		return( -1 );
 	}
 #endif
-	level2_table_offset &= internal_file->offset_bit_mask;
+	return( result );
 
-	/* If level2_table_offset is 0 the level 2 table is sparse
-	 */
-	if( level2_table_offset > 0 )
+on_error:
+	if( file_io_handle_opened_in_library != 0 )
 	{
-		if( libfdata_vector_get_element_value_at_offset(
-		     internal_file->level2_table_vector,
-		     (intptr_t *) file_io_handle,
-		     (libfdata_cache_t *) internal_file->level2_table_cache,
-		     (off64_t) level2_table_offset,
-		     &element_data_offset,
-		     (intptr_t **) &level2_table,
-		     0,
-		     error ) != 1 )
-		{
-			libcerror_error_set(
-			 error,
-			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-			 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
-			 "%s: unable to retrieve level2 table at offset: 0x%08" PRIx64 ".",
-			 function,
-			 level2_table_offset );
-
-			return( -1 );
-		}
-		level2_table_index = ( internal_file->current_offset >> internal_file->file_header->number_of_cluster_block_bits ) & internal_file->level2_index_bit_mask;
-
-#if defined( HAVE_DEBUG_OUTPUT )
-		if( libcnotify_verbose != 0 )
-		{
-			libcnotify_printf(
-			 "%s: level 2 table index\t: %" PRIu64 "\n",
-			 function,
-			 level2_table_index );
-		}
-#endif
-		if( level2_table_index > (uint64_t) INT_MAX )
-		{
-			libcerror_error_set(
-			 error,
-			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-			 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
-			 "%s: invalid level 2 table index value out of bounds.",
-			 function );
-
-			return( -1 );
-		}
-		if( libqcow_cluster_table_get_reference_by_index(
-		     level2_table,
-		     (int) level2_table_index,
-		     &safe_cluster_block_offset,
-		     error ) != 1 )
-		{
-			libcerror_error_set(
-			 error,
-			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-			 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
-			 "%s: unable to retrieve level 2 table entry: %" PRIu64 ".",
-			 function,
-			 level2_table_index );
-
-			return( -1 );
-		}
-	}
-#if defined( HAVE_DEBUG_OUTPUT )
-	if( libcnotify_verbose != 0 )
-	{
-		libcnotify_printf(
-		 "%s: table2 entry: %" PRIu64 "\t\t: 0x%08" PRIx64 "\n",
-		 function,
-		 level2_table_index,
-		 safe_cluster_block_offset );
-
-		libcnotify_printf(
-		 "%s: cluster block offset\t: %" PRIi64 " (0x%08" PRIx64 ")\n",
-		 function,
-		 safe_cluster_block_offset & internal_file->offset_bit_mask,
-		 safe_cluster_block_offset & internal_file->offset_bit_mask );
-	}
-#endif
-	if( ( safe_cluster_block_offset & internal_file->compression_flag_bit_mask ) != 0 )
-	{
-		if( internal_file->encryption_method != LIBQCOW_ENCRYPTION_METHOD_NONE )
-		{
-			libcerror_error_set(
-			 error,
-			 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
-			 LIBCERROR_ARGUMENT_ERROR_UNSUPPORTED_VALUE,
-			 "%s: simultaneous encryption and compression not supported.",
-			 function );
-
-			return( -1 );
-		}
-#if defined( HAVE_DEBUG_OUTPUT )
-		if( libcnotify_verbose != 0 )
-		{
-			libcnotify_printf(
-			 "%s: is compressed\n",
-			 function );
-		}
-#endif
-		safe_cluster_block_flags |= LIBQCOW_CLUSTER_BLOCK_FLAG_IS_COMPRESSED;
-	}
-	if( ( internal_file->sparse_flag_bit_mask != 0 )
-	 && ( ( safe_cluster_block_offset & internal_file->sparse_flag_bit_mask ) != 0 ) )
-	{
-#if defined( HAVE_DEBUG_OUTPUT )
-		if( libcnotify_verbose != 0 )
-		{
-			libcnotify_printf(
-			 "%s: is sparse\n",
-			 function );
-		}
-#endif
-		safe_cluster_block_flags |= LIBQCOW_CLUSTER_BLOCK_FLAG_IS_SPARSE;
-	}
-#if defined( HAVE_DEBUG_OUTPUT )
-	if( libcnotify_verbose != 0 )
-	{
-		libcnotify_printf(
-		 "\n" );
+		libbfio_handle_close(
+		 file_io_handle,
+		 error );
 	}
-#endif
-	*cluster_block_offset      = safe_cluster_block_offset & internal_file->offset_bit_mask;
-	*cluster_block_data_offset = offset & internal_file->cluster_block_bit_mask;
-	*cluster_block_flags       = safe_cluster_block_flags;
-
-	return( 1 );
+	return( -1 );
 }
 
-/* Reads a cluster block
- * Returns 1 if successful or -1 on error
+/* Closes a file
+ * Returns 0 if successful or -1 on error
  */
-int libqcow_internal_file_read_cluster_block(
-     libqcow_internal_file_t *internal_file,
-     libbfio_handle_t *file_io_handle,
-     uint64_t cluster_block_offset,
-     uint64_t cluster_block_data_offset,
-     uint32_t cluster_block_flags,
-     libqcow_cluster_block_t **cluster_block,
+int libqcow_file_close(
+     libqcow_file_t *file,
      libcerror_error_t **error )
 {
-	libfcache_cache_t *cluster_block_cache       = NULL;
-	libqcow_cluster_block_t *safe_cluster_block  = NULL;
-	static char *function                        = "libqcow_internal_file_read_cluster_block";
-	size_t cluster_block_size                    = 0;
-	size_t safe_cluster_block_data_size          = 0;
-	off64_t element_data_offset                  = 0;
-	uint64_t block_key                           = 0;
-	uint64_t compressed_cluster_block_end_offset = 0;
-	int cache_entry_index                        = 0;
+	libqcow_internal_file_t *internal_file = NULL;
+	static char *function                  = "libqcow_file_close";
+	int result                             = 0;
 
-	if( internal_file == NULL )
+	if( file == NULL )
 	{
 		libcerror_error_set(
 		 error,
@@ -2200,617 +2378,12458 @@ int libqcow_internal_file_read_cluster_block(
 
 		return( -1 );
 	}
-	if( internal_file->file_header == NULL )
+	internal_file = (libqcow_internal_file_t *) file;
+
+	if( internal_file->file_io_handle == NULL )
 	{
 		libcerror_error_set(
 		 error,
 		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
 		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
-		 "%s: invalid file - missing file header.",
+		 "%s: invalid file - missing file IO handle.",
 		 function );
 
 		return( -1 );
 	}
-	if( internal_file->cluster_block_size == 0 )
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_grab_for_write(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
 	{
 		libcerror_error_set(
 		 error,
 		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-		 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
-		 "%s: invalid file - cluster block size value out of bounds.",
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab read/write lock for writing.",
 		 function );
 
 		return( -1 );
 	}
-	if( cluster_block == NULL )
+#endif
+	if( internal_file->number_of_data_pins > 0 )
 	{
 		libcerror_error_set(
 		 error,
-		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
-		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
-		 "%s: invalid cluster block.",
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid file - data pins still in use.",
 		 function );
 
-		return( -1 );
+		goto on_error;
 	}
-	if( ( cluster_block_flags & LIBQCOW_CLUSTER_BLOCK_FLAG_IS_COMPRESSED ) != 0 )
+	if( internal_file->number_of_open_snapshots > 0 )
 	{
-		/* Handle compressed cluster block
-		 */
-		cluster_block_size    = (size_t) ( cluster_block_offset >> internal_file->compression_bit_shift );
-		cluster_block_offset &= internal_file->compression_bit_mask;
-
-		if( ( internal_file->file_header->format_version == 2 )
-		 || ( internal_file->file_header->format_version == 3 ) )
-		{
-			cluster_block_size += 1;
-			cluster_block_size *= 512;
-
-			/* Make sure the compressed block size stays within the bounds
-			 * of the cluster block size and the size of the file
-			 */
-			compressed_cluster_block_end_offset = cluster_block_offset / internal_file->cluster_block_size;
-
-			if( ( cluster_block_offset % internal_file->cluster_block_size ) != 0 )
-			{
-				compressed_cluster_block_end_offset += 1;
-			}
-			compressed_cluster_block_end_offset += 1;
-			compressed_cluster_block_end_offset *= internal_file->cluster_block_size;
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid file - snapshots still in use.",
+		 function );
 
-			if( compressed_cluster_block_end_offset > internal_file->size )
-			{
-				compressed_cluster_block_end_offset = internal_file->size;
-			}
-			if( ( cluster_block_offset + cluster_block_size ) > compressed_cluster_block_end_offset )
-			{
-				cluster_block_size = (size_t) ( compressed_cluster_block_end_offset - cluster_block_offset );
-			}
-		}
-#if defined( HAVE_DEBUG_OUTPUT )
-		if( libcnotify_verbose != 0 )
-		{
-			libcnotify_printf(
-			 "%s: compressed cluster block offset\t\t: 0x%08" PRIx64 "\n",
-			 function,
-			 cluster_block_offset );
+		goto on_error;
+	}
+	if( internal_file->number_of_open_cursors > 0 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid file - cursors still in use.",
+		 function );
 
-			libcnotify_printf(
-			 "%s: compressed cluster block size\t\t: %" PRIzd "\n",
-			 function,
-			 cluster_block_size );
-		}
-#endif
-		cluster_block_cache = internal_file->compressed_cluster_block_cache;
+		goto on_error;
 	}
-	else
+	if( internal_file->number_of_open_read_requests > 0 )
 	{
-		/* For version 2 and 3 make sure the sure the last cluster block size
-		 * stays within the bounds of the size of the file
-		 */
-		if( ( ( internal_file->file_header->format_version == 2 )
-		  ||  ( internal_file->file_header->format_version == 3 ) )
-		 && ( ( cluster_block_offset + internal_file->cluster_block_size ) > internal_file->size ) )
-		{
-			cluster_block_size = (size_t) ( internal_file->size - cluster_block_offset );
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid file - read requests still in use.",
+		 function );
 
-#if defined( HAVE_DEBUG_OUTPUT )
-			if( libcnotify_verbose != 0 )
-			{
-				libcnotify_printf(
-				 "%s: last cluster block offset\t\t: 0x%08" PRIx64 "\n",
-				 function,
-				 cluster_block_offset );
+		goto on_error;
+	}
+	if( internal_file->number_of_concurrent_reads > 0 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid file - concurrent reads still in progress.",
+		 function );
 
-				libcnotify_printf(
-				 "%s: last cluster block size\t\t\t: %" PRIzd "\n",
-				 function,
-				 cluster_block_size );
-			}
-#endif
-		}
-		cluster_block_cache = internal_file->cluster_block_cache;
+		goto on_error;
 	}
-	if( cluster_block_size == 0 )
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	/* Without open read requests the read threads are idle
+	 */
+	if( internal_file->read_thread_pool != NULL )
 	{
-		if( libfdata_vector_get_element_value_at_offset(
-		     internal_file->cluster_block_vector,
-		     (intptr_t *) file_io_handle,
-		     (libfdata_cache_t *) cluster_block_cache,
-		     (off64_t) cluster_block_offset,
-		     &element_data_offset,
-		     (intptr_t **) cluster_block,
-		     0,
+		if( libcthreads_thread_pool_join(
+		     &( internal_file->read_thread_pool ),
 		     error ) != 1 )
 		{
 			libcerror_error_set(
 			 error,
 			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-			 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
-			 "%s: unable to retrieve cluster block at offset: %" PRIi64 " (0x%08" PRIx64 ").",
-			 function,
-			 cluster_block_offset,
-			 cluster_block_offset );
+			 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+			 "%s: unable to join read thread pool.",
+			 function );
 
-			goto on_error;
+			result = -1;
 		}
 	}
-	else
+	if( internal_file->read_scheduler_queue != NULL )
 	{
-/* TODO check cache  */
-		if( libqcow_cluster_block_initialize(
-		     &safe_cluster_block,
-		     cluster_block_size,
+		if( libqcow_scheduler_wait_for_queue(
+		     internal_file->scheduler,
+		     internal_file->read_scheduler_queue,
 		     error ) != 1 )
 		{
 			libcerror_error_set(
 			 error,
 			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-			 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
-			 "%s: unable to create cluster block.",
+			 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+			 "%s: unable to wait for read scheduler queue.",
 			 function );
 
-			goto on_error;
+			result = -1;
 		}
-		if( libqcow_cluster_block_read(
-		     safe_cluster_block,
-		     file_io_handle,
-		     cluster_block_offset,
-		     error ) != 1 )
+		else if( libqcow_scheduler_queue_free(
+		          &( internal_file->read_scheduler_queue ),
+		          error ) != 1 )
 		{
 			libcerror_error_set(
 			 error,
-			 LIBCERROR_ERROR_DOMAIN_IO,
-			 LIBCERROR_IO_ERROR_READ_FAILED,
-			 "%s: unable to read cluster block at offset: %" PRIi64 " (0x%08" PRIx64 ").",
-			 function,
-			 cluster_block_offset,
-			 cluster_block_offset );
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+			 "%s: unable to free read scheduler queue.",
+			 function );
 
-			goto on_error;
+			result = -1;
 		}
-		if( ( cluster_block_flags & LIBQCOW_CLUSTER_BLOCK_FLAG_IS_COMPRESSED ) != 0 )
+	}
+#endif
+	if( internal_file->file_io_pool != NULL )
+	{
+		if( libqcow_file_io_pool_free(
+		     &( internal_file->file_io_pool ),
+		     error ) != 1 )
 		{
-			safe_cluster_block->compressed_data = safe_cluster_block->data;
-
-			safe_cluster_block->data = (uint8_t *) memory_allocate(
-			                                        sizeof( uint8_t ) * internal_file->cluster_block_size );
-
-			if( safe_cluster_block->data == NULL )
-			{
-				libcerror_error_set(
-				 error,
-				 LIBCERROR_ERROR_DOMAIN_MEMORY,
-				 LIBCERROR_MEMORY_ERROR_INSUFFICIENT,
-				 "%s: unable to create cluster block data.",
-				 function );
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+			 "%s: unable to free file IO pool.",
+			 function );
 
-				goto on_error;
-			}
-			safe_cluster_block->data_size = internal_file->cluster_block_size;
-			safe_cluster_block_data_size  = safe_cluster_block->data_size;
+			result = -1;
+		}
+	}
+	internal_file->file_io_handle_cannot_be_cloned = 0;
 
-			if( libqcow_decompress_data(
-			     safe_cluster_block->compressed_data,
-			     cluster_block_size,
-			     LIBQCOW_COMPRESSION_METHOD_DEFLATE,
-			     safe_cluster_block->data,
-			     &safe_cluster_block_data_size,
+#if defined( HAVE_DEBUG_OUTPUT )
+	if( libcnotify_verbose != 0 )
+	{
+		if( internal_file->file_io_handle_created_in_library != 0 )
+		{
+			if( libqcow_debug_print_read_offsets(
+			     internal_file->file_io_handle,
 			     error ) != 1 )
 			{
 				libcerror_error_set(
 				 error,
-				 LIBCERROR_ERROR_DOMAIN_ENCRYPTION,
-				 LIBCERROR_ENCRYPTION_ERROR_GENERIC,
-				 "%s: unable to decompress cluster block data at offset: %" PRIi64 " (0x%08" PRIx64 ").",
-				 function,
-				 cluster_block_offset,
-				 cluster_block_offset );
-
-				goto on_error;
-			}
-/* TODO check safe_cluster_block_data_size
-			if( safe_cluster_block_data_size != safe_cluster_block->data_size )
-			{
-				libcerror_error_set(
-				 error,
-				 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
-				 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
-				 "%s: invalid cluster block size value out of bounds.",
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_PRINT_FAILED,
+				 "%s: unable to print the read offsets.",
 				 function );
 
-				goto on_error;
+				result = -1;
 			}
-*/
 		}
-		cache_entry_index = ( cluster_block_offset & internal_file->cluster_block_bit_mask ) % LIBQCOW_MAXIMUM_CACHE_ENTRIES_CLUSTER_BLOCKS;
-
-		if( libfcache_cache_set_value_by_index(
-		     cluster_block_cache,
-		     cache_entry_index,
-		     0,
-		     cluster_block_offset,
-		     0,
-		     (intptr_t *) safe_cluster_block,
-		     (int (*)(intptr_t **, libcerror_error_t **)) &libqcow_cluster_block_free,
-		     LIBFCACHE_CACHE_VALUE_FLAG_MANAGED,
-		     error ) != 1 )
+	}
+#endif
+	if( internal_file->file_io_handle_opened_in_library != 0 )
+	{
+		if( libbfio_handle_close(
+		     internal_file->file_io_handle,
+		     error ) != 0 )
 		{
 			libcerror_error_set(
 			 error,
-			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-			 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
-			 "%s: unable to set value in cache entry: %d.",
-			 function,
-			 cache_entry_index );
+			 LIBCERROR_ERROR_DOMAIN_IO,
+			 LIBCERROR_IO_ERROR_CLOSE_FAILED,
+			 "%s: unable to close file IO handle.",
+			 function );
 
-			goto on_error;
+			result = -1;
 		}
-		*cluster_block = safe_cluster_block;
-
-		safe_cluster_block = NULL;
+		internal_file->file_io_handle_opened_in_library = 0;
 	}
-	if( internal_file->encryption_method != LIBQCOW_ENCRYPTION_METHOD_NONE )
+	if( internal_file->file_io_handle_created_in_library != 0 )
 	{
-		if( *cluster_block == NULL )
+		if( libbfio_handle_free(
+		     &( internal_file->file_io_handle ),
+		     error ) != 1 )
 		{
 			libcerror_error_set(
 			 error,
 			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-			 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
-			 "%s: missing cluster block.",
+			 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+			 "%s: unable to free file IO handle.",
 			 function );
 
-			goto on_error;
-		}
-		if( ( *cluster_block )->encrypted_data == NULL )
-		{
-			( *cluster_block )->encrypted_data = ( *cluster_block )->data;
-
-			( *cluster_block )->data = (uint8_t *) memory_allocate(
-			                                        sizeof( uint8_t ) * ( *cluster_block )->data_size );
-
-			if( ( *cluster_block )->data == NULL )
-			{
-				libcerror_error_set(
-				 error,
-				 LIBCERROR_ERROR_DOMAIN_MEMORY,
-				 LIBCERROR_MEMORY_ERROR_INSUFFICIENT,
-				 "%s: unable to create cluster block data.",
-				 function );
-
-				goto on_error;
-			}
-			block_key = (uint64_t) ( internal_file->current_offset - cluster_block_data_offset ) / 512;
-
-			if( libqcow_encryption_crypt(
-			     internal_file->encryption_context,
-			     LIBQCOW_ENCYPTION_CRYPT_MODE_DECRYPT,
-			     ( *cluster_block )->encrypted_data,
-			     ( *cluster_block )->data_size,
-			     ( *cluster_block )->data,
-			     ( *cluster_block )->data_size,
-			     block_key,
-			     error ) != 1 )
-			{
-				libcerror_error_set(
-				 error,
-				 LIBCERROR_ERROR_DOMAIN_ENCRYPTION,
-				 LIBCERROR_ENCRYPTION_ERROR_GENERIC,
-				 "%s: unable to decrypt cluster block data.",
-				 function );
-
-				goto on_error;
-			}
+			result = -1;
 		}
+		internal_file->file_io_handle_created_in_library = 0;
 	}
-	return( 1 );
+	internal_file->file_io_handle = NULL;
+	internal_file->access_flags   = 0;
+	internal_file->current_offset = 0;
+	internal_file->is_locked      = 1;
 
-on_error:
-	if( safe_cluster_block != NULL )
+	if( internal_file->data_file_io_handle != NULL )
 	{
-		libqcow_cluster_block_free(
-		 &safe_cluster_block,
-		 NULL );
-	}
-	return( -1 );
-}
+		if( libqcow_internal_file_close_data_file(
+		     internal_file,
+		     error ) != 0 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_IO,
+			 LIBCERROR_IO_ERROR_CLOSE_FAILED,
+			 "%s: unable to close data file.",
+			 function );
 
-/* Reads (media) data from the current offset into a buffer using a Basic File IO (bfio) handle
- * This function is not multi-thread safe acquire write lock before call
- * Returns the number of bytes read or -1 on error
- */
-ssize_t libqcow_internal_file_read_buffer_from_file_io_handle(
-         libqcow_internal_file_t *internal_file,
-         libbfio_handle_t *file_io_handle,
-         void *buffer,
-         size_t buffer_size,
-         libcerror_error_t **error )
-{
-	libqcow_cluster_block_t *cluster_block = NULL;
-	static char *function                  = "libqcow_internal_file_read_buffer_from_file_io_handle";
-	size_t buffer_offset                   = 0;
-	size_t read_size                       = 0;
-	ssize_t read_count                     = 0;
-	uint64_t cluster_block_data_offset     = 0;
-	uint64_t cluster_block_file_offset     = 0;
-	uint32_t cluster_block_flags           = 0;
+			result = -1;
+		}
+	}
+	internal_file->data_file_is_raw = 0;
 
-	if( internal_file == NULL )
+	if( libqcow_io_handle_clear(
+	     internal_file->io_handle,
+	     error ) != 1 )
 	{
 		libcerror_error_set(
 		 error,
-		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
-		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
-		 "%s: invalid file.",
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+		 "%s: unable to clear IO handle.",
 		 function );
 
-		return( -1 );
+		result = -1;
 	}
-	if( internal_file->file_header == NULL )
+	if( libqcow_file_header_free(
+	     &( internal_file->file_header ),
+	     error ) != 1 )
 	{
 		libcerror_error_set(
 		 error,
 		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
-		 "%s: invalid file - missing file header.",
+		 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+		 "%s: unable to free file header.",
 		 function );
 
-		return( -1 );
+		result = -1;
+	}
+	if( internal_file->backing_filename != NULL )
+	{
+		memory_free(
+		 internal_file->backing_filename );
+
+		internal_file->backing_filename      = NULL;
+		internal_file->backing_filename_size = 0;
 	}
-	if( internal_file->current_offset < 0 )
+	if( libqcow_internal_file_free_published_level2_tables(
+	     internal_file,
+	     error ) != 1 )
 	{
 		libcerror_error_set(
 		 error,
 		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-		 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
-		 "%s: invalid file - current offset value out of bounds.",
+		 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+		 "%s: unable to free published level 2 tables.",
 		 function );
 
-		return( -1 );
+		result = -1;
 	}
-	if( internal_file->cluster_block_size == 0 )
+	if( libqcow_cluster_table_free(
+	     &( internal_file->level1_table ),
+	     error ) != 1 )
 	{
 		libcerror_error_set(
 		 error,
 		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-		 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
-		 "%s: invalid file - cluster block size value out of bounds.",
+		 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+		 "%s: unable to free level 1 table.",
 		 function );
 
-		return( -1 );
-	}
-	if( internal_file->backing_filename != NULL )
-	{
-		if( internal_file->parent_file == NULL )
-		{
-			libcerror_error_set(
-			 error,
-			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-			 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
-			 "%s: invalid file - missing parent file.",
-			 function );
-
-			return( -1 );
-		}
+		result = -1;
 	}
-	if( buffer == NULL )
+	if( libqcow_internal_file_free_snapshot_table(
+	     internal_file,
+	     error ) != 1 )
 	{
 		libcerror_error_set(
 		 error,
-		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
-		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
-		 "%s: invalid buffer.",
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+		 "%s: unable to free snapshot table.",
 		 function );
 
-		return( -1 );
+		result = -1;
 	}
-	if( buffer_size > (size_t) SSIZE_MAX )
+	if( libfdata_vector_free(
+	     &( internal_file->level2_table_vector ),
+	     error ) != 1 )
 	{
 		libcerror_error_set(
 		 error,
-		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
-		 LIBCERROR_ARGUMENT_ERROR_VALUE_EXCEEDS_MAXIMUM,
-		 "%s: invalid buffer size value exceeds maximum.",
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+		 "%s: unable to free level2 table vector.",
 		 function );
 
-		return( -1 );
+		result = -1;
 	}
-	internal_file->io_handle->abort = 0;
+	if( libfcache_cache_free(
+	     &( internal_file->level2_table_cache ),
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+		 "%s: unable to free level2 table cache.",
+		 function );
 
-	if( (size64_t) internal_file->current_offset >= internal_file->file_header->media_size )
+		result = -1;
+	}
+	if( libfdata_vector_free(
+	     &( internal_file->cluster_block_vector ),
+	     error ) != 1 )
 	{
-		return( 0 );
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+		 "%s: unable to free cluster block vector.",
+		 function );
+
+		result = -1;
 	}
-	while( buffer_offset < buffer_size )
+	if( libfcache_cache_free(
+	     &( internal_file->cluster_block_cache ),
+	     error ) != 1 )
 	{
-#if defined( HAVE_DEBUG_OUTPUT )
-		if( libcnotify_verbose != 0 )
-		{
-			libcnotify_printf(
-			 "%s: current offset\t: %" PRIi64 " (0x%08" PRIx64 ")\n",
-			 function,
-			 internal_file->current_offset,
-			 internal_file->current_offset );
-		}
-#endif
-		if( libqcow_internal_file_get_cluster_block_offset(
-		     internal_file,
-		     file_io_handle,
-		     internal_file->current_offset,
-		     &cluster_block_file_offset,
-		     &cluster_block_data_offset,
-		     &cluster_block_flags,
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+		 "%s: unable to free cluster block cache.",
+		 function );
+
+		result = -1;
+	}
+	if( libfcache_cache_free(
+	     &( internal_file->compressed_cluster_block_cache ),
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+		 "%s: unable to free compressed cluster block cache.",
+		 function );
+
+		result = -1;
+	}
+	if( internal_file->extent_index != NULL )
+	{
+		if( libqcow_extent_index_free(
+		     &( internal_file->extent_index ),
 		     error ) != 1 )
 		{
 			libcerror_error_set(
 			 error,
 			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-			 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
-			 "%s: unable to retrieve cluster block offset for offset: %" PRIi64 " (0x%08" PRIx64 ").",
-			 function,
-			 internal_file->current_offset,
-			 internal_file->current_offset );
-
-			return( -1 );
-		}
-		read_size = internal_file->cluster_block_size - (size_t) cluster_block_data_offset;
+			 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+			 "%s: unable to free extent index.",
+			 function );
 
-		if( (size64_t) read_size > ( internal_file->file_header->media_size - internal_file->current_offset ) )
-		{
-			read_size = (size_t) ( internal_file->file_header->media_size - internal_file->current_offset );
+			result = -1;
 		}
-		if( read_size > ( buffer_size - buffer_offset ) )
+	}
+	if( internal_file->chain_index != NULL )
+	{
+		if( libqcow_chain_index_free(
+		     &( internal_file->chain_index ),
+		     error ) != 1 )
 		{
-			read_size = buffer_size - buffer_offset;
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+			 "%s: unable to free chain index.",
+			 function );
+
+			result = -1;
 		}
-		if( ( cluster_block_file_offset > 0 )
-		 && ( ( cluster_block_flags & LIBQCOW_CLUSTER_BLOCK_FLAG_IS_SPARSE ) == 0 ) )
+	}
+	if( internal_file->parent_file_created_in_library != 0 )
+	{
+		if( libqcow_file_free(
+		     &( internal_file->parent_file ),
+		     error ) != 1 )
 		{
-			if( libqcow_internal_file_read_cluster_block(
-			     internal_file,
-			     file_io_handle,
-			     cluster_block_file_offset,
-			     cluster_block_data_offset,
-			     cluster_block_flags,
-			     &cluster_block,
-			     error ) != 1 )
-			{
-				libcerror_error_set(
-				 error,
-				 LIBCERROR_ERROR_DOMAIN_IO,
-				 LIBCERROR_IO_ERROR_READ_FAILED,
-				 "%s: unable to read cluster block.",
-				 function );
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+			 "%s: unable to free parent file.",
+			 function );
 
-				return( -1 );
-			}
-			if( cluster_block == NULL )
-			{
-				libcerror_error_set(
-				 error,
-				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-				 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
-				 "%s: invalid cluster block.",
-				 function );
+			result = -1;
+		}
+		internal_file->parent_file_created_in_library = 0;
+	}
+	internal_file->maximum_level2_table_cache_entries        = 0;
+	internal_file->maximum_cluster_block_cache_entries       = 0;
+	internal_file->number_of_cluster_block_reads             = 0;
+	internal_file->number_of_reads_since_cache_budget_update = 0;
 
-				return( -1 );
-			}
-			if( cluster_block->data == NULL )
-			{
-				libcerror_error_set(
-				 error,
-				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-				 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
-				 "%s: invalid cluster block - missing data.",
-				 function );
+	if( internal_file->mapping_index != NULL )
+	{
+		if( libqcow_mapping_index_free(
+		     &( internal_file->mapping_index ),
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+			 "%s: unable to free mapping index.",
+			 function );
 
-				return( -1 );
-			}
-			if( cluster_block_data_offset > cluster_block->data_size )
-			{
-				libcerror_error_set(
-				 error,
-				 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
-				 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
-				 "%s: invalid cluster block data offset value out of bounds.",
-				 function );
+			result = -1;
+		}
+	}
+	if( internal_file->mapping_index_filename != NULL )
+	{
+		memory_free(
+		 internal_file->mapping_index_filename );
 
-				return( -1 );
-			}
-			if( read_size > ( cluster_block->data_size - cluster_block_data_offset ) )
-			{
-				read_size = cluster_block->data_size - cluster_block_data_offset;
-			}
-			if( read_size == 0 )
-			{
-				break;
-			}
-			if( memory_copy(
-			     &( ( (uint8_t *) buffer )[ buffer_offset ] ),
-			     &( cluster_block->data[ cluster_block_data_offset ] ),
-			     read_size ) == NULL )
-			{
-				libcerror_error_set(
-				 error,
-				 LIBCERROR_ERROR_DOMAIN_MEMORY,
-				 LIBCERROR_MEMORY_ERROR_COPY_FAILED,
-				 "%s: unable to copy cluster block data to buffer.",
-				 function );
+		internal_file->mapping_index_filename = NULL;
+	}
+	if( internal_file->mapped_file != NULL )
+	{
+		if( libqcow_mapped_file_free(
+		     &( internal_file->mapped_file ),
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+			 "%s: unable to free mapped file.",
+			 function );
 
-				return( -1 );
-			}
+			result = -1;
 		}
-		else if( internal_file->parent_file != NULL )
+	}
+	if( internal_file->cache_pool_cluster_block != NULL )
+	{
+		if( libqcow_cache_pool_unpin_cluster_block(
+		     internal_file->cache_pool,
+		     &( internal_file->cache_pool_cluster_block ),
+		     error ) != 1 )
 		{
-			read_count = libqcow_file_read_buffer_at_offset(
-				      internal_file->parent_file,
-				      &( ( (uint8_t *) buffer )[ buffer_offset ] ),
-				      read_size,
-				      internal_file->current_offset,
-				      error );
-
-			if( read_count != (ssize_t) read_size )
-			{
-				libcerror_error_set(
-				 error,
-				 LIBCERROR_ERROR_DOMAIN_IO,
-				 LIBCERROR_IO_ERROR_READ_FAILED,
-				 "%s: unable to read buffer from parent file.",
-				 function );
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+			 "%s: unable to unpin cache pool cluster block.",
+			 function );
 
-				return( -1 );
-			}
+			result = -1;
 		}
-		else
+		internal_file->cache_pool_cluster_block = NULL;
+	}
+	if( internal_file->cache_pool_created_in_library != 0 )
+	{
+		if( libqcow_cache_pool_free(
+		     &( internal_file->cache_pool ),
+		     error ) != 1 )
 		{
-			/* Handle sparse cluster block
-			 */
-			if( memory_set(
-			     &( ( (uint8_t *) buffer )[ buffer_offset ] ),
-			     0,
-			     read_size ) == NULL )
-			{
-				libcerror_error_set(
-				 error,
-				 LIBCERROR_ERROR_DOMAIN_MEMORY,
-				 LIBCERROR_MEMORY_ERROR_SET_FAILED,
-				 "%s: unable to set sparse data in buffer.",
-				 function );
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+			 "%s: unable to free cache pool.",
+			 function );
 
-				return( -1 );
-			}
+			result = -1;
 		}
-		internal_file->current_offset += read_size;
-		buffer_offset                 += read_size;
+		internal_file->cache_pool_created_in_library = 0;
+	}
+	internal_file->file_identity_is_set = 0;
 
-#if defined( HAVE_DEBUG_OUTPUT )
-		if( libcnotify_verbose != 0 )
+	if( internal_file->sparse_cluster_block != NULL )
+	{
+		if( libqcow_cluster_block_free(
+		     &( internal_file->sparse_cluster_block ),
+		     error ) != 1 )
 		{
-			libcnotify_printf(
-			 "\n" );
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+			 "%s: unable to free sparse cluster block.",
+			 function );
+
+			result = -1;
 		}
-#endif
-		if( (size64_t) internal_file->current_offset >= internal_file->file_header->media_size )
-		{
-			break;
+	}
+	if( internal_file->encryption_context != NULL )
+	{
+		if( libqcow_encryption_free(
+		     &( internal_file->encryption_context ),
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+			 "%s: unable to free encryption context.",
+			 function );
+
+			result = -1;
+		}
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_release_for_write(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release read/write lock for writing.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	return( result );
+
+on_error:
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	libcthreads_read_write_lock_release_for_write(
+	 internal_file->read_write_lock,
+	 NULL );
+#endif
+	return( -1 );
+}
+
+/* Opens the external data file
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_file_open_data_file(
+     libqcow_file_t *file,
+     const char *filename,
+     libcerror_error_t **error )
+{
+	libbfio_handle_t *file_io_handle       = NULL;
+	libqcow_internal_file_t *internal_file = NULL;
+	static char *function                  = "libqcow_file_open_data_file";
+
+	if( file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	if( filename == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid filename.",
+		 function );
+
+		return( -1 );
+	}
+	internal_file = (libqcow_internal_file_t *) file;
+
+	if( libbfio_file_initialize(
+	     &file_io_handle,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+		 "%s: unable to create data file IO handle.",
+		 function );
+
+		goto on_error;
+	}
+	if( libbfio_file_set_name(
+	     file_io_handle,
+	     filename,
+	     narrow_string_length(
+	      filename ) + 1,
+	     error ) != 1 )
+	{
+                libcerror_error_set(
+                 error,
+                 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+                 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+                 "%s: unable to set filename in data file IO handle.",
+                 function );
+
+		goto on_error;
+	}
+	if( libqcow_file_open_data_file_io_handle(
+	     file,
+	     file_io_handle,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_IO,
+		 LIBCERROR_IO_ERROR_OPEN_FAILED,
+		 "%s: unable to open data file: %s.",
+		 function,
+		 filename );
+
+		goto on_error;
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_grab_for_write(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab read/write lock for writing.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	internal_file->data_file_io_handle_created_in_library = 1;
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_release_for_write(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release read/write lock for writing.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	return( 1 );
+
+on_error:
+	if( file_io_handle != NULL )
+	{
+		libbfio_handle_free(
+		 &file_io_handle,
+		 NULL );
+	}
+	return( -1 );
+}
+
+#if defined( HAVE_WIDE_CHARACTER_TYPE )
+
+/* Opens the external data file
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_file_open_data_file_wide(
+     libqcow_file_t *file,
+     const wchar_t *filename,
+     libcerror_error_t **error )
+{
+	libbfio_handle_t *file_io_handle       = NULL;
+	libqcow_internal_file_t *internal_file = NULL;
+	static char *function                  = "libqcow_file_open_data_file_wide";
+
+	if( file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	if( filename == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid filename.",
+		 function );
+
+		return( -1 );
+	}
+	internal_file = (libqcow_internal_file_t *) file;
+
+	if( libbfio_file_initialize(
+	     &file_io_handle,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+		 "%s: unable to create data file IO handle.",
+		 function );
+
+		goto on_error;
+	}
+	if( libbfio_file_set_name_wide(
+	     file_io_handle,
+	     filename,
+	     wide_string_length(
+	      filename ) + 1,
+	     error ) != 1 )
+	{
+                libcerror_error_set(
+                 error,
+                 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+                 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+                 "%s: unable to set filename in data file IO handle.",
+                 function );
+
+		goto on_error;
+	}
+	if( libqcow_file_open_data_file_io_handle(
+	     file,
+	     file_io_handle,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_IO,
+		 LIBCERROR_IO_ERROR_OPEN_FAILED,
+		 "%s: unable to open data file: %ls.",
+		 function,
+		 filename );
+
+		goto on_error;
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_grab_for_write(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab read/write lock for writing.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	internal_file->data_file_io_handle_created_in_library = 1;
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_release_for_write(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release read/write lock for writing.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	return( 1 );
+
+on_error:
+	if( file_io_handle != NULL )
+	{
+		libbfio_handle_free(
+		 &file_io_handle,
+		 NULL );
+	}
+	return( -1 );
+}
+
+#endif /* defined( HAVE_WIDE_CHARACTER_TYPE ) */
+
+/* Opens the external data file using a Basic File IO (bfio) handle
+ * The file must be opened before and use an external data file
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_file_open_data_file_io_handle(
+     libqcow_file_t *file,
+     libbfio_handle_t *file_io_handle,
+     libcerror_error_t **error )
+{
+	libqcow_internal_file_t *internal_file   = NULL;
+	static char *function                    = "libqcow_file_open_data_file_io_handle";
+	size64_t data_file_size                  = 0;
+	uint8_t file_io_handle_opened_in_library = 0;
+	int file_io_handle_is_open               = 0;
+	int result                               = 1;
+	int segment_index                        = 0;
+
+	if( file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	internal_file = (libqcow_internal_file_t *) file;
+
+	if( internal_file->file_header == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid file - missing file header.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( internal_file->file_header->incompatible_feature_flags & LIBQCOW_INCOMPATIBLE_FEATURE_FLAG_EXTERNAL_DATA_FILE ) == 0 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_UNSUPPORTED_VALUE,
+		 "%s: invalid file - file does not use an external data file.",
+		 function );
+
+		return( -1 );
+	}
+	if( internal_file->data_file_io_handle != NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_ALREADY_SET,
+		 "%s: invalid file - data file IO handle already set.",
+		 function );
+
+		return( -1 );
+	}
+	if( file_io_handle == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid data file IO handle.",
+		 function );
+
+		return( -1 );
+	}
+	file_io_handle_is_open = libbfio_handle_is_open(
+	                          file_io_handle,
+	                          error );
+
+	if( file_io_handle_is_open == -1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_IO,
+		 LIBCERROR_IO_ERROR_OPEN_FAILED,
+		 "%s: unable to determine if data file IO handle is open.",
+		 function );
+
+		goto on_error;
+	}
+	else if( file_io_handle_is_open == 0 )
+	{
+		if( libbfio_handle_open(
+		     file_io_handle,
+		     LIBBFIO_ACCESS_FLAG_READ,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_IO,
+			 LIBCERROR_IO_ERROR_OPEN_FAILED,
+			 "%s: unable to open data file IO handle.",
+			 function );
+
+			goto on_error;
+		}
+		file_io_handle_opened_in_library = 1;
+	}
+	if( libbfio_handle_get_size(
+	     file_io_handle,
+	     &data_file_size,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_IO,
+		 LIBCERROR_IO_ERROR_READ_FAILED,
+		 "%s: unable to retrieve data file size.",
+		 function );
+
+		goto on_error;
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_grab_for_write(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab read/write lock for writing.",
+		 function );
+
+		goto on_error;
+	}
+#endif
+	/* The cluster blocks of the external data file use a separate vector
+	 * that covers the data file but share the cluster block cache
+	 */
+	if( libfdata_vector_initialize(
+	     &( internal_file->data_file_cluster_block_vector ),
+	     internal_file->cluster_block_size,
+	     (intptr_t *) internal_file->io_handle,
+	     NULL,
+	     NULL,
+	     (int (*)(intptr_t *, intptr_t *, libfdata_vector_t *, libfdata_cache_t *, int, int, off64_t, size64_t, uint32_t, uint8_t, libcerror_error_t **)) &libqcow_io_handle_read_cluster_block,
+	     NULL,
+	     LIBFDATA_DATA_HANDLE_FLAG_NON_MANAGED,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+		 "%s: unable to create data file cluster block vector.",
+		 function );
+
+		result = -1;
+	}
+	else if( libfdata_vector_append_segment(
+	          internal_file->data_file_cluster_block_vector,
+	          &segment_index,
+	          0,
+	          0,
+	          data_file_size,
+	          0,
+	          error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_APPEND_FAILED,
+		 "%s: unable to append segment to data file cluster block vector.",
+		 function );
+
+		libfdata_vector_free(
+		 &( internal_file->data_file_cluster_block_vector ),
+		 NULL );
+
+		result = -1;
+	}
+	else
+	{
+		internal_file->data_file_io_handle                   = file_io_handle;
+		internal_file->data_file_io_handle_opened_in_library = file_io_handle_opened_in_library;
+		internal_file->data_file_size                        = data_file_size;
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_release_for_write(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release read/write lock for writing.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	if( result != 1 )
+	{
+		goto on_error;
+	}
+	return( 1 );
+
+on_error:
+	if( file_io_handle_opened_in_library != 0 )
+	{
+		libbfio_handle_close(
+		 file_io_handle,
+		 NULL );
+	}
+	return( -1 );
+}
+
+/* Closes the external data file
+ * Returns 0 if successful or -1 on error
+ */
+int libqcow_internal_file_close_data_file(
+     libqcow_internal_file_t *internal_file,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_internal_file_close_data_file";
+	int result            = 0;
+
+	if( internal_file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	if( internal_file->data_file_io_handle_opened_in_library != 0 )
+	{
+		if( libbfio_handle_close(
+		     internal_file->data_file_io_handle,
+		     error ) != 0 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_IO,
+			 LIBCERROR_IO_ERROR_CLOSE_FAILED,
+			 "%s: unable to close data file IO handle.",
+			 function );
+
+			result = -1;
+		}
+		internal_file->data_file_io_handle_opened_in_library = 0;
+	}
+	if( internal_file->data_file_io_handle_created_in_library != 0 )
+	{
+		if( libbfio_handle_free(
+		     &( internal_file->data_file_io_handle ),
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+			 "%s: unable to free data file IO handle.",
+			 function );
+
+			result = -1;
+		}
+		internal_file->data_file_io_handle_created_in_library = 0;
+	}
+	if( libfdata_vector_free(
+	     &( internal_file->data_file_cluster_block_vector ),
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+		 "%s: unable to free data file cluster block vector.",
+		 function );
+
+		result = -1;
+	}
+	internal_file->data_file_io_handle = NULL;
+	internal_file->data_file_size      = 0;
+
+	return( result );
+}
+
+/* Opens a file for reading
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_internal_file_open_read(
+     libqcow_internal_file_t *internal_file,
+     libbfio_handle_t *file_io_handle,
+     libcerror_error_t **error )
+{
+	uint8_t *level1_table_data                 = NULL;
+	static char *function                      = "libqcow_internal_file_open_read";
+	size64_t cache_pool_size                   = 0;
+	size_t level1_table_size                   = 0;
+	size_t level2_table_size                   = 0;
+	uint32_t number_of_level1_table_references = 0;
+	uint32_t number_of_level2_table_bits       = 0;
+	int entry_index                            = 0;
+	int result                                 = 0;
+
+	if( internal_file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	if( internal_file->io_handle == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid file - missing IO handle.",
+		 function );
+
+		return( -1 );
+	}
+	if( internal_file->file_header != NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_ALREADY_SET,
+		 "%s: invalid file - file header value already set.",
+		 function );
+
+		return( -1 );
+	}
+	if( internal_file->backing_filename != NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_ALREADY_SET,
+		 "%s: invalid file - backing filename value already set.",
+		 function );
+
+		return( -1 );
+	}
+	if( internal_file->level1_table != NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_ALREADY_SET,
+		 "%s: invalid file - level 1 table already set.",
+		 function );
+
+		return( -1 );
+	}
+	if( internal_file->level2_table_vector != NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_ALREADY_SET,
+		 "%s: invalid file - level2 table vector already set.",
+		 function );
+
+		return( -1 );
+	}
+	if( internal_file->level2_table_cache != NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_ALREADY_SET,
+		 "%s: invalid file - level2 table cache already set.",
+		 function );
+
+		return( -1 );
+	}
+	if( internal_file->cluster_block_vector != NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_ALREADY_SET,
+		 "%s: invalid file - cluster block vector already set.",
+		 function );
+
+		return( -1 );
+	}
+	if( internal_file->cluster_block_cache != NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_ALREADY_SET,
+		 "%s: invalid file - cluster block cache already set.",
+		 function );
+
+		return( -1 );
+	}
+	if( internal_file->compressed_cluster_block_cache != NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_ALREADY_SET,
+		 "%s: invalid file - compressed cluster block cache already set.",
+		 function );
+
+		return( -1 );
+	}
+	if( libbfio_handle_get_size(
+	     file_io_handle,
+	     &( internal_file->size ),
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+		 "%s: unable to retrieve file size.",
+		 function );
+
+		goto on_error;
+	}
+	if( internal_file->size == 0 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid file size.",
+		 function );
+
+		goto on_error;
+	}
+#if defined( HAVE_DEBUG_OUTPUT )
+	if( libcnotify_verbose != 0 )
+	{
+		libcnotify_printf(
+		 "Reading file header:\n" );
+	}
+#endif
+	if( libqcow_file_header_initialize(
+	     &( internal_file->file_header ),
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+		 "%s: unable to create file header.",
+		 function );
+
+		goto on_error;
+	}
+	if( libqcow_file_header_read_file_io_handle(
+	     internal_file->file_header,
+	     file_io_handle,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_IO,
+		 LIBCERROR_IO_ERROR_READ_FAILED,
+		 "%s: unable to read file header.",
+		 function );
+
+		goto on_error;
+	}
+
+	internal_file->encryption_method  = internal_file->file_header->encryption_method;
+
+	number_of_level1_table_references = internal_file->file_header->number_of_level1_table_references;
+
+	if( internal_file->file_header->format_version == 1 )
+	{
+		if( internal_file->file_header->number_of_cluster_block_bits > 63 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+			 "%s: invalid number of cluster block bits value out of bounds.",
+			 function );
+
+			goto on_error;
+		}
+		if( internal_file->file_header->number_of_level2_table_bits > 63 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+			 "%s: invalid number of cluster block bits value out of bounds.",
+			 function );
+
+			goto on_error;
+		}
+		number_of_level2_table_bits = internal_file->file_header->number_of_level2_table_bits;
+
+		internal_file->offset_bit_mask            = 0x7fffffffffffffffULL;
+		internal_file->compressed_offset_bit_mask = 0x7fffffffffffffffULL;
+		internal_file->compression_flag_bit_mask  = (uint64_t) 1UL << 63;
+		internal_file->compression_bit_shift      = 63 - internal_file->file_header->number_of_cluster_block_bits;
+	}
+	else if( internal_file->file_header->format_version == 2 )
+	{
+		if( ( internal_file->file_header->number_of_cluster_block_bits <= 8 )
+		 || ( internal_file->file_header->number_of_cluster_block_bits > 63 ) )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+			 "%s: invalid number of cluster block bits value out of bounds.",
+			 function );
+
+			goto on_error;
+		}
+		number_of_level2_table_bits = internal_file->file_header->number_of_cluster_block_bits - 3;
+
+		internal_file->offset_bit_mask            = 0x3fffffffffffffffULL;
+		internal_file->compressed_offset_bit_mask = 0x3fffffffffffffffULL;
+		internal_file->compression_flag_bit_mask  = (uint64_t) 1UL << 62;
+		internal_file->compression_bit_shift      = 62 - ( internal_file->file_header->number_of_cluster_block_bits - 8 );
+	}
+	else if( internal_file->file_header->format_version == 3 )
+	{
+		if( ( internal_file->file_header->number_of_cluster_block_bits <= 8 )
+		 || ( internal_file->file_header->number_of_cluster_block_bits > 63 ) )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+			 "%s: invalid number of cluster block bits value out of bounds.",
+			 function );
+
+			goto on_error;
+		}
+		if( ( internal_file->file_header->incompatible_feature_flags & LIBQCOW_INCOMPATIBLE_FEATURE_FLAG_EXTENDED_LEVEL2_ENTRIES ) != 0 )
+		{
+			/* Subclusters should be at least 512 bytes in size
+			 */
+			if( internal_file->file_header->number_of_cluster_block_bits < 14 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+				 "%s: invalid number of cluster block bits value out of bounds for extended level 2 table entries.",
+				 function );
+
+				goto on_error;
+			}
+			number_of_level2_table_bits = internal_file->file_header->number_of_cluster_block_bits - 4;
+
+			internal_file->subcluster_size                        = ( (size64_t) 1 << internal_file->file_header->number_of_cluster_block_bits ) / LIBQCOW_NUMBER_OF_SUBCLUSTERS;
+			internal_file->io_handle->has_extended_level2_entries = 1;
+		}
+		else
+		{
+			number_of_level2_table_bits = internal_file->file_header->number_of_cluster_block_bits - 3;
+		}
+		/* Bit 0 of a compressed cluster block descriptor is part of the compressed data offset
+		 */
+		internal_file->offset_bit_mask            = 0x3ffffffffffffffeULL;
+		internal_file->compressed_offset_bit_mask = 0x3fffffffffffffffULL;
+		internal_file->compression_flag_bit_mask  = (uint64_t) 1UL << 62;
+		internal_file->compression_bit_shift      = 62 - ( internal_file->file_header->number_of_cluster_block_bits - 8 );
+
+		/* With extended level 2 table entries the zero state is stored in the subcluster allocation bitmap
+		 */
+		if( internal_file->subcluster_size == 0 )
+		{
+			internal_file->zero_flag_bit_mask = 0x0000000000000001ULL;
+		}
+		/* A raw external data file contains the guest data at the same offsets
+		 */
+		if( ( ( internal_file->file_header->incompatible_feature_flags & LIBQCOW_INCOMPATIBLE_FEATURE_FLAG_EXTERNAL_DATA_FILE ) != 0 )
+		 && ( ( internal_file->file_header->auto_clear_feature_flags & LIBQCOW_AUTO_CLEAR_FEATURE_FLAG_DATA_FILE_RAW ) != 0 ) )
+		{
+			internal_file->data_file_is_raw = 1;
+		}
+	}
+	internal_file->level1_index_bit_shift = internal_file->file_header->number_of_cluster_block_bits + number_of_level2_table_bits;
+
+	if( internal_file->level1_index_bit_shift > 63 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid level1 index bit shift value out of bounds.",
+		 function );
+
+		goto on_error;
+	}
+	internal_file->level2_index_bit_mask  = ~( (uint64_t) -1 << number_of_level2_table_bits );
+	internal_file->cluster_block_bit_mask = ~( (uint64_t) -1 << internal_file->file_header->number_of_cluster_block_bits );
+	internal_file->compression_bit_mask   = ~( (uint64_t) -1 << internal_file->compression_bit_shift );
+	internal_file->cluster_block_size     = (size64_t) 1 << internal_file->file_header->number_of_cluster_block_bits;
+
+	level2_table_size = (size_t) 1 << number_of_level2_table_bits;
+
+	if( internal_file->file_header->format_version == 1 )
+	{
+		if( internal_file->cluster_block_size > ( (size64_t) MEMORY_MAXIMUM_ALLOCATION_SIZE / level2_table_size ) )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+			 "%s: invalid cluster block size value out of bounds.",
+			 function );
+
+			goto on_error;
+		}
+		level1_table_size = (size_t) ( internal_file->cluster_block_size * level2_table_size );
+
+		if( ( internal_file->file_header->media_size / level1_table_size ) > ( (size64_t) UINT32_MAX - 1 ) )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+			 "%s: invalid level1 table size value out of bounds: %zd.",
+			 function, level1_table_size );
+
+			goto on_error;
+		}
+		number_of_level1_table_references = (uint32_t) ( internal_file->file_header->media_size / level1_table_size );
+
+		if( ( internal_file->file_header->media_size % level1_table_size ) != 0 )
+		{
+			number_of_level1_table_references += 1;
+		}
+		level1_table_size = (size_t) number_of_level1_table_references;
+	}
+	else if( ( internal_file->file_header->format_version == 2 )
+	      || ( internal_file->file_header->format_version == 3 ) )
+	{
+		if( internal_file->cluster_block_size > (size64_t) MEMORY_MAXIMUM_ALLOCATION_SIZE )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+			 "%s: invalid cluster block size value out of bounds.",
+			 function );
+
+			goto on_error;
+		}
+		level1_table_size = (size_t) number_of_level1_table_references;
+	}
+	if( ( level1_table_size == 0 )
+	 || ( level1_table_size > ( (size_t) MEMORY_MAXIMUM_ALLOCATION_SIZE / 8 ) ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid level1 table size value out of bounds.",
+		 function );
+
+		goto on_error;
+	}
+	if( ( level2_table_size == 0 )
+	 || ( level2_table_size > ( (size_t) MEMORY_MAXIMUM_ALLOCATION_SIZE / 16 ) ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid level2 table size value out of bounds.",
+		 function );
+
+		goto on_error;
+	}
+	level1_table_size *= 8;
+
+	if( internal_file->io_handle->has_extended_level2_entries != 0 )
+	{
+		level2_table_size *= 16;
+	}
+	else
+	{
+		level2_table_size *= 8;
+	}
+
+#if defined( HAVE_DEBUG_OUTPUT )
+	if( libcnotify_verbose != 0 )
+	{
+		libcnotify_printf(
+		 "%s: level 1 table size\t\t\t: %" PRIzd "\n",
+		 function,
+		 level1_table_size );
+
+		libcnotify_printf(
+		 "%s: level 2 table size\t\t\t: %" PRIzd "\n",
+		 function,
+		 level2_table_size );
+
+		libcnotify_printf(
+		 "%s: cluster block size\t\t\t: %" PRIu64 "\n",
+		 function,
+		 internal_file->cluster_block_size );
+
+		libcnotify_printf(
+		 "\n" );
+	}
+#endif /* defined( HAVE_DEBUG_OUTPUT ) */
+
+	if( ( internal_file->file_header->backing_filename_offset > 0 )
+	 && ( internal_file->file_header->backing_filename_size > 0 ) )
+	{
+		if( libqcow_internal_file_open_read_backing_filename(
+		     internal_file,
+		     file_io_handle,
+		     internal_file->file_header->backing_filename_offset,
+		     internal_file->file_header->backing_filename_size,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_IO,
+			 LIBCERROR_IO_ERROR_READ_FAILED,
+			 "%s: unable to read backing filename.",
+			 function );
+
+			goto on_error;
+		}
+	}
+	if( internal_file->encryption_method != LIBQCOW_ENCRYPTION_METHOD_NONE )
+	{
+		if( libqcow_encryption_initialize(
+		     &( internal_file->encryption_context ),
+		     internal_file->encryption_method,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+			 "%s: unable to create encryption context.",
+			 function );
+
+			goto on_error;
+		}
+#if defined( HAVE_DEBUG_OUTPUT )
+		if( libcnotify_verbose != 0 )
+		{
+			libcnotify_printf(
+			 "%s: key:\n",
+			 function );
+			libcnotify_print_data(
+			 internal_file->key_data,
+			 16,
+			 0 );
+		}
+#endif
+		if( libqcow_encryption_set_keys(
+		     internal_file->encryption_context,
+		     internal_file->key_data,
+		     16,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+			 "%s: unable to set key data in encryption context.",
+			 function );
+
+			goto on_error;
+		}
+	}
+#if defined( HAVE_DEBUG_OUTPUT )
+	if( libcnotify_verbose != 0 )
+	{
+		libcnotify_printf(
+		 "Reading level 1 table:\n" );
+	}
+#endif
+	if( libqcow_cluster_table_initialize(
+	     &( internal_file->level1_table ),
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+		 "%s: unable to create level 1 table.",
+		 function );
+
+		goto on_error;
+	}
+	if( internal_file->mapped_file != NULL )
+	{
+		/* Reference the level 1 table in the memory mapped file so that
+		 * its pages are only read when the corresponding references are used
+		 */
+		result = libqcow_mapped_file_get_data(
+		          internal_file->mapped_file,
+		          (off64_t) internal_file->file_header->level1_table_offset,
+		          (size64_t) level1_table_size,
+		          &level1_table_data,
+		          error );
+
+		if( result == -1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+			 "%s: unable to retrieve level 1 table data from mapped file.",
+			 function );
+
+			goto on_error;
+		}
+		else if( result != 0 )
+		{
+			if( libqcow_cluster_table_set_references_data(
+			     internal_file->level1_table,
+			     level1_table_data,
+			     level1_table_size,
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+				 "%s: unable to set level 1 table references data.",
+				 function );
+
+				goto on_error;
+			}
+		}
+	}
+	if( result == 0 )
+	{
+		if( libqcow_cluster_table_read(
+		     internal_file->level1_table,
+		     file_io_handle,
+		     internal_file->file_header->level1_table_offset,
+		     level1_table_size,
+		     8,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_IO,
+			 LIBCERROR_IO_ERROR_READ_FAILED,
+			 "%s: unable to read level 1 table.",
+			 function );
+
+			goto on_error;
+		}
+	}
+/* TODO clone function ? */
+	if( libfdata_vector_initialize(
+	     &( internal_file->level2_table_vector ),
+	     (size64_t) level2_table_size,
+	     (intptr_t *) internal_file->io_handle,
+	     NULL,
+	     NULL,
+	     (int (*)(intptr_t *, intptr_t *, libfdata_vector_t *, libfdata_cache_t *, int, int, off64_t, size64_t, uint32_t, uint8_t, libcerror_error_t **)) &libqcow_io_handle_read_level2_table,
+	     NULL,
+	     LIBFDATA_DATA_HANDLE_FLAG_NON_MANAGED,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+		 "%s: unable to create level2 table vector.",
+		 function );
+
+		goto on_error;
+	}
+	if( libfdata_vector_append_segment(
+	     internal_file->level2_table_vector,
+	     &entry_index,
+	     0,
+	     0,
+	     internal_file->size,
+	     0,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_APPEND_FAILED,
+		 "%s: unable to append segment to level2 table vector.",
+		 function );
+
+		goto on_error;
+	}
+	if( libfcache_cache_initialize(
+	     &( internal_file->level2_table_cache ),
+	     LIBQCOW_MAXIMUM_CACHE_ENTRIES_LEVEL2_TABLES,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+		 "%s: unable to create level2 table cache.",
+		 function );
+
+		goto on_error;
+	}
+	internal_file->maximum_level2_table_cache_entries = LIBQCOW_MAXIMUM_CACHE_ENTRIES_LEVEL2_TABLES;
+
+	/* Cluster blocks that are not compressed or encrypted are served
+	 * directly from the memory mapped file, unless they are stored
+	 * in an external data file
+	 */
+	if( ( internal_file->mapped_file != NULL )
+	 && ( internal_file->encryption_method == LIBQCOW_ENCRYPTION_METHOD_NONE )
+	 && ( ( internal_file->file_header->incompatible_feature_flags & LIBQCOW_INCOMPATIBLE_FEATURE_FLAG_EXTERNAL_DATA_FILE ) == 0 ) )
+	{
+		internal_file->io_handle->mapped_file = internal_file->mapped_file;
+	}
+/* TODO clone function ? */
+	if( libfdata_vector_initialize(
+	     &( internal_file->cluster_block_vector ),
+	     internal_file->cluster_block_size,
+	     (intptr_t *) internal_file->io_handle,
+	     NULL,
+	     NULL,
+	     (int (*)(intptr_t *, intptr_t *, libfdata_vector_t *, libfdata_cache_t *, int, int, off64_t, size64_t, uint32_t, uint8_t, libcerror_error_t **)) &libqcow_io_handle_read_cluster_block,
+	     NULL,
+	     LIBFDATA_DATA_HANDLE_FLAG_NON_MANAGED,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+		 "%s: unable to create cluster block vector.",
+		 function );
+
+		goto on_error;
+	}
+	if( libfdata_vector_append_segment(
+	     internal_file->cluster_block_vector,
+	     &entry_index,
+	     0,
+	     0,
+	     internal_file->size,
+	     0,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_APPEND_FAILED,
+		 "%s: unable to append segment to cluster block vector.",
+		 function );
+
+		goto on_error;
+	}
+	if( libfcache_cache_initialize(
+	     &( internal_file->cluster_block_cache ),
+	     LIBQCOW_MAXIMUM_CACHE_ENTRIES_CLUSTER_BLOCKS,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+		 "%s: unable to create cluster block cache.",
+		 function );
+
+		goto on_error;
+	}
+	if( libfcache_cache_initialize(
+	     &( internal_file->compressed_cluster_block_cache ),
+	     LIBQCOW_MAXIMUM_CACHE_ENTRIES_CLUSTER_BLOCKS,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+		 "%s: unable to create compressed cluster block cache.",
+		 function );
+
+		goto on_error;
+	}
+	internal_file->maximum_cluster_block_cache_entries = LIBQCOW_MAXIMUM_CACHE_ENTRIES_CLUSTER_BLOCKS;
+
+	/* Without a cache pool the file creates a cache pool of its own, so that its cluster blocks
+	 * are cached in independently locked shards instead of the cluster block caches of the file,
+	 * which are only used with the read/write lock of the file grabbed for writing
+	 */
+	if( internal_file->cache_pool == NULL )
+	{
+		cache_pool_size = (size64_t) LIBQCOW_MAXIMUM_CACHE_ENTRIES_CLUSTER_BLOCKS * internal_file->cluster_block_size * 2;
+
+		if( cache_pool_size < LIBQCOW_MINIMUM_FILE_CACHE_POOL_SIZE )
+		{
+			cache_pool_size = LIBQCOW_MINIMUM_FILE_CACHE_POOL_SIZE;
+		}
+		if( libqcow_cache_pool_initialize(
+		     &( internal_file->cache_pool ),
+		     cache_pool_size,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+			 "%s: unable to create cache pool.",
+			 function );
+
+			goto on_error;
+		}
+		internal_file->cache_pool_created_in_library = 1;
+
+		/* The cache pool is only used by this file and the files of its backing chain
+		 * that were opened in the library, which have file identities of their own
+		 */
+		if( memory_set(
+		     &( internal_file->file_identity ),
+		     0,
+		     sizeof( libqcow_file_identity_t ) ) == NULL )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_MEMORY,
+			 LIBCERROR_MEMORY_ERROR_SET_FAILED,
+			 "%s: unable to clear file identity.",
+			 function );
+
+			goto on_error;
+		}
+		internal_file->file_identity_is_set = 1;
+	}
+	/* The extent index stores cluster block values and cannot represent subclusters
+	 * or cluster blocks stored at offset 0 of an external data file
+	 */
+	if( ( ( internal_file->access_flags & ( LIBQCOW_OPEN_FLAG_EXTENT_INDEX | LIBQCOW_OPEN_FLAG_MAPPING_INDEX ) ) != 0 )
+	 && ( internal_file->subcluster_size == 0 )
+	 && ( ( internal_file->file_header->incompatible_feature_flags & LIBQCOW_INCOMPATIBLE_FEATURE_FLAG_EXTERNAL_DATA_FILE ) == 0 ) )
+	{
+		if( libqcow_extent_index_initialize(
+		     &( internal_file->extent_index ),
+		     internal_file->level1_table->number_of_references,
+		     (int) ( level2_table_size / 8 ),
+		     internal_file->cluster_block_size,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+			 "%s: unable to create extent index.",
+			 function );
+
+			goto on_error;
+		}
+	}
+	if( internal_file->file_header->number_of_snapshots > 0 )
+	{
+#if defined( HAVE_DEBUG_OUTPUT )
+		if( libcnotify_verbose != 0 )
+		{
+			libcnotify_printf(
+			 "Reading snapshot table:\n" );
+		}
+#endif
+		if( libqcow_internal_file_open_read_snapshot_table(
+		     internal_file,
+		     file_io_handle,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_IO,
+			 LIBCERROR_IO_ERROR_READ_FAILED,
+			 "%s: unable to read snapshot table.",
+			 function );
+
+			goto on_error;
+		}
+	}
+	internal_file->is_locked = 0;
+
+	return( 1 );
+
+on_error:
+	if( internal_file->extent_index != NULL )
+	{
+		libqcow_extent_index_free(
+		 &( internal_file->extent_index ),
+		 NULL );
+	}
+	if( internal_file->cache_pool_created_in_library != 0 )
+	{
+		libqcow_cache_pool_free(
+		 &( internal_file->cache_pool ),
+		 NULL );
+
+		internal_file->cache_pool_created_in_library = 0;
+		internal_file->file_identity_is_set          = 0;
+	}
+	if( internal_file->io_handle != NULL )
+	{
+		internal_file->io_handle->mapped_file = NULL;
+	}
+	if( internal_file->compressed_cluster_block_cache != NULL )
+	{
+		libfcache_cache_free(
+		 &( internal_file->compressed_cluster_block_cache ),
+		 NULL );
+	}
+	if( internal_file->cluster_block_cache != NULL )
+	{
+		libfcache_cache_free(
+		 &( internal_file->cluster_block_cache ),
+		 NULL );
+	}
+	if( internal_file->cluster_block_vector != NULL )
+	{
+		libfdata_vector_free(
+		 &( internal_file->cluster_block_vector ),
+		 NULL );
+	}
+	if( internal_file->level2_table_cache != NULL )
+	{
+		libfcache_cache_free(
+		 &( internal_file->level2_table_cache ),
+		 NULL );
+	}
+	if( internal_file->level2_table_vector != NULL )
+	{
+		libfdata_vector_free(
+		 &( internal_file->level2_table_vector ),
+		 NULL );
+	}
+	libqcow_internal_file_free_published_level2_tables(
+	 internal_file,
+	 NULL );
+
+	if( internal_file->level1_table != NULL )
+	{
+		libqcow_cluster_table_free(
+		 &( internal_file->level1_table ),
+		 NULL );
+	}
+	if( internal_file->encryption_context != NULL )
+	{
+		libqcow_encryption_free(
+		 &( internal_file->encryption_context ),
+		 NULL );
+	}
+	if( internal_file->backing_filename != NULL )
+	{
+		memory_free(
+		 internal_file->backing_filename );
+
+		internal_file->backing_filename = NULL;
+	}
+	internal_file->backing_filename_size = 0;
+
+	if( internal_file->file_header != NULL )
+	{
+		libqcow_file_header_free(
+		 &( internal_file->file_header ),
+		 NULL );
+	}
+	return( -1 );
+}
+
+/* Reads the snapshot table
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_internal_file_open_read_snapshot_table(
+     libqcow_internal_file_t *internal_file,
+     libbfio_handle_t *file_io_handle,
+     libcerror_error_t **error )
+{
+	libqcow_snapshot_values_t *snapshot_values = NULL;
+	static char *function                      = "libqcow_internal_file_open_read_snapshot_table";
+	size_t snapshot_values_array_size          = 0;
+	off64_t file_offset                        = 0;
+	uint32_t snapshot_index                    = 0;
+
+	if( internal_file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	if( internal_file->file_header == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid file - missing file header.",
+		 function );
+
+		return( -1 );
+	}
+	if( internal_file->snapshot_values_array != NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_ALREADY_SET,
+		 "%s: invalid file - snapshot values array value already set.",
+		 function );
+
+		return( -1 );
+	}
+	if( internal_file->file_header->number_of_snapshots > LIBQCOW_MAXIMUM_NUMBER_OF_SNAPSHOTS )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid file - number of snapshots value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	if( internal_file->file_header->number_of_snapshots == 0 )
+	{
+		return( 1 );
+	}
+	snapshot_values_array_size = sizeof( libqcow_snapshot_values_t * ) * internal_file->file_header->number_of_snapshots;
+
+	internal_file->snapshot_values_array = (libqcow_snapshot_values_t **) memory_allocate(
+	                                                                       snapshot_values_array_size );
+
+	if( internal_file->snapshot_values_array == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_INSUFFICIENT,
+		 "%s: unable to create snapshot values array.",
+		 function );
+
+		goto on_error;
+	}
+	if( memory_set(
+	     internal_file->snapshot_values_array,
+	     0,
+	     snapshot_values_array_size ) == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_SET_FAILED,
+		 "%s: unable to clear snapshot values array.",
+		 function );
+
+		goto on_error;
+	}
+	file_offset = internal_file->file_header->snapshots_offset;
+
+	for( snapshot_index = 0;
+	     snapshot_index < internal_file->file_header->number_of_snapshots;
+	     snapshot_index++ )
+	{
+		if( libqcow_snapshot_values_initialize(
+		     &snapshot_values,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+			 "%s: unable to create snapshot: %" PRIu32 " values.",
+			 function,
+			 snapshot_index );
+
+			goto on_error;
+		}
+		if( libqcow_snapshot_values_read_file_io_handle(
+		     snapshot_values,
+		     file_io_handle,
+		     file_offset,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_IO,
+			 LIBCERROR_IO_ERROR_READ_FAILED,
+			 "%s: unable to read snapshot: %" PRIu32 " values.",
+			 function,
+			 snapshot_index );
+
+			goto on_error;
+		}
+		file_offset += (off64_t) snapshot_values->data_size;
+
+		internal_file->snapshot_values_array[ snapshot_index ] = snapshot_values;
+		internal_file->number_of_snapshots                    += 1;
+
+		snapshot_values = NULL;
+	}
+	return( 1 );
+
+on_error:
+	if( snapshot_values != NULL )
+	{
+		libqcow_snapshot_values_free(
+		 &snapshot_values,
+		 NULL );
+	}
+	libqcow_internal_file_free_snapshot_table(
+	 internal_file,
+	 NULL );
+
+	return( -1 );
+}
+
+/* Frees the snapshot table
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_internal_file_free_snapshot_table(
+     libqcow_internal_file_t *internal_file,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_internal_file_free_snapshot_table";
+	int result            = 1;
+	int snapshot_index    = 0;
+
+	if( internal_file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	if( internal_file->snapshot_values_array != NULL )
+	{
+		for( snapshot_index = 0;
+		     snapshot_index < internal_file->number_of_snapshots;
+		     snapshot_index++ )
+		{
+			if( libqcow_snapshot_values_free(
+			     &( internal_file->snapshot_values_array[ snapshot_index ] ),
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+				 "%s: unable to free snapshot: %d values.",
+				 function,
+				 snapshot_index );
+
+				result = -1;
+			}
+		}
+		memory_free(
+		 internal_file->snapshot_values_array );
+
+		internal_file->snapshot_values_array = NULL;
+	}
+	internal_file->number_of_snapshots = 0;
+
+	return( result );
+}
+
+/* Reads the backing filename
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_internal_file_open_read_backing_filename(
+     libqcow_internal_file_t *internal_file,
+     libbfio_handle_t *file_io_handle,
+     off64_t backing_filename_offset,
+     uint32_t backing_filename_size,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_internal_file_open_read_backing_filename";
+	ssize_t read_count    = 0;
+
+	if( internal_file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	if( internal_file->backing_filename != NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_ALREADY_SET,
+		 "%s: invalid file - backing filename value already set.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( backing_filename_size == 0 )
+	 || ( backing_filename_size > MEMORY_MAXIMUM_ALLOCATION_SIZE ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid backing filename size value out of bounds.",
+		 function );
+
+		goto on_error;
+	}
+	internal_file->backing_filename = (uint8_t *) memory_allocate(
+	                                               sizeof( uint8_t ) * backing_filename_size );
+
+	if( internal_file->backing_filename == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_INSUFFICIENT,
+		 "%s: unable to create backing filename.",
+		 function );
+
+		goto on_error;
+	}
+	internal_file->backing_filename_size = (size_t) backing_filename_size;
+
+#if defined( HAVE_DEBUG_OUTPUT )
+	if( libcnotify_verbose != 0 )
+	{
+		libcnotify_printf(
+		 "%s: reading backing filename at offset: %" PRIu64 " (0x%08" PRIx64 ")\n",
+		 function,
+		 backing_filename_offset,
+		 backing_filename_offset );
+	}
+#endif
+	read_count = libbfio_handle_read_buffer_at_offset(
+		      file_io_handle,
+		      internal_file->backing_filename,
+		      (size_t) backing_filename_size,
+		      backing_filename_offset,
+		      error );
+
+	if( read_count != (ssize_t) backing_filename_size )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_IO,
+		 LIBCERROR_IO_ERROR_READ_FAILED,
+		 "%s: unable to read backing filename data at offset: %" PRIu64 " (0x%08" PRIx64 ").",
+		 function,
+		 backing_filename_offset,
+		 backing_filename_offset );
+
+		goto on_error;
+	}
+#if defined( HAVE_DEBUG_OUTPUT )
+	if( libcnotify_verbose != 0 )
+	{
+		libcnotify_printf(
+		 "%s: backing filename data:\n",
+		 function );
+		libcnotify_print_data(
+		 internal_file->backing_filename,
+		 (size_t) backing_filename_size,
+		 0 );
+	}
+#endif
+	return( 1 );
+
+on_error:
+	if( internal_file->backing_filename != NULL )
+	{
+		memory_free(
+		 internal_file->backing_filename );
+
+		internal_file->backing_filename = NULL;
+	}
+	internal_file->backing_filename_size = 0;
+
+	return( -1 );
+}
+
+/* Opens the memory mapped file
+ * If the file cannot be memory mapped, the file is read using the file IO handle
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_internal_file_open_mapped_file(
+     libqcow_internal_file_t *internal_file,
+     const char *filename,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_internal_file_open_mapped_file";
+	int result            = 0;
+
+	if( internal_file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	if( internal_file->mapped_file != NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_ALREADY_SET,
+		 "%s: invalid file - mapped file value already set.",
+		 function );
+
+		return( -1 );
+	}
+	if( libqcow_mapped_file_initialize(
+	     &( internal_file->mapped_file ),
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+		 "%s: unable to create mapped file.",
+		 function );
+
+		goto on_error;
+	}
+	result = libqcow_mapped_file_open(
+	          internal_file->mapped_file,
+	          filename,
+	          error );
+
+	if( result == -1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_IO,
+		 LIBCERROR_IO_ERROR_OPEN_FAILED,
+		 "%s: unable to open mapped file.",
+		 function );
+
+		goto on_error;
+	}
+	else if( result == 0 )
+	{
+#if defined( HAVE_DEBUG_OUTPUT )
+		if( libcnotify_verbose != 0 )
+		{
+			libcnotify_printf(
+			 "%s: file cannot be memory mapped.\n",
+			 function );
+		}
+#endif
+		if( libqcow_mapped_file_free(
+		     &( internal_file->mapped_file ),
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+			 "%s: unable to free mapped file.",
+			 function );
+
+			goto on_error;
+		}
+	}
+	return( 1 );
+
+on_error:
+	if( internal_file->mapped_file != NULL )
+	{
+		libqcow_mapped_file_free(
+		 &( internal_file->mapped_file ),
+		 NULL );
+	}
+	return( -1 );
+}
+
+/* Opens the file IO pool
+ * A file IO handle that cannot be cloned is not considered an error
+ * and the file IO pool is not opened again until the file is closed
+ * A file IO handle passed to open with a file IO handle is only cloned when requested
+ * by the open flags, since its clones can share an offset, like those of a file object
+ * This function is not multi-thread safe acquire write lock before call
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_internal_file_open_file_io_pool(
+     libqcow_internal_file_t *internal_file,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_internal_file_open_file_io_pool";
+	int result            = 0;
+
+	if( internal_file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	if( internal_file->file_io_pool != NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_ALREADY_SET,
+		 "%s: invalid file - file IO pool value already set.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( internal_file->file_io_handle_created_in_library == 0 )
+	 && ( ( internal_file->access_flags & LIBQCOW_OPEN_FLAG_CLONE_FILE_IO_HANDLE ) == 0 ) )
+	{
+		internal_file->file_io_handle_cannot_be_cloned = 1;
+
+		return( 1 );
+	}
+	result = libqcow_file_io_pool_initialize(
+	          &( internal_file->file_io_pool ),
+	          internal_file->file_io_handle,
+	          LIBQCOW_FILE_IO_POOL_MAXIMUM_NUMBER_OF_HANDLES,
+	          error );
+
+	if( result == -1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+		 "%s: unable to create file IO pool.",
+		 function );
+
+		return( -1 );
+	}
+	else if( result == 0 )
+	{
+		internal_file->file_io_handle_cannot_be_cloned = 1;
+	}
+	return( 1 );
+}
+
+/* Opens the mapping index (sidecar) file
+ * A mapping index file that is missing or stale is ignored
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_internal_file_open_mapping_index(
+     libqcow_internal_file_t *internal_file,
+     const char *filename,
+     libcerror_error_t **error )
+{
+	static char *function  = "libqcow_internal_file_open_mapping_index";
+	size_t filename_length = 0;
+	int result             = 0;
+
+	if( internal_file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	if( internal_file->extent_index == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid file - missing extent index.",
+		 function );
+
+		return( -1 );
+	}
+	if( internal_file->mapping_index != NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_ALREADY_SET,
+		 "%s: invalid file - mapping index value already set.",
+		 function );
+
+		return( -1 );
+	}
+	if( internal_file->mapping_index_filename != NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_ALREADY_SET,
+		 "%s: invalid file - mapping index filename value already set.",
+		 function );
+
+		return( -1 );
+	}
+	if( filename == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid filename.",
+		 function );
+
+		return( -1 );
+	}
+	filename_length = narrow_string_length(
+	                   filename );
+
+	internal_file->mapping_index_filename = narrow_string_allocate(
+	                                         filename_length + 7 );
+
+	if( internal_file->mapping_index_filename == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_INSUFFICIENT,
+		 "%s: unable to create mapping index filename.",
+		 function );
+
+		goto on_error;
+	}
+	if( narrow_string_copy(
+	     internal_file->mapping_index_filename,
+	     filename,
+	     filename_length ) == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_COPY_FAILED,
+		 "%s: unable to copy filename.",
+		 function );
+
+		goto on_error;
+	}
+	if( narrow_string_copy(
+	     &( internal_file->mapping_index_filename[ filename_length ] ),
+	     ".lqidx",
+	     6 ) == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_COPY_FAILED,
+		 "%s: unable to copy filename suffix.",
+		 function );
+
+		goto on_error;
+	}
+	internal_file->mapping_index_filename[ filename_length + 6 ] = 0;
+
+	if( libqcow_mapping_index_initialize(
+	     &( internal_file->mapping_index ),
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+		 "%s: unable to create mapping index.",
+		 function );
+
+		goto on_error;
+	}
+	if( libqcow_mapping_index_read_file_values(
+	     internal_file->mapping_index,
+	     filename,
+	     internal_file->file_io_handle,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_IO,
+		 LIBCERROR_IO_ERROR_READ_FAILED,
+		 "%s: unable to read file values.",
+		 function );
+
+		goto on_error;
+	}
+	result = libqcow_mapping_index_read_file(
+	          internal_file->mapping_index,
+	          internal_file->mapping_index_filename,
+	          internal_file->extent_index,
+	          error );
+
+	if( result == -1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_IO,
+		 LIBCERROR_IO_ERROR_READ_FAILED,
+		 "%s: unable to read mapping index file: %s.",
+		 function,
+		 internal_file->mapping_index_filename );
+
+		goto on_error;
+	}
+#if defined( HAVE_DEBUG_OUTPUT )
+	else if( libcnotify_verbose != 0 )
+	{
+		if( result == 0 )
+		{
+			libcnotify_printf(
+			 "%s: mapping index file: %s not available.\n",
+			 function,
+			 internal_file->mapping_index_filename );
+		}
+	}
+#endif
+	return( 1 );
+
+on_error:
+	if( internal_file->mapping_index != NULL )
+	{
+		libqcow_mapping_index_free(
+		 &( internal_file->mapping_index ),
+		 NULL );
+	}
+	if( internal_file->mapping_index_filename != NULL )
+	{
+		memory_free(
+		 internal_file->mapping_index_filename );
+
+		internal_file->mapping_index_filename = NULL;
+	}
+	return( -1 );
+}
+
+/* Determines if the file is locked
+ * Returns 1 if locked, 0 if not or -1 on error
+ */
+int libqcow_file_is_locked(
+     libqcow_file_t *file,
+     libcerror_error_t **error )
+{
+	libqcow_internal_file_t *internal_file = NULL;
+	static char *function                  = "libqcow_file_is_locked";
+	uint8_t is_locked                      = 0;
+
+	if( file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	internal_file = (libqcow_internal_file_t *) file;
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_grab_for_read(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab read/write lock for reading.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	is_locked = internal_file->is_locked;
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_release_for_read(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release read/write lock for reading.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	return( is_locked );
+}
+
+/* Writes the mapping index (sidecar) file
+ * All level 2 tables are indexed before the mapping index file is written
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_file_write_mapping_index(
+     libqcow_file_t *file,
+     libcerror_error_t **error )
+{
+	libqcow_internal_file_t *internal_file = NULL;
+	static char *function                  = "libqcow_file_write_mapping_index";
+	uint32_t abort_generation              = 0;
+	int result                             = 1;
+
+	if( file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	internal_file = (libqcow_internal_file_t *) file;
+
+	if( internal_file->mapping_index == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid file - missing mapping index.",
+		 function );
+
+		return( -1 );
+	}
+	/* The indexing is stopped when the file is signalled to abort after this point
+	 */
+	if( libqcow_internal_file_get_abort_generation(
+	     internal_file,
+	     &abort_generation,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+		 "%s: unable to retrieve abort generation.",
+		 function );
+
+		return( -1 );
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_grab_for_write(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab read/write lock for writing.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	if( libqcow_internal_file_index_level2_tables(
+	     internal_file,
+	     internal_file->file_io_handle,
+	     abort_generation,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to index level 2 tables.",
+		 function );
+
+		result = -1;
+	}
+	else if( libqcow_mapping_index_write_file(
+	          internal_file->mapping_index,
+	          internal_file->mapping_index_filename,
+	          internal_file->extent_index,
+	          error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_IO,
+		 LIBCERROR_IO_ERROR_WRITE_FAILED,
+		 "%s: unable to write mapping index file: %s.",
+		 function,
+		 internal_file->mapping_index_filename );
+
+		result = -1;
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_release_for_write(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release read/write lock for writing.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	return( result );
+}
+
+/* Retrieves the cluster block offset and flags from a level 2 table reference
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_internal_file_get_cluster_block_values(
+     libqcow_internal_file_t *internal_file,
+     uint64_t level2_table_reference,
+     uint64_t *cluster_block_offset,
+     uint32_t *cluster_block_flags,
+     libcerror_error_t **error )
+{
+	static char *function              = "libqcow_internal_file_get_cluster_block_values";
+	uint64_t safe_cluster_block_offset = 0;
+	uint32_t safe_cluster_block_flags  = 0;
+
+	if( internal_file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	if( internal_file->file_header == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid file - missing file header.",
+		 function );
+
+		return( -1 );
+	}
+	if( cluster_block_offset == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid cluster block offset.",
+		 function );
+
+		return( -1 );
+	}
+	if( cluster_block_flags == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid cluster block flags.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( level2_table_reference & internal_file->compression_flag_bit_mask ) != 0 )
+	{
+		if( internal_file->encryption_method != LIBQCOW_ENCRYPTION_METHOD_NONE )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+			 LIBCERROR_ARGUMENT_ERROR_UNSUPPORTED_VALUE,
+			 "%s: simultaneous encryption and compression not supported.",
+			 function );
+
+			return( -1 );
+		}
+		safe_cluster_block_flags |= LIBQCOW_CLUSTER_BLOCK_FLAG_IS_COMPRESSED;
+	}
+	/* A cluster block with the zero flag set reads as zero bytes, also when
+	 * it has a (preallocated) cluster block offset, and does not fall through
+	 * to the parent file. The flag is not used by compressed cluster blocks.
+	 */
+	if( ( ( safe_cluster_block_flags & LIBQCOW_CLUSTER_BLOCK_FLAG_IS_COMPRESSED ) == 0 )
+	 && ( internal_file->zero_flag_bit_mask != 0 )
+	 && ( ( level2_table_reference & internal_file->zero_flag_bit_mask ) != 0 ) )
+	{
+		*cluster_block_offset = 0;
+		*cluster_block_flags  = LIBQCOW_CLUSTER_BLOCK_FLAG_IS_ZERO;
+
+		return( 1 );
+	}
+	if( ( safe_cluster_block_flags & LIBQCOW_CLUSTER_BLOCK_FLAG_IS_COMPRESSED ) != 0 )
+	{
+		safe_cluster_block_offset = level2_table_reference & internal_file->compressed_offset_bit_mask;
+	}
+	else
+	{
+		safe_cluster_block_offset = level2_table_reference & internal_file->offset_bit_mask;
+	}
+	if( ( internal_file->file_header->incompatible_feature_flags & LIBQCOW_INCOMPATIBLE_FEATURE_FLAG_EXTERNAL_DATA_FILE ) != 0 )
+	{
+		if( ( safe_cluster_block_flags & LIBQCOW_CLUSTER_BLOCK_FLAG_IS_COMPRESSED ) != 0 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+			 LIBCERROR_ARGUMENT_ERROR_UNSUPPORTED_VALUE,
+			 "%s: compressed cluster block in external data file not supported.",
+			 function );
+
+			return( -1 );
+		}
+		/* The copied flag indicates an allocated cluster block at offset 0 of the external data file
+		 */
+		if( ( safe_cluster_block_offset != 0 )
+		 || ( ( level2_table_reference & 0x8000000000000000ULL ) != 0 ) )
+		{
+			safe_cluster_block_flags |= LIBQCOW_CLUSTER_BLOCK_FLAG_IN_DATA_FILE;
+		}
+	}
+	*cluster_block_offset = safe_cluster_block_offset;
+	*cluster_block_flags  = safe_cluster_block_flags;
+
+	return( 1 );
+}
+
+/* Indexes the cluster blocks of a level 2 table in the extent index
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_internal_file_index_level2_table(
+     libqcow_internal_file_t *internal_file,
+     int level1_table_index,
+     libqcow_cluster_table_t *level2_table,
+     libcerror_error_t **error )
+{
+	static char *function           = "libqcow_internal_file_index_level2_table";
+	uint64_t cluster_block_offset   = 0;
+	uint64_t level2_table_reference = 0;
+	uint32_t cluster_block_flags    = 0;
+	int number_of_references        = 0;
+	int reference_index             = 0;
+
+	if( internal_file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	if( internal_file->extent_index == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid file - missing extent index.",
+		 function );
+
+		return( -1 );
+	}
+	if( libqcow_cluster_table_get_number_of_references(
+	     level2_table,
+	     &number_of_references,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+		 "%s: unable to retrieve number of level 2 table references.",
+		 function );
+
+		return( -1 );
+	}
+	for( reference_index = 0;
+	     reference_index < number_of_references;
+	     reference_index++ )
+	{
+		if( libqcow_cluster_table_get_reference_by_index(
+		     level2_table,
+		     reference_index,
+		     &level2_table_reference,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+			 "%s: unable to retrieve level 2 table entry: %d.",
+			 function,
+			 reference_index );
+
+			return( -1 );
+		}
+		if( libqcow_internal_file_get_cluster_block_values(
+		     internal_file,
+		     level2_table_reference,
+		     &cluster_block_offset,
+		     &cluster_block_flags,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+			 "%s: unable to retrieve cluster block values of level 2 table entry: %d.",
+			 function,
+			 reference_index );
+
+			return( -1 );
+		}
+		/* Unallocated cluster blocks are not stored in the extent index
+		 */
+		if( ( cluster_block_offset == 0 )
+		 && ( cluster_block_flags == 0 ) )
+		{
+			continue;
+		}
+		if( libqcow_extent_index_append_extent(
+		     internal_file->extent_index,
+		     level1_table_index,
+		     reference_index,
+		     cluster_block_offset,
+		     cluster_block_flags,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_APPEND_FAILED,
+			 "%s: unable to append level 2 table entry: %d to extent index.",
+			 function,
+			 reference_index );
+
+			return( -1 );
+		}
+	}
+	if( libqcow_extent_index_finalize_level2_table(
+	     internal_file->extent_index,
+	     level1_table_index,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to finalize level 2 table: %d in extent index.",
+		 function,
+		 level1_table_index );
+
+		return( -1 );
+	}
+	return( 1 );
+}
+
+/* Indexes the cluster blocks of all level 2 tables that have not been indexed before
+ * The indexing is stopped when the file is signalled to abort after the abort generation
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_internal_file_index_level2_tables(
+     libqcow_internal_file_t *internal_file,
+     libbfio_handle_t *file_io_handle,
+     uint32_t abort_generation,
+     libcerror_error_t **error )
+{
+	libqcow_cluster_table_t *level2_table = NULL;
+	static char *function                 = "libqcow_internal_file_index_level2_tables";
+	off64_t element_data_offset           = 0;
+	uint64_t level2_table_offset          = 0;
+	int level1_table_index                = 0;
+	int number_of_level2_tables           = 0;
+	int result                            = 0;
+
+	if( internal_file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	if( internal_file->extent_index == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid file - missing extent index.",
+		 function );
+
+		return( -1 );
+	}
+	if( libqcow_cluster_table_get_number_of_references(
+	     internal_file->level1_table,
+	     &number_of_level2_tables,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+		 "%s: unable to retrieve number of level 1 table references.",
+		 function );
+
+		return( -1 );
+	}
+	for( level1_table_index = 0;
+	     level1_table_index < number_of_level2_tables;
+	     level1_table_index++ )
+	{
+		result = libqcow_internal_file_read_is_stopped(
+		          internal_file,
+		          NULL,
+		          abort_generation,
+		          error );
+
+		if( result == -1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+			 "%s: unable to determine if read is stopped.",
+			 function );
+
+			return( -1 );
+		}
+		else if( result != 0 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_ABORT_REQUESTED,
+			 "%s: abort requested.",
+			 function );
+
+			return( -1 );
+		}
+		result = libqcow_extent_index_is_level2_table_scanned(
+		          internal_file->extent_index,
+		          level1_table_index,
+		          error );
+
+		if( result == -1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+			 "%s: unable to determine if level 2 table: %d was scanned.",
+			 function,
+			 level1_table_index );
+
+			return( -1 );
+		}
+		else if( result != 0 )
+		{
+			continue;
+		}
+		if( libqcow_cluster_table_get_reference_by_index(
+		     internal_file->level1_table,
+		     level1_table_index,
+		     &level2_table_offset,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+			 "%s: unable to retrieve level 2 table offset: %d from level 1 table.",
+			 function,
+			 level1_table_index );
+
+			return( -1 );
+		}
+		level2_table_offset &= internal_file->offset_bit_mask;
+
+		/* A sparse level 2 table is not looked up in the extent index
+		 */
+		if( level2_table_offset == 0 )
+		{
+			continue;
+		}
+		if( libfdata_vector_get_element_value_at_offset(
+		     internal_file->level2_table_vector,
+		     (intptr_t *) file_io_handle,
+		     (libfdata_cache_t *) internal_file->level2_table_cache,
+		     (off64_t) level2_table_offset,
+		     &element_data_offset,
+		     (intptr_t **) &level2_table,
+		     0,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+			 "%s: unable to retrieve level2 table at offset: 0x%08" PRIx64 ".",
+			 function,
+			 level2_table_offset );
+
+			return( -1 );
+		}
+		if( libqcow_internal_file_index_level2_table(
+		     internal_file,
+		     level1_table_index,
+		     level2_table,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+			 "%s: unable to index level 2 table: %d.",
+			 function,
+			 level1_table_index );
+
+			return( -1 );
+		}
+	}
+	return( 1 );
+}
+
+/* Retrieves the cluster block values of a specific entry of a level 2 table
+ * The cluster block data size contains the number of bytes from the cluster block data offset
+ * that share the same allocation state
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_internal_file_get_level2_table_cluster_block_values(
+     libqcow_internal_file_t *internal_file,
+     libqcow_cluster_table_t *level2_table,
+     int level2_table_index,
+     uint64_t cluster_block_data_offset,
+     uint64_t *cluster_block_offset,
+     size_t *cluster_block_data_size,
+     uint32_t *cluster_block_flags,
+     libcerror_error_t **error )
+{
+	static char *function               = "libqcow_internal_file_get_level2_table_cluster_block_values";
+	size_t safe_cluster_block_data_size = 0;
+	uint64_t level2_table_reference     = 0;
+	uint64_t safe_cluster_block_offset  = 0;
+	uint64_t subcluster_bitmap          = 0;
+	uint32_t allocation_bitmap          = 0;
+	uint32_t safe_cluster_block_flags   = 0;
+	uint32_t subcluster_mask            = 0;
+	uint32_t zero_bitmap                = 0;
+	uint8_t subcluster_is_allocated     = 0;
+	uint8_t subcluster_is_zero          = 0;
+	int first_subcluster_index          = 0;
+	int subcluster_index                = 0;
+
+	if( internal_file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	if( cluster_block_data_offset >= internal_file->cluster_block_size )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid cluster block data offset value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	if( cluster_block_offset == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid cluster block offset.",
+		 function );
+
+		return( -1 );
+	}
+	if( cluster_block_data_size == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid cluster block data size.",
+		 function );
+
+		return( -1 );
+	}
+	if( cluster_block_flags == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid cluster block flags.",
+		 function );
+
+		return( -1 );
+	}
+	safe_cluster_block_data_size = (size_t) ( internal_file->cluster_block_size - cluster_block_data_offset );
+
+	if( libqcow_cluster_table_get_reference_by_index(
+	     level2_table,
+	     level2_table_index,
+	     &level2_table_reference,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+		 "%s: unable to retrieve level 2 table entry: %d.",
+		 function,
+		 level2_table_index );
+
+		return( -1 );
+	}
+#if defined( HAVE_DEBUG_OUTPUT )
+	if( libcnotify_verbose != 0 )
+	{
+		libcnotify_printf(
+		 "%s: table2 entry: %d\t\t: 0x%08" PRIx64 "\n",
+		 function,
+		 level2_table_index,
+		 level2_table_reference );
+	}
+#endif
+	if( libqcow_internal_file_get_cluster_block_values(
+	     internal_file,
+	     level2_table_reference,
+	     &safe_cluster_block_offset,
+	     &safe_cluster_block_flags,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+		 "%s: unable to retrieve cluster block values of level 2 table entry: %d.",
+		 function,
+		 level2_table_index );
+
+		return( -1 );
+	}
+	/* Compressed cluster blocks do not use the subcluster allocation bitmap
+	 */
+	if( ( internal_file->subcluster_size != 0 )
+	 && ( ( safe_cluster_block_flags & LIBQCOW_CLUSTER_BLOCK_FLAG_IS_COMPRESSED ) == 0 ) )
+	{
+		if( libqcow_cluster_table_get_subcluster_bitmap_by_index(
+		     level2_table,
+		     level2_table_index,
+		     &subcluster_bitmap,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+			 "%s: unable to retrieve subcluster allocation bitmap of level 2 table entry: %d.",
+			 function,
+			 level2_table_index );
+
+			return( -1 );
+		}
+		allocation_bitmap = (uint32_t) ( subcluster_bitmap & 0xffffffffUL );
+		zero_bitmap       = (uint32_t) ( subcluster_bitmap >> 32 );
+
+#if defined( HAVE_DEBUG_OUTPUT )
+		if( libcnotify_verbose != 0 )
+		{
+			libcnotify_printf(
+			 "%s: allocation bitmap	: 0x%08" PRIx32 "\n",
+			 function,
+			 allocation_bitmap );
+
+			libcnotify_printf(
+			 "%s: zero bitmap		: 0x%08" PRIx32 "\n",
+			 function,
+			 zero_bitmap );
+		}
+#endif
+		if( ( allocation_bitmap & zero_bitmap ) != 0 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+			 "%s: invalid subcluster allocation bitmap of level 2 table entry: %d - subcluster both allocated and zero.",
+			 function,
+			 level2_table_index );
+
+			return( -1 );
+		}
+		first_subcluster_index = (int) ( cluster_block_data_offset / internal_file->subcluster_size );
+
+		subcluster_mask         = (uint32_t) 1UL << first_subcluster_index;
+		subcluster_is_allocated = (uint8_t) ( ( allocation_bitmap & subcluster_mask ) != 0 );
+		subcluster_is_zero      = (uint8_t) ( ( zero_bitmap & subcluster_mask ) != 0 );
+
+		if( ( subcluster_is_allocated != 0 )
+		 && ( safe_cluster_block_offset == 0 )
+		 && ( ( safe_cluster_block_flags & LIBQCOW_CLUSTER_BLOCK_FLAG_IN_DATA_FILE ) == 0 ) )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+			 "%s: invalid level 2 table entry: %d - missing cluster block offset of allocated subcluster.",
+			 function,
+			 level2_table_index );
+
+			return( -1 );
+		}
+		/* Determine the number of consecutive subclusters with the same state
+		 */
+		for( subcluster_index = first_subcluster_index + 1;
+		     subcluster_index < LIBQCOW_NUMBER_OF_SUBCLUSTERS;
+		     subcluster_index++ )
+		{
+			subcluster_mask = (uint32_t) 1UL << subcluster_index;
+
+			if( ( (uint8_t) ( ( allocation_bitmap & subcluster_mask ) != 0 ) != subcluster_is_allocated )
+			 || ( (uint8_t) ( ( zero_bitmap & subcluster_mask ) != 0 ) != subcluster_is_zero ) )
+			{
+				break;
+			}
+		}
+		safe_cluster_block_data_size = (size_t) ( ( subcluster_index * internal_file->subcluster_size ) - cluster_block_data_offset );
+
+		/* Unallocated and zero subclusters are not read from the file
+		 */
+		if( subcluster_is_zero != 0 )
+		{
+			safe_cluster_block_offset = 0;
+			safe_cluster_block_flags &= ~( LIBQCOW_CLUSTER_BLOCK_FLAG_IN_DATA_FILE );
+			safe_cluster_block_flags |= LIBQCOW_CLUSTER_BLOCK_FLAG_IS_ZERO;
+		}
+		else if( subcluster_is_allocated == 0 )
+		{
+			safe_cluster_block_offset = 0;
+			safe_cluster_block_flags &= ~( LIBQCOW_CLUSTER_BLOCK_FLAG_IN_DATA_FILE );
+		}
+	}
+	*cluster_block_offset    = safe_cluster_block_offset;
+	*cluster_block_data_size = safe_cluster_block_data_size;
+	*cluster_block_flags     = safe_cluster_block_flags;
+
+	return( 1 );
+}
+
+/* Retrieves the cluster block offset for a specific offset from the memory mapped file
+ * The level 2 table is referenced in the memory mapped file instead of being read
+ * into the level 2 table cache. Since the memory mapped file does not change while
+ * the file is open, the lookup does not modify the file and does not require the
+ * read/write lock of the file
+ * The cluster block data size contains the number of bytes from the cluster block data offset
+ * that share the same allocation state
+ * Returns 1 if successful, 0 if the level 2 table cannot be referenced in the memory mapped file or -1 on error
+ */
+int libqcow_internal_file_get_mapped_cluster_block_offset(
+     libqcow_internal_file_t *internal_file,
+     libqcow_cluster_table_t *level1_table,
+     off64_t offset,
+     uint64_t *cluster_block_offset,
+     uint64_t *cluster_block_data_offset,
+     size_t *cluster_block_data_size,
+     uint32_t *cluster_block_flags,
+     libcerror_error_t **error )
+{
+	uint8_t *level2_table_data              = NULL;
+	static char *function                   = "libqcow_internal_file_get_mapped_cluster_block_offset";
+	uint64_t level1_table_index             = 0;
+	uint64_t level2_table_index             = 0;
+	uint64_t level2_table_offset            = 0;
+	uint64_t level2_table_reference         = 0;
+	uint64_t safe_cluster_block_data_offset = 0;
+	uint64_t safe_cluster_block_offset      = 0;
+	uint32_t safe_cluster_block_flags       = 0;
+	int result                              = 0;
+
+	if( internal_file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	if( internal_file->file_header == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid file - missing file header.",
+		 function );
+
+		return( -1 );
+	}
+	if( level1_table == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid level 1 table.",
+		 function );
+
+		return( -1 );
+	}
+	if( offset < 0 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid offset value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	if( cluster_block_offset == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid cluster block offset.",
+		 function );
+
+		return( -1 );
+	}
+	if( cluster_block_data_offset == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid cluster block data offset.",
+		 function );
+
+		return( -1 );
+	}
+	if( cluster_block_data_size == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid cluster block data size.",
+		 function );
+
+		return( -1 );
+	}
+	if( cluster_block_flags == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid cluster block flags.",
+		 function );
+
+		return( -1 );
+	}
+	/* Extended level 2 table entries and a raw external data file
+	 * are only looked up by libqcow_internal_file_get_cluster_block_offset
+	 */
+	if( ( internal_file->mapped_file == NULL )
+	 || ( internal_file->subcluster_size != 0 )
+	 || ( internal_file->data_file_is_raw != 0 ) )
+	{
+		return( 0 );
+	}
+	level1_table_index = offset >> internal_file->level1_index_bit_shift;
+
+	if( level1_table_index >= (uint64_t) level1_table->number_of_references )
+	{
+		return( 0 );
+	}
+	if( libqcow_cluster_table_get_reference_by_index(
+	     level1_table,
+	     (int) level1_table_index,
+	     &level2_table_offset,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+		 "%s: unable to retrieve level 2 table offset: %" PRIi64 " from level 1 table.",
+		 function,
+		 level1_table_index );
+
+		return( -1 );
+	}
+	level2_table_offset &= internal_file->offset_bit_mask;
+
+	/* If level2_table_offset is 0 the level 2 table is sparse
+	 */
+	if( level2_table_offset > 0 )
+	{
+		level2_table_index = ( offset >> internal_file->file_header->number_of_cluster_block_bits ) & internal_file->level2_index_bit_mask;
+
+		result = libqcow_mapped_file_get_data(
+		          internal_file->mapped_file,
+		          (off64_t) ( level2_table_offset + ( level2_table_index * 8 ) ),
+		          8,
+		          &level2_table_data,
+		          error );
+
+		if( result == -1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+			 "%s: unable to retrieve level 2 table entry: %" PRIu64 " data from mapped file.",
+			 function,
+			 level2_table_index );
+
+			return( -1 );
+		}
+		else if( result == 0 )
+		{
+			return( 0 );
+		}
+		byte_stream_copy_to_uint64_big_endian(
+		 level2_table_data,
+		 level2_table_reference );
+
+		if( libqcow_internal_file_get_cluster_block_values(
+		     internal_file,
+		     level2_table_reference,
+		     &safe_cluster_block_offset,
+		     &safe_cluster_block_flags,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+			 "%s: unable to retrieve cluster block values of level 2 table entry: %" PRIu64 ".",
+			 function,
+			 level2_table_index );
+
+			return( -1 );
+		}
+	}
+	safe_cluster_block_data_offset = (uint64_t) offset & internal_file->cluster_block_bit_mask;
+
+	*cluster_block_offset      = safe_cluster_block_offset;
+	*cluster_block_data_offset = safe_cluster_block_data_offset;
+	*cluster_block_data_size   = (size_t) ( internal_file->cluster_block_size - safe_cluster_block_data_offset );
+	*cluster_block_flags       = safe_cluster_block_flags;
+
+	return( 1 );
+}
+
+/* Publishes a level 2 table of the level 1 table of the file
+ * The level 2 table is copied, the copy does not change while the file is open
+ * and remains published until the file is closed. A level 2 table is not published
+ * when the published level 2 tables have reached their maximum size
+ * This function is not multi-thread safe acquire write lock before call
+ * Returns 1 if successful, 0 if the level 2 table was not published or -1 on error
+ */
+int libqcow_internal_file_publish_level2_table(
+     libqcow_internal_file_t *internal_file,
+     int level1_table_index,
+     libqcow_cluster_table_t *level2_table,
+     libcerror_error_t **error )
+{
+	libqcow_cluster_table_t *published_level2_table = NULL;
+	static char *function                           = "libqcow_internal_file_publish_level2_table";
+	size_t level2_table_size                        = 0;
+
+	if( internal_file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	if( internal_file->level1_table == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid file - missing level 1 table.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( level1_table_index < 0 )
+	 || ( level1_table_index >= internal_file->level1_table->number_of_references ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid level 1 table index value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	if( level2_table == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid level 2 table.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( internal_file->published_level2_tables != NULL )
+	 && ( internal_file->published_level2_tables[ level1_table_index ] != NULL ) )
+	{
+		return( 1 );
+	}
+	level2_table_size = sizeof( uint64_t ) * (size_t) level2_table->number_of_references;
+
+	if( level2_table->subcluster_bitmaps != NULL )
+	{
+		level2_table_size *= 2;
+	}
+	if( level2_table_size > ( LIBQCOW_MAXIMUM_PUBLISHED_LEVEL2_TABLES_SIZE - internal_file->published_level2_tables_size ) )
+	{
+		return( 0 );
+	}
+	if( internal_file->published_level2_tables == NULL )
+	{
+		internal_file->published_level2_tables = (libqcow_cluster_table_t **) memory_allocate(
+		                                                                       sizeof( libqcow_cluster_table_t * ) * internal_file->level1_table->number_of_references );
+
+		if( internal_file->published_level2_tables == NULL )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_MEMORY,
+			 LIBCERROR_MEMORY_ERROR_INSUFFICIENT,
+			 "%s: unable to create published level 2 tables.",
+			 function );
+
+			return( -1 );
+		}
+		if( memory_set(
+		     internal_file->published_level2_tables,
+		     0,
+		     sizeof( libqcow_cluster_table_t * ) * internal_file->level1_table->number_of_references ) == NULL )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_MEMORY,
+			 LIBCERROR_MEMORY_ERROR_SET_FAILED,
+			 "%s: unable to clear published level 2 tables.",
+			 function );
+
+			memory_free(
+			 internal_file->published_level2_tables );
+
+			internal_file->published_level2_tables = NULL;
+
+			return( -1 );
+		}
+	}
+	if( libqcow_cluster_table_clone(
+	     &published_level2_table,
+	     level2_table,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+		 "%s: unable to clone level 2 table: %d.",
+		 function,
+		 level1_table_index );
+
+		return( -1 );
+	}
+	internal_file->published_level2_tables[ level1_table_index ] = published_level2_table;
+	internal_file->published_level2_tables_size                 += level2_table_size;
+
+	return( 1 );
+}
+
+/* Frees the published level 2 tables
+ * This function is not multi-thread safe acquire write lock before call
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_internal_file_free_published_level2_tables(
+     libqcow_internal_file_t *internal_file,
+     libcerror_error_t **error )
+{
+	static char *function  = "libqcow_internal_file_free_published_level2_tables";
+	int level1_table_index = 0;
+	int result             = 1;
+
+	if( internal_file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	if( internal_file->published_level2_tables != NULL )
+	{
+		if( internal_file->level1_table != NULL )
+		{
+			for( level1_table_index = 0;
+			     level1_table_index < internal_file->level1_table->number_of_references;
+			     level1_table_index++ )
+			{
+				if( libqcow_cluster_table_free(
+				     &( internal_file->published_level2_tables[ level1_table_index ] ),
+				     error ) != 1 )
+				{
+					libcerror_error_set(
+					 error,
+					 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+					 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+					 "%s: unable to free published level 2 table: %d.",
+					 function,
+					 level1_table_index );
+
+					result = -1;
+				}
+			}
+		}
+		memory_free(
+		 internal_file->published_level2_tables );
+
+		internal_file->published_level2_tables = NULL;
+	}
+	internal_file->published_level2_tables_size = 0;
+
+	return( result );
+}
+
+/* Retrieves the cluster block offset for a specific offset without reading level 2 tables
+ * The level 2 table is referenced in the memory mapped file or, for the level 1 table of
+ * the file, retrieved from the published level 2 tables. The lookup does not modify the file
+ * and only requires the read/write lock of the file grabbed for reading
+ * The cluster block data size contains the number of bytes from the cluster block data offset
+ * that share the same allocation state
+ * Returns 1 if successful, 0 if the level 2 table is not available without being read or -1 on error
+ */
+int libqcow_internal_file_get_published_cluster_block_offset(
+     libqcow_internal_file_t *internal_file,
+     libqcow_cluster_table_t *level1_table,
+     off64_t offset,
+     uint64_t *cluster_block_offset,
+     uint64_t *cluster_block_data_offset,
+     size_t *cluster_block_data_size,
+     uint32_t *cluster_block_flags,
+     libcerror_error_t **error )
+{
+	libqcow_cluster_table_t *level2_table   = NULL;
+	static char *function                   = "libqcow_internal_file_get_published_cluster_block_offset";
+	size_t safe_cluster_block_data_size     = 0;
+	uint64_t level1_table_index             = 0;
+	uint64_t level2_table_index             = 0;
+	uint64_t level2_table_offset            = 0;
+	uint64_t safe_cluster_block_data_offset = 0;
+	uint64_t safe_cluster_block_offset      = 0;
+	uint32_t safe_cluster_block_flags       = 0;
+	int result                              = 0;
+
+	if( internal_file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	if( internal_file->file_header == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid file - missing file header.",
+		 function );
+
+		return( -1 );
+	}
+	if( level1_table == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid level 1 table.",
+		 function );
+
+		return( -1 );
+	}
+	if( offset < 0 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid offset value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	if( cluster_block_offset == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid cluster block offset.",
+		 function );
+
+		return( -1 );
+	}
+	if( cluster_block_data_offset == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid cluster block data offset.",
+		 function );
+
+		return( -1 );
+	}
+	if( cluster_block_data_size == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid cluster block data size.",
+		 function );
+
+		return( -1 );
+	}
+	if( cluster_block_flags == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid cluster block flags.",
+		 function );
+
+		return( -1 );
+	}
+	/* A raw external data file is only looked up by libqcow_internal_file_get_cluster_block_offset
+	 */
+	if( internal_file->data_file_is_raw != 0 )
+	{
+		return( 0 );
+	}
+	result = libqcow_internal_file_get_mapped_cluster_block_offset(
+	          internal_file,
+	          level1_table,
+	          offset,
+	          cluster_block_offset,
+	          cluster_block_data_offset,
+	          cluster_block_data_size,
+	          cluster_block_flags,
+	          error );
+
+	if( result == -1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+		 "%s: unable to retrieve cluster block offset from mapped file.",
+		 function );
+
+		return( -1 );
+	}
+	else if( result != 0 )
+	{
+		return( 1 );
+	}
+	if( level1_table != internal_file->level1_table )
+	{
+		return( 0 );
+	}
+	level1_table_index = offset >> internal_file->level1_index_bit_shift;
+
+	if( level1_table_index >= (uint64_t) level1_table->number_of_references )
+	{
+		return( 0 );
+	}
+	if( libqcow_cluster_table_get_reference_by_index(
+	     level1_table,
+	     (int) level1_table_index,
+	     &level2_table_offset,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+		 "%s: unable to retrieve level 2 table offset: %" PRIi64 " from level 1 table.",
+		 function,
+		 level1_table_index );
+
+		return( -1 );
+	}
+	level2_table_offset &= internal_file->offset_bit_mask;
+
+	safe_cluster_block_data_offset = (uint64_t) offset & internal_file->cluster_block_bit_mask;
+	safe_cluster_block_data_size   = (size_t) ( internal_file->cluster_block_size - safe_cluster_block_data_offset );
+
+	/* If level2_table_offset is 0 the level 2 table is sparse
+	 */
+	if( level2_table_offset > 0 )
+	{
+		if( internal_file->published_level2_tables == NULL )
+		{
+			return( 0 );
+		}
+		level2_table = internal_file->published_level2_tables[ level1_table_index ];
+
+		if( level2_table == NULL )
+		{
+			return( 0 );
+		}
+		level2_table_index = ( offset >> internal_file->file_header->number_of_cluster_block_bits ) & internal_file->level2_index_bit_mask;
+
+		if( libqcow_internal_file_get_level2_table_cluster_block_values(
+		     internal_file,
+		     level2_table,
+		     (int) level2_table_index,
+		     safe_cluster_block_data_offset,
+		     &safe_cluster_block_offset,
+		     &safe_cluster_block_data_size,
+		     &safe_cluster_block_flags,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+			 "%s: unable to retrieve cluster block values of level 2 table entry: %" PRIu64 ".",
+			 function,
+			 level2_table_index );
+
+			return( -1 );
+		}
+	}
+	*cluster_block_offset      = safe_cluster_block_offset;
+	*cluster_block_data_offset = safe_cluster_block_data_offset;
+	*cluster_block_data_size   = safe_cluster_block_data_size;
+	*cluster_block_flags       = safe_cluster_block_flags;
+
+	return( 1 );
+}
+
+/* Retrieves the cluster block offset for a specific offset
+ * The level 1 table is either the level 1 table of the file or that of a snapshot,
+ * the extent index is only used for the level 1 table of the file
+ * The cluster block data size contains the number of bytes from the cluster block data offset
+ * that share the same allocation state
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_internal_file_get_cluster_block_offset(
+     libqcow_internal_file_t *internal_file,
+     libbfio_handle_t *file_io_handle,
+     libqcow_cluster_table_t *level1_table,
+     off64_t offset,
+     uint64_t *cluster_block_offset,
+     uint64_t *cluster_block_data_offset,
+     size_t *cluster_block_data_size,
+     uint32_t *cluster_block_flags,
+     libcerror_error_t **error )
+{
+	libqcow_cluster_table_t *level2_table   = NULL;
+	libqcow_extent_index_t *extent_index    = NULL;
+	static char *function                   = "libqcow_internal_file_get_cluster_block_offset";
+	off64_t element_data_offset             = 0;
+	size_t safe_cluster_block_data_size     = 0;
+	uint64_t level1_table_index             = 0;
+	uint64_t level2_table_index             = 0;
+	uint64_t level2_table_offset            = 0;
+	uint64_t safe_cluster_block_data_offset = 0;
+	uint64_t safe_cluster_block_offset      = 0;
+	uint32_t safe_cluster_block_flags       = 0;
+	int result                              = 0;
+
+	if( internal_file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	if( internal_file->file_header == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid file - missing file header.",
+		 function );
+
+		return( -1 );
+	}
+	if( level1_table == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid level 1 table.",
+		 function );
+
+		return( -1 );
+	}
+	if( offset < 0 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid offset value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	if( cluster_block_offset == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid cluster block offset.",
+		 function );
+
+		return( -1 );
+	}
+	if( cluster_block_data_offset == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid cluster block data offset.",
+		 function );
+
+		return( -1 );
+	}
+	if( cluster_block_data_size == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid cluster block data size.",
+		 function );
+
+		return( -1 );
+	}
+	if( cluster_block_flags == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid cluster block flags.",
+		 function );
+
+		return( -1 );
+	}
+	safe_cluster_block_data_offset = (uint64_t) offset & internal_file->cluster_block_bit_mask;
+	safe_cluster_block_data_size   = (size_t) ( internal_file->cluster_block_size - safe_cluster_block_data_offset );
+
+	/* A raw external data file contains the guest data at the same offsets
+	 * hence the level 1 and 2 tables do not need to be consulted, data beyond
+	 * the end of the data file is read as zero bytes
+	 */
+	if( internal_file->data_file_is_raw != 0 )
+	{
+		if( (size64_t) offset < internal_file->data_file_size )
+		{
+			if( (size64_t) safe_cluster_block_data_size > ( internal_file->data_file_size - offset ) )
+			{
+				safe_cluster_block_data_size = (size_t) ( internal_file->data_file_size - offset );
+			}
+			*cluster_block_offset = (uint64_t) offset - safe_cluster_block_data_offset;
+			*cluster_block_flags  = LIBQCOW_CLUSTER_BLOCK_FLAG_IN_DATA_FILE;
+		}
+		else
+		{
+			*cluster_block_offset = 0;
+			*cluster_block_flags  = LIBQCOW_CLUSTER_BLOCK_FLAG_IS_ZERO;
+		}
+		*cluster_block_data_offset = safe_cluster_block_data_offset;
+		*cluster_block_data_size   = safe_cluster_block_data_size;
+
+		return( 1 );
+	}
+	/* The level 2 tables in a memory mapped file are referenced in place and
+	 * the published level 2 tables are used instead of the level 2 table cache
+	 */
+	result = libqcow_internal_file_get_published_cluster_block_offset(
+	          internal_file,
+	          level1_table,
+	          offset,
+	          cluster_block_offset,
+	          cluster_block_data_offset,
+	          cluster_block_data_size,
+	          cluster_block_flags,
+	          error );
+
+	if( result == -1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+		 "%s: unable to retrieve published cluster block offset.",
+		 function );
+
+		return( -1 );
+	}
+	else if( result != 0 )
+	{
+		return( 1 );
+	}
+	if( level1_table == internal_file->level1_table )
+	{
+		extent_index = internal_file->extent_index;
+	}
+	level1_table_index = offset >> internal_file->level1_index_bit_shift;
+
+#if defined( HAVE_DEBUG_OUTPUT )
+	if( libcnotify_verbose != 0 )
+	{
+		libcnotify_printf(
+		 "%s: level 1 table index\t: %" PRIu64 "\n",
+		 function,
+		 level1_table_index );
+	}
+#endif
+	if( level1_table_index > (uint64_t) INT_MAX )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid level 1 table index value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	if( libqcow_cluster_table_get_reference_by_index(
+	     level1_table,
+	     (int) level1_table_index,
+	     &level2_table_offset,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+		 "%s: unable to retrieve level 2 table offset: %" PRIi64 " from level 1 table.",
+		 function,
+		 level1_table_index );
+
+		return( -1 );
+	}
+#if defined( HAVE_DEBUG_OUTPUT )
+	if( libcnotify_verbose != 0 )
+	{
+		libcnotify_printf(
+		 "%s: level 2 table offset\t: 0x%08" PRIx64 "\n",
+		 function,
+		 level2_table_offset );
+
+		libcnotify_printf(
+		 "\n" );
+	}
+#endif
+	level2_table_offset &= internal_file->offset_bit_mask;
+
+	/* If level2_table_offset is 0 the level 2 table is sparse
+	 */
+	if( level2_table_offset > 0 )
+	{
+		level2_table_index = ( offset >> internal_file->file_header->number_of_cluster_block_bits ) & internal_file->level2_index_bit_mask;
+
+#if defined( HAVE_DEBUG_OUTPUT )
+		if( libcnotify_verbose != 0 )
+		{
+			libcnotify_printf(
+			 "%s: level 2 table index\t: %" PRIu64 "\n",
+			 function,
+			 level2_table_index );
+		}
+#endif
+		if( level2_table_index > (uint64_t) INT_MAX )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+			 "%s: invalid level 2 table index value out of bounds.",
+			 function );
+
+			return( -1 );
+		}
+		if( extent_index != NULL )
+		{
+			result = libqcow_extent_index_get_cluster_block_by_index(
+			          extent_index,
+			          (int) level1_table_index,
+			          (int) level2_table_index,
+			          &safe_cluster_block_offset,
+			          &safe_cluster_block_flags,
+			          error );
+
+			if( result == -1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+				 "%s: unable to retrieve cluster block: %" PRIu64 " of level 2 table: %" PRIu64 " from extent index.",
+				 function,
+				 level2_table_index,
+				 level1_table_index );
+
+				return( -1 );
+			}
+		}
+		/* Fall back to the level 2 table if the level 2 table is not (yet) indexed
+		 */
+		if( result == 0 )
+		{
+			if( libfdata_vector_get_element_value_at_offset(
+			     internal_file->level2_table_vector,
+			     (intptr_t *) file_io_handle,
+			     (libfdata_cache_t *) internal_file->level2_table_cache,
+			     (off64_t) level2_table_offset,
+			     &element_data_offset,
+			     (intptr_t **) &level2_table,
+			     0,
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+				 "%s: unable to retrieve level2 table at offset: 0x%08" PRIx64 ".",
+				 function,
+				 level2_table_offset );
+
+				return( -1 );
+			}
+			/* Publish the level 2 table so that subsequent lookups only require the read lock
+			 */
+			if( level1_table == internal_file->level1_table )
+			{
+				if( libqcow_internal_file_publish_level2_table(
+				     internal_file,
+				     (int) level1_table_index,
+				     level2_table,
+				     error ) == -1 )
+				{
+					libcerror_error_set(
+					 error,
+					 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+					 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+					 "%s: unable to publish level 2 table: %" PRIu64 ".",
+					 function,
+					 level1_table_index );
+
+					return( -1 );
+				}
+			}
+			if( extent_index != NULL )
+			{
+				result = libqcow_extent_index_is_level2_table_scanned(
+				          extent_index,
+				          (int) level1_table_index,
+				          error );
+
+				if( result == -1 )
+				{
+					libcerror_error_set(
+					 error,
+					 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+					 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+					 "%s: unable to determine if level 2 table: %" PRIu64 " was scanned.",
+					 function,
+					 level1_table_index );
+
+					return( -1 );
+				}
+				else if( result == 0 )
+				{
+					if( libqcow_internal_file_index_level2_table(
+					     internal_file,
+					     (int) level1_table_index,
+					     level2_table,
+					     error ) != 1 )
+					{
+						libcerror_error_set(
+						 error,
+						 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+						 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+						 "%s: unable to index level 2 table: %" PRIu64 ".",
+						 function,
+						 level1_table_index );
+
+						return( -1 );
+					}
+				}
+			}
+			if( libqcow_internal_file_get_level2_table_cluster_block_values(
+			     internal_file,
+			     level2_table,
+			     (int) level2_table_index,
+			     safe_cluster_block_data_offset,
+			     &safe_cluster_block_offset,
+			     &safe_cluster_block_data_size,
+			     &safe_cluster_block_flags,
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+				 "%s: unable to retrieve cluster block values of level 2 table entry: %" PRIu64 ".",
+				 function,
+				 level2_table_index );
+
+				return( -1 );
+			}
+		}
+	}
+#if defined( HAVE_DEBUG_OUTPUT )
+	if( libcnotify_verbose != 0 )
+	{
+		libcnotify_printf(
+		 "%s: cluster block offset\t: %" PRIi64 " (0x%08" PRIx64 ")\n",
+		 function,
+		 safe_cluster_block_offset,
+		 safe_cluster_block_offset );
+
+		if( ( safe_cluster_block_flags & LIBQCOW_CLUSTER_BLOCK_FLAG_IS_COMPRESSED ) != 0 )
+		{
+			libcnotify_printf(
+			 "%s: is compressed\n",
+			 function );
+		}
+		if( ( safe_cluster_block_flags & LIBQCOW_CLUSTER_BLOCK_FLAG_IS_SPARSE ) != 0 )
+		{
+			libcnotify_printf(
+			 "%s: is sparse\n",
+			 function );
+		}
+		if( ( safe_cluster_block_flags & LIBQCOW_CLUSTER_BLOCK_FLAG_IS_ZERO ) != 0 )
+		{
+			libcnotify_printf(
+			 "%s: is zero\n",
+			 function );
+		}
+		libcnotify_printf(
+		 "\n" );
+	}
+#endif
+	*cluster_block_offset      = safe_cluster_block_offset;
+	*cluster_block_data_offset = safe_cluster_block_data_offset;
+	*cluster_block_data_size   = safe_cluster_block_data_size;
+	*cluster_block_flags       = safe_cluster_block_flags;
+
+	return( 1 );
+}
+
+/* Retrieves the range of the compressed data of a compressed cluster block
+ * The cluster block offset contains the compressed data offset and size as stored
+ * in the level 2 table, the compressed data size is kept within the bounds of
+ * the cluster block size and the size of the file
+ * The values used do not change while the file is open, hence this function
+ * does not require the read/write lock of the file
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_internal_file_get_compressed_cluster_block_range(
+     libqcow_internal_file_t *internal_file,
+     uint64_t cluster_block_offset,
+     uint64_t *compressed_data_offset,
+     size_t *compressed_data_size,
+     libcerror_error_t **error )
+{
+	static char *function                        = "libqcow_internal_file_get_compressed_cluster_block_range";
+	size_t safe_compressed_data_size             = 0;
+	uint64_t compressed_cluster_block_end_offset = 0;
+	uint64_t safe_compressed_data_offset         = 0;
+
+	if( internal_file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	if( internal_file->file_header == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid file - missing file header.",
+		 function );
+
+		return( -1 );
+	}
+	if( internal_file->cluster_block_size == 0 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid file - cluster block size value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	if( compressed_data_offset == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid compressed data offset.",
+		 function );
+
+		return( -1 );
+	}
+	if( compressed_data_size == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid compressed data size.",
+		 function );
+
+		return( -1 );
+	}
+	safe_compressed_data_size   = (size_t) ( cluster_block_offset >> internal_file->compression_bit_shift );
+	safe_compressed_data_offset = cluster_block_offset & internal_file->compression_bit_mask;
+
+	if( ( internal_file->file_header->format_version == 2 )
+	 || ( internal_file->file_header->format_version == 3 ) )
+	{
+		safe_compressed_data_size += 1;
+		safe_compressed_data_size *= 512;
+
+		/* Make sure the compressed block size stays within the bounds
+		 * of the cluster block size and the size of the file
+		 */
+		compressed_cluster_block_end_offset = safe_compressed_data_offset / internal_file->cluster_block_size;
+
+		if( ( safe_compressed_data_offset % internal_file->cluster_block_size ) != 0 )
+		{
+			compressed_cluster_block_end_offset += 1;
+		}
+		compressed_cluster_block_end_offset += 1;
+		compressed_cluster_block_end_offset *= internal_file->cluster_block_size;
+
+		if( compressed_cluster_block_end_offset > internal_file->size )
+		{
+			compressed_cluster_block_end_offset = internal_file->size;
+		}
+		if( ( safe_compressed_data_offset + safe_compressed_data_size ) > compressed_cluster_block_end_offset )
+		{
+			safe_compressed_data_size = (size_t) ( compressed_cluster_block_end_offset - safe_compressed_data_offset );
+		}
+	}
+	*compressed_data_offset = safe_compressed_data_offset;
+	*compressed_data_size   = safe_compressed_data_size;
+
+	return( 1 );
+}
+
+/* Decodes the data of a cluster block
+ * The data is decompressed or decrypted by decode jobs on the scheduler, if any, where
+ * the data of an encrypted cluster block is divided into a job per thread, otherwise
+ * the data is decoded by the calling thread. The offset is the (media) offset of
+ * the decrypted data, from which the block keys are derived
+ * The decode does not modify the file and does not require the read/write lock of the file
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_internal_file_decode_data(
+     libqcow_internal_file_t *internal_file,
+     libqcow_scheduler_t *scheduler,
+     uint8_t decode_type,
+     const uint8_t *data,
+     size_t data_size,
+     uint8_t *buffer,
+     size_t buffer_size,
+     off64_t offset,
+     libcerror_error_t **error )
+{
+	static char *function                      = "libqcow_internal_file_decode_data";
+	size_t decompressed_data_size              = 0;
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	libqcow_decode_job_t *decode_job           = NULL;
+	libqcow_decode_job_t *decode_jobs          = NULL;
+	libqcow_scheduler_batch_t *scheduler_batch = NULL;
+	size_t data_offset                         = 0;
+	size_t part_size                           = 0;
+	int number_of_threads                      = 0;
+#endif
+
+	if( internal_file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( decode_type != LIBQCOW_DECODE_JOB_TYPE_DECOMPRESS )
+	 && ( decode_type != LIBQCOW_DECODE_JOB_TYPE_DECRYPT ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_UNSUPPORTED_VALUE,
+		 "%s: unsupported decode type.",
+		 function );
+
+		return( -1 );
+	}
+	if( data == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid data.",
+		 function );
+
+		return( -1 );
+	}
+	if( buffer == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid buffer.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( decode_type == LIBQCOW_DECODE_JOB_TYPE_DECRYPT )
+	 && ( data_size != buffer_size ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid buffer size value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( ( scheduler != NULL )
+	 && ( internal_file->decode_scheduler_queue != NULL ) )
+	{
+		if( libqcow_scheduler_get_number_of_threads(
+		     scheduler,
+		     &number_of_threads,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+			 "%s: unable to retrieve number of threads of scheduler.",
+			 function );
+
+			goto on_error;
+		}
+		/* The data is decrypted per sector of 512 bytes, hence the parts consist of whole sectors
+		 */
+		part_size = data_size;
+
+		if( ( decode_type == LIBQCOW_DECODE_JOB_TYPE_DECRYPT )
+		 && ( number_of_threads > 1 ) )
+		{
+			part_size = data_size / (size_t) number_of_threads;
+
+			if( ( part_size % 512 ) != 0 )
+			{
+				part_size += 512 - ( part_size % 512 );
+			}
+			if( part_size < LIBQCOW_DECODE_JOB_MINIMUM_DECRYPT_SIZE )
+			{
+				part_size = LIBQCOW_DECODE_JOB_MINIMUM_DECRYPT_SIZE;
+			}
+		}
+		if( libqcow_scheduler_batch_initialize(
+		     &scheduler_batch,
+		     scheduler,
+		     internal_file->decode_scheduler_queue,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+			 "%s: unable to create scheduler batch.",
+			 function );
+
+			goto on_error;
+		}
+		do
+		{
+			if( libqcow_decode_job_initialize(
+			     &decode_job,
+			     (libqcow_file_t *) internal_file,
+			     decode_type,
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+				 "%s: unable to create decode job.",
+				 function );
+
+				goto on_error;
+			}
+			decode_job->data        = &( data[ data_offset ] );
+			decode_job->data_size   = data_size - data_offset;
+			decode_job->buffer      = &( buffer[ data_offset ] );
+			decode_job->buffer_size = buffer_size - data_offset;
+			decode_job->offset      = offset + (off64_t) data_offset;
+
+			if( decode_job->data_size > part_size )
+			{
+				decode_job->data_size   = part_size;
+				decode_job->buffer_size = part_size;
+			}
+			decode_job->next_decode_job = decode_jobs;
+			decode_jobs                 = decode_job;
+
+			data_offset += decode_job->data_size;
+
+			decode_job = NULL;
+
+			if( libqcow_scheduler_batch_push_job(
+			     scheduler_batch,
+			     (int (*)(intptr_t *, void *)) &libqcow_decode_job_callback,
+			     (intptr_t *) decode_jobs,
+			     NULL,
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_APPEND_FAILED,
+				 "%s: unable to push decode job.",
+				 function );
+
+				goto on_error;
+			}
+		}
+		while( data_offset < data_size );
+
+		if( libqcow_internal_file_wait_for_decode_jobs(
+		     internal_file,
+		     scheduler_batch,
+		     &decode_jobs,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+			 "%s: unable to decode data.",
+			 function );
+
+			goto on_error;
+		}
+		if( libqcow_scheduler_batch_free(
+		     &scheduler_batch,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+			 "%s: unable to free scheduler batch.",
+			 function );
+
+			goto on_error;
+		}
+		return( 1 );
+	}
+#endif
+	if( decode_type == LIBQCOW_DECODE_JOB_TYPE_DECOMPRESS )
+	{
+		decompressed_data_size = buffer_size;
+
+		if( libqcow_decompress_data(
+		     data,
+		     data_size,
+		     LIBQCOW_COMPRESSION_METHOD_DEFLATE,
+		     buffer,
+		     &decompressed_data_size,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_ENCRYPTION,
+			 LIBCERROR_ENCRYPTION_ERROR_GENERIC,
+			 "%s: unable to decompress data.",
+			 function );
+
+			goto on_error;
+		}
+	}
+	else
+	{
+		if( libqcow_encryption_crypt(
+		     internal_file->encryption_context,
+		     LIBQCOW_ENCYPTION_CRYPT_MODE_DECRYPT,
+		     data,
+		     data_size,
+		     buffer,
+		     buffer_size,
+		     (uint64_t) offset / 512,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_ENCRYPTION,
+			 LIBCERROR_ENCRYPTION_ERROR_GENERIC,
+			 "%s: unable to decrypt data.",
+			 function );
+
+			goto on_error;
+		}
+	}
+	return( 1 );
+
+on_error:
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	/* The batch waits for the jobs that were pushed before the jobs are freed
+	 */
+	if( scheduler_batch != NULL )
+	{
+		if( libqcow_scheduler_batch_free(
+		     &scheduler_batch,
+		     NULL ) != 1 )
+		{
+			return( -1 );
+		}
+	}
+	while( decode_jobs != NULL )
+	{
+		decode_job  = decode_jobs;
+		decode_jobs = decode_job->next_decode_job;
+
+		libqcow_decode_job_free(
+		 &decode_job,
+		 NULL );
+	}
+#endif
+	return( -1 );
+}
+
+/* Waits for the decode jobs of a batch to complete and frees the decode jobs
+ * The jobs of the batch that are still queued are run by the calling thread
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_internal_file_wait_for_decode_jobs(
+     libqcow_internal_file_t *internal_file,
+     libqcow_scheduler_batch_t *scheduler_batch,
+     libqcow_decode_job_t **decode_jobs,
+     libcerror_error_t **error )
+{
+	libcerror_error_t *decode_error  = NULL;
+	libqcow_decode_job_t *decode_job = NULL;
+	static char *function            = "libqcow_internal_file_wait_for_decode_jobs";
+	int result                       = 0;
+
+	if( internal_file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	if( decode_jobs == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid decode jobs.",
+		 function );
+
+		return( -1 );
+	}
+	result = libqcow_scheduler_batch_wait(
+	          scheduler_batch,
+	          error );
+
+	if( result == -1 )
+	{
+		/* The decode jobs cannot be freed when it is unknown if they have completed
+		 */
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+		 "%s: unable to wait for scheduler batch.",
+		 function );
+
+		return( -1 );
+	}
+	while( *decode_jobs != NULL )
+	{
+		decode_job   = *decode_jobs;
+		*decode_jobs = decode_job->next_decode_job;
+
+		if( ( decode_error == NULL )
+		 && ( decode_job->decode_error != NULL ) )
+		{
+			decode_error = decode_job->decode_error;
+
+			decode_job->decode_error = NULL;
+		}
+		if( libqcow_decode_job_free(
+		     &decode_job,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+			 "%s: unable to free decode job.",
+			 function );
+
+			result = -1;
+		}
+	}
+	if( result != 1 )
+	{
+		if( ( error != NULL )
+		 && ( *error == NULL ) )
+		{
+			*error = decode_error;
+
+			decode_error = NULL;
+		}
+		if( decode_error != NULL )
+		{
+			libcerror_error_free(
+			 &decode_error );
+		}
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_GENERIC,
+		 "%s: one or more decode jobs failed.",
+		 function );
+
+		return( -1 );
+	}
+	if( decode_error != NULL )
+	{
+		libcerror_error_free(
+		 &decode_error );
+	}
+	return( 1 );
+}
+
+/* Reads and decompresses a compressed cluster block
+ * The decompression does not modify the file and does not require the read/write lock
+ * of the file when a file IO handle of the file IO pool is used
+ * The data is decompressed by a decode job on the scheduler, if any
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_internal_file_decompress_cluster_block(
+     libqcow_internal_file_t *internal_file,
+     libbfio_handle_t *file_io_handle,
+     libqcow_scheduler_t *scheduler,
+     uint64_t compressed_data_offset,
+     size_t compressed_data_size,
+     libqcow_cluster_block_t **cluster_block,
+     libcerror_error_t **error )
+{
+	libqcow_cluster_block_t *safe_cluster_block = NULL;
+	static char *function                       = "libqcow_internal_file_decompress_cluster_block";
+
+	if( internal_file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( internal_file->cluster_block_size == 0 )
+	 || ( internal_file->cluster_block_size > (size64_t) MEMORY_MAXIMUM_ALLOCATION_SIZE ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid file - cluster block size value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	if( cluster_block == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid cluster block.",
+		 function );
+
+		return( -1 );
+	}
+	if( libqcow_cluster_block_initialize(
+	     &safe_cluster_block,
+	     compressed_data_size,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+		 "%s: unable to create cluster block.",
+		 function );
+
+		goto on_error;
+	}
+	if( libqcow_cluster_block_read(
+	     safe_cluster_block,
+	     file_io_handle,
+	     compressed_data_offset,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_IO,
+		 LIBCERROR_IO_ERROR_READ_FAILED,
+		 "%s: unable to read cluster block at offset: %" PRIi64 " (0x%08" PRIx64 ").",
+		 function,
+		 compressed_data_offset,
+		 compressed_data_offset );
+
+		goto on_error;
+	}
+	safe_cluster_block->compressed_data = safe_cluster_block->data;
+
+	safe_cluster_block->data = (uint8_t *) memory_allocate(
+	                                        sizeof( uint8_t ) * internal_file->cluster_block_size );
+
+	if( safe_cluster_block->data == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_INSUFFICIENT,
+		 "%s: unable to create cluster block data.",
+		 function );
+
+		goto on_error;
+	}
+	safe_cluster_block->data_size = internal_file->cluster_block_size;
+
+	if( libqcow_internal_file_decode_data(
+	     internal_file,
+	     scheduler,
+	     LIBQCOW_DECODE_JOB_TYPE_DECOMPRESS,
+	     safe_cluster_block->compressed_data,
+	     compressed_data_size,
+	     safe_cluster_block->data,
+	     safe_cluster_block->data_size,
+	     0,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ENCRYPTION,
+		 LIBCERROR_ENCRYPTION_ERROR_GENERIC,
+		 "%s: unable to decompress cluster block data at offset: %" PRIi64 " (0x%08" PRIx64 ").",
+		 function,
+		 compressed_data_offset,
+		 compressed_data_offset );
+
+		goto on_error;
+	}
+/* TODO check data_size
+	if( data_size != safe_cluster_block->data_size )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid cluster block size value out of bounds.",
+		 function );
+
+		goto on_error;
+	}
+*/
+	*cluster_block = safe_cluster_block;
+
+	return( 1 );
+
+on_error:
+	if( safe_cluster_block != NULL )
+	{
+		libqcow_cluster_block_free(
+		 &safe_cluster_block,
+		 NULL );
+	}
+	return( -1 );
+}
+
+/* Reads a cluster block
+ * The offset is the (media) offset of the data in the cluster block, from which
+ * the block key of an encrypted cluster block is derived
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_internal_file_read_cluster_block(
+     libqcow_internal_file_t *internal_file,
+     libbfio_handle_t *file_io_handle,
+     off64_t offset,
+     uint64_t cluster_block_offset,
+     uint64_t cluster_block_data_offset,
+     uint32_t cluster_block_flags,
+     libqcow_cluster_block_t **cluster_block,
+     libcerror_error_t **error )
+{
+	libbfio_handle_t *cluster_block_io_handle         = NULL;
+	libfcache_cache_t *cluster_block_cache            = NULL;
+	libfdata_vector_t *cluster_block_vector           = NULL;
+	libqcow_cluster_block_t *cache_pool_cluster_block = NULL;
+	libqcow_cluster_block_t *safe_cluster_block       = NULL;
+	static char *function                             = "libqcow_internal_file_read_cluster_block";
+	size64_t cluster_block_io_handle_size             = 0;
+	size_t cluster_block_size                         = 0;
+	size_t value_size                                 = 0;
+	off64_t element_data_offset                       = 0;
+	uint8_t is_loading                                = 0;
+	uint8_t use_cache_pool                            = 0;
+	uint8_t value_type                                = 0;
+	int cache_entry_index                             = 0;
+	int result                                        = 0;
+
+	if( internal_file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	if( internal_file->file_header == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid file - missing file header.",
+		 function );
+
+		return( -1 );
+	}
+	if( internal_file->cluster_block_size == 0 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid file - cluster block size value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	if( cluster_block == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid cluster block.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( cluster_block_flags & LIBQCOW_CLUSTER_BLOCK_FLAG_IN_DATA_FILE ) != 0 )
+	{
+		if( internal_file->data_file_io_handle == NULL )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+			 "%s: invalid file - missing data file IO handle.",
+			 function );
+
+			return( -1 );
+		}
+		if( cluster_block_offset >= internal_file->data_file_size )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+			 "%s: invalid cluster block offset value out of bounds.",
+			 function );
+
+			return( -1 );
+		}
+		cluster_block_io_handle      = internal_file->data_file_io_handle;
+		cluster_block_io_handle_size = internal_file->data_file_size;
+		cluster_block_vector         = internal_file->data_file_cluster_block_vector;
+	}
+	else
+	{
+		cluster_block_io_handle      = file_io_handle;
+		cluster_block_io_handle_size = internal_file->size;
+		cluster_block_vector         = internal_file->cluster_block_vector;
+	}
+	internal_file->number_of_cluster_block_reads += 1;
+
+	if( ( cluster_block_flags & LIBQCOW_CLUSTER_BLOCK_FLAG_IS_COMPRESSED ) != 0 )
+	{
+		/* Handle compressed cluster block
+		 */
+		if( libqcow_internal_file_get_compressed_cluster_block_range(
+		     internal_file,
+		     cluster_block_offset,
+		     &cluster_block_offset,
+		     &cluster_block_size,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+			 "%s: unable to retrieve compressed cluster block range.",
+			 function );
+
+			goto on_error;
+		}
+#if defined( HAVE_DEBUG_OUTPUT )
+		if( libcnotify_verbose != 0 )
+		{
+			libcnotify_printf(
+			 "%s: compressed cluster block offset\t\t: 0x%08" PRIx64 "\n",
+			 function,
+			 cluster_block_offset );
+
+			libcnotify_printf(
+			 "%s: compressed cluster block size\t\t: %" PRIzd "\n",
+			 function,
+			 cluster_block_size );
+		}
+#endif
+		cluster_block_cache = internal_file->compressed_cluster_block_cache;
+	}
+	else
+	{
+		/* For version 2 and 3 make sure the sure the last cluster block size
+		 * stays within the bounds of the size of the file
+		 */
+		if( ( ( internal_file->file_header->format_version == 2 )
+		  ||  ( internal_file->file_header->format_version == 3 ) )
+		 && ( ( cluster_block_offset + internal_file->cluster_block_size ) > cluster_block_io_handle_size ) )
+		{
+			cluster_block_size = (size_t) ( cluster_block_io_handle_size - cluster_block_offset );
+
+#if defined( HAVE_DEBUG_OUTPUT )
+			if( libcnotify_verbose != 0 )
+			{
+				libcnotify_printf(
+				 "%s: last cluster block offset\t\t: 0x%08" PRIx64 "\n",
+				 function,
+				 cluster_block_offset );
+
+				libcnotify_printf(
+				 "%s: last cluster block size\t\t\t: %" PRIzd "\n",
+				 function,
+				 cluster_block_size );
+			}
+#endif
+		}
+		cluster_block_cache = internal_file->cluster_block_cache;
+	}
+	/* The cache pool is not used for decrypted data, the external data file
+	 * and uncompressed cluster blocks that are not copied from a memory mapped file
+	 */
+	if( ( internal_file->cache_pool != NULL )
+	 && ( internal_file->file_identity_is_set != 0 )
+	 && ( internal_file->encryption_method == LIBQCOW_ENCRYPTION_METHOD_NONE )
+	 && ( ( cluster_block_flags & LIBQCOW_CLUSTER_BLOCK_FLAG_IN_DATA_FILE ) == 0 ) )
+	{
+		if( ( cluster_block_flags & LIBQCOW_CLUSTER_BLOCK_FLAG_IS_COMPRESSED ) != 0 )
+		{
+			use_cache_pool = 1;
+			value_type     = LIBQCOW_CACHE_POOL_VALUE_TYPE_COMPRESSED_CLUSTER_BLOCK;
+		}
+		else if( internal_file->mapped_file == NULL )
+		{
+			use_cache_pool = 1;
+			value_type     = LIBQCOW_CACHE_POOL_VALUE_TYPE_CLUSTER_BLOCK;
+		}
+	}
+	if( use_cache_pool != 0 )
+	{
+		/* Concurrent misses on the same cluster block, from another thread or another
+		 * file of the same base file, wait for a single load
+		 */
+		result = libqcow_cache_pool_get_cluster_block_or_begin_load(
+		          internal_file->cache_pool,
+		          &( internal_file->file_identity ),
+		          value_type,
+		          cluster_block_offset,
+		          &cache_pool_cluster_block,
+		          error );
+
+		if( result == -1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+			 "%s: unable to retrieve cluster block at offset: %" PRIi64 " (0x%08" PRIx64 ") from cache pool.",
+			 function,
+			 cluster_block_offset,
+			 cluster_block_offset );
+
+			goto on_error;
+		}
+		else if( result == 0 )
+		{
+			is_loading = 1;
+		}
+	}
+	if( cache_pool_cluster_block != NULL )
+	{
+		if( libqcow_internal_file_hold_cache_pool_cluster_block(
+		     internal_file,
+		     cache_pool_cluster_block,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+			 "%s: unable to hold cache pool cluster block.",
+			 function );
+
+			goto on_error;
+		}
+		*cluster_block = cache_pool_cluster_block;
+
+		cache_pool_cluster_block = NULL;
+	}
+	else if( ( cluster_block_size == 0 )
+	      && ( use_cache_pool == 0 ) )
+	{
+		if( libfdata_vector_get_element_value_at_offset(
+		     cluster_block_vector,
+		     (intptr_t *) cluster_block_io_handle,
+		     (libfdata_cache_t *) cluster_block_cache,
+		     (off64_t) cluster_block_offset,
+		     &element_data_offset,
+		     (intptr_t **) cluster_block,
+		     0,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+			 "%s: unable to retrieve cluster block at offset: %" PRIi64 " (0x%08" PRIx64 ").",
+			 function,
+			 cluster_block_offset,
+			 cluster_block_offset );
+
+			goto on_error;
+		}
+	}
+	else
+	{
+		if( ( cluster_block_flags & LIBQCOW_CLUSTER_BLOCK_FLAG_IS_COMPRESSED ) != 0 )
+		{
+			if( libqcow_internal_file_decompress_cluster_block(
+			     internal_file,
+			     cluster_block_io_handle,
+			     internal_file->scheduler,
+			     cluster_block_offset,
+			     cluster_block_size,
+			     &safe_cluster_block,
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_IO,
+				 LIBCERROR_IO_ERROR_READ_FAILED,
+				 "%s: unable to read compressed cluster block at offset: %" PRIi64 " (0x%08" PRIx64 ").",
+				 function,
+				 cluster_block_offset,
+				 cluster_block_offset );
+
+				goto on_error;
+			}
+		}
+		else
+		{
+			if( cluster_block_size == 0 )
+			{
+				cluster_block_size = (size_t) internal_file->cluster_block_size;
+			}
+			if( libqcow_cluster_block_initialize(
+			     &safe_cluster_block,
+			     cluster_block_size,
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+				 "%s: unable to create cluster block.",
+				 function );
+
+				goto on_error;
+			}
+			if( libqcow_cluster_block_read(
+			     safe_cluster_block,
+			     cluster_block_io_handle,
+			     cluster_block_offset,
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_IO,
+				 LIBCERROR_IO_ERROR_READ_FAILED,
+				 "%s: unable to read cluster block at offset: %" PRIi64 " (0x%08" PRIx64 ").",
+				 function,
+				 cluster_block_offset,
+				 cluster_block_offset );
+
+				goto on_error;
+			}
+		}
+		if( use_cache_pool != 0 )
+		{
+			value_size = cluster_block_size;
+
+			if( safe_cluster_block->compressed_data != NULL )
+			{
+				value_size += safe_cluster_block->data_size;
+			}
+			if( libqcow_cache_pool_set_cluster_block(
+			     internal_file->cache_pool,
+			     &( internal_file->file_identity ),
+			     value_type,
+			     cluster_block_offset,
+			     safe_cluster_block,
+			     value_size,
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+				 "%s: unable to set cluster block at offset: %" PRIi64 " (0x%08" PRIx64 ") in cache pool.",
+				 function,
+				 cluster_block_offset,
+				 cluster_block_offset );
+
+				goto on_error;
+			}
+			cache_pool_cluster_block = safe_cluster_block;
+			safe_cluster_block       = NULL;
+
+			is_loading = 0;
+
+			if( libqcow_cache_pool_end_load(
+			     internal_file->cache_pool,
+			     &( internal_file->file_identity ),
+			     value_type,
+			     cluster_block_offset,
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+				 "%s: unable to end load of cluster block at offset: %" PRIi64 " (0x%08" PRIx64 ") in cache pool.",
+				 function,
+				 cluster_block_offset,
+				 cluster_block_offset );
+
+				goto on_error;
+			}
+			if( libqcow_internal_file_hold_cache_pool_cluster_block(
+			     internal_file,
+			     cache_pool_cluster_block,
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+				 "%s: unable to hold cache pool cluster block.",
+				 function );
+
+				goto on_error;
+			}
+			*cluster_block = cache_pool_cluster_block;
+
+			cache_pool_cluster_block = NULL;
+		}
+		else
+		{
+			cache_entry_index = ( cluster_block_offset & internal_file->cluster_block_bit_mask ) % internal_file->maximum_cluster_block_cache_entries;
+
+			if( libfcache_cache_set_value_by_index(
+			     cluster_block_cache,
+			     cache_entry_index,
+			     0,
+			     cluster_block_offset,
+			     0,
+			     (intptr_t *) safe_cluster_block,
+			     (int (*)(intptr_t **, libcerror_error_t **)) &libqcow_cluster_block_free,
+			     LIBFCACHE_CACHE_VALUE_FLAG_MANAGED,
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+				 "%s: unable to set value in cache entry: %d.",
+				 function,
+				 cache_entry_index );
+
+				goto on_error;
+			}
+			*cluster_block = safe_cluster_block;
+
+			safe_cluster_block = NULL;
+		}
+	}
+	if( internal_file->encryption_method != LIBQCOW_ENCRYPTION_METHOD_NONE )
+	{
+		if( *cluster_block == NULL )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+			 "%s: missing cluster block.",
+			 function );
+
+			goto on_error;
+		}
+		if( ( *cluster_block )->encrypted_data == NULL )
+		{
+			( *cluster_block )->encrypted_data = ( *cluster_block )->data;
+
+			( *cluster_block )->data = (uint8_t *) memory_allocate(
+			                                        sizeof( uint8_t ) * ( *cluster_block )->data_size );
+
+			if( ( *cluster_block )->data == NULL )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_MEMORY,
+				 LIBCERROR_MEMORY_ERROR_INSUFFICIENT,
+				 "%s: unable to create cluster block data.",
+				 function );
+
+				goto on_error;
+			}
+			/* The block key is derived from the (media) offset of the cluster block
+			 */
+			if( libqcow_internal_file_decode_data(
+			     internal_file,
+			     internal_file->scheduler,
+			     LIBQCOW_DECODE_JOB_TYPE_DECRYPT,
+			     ( *cluster_block )->encrypted_data,
+			     ( *cluster_block )->data_size,
+			     ( *cluster_block )->data,
+			     ( *cluster_block )->data_size,
+			     offset - (off64_t) cluster_block_data_offset,
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_ENCRYPTION,
+				 LIBCERROR_ENCRYPTION_ERROR_GENERIC,
+				 "%s: unable to decrypt cluster block data.",
+				 function );
+
+				goto on_error;
+			}
+		}
+	}
+	return( 1 );
+
+on_error:
+	if( is_loading != 0 )
+	{
+		libqcow_cache_pool_end_load(
+		 internal_file->cache_pool,
+		 &( internal_file->file_identity ),
+		 value_type,
+		 cluster_block_offset,
+		 NULL );
+	}
+	if( cache_pool_cluster_block != NULL )
+	{
+		libqcow_cache_pool_unpin_cluster_block(
+		 internal_file->cache_pool,
+		 &cache_pool_cluster_block,
+		 NULL );
+	}
+	if( safe_cluster_block != NULL )
+	{
+		libqcow_cluster_block_free(
+		 &safe_cluster_block,
+		 NULL );
+	}
+	return( -1 );
+}
+
+/* Holds a cluster block of the cache pool
+ * The cluster block must be pinned, the file takes over the pin and unpins the cluster block
+ * it held before, the cluster block remains valid until the next cluster block is held
+ * or the file is closed
+ * This function is not multi-thread safe acquire write lock before call
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_internal_file_hold_cache_pool_cluster_block(
+     libqcow_internal_file_t *internal_file,
+     libqcow_cluster_block_t *cluster_block,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_internal_file_hold_cache_pool_cluster_block";
+
+	if( internal_file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	if( cluster_block == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid cluster block.",
+		 function );
+
+		return( -1 );
+	}
+	if( internal_file->cache_pool_cluster_block != NULL )
+	{
+		if( libqcow_cache_pool_unpin_cluster_block(
+		     internal_file->cache_pool,
+		     &( internal_file->cache_pool_cluster_block ),
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+			 "%s: unable to unpin cache pool cluster block.",
+			 function );
+
+			return( -1 );
+		}
+	}
+	internal_file->cache_pool_cluster_block = cluster_block;
+
+	return( 1 );
+}
+
+/* Reads (media) data at a specific offset into a buffer from a raw external data file
+ * The guest data is stored at the same offset in the data file, data beyond
+ * the end of the data file is read as zero bytes
+ * The current offset of the file is not changed
+ * This function is not multi-thread safe acquire write lock before call
+ * Returns the number of bytes read or -1 on error
+ */
+ssize_t libqcow_internal_file_read_buffer_from_raw_data_file(
+         libqcow_internal_file_t *internal_file,
+         void *buffer,
+         size_t buffer_size,
+         off64_t offset,
+         libcerror_error_t **error )
+{
+	static char *function = "libqcow_internal_file_read_buffer_from_raw_data_file";
+	size_t data_read_size = 0;
+	size_t read_size      = 0;
+	ssize_t read_count    = 0;
+
+	if( internal_file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	if( internal_file->file_header == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid file - missing file header.",
+		 function );
+
+		return( -1 );
+	}
+	if( internal_file->data_file_io_handle == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid file - missing data file IO handle.",
+		 function );
+
+		return( -1 );
+	}
+	if( buffer == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid buffer.",
+		 function );
+
+		return( -1 );
+	}
+	if( buffer_size > (size_t) SSIZE_MAX )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_EXCEEDS_MAXIMUM,
+		 "%s: invalid buffer size value exceeds maximum.",
+		 function );
+
+		return( -1 );
+	}
+	if( offset < 0 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_LESS_THAN_ZERO,
+		 "%s: invalid offset value less than zero.",
+		 function );
+
+		return( -1 );
+	}
+	if( (size64_t) offset >= internal_file->file_header->media_size )
+	{
+		return( 0 );
+	}
+	read_size = buffer_size;
+
+	if( (size64_t) read_size > ( internal_file->file_header->media_size - offset ) )
+	{
+		read_size = (size_t) ( internal_file->file_header->media_size - offset );
+	}
+	if( (size64_t) offset < internal_file->data_file_size )
+	{
+		data_read_size = read_size;
+
+		if( (size64_t) data_read_size > ( internal_file->data_file_size - offset ) )
+		{
+			data_read_size = (size_t) ( internal_file->data_file_size - offset );
+		}
+		read_count = libbfio_handle_read_buffer_at_offset(
+		              internal_file->data_file_io_handle,
+		              (uint8_t *) buffer,
+		              data_read_size,
+		              offset,
+		              error );
+
+		if( read_count != (ssize_t) data_read_size )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_IO,
+			 LIBCERROR_IO_ERROR_READ_FAILED,
+			 "%s: unable to read buffer from data file at offset: %" PRIi64 " (0x%08" PRIx64 ").",
+			 function,
+			 offset,
+			 offset );
+
+			return( -1 );
+		}
+	}
+	if( data_read_size < read_size )
+	{
+		if( memory_set(
+		     &( ( (uint8_t *) buffer )[ data_read_size ] ),
+		     0,
+		     read_size - data_read_size ) == NULL )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_MEMORY,
+			 LIBCERROR_MEMORY_ERROR_SET_FAILED,
+			 "%s: unable to set buffer.",
+			 function );
+
+			return( -1 );
+		}
+	}
+	return( (ssize_t) read_size );
+}
+
+/* Resolves the layer of the backing chain that contains the data at a specific offset
+ * Determines if the data at the offset is stored in the file or not, and
+ * reduces the size of the chain index entry to the range that has the same state
+ * This function is not multi-thread safe acquire write lock before call
+ * Returns 1 if resolved, 0 if the data is stored in the parent file or -1 on error
+ */
+int libqcow_internal_file_resolve_offset(
+     libqcow_internal_file_t *internal_file,
+     off64_t offset,
+     libqcow_chain_index_entry_t *chain_index_entry,
+     libcerror_error_t **error )
+{
+	static char *function              = "libqcow_internal_file_resolve_offset";
+	size_t cluster_block_data_size     = 0;
+	uint64_t cluster_block_data_offset = 0;
+	uint64_t cluster_block_file_offset = 0;
+	uint32_t cluster_block_flags       = 0;
+
+	if( internal_file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	if( internal_file->file_io_handle == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid file - missing file IO handle.",
+		 function );
+
+		return( -1 );
+	}
+	if( internal_file->file_header == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid file - missing file header.",
+		 function );
+
+		return( -1 );
+	}
+	if( offset < 0 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_LESS_THAN_ZERO,
+		 "%s: invalid offset value less than zero.",
+		 function );
+
+		return( -1 );
+	}
+	if( chain_index_entry == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid chain index entry.",
+		 function );
+
+		return( -1 );
+	}
+	/* Data beyond the end of the media is read as zero bytes
+	 */
+	if( (size64_t) offset >= internal_file->file_header->media_size )
+	{
+		chain_index_entry->file = NULL;
+
+		return( 1 );
+	}
+	if( chain_index_entry->size > ( internal_file->file_header->media_size - offset ) )
+	{
+		chain_index_entry->size = internal_file->file_header->media_size - offset;
+	}
+	if( ( internal_file->data_file_is_raw != 0 )
+	 && ( internal_file->encryption_method == LIBQCOW_ENCRYPTION_METHOD_NONE ) )
+	{
+		if( internal_file->data_file_io_handle == NULL )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+			 "%s: invalid file - missing data file.",
+			 function );
+
+			return( -1 );
+		}
+		/* The data of a raw external data file is read by the file itself
+		 */
+		chain_index_entry->file                      = (libqcow_file_t *) internal_file;
+		chain_index_entry->cluster_block_offset      = 0;
+		chain_index_entry->cluster_block_data_offset = 0;
+		chain_index_entry->cluster_block_flags       = LIBQCOW_CLUSTER_BLOCK_FLAG_IN_DATA_FILE;
+
+		return( 1 );
+	}
+	if( ( internal_file->backing_filename != NULL )
+	 && ( internal_file->parent_file == NULL ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid file - missing parent file.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( ( internal_file->file_header->incompatible_feature_flags & LIBQCOW_INCOMPATIBLE_FEATURE_FLAG_EXTERNAL_DATA_FILE ) != 0 )
+	 && ( internal_file->data_file_io_handle == NULL ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid file - missing data file.",
+		 function );
+
+		return( -1 );
+	}
+	if( libqcow_internal_file_get_cluster_block_offset(
+	     internal_file,
+	     internal_file->file_io_handle,
+	     internal_file->level1_table,
+	     offset,
+	     &cluster_block_file_offset,
+	     &cluster_block_data_offset,
+	     &cluster_block_data_size,
+	     &cluster_block_flags,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+		 "%s: unable to retrieve cluster block offset for offset: %" PRIi64 " (0x%08" PRIx64 ").",
+		 function,
+		 offset,
+		 offset );
+
+		return( -1 );
+	}
+	if( chain_index_entry->size > (size64_t) cluster_block_data_size )
+	{
+		chain_index_entry->size = (size64_t) cluster_block_data_size;
+	}
+	if( ( ( cluster_block_file_offset > 0 )
+	  || ( ( cluster_block_flags & LIBQCOW_CLUSTER_BLOCK_FLAG_IN_DATA_FILE ) != 0 ) )
+	 && ( ( cluster_block_flags & LIBQCOW_CLUSTER_BLOCK_FLAG_IS_SPARSE ) == 0 ) )
+	{
+		chain_index_entry->file                      = (libqcow_file_t *) internal_file;
+		chain_index_entry->cluster_block_offset      = cluster_block_file_offset;
+		chain_index_entry->cluster_block_data_offset = cluster_block_data_offset;
+		chain_index_entry->cluster_block_flags       = cluster_block_flags;
+
+		return( 1 );
+	}
+	if( ( internal_file->parent_file == NULL )
+	 || ( ( cluster_block_flags & LIBQCOW_CLUSTER_BLOCK_FLAG_IS_ZERO ) != 0 ) )
+	{
+		chain_index_entry->file = NULL;
+
+		return( 1 );
+	}
+	return( 0 );
+}
+
+/* Retrieves the layer of the backing chain that contains the data at a specific offset
+ * The layers below the file are walked once per range, after which the result is
+ * retrieved from the chain index
+ * This function is not multi-thread safe acquire write lock before call
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_internal_file_get_parent_chain_index_entry(
+     libqcow_internal_file_t *internal_file,
+     off64_t offset,
+     libqcow_chain_index_entry_t *chain_index_entry,
+     libcerror_error_t **error )
+{
+	libqcow_file_t *layer_file                   = NULL;
+	libqcow_internal_file_t *internal_layer_file = NULL;
+	static char *function                        = "libqcow_internal_file_get_parent_chain_index_entry";
+	int result                                   = 0;
+
+	if( internal_file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	if( internal_file->file_header == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid file - missing file header.",
+		 function );
+
+		return( -1 );
+	}
+	if( internal_file->parent_file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid file - missing parent file.",
+		 function );
+
+		return( -1 );
+	}
+	if( offset < 0 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_LESS_THAN_ZERO,
+		 "%s: invalid offset value less than zero.",
+		 function );
+
+		return( -1 );
+	}
+	if( chain_index_entry == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid chain index entry.",
+		 function );
+
+		return( -1 );
+	}
+	if( internal_file->chain_index == NULL )
+	{
+		if( libqcow_chain_index_initialize(
+		     &( internal_file->chain_index ),
+		     LIBQCOW_MAXIMUM_CACHE_ENTRIES_CHAIN_INDEX,
+		     internal_file->file_header->number_of_cluster_block_bits,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+			 "%s: unable to create chain index.",
+			 function );
+
+			return( -1 );
+		}
+	}
+	result = libqcow_chain_index_get_entry_by_offset(
+	          internal_file->chain_index,
+	          offset,
+	          chain_index_entry,
+	          error );
+
+	if( result == -1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+		 "%s: unable to retrieve chain index entry for offset: %" PRIi64 " (0x%08" PRIx64 ").",
+		 function,
+		 offset,
+		 offset );
+
+		return( -1 );
+	}
+	else if( result != 0 )
+	{
+		return( 1 );
+	}
+	chain_index_entry->offset                    = offset;
+	chain_index_entry->size                      = (size64_t) ( INT64_MAX - offset );
+	chain_index_entry->file                      = NULL;
+	chain_index_entry->cluster_block_offset      = 0;
+	chain_index_entry->cluster_block_data_offset = 0;
+	chain_index_entry->cluster_block_flags       = 0;
+
+	layer_file = internal_file->parent_file;
+
+	while( layer_file != NULL )
+	{
+		internal_layer_file = (libqcow_internal_file_t *) layer_file;
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+		if( libcthreads_read_write_lock_grab_for_write(
+		     internal_layer_file->read_write_lock,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+			 "%s: unable to grab read/write lock for writing.",
+			 function );
+
+			return( -1 );
+		}
+#endif
+		result = libqcow_internal_file_resolve_offset(
+		          internal_layer_file,
+		          offset,
+		          chain_index_entry,
+		          error );
+
+		layer_file = internal_layer_file->parent_file;
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+		if( libcthreads_read_write_lock_release_for_write(
+		     internal_layer_file->read_write_lock,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+			 "%s: unable to release read/write lock for writing.",
+			 function );
+
+			return( -1 );
+		}
+#endif
+		if( result == -1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+			 "%s: unable to resolve offset: %" PRIi64 " (0x%08" PRIx64 ") in backing chain.",
+			 function,
+			 offset,
+			 offset );
+
+			return( -1 );
+		}
+		else if( result != 0 )
+		{
+			break;
+		}
+	}
+	if( libqcow_chain_index_set_entry(
+	     internal_file->chain_index,
+	     chain_index_entry,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to set chain index entry for offset: %" PRIi64 " (0x%08" PRIx64 ").",
+		 function,
+		 offset,
+		 offset );
+
+		return( -1 );
+	}
+	return( 1 );
+}
+
+/* Determines if any layer of the backing chain stores the data of a range
+ * On input range_size contains the maximum size of the range, on output the size
+ * of the part of the range that has the same state
+ * This function is not multi-thread safe acquire write lock before call
+ * Returns 1 if stored, 0 if sparse or zero or -1 on error
+ */
+int libqcow_internal_file_get_allocation_range(
+     libqcow_internal_file_t *internal_file,
+     off64_t offset,
+     size64_t *range_size,
+     libcerror_error_t **error )
+{
+	libqcow_chain_index_entry_t chain_index_entry;
+
+	static char *function    = "libqcow_internal_file_get_allocation_range";
+	size64_t file_range_size = 0;
+	int result               = 0;
+
+	if( range_size == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid range size.",
+		 function );
+
+		return( -1 );
+	}
+	chain_index_entry.offset = offset;
+	chain_index_entry.size   = *range_size;
+	chain_index_entry.file   = NULL;
+
+	result = libqcow_internal_file_resolve_offset(
+	          internal_file,
+	          offset,
+	          &chain_index_entry,
+	          error );
+
+	if( result == 0 )
+	{
+		/* The range stored in the parent file is limited to the cluster block of the file
+		 */
+		file_range_size = chain_index_entry.size;
+
+		result = libqcow_internal_file_get_parent_chain_index_entry(
+		          internal_file,
+		          offset,
+		          &chain_index_entry,
+		          error );
+
+		if( chain_index_entry.size > file_range_size )
+		{
+			chain_index_entry.size = file_range_size;
+		}
+	}
+	if( result != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+		 "%s: unable to resolve offset: %" PRIi64 " (0x%08" PRIx64 ").",
+		 function,
+		 offset,
+		 offset );
+
+		return( -1 );
+	}
+	if( chain_index_entry.size == 0 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid chain index entry - size value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	if( chain_index_entry.size < *range_size )
+	{
+		*range_size = chain_index_entry.size;
+	}
+	if( chain_index_entry.file == NULL )
+	{
+		return( 0 );
+	}
+	return( 1 );
+}
+
+/* Retrieves the abort generation
+ * The abort generation is incremented every time the file is signalled to abort,
+ * a read retrieves it when it starts to determine if it was signalled to abort since
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_internal_file_get_abort_generation(
+     libqcow_internal_file_t *internal_file,
+     uint32_t *abort_generation,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_internal_file_get_abort_generation";
+
+	if( internal_file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	if( abort_generation == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid abort generation.",
+		 function );
+
+		return( -1 );
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_mutex_grab(
+	     internal_file->abort_mutex,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab abort mutex.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	*abort_generation = internal_file->abort_generation;
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_mutex_release(
+	     internal_file->abort_mutex,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release abort mutex.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	return( 1 );
+}
+
+/* Determines if a read must stop
+ * A read stops when the file was signalled to abort after the read started, that is
+ * when the abort generation differs from the one at the start of the read, or when
+ * the read control of the read, if any, was cancelled or has passed its deadline
+ * The read control can be NULL
+ * Returns 1 if stopped, 0 if not or -1 on error
+ */
+int libqcow_internal_file_read_is_stopped(
+     libqcow_internal_file_t *internal_file,
+     libqcow_read_control_t *read_control,
+     uint32_t abort_generation,
+     libcerror_error_t **error )
+{
+	static char *function             = "libqcow_internal_file_read_is_stopped";
+	uint32_t current_abort_generation = 0;
+	int result                        = 0;
+
+	if( libqcow_internal_file_get_abort_generation(
+	     internal_file,
+	     &current_abort_generation,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+		 "%s: unable to retrieve abort generation.",
+		 function );
+
+		return( -1 );
+	}
+	if( current_abort_generation != abort_generation )
+	{
+		return( 1 );
+	}
+	if( read_control != NULL )
+	{
+		result = libqcow_read_control_is_stopped(
+		          read_control,
+		          error );
+
+		if( result == -1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+			 "%s: unable to determine if read control is stopped.",
+			 function );
+
+			return( -1 );
+		}
+	}
+	return( result );
+}
+
+/* Determines if the range of a chain index entry can be read directly from its layer
+ * The range can be read directly if it is stored uncompressed and unencrypted in the file of the layer
+ * Returns 1 if the range can be read directly, 0 if not or -1 on error
+ */
+int libqcow_internal_file_chain_index_entry_is_direct(
+     libqcow_chain_index_entry_t *chain_index_entry,
+     libcerror_error_t **error )
+{
+	libqcow_internal_file_t *internal_layer_file = NULL;
+	static char *function                        = "libqcow_internal_file_chain_index_entry_is_direct";
+
+	if( chain_index_entry == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid chain index entry.",
+		 function );
+
+		return( -1 );
+	}
+	if( chain_index_entry->file == NULL )
+	{
+		return( 0 );
+	}
+	internal_layer_file = (libqcow_internal_file_t *) chain_index_entry->file;
+
+	if( ( internal_layer_file->encryption_method != LIBQCOW_ENCRYPTION_METHOD_NONE )
+	 || ( internal_layer_file->data_file_is_raw != 0 )
+	 || ( chain_index_entry->cluster_block_offset == 0 )
+	 || ( ( chain_index_entry->cluster_block_flags & ( LIBQCOW_CLUSTER_BLOCK_FLAG_IS_COMPRESSED | LIBQCOW_CLUSTER_BLOCK_FLAG_IS_SPARSE | LIBQCOW_CLUSTER_BLOCK_FLAG_IN_DATA_FILE ) ) != 0 ) )
+	{
+		return( 0 );
+	}
+	return( 1 );
+}
+
+/* Reads (media) data at a specific offset from the backing chain into a buffer
+ * The data is read directly from the layer of the backing chain that contains it
+ * Consecutive ranges that are stored contiguously in the same layer are read at once
+ * The read stops between layers when the read is stopped, in which case
+ * the number of bytes read so far is returned
+ * This function is not multi-thread safe acquire write lock before call
+ * Returns the number of bytes read or -1 on error
+ */
+ssize_t libqcow_internal_file_read_buffer_from_parent_file(
+         libqcow_internal_file_t *internal_file,
+         void *buffer,
+         size_t buffer_size,
+         off64_t offset,
+         libqcow_read_control_t *read_control,
+         uint32_t abort_generation,
+         libcerror_error_t **error )
+{
+	libqcow_chain_index_entry_t chain_index_entry;
+	libqcow_chain_index_entry_t next_chain_index_entry;
+
+	libqcow_cluster_block_t *cluster_block       = NULL;
+	libqcow_internal_file_t *internal_layer_file = NULL;
+	static char *function                        = "libqcow_internal_file_read_buffer_from_parent_file";
+	size_t buffer_offset                         = 0;
+	size_t next_read_size                        = 0;
+	size_t read_size                             = 0;
+	ssize_t read_count                           = 0;
+	off64_t next_offset                          = 0;
+	uint8_t read_is_direct                       = 0;
+	int result                                   = 0;
+
+	if( internal_file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	if( buffer == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid buffer.",
+		 function );
+
+		return( -1 );
+	}
+	if( buffer_size > (size_t) SSIZE_MAX )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_EXCEEDS_MAXIMUM,
+		 "%s: invalid buffer size value exceeds maximum.",
+		 function );
+
+		return( -1 );
+	}
+	if( offset < 0 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_LESS_THAN_ZERO,
+		 "%s: invalid offset value less than zero.",
+		 function );
+
+		return( -1 );
+	}
+	while( buffer_offset < buffer_size )
+	{
+		if( buffer_offset > 0 )
+		{
+			result = libqcow_internal_file_read_is_stopped(
+			          internal_file,
+			          read_control,
+			          abort_generation,
+			          error );
+
+			if( result == -1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+				 "%s: unable to determine if read is stopped.",
+				 function );
+
+				return( -1 );
+			}
+			else if( result != 0 )
+			{
+				break;
+			}
+		}
+		if( libqcow_internal_file_get_parent_chain_index_entry(
+		     internal_file,
+		     offset,
+		     &chain_index_entry,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+			 "%s: unable to retrieve chain index entry for offset: %" PRIi64 " (0x%08" PRIx64 ").",
+			 function,
+			 offset,
+			 offset );
+
+			return( -1 );
+		}
+		read_size = buffer_size - buffer_offset;
+
+		if( (size64_t) read_size > chain_index_entry.size )
+		{
+			read_size = (size_t) chain_index_entry.size;
+		}
+		internal_layer_file = (libqcow_internal_file_t *) chain_index_entry.file;
+
+		result = libqcow_internal_file_chain_index_entry_is_direct(
+		          &chain_index_entry,
+		          error );
+
+		if( result == -1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+			 "%s: unable to determine if chain index entry can be read directly.",
+			 function );
+
+			return( -1 );
+		}
+		read_is_direct = (uint8_t) result;
+
+		/* Extend the read with the consecutive ranges that are stored contiguously
+		 * in the same layer, so that they are read from the layer at once
+		 */
+		while( read_size < ( buffer_size - buffer_offset ) )
+		{
+			if( ( internal_layer_file != NULL )
+			 && ( read_is_direct == 0 )
+			 && ( ( internal_layer_file->data_file_is_raw == 0 )
+			  ||  ( internal_layer_file->encryption_method != LIBQCOW_ENCRYPTION_METHOD_NONE ) ) )
+			{
+				break;
+			}
+			next_offset = offset + (off64_t) read_size;
+
+			if( libqcow_internal_file_get_parent_chain_index_entry(
+			     internal_file,
+			     next_offset,
+			     &next_chain_index_entry,
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+				 "%s: unable to retrieve chain index entry for offset: %" PRIi64 " (0x%08" PRIx64 ").",
+				 function,
+				 next_offset,
+				 next_offset );
+
+				return( -1 );
+			}
+			if( next_chain_index_entry.file != chain_index_entry.file )
+			{
+				break;
+			}
+			if( read_is_direct != 0 )
+			{
+				result = libqcow_internal_file_chain_index_entry_is_direct(
+				          &next_chain_index_entry,
+				          error );
+
+				if( result == -1 )
+				{
+					libcerror_error_set(
+					 error,
+					 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+					 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+					 "%s: unable to determine if chain index entry can be read directly.",
+					 function );
+
+					return( -1 );
+				}
+				else if( result == 0 )
+				{
+					break;
+				}
+				if( ( next_chain_index_entry.cluster_block_offset + next_chain_index_entry.cluster_block_data_offset ) != ( chain_index_entry.cluster_block_offset + chain_index_entry.cluster_block_data_offset + read_size ) )
+				{
+					break;
+				}
+			}
+			next_read_size = buffer_size - buffer_offset - read_size;
+
+			if( (size64_t) next_read_size > next_chain_index_entry.size )
+			{
+				next_read_size = (size_t) next_chain_index_entry.size;
+			}
+			read_size += next_read_size;
+		}
+		if( chain_index_entry.file == NULL )
+		{
+			if( memory_set(
+			     &( ( (uint8_t *) buffer )[ buffer_offset ] ),
+			     0,
+			     read_size ) == NULL )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_MEMORY,
+				 LIBCERROR_MEMORY_ERROR_SET_FAILED,
+				 "%s: unable to set sparse data in buffer.",
+				 function );
+
+				return( -1 );
+			}
+		}
+		else
+		{
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+			if( libcthreads_read_write_lock_grab_for_write(
+			     internal_layer_file->read_write_lock,
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+				 "%s: unable to grab read/write lock for writing.",
+				 function );
+
+				return( -1 );
+			}
+#endif
+			if( ( internal_layer_file->data_file_is_raw != 0 )
+			 && ( internal_layer_file->encryption_method == LIBQCOW_ENCRYPTION_METHOD_NONE ) )
+			{
+				read_count = libqcow_internal_file_read_buffer_from_raw_data_file(
+				              internal_layer_file,
+				              &( ( (uint8_t *) buffer )[ buffer_offset ] ),
+				              read_size,
+				              offset,
+				              error );
+
+				if( read_count != (ssize_t) read_size )
+				{
+					libcerror_error_set(
+					 error,
+					 LIBCERROR_ERROR_DOMAIN_IO,
+					 LIBCERROR_IO_ERROR_READ_FAILED,
+					 "%s: unable to read buffer from raw data file of backing file.",
+					 function );
+
+					result = -1;
+				}
+				else
+				{
+					result = 1;
+				}
+			}
+			else if( read_is_direct != 0 )
+			{
+				read_count = libbfio_handle_read_buffer_at_offset(
+				              internal_layer_file->file_io_handle,
+				              &( ( (uint8_t *) buffer )[ buffer_offset ] ),
+				              read_size,
+				              (off64_t) ( chain_index_entry.cluster_block_offset + chain_index_entry.cluster_block_data_offset ),
+				              error );
+
+				if( read_count != (ssize_t) read_size )
+				{
+					libcerror_error_set(
+					 error,
+					 LIBCERROR_ERROR_DOMAIN_IO,
+					 LIBCERROR_IO_ERROR_READ_FAILED,
+					 "%s: unable to read cluster blocks of backing file.",
+					 function );
+
+					result = -1;
+				}
+				else
+				{
+					result = 1;
+				}
+			}
+			else
+			{
+				result = libqcow_internal_file_read_cluster_block(
+				          internal_layer_file,
+				          internal_layer_file->file_io_handle,
+				          offset,
+				          chain_index_entry.cluster_block_offset,
+				          chain_index_entry.cluster_block_data_offset,
+				          chain_index_entry.cluster_block_flags,
+				          &cluster_block,
+				          error );
+
+				if( result != 1 )
+				{
+					libcerror_error_set(
+					 error,
+					 LIBCERROR_ERROR_DOMAIN_IO,
+					 LIBCERROR_IO_ERROR_READ_FAILED,
+					 "%s: unable to read cluster block of backing file.",
+					 function );
+				}
+				else if( ( cluster_block == NULL )
+				      || ( cluster_block->data == NULL )
+				      || ( chain_index_entry.cluster_block_data_offset >= cluster_block->data_size ) )
+				{
+					libcerror_error_set(
+					 error,
+					 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+					 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+					 "%s: invalid cluster block of backing file.",
+					 function );
+
+					result = -1;
+				}
+				else
+				{
+					if( read_size > ( cluster_block->data_size - chain_index_entry.cluster_block_data_offset ) )
+					{
+						read_size = cluster_block->data_size - chain_index_entry.cluster_block_data_offset;
+					}
+					if( memory_copy(
+					     &( ( (uint8_t *) buffer )[ buffer_offset ] ),
+					     &( cluster_block->data[ chain_index_entry.cluster_block_data_offset ] ),
+					     read_size ) == NULL )
+					{
+						libcerror_error_set(
+						 error,
+						 LIBCERROR_ERROR_DOMAIN_MEMORY,
+						 LIBCERROR_MEMORY_ERROR_COPY_FAILED,
+						 "%s: unable to copy cluster block data to buffer.",
+						 function );
+
+						result = -1;
+					}
+				}
+			}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+			if( libcthreads_read_write_lock_release_for_write(
+			     internal_layer_file->read_write_lock,
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+				 "%s: unable to release read/write lock for writing.",
+				 function );
+
+				return( -1 );
+			}
+#endif
+			if( result != 1 )
+			{
+				return( -1 );
+			}
+		}
+		offset        += (off64_t) read_size;
+		buffer_offset += read_size;
+	}
+	return( (ssize_t) buffer_offset );
+}
+
+/* Reads (media) data at a specific offset into a buffer using a specific level 1 table
+ * The level 1 table is either the level 1 table of the file or that of a snapshot
+ * The read stops between cluster blocks when the read is stopped, in which case
+ * the number of bytes read so far is returned
+ * The current offset of the file is not changed
+ * This function is not multi-thread safe acquire write lock before call
+ * Returns the number of bytes read or -1 on error
+ */
+ssize_t libqcow_internal_file_read_buffer_from_level1_table(
+         libqcow_internal_file_t *internal_file,
+         libbfio_handle_t *file_io_handle,
+         libqcow_cluster_table_t *level1_table,
+         size64_t media_size,
+         void *buffer,
+         size_t buffer_size,
+         off64_t offset,
+         libqcow_read_control_t *read_control,
+         uint32_t abort_generation,
+         libcerror_error_t **error )
+{
+	libqcow_cluster_block_t *cluster_block = NULL;
+	static char *function                  = "libqcow_internal_file_read_buffer_from_level1_table";
+	size_t buffer_offset                   = 0;
+	size_t cluster_block_data_size         = 0;
+	size_t read_size                       = 0;
+	ssize_t read_count                     = 0;
+	off64_t next_offset                    = 0;
+	uint64_t cluster_block_data_offset     = 0;
+	uint64_t cluster_block_file_offset     = 0;
+	uint32_t cluster_block_flags           = 0;
+	int result                             = 0;
+
+	if( internal_file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	if( internal_file->file_header == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid file - missing file header.",
+		 function );
+
+		return( -1 );
+	}
+	if( internal_file->cluster_block_size == 0 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid file - cluster block size value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	if( internal_file->backing_filename != NULL )
+	{
+		if( internal_file->parent_file == NULL )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+			 "%s: invalid file - missing parent file.",
+			 function );
+
+			return( -1 );
+		}
+	}
+	if( ( ( internal_file->file_header->incompatible_feature_flags & LIBQCOW_INCOMPATIBLE_FEATURE_FLAG_EXTERNAL_DATA_FILE ) != 0 )
+	 && ( internal_file->data_file_io_handle == NULL ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid file - missing data file.",
+		 function );
+
+		return( -1 );
+	}
+	if( level1_table == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid level 1 table.",
+		 function );
+
+		return( -1 );
+	}
+	if( buffer == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid buffer.",
+		 function );
+
+		return( -1 );
+	}
+	if( buffer_size > (size_t) SSIZE_MAX )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_EXCEEDS_MAXIMUM,
+		 "%s: invalid buffer size value exceeds maximum.",
+		 function );
+
+		return( -1 );
+	}
+	if( offset < 0 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_LESS_THAN_ZERO,
+		 "%s: invalid offset value less than zero.",
+		 function );
+
+		return( -1 );
+	}
+	if( (size64_t) offset >= media_size )
+	{
+		return( 0 );
+	}
+	while( buffer_offset < buffer_size )
+	{
+		result = libqcow_internal_file_read_is_stopped(
+		          internal_file,
+		          read_control,
+		          abort_generation,
+		          error );
+
+		if( result == -1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+			 "%s: unable to determine if read is stopped.",
+			 function );
+
+			return( -1 );
+		}
+		else if( result != 0 )
+		{
+			break;
+		}
+#if defined( HAVE_DEBUG_OUTPUT )
+		if( libcnotify_verbose != 0 )
+		{
+			libcnotify_printf(
+			 "%s: offset\t\t: %" PRIi64 " (0x%08" PRIx64 ")\n",
+			 function,
+			 offset,
+			 offset );
+		}
+#endif
+		if( libqcow_internal_file_get_cluster_block_offset(
+		     internal_file,
+		     file_io_handle,
+		     level1_table,
+		     offset,
+		     &cluster_block_file_offset,
+		     &cluster_block_data_offset,
+		     &cluster_block_data_size,
+		     &cluster_block_flags,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+			 "%s: unable to retrieve cluster block offset for offset: %" PRIi64 " (0x%08" PRIx64 ").",
+			 function,
+			 offset,
+			 offset );
+
+			return( -1 );
+		}
+		read_size = cluster_block_data_size;
+
+		if( (size64_t) read_size > ( media_size - offset ) )
+		{
+			read_size = (size_t) ( media_size - offset );
+		}
+		if( read_size > ( buffer_size - buffer_offset ) )
+		{
+			read_size = buffer_size - buffer_offset;
+		}
+		if( ( ( cluster_block_file_offset > 0 )
+		  || ( ( cluster_block_flags & LIBQCOW_CLUSTER_BLOCK_FLAG_IN_DATA_FILE ) != 0 ) )
+		 && ( ( cluster_block_flags & LIBQCOW_CLUSTER_BLOCK_FLAG_IS_SPARSE ) == 0 ) )
+		{
+			if( libqcow_internal_file_read_cluster_block(
+			     internal_file,
+			     file_io_handle,
+			     offset,
+			     cluster_block_file_offset,
+			     cluster_block_data_offset,
+			     cluster_block_flags,
+			     &cluster_block,
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_IO,
+				 LIBCERROR_IO_ERROR_READ_FAILED,
+				 "%s: unable to read cluster block.",
+				 function );
+
+				return( -1 );
+			}
+			if( cluster_block == NULL )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+				 "%s: invalid cluster block.",
+				 function );
+
+				return( -1 );
+			}
+			if( cluster_block->data == NULL )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+				 "%s: invalid cluster block - missing data.",
+				 function );
+
+				return( -1 );
+			}
+			if( cluster_block_data_offset > cluster_block->data_size )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+				 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+				 "%s: invalid cluster block data offset value out of bounds.",
+				 function );
+
+				return( -1 );
+			}
+			if( read_size > ( cluster_block->data_size - cluster_block_data_offset ) )
+			{
+				read_size = cluster_block->data_size - cluster_block_data_offset;
+			}
+			if( read_size == 0 )
+			{
+				break;
+			}
+			if( memory_copy(
+			     &( ( (uint8_t *) buffer )[ buffer_offset ] ),
+			     &( cluster_block->data[ cluster_block_data_offset ] ),
+			     read_size ) == NULL )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_MEMORY,
+				 LIBCERROR_MEMORY_ERROR_COPY_FAILED,
+				 "%s: unable to copy cluster block data to buffer.",
+				 function );
+
+				return( -1 );
+			}
+		}
+		else if( ( internal_file->parent_file != NULL )
+		      && ( ( cluster_block_flags & LIBQCOW_CLUSTER_BLOCK_FLAG_IS_ZERO ) == 0 ) )
+		{
+			/* Extend the read with the consecutive cluster blocks that are also
+			 * stored in the parent file, so that they are read from the parent at once
+			 */
+			while( read_size < ( buffer_size - buffer_offset ) )
+			{
+				next_offset = offset + read_size;
+
+				if( (size64_t) next_offset >= media_size )
+				{
+					break;
+				}
+				if( libqcow_internal_file_get_cluster_block_offset(
+				     internal_file,
+				     file_io_handle,
+				     level1_table,
+				     next_offset,
+				     &cluster_block_file_offset,
+				     &cluster_block_data_offset,
+				     &cluster_block_data_size,
+				     &cluster_block_flags,
+				     error ) != 1 )
+				{
+					libcerror_error_set(
+					 error,
+					 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+					 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+					 "%s: unable to retrieve cluster block offset for offset: %" PRIi64 " (0x%08" PRIx64 ").",
+					 function,
+					 next_offset,
+					 next_offset );
+
+					return( -1 );
+				}
+				if( ( ( cluster_block_file_offset > 0 )
+				  || ( ( cluster_block_flags & LIBQCOW_CLUSTER_BLOCK_FLAG_IN_DATA_FILE ) != 0 ) )
+				 && ( ( cluster_block_flags & LIBQCOW_CLUSTER_BLOCK_FLAG_IS_SPARSE ) == 0 ) )
+				{
+					break;
+				}
+				if( ( cluster_block_flags & LIBQCOW_CLUSTER_BLOCK_FLAG_IS_ZERO ) != 0 )
+				{
+					break;
+				}
+				if( (size64_t) cluster_block_data_size > ( media_size - next_offset ) )
+				{
+					cluster_block_data_size = (size_t) ( media_size - next_offset );
+				}
+				if( cluster_block_data_size > ( buffer_size - buffer_offset - read_size ) )
+				{
+					cluster_block_data_size = buffer_size - buffer_offset - read_size;
+				}
+				read_size += cluster_block_data_size;
+			}
+#if defined( HAVE_DEBUG_OUTPUT )
+			if( libcnotify_verbose != 0 )
+			{
+				libcnotify_printf(
+				 "%s: reading: %" PRIzd " bytes from parent file.\n",
+				 function,
+				 read_size );
+			}
+#endif
+			read_count = libqcow_internal_file_read_buffer_from_parent_file(
+			              internal_file,
+			              &( ( (uint8_t *) buffer )[ buffer_offset ] ),
+			              read_size,
+			              offset,
+			              read_control,
+			              abort_generation,
+			              error );
+
+			if( read_count == -1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_IO,
+				 LIBCERROR_IO_ERROR_READ_FAILED,
+				 "%s: unable to read buffer from parent file.",
+				 function );
+
+				return( -1 );
+			}
+			/* The read from the parent file stops early when the read is stopped
+			 */
+			else if( read_count < (ssize_t) read_size )
+			{
+				offset        += (off64_t) read_count;
+				buffer_offset += (size_t) read_count;
+
+				break;
+			}
+		}
+		else
+		{
+			/* Handle sparse cluster block
+			 */
+			if( memory_set(
+			     &( ( (uint8_t *) buffer )[ buffer_offset ] ),
+			     0,
+			     read_size ) == NULL )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_MEMORY,
+				 LIBCERROR_MEMORY_ERROR_SET_FAILED,
+				 "%s: unable to set sparse data in buffer.",
+				 function );
+
+				return( -1 );
+			}
+		}
+		offset        += (off64_t) read_size;
+		buffer_offset += read_size;
+
+#if defined( HAVE_DEBUG_OUTPUT )
+		if( libcnotify_verbose != 0 )
+		{
+			libcnotify_printf(
+			 "\n" );
+		}
+#endif
+		if( (size64_t) offset >= media_size )
+		{
+			break;
+		}
+	}
+	return( (ssize_t) buffer_offset );
+}
+
+/* Reads (media) data at a specific offset from the memory mapped file into a buffer
+ * Only the cluster blocks that are stored uncompressed in the memory mapped file
+ * and the cluster blocks that read as zero bytes are read, the read stops at the
+ * first cluster block that needs to be read using the caches of the file
+ * The read does not modify the file and does not require the read/write lock
+ * of the file, the caller must make sure the file is not closed during the read
+ * The current offset of the file is not changed
+ * Returns the number of bytes read or -1 on error
+ */
+ssize_t libqcow_internal_file_read_mapped_buffer_at_offset(
+         libqcow_internal_file_t *internal_file,
+         uint8_t *buffer,
+         size_t buffer_size,
+         off64_t offset,
+         libcerror_error_t **error )
+{
+	uint8_t *mapped_data               = NULL;
+	static char *function              = "libqcow_internal_file_read_mapped_buffer_at_offset";
+	size64_t media_size                = 0;
+	size_t buffer_offset               = 0;
+	size_t cluster_block_data_size     = 0;
+	size_t read_size                   = 0;
+	uint64_t cluster_block_data_offset = 0;
+	uint64_t cluster_block_file_offset = 0;
+	uint32_t cluster_block_flags       = 0;
+	int result                         = 0;
+
+	if( internal_file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	if( internal_file->io_handle == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid file - missing IO handle.",
+		 function );
+
+		return( -1 );
+	}
+	if( internal_file->file_header == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid file - missing file header.",
+		 function );
+
+		return( -1 );
+	}
+	if( buffer == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid buffer.",
+		 function );
+
+		return( -1 );
+	}
+	if( buffer_size > (size_t) SSIZE_MAX )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_EXCEEDS_MAXIMUM,
+		 "%s: invalid buffer size value exceeds maximum.",
+		 function );
+
+		return( -1 );
+	}
+	if( offset < 0 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_LESS_THAN_ZERO,
+		 "%s: invalid offset value less than zero.",
+		 function );
+
+		return( -1 );
+	}
+	/* The IO handle only references the memory mapped file if the cluster blocks
+	 * are not encrypted and not stored in an external data file
+	 */
+	if( internal_file->io_handle->mapped_file == NULL )
+	{
+		return( 0 );
+	}
+	media_size = internal_file->file_header->media_size;
+
+	while( ( buffer_offset < buffer_size )
+	    && ( (size64_t) offset < media_size ) )
+	{
+		result = libqcow_internal_file_get_mapped_cluster_block_offset(
+		          internal_file,
+		          internal_file->level1_table,
+		          offset,
+		          &cluster_block_file_offset,
+		          &cluster_block_data_offset,
+		          &cluster_block_data_size,
+		          &cluster_block_flags,
+		          error );
+
+		if( result == -1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+			 "%s: unable to retrieve cluster block offset for offset: %" PRIi64 " (0x%08" PRIx64 ").",
+			 function,
+			 offset,
+			 offset );
+
+			return( -1 );
+		}
+		else if( result == 0 )
+		{
+			break;
+		}
+		read_size = cluster_block_data_size;
+
+		if( (size64_t) read_size > ( media_size - offset ) )
+		{
+			read_size = (size_t) ( media_size - offset );
+		}
+		if( read_size > ( buffer_size - buffer_offset ) )
+		{
+			read_size = buffer_size - buffer_offset;
+		}
+		if( ( cluster_block_flags & ( LIBQCOW_CLUSTER_BLOCK_FLAG_IS_COMPRESSED | LIBQCOW_CLUSTER_BLOCK_FLAG_IN_DATA_FILE ) ) != 0 )
+		{
+			break;
+		}
+		else if( ( cluster_block_file_offset > 0 )
+		      && ( ( cluster_block_flags & LIBQCOW_CLUSTER_BLOCK_FLAG_IS_SPARSE ) == 0 ) )
+		{
+			result = libqcow_mapped_file_get_data(
+			          internal_file->io_handle->mapped_file,
+			          (off64_t) ( cluster_block_file_offset + cluster_block_data_offset ),
+			          (size64_t) read_size,
+			          &mapped_data,
+			          error );
+
+			if( result == -1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+				 "%s: unable to retrieve cluster block data from mapped file.",
+				 function );
+
+				return( -1 );
+			}
+			else if( result == 0 )
+			{
+				break;
+			}
+			if( memory_copy(
+			     &( buffer[ buffer_offset ] ),
+			     mapped_data,
+			     read_size ) == NULL )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_MEMORY,
+				 LIBCERROR_MEMORY_ERROR_COPY_FAILED,
+				 "%s: unable to copy cluster block data to buffer.",
+				 function );
+
+				return( -1 );
+			}
+		}
+		/* Unallocated cluster blocks are read from the parent file
+		 */
+		else if( ( internal_file->parent_file != NULL )
+		      && ( ( cluster_block_flags & LIBQCOW_CLUSTER_BLOCK_FLAG_IS_ZERO ) == 0 ) )
+		{
+			break;
+		}
+		else
+		{
+			if( memory_set(
+			     &( buffer[ buffer_offset ] ),
+			     0,
+			     read_size ) == NULL )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_MEMORY,
+				 LIBCERROR_MEMORY_ERROR_SET_FAILED,
+				 "%s: unable to set sparse data in buffer.",
+				 function );
+
+				return( -1 );
+			}
+		}
+		offset        += read_size;
+		buffer_offset += read_size;
+	}
+	return( (ssize_t) buffer_offset );
+}
+
+/* Reads (media) data at a specific offset into a buffer using a Basic File IO (bfio) handle
+ * The current offset of the file is not changed
+ * This function is not multi-thread safe acquire write lock before call
+ * Returns the number of bytes read or -1 on error
+ */
+ssize_t libqcow_internal_file_read_buffer_from_file_io_handle(
+         libqcow_internal_file_t *internal_file,
+         libbfio_handle_t *file_io_handle,
+         void *buffer,
+         size_t buffer_size,
+         off64_t offset,
+         libqcow_read_control_t *read_control,
+         uint32_t abort_generation,
+         libcerror_error_t **error )
+{
+	static char *function = "libqcow_internal_file_read_buffer_from_file_io_handle";
+	ssize_t read_count    = 0;
+
+	if( internal_file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	if( internal_file->file_header == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid file - missing file header.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( internal_file->data_file_is_raw != 0 )
+	 && ( internal_file->encryption_method == LIBQCOW_ENCRYPTION_METHOD_NONE ) )
+	{
+		read_count = libqcow_internal_file_read_buffer_from_raw_data_file(
+		              internal_file,
+		              buffer,
+		              buffer_size,
+		              offset,
+		              error );
+	}
+	else
+	{
+		read_count = libqcow_internal_file_read_buffer_from_level1_table(
+		              internal_file,
+		              file_io_handle,
+		              internal_file->level1_table,
+		              internal_file->file_header->media_size,
+		              buffer,
+		              buffer_size,
+		              offset,
+		              read_control,
+		              abort_generation,
+		              error );
+	}
+	if( read_count == -1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_IO,
+		 LIBCERROR_IO_ERROR_READ_FAILED,
+		 "%s: unable to read buffer.",
+		 function );
+
+		return( -1 );
+	}
+	if( internal_file->parent_file_created_in_library != 0 )
+	{
+		internal_file->number_of_reads_since_cache_budget_update += 1;
+
+		if( internal_file->number_of_reads_since_cache_budget_update >= LIBQCOW_CACHE_BUDGET_UPDATE_INTERVAL )
+		{
+			if( libqcow_internal_file_apportion_cache_budget(
+			     internal_file,
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+				 "%s: unable to apportion cache budget.",
+				 function );
+
+				return( -1 );
+			}
+		}
+	}
+	return( read_count );
+}
+
+/* Retrieves the range of consecutive cluster blocks at a specific offset that can
+ * be read directly from the file, or the range of consecutive cluster blocks that cannot
+ * Cluster blocks that can be read directly are uncompressed, unencrypted and stored
+ * contiguously in the file, other cluster blocks need to be read using the caches of the file
+ * Uncompressed encrypted cluster blocks stored contiguously in the file are returned as
+ * a range that can be decrypted directly
+ * When the file uses a cache pool, an unencrypted compressed cluster block stored in the file
+ * is returned as a range of its own that can be decompressed directly, the range file offset
+ * then contains the cluster block offset. Without a cache pool this only applies when the
+ * entire cluster block is read, partially read compressed cluster blocks are read using
+ * the compressed cluster block cache of the file, so they are decompressed once
+ * When the lookups are limited to the published level 2 tables, the range ends at the first
+ * cluster block of which the level 2 table is not published, this only requires the read/write
+ * lock of the file grabbed for reading. A range size of 0 then indicates that the range could
+ * not be determined without reading a level 2 table
+ * Otherwise this function is not multi-thread safe acquire write lock before call
+ * Returns 1 if the range can be read directly, 2 if the range can be decompressed directly,
+ * 3 if the range can be decrypted directly, 0 if not or -1 on error
+ */
+int libqcow_internal_file_get_direct_read_range(
+     libqcow_internal_file_t *internal_file,
+     off64_t offset,
+     size_t size,
+     uint8_t published_lookups_only,
+     off64_t *range_file_offset,
+     size_t *range_size,
+     libcerror_error_t **error )
+{
+	static char *function              = "libqcow_internal_file_get_direct_read_range";
+	size64_t media_size                = 0;
+	size_t cluster_block_data_size     = 0;
+	size_t safe_range_size             = 0;
+	uint64_t cluster_block_data_offset = 0;
+	uint64_t cluster_block_file_offset = 0;
+	uint32_t cluster_block_flags       = 0;
+	off64_t next_offset                = 0;
+	off64_t safe_range_file_offset     = 0;
+	uint8_t is_direct                  = 0;
+	uint8_t range_is_direct            = 0;
+	int result                         = 0;
+
+	if( internal_file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	if( internal_file->file_header == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid file - missing file header.",
+		 function );
+
+		return( -1 );
+	}
+	media_size = internal_file->file_header->media_size;
+
+	if( ( offset < 0 )
+	 || ( (size64_t) offset >= media_size ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid offset value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	if( size > (size_t) SSIZE_MAX )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_EXCEEDS_MAXIMUM,
+		 "%s: invalid size value exceeds maximum.",
+		 function );
+
+		return( -1 );
+	}
+	if( range_file_offset == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid range file offset.",
+		 function );
+
+		return( -1 );
+	}
+	if( range_size == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid range size.",
+		 function );
+
+		return( -1 );
+	}
+	if( (size64_t) size > ( media_size - offset ) )
+	{
+		size = (size_t) ( media_size - offset );
+	}
+	next_offset = offset;
+
+	while( safe_range_size < size )
+	{
+		if( published_lookups_only != 0 )
+		{
+			result = libqcow_internal_file_get_published_cluster_block_offset(
+			          internal_file,
+			          internal_file->level1_table,
+			          next_offset,
+			          &cluster_block_file_offset,
+			          &cluster_block_data_offset,
+			          &cluster_block_data_size,
+			          &cluster_block_flags,
+			          error );
+		}
+		else
+		{
+			result = libqcow_internal_file_get_cluster_block_offset(
+			          internal_file,
+			          internal_file->file_io_handle,
+			          internal_file->level1_table,
+			          next_offset,
+			          &cluster_block_file_offset,
+			          &cluster_block_data_offset,
+			          &cluster_block_data_size,
+			          &cluster_block_flags,
+			          error );
+		}
+		if( result == -1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+			 "%s: unable to retrieve cluster block offset for offset: %" PRIi64 " (0x%08" PRIx64 ").",
+			 function,
+			 next_offset,
+			 next_offset );
+
+			return( -1 );
+		}
+		else if( result == 0 )
+		{
+			break;
+		}
+		if( cluster_block_data_size == 0 )
+		{
+			break;
+		}
+		is_direct = 0;
+
+		if( ( internal_file->data_file_is_raw == 0 )
+		 && ( cluster_block_file_offset > 0 )
+		 && ( ( cluster_block_flags & ( LIBQCOW_CLUSTER_BLOCK_FLAG_IN_DATA_FILE | LIBQCOW_CLUSTER_BLOCK_FLAG_IS_SPARSE ) ) == 0 ) )
+		{
+			if( internal_file->encryption_method != LIBQCOW_ENCRYPTION_METHOD_NONE )
+			{
+				if( ( cluster_block_flags & LIBQCOW_CLUSTER_BLOCK_FLAG_IS_COMPRESSED ) == 0 )
+				{
+					is_direct = 3;
+				}
+			}
+			else if( ( cluster_block_flags & LIBQCOW_CLUSTER_BLOCK_FLAG_IS_COMPRESSED ) == 0 )
+			{
+				is_direct = 1;
+			}
+			else if( ( internal_file->cache_pool != NULL )
+			      && ( internal_file->file_identity_is_set != 0 ) )
+			{
+				is_direct = 2;
+			}
+			/* Without a cache pool only a read of the entire cluster block is decompressed
+			 * directly, so that the cluster block is not decompressed once per partial read
+			 */
+			else if( ( cluster_block_data_offset == 0 )
+			      && ( cluster_block_data_size <= ( size - safe_range_size ) ) )
+			{
+				is_direct = 2;
+			}
+		}
+		if( safe_range_size == 0 )
+		{
+			range_is_direct        = is_direct;
+			safe_range_file_offset = (off64_t) ( cluster_block_file_offset + cluster_block_data_offset );
+
+			if( is_direct == 2 )
+			{
+				safe_range_file_offset = (off64_t) cluster_block_file_offset;
+			}
+		}
+		else if( ( is_direct != range_is_direct )
+		      || ( is_direct == 2 ) )
+		{
+			break;
+		}
+		else if( ( is_direct != 0 )
+		      && ( (off64_t) ( cluster_block_file_offset + cluster_block_data_offset ) != ( safe_range_file_offset + (off64_t) safe_range_size ) ) )
+		{
+			break;
+		}
+		if( cluster_block_data_size > ( size - safe_range_size ) )
+		{
+			cluster_block_data_size = size - safe_range_size;
+		}
+		safe_range_size += cluster_block_data_size;
+		next_offset     += (off64_t) cluster_block_data_size;
+	}
+	if( range_is_direct == 0 )
+	{
+		safe_range_file_offset = 0;
+	}
+	*range_file_offset = safe_range_file_offset;
+	*range_size        = safe_range_size;
+
+	return( (int) range_is_direct );
+}
+
+/* Reads (media) data of a compressed cluster block into a buffer
+ * The compressed cluster block is retrieved from the cache pool if available,
+ * otherwise it is read and decompressed without the read/write lock of the file
+ * and stored in the cache pool if available
+ * The caller must make sure the file is not closed during the read
+ * Returns the number of bytes read or -1 on error
+ */
+ssize_t libqcow_internal_file_read_compressed_buffer_at_offset(
+         libqcow_internal_file_t *internal_file,
+         libbfio_handle_t *file_io_handle,
+         uint64_t cluster_block_offset,
+         uint64_t cluster_block_data_offset,
+         uint8_t *buffer,
+         size_t buffer_size,
+         libcerror_error_t **error )
+{
+	libqcow_cluster_block_t *cluster_block = NULL;
+	static char *function                  = "libqcow_internal_file_read_compressed_buffer_at_offset";
+	size_t compressed_data_size            = 0;
+	size_t read_size                       = 0;
+	uint64_t compressed_data_offset        = 0;
+	uint8_t is_loading                     = 0;
+	uint8_t is_pinned                      = 0;
+	uint8_t use_cache_pool                 = 0;
+	int result                             = 0;
+
+	if( internal_file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	if( buffer == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid buffer.",
+		 function );
+
+		return( -1 );
+	}
+	if( buffer_size > (size_t) SSIZE_MAX )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_EXCEEDS_MAXIMUM,
+		 "%s: invalid buffer size value exceeds maximum.",
+		 function );
+
+		return( -1 );
+	}
+	if( libqcow_internal_file_get_compressed_cluster_block_range(
+	     internal_file,
+	     cluster_block_offset,
+	     &compressed_data_offset,
+	     &compressed_data_size,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+		 "%s: unable to retrieve compressed cluster block range.",
+		 function );
+
+		goto on_error;
+	}
+	/* The cache pool and file identity do not change while the file is open
+	 */
+	if( ( internal_file->cache_pool != NULL )
+	 && ( internal_file->file_identity_is_set != 0 ) )
+	{
+		use_cache_pool = 1;
+	}
+	if( use_cache_pool != 0 )
+	{
+		/* Concurrent misses on the same cluster block wait for a single load
+		 */
+		result = libqcow_cache_pool_get_cluster_block_or_begin_load(
+		          internal_file->cache_pool,
+		          &( internal_file->file_identity ),
+		          LIBQCOW_CACHE_POOL_VALUE_TYPE_COMPRESSED_CLUSTER_BLOCK,
+		          compressed_data_offset,
+		          &cluster_block,
+		          error );
+
+		if( result == -1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+			 "%s: unable to retrieve cluster block at offset: %" PRIi64 " (0x%08" PRIx64 ") from cache pool.",
+			 function,
+			 compressed_data_offset,
+			 compressed_data_offset );
+
+			goto on_error;
+		}
+		else if( result != 0 )
+		{
+			is_pinned = 1;
+		}
+		else
+		{
+			is_loading = 1;
+		}
+	}
+	if( cluster_block == NULL )
+	{
+		if( libqcow_internal_file_decompress_cluster_block(
+		     internal_file,
+		     file_io_handle,
+		     NULL,
+		     compressed_data_offset,
+		     compressed_data_size,
+		     &cluster_block,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_IO,
+			 LIBCERROR_IO_ERROR_READ_FAILED,
+			 "%s: unable to read compressed cluster block at offset: %" PRIi64 " (0x%08" PRIx64 ").",
+			 function,
+			 compressed_data_offset,
+			 compressed_data_offset );
+
+			goto on_error;
+		}
+		if( use_cache_pool != 0 )
+		{
+			if( libqcow_cache_pool_set_cluster_block(
+			     internal_file->cache_pool,
+			     &( internal_file->file_identity ),
+			     LIBQCOW_CACHE_POOL_VALUE_TYPE_COMPRESSED_CLUSTER_BLOCK,
+			     compressed_data_offset,
+			     cluster_block,
+			     compressed_data_size + cluster_block->data_size,
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+				 "%s: unable to set cluster block at offset: %" PRIi64 " (0x%08" PRIx64 ") in cache pool.",
+				 function,
+				 compressed_data_offset,
+				 compressed_data_offset );
+
+				goto on_error;
+			}
+			is_pinned  = 1;
+			is_loading = 0;
+
+			if( libqcow_cache_pool_end_load(
+			     internal_file->cache_pool,
+			     &( internal_file->file_identity ),
+			     LIBQCOW_CACHE_POOL_VALUE_TYPE_COMPRESSED_CLUSTER_BLOCK,
+			     compressed_data_offset,
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+				 "%s: unable to end load of cluster block at offset: %" PRIi64 " (0x%08" PRIx64 ") in cache pool.",
+				 function,
+				 compressed_data_offset,
+				 compressed_data_offset );
+
+				goto on_error;
+			}
+		}
+	}
+	if( cluster_block_data_offset > cluster_block->data_size )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid cluster block data offset value out of bounds.",
+		 function );
+
+		goto on_error;
+	}
+	read_size = buffer_size;
+
+	if( read_size > ( cluster_block->data_size - cluster_block_data_offset ) )
+	{
+		read_size = cluster_block->data_size - cluster_block_data_offset;
+	}
+	if( memory_copy(
+	     buffer,
+	     &( cluster_block->data[ cluster_block_data_offset ] ),
+	     read_size ) == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_COPY_FAILED,
+		 "%s: unable to copy cluster block data to buffer.",
+		 function );
+
+		goto on_error;
+	}
+	if( is_pinned != 0 )
+	{
+		if( libqcow_cache_pool_unpin_cluster_block(
+		     internal_file->cache_pool,
+		     &cluster_block,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+			 "%s: unable to unpin cluster block.",
+			 function );
+
+			return( -1 );
+		}
+	}
+	else if( libqcow_cluster_block_free(
+	          &cluster_block,
+	          error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+		 "%s: unable to free cluster block.",
+		 function );
+
+		return( -1 );
+	}
+	return( (ssize_t) read_size );
+
+on_error:
+	if( is_loading != 0 )
+	{
+		libqcow_cache_pool_end_load(
+		 internal_file->cache_pool,
+		 &( internal_file->file_identity ),
+		 LIBQCOW_CACHE_POOL_VALUE_TYPE_COMPRESSED_CLUSTER_BLOCK,
+		 compressed_data_offset,
+		 NULL );
+	}
+	if( cluster_block != NULL )
+	{
+		if( is_pinned != 0 )
+		{
+			libqcow_cache_pool_unpin_cluster_block(
+			 internal_file->cache_pool,
+			 &cluster_block,
+			 NULL );
+		}
+		else
+		{
+			libqcow_cluster_block_free(
+			 &cluster_block,
+			 NULL );
+		}
+	}
+	return( -1 );
+}
+
+/* Reads (media) data of a range of encrypted cluster blocks into a buffer
+ * The range file offset contains the offset of the data in the file that corresponds
+ * to the (media) offset. The data is read and decrypted without the read/write lock
+ * of the file, using a copy of the encryption context of the file
+ * The caller must make sure the file is not closed during the read
+ * Returns the number of bytes read or -1 on error
+ */
+ssize_t libqcow_internal_file_read_encrypted_buffer_at_offset(
+         libqcow_internal_file_t *internal_file,
+         libbfio_handle_t *file_io_handle,
+         off64_t range_file_offset,
+         off64_t offset,
+         uint8_t *buffer,
+         size_t buffer_size,
+         libcerror_error_t **error )
+{
+	uint8_t encrypted_sector_data[ 512 ];
+	uint8_t sector_data[ 512 ];
+
+	libqcow_encryption_context_t *encryption_context = NULL;
+	static char *function                            = "libqcow_internal_file_read_encrypted_buffer_at_offset";
+	size_t buffer_offset                             = 0;
+	size_t data_offset                               = 0;
+	size_t read_size                                 = 0;
+	size_t sector_data_offset                        = 0;
+	ssize_t read_count                               = 0;
+
+	if( internal_file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	if( internal_file->encryption_context == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid file - missing encryption context.",
+		 function );
+
+		return( -1 );
+	}
+	if( range_file_offset < 0 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid range file offset value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	if( offset < 0 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid offset value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	if( buffer == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid buffer.",
+		 function );
+
+		return( -1 );
+	}
+	if( buffer_size > (size_t) SSIZE_MAX )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_EXCEEDS_MAXIMUM,
+		 "%s: invalid buffer size value exceeds maximum.",
+		 function );
+
+		return( -1 );
+	}
+	/* The AES contexts of the file cannot be used by multiple threads at the same time
+	 * and the encryption context does not change while the file is open
+	 */
+	if( libqcow_encryption_clone(
+	     &encryption_context,
+	     internal_file->encryption_context,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+		 "%s: unable to create encryption context.",
+		 function );
+
+		goto on_error;
+	}
+	while( buffer_offset < buffer_size )
+	{
+		/* The data is encrypted per sector of 512 bytes, where the block key
+		 * is the (media) sector number
+		 */
+		sector_data_offset = (size_t) ( offset % 512 );
+		read_size          = buffer_size - buffer_offset;
+
+		if( ( sector_data_offset != 0 )
+		 || ( read_size < 512 ) )
+		{
+			read_count = libbfio_handle_read_buffer_at_offset(
+			              file_io_handle,
+			              encrypted_sector_data,
+			              512,
+			              range_file_offset - (off64_t) sector_data_offset,
+			              error );
+
+			if( read_count != (ssize_t) 512 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_IO,
+				 LIBCERROR_IO_ERROR_READ_FAILED,
+				 "%s: unable to read encrypted sector data at file offset: %" PRIi64 " (0x%08" PRIx64 ").",
+				 function,
+				 range_file_offset - (off64_t) sector_data_offset,
+				 range_file_offset - (off64_t) sector_data_offset );
+
+				goto on_error;
+			}
+			if( libqcow_encryption_crypt(
+			     encryption_context,
+			     LIBQCOW_ENCYPTION_CRYPT_MODE_DECRYPT,
+			     encrypted_sector_data,
+			     512,
+			     sector_data,
+			     512,
+			     (uint64_t) offset / 512,
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_ENCRYPTION,
+				 LIBCERROR_ENCRYPTION_ERROR_GENERIC,
+				 "%s: unable to decrypt sector data.",
+				 function );
+
+				goto on_error;
+			}
+			if( read_size > ( 512 - sector_data_offset ) )
+			{
+				read_size = 512 - sector_data_offset;
+			}
+			if( memory_copy(
+			     &( buffer[ buffer_offset ] ),
+			     &( sector_data[ sector_data_offset ] ),
+			     read_size ) == NULL )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_MEMORY,
+				 LIBCERROR_MEMORY_ERROR_COPY_FAILED,
+				 "%s: unable to copy sector data to buffer.",
+				 function );
+
+				goto on_error;
+			}
+		}
+		else
+		{
+			read_size -= read_size % 512;
+
+			read_count = libbfio_handle_read_buffer_at_offset(
+			              file_io_handle,
+			              &( buffer[ buffer_offset ] ),
+			              read_size,
+			              range_file_offset,
+			              error );
+
+			if( read_count != (ssize_t) read_size )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_IO,
+				 LIBCERROR_IO_ERROR_READ_FAILED,
+				 "%s: unable to read: %" PRIzd " bytes of encrypted data at file offset: %" PRIi64 " (0x%08" PRIx64 ").",
+				 function,
+				 read_size,
+				 range_file_offset,
+				 range_file_offset );
+
+				goto on_error;
+			}
+			/* The sectors are decrypted in place via a copy of the encrypted sector data
+			 */
+			for( data_offset = 0;
+			     data_offset < read_size;
+			     data_offset += 512 )
+			{
+				if( memory_copy(
+				     encrypted_sector_data,
+				     &( buffer[ buffer_offset + data_offset ] ),
+				     512 ) == NULL )
+				{
+					libcerror_error_set(
+					 error,
+					 LIBCERROR_ERROR_DOMAIN_MEMORY,
+					 LIBCERROR_MEMORY_ERROR_COPY_FAILED,
+					 "%s: unable to copy encrypted sector data.",
+					 function );
+
+					goto on_error;
+				}
+				if( libqcow_encryption_crypt(
+				     encryption_context,
+				     LIBQCOW_ENCYPTION_CRYPT_MODE_DECRYPT,
+				     encrypted_sector_data,
+				     512,
+				     &( buffer[ buffer_offset + data_offset ] ),
+				     512,
+				     (uint64_t) ( offset + (off64_t) data_offset ) / 512,
+				     error ) != 1 )
+				{
+					libcerror_error_set(
+					 error,
+					 LIBCERROR_ERROR_DOMAIN_ENCRYPTION,
+					 LIBCERROR_ENCRYPTION_ERROR_GENERIC,
+					 "%s: unable to decrypt sector data.",
+					 function );
+
+					goto on_error;
+				}
+			}
+		}
+		buffer_offset     += read_size;
+		offset            += (off64_t) read_size;
+		range_file_offset += (off64_t) read_size;
+	}
+	if( memory_set(
+	     sector_data,
+	     0,
+	     512 ) == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_SET_FAILED,
+		 "%s: unable to clear sector data.",
+		 function );
+
+		goto on_error;
+	}
+	if( libqcow_encryption_free(
+	     &encryption_context,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+		 "%s: unable to free encryption context.",
+		 function );
+
+		goto on_error;
+	}
+	return( (ssize_t) buffer_offset );
+
+on_error:
+	memory_set(
+	 sector_data,
+	 0,
+	 512 );
+
+	if( encryption_context != NULL )
+	{
+		libqcow_encryption_free(
+		 &encryption_context,
+		 NULL );
+	}
+	return( -1 );
+}
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+
+/* Pushes decode jobs that read and decode a compressed or encrypted range
+ * The range of encrypted cluster blocks is divided into a decode job per thread of the scheduler
+ * The decode jobs are prepended to the decode jobs, when the maximum number of decode jobs
+ * is pending the function waits for the decode jobs of the scheduler batch to complete first
+ * The caller must make sure the file is not closed during the read
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_internal_file_push_read_decode_jobs(
+     libqcow_internal_file_t *internal_file,
+     libqcow_scheduler_batch_t *scheduler_batch,
+     libqcow_decode_job_t **decode_jobs,
+     uint8_t decode_type,
+     off64_t range_file_offset,
+     off64_t offset,
+     uint8_t *buffer,
+     size_t buffer_size,
+     libcerror_error_t **error )
+{
+	libqcow_decode_job_t *decode_job = NULL;
+	static char *function            = "libqcow_internal_file_push_read_decode_jobs";
+	size_t buffer_offset             = 0;
+	size_t part_size                 = 0;
+	size_t read_size                 = 0;
+	int number_of_threads            = 0;
+
+	if( internal_file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	if( internal_file->cluster_block_size == 0 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid file - cluster block size value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	if( scheduler_batch == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid scheduler batch.",
+		 function );
+
+		return( -1 );
+	}
+	if( decode_jobs == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid decode jobs.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( decode_type != LIBQCOW_DECODE_JOB_TYPE_READ_COMPRESSED )
+	 && ( decode_type != LIBQCOW_DECODE_JOB_TYPE_READ_ENCRYPTED ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_UNSUPPORTED_VALUE,
+		 "%s: unsupported decode type.",
+		 function );
+
+		return( -1 );
+	}
+	if( buffer == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid buffer.",
+		 function );
+
+		return( -1 );
+	}
+	if( buffer_size > (size_t) SSIZE_MAX )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_EXCEEDS_MAXIMUM,
+		 "%s: invalid buffer size value exceeds maximum.",
+		 function );
+
+		return( -1 );
+	}
+	/* The parts of a range of encrypted cluster blocks start at a multiple
+	 * of the part size, which is a multiple of the cluster block size
+	 */
+	part_size = buffer_size;
+
+	if( ( decode_type == LIBQCOW_DECODE_JOB_TYPE_READ_ENCRYPTED )
+	 && ( scheduler_batch->scheduler != NULL ) )
+	{
+		if( libqcow_scheduler_get_number_of_threads(
+		     scheduler_batch->scheduler,
+		     &number_of_threads,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+			 "%s: unable to retrieve number of threads of scheduler.",
+			 function );
+
+			return( -1 );
+		}
+		if( number_of_threads > 1 )
+		{
+			part_size = buffer_size / (size_t) number_of_threads;
+		}
+		if( part_size < internal_file->cluster_block_size )
+		{
+			part_size = (size_t) internal_file->cluster_block_size;
+		}
+		else if( ( part_size % internal_file->cluster_block_size ) != 0 )
+		{
+			part_size += (size_t) ( internal_file->cluster_block_size - ( part_size % internal_file->cluster_block_size ) );
+		}
+	}
+	while( buffer_offset < buffer_size )
+	{
+		read_size = buffer_size - buffer_offset;
+
+		if( decode_type == LIBQCOW_DECODE_JOB_TYPE_READ_ENCRYPTED )
+		{
+			if( read_size > ( part_size - (size_t) ( (size64_t) offset % part_size ) ) )
+			{
+				read_size = part_size - (size_t) ( (size64_t) offset % part_size );
+			}
+		}
+		if( scheduler_batch->number_of_jobs >= LIBQCOW_MAXIMUM_NUMBER_OF_DECODE_JOBS )
+		{
+			if( libqcow_internal_file_wait_for_decode_jobs(
+			     internal_file,
+			     scheduler_batch,
+			     decode_jobs,
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+				 "%s: unable to wait for decode jobs.",
+				 function );
+
+				return( -1 );
+			}
+		}
+		if( libqcow_decode_job_initialize(
+		     &decode_job,
+		     (libqcow_file_t *) internal_file,
+		     decode_type,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+			 "%s: unable to create decode job.",
+			 function );
+
+			return( -1 );
+		}
+		decode_job->buffer      = &( buffer[ buffer_offset ] );
+		decode_job->buffer_size = read_size;
+		decode_job->file_offset = range_file_offset;
+		decode_job->offset      = offset;
+
+		decode_job->next_decode_job = *decode_jobs;
+		*decode_jobs                = decode_job;
+
+		decode_job = NULL;
+
+		if( libqcow_scheduler_batch_push_job(
+		     scheduler_batch,
+		     (int (*)(intptr_t *, void *)) &libqcow_decode_job_callback,
+		     (intptr_t *) *decode_jobs,
+		     NULL,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_APPEND_FAILED,
+			 "%s: unable to push decode job.",
+			 function );
+
+			return( -1 );
+		}
+		buffer_offset     += read_size;
+		offset            += (off64_t) read_size;
+		range_file_offset += (off64_t) read_size;
+	}
+	return( 1 );
+}
+
+#endif /* defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT ) */
+
+/* Reads (media) data of the ranges at a specific offset into a buffer
+ * The data in the memory mapped file is read without the read/write lock of the file.
+ * Consecutive cluster blocks that can be read directly from the file are looked up in the
+ * published level 2 tables with the read/write lock of the file grabbed for reading and read
+ * without it, using a file IO handle of the file IO pool, compressed and encrypted cluster blocks
+ * are read and decompressed or decrypted without it as well. Cluster blocks of level 2 tables
+ * that are not published are looked up and the remainder, such as partially read compressed
+ * cluster blocks without a cache pool, is read with the read/write lock of the file grabbed for writing
+ * The compressed and encrypted ranges are read and decoded by decode jobs of the scheduler
+ * batch, if any, the buffer contains the data of these ranges once the decode jobs have completed
+ * The read stops between ranges and cluster blocks when the file was signalled to abort
+ * since the abort generation was retrieved, or when the read control, if any, was cancelled
+ * or has passed its deadline. The number of bytes read so far is then returned, or -1 if
+ * no bytes were read
+ * The current offset of the file is not changed
+ * The caller must make sure the file is not closed during the read
+ * Returns the number of bytes read or -1 on error
+ */
+ssize_t libqcow_internal_file_read_ranges_at_offset(
+         libqcow_internal_file_t *internal_file,
+         uint8_t *buffer,
+         size_t buffer_size,
+         off64_t offset,
+         libqcow_read_control_t *read_control,
+         uint32_t abort_generation,
+         libqcow_scheduler_batch_t *scheduler_batch,
+         libqcow_decode_job_t **decode_jobs,
+         libcerror_error_t **error )
+{
+	libbfio_handle_t *file_io_handle            = NULL;
+	static char *function                       = "libqcow_internal_file_read_ranges_at_offset";
+	size64_t media_size                         = 0;
+	size_t buffer_offset                        = 0;
+	size_t read_size                            = 0;
+	ssize_t read_count                          = 0;
+	off64_t range_file_offset                   = 0;
+	int result                                  = 0;
+
+	if( internal_file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	if( internal_file->file_io_handle == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid file - missing file IO handle.",
+		 function );
+
+		return( -1 );
+	}
+	if( internal_file->file_header == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid file - missing file header.",
+		 function );
+
+		return( -1 );
+	}
+	media_size = internal_file->file_header->media_size;
+
+	while( ( buffer_offset < buffer_size )
+	    && ( (size64_t) offset < media_size ) )
+	{
+		result = libqcow_internal_file_read_is_stopped(
+		          internal_file,
+		          read_control,
+		          abort_generation,
+		          error );
+
+		if( result == -1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+			 "%s: unable to determine if read is stopped.",
+			 function );
+
+			return( -1 );
+		}
+		else if( result != 0 )
+		{
+			break;
+		}
+		/* The ranges are limited in size so that a stopped read is noticed
+		 */
+		read_size = buffer_size - buffer_offset;
+
+		if( read_size > LIBQCOW_MAXIMUM_READ_RANGE_SIZE )
+		{
+			read_size = LIBQCOW_MAXIMUM_READ_RANGE_SIZE;
+		}
+		read_count = libqcow_internal_file_read_mapped_buffer_at_offset(
+		              internal_file,
+		              &( buffer[ buffer_offset ] ),
+		              read_size,
+		              offset,
+		              error );
+
+		if( read_count == -1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_IO,
+			 LIBCERROR_IO_ERROR_READ_FAILED,
+			 "%s: unable to read buffer from mapped file.",
+			 function );
+
+			return( -1 );
+		}
+		buffer_offset += (size_t) read_count;
+		offset        += (off64_t) read_count;
+
+		if( ( buffer_offset >= buffer_size )
+		 || ( (size64_t) offset >= media_size ) )
+		{
+			break;
+		}
+		else if( (size_t) read_count == read_size )
+		{
+			continue;
+		}
+		read_size = buffer_size - buffer_offset;
+		result    = 0;
+
+		if( read_size > LIBQCOW_MAXIMUM_READ_RANGE_SIZE )
+		{
+			read_size = LIBQCOW_MAXIMUM_READ_RANGE_SIZE;
+		}
+		/* The range is looked up in the published level 2 tables first, which only
+		 * requires the read/write lock of the file grabbed for reading
+		 */
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+		if( libcthreads_read_write_lock_grab_for_read(
+		     internal_file->read_write_lock,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+			 "%s: unable to grab read/write lock for reading.",
+			 function );
+
+			return( -1 );
+		}
+#endif
+		if( internal_file->file_io_handle_cannot_be_cloned == 0 )
+		{
+			result = libqcow_internal_file_get_direct_read_range(
+			          internal_file,
+			          offset,
+			          read_size,
+			          1,
+			          &range_file_offset,
+			          &read_size,
+			          error );
+
+			if( result == -1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+				 "%s: unable to retrieve direct read range for offset: %" PRIi64 " (0x%08" PRIx64 ").",
+				 function,
+				 offset,
+				 offset );
+			}
+			/* The file IO pool is opened with the read/write lock grabbed for writing
+			 */
+			else if( ( result >= 1 )
+			      && ( internal_file->file_io_pool == NULL ) )
+			{
+				read_size = 0;
+				result    = 0;
+			}
+		}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+		if( libcthreads_read_write_lock_release_for_read(
+		     internal_file->read_write_lock,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+			 "%s: unable to release read/write lock for reading.",
+			 function );
+
+			return( -1 );
+		}
+#endif
+		if( result == -1 )
+		{
+			return( -1 );
+		}
+		else if( result == 0 )
+		{
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+			if( libcthreads_read_write_lock_grab_for_write(
+			     internal_file->read_write_lock,
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+				 "%s: unable to grab read/write lock for writing.",
+				 function );
+
+				return( -1 );
+			}
+#endif
+			/* A range size of 0 indicates that the range could not be determined
+			 * from the published level 2 tables or that the file IO pool is not open
+			 */
+			if( ( internal_file->file_io_handle_cannot_be_cloned == 0 )
+			 && ( read_size == 0 ) )
+			{
+				read_size = buffer_size - buffer_offset;
+
+				if( read_size > LIBQCOW_MAXIMUM_READ_RANGE_SIZE )
+				{
+					read_size = LIBQCOW_MAXIMUM_READ_RANGE_SIZE;
+				}
+				result = libqcow_internal_file_get_direct_read_range(
+				          internal_file,
+				          offset,
+				          read_size,
+				          0,
+				          &range_file_offset,
+				          &read_size,
+				          error );
+
+				if( result == -1 )
+				{
+					libcerror_error_set(
+					 error,
+					 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+					 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+					 "%s: unable to retrieve direct read range for offset: %" PRIi64 " (0x%08" PRIx64 ").",
+					 function,
+					 offset,
+					 offset );
+				}
+				else if( ( result >= 1 )
+				      && ( internal_file->file_io_pool == NULL ) )
+				{
+					if( libqcow_internal_file_open_file_io_pool(
+					     internal_file,
+					     error ) != 1 )
+					{
+						libcerror_error_set(
+						 error,
+						 LIBCERROR_ERROR_DOMAIN_IO,
+						 LIBCERROR_IO_ERROR_OPEN_FAILED,
+						 "%s: unable to open file IO pool.",
+						 function );
+
+						result = -1;
+					}
+					else if( internal_file->file_io_pool == NULL )
+					{
+						result = 0;
+					}
+				}
+				if( ( result == 0 )
+				 && ( ( internal_file->file_io_handle_cannot_be_cloned != 0 )
+				  ||  ( read_size == 0 ) ) )
+				{
+					read_size = buffer_size - buffer_offset;
+
+					if( read_size > LIBQCOW_MAXIMUM_READ_RANGE_SIZE )
+					{
+						read_size = LIBQCOW_MAXIMUM_READ_RANGE_SIZE;
+					}
+				}
+			}
+			if( result == 0 )
+			{
+				read_count = libqcow_internal_file_read_buffer_from_file_io_handle(
+				              internal_file,
+				              internal_file->file_io_handle,
+				              &( buffer[ buffer_offset ] ),
+				              read_size,
+				              offset,
+				              read_control,
+				              abort_generation,
+				              error );
+
+				if( read_count == -1 )
+				{
+					libcerror_error_set(
+					 error,
+					 LIBCERROR_ERROR_DOMAIN_IO,
+					 LIBCERROR_IO_ERROR_READ_FAILED,
+					 "%s: unable to read buffer.",
+					 function );
+
+					result = -1;
+				}
+			}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+			if( libcthreads_read_write_lock_release_for_write(
+			     internal_file->read_write_lock,
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+				 "%s: unable to release read/write lock for writing.",
+				 function );
+
+				return( -1 );
+			}
+#endif
+			if( result == -1 )
+			{
+				return( -1 );
+			}
+		}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+		if( ( scheduler_batch != NULL )
+		 && ( result >= 2 ) )
+		{
+			if( libqcow_internal_file_push_read_decode_jobs(
+			     internal_file,
+			     scheduler_batch,
+			     decode_jobs,
+			     ( result == 2 ) ? LIBQCOW_DECODE_JOB_TYPE_READ_COMPRESSED : LIBQCOW_DECODE_JOB_TYPE_READ_ENCRYPTED,
+			     range_file_offset,
+			     offset,
+			     &( buffer[ buffer_offset ] ),
+			     read_size,
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_APPEND_FAILED,
+				 "%s: unable to push decode jobs for offset: %" PRIi64 " (0x%08" PRIx64 ").",
+				 function,
+				 offset,
+				 offset );
+
+				return( -1 );
+			}
+			read_count = (ssize_t) read_size;
+		}
+		else
+#endif
+		if( result >= 1 )
+		{
+			/* The file IO pool is not freed while the file is open
+			 */
+			if( libqcow_file_io_pool_grab_handle(
+			     internal_file->file_io_pool,
+			     &file_io_handle,
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+				 "%s: unable to grab file IO handle from file IO pool.",
+				 function );
+
+				return( -1 );
+			}
+			if( result == 3 )
+			{
+				read_count = libqcow_internal_file_read_encrypted_buffer_at_offset(
+				              internal_file,
+				              file_io_handle,
+				              range_file_offset,
+				              offset,
+				              &( buffer[ buffer_offset ] ),
+				              read_size,
+				              error );
+
+				if( read_count != (ssize_t) read_size )
+				{
+					libcerror_error_set(
+					 error,
+					 LIBCERROR_ERROR_DOMAIN_IO,
+					 LIBCERROR_IO_ERROR_READ_FAILED,
+					 "%s: unable to read: %" PRIzd " bytes of encrypted data at file offset: %" PRIi64 " (0x%08" PRIx64 ").",
+					 function,
+					 read_size,
+					 range_file_offset,
+					 range_file_offset );
+
+					read_count = -1;
+				}
+			}
+			else if( result == 2 )
+			{
+				read_count = libqcow_internal_file_read_compressed_buffer_at_offset(
+				              internal_file,
+				              file_io_handle,
+				              (uint64_t) range_file_offset,
+				              (uint64_t) offset & internal_file->cluster_block_bit_mask,
+				              &( buffer[ buffer_offset ] ),
+				              read_size,
+				              error );
+
+				if( read_count != (ssize_t) read_size )
+				{
+					libcerror_error_set(
+					 error,
+					 LIBCERROR_ERROR_DOMAIN_IO,
+					 LIBCERROR_IO_ERROR_READ_FAILED,
+					 "%s: unable to read: %" PRIzd " bytes of compressed cluster block at offset: %" PRIi64 " (0x%08" PRIx64 ").",
+					 function,
+					 read_size,
+					 offset,
+					 offset );
+
+					read_count = -1;
+				}
+			}
+			else
+			{
+				read_count = libbfio_handle_read_buffer_at_offset(
+				              file_io_handle,
+				              &( buffer[ buffer_offset ] ),
+				              read_size,
+				              range_file_offset,
+				              error );
+
+				if( read_count != (ssize_t) read_size )
+				{
+					libcerror_error_set(
+					 error,
+					 LIBCERROR_ERROR_DOMAIN_IO,
+					 LIBCERROR_IO_ERROR_READ_FAILED,
+					 "%s: unable to read: %" PRIzd " bytes at file offset: %" PRIi64 " (0x%08" PRIx64 ").",
+					 function,
+					 read_size,
+					 range_file_offset,
+					 range_file_offset );
+
+					read_count = -1;
+				}
+			}
+			if( libqcow_file_io_pool_release_handle(
+			     internal_file->file_io_pool,
+			     file_io_handle,
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+				 "%s: unable to release file IO handle to file IO pool.",
+				 function );
+
+				read_count = -1;
+			}
+			file_io_handle = NULL;
+
+			if( read_count == -1 )
+			{
+				return( -1 );
+			}
+		}
+		else if( read_count == 0 )
+		{
+			break;
+		}
+		buffer_offset += (size_t) read_count;
+		offset        += (off64_t) read_count;
+	}
+	if( ( buffer_offset == 0 )
+	 && ( buffer_size > 0 )
+	 && ( (size64_t) offset < media_size ) )
+	{
+		result = libqcow_internal_file_read_is_stopped(
+		          internal_file,
+		          read_control,
+		          abort_generation,
+		          error );
+
+		if( result == -1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+			 "%s: unable to determine if read is stopped.",
+			 function );
+
+			return( -1 );
+		}
+		else if( result != 0 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_ABORT_REQUESTED,
+			 "%s: read stopped before any data was read.",
+			 function );
+
+			return( -1 );
+		}
+	}
+	return( (ssize_t) buffer_offset );
+}
+
+/* Reads (media) data at a specific offset into a buffer
+ * The ranges are read by libqcow_internal_file_read_ranges_at_offset, when a scheduler
+ * is set the compressed and encrypted ranges are read and decoded by decode jobs of
+ * the scheduler, while the next ranges are looked up and read by the calling thread
+ * The function returns once the decode jobs have completed
+ * The current offset of the file is not changed
+ * The caller must make sure the file is not closed during the read
+ * Returns the number of bytes read or -1 on error
+ */
+ssize_t libqcow_internal_file_read_buffer_at_offset(
+         libqcow_internal_file_t *internal_file,
+         uint8_t *buffer,
+         size_t buffer_size,
+         off64_t offset,
+         libqcow_read_control_t *read_control,
+         uint32_t abort_generation,
+         libcerror_error_t **error )
+{
+	libqcow_decode_job_t *decode_jobs          = NULL;
+	libqcow_scheduler_batch_t *scheduler_batch = NULL;
+	static char *function                      = "libqcow_internal_file_read_buffer_at_offset";
+	ssize_t read_count                         = 0;
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	libcerror_error_t *decode_error            = NULL;
+	libqcow_decode_job_t *decode_job           = NULL;
+	int result                                 = 0;
+#endif
+
+	if( internal_file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( ( internal_file->scheduler != NULL )
+	 && ( internal_file->decode_scheduler_queue != NULL ) )
+	{
+		if( libqcow_scheduler_batch_initialize(
+		     &scheduler_batch,
+		     internal_file->scheduler,
+		     internal_file->decode_scheduler_queue,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+			 "%s: unable to create scheduler batch.",
+			 function );
+
+			return( -1 );
+		}
+	}
+#endif
+	read_count = libqcow_internal_file_read_ranges_at_offset(
+	              internal_file,
+	              buffer,
+	              buffer_size,
+	              offset,
+	              read_control,
+	              abort_generation,
+	              scheduler_batch,
+	              &decode_jobs,
+	              error );
+
+	if( read_count == -1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_IO,
+		 LIBCERROR_IO_ERROR_READ_FAILED,
+		 "%s: unable to read ranges.",
+		 function );
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( scheduler_batch != NULL )
+	{
+		/* The decode jobs write into the buffer, hence they are waited for
+		 * even if the read failed, in which case their errors are discarded
+		 */
+		if( read_count == -1 )
+		{
+			result = libqcow_internal_file_wait_for_decode_jobs(
+			          internal_file,
+			          scheduler_batch,
+			          &decode_jobs,
+			          &decode_error );
+
+			if( decode_error != NULL )
+			{
+				libcerror_error_free(
+				 &decode_error );
+			}
+		}
+		else
+		{
+			result = libqcow_internal_file_wait_for_decode_jobs(
+			          internal_file,
+			          scheduler_batch,
+			          &decode_jobs,
+			          error );
+
+			if( result != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_IO,
+				 LIBCERROR_IO_ERROR_READ_FAILED,
+				 "%s: unable to read compressed or encrypted ranges.",
+				 function );
+
+				read_count = -1;
+			}
+		}
+		/* The batch waits for the decode jobs that were pushed before the decode jobs are freed
+		 */
+		if( libqcow_scheduler_batch_free(
+		     &scheduler_batch,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+			 "%s: unable to free scheduler batch.",
+			 function );
+
+			read_count = -1;
+		}
+		while( decode_jobs != NULL )
+		{
+			decode_job  = decode_jobs;
+			decode_jobs = decode_job->next_decode_job;
+
+			libqcow_decode_job_free(
+			 &decode_job,
+			 NULL );
+		}
+	}
+#endif
+	return( read_count );
+}
+
+/* Reads (media) data from the current offset into a buffer
+ * Returns the number of bytes read or -1 on error
+ */
+ssize_t libqcow_file_read_buffer(
+         libqcow_file_t *file,
+         void *buffer,
+         size_t buffer_size,
+         libcerror_error_t **error )
+{
+	libqcow_internal_file_t *internal_file = NULL;
+	static char *function                  = "libqcow_file_read_buffer";
+	ssize_t read_count                     = 0;
+	uint32_t abort_generation              = 0;
+
+	if( file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	internal_file = (libqcow_internal_file_t *) file;
+
+	if( internal_file->file_io_handle == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid file - missing file IO handle.",
+		 function );
+
+		return( -1 );
+	}
+	/* The read is stopped when the file is signalled to abort after this point
+	 */
+	if( libqcow_internal_file_get_abort_generation(
+	     internal_file,
+	     &abort_generation,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+		 "%s: unable to retrieve abort generation.",
+		 function );
+
+		return( -1 );
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_grab_for_write(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab read/write lock for writing.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	read_count = libqcow_internal_file_read_buffer_from_file_io_handle(
+		      internal_file,
+		      internal_file->file_io_handle,
+		      buffer,
+		      buffer_size,
+		      internal_file->current_offset,
+		      NULL,
+		      abort_generation,
+		      error );
+
+	if( read_count == -1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_IO,
+		 LIBCERROR_IO_ERROR_READ_FAILED,
+		 "%s: unable to read buffer.",
+		 function );
+
+		read_count = -1;
+	}
+	else if( read_count > 0 )
+	{
+		internal_file->current_offset += (off64_t) read_count;
+	}
+	/* The read returns no data before the end of the media data when it was stopped
+	 */
+	else if( ( read_count == 0 )
+	      && ( buffer_size > 0 )
+	      && ( (size64_t) internal_file->current_offset < internal_file->file_header->media_size ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_ABORT_REQUESTED,
+		 "%s: abort requested.",
+		 function );
+
+		read_count = -1;
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_release_for_write(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release read/write lock for writing.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	return( read_count );
+}
+
+/* Reads (media) data at a specific offset
+ * Returns the number of bytes read or -1 on error
+ */
+ssize_t libqcow_file_read_buffer_at_offset(
+         libqcow_file_t *file,
+         void *buffer,
+         size_t buffer_size,
+         off64_t offset,
+         libcerror_error_t **error )
+{
+	libqcow_internal_file_t *internal_file = NULL;
+	static char *function                  = "libqcow_file_read_buffer_at_offset";
+	ssize_t read_count                     = 0;
+	uint32_t abort_generation              = 0;
+
+	if( file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	internal_file = (libqcow_internal_file_t *) file;
+
+	if( internal_file->file_io_handle == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid file - missing file IO handle.",
+		 function );
+
+		return( -1 );
+	}
+	/* The read is stopped when the file is signalled to abort after this point
+	 */
+	if( libqcow_internal_file_get_abort_generation(
+	     internal_file,
+	     &abort_generation,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+		 "%s: unable to retrieve abort generation.",
+		 function );
+
+		return( -1 );
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_grab_for_write(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab read/write lock for writing.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	if( libqcow_internal_file_seek_offset(
+	     internal_file,
+	     offset,
+	     SEEK_SET,
+	     error ) == -1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_IO,
+		 LIBCERROR_IO_ERROR_SEEK_FAILED,
+		 "%s: unable to seek offset.",
+		 function );
+
+		read_count = -1;
+	}
+	else
+	{
+		read_count = libqcow_internal_file_read_buffer_from_file_io_handle(
+			      internal_file,
+			      internal_file->file_io_handle,
+			      buffer,
+			      buffer_size,
+			      internal_file->current_offset,
+			      NULL,
+			      abort_generation,
+			      error );
+
+		if( read_count == -1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_IO,
+			 LIBCERROR_IO_ERROR_READ_FAILED,
+			 "%s: unable to read buffer.",
+			 function );
+
+			read_count = -1;
+		}
+		else if( read_count > 0 )
+		{
+			internal_file->current_offset += (off64_t) read_count;
+		}
+		/* The read returns no data before the end of the media data when it was stopped
+		 */
+		else if( ( read_count == 0 )
+		      && ( buffer_size > 0 )
+		      && ( (size64_t) internal_file->current_offset < internal_file->file_header->media_size ) )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_ABORT_REQUESTED,
+			 "%s: abort requested.",
+			 function );
+
+			read_count = -1;
+		}
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_release_for_write(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release read/write lock for writing.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	return( read_count );
+}
+
+/* Reads (media) data at a specific offset, safe to use from multiple threads at the same time
+ * The current offset of the file is not changed
+ * The read/write lock of the file is only grabbed to register the read, which prevents the
+ * file from being closed during the read, and for the cluster blocks that need the caches
+ * of the file
+ * Returns the number of bytes read or -1 on error
+ */
+ssize_t libqcow_file_read_buffer_at_offset_concurrent(
+         libqcow_file_t *file,
+         void *buffer,
+         size_t buffer_size,
+         off64_t offset,
+         libcerror_error_t **error )
+{
+	static char *function = "libqcow_file_read_buffer_at_offset_concurrent";
+	ssize_t read_count    = 0;
+
+	read_count = libqcow_file_read_buffer_at_offset_with_timeout(
+	              file,
+	              buffer,
+	              buffer_size,
+	              offset,
+	              0,
+	              error );
+
+	if( read_count == -1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_IO,
+		 LIBCERROR_IO_ERROR_READ_FAILED,
+		 "%s: unable to read buffer.",
+		 function );
+
+		return( -1 );
+	}
+	return( read_count );
+}
+
+/* Reads (media) data at a specific offset within a timeout, safe to use from multiple threads
+ * at the same time like libqcow_file_read_buffer_at_offset_concurrent
+ * The deadline of the read is the time of the call plus the timeout in milliseconds,
+ * a timeout of 0 means the read has no deadline
+ * The read stops between cluster blocks and between the layers of the backing chain when
+ * the deadline has passed or the file was signalled to abort after the read started, the number
+ * of bytes read so far is then returned, or -1 if no bytes were read
+ * Returns the number of bytes read or -1 on error
+ */
+ssize_t libqcow_file_read_buffer_at_offset_with_timeout(
+         libqcow_file_t *file,
+         void *buffer,
+         size_t buffer_size,
+         off64_t offset,
+         uint32_t timeout,
+         libcerror_error_t **error )
+{
+	libqcow_read_control_t read_control;
+
+	libqcow_internal_file_t *internal_file = NULL;
+	static char *function                  = "libqcow_file_read_buffer_at_offset_with_timeout";
+	ssize_t read_count                     = 0;
+	uint32_t abort_generation              = 0;
+	int result                             = 1;
+
+	if( file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	internal_file = (libqcow_internal_file_t *) file;
+
+	if( buffer == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid buffer.",
+		 function );
+
+		return( -1 );
+	}
+	if( buffer_size > (size_t) SSIZE_MAX )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_EXCEEDS_MAXIMUM,
+		 "%s: invalid buffer size value exceeds maximum.",
+		 function );
+
+		return( -1 );
+	}
+	if( offset < 0 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_LESS_THAN_ZERO,
+		 "%s: invalid offset value less than zero.",
+		 function );
+
+		return( -1 );
+	}
+	if( memory_set(
+	     &read_control,
+	     0,
+	     sizeof( libqcow_read_control_t ) ) == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_SET_FAILED,
+		 "%s: unable to clear read control.",
+		 function );
+
+		return( -1 );
+	}
+	if( libqcow_read_control_set_timeout(
+	     &read_control,
+	     timeout,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to set timeout.",
+		 function );
+
+		return( -1 );
+	}
+	/* The read is stopped when the file is signalled to abort after this point
+	 */
+	if( libqcow_internal_file_get_abort_generation(
+	     internal_file,
+	     &abort_generation,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+		 "%s: unable to retrieve abort generation.",
+		 function );
+
+		return( -1 );
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_grab_for_write(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab read/write lock for writing.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	if( internal_file->file_io_handle == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid file - missing file IO handle.",
+		 function );
+
+		result = -1;
+	}
+	else if( internal_file->number_of_concurrent_reads == INT_MAX )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_EXCEEDS_MAXIMUM,
+		 "%s: invalid file - number of concurrent reads value exceeds maximum.",
+		 function );
+
+		result = -1;
+	}
+	else
+	{
+		internal_file->number_of_concurrent_reads += 1;
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_release_for_write(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release read/write lock for writing.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	if( result == -1 )
+	{
+		return( -1 );
+	}
+	read_count = libqcow_internal_file_read_buffer_at_offset(
+	              internal_file,
+	              (uint8_t *) buffer,
+	              buffer_size,
+	              offset,
+	              &read_control,
+	              abort_generation,
+	              error );
+
+	if( read_count == -1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_IO,
+		 LIBCERROR_IO_ERROR_READ_FAILED,
+		 "%s: unable to read buffer.",
+		 function );
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_grab_for_write(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab read/write lock for writing.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	internal_file->number_of_concurrent_reads -= 1;
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_release_for_write(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release read/write lock for writing.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	return( read_count );
+}
+
+/* Retrieves a pointer to the (media) data at a specific offset without copying it
+ * The data remains valid until the data pin is freed, which must be done before the file is closed
+ * The data size is the number of contiguous bytes available at the offset, which is at most
+ * the remainder of the cluster block
+ * This function is not multi-thread safe acquire write lock before call
+ * Returns 1 if successful, 0 if the offset is beyond the media size or -1 on error
+ */
+int libqcow_internal_file_get_data_at_offset(
+     libqcow_internal_file_t *internal_file,
+     off64_t offset,
+     const uint8_t **data,
+     size_t *data_size,
+     libqcow_data_pin_t **data_pin,
+     libcerror_error_t **error )
+{
+	libqcow_cache_pool_t *cache_pool       = NULL;
+	libqcow_cluster_block_t *cluster_block = NULL;
+	libqcow_data_pin_t *parent_data_pin    = NULL;
+	const uint8_t *parent_data             = NULL;
+	const uint8_t *safe_data               = NULL;
+	static char *function                  = "libqcow_internal_file_get_data_at_offset";
+	size_t parent_data_size                = 0;
+	size_t safe_data_size                  = 0;
+	uint64_t cluster_block_data_offset     = 0;
+	uint64_t cluster_block_file_offset     = 0;
+	uint32_t cluster_block_flags           = 0;
+	int result                             = 0;
+
+	if( internal_file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	if( internal_file->file_header == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid file - missing file header.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( internal_file->cluster_block_size == 0 )
+	 || ( internal_file->cluster_block_size > (size64_t) SSIZE_MAX ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid file - cluster block size value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	if( internal_file->backing_filename != NULL )
+	{
+		if( internal_file->parent_file == NULL )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+			 "%s: invalid file - missing parent file.",
+			 function );
+
+			return( -1 );
+		}
+	}
+	if( ( ( internal_file->file_header->incompatible_feature_flags & LIBQCOW_INCOMPATIBLE_FEATURE_FLAG_EXTERNAL_DATA_FILE ) != 0 )
+	 && ( internal_file->data_file_io_handle == NULL ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid file - missing data file.",
+		 function );
+
+		return( -1 );
+	}
+	if( offset < 0 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_LESS_THAN_ZERO,
+		 "%s: invalid offset value less than zero.",
+		 function );
+
+		return( -1 );
+	}
+	if( data == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid data.",
+		 function );
+
+		return( -1 );
+	}
+	if( data_size == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid data size.",
+		 function );
+
+		return( -1 );
+	}
+	if( data_pin == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid data pin.",
+		 function );
+
+		return( -1 );
+	}
+	if( *data_pin != NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_ALREADY_SET,
+		 "%s: invalid data pin value already set.",
+		 function );
+
+		return( -1 );
+	}
+	if( (size64_t) offset >= internal_file->file_header->media_size )
+	{
+		return( 0 );
+	}
+	if( libqcow_internal_file_get_cluster_block_offset(
+	     internal_file,
+	     internal_file->file_io_handle,
+	     internal_file->level1_table,
+	     offset,
+	     &cluster_block_file_offset,
+	     &cluster_block_data_offset,
+	     &safe_data_size,
+	     &cluster_block_flags,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+		 "%s: unable to retrieve cluster block offset for offset: %" PRIi64 " (0x%08" PRIx64 ").",
+		 function,
+		 offset,
+		 offset );
+
+		goto on_error;
+	}
+	if( (size64_t) safe_data_size > ( internal_file->file_header->media_size - offset ) )
+	{
+		safe_data_size = (size_t) ( internal_file->file_header->media_size - offset );
+	}
+	if( ( ( cluster_block_file_offset > 0 )
+	  || ( ( cluster_block_flags & LIBQCOW_CLUSTER_BLOCK_FLAG_IN_DATA_FILE ) != 0 ) )
+	 && ( ( cluster_block_flags & LIBQCOW_CLUSTER_BLOCK_FLAG_IS_SPARSE ) == 0 ) )
+	{
+		result = libqcow_internal_file_read_cluster_block(
+		          internal_file,
+		          internal_file->file_io_handle,
+		          offset,
+		          cluster_block_file_offset,
+		          cluster_block_data_offset,
+		          cluster_block_flags,
+		          &cluster_block,
+		          error );
+
+		if( result != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_IO,
+			 LIBCERROR_IO_ERROR_READ_FAILED,
+			 "%s: unable to read cluster block.",
+			 function );
+
+			goto on_error;
+		}
+		if( cluster_block == NULL )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+			 "%s: invalid cluster block.",
+			 function );
+
+			goto on_error;
+		}
+		if( cluster_block->data == NULL )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+			 "%s: invalid cluster block - missing data.",
+			 function );
+
+			goto on_error;
+		}
+		if( cluster_block_data_offset >= cluster_block->data_size )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+			 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+			 "%s: invalid cluster block data offset value out of bounds.",
+			 function );
+
+			goto on_error;
+		}
+		if( safe_data_size > ( cluster_block->data_size - cluster_block_data_offset ) )
+		{
+			safe_data_size = cluster_block->data_size - cluster_block_data_offset;
+		}
+		safe_data = &( cluster_block->data[ cluster_block_data_offset ] );
+	}
+	else if( ( internal_file->parent_file != NULL )
+	      && ( ( cluster_block_flags & LIBQCOW_CLUSTER_BLOCK_FLAG_IS_ZERO ) == 0 ) )
+	{
+		result = libqcow_file_get_data_at_offset(
+		          internal_file->parent_file,
+		          offset,
+		          &parent_data,
+		          &parent_data_size,
+		          &parent_data_pin,
+		          error );
+
+		if( result == -1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+			 "%s: unable to retrieve data from parent file.",
+			 function );
+
+			goto on_error;
+		}
+		else if( result != 0 )
+		{
+			if( safe_data_size > parent_data_size )
+			{
+				safe_data_size = parent_data_size;
+			}
+			safe_data = parent_data;
+		}
+	}
+	if( safe_data == NULL )
+	{
+		/* Handle sparse cluster block
+		 */
+		if( internal_file->sparse_cluster_block == NULL )
+		{
+			if( libqcow_cluster_block_initialize(
+			     &( internal_file->sparse_cluster_block ),
+			     (size_t) internal_file->cluster_block_size,
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+				 "%s: unable to create sparse cluster block.",
+				 function );
+
+				goto on_error;
+			}
+			if( memory_set(
+			     internal_file->sparse_cluster_block->data,
+			     0,
+			     internal_file->sparse_cluster_block->data_size ) == NULL )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_MEMORY,
+				 LIBCERROR_MEMORY_ERROR_SET_FAILED,
+				 "%s: unable to clear sparse cluster block data.",
+				 function );
+
+				libqcow_cluster_block_free(
+				 &( internal_file->sparse_cluster_block ),
+				 NULL );
+
+				goto on_error;
+			}
+		}
+		cluster_block = internal_file->sparse_cluster_block;
+		safe_data     = cluster_block->data;
+	}
+	/* A cluster block of the cache pool is shared with other files
+	 * and is pinned under the lock of the cache pool
+	 */
+	if( ( cluster_block != NULL )
+	 && ( cluster_block == internal_file->cache_pool_cluster_block ) )
+	{
+		cache_pool = internal_file->cache_pool;
+
+		if( libqcow_cache_pool_pin_cluster_block(
+		     cache_pool,
+		     cluster_block,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+			 "%s: unable to pin cache pool cluster block.",
+			 function );
+
+			goto on_error;
+		}
+	}
+	else if( cluster_block != NULL )
+	{
+		if( libqcow_cluster_block_pin(
+		     cluster_block,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+			 "%s: unable to pin cluster block.",
+			 function );
+
+			goto on_error;
+		}
+	}
+	if( libqcow_data_pin_initialize(
+	     data_pin,
+	     (libqcow_file_t *) internal_file,
+	     cluster_block,
+	     cache_pool,
+	     parent_data_pin,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+		 "%s: unable to create data pin.",
+		 function );
+
+		if( cache_pool != NULL )
+		{
+			libqcow_cache_pool_unpin_cluster_block(
+			 cache_pool,
+			 &cluster_block,
+			 NULL );
+		}
+		else if( cluster_block != NULL )
+		{
+			libqcow_cluster_block_unpin(
+			 &cluster_block,
+			 NULL );
+		}
+		goto on_error;
+	}
+	internal_file->number_of_data_pins += 1;
+
+	*data      = safe_data;
+	*data_size = safe_data_size;
+
+	return( 1 );
+
+on_error:
+	if( parent_data_pin != NULL )
+	{
+		libqcow_data_pin_free(
+		 &parent_data_pin,
+		 NULL );
+	}
+	return( -1 );
+}
+
+/* Retrieves a pointer to the (media) data at a specific offset without copying it
+ * The data remains valid until the data pin is freed, which must be done before the file is closed
+ * The data size is the number of contiguous bytes available at the offset, which is at most
+ * the remainder of the cluster block
+ * Returns 1 if successful, 0 if the offset is beyond the media size or -1 on error
+ */
+int libqcow_file_get_data_at_offset(
+     libqcow_file_t *file,
+     off64_t offset,
+     const uint8_t **data,
+     size_t *data_size,
+     libqcow_data_pin_t **data_pin,
+     libcerror_error_t **error )
+{
+	libqcow_internal_file_t *internal_file = NULL;
+	static char *function                  = "libqcow_file_get_data_at_offset";
+	int result                             = 0;
+
+	if( file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	internal_file = (libqcow_internal_file_t *) file;
+
+	if( internal_file->file_io_handle == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid file - missing file IO handle.",
+		 function );
+
+		return( -1 );
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_grab_for_write(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab read/write lock for writing.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	result = libqcow_internal_file_get_data_at_offset(
+	          internal_file,
+	          offset,
+	          data,
+	          data_size,
+	          data_pin,
+	          error );
+
+	if( result == -1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+		 "%s: unable to retrieve data at offset: %" PRIi64 " (0x%08" PRIx64 ").",
+		 function,
+		 offset,
+		 offset );
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_release_for_write(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release read/write lock for writing.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	return( result );
+}
+
+/* Reads (media) data at a specific offset into a buffer asynchronously
+ * The read is queued on the scheduler of the file, or on the read thread pool of the file
+ * if no scheduler is set, and the read request is returned immediately,
+ * use libqcow_read_request_wait to retrieve the result
+ * The read is split into parts of whole cluster blocks, one per thread, that are read
+ * concurrently, the read request completes when all of its parts have completed
+ * The buffer must remain valid until the read request is freed
+ * Without multi-thread support the read is done before the function returns
+ * The current offset of the file is not changed
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_file_read_async(
+     libqcow_file_t *file,
+     void *buffer,
+     size_t buffer_size,
+     off64_t offset,
+     libqcow_read_request_t **read_request,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_file_read_async";
+
+	if( libqcow_file_read_async_with_timeout(
+	     file,
+	     buffer,
+	     buffer_size,
+	     offset,
+	     0,
+	     read_request,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_IO,
+		 LIBCERROR_IO_ERROR_READ_FAILED,
+		 "%s: unable to read buffer.",
+		 function );
+
+		return( -1 );
+	}
+	return( 1 );
+}
+
+/* Reads (media) data at a specific offset into a buffer asynchronously within a timeout
+ * The read is queued like libqcow_file_read_async
+ * The deadline of the read is the time of the call plus the timeout in milliseconds,
+ * which includes the time the read request is queued, a timeout of 0 means the read
+ * has no deadline
+ * The read stops between cluster blocks and between the layers of the backing chain when
+ * the deadline has passed, the read request was cancelled or the file was signalled to abort
+ * after the read was queued, the number of bytes read so far is then the result of the read,
+ * or an error if no bytes were read
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_file_read_async_with_timeout(
+     libqcow_file_t *file,
+     void *buffer,
+     size_t buffer_size,
+     off64_t offset,
+     uint32_t timeout,
+     libqcow_read_request_t **read_request,
+     libcerror_error_t **error )
+{
+	libqcow_internal_file_t *internal_file = NULL;
+	static char *function                  = "libqcow_file_read_async_with_timeout";
+	size_t part_size                       = 0;
+	int number_of_threads                  = 1;
+	int result                             = 1;
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	libqcow_internal_read_request_t *internal_read_request = NULL;
+	int part_index                                         = 0;
+#endif
+
+	if( file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	internal_file = (libqcow_internal_file_t *) file;
+
+	if( internal_file->file_io_handle == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid file - missing file IO handle.",
+		 function );
+
+		return( -1 );
+	}
+	if( read_request == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid read request.",
+		 function );
+
+		return( -1 );
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_grab_for_write(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab read/write lock for writing.",
+		 function );
+
+		return( -1 );
+	}
+	if( internal_file->scheduler != NULL )
+	{
+		if( libqcow_scheduler_get_number_of_threads(
+		     internal_file->scheduler,
+		     &number_of_threads,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+			 "%s: unable to retrieve number of threads of scheduler.",
+			 function );
+
+			result = -1;
+		}
+		else if( internal_file->read_scheduler_queue == NULL )
+		{
+			if( libqcow_scheduler_queue_initialize(
+			     &( internal_file->read_scheduler_queue ),
+			     LIBQCOW_READ_REQUEST_MAXIMUM_NUMBER_OF_QUEUED_REQUESTS,
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+				 "%s: unable to create read scheduler queue.",
+				 function );
+
+				result = -1;
+			}
+		}
+	}
+	else
+	{
+		number_of_threads = LIBQCOW_READ_REQUEST_NUMBER_OF_THREADS;
+
+		if( internal_file->read_thread_pool == NULL )
+		{
+			if( libcthreads_thread_pool_create(
+			     &( internal_file->read_thread_pool ),
+			     NULL,
+			     LIBQCOW_READ_REQUEST_NUMBER_OF_THREADS,
+			     LIBQCOW_READ_REQUEST_MAXIMUM_NUMBER_OF_QUEUED_REQUESTS,
+			     (int (*)(intptr_t *, void *)) &libqcow_read_request_part_read_callback,
+			     NULL,
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+				 "%s: unable to create read thread pool.",
+				 function );
+
+				result = -1;
+			}
+		}
+	}
+#endif
+	if( result == 1 )
+	{
+		/* The read is split into a part per thread, where the parts consist of
+		 * whole cluster blocks so that no cluster block is read by more than one part
+		 */
+		part_size = buffer_size / (size_t) number_of_threads;
+
+		if( ( part_size % internal_file->cluster_block_size ) != 0 )
+		{
+			part_size += (size_t) ( internal_file->cluster_block_size - ( part_size % internal_file->cluster_block_size ) );
+		}
+		if( part_size < (size_t) internal_file->cluster_block_size )
+		{
+			part_size = (size_t) internal_file->cluster_block_size;
+		}
+		if( libqcow_read_request_initialize(
+		     read_request,
+		     file,
+		     (uint8_t *) buffer,
+		     buffer_size,
+		     offset,
+		     part_size,
+		     timeout,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+			 "%s: unable to create read request.",
+			 function );
+
+			result = -1;
+		}
+		else
+		{
+			internal_file->number_of_open_read_requests += 1;
+		}
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_release_for_write(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release read/write lock for writing.",
+		 function );
+
+		result = -1;
+	}
+#endif
+	if( result != 1 )
+	{
+		goto on_error;
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	/* The push blocks while the maximum number of jobs is queued
+	 * hence it is done without the read/write lock of the file
+	 */
+	internal_read_request = (libqcow_internal_read_request_t *) *read_request;
+
+	for( part_index = 0;
+	     part_index < internal_read_request->number_of_parts;
+	     part_index++ )
+	{
+		if( internal_file->scheduler != NULL )
+		{
+			result = libqcow_scheduler_push_job(
+			          internal_file->scheduler,
+			          internal_file->read_scheduler_queue,
+			          (int (*)(intptr_t *, void *)) &libqcow_read_request_part_read_callback,
+			          (intptr_t *) &( internal_read_request->parts[ part_index ] ),
+			          NULL,
+			          error );
+		}
+		else
+		{
+			result = libcthreads_thread_pool_push(
+			          internal_file->read_thread_pool,
+			          (intptr_t *) &( internal_read_request->parts[ part_index ] ),
+			          error );
+		}
+		if( result != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_APPEND_FAILED,
+			 "%s: unable to push part: %d of read request onto read threads.",
+			 function,
+			 part_index );
+
+			break;
+		}
+	}
+	if( result != 1 )
+	{
+		/* The parts that were not queued need to be completed for the read request
+		 * to complete, after the parts that were queued, before it can be freed
+		 */
+		while( part_index < internal_read_request->number_of_parts )
+		{
+			if( libqcow_internal_read_request_complete_part(
+			     internal_read_request,
+			     &( internal_read_request->parts[ part_index ] ),
+			     -1,
+			     NULL,
+			     NULL ) != 1 )
+			{
+				/* The read request cannot be freed without completing
+				 */
+				*read_request = NULL;
+
+				return( -1 );
+			}
+			part_index++;
+		}
+		goto on_error;
+	}
+#else
+	/* A failed read is reported by libqcow_read_request_wait
+	 */
+	if( libqcow_internal_read_request_read(
+	     (libqcow_internal_read_request_t *) *read_request,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_IO,
+		 LIBCERROR_IO_ERROR_READ_FAILED,
+		 "%s: unable to read buffer.",
+		 function );
+
+		goto on_error;
+	}
+#endif
+	return( 1 );
+
+on_error:
+	if( *read_request != NULL )
+	{
+		libqcow_read_request_free(
+		 read_request,
+		 NULL );
+	}
+	return( -1 );
+}
+
+/* Seeks a certain offset of the (media) data
+ * This function is not multi-thread safe acquire write lock before call
+ * Returns the offset if seek is successful or -1 on error
+ */
+off64_t libqcow_internal_file_seek_offset(
+         libqcow_internal_file_t *internal_file,
+         off64_t offset,
+         int whence,
+         libcerror_error_t **error )
+{
+	static char *function = "libqcow_internal_file_seek_offset";
+
+	if( internal_file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	if( internal_file->file_header == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid file - missing file header.",
+		 function );
+
+		return( -1 );
+	}
+	if( internal_file->backing_filename != NULL )
+	{
+		if( internal_file->parent_file == NULL )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+			 "%s: invalid file - missing parent file.",
+			 function );
+
+			return( -1 );
+		}
+	}
+	if( ( whence != SEEK_CUR )
+	 && ( whence != SEEK_END )
+	 && ( whence != SEEK_SET ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_UNSUPPORTED_VALUE,
+		 "%s: unsupported whence.",
+		 function );
+
+		return( -1 );
+	}
+	if( whence == SEEK_CUR )
+	{
+		offset += internal_file->current_offset;
+	}
+	else if( whence == SEEK_END )
+	{
+		offset += (off64_t) internal_file->file_header->media_size;
+	}
+	if( offset < 0 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid offset value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	internal_file->current_offset = offset;
+
+	return( offset );
+}
+
+/* Seeks a certain offset of the (media) data
+ * Returns the offset if seek is successful or -1 on error
+ */
+off64_t libqcow_file_seek_offset(
+         libqcow_file_t *file,
+         off64_t offset,
+         int whence,
+         libcerror_error_t **error )
+{
+	libqcow_internal_file_t *internal_file = NULL;
+	static char *function                  = "libqcow_file_seek_offset";
+
+	if( file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	internal_file = (libqcow_internal_file_t *) file;
+
+	if( internal_file->file_io_handle == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid file - missing file IO handle.",
+		 function );
+
+		return( -1 );
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_grab_for_write(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab read/write lock for writing.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	offset = libqcow_internal_file_seek_offset(
+	          internal_file,
+	          offset,
+	          whence,
+	          error );
+
+	if( offset == -1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_IO,
+		 LIBCERROR_IO_ERROR_SEEK_FAILED,
+		 "%s: unable to seek offset.",
+		 function );
+
+		offset = -1;
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_release_for_write(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release read/write lock for writing.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	return( offset );
+}
+
+/* Retrieves the current offset of the (media) data
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_file_get_offset(
+     libqcow_file_t *file,
+     off64_t *offset,
+     libcerror_error_t **error )
+{
+	libqcow_internal_file_t *internal_file = NULL;
+	static char *function                  = "libqcow_file_get_offset";
+
+	if( file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	internal_file = (libqcow_internal_file_t *) file;
+
+	if( internal_file->file_io_handle == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid file - missing file IO handle.",
+		 function );
+
+		return( -1 );
+	}
+	if( offset == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid offset.",
+		 function );
+
+		return( -1 );
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_grab_for_read(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab read/write lock for reading.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	*offset = internal_file->current_offset;
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_release_for_read(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release read/write lock for reading.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	return( 1 );
+}
+
+
+/* Creates a cursor
+ * The cursor has its own current offset and readahead data and shares the level 2 table
+ * and cluster block caches of the file, which allows multiple threads to each read
+ * a different part of the (media) data. The cursor must be freed before the file is closed
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_file_create_cursor(
+     libqcow_file_t *file,
+     libqcow_cursor_t **cursor,
+     libcerror_error_t **error )
+{
+	libqcow_internal_file_t *internal_file = NULL;
+	static char *function                  = "libqcow_file_create_cursor";
+	int result                             = 1;
+
+	if( file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	internal_file = (libqcow_internal_file_t *) file;
+
+	if( internal_file->file_io_handle == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid file - missing file IO handle.",
+		 function );
+
+		return( -1 );
+	}
+	if( cursor == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid cursor.",
+		 function );
+
+		return( -1 );
+	}
+	if( *cursor != NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_ALREADY_SET,
+		 "%s: invalid cursor value already set.",
+		 function );
+
+		return( -1 );
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_grab_for_write(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab read/write lock for writing.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	if( libqcow_cursor_initialize(
+	     cursor,
+	     file,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+		 "%s: unable to create cursor.",
+		 function );
+
+		result = -1;
+	}
+	else
+	{
+		internal_file->number_of_open_cursors += 1;
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_release_for_write(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release read/write lock for writing.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	return( result );
+}
+
+/* Sets the parent (backing) file of a differential image
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_file_set_parent_file(
+     libqcow_file_t *file,
+     libqcow_file_t *parent_file,
+     libcerror_error_t **error )
+{
+	libqcow_internal_file_t *internal_file = NULL;
+	static char *function                  = "libqcow_file_set_parent_file";
+
+	if( file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	internal_file = (libqcow_internal_file_t *) file;
+
+	if( internal_file->backing_filename == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid file - missing backing filename.",
+		 function );
+
+		return( -1 );
+	}
+	if( internal_file->parent_file != NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_ALREADY_SET,
+		 "%s: invalid file - parent file already set.",
+		 function );
+
+		return( -1 );
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_grab_for_write(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab read/write lock for writing.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	internal_file->parent_file = parent_file;
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_release_for_write(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release read/write lock for writing.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	return( 1 );
+}
+
+/* Sets the cache pool
+ * The cluster blocks of files opened on the same file are shared in the cache pool
+ * The file keeps a reference to the cache pool, a cache pool value of NULL removes
+ * the cache pool of the file. Without a cache pool the file creates a cache pool
+ * of its own when it is opened
+ * This function needs to be used before one of the open functions
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_file_set_cache_pool(
+     libqcow_file_t *file,
+     libqcow_cache_pool_t *cache_pool,
+     libcerror_error_t **error )
+{
+	libqcow_internal_file_t *internal_file = NULL;
+	static char *function                  = "libqcow_file_set_cache_pool";
+	int result                             = 1;
+
+	if( file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	internal_file = (libqcow_internal_file_t *) file;
+
+	if( internal_file->file_io_handle != NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_ALREADY_SET,
+		 "%s: invalid file - file IO handle already set.",
+		 function );
+
+		return( -1 );
+	}
+	if( cache_pool != NULL )
+	{
+		if( libqcow_cache_pool_reference(
+		     cache_pool,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+			 "%s: unable to reference cache pool.",
+			 function );
+
+			return( -1 );
+		}
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_grab_for_write(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab read/write lock for writing.",
+		 function );
+
+		if( cache_pool != NULL )
+		{
+			libqcow_cache_pool_free(
+			 &cache_pool,
+			 NULL );
+		}
+		return( -1 );
+	}
+#endif
+	if( internal_file->cache_pool != NULL )
+	{
+		if( libqcow_cache_pool_free(
+		     &( internal_file->cache_pool ),
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+			 "%s: unable to free cache pool.",
+			 function );
+
+			result = -1;
+		}
+	}
+	internal_file->cache_pool = cache_pool;
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_release_for_write(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release read/write lock for writing.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	return( result );
+}
+
+/* Sets the scheduler
+ * The asynchronous reads and scans of the file are run by the threads of the scheduler
+ * instead of threads of the file, the scheduler can be shared by the files of a process
+ * The threads of the scheduler also decompress and decrypt the cluster blocks of the file
+ * The file keeps a reference to the scheduler, a scheduler value of NULL removes
+ * the scheduler of the file
+ * This function needs to be used before one of the open functions
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_file_set_scheduler(
+     libqcow_file_t *file,
+     libqcow_scheduler_t *scheduler,
+     libcerror_error_t **error )
+{
+	libqcow_internal_file_t *internal_file = NULL;
+	static char *function                  = "libqcow_file_set_scheduler";
+	int result                             = 1;
+
+	if( file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	internal_file = (libqcow_internal_file_t *) file;
+
+	if( internal_file->file_io_handle != NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_ALREADY_SET,
+		 "%s: invalid file - file IO handle already set.",
+		 function );
+
+		return( -1 );
+	}
+	if( scheduler != NULL )
+	{
+		if( libqcow_scheduler_reference(
+		     scheduler,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+			 "%s: unable to reference scheduler.",
+			 function );
+
+			return( -1 );
+		}
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_grab_for_write(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab read/write lock for writing.",
+		 function );
+
+		if( scheduler != NULL )
+		{
+			libqcow_scheduler_free(
+			 &scheduler,
+			 NULL );
+		}
+		return( -1 );
+	}
+
+	/* A worker can still hold the queue after the last decode job has completed
+	 */
+	if( internal_file->decode_scheduler_queue != NULL )
+	{
+		if( libqcow_scheduler_wait_for_queue(
+		     internal_file->scheduler,
+		     internal_file->decode_scheduler_queue,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+			 "%s: unable to wait for decode scheduler queue.",
+			 function );
+
+			result = -1;
+		}
+		else if( libqcow_scheduler_queue_free(
+		          &( internal_file->decode_scheduler_queue ),
+		          error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+			 "%s: unable to free decode scheduler queue.",
+			 function );
+
+			result = -1;
+		}
+	}
+#endif
+	if( internal_file->scheduler != NULL )
+	{
+		if( libqcow_scheduler_free(
+		     &( internal_file->scheduler ),
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+			 "%s: unable to free scheduler.",
+			 function );
+
+			result = -1;
+		}
+	}
+	internal_file->scheduler = scheduler;
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	/* The decode jobs of the file are queued on a queue of their own so that
+	 * they are run in turn with the jobs of other files
+	 */
+	if( ( result == 1 )
+	 && ( internal_file->scheduler != NULL ) )
+	{
+		if( libqcow_scheduler_queue_initialize(
+		     &( internal_file->decode_scheduler_queue ),
+		     0,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+			 "%s: unable to create decode scheduler queue.",
+			 function );
+
+			result = -1;
+		}
+	}
+	if( libcthreads_read_write_lock_release_for_write(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release read/write lock for writing.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	return( result );
+}
+
+/* Set the keys
+ * This function needs to be used before one of the open functions
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_file_set_keys(
+     libqcow_file_t *file,
+     const uint8_t *key,
+     size_t key_size,
+     libcerror_error_t **error )
+{
+	libqcow_internal_file_t *internal_file = NULL;
+	static char *function                  = "libqcow_file_set_keys";
+
+	if( file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	internal_file = (libqcow_internal_file_t *) file;
+
+	if( internal_file->file_io_handle != NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_ALREADY_SET,
+		 "%s: invalid file - file IO handle already set.",
+		 function );
+
+		return( -1 );
+	}
+	if( key == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid key.",
+		 function );
+
+		return( -1 );
+	}
+	if( key_size != 16 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_UNSUPPORTED_VALUE,
+		 "%s: unsupported key size.",
+		 function );
+
+		return( -1 );
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_grab_for_write(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab read/write lock for writing.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	if( memory_copy(
+	     internal_file->key_data,
+	     key,
+	     key_size ) == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_COPY_FAILED,
+		 "%s: unable to copy key.",
+		 function );
+
+		goto on_error;
+	}
+	internal_file->key_data_is_set = 1;
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_release_for_write(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release read/write lock for writing.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	return( 1 );
+
+on_error:
+	memory_set(
+	 internal_file->key_data,
+	 0,
+	 16 );
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	libcthreads_read_write_lock_release_for_write(
+	 internal_file->read_write_lock,
+	 NULL );
+#endif
+	return( -1 );
+}
+
+/* Sets an UTF-8 formatted password
+ * This function needs to be used before one of the open functions
+ * Returns 1 if successful, 0 if password is invalid or -1 on error
+ */
+int libqcow_file_set_utf8_password(
+     libqcow_file_t *file,
+     const uint8_t *utf8_string,
+     size_t utf8_string_length,
+     libcerror_error_t **error )
+{
+	libqcow_internal_file_t *internal_file = NULL;
+	static char *function                  = "libqcow_file_set_utf8_password";
+
+	if( file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	internal_file = (libqcow_internal_file_t *) file;
+
+	if( internal_file->file_io_handle != NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_ALREADY_SET,
+		 "%s: invalid file - file IO handle already set.",
+		 function );
+
+		return( -1 );
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_grab_for_write(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab read/write lock for writing.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	if( memory_set(
+	     internal_file->key_data,
+	     0,
+	     16 ) == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_SET_FAILED,
+		 "%s: unable to clear key data.",
+		 function );
+
+		goto on_error;
+	}
+	if( libuna_byte_stream_copy_from_utf8(
+	     internal_file->key_data,
+	     16,
+	     LIBQCOW_CODEPAGE_US_ASCII,
+	     utf8_string,
+	     utf8_string_length,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to copy password.",
+		 function );
+
+		goto on_error;
+	}
+	internal_file->key_data_is_set = 1;
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_release_for_write(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release read/write lock for writing.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	return( 1 );
+
+on_error:
+	memory_set(
+	 internal_file->key_data,
+	 0,
+	 16 );
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	libcthreads_read_write_lock_release_for_write(
+	 internal_file->read_write_lock,
+	 NULL );
+#endif
+	return( -1 );
+}
+
+/* Sets an UTF-16 formatted password
+ * This function needs to be used before one of the open functions
+ * Returns 1 if successful, 0 if password is invalid or -1 on error
+ */
+int libqcow_file_set_utf16_password(
+     libqcow_file_t *file,
+     const uint16_t *utf16_string,
+     size_t utf16_string_length,
+     libcerror_error_t **error )
+{
+	libqcow_internal_file_t *internal_file = NULL;
+	static char *function                  = "libqcow_file_set_utf16_password";
+
+	if( file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	internal_file = (libqcow_internal_file_t *) file;
+
+	if( internal_file->file_io_handle != NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_ALREADY_SET,
+		 "%s: invalid file - file IO handle already set.",
+		 function );
+
+		return( -1 );
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_grab_for_write(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab read/write lock for writing.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	if( memory_set(
+	     internal_file->key_data,
+	     0,
+	     16 ) == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_SET_FAILED,
+		 "%s: unable to clear key data.",
+		 function );
+
+		goto on_error;
+	}
+	if( libuna_byte_stream_copy_from_utf16(
+	     internal_file->key_data,
+	     16,
+	     LIBQCOW_CODEPAGE_US_ASCII,
+	     utf16_string,
+	     utf16_string_length,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to copy password.",
+		 function );
+
+		goto on_error;
+	}
+	internal_file->key_data_is_set = 1;
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_release_for_write(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release read/write lock for writing.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	return( 1 );
+
+on_error:
+	memory_set(
+	 internal_file->key_data,
+	 0,
+	 16 );
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	libcthreads_read_write_lock_release_for_write(
+	 internal_file->read_write_lock,
+	 NULL );
+#endif
+	return( -1 );
+}
+
+/* Retrieves the media size
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_file_get_media_size(
+     libqcow_file_t *file,
+     size64_t *media_size,
+     libcerror_error_t **error )
+{
+	libqcow_internal_file_t *internal_file = NULL;
+	static char *function                  = "libqcow_file_get_media_size";
+
+	if( file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	internal_file = (libqcow_internal_file_t *) file;
+
+	if( internal_file->file_header == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid file - missing file header.",
+		 function );
+
+		return( -1 );
+	}
+	if( media_size == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid media size.",
+		 function );
+
+		return( -1 );
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_grab_for_read(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab read/write lock for reading.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	*media_size = internal_file->file_header->media_size;
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_release_for_read(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release read/write lock for reading.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	return( 1 );
+}
+
+/* Retrieves the format version
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_file_get_format_version(
+     libqcow_file_t *file,
+     uint32_t *format_version,
+     libcerror_error_t **error )
+{
+	libqcow_internal_file_t *internal_file = NULL;
+	static char *function                  = "libqcow_file_get_format_version";
+
+	if( file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	internal_file = (libqcow_internal_file_t *) file;
+
+	if( internal_file->file_header == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid file - missing file header.",
+		 function );
+
+		return( -1 );
+	}
+	if( format_version == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid format version.",
+		 function );
+
+		return( -1 );
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_grab_for_read(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab read/write lock for reading.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	*format_version = internal_file->file_header->format_version;
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_release_for_read(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release read/write lock for reading.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	return( 1 );
+}
+
+/* Retrieves the encryption method
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_file_get_encryption_method(
+     libqcow_file_t *file,
+     uint32_t *encryption_method,
+     libcerror_error_t **error )
+{
+	libqcow_internal_file_t *internal_file = NULL;
+	static char *function                  = "libqcow_file_get_encryption_method";
+
+	if( file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	internal_file = (libqcow_internal_file_t *) file;
+
+	if( internal_file->file_io_handle == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid file - missing file IO handle.",
+		 function );
+
+		return( -1 );
+	}
+	if( encryption_method == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid encryption method.",
+		 function );
+
+		return( -1 );
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_grab_for_read(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab read/write lock for reading.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	*encryption_method = internal_file->encryption_method;
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_release_for_read(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release read/write lock for reading.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	return( 1 );
+}
+
+/* Retrieves the size of the UTF-8 encoded backing filename
+ * The returned size includes the end of string character
+ * Returns 1 if successful, 0 if not available or -1 on error
+ */
+int libqcow_file_get_utf8_backing_filename_size(
+     libqcow_file_t *file,
+     size_t *utf8_string_size,
+     libcerror_error_t **error )
+{
+	libqcow_internal_file_t *internal_file = NULL;
+	static char *function                  = "libqcow_file_get_utf8_backing_filename_size";
+	int result                             = 0;
+
+	if( file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	internal_file = (libqcow_internal_file_t *) file;
+
+	if( internal_file->file_io_handle == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid file - missing file IO handle.",
+		 function );
+
+		return( -1 );
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_grab_for_read(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab read/write lock for reading.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	if( internal_file->backing_filename != NULL )
+	{
+		result = libuna_utf8_string_size_from_utf8_stream(
+		          internal_file->backing_filename,
+		          internal_file->backing_filename_size,
+		          utf8_string_size,
+		          error );
+
+		if( result != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+			 "%s: unable to retrieve UTF-8 string size of backing filename.",
+			 function );
+
+			result = -1;
+		}
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_release_for_read(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release read/write lock for reading.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	return( result );
+}
+
+/* Retrieves the UTF-8 encoded backing filename
+ * The size should include the end of string character
+ * Returns 1 if successful, 0 if not available or -1 on error
+ */
+int libqcow_file_get_utf8_backing_filename(
+     libqcow_file_t *file,
+     uint8_t *utf8_string,
+     size_t utf8_string_size,
+     libcerror_error_t **error )
+{
+	libqcow_internal_file_t *internal_file = NULL;
+	static char *function                  = "libqcow_file_get_utf8_backing_filename";
+	int result                             = 0;
+
+	if( file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	internal_file = (libqcow_internal_file_t *) file;
+
+	if( internal_file->file_io_handle == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid file - missing file IO handle.",
+		 function );
+
+		return( -1 );
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_grab_for_read(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab read/write lock for reading.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	if( internal_file->backing_filename != NULL )
+	{
+		result = libuna_utf8_string_copy_from_utf8_stream(
+		          utf8_string,
+		          utf8_string_size,
+		          internal_file->backing_filename,
+		          internal_file->backing_filename_size,
+		          error );
+
+		if( result != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+			 "%s: unable to retrieve UTF-8 string of backing filename.",
+			 function );
+
+			result = -1;
 		}
 	}
-	return( (ssize_t) buffer_offset );
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_release_for_read(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release read/write lock for reading.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	return( result );
 }
 
-/* Reads (media) data from the current offset into a buffer
- * Returns the number of bytes read or -1 on error
+/* Retrieves the size of the UTF-16 encoded backing filename
+ * The returned size includes the end of string character
+ * Returns 1 if successful, 0 if not available or -1 on error
  */
-ssize_t libqcow_file_read_buffer(
-         libqcow_file_t *file,
-         void *buffer,
-         size_t buffer_size,
-         libcerror_error_t **error )
+int libqcow_file_get_utf16_backing_filename_size(
+     libqcow_file_t *file,
+     size_t *utf16_string_size,
+     libcerror_error_t **error )
+{
+	libqcow_internal_file_t *internal_file = NULL;
+	static char *function                  = "libqcow_file_get_utf16_backing_filename_size";
+	int result                             = 0;
+
+	if( file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	internal_file = (libqcow_internal_file_t *) file;
+
+	if( internal_file->file_io_handle == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid file - missing file IO handle.",
+		 function );
+
+		return( -1 );
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_grab_for_read(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab read/write lock for reading.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	if( internal_file->backing_filename != NULL )
+	{
+		result = libuna_utf16_string_size_from_utf8_stream(
+		          internal_file->backing_filename,
+		          internal_file->backing_filename_size,
+		          utf16_string_size,
+		          error );
+
+		if( result != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+			 "%s: unable to retrieve UTF-16 string size of backing filename.",
+			 function );
+
+			result = -1;
+		}
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_release_for_read(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release read/write lock for reading.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	return( result );
+}
+
+/* Retrieves the UTF-16 encoded backing filename
+ * The size should include the end of string character
+ * Returns 1 if successful, 0 if not available or -1 on error
+ */
+int libqcow_file_get_utf16_backing_filename(
+     libqcow_file_t *file,
+     uint16_t *utf16_string,
+     size_t utf16_string_size,
+     libcerror_error_t **error )
+{
+	libqcow_internal_file_t *internal_file = NULL;
+	static char *function                  = "libqcow_file_get_utf16_backing_filename";
+	int result                             = 0;
+
+	if( file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	internal_file = (libqcow_internal_file_t *) file;
+
+	if( internal_file->file_io_handle == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid file - missing file IO handle.",
+		 function );
+
+		return( -1 );
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_grab_for_read(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab read/write lock for reading.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	if( internal_file->backing_filename != NULL )
+	{
+		result = libuna_utf16_string_copy_from_utf8_stream(
+		          utf16_string,
+		          utf16_string_size,
+		          internal_file->backing_filename,
+		          internal_file->backing_filename_size,
+		          error );
+
+		if( result != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+			 "%s: unable to retrieve UTF-16 string of backing filename.",
+			 function );
+
+			result = -1;
+		}
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_release_for_read(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release read/write lock for reading.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	return( result );
+}
+
+/* Retrieves the size of the UTF-8 encoded data filename
+ * The returned size includes the end of string character
+ * Returns 1 if successful, 0 if not available or -1 on error
+ */
+int libqcow_file_get_utf8_data_filename_size(
+     libqcow_file_t *file,
+     size_t *utf8_string_size,
+     libcerror_error_t **error )
 {
 	libqcow_internal_file_t *internal_file = NULL;
-	static char *function                  = "libqcow_file_read_buffer";
-	ssize_t read_count                     = 0;
+	static char *function                  = "libqcow_file_get_utf8_data_filename_size";
+	int result                             = 0;
 
 	if( file == NULL )
 	{
@@ -2837,7 +14856,7 @@ ssize_t libqcow_file_read_buffer(
 		return( -1 );
 	}
 #if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
-	if( libcthreads_read_write_lock_grab_for_write(
+	if( libcthreads_read_write_lock_grab_for_read(
 	     internal_file->read_write_lock,
 	     error ) != 1 )
 	{
@@ -2845,32 +14864,35 @@ ssize_t libqcow_file_read_buffer(
 		 error,
 		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
 		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
-		 "%s: unable to grab read/write lock for writing.",
+		 "%s: unable to grab read/write lock for reading.",
 		 function );
 
 		return( -1 );
 	}
 #endif
-	read_count = libqcow_internal_file_read_buffer_from_file_io_handle(
-		      internal_file,
-		      internal_file->file_io_handle,
-		      buffer,
-		      buffer_size,
-		      error );
-
-	if( read_count == -1 )
+	if( ( internal_file->file_header != NULL )
+	 && ( internal_file->file_header->data_filename != NULL ) )
 	{
-		libcerror_error_set(
-		 error,
-		 LIBCERROR_ERROR_DOMAIN_IO,
-		 LIBCERROR_IO_ERROR_READ_FAILED,
-		 "%s: unable to read buffer.",
-		 function );
+		result = libuna_utf8_string_size_from_utf8_stream(
+		          internal_file->file_header->data_filename,
+		          internal_file->file_header->data_filename_size,
+		          utf8_string_size,
+		          error );
 
-		read_count = -1;
+		if( result != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+			 "%s: unable to retrieve UTF-8 string size of data filename.",
+			 function );
+
+			result = -1;
+		}
 	}
 #if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
-	if( libcthreads_read_write_lock_release_for_write(
+	if( libcthreads_read_write_lock_release_for_read(
 	     internal_file->read_write_lock,
 	     error ) != 1 )
 	{
@@ -2878,28 +14900,28 @@ ssize_t libqcow_file_read_buffer(
 		 error,
 		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
 		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
-		 "%s: unable to release read/write lock for writing.",
+		 "%s: unable to release read/write lock for reading.",
 		 function );
 
 		return( -1 );
 	}
 #endif
-	return( read_count );
+	return( result );
 }
 
-/* Reads (media) data at a specific offset
- * Returns the number of bytes read or -1 on error
+/* Retrieves the UTF-8 encoded data filename
+ * The size should include the end of string character
+ * Returns 1 if successful, 0 if not available or -1 on error
  */
-ssize_t libqcow_file_read_buffer_at_offset(
-         libqcow_file_t *file,
-         void *buffer,
-         size_t buffer_size,
-         off64_t offset,
-         libcerror_error_t **error )
+int libqcow_file_get_utf8_data_filename(
+     libqcow_file_t *file,
+     uint8_t *utf8_string,
+     size_t utf8_string_size,
+     libcerror_error_t **error )
 {
 	libqcow_internal_file_t *internal_file = NULL;
-	static char *function                  = "libqcow_file_read_buffer_at_offset";
-	ssize_t read_count                     = 0;
+	static char *function                  = "libqcow_file_get_utf8_data_filename";
+	int result                             = 0;
 
 	if( file == NULL )
 	{
@@ -2926,7 +14948,7 @@ ssize_t libqcow_file_read_buffer_at_offset(
 		return( -1 );
 	}
 #if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
-	if( libcthreads_read_write_lock_grab_for_write(
+	if( libcthreads_read_write_lock_grab_for_read(
 	     internal_file->read_write_lock,
 	     error ) != 1 )
 	{
@@ -2934,50 +14956,36 @@ ssize_t libqcow_file_read_buffer_at_offset(
 		 error,
 		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
 		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
-		 "%s: unable to grab read/write lock for writing.",
+		 "%s: unable to grab read/write lock for reading.",
 		 function );
 
 		return( -1 );
 	}
 #endif
-	if( libqcow_internal_file_seek_offset(
-	     internal_file,
-	     offset,
-	     SEEK_SET,
-	     error ) == -1 )
-	{
-		libcerror_error_set(
-		 error,
-		 LIBCERROR_ERROR_DOMAIN_IO,
-		 LIBCERROR_IO_ERROR_SEEK_FAILED,
-		 "%s: unable to seek offset.",
-		 function );
-
-		read_count = -1;
-	}
-	else
+	if( ( internal_file->file_header != NULL )
+	 && ( internal_file->file_header->data_filename != NULL ) )
 	{
-		read_count = libqcow_internal_file_read_buffer_from_file_io_handle(
-			      internal_file,
-			      internal_file->file_io_handle,
-			      buffer,
-			      buffer_size,
-			      error );
+		result = libuna_utf8_string_copy_from_utf8_stream(
+		          utf8_string,
+		          utf8_string_size,
+		          internal_file->file_header->data_filename,
+		          internal_file->file_header->data_filename_size,
+		          error );
 
-		if( read_count == -1 )
+		if( result != 1 )
 		{
 			libcerror_error_set(
 			 error,
-			 LIBCERROR_ERROR_DOMAIN_IO,
-			 LIBCERROR_IO_ERROR_READ_FAILED,
-			 "%s: unable to read buffer.",
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+			 "%s: unable to retrieve UTF-8 string of data filename.",
 			 function );
 
-			read_count = -1;
+			result = -1;
 		}
 	}
 #if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
-	if( libcthreads_read_write_lock_release_for_write(
+	if( libcthreads_read_write_lock_release_for_read(
 	     internal_file->read_write_lock,
 	     error ) != 1 )
 	{
@@ -2985,28 +14993,29 @@ ssize_t libqcow_file_read_buffer_at_offset(
 		 error,
 		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
 		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
-		 "%s: unable to release read/write lock for writing.",
+		 "%s: unable to release read/write lock for reading.",
 		 function );
 
 		return( -1 );
 	}
 #endif
-	return( read_count );
+	return( result );
 }
 
-/* Seeks a certain offset of the (media) data
- * This function is not multi-thread safe acquire write lock before call
- * Returns the offset if seek is successful or -1 on error
+/* Retrieves the size of the UTF-16 encoded data filename
+ * The returned size includes the end of string character
+ * Returns 1 if successful, 0 if not available or -1 on error
  */
-off64_t libqcow_internal_file_seek_offset(
-         libqcow_internal_file_t *internal_file,
-         off64_t offset,
-         int whence,
-         libcerror_error_t **error )
+int libqcow_file_get_utf16_data_filename_size(
+     libqcow_file_t *file,
+     size_t *utf16_string_size,
+     libcerror_error_t **error )
 {
-	static char *function = "libqcow_internal_file_seek_offset";
+	libqcow_internal_file_t *internal_file = NULL;
+	static char *function                  = "libqcow_file_get_utf16_data_filename_size";
+	int result                             = 0;
 
-	if( internal_file == NULL )
+	if( file == NULL )
 	{
 		libcerror_error_set(
 		 error,
@@ -3017,79 +15026,86 @@ off64_t libqcow_internal_file_seek_offset(
 
 		return( -1 );
 	}
-	if( internal_file->file_header == NULL )
+	internal_file = (libqcow_internal_file_t *) file;
+
+	if( internal_file->file_io_handle == NULL )
 	{
 		libcerror_error_set(
 		 error,
 		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
 		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
-		 "%s: invalid file - missing file header.",
+		 "%s: invalid file - missing file IO handle.",
 		 function );
 
 		return( -1 );
 	}
-	if( internal_file->backing_filename != NULL )
-	{
-		if( internal_file->parent_file == NULL )
-		{
-			libcerror_error_set(
-			 error,
-			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-			 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
-			 "%s: invalid file - missing parent file.",
-			 function );
-
-			return( -1 );
-		}
-	}
-	if( ( whence != SEEK_CUR )
-	 && ( whence != SEEK_END )
-	 && ( whence != SEEK_SET ) )
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_grab_for_read(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
 	{
 		libcerror_error_set(
 		 error,
-		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
-		 LIBCERROR_ARGUMENT_ERROR_UNSUPPORTED_VALUE,
-		 "%s: unsupported whence.",
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab read/write lock for reading.",
 		 function );
 
 		return( -1 );
 	}
-	if( whence == SEEK_CUR )
-	{
-		offset += internal_file->current_offset;
-	}
-	else if( whence == SEEK_END )
+#endif
+	if( ( internal_file->file_header != NULL )
+	 && ( internal_file->file_header->data_filename != NULL ) )
 	{
-		offset += (off64_t) internal_file->file_header->media_size;
+		result = libuna_utf16_string_size_from_utf8_stream(
+		          internal_file->file_header->data_filename,
+		          internal_file->file_header->data_filename_size,
+		          utf16_string_size,
+		          error );
+
+		if( result != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+			 "%s: unable to retrieve UTF-16 string size of data filename.",
+			 function );
+
+			result = -1;
+		}
 	}
-	if( offset < 0 )
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_release_for_read(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
 	{
 		libcerror_error_set(
 		 error,
-		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
-		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
-		 "%s: invalid offset value out of bounds.",
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release read/write lock for reading.",
 		 function );
 
 		return( -1 );
 	}
-	internal_file->current_offset = offset;
-
-	return( offset );
+#endif
+	return( result );
 }
 
-/* Seeks a certain offset of the (media) data
- * Returns the offset if seek is successful or -1 on error
+/* Retrieves the UTF-16 encoded data filename
+ * The size should include the end of string character
+ * Returns 1 if successful, 0 if not available or -1 on error
  */
-off64_t libqcow_file_seek_offset(
-         libqcow_file_t *file,
-         off64_t offset,
-         int whence,
-         libcerror_error_t **error )
+int libqcow_file_get_utf16_data_filename(
+     libqcow_file_t *file,
+     uint16_t *utf16_string,
+     size_t utf16_string_size,
+     libcerror_error_t **error )
 {
 	libqcow_internal_file_t *internal_file = NULL;
-	static char *function                  = "libqcow_file_seek_offset";
+	static char *function                  = "libqcow_file_get_utf16_data_filename";
+	int result                             = 0;
 
 	if( file == NULL )
 	{
@@ -3116,7 +15132,7 @@ off64_t libqcow_file_seek_offset(
 		return( -1 );
 	}
 #if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
-	if( libcthreads_read_write_lock_grab_for_write(
+	if( libcthreads_read_write_lock_grab_for_read(
 	     internal_file->read_write_lock,
 	     error ) != 1 )
 	{
@@ -3124,31 +15140,36 @@ off64_t libqcow_file_seek_offset(
 		 error,
 		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
 		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
-		 "%s: unable to grab read/write lock for writing.",
+		 "%s: unable to grab read/write lock for reading.",
 		 function );
 
 		return( -1 );
 	}
 #endif
-	offset = libqcow_internal_file_seek_offset(
-	          internal_file,
-	          offset,
-	          whence,
-	          error );
-
-	if( offset == -1 )
+	if( ( internal_file->file_header != NULL )
+	 && ( internal_file->file_header->data_filename != NULL ) )
 	{
-		libcerror_error_set(
-		 error,
-		 LIBCERROR_ERROR_DOMAIN_IO,
-		 LIBCERROR_IO_ERROR_SEEK_FAILED,
-		 "%s: unable to seek offset.",
-		 function );
+		result = libuna_utf16_string_copy_from_utf8_stream(
+		          utf16_string,
+		          utf16_string_size,
+		          internal_file->file_header->data_filename,
+		          internal_file->file_header->data_filename_size,
+		          error );
 
-		offset = -1;
+		if( result != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+			 "%s: unable to retrieve UTF-16 string of data filename.",
+			 function );
+
+			result = -1;
+		}
 	}
 #if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
-	if( libcthreads_read_write_lock_release_for_write(
+	if( libcthreads_read_write_lock_release_for_read(
 	     internal_file->read_write_lock,
 	     error ) != 1 )
 	{
@@ -3156,25 +15177,25 @@ off64_t libqcow_file_seek_offset(
 		 error,
 		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
 		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
-		 "%s: unable to release read/write lock for writing.",
+		 "%s: unable to release read/write lock for reading.",
 		 function );
 
 		return( -1 );
 	}
 #endif
-	return( offset );
+	return( result );
 }
 
-/* Retrieves the current offset of the (media) data
+/* Retrieves the number of snapshots
  * Returns 1 if successful or -1 on error
  */
-int libqcow_file_get_offset(
+int libqcow_file_get_number_of_snapshots(
      libqcow_file_t *file,
-     off64_t *offset,
+     int *number_of_snapshots,
      libcerror_error_t **error )
 {
 	libqcow_internal_file_t *internal_file = NULL;
-	static char *function                  = "libqcow_file_get_offset";
+	static char *function                  = "libqcow_file_get_number_of_snapshots";
 
 	if( file == NULL )
 	{
@@ -3189,24 +15210,24 @@ int libqcow_file_get_offset(
 	}
 	internal_file = (libqcow_internal_file_t *) file;
 
-	if( internal_file->file_io_handle == NULL )
+	if( internal_file->file_header == NULL )
 	{
 		libcerror_error_set(
 		 error,
 		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
 		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
-		 "%s: invalid file - missing file IO handle.",
+		 "%s: invalid file - missing file header.",
 		 function );
 
 		return( -1 );
 	}
-	if( offset == NULL )
+	if( number_of_snapshots == NULL )
 	{
 		libcerror_error_set(
 		 error,
 		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
 		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
-		 "%s: invalid offset.",
+		 "%s: invalid number of snapshots.",
 		 function );
 
 		return( -1 );
@@ -3226,7 +15247,7 @@ int libqcow_file_get_offset(
 		return( -1 );
 	}
 #endif
-	*offset = internal_file->current_offset;
+	*number_of_snapshots = internal_file->number_of_snapshots;
 
 #if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
 	if( libcthreads_read_write_lock_release_for_read(
@@ -3246,16 +15267,21 @@ int libqcow_file_get_offset(
 	return( 1 );
 }
 
-/* Sets the parent (backing) file of a differential image
+
+/* Retrieves a specific snapshot
+ * The snapshot shares the level 2 table and cluster block caches of the file
+ * and must be freed before the file is closed
  * Returns 1 if successful or -1 on error
  */
-int libqcow_file_set_parent_file(
+int libqcow_file_get_snapshot_by_index(
      libqcow_file_t *file,
-     libqcow_file_t *parent_file,
+     int snapshot_index,
+     libqcow_snapshot_t **snapshot,
      libcerror_error_t **error )
 {
 	libqcow_internal_file_t *internal_file = NULL;
-	static char *function                  = "libqcow_file_set_parent_file";
+	static char *function                  = "libqcow_file_get_snapshot_by_index";
+	int result                             = 1;
 
 	if( file == NULL )
 	{
@@ -3270,24 +15296,35 @@ int libqcow_file_set_parent_file(
 	}
 	internal_file = (libqcow_internal_file_t *) file;
 
-	if( internal_file->backing_filename == NULL )
+	if( internal_file->file_io_handle == NULL )
 	{
 		libcerror_error_set(
 		 error,
 		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
 		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
-		 "%s: invalid file - missing backing filename.",
+		 "%s: invalid file - missing file IO handle.",
 		 function );
 
 		return( -1 );
 	}
-	if( internal_file->parent_file != NULL )
+	if( snapshot == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid snapshot.",
+		 function );
+
+		return( -1 );
+	}
+	if( *snapshot != NULL )
 	{
 		libcerror_error_set(
 		 error,
 		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
 		 LIBCERROR_RUNTIME_ERROR_VALUE_ALREADY_SET,
-		 "%s: invalid file - parent file already set.",
+		 "%s: invalid snapshot value already set.",
 		 function );
 
 		return( -1 );
@@ -3307,8 +15344,39 @@ int libqcow_file_set_parent_file(
 		return( -1 );
 	}
 #endif
-	internal_file->parent_file = parent_file;
+	if( ( snapshot_index < 0 )
+	 || ( snapshot_index >= internal_file->number_of_snapshots ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid snapshot index value out of bounds.",
+		 function );
+
+		result = -1;
+	}
+	else if( libqcow_snapshot_initialize(
+	          snapshot,
+	          file,
+	          internal_file->file_io_handle,
+	          internal_file->snapshot_values_array[ snapshot_index ],
+	          error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+		 "%s: unable to create snapshot: %d.",
+		 function,
+		 snapshot_index );
 
+		result = -1;
+	}
+	else
+	{
+		internal_file->number_of_open_snapshots += 1;
+	}
 #if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
 	if( libcthreads_read_write_lock_release_for_write(
 	     internal_file->read_write_lock,
@@ -3324,23 +15392,52 @@ int libqcow_file_set_parent_file(
 		return( -1 );
 	}
 #endif
-	return( 1 );
+	return( result );
 }
 
-/* Set the keys
- * This function needs to be used before one of the open functions
+/* Determines the extents that differ between two level 1 tables
+ * Level 2 tables that are referenced by both level 1 tables are skipped
+ * without being read, the guest data itself is never read
+ * The determination is stopped when the file is signalled to abort after the abort generation
+ * This function is not multi-thread safe acquire write lock before call
  * Returns 1 if successful or -1 on error
  */
-int libqcow_file_set_keys(
-     libqcow_file_t *file,
-     const uint8_t *key,
-     size_t key_size,
+int libqcow_internal_file_get_changed_extents(
+     libqcow_internal_file_t *internal_file,
+     libbfio_handle_t *file_io_handle,
+     libqcow_cluster_table_t *first_level1_table,
+     size64_t first_media_size,
+     libqcow_cluster_table_t *second_level1_table,
+     size64_t second_media_size,
+     libqcow_changed_extents_t *changed_extents,
+     uint32_t abort_generation,
      libcerror_error_t **error )
 {
-	libqcow_internal_file_t *internal_file = NULL;
-	static char *function                  = "libqcow_file_set_keys";
+	libqcow_cluster_table_t *first_level2_table  = NULL;
+	libqcow_cluster_table_t *second_level2_table = NULL;
+	static char *function                        = "libqcow_internal_file_get_changed_extents";
+	size64_t compare_size                        = 0;
+	size64_t extent_size                         = 0;
+	size64_t level1_range_size                   = 0;
+	size_t level2_table_size                     = 0;
+	uint64_t first_level2_table_offset           = 0;
+	uint64_t first_reference                     = 0;
+	uint64_t first_subcluster_bitmap             = 0;
+	uint64_t level1_table_index                  = 0;
+	uint64_t number_of_level1_ranges             = 0;
+	uint64_t reference_bit_mask                  = 0;
+	uint64_t second_level2_table_offset          = 0;
+	uint64_t second_reference                    = 0;
+	uint64_t second_subcluster_bitmap            = 0;
+	off64_t extent_offset                        = 0;
+	off64_t range_offset                         = 0;
+	int first_number_of_references               = 0;
+	int level2_table_index                       = 0;
+	int number_of_cluster_blocks                 = 0;
+	int result                                   = 0;
+	int second_number_of_references              = 0;
 
-	if( file == NULL )
+	if( internal_file == NULL )
 	{
 		libcerror_error_set(
 		 error,
@@ -3351,231 +15448,498 @@ int libqcow_file_set_keys(
 
 		return( -1 );
 	}
-	internal_file = (libqcow_internal_file_t *) file;
+	if( internal_file->file_header == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid file - missing file header.",
+		 function );
 
-	if( internal_file->file_io_handle != NULL )
+		return( -1 );
+	}
+	if( internal_file->io_handle == NULL )
 	{
 		libcerror_error_set(
 		 error,
 		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-		 LIBCERROR_RUNTIME_ERROR_VALUE_ALREADY_SET,
-		 "%s: invalid file - file IO handle already set.",
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid file - missing IO handle.",
 		 function );
 
 		return( -1 );
 	}
-	if( key == NULL )
+	if( ( internal_file->level1_index_bit_shift == 0 )
+	 || ( internal_file->level1_index_bit_shift > 63 ) )
 	{
 		libcerror_error_set(
 		 error,
-		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
-		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
-		 "%s: invalid key.",
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid file - level 1 index bit shift value out of bounds.",
 		 function );
 
 		return( -1 );
 	}
-	if( key_size != 16 )
+	if( first_level1_table == NULL )
 	{
 		libcerror_error_set(
 		 error,
 		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
-		 LIBCERROR_ARGUMENT_ERROR_UNSUPPORTED_VALUE,
-		 "%s: unsupported key size.",
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid first level 1 table.",
 		 function );
 
 		return( -1 );
 	}
-#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
-	if( libcthreads_read_write_lock_grab_for_write(
-	     internal_file->read_write_lock,
-	     error ) != 1 )
+	if( second_level1_table == NULL )
 	{
 		libcerror_error_set(
 		 error,
-		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
-		 "%s: unable to grab read/write lock for writing.",
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid second level 1 table.",
 		 function );
 
 		return( -1 );
 	}
-#endif
-	if( memory_copy(
-	     internal_file->key_data,
-	     key,
-	     key_size ) == NULL )
+	if( libqcow_cluster_table_get_number_of_references(
+	     first_level1_table,
+	     &first_number_of_references,
+	     error ) != 1 )
 	{
 		libcerror_error_set(
 		 error,
-		 LIBCERROR_ERROR_DOMAIN_MEMORY,
-		 LIBCERROR_MEMORY_ERROR_COPY_FAILED,
-		 "%s: unable to copy key.",
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+		 "%s: unable to retrieve number of references of first level 1 table.",
 		 function );
 
-		goto on_error;
+		return( -1 );
 	}
-	internal_file->key_data_is_set = 1;
-
-#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
-	if( libcthreads_read_write_lock_release_for_write(
-	     internal_file->read_write_lock,
+	if( libqcow_cluster_table_get_number_of_references(
+	     second_level1_table,
+	     &second_number_of_references,
 	     error ) != 1 )
 	{
 		libcerror_error_set(
 		 error,
 		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
-		 "%s: unable to release read/write lock for writing.",
+		 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+		 "%s: unable to retrieve number of references of second level 1 table.",
 		 function );
 
 		return( -1 );
 	}
-#endif
-	return( 1 );
-
-on_error:
-	memory_set(
-	 internal_file->key_data,
-	 0,
-	 16 );
+	/* The copied flag (bit 63) of a version 2 or later level 2 table entry only
+	 * reflects the reference count of the cluster block and is ignored
+	 */
+	if( internal_file->file_header->format_version == 1 )
+	{
+		reference_bit_mask = ~( (uint64_t) 0 );
+	}
+	else
+	{
+		reference_bit_mask = ~( (uint64_t) 1UL << 63 );
+	}
+	level2_table_size = (size_t) ( internal_file->level2_index_bit_mask + 1 );
 
-#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
-	libcthreads_read_write_lock_release_for_write(
-	 internal_file->read_write_lock,
-	 NULL );
-#endif
-	return( -1 );
-}
+	if( internal_file->io_handle->has_extended_level2_entries != 0 )
+	{
+		level2_table_size *= 16;
+	}
+	else
+	{
+		level2_table_size *= 8;
+	}
+	level1_range_size = (size64_t) 1UL << internal_file->level1_index_bit_shift;
 
-/* Sets an UTF-8 formatted password
- * This function needs to be used before one of the open functions
- * Returns 1 if successful, 0 if password is invalid or -1 on error
- */
-int libqcow_file_set_utf8_password(
-     libqcow_file_t *file,
-     const uint8_t *utf8_string,
-     size_t utf8_string_length,
-     libcerror_error_t **error )
-{
-	libqcow_internal_file_t *internal_file = NULL;
-	static char *function                  = "libqcow_file_set_utf8_password";
+	if( first_media_size < second_media_size )
+	{
+		compare_size = first_media_size;
+	}
+	else
+	{
+		compare_size = second_media_size;
+	}
+	number_of_level1_ranges = compare_size >> internal_file->level1_index_bit_shift;
 
-	if( file == NULL )
+	if( ( compare_size % level1_range_size ) != 0 )
 	{
-		libcerror_error_set(
-		 error,
-		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
-		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
-		 "%s: invalid file.",
-		 function );
+		number_of_level1_ranges += 1;
+	}
+	for( level1_table_index = 0;
+	     level1_table_index < number_of_level1_ranges;
+	     level1_table_index++ )
+	{
+		result = libqcow_internal_file_read_is_stopped(
+		          internal_file,
+		          NULL,
+		          abort_generation,
+		          error );
+
+		if( result == -1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+			 "%s: unable to determine if read is stopped.",
+			 function );
+
+			goto on_error;
+		}
+		else if( result != 0 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_ABORT_REQUESTED,
+			 "%s: abort requested.",
+			 function );
+
+			goto on_error;
+		}
+		first_level2_table_offset  = 0;
+		second_level2_table_offset = 0;
+
+		if( level1_table_index < (uint64_t) first_number_of_references )
+		{
+			if( libqcow_cluster_table_get_reference_by_index(
+			     first_level1_table,
+			     (int) level1_table_index,
+			     &first_level2_table_offset,
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+				 "%s: unable to retrieve level 2 table offset: %" PRIu64 " from first level 1 table.",
+				 function,
+				 level1_table_index );
+
+				goto on_error;
+			}
+			first_level2_table_offset &= internal_file->offset_bit_mask;
+		}
+		if( level1_table_index < (uint64_t) second_number_of_references )
+		{
+			if( libqcow_cluster_table_get_reference_by_index(
+			     second_level1_table,
+			     (int) level1_table_index,
+			     &second_level2_table_offset,
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+				 "%s: unable to retrieve level 2 table offset: %" PRIu64 " from second level 1 table.",
+				 function,
+				 level1_table_index );
+
+				goto on_error;
+			}
+			second_level2_table_offset &= internal_file->offset_bit_mask;
+		}
+		/* A level 2 table that is shared, or sparse in both, maps the same data
+		 */
+		if( first_level2_table_offset == second_level2_table_offset )
+		{
+			continue;
+		}
+		range_offset = (off64_t) ( level1_table_index << internal_file->level1_index_bit_shift );
+
+		if( level1_range_size > ( compare_size - (size64_t) range_offset ) )
+		{
+			number_of_cluster_blocks = (int) ( ( compare_size - (size64_t) range_offset + internal_file->cluster_block_size - 1 ) / internal_file->cluster_block_size );
+		}
+		else
+		{
+			number_of_cluster_blocks = (int) ( internal_file->level2_index_bit_mask + 1 );
+		}
+		if( first_level2_table_offset != 0 )
+		{
+			if( libqcow_cluster_table_initialize(
+			     &first_level2_table,
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+				 "%s: unable to create first level 2 table.",
+				 function );
+
+				goto on_error;
+			}
+			if( libqcow_cluster_table_read(
+			     first_level2_table,
+			     file_io_handle,
+			     (off64_t) first_level2_table_offset,
+			     level2_table_size,
+			     ( internal_file->io_handle->has_extended_level2_entries != 0 ) ? 16 : 8,
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_IO,
+				 LIBCERROR_IO_ERROR_READ_FAILED,
+				 "%s: unable to read first level 2 table at offset: 0x%08" PRIx64 ".",
+				 function,
+				 first_level2_table_offset );
+
+				goto on_error;
+			}
+		}
+		if( second_level2_table_offset != 0 )
+		{
+			if( libqcow_cluster_table_initialize(
+			     &second_level2_table,
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+				 "%s: unable to create second level 2 table.",
+				 function );
 
-		return( -1 );
-	}
-	internal_file = (libqcow_internal_file_t *) file;
+				goto on_error;
+			}
+			if( libqcow_cluster_table_read(
+			     second_level2_table,
+			     file_io_handle,
+			     (off64_t) second_level2_table_offset,
+			     level2_table_size,
+			     ( internal_file->io_handle->has_extended_level2_entries != 0 ) ? 16 : 8,
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_IO,
+				 LIBCERROR_IO_ERROR_READ_FAILED,
+				 "%s: unable to read second level 2 table at offset: 0x%08" PRIx64 ".",
+				 function,
+				 second_level2_table_offset );
 
-	if( internal_file->file_io_handle != NULL )
-	{
-		libcerror_error_set(
-		 error,
-		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-		 LIBCERROR_RUNTIME_ERROR_VALUE_ALREADY_SET,
-		 "%s: invalid file - file IO handle already set.",
-		 function );
+				goto on_error;
+			}
+		}
+		for( level2_table_index = 0;
+		     level2_table_index < number_of_cluster_blocks;
+		     level2_table_index++ )
+		{
+			first_reference          = 0;
+			first_subcluster_bitmap  = 0;
+			second_reference         = 0;
+			second_subcluster_bitmap = 0;
 
-		return( -1 );
-	}
-#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
-	if( libcthreads_read_write_lock_grab_for_write(
-	     internal_file->read_write_lock,
-	     error ) != 1 )
-	{
-		libcerror_error_set(
-		 error,
-		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
-		 "%s: unable to grab read/write lock for writing.",
-		 function );
+			if( first_level2_table != NULL )
+			{
+				if( libqcow_cluster_table_get_reference_by_index(
+				     first_level2_table,
+				     level2_table_index,
+				     &first_reference,
+				     error ) != 1 )
+				{
+					libcerror_error_set(
+					 error,
+					 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+					 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+					 "%s: unable to retrieve first level 2 table entry: %d.",
+					 function,
+					 level2_table_index );
+
+					goto on_error;
+				}
+				if( ( internal_file->subcluster_size != 0 )
+				 && ( libqcow_cluster_table_get_subcluster_bitmap_by_index(
+				       first_level2_table,
+				       level2_table_index,
+				       &first_subcluster_bitmap,
+				       error ) != 1 ) )
+				{
+					libcerror_error_set(
+					 error,
+					 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+					 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+					 "%s: unable to retrieve subcluster allocation bitmap of first level 2 table entry: %d.",
+					 function,
+					 level2_table_index );
+
+					goto on_error;
+				}
+			}
+			if( second_level2_table != NULL )
+			{
+				if( libqcow_cluster_table_get_reference_by_index(
+				     second_level2_table,
+				     level2_table_index,
+				     &second_reference,
+				     error ) != 1 )
+				{
+					libcerror_error_set(
+					 error,
+					 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+					 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+					 "%s: unable to retrieve second level 2 table entry: %d.",
+					 function,
+					 level2_table_index );
+
+					goto on_error;
+				}
+				if( ( internal_file->subcluster_size != 0 )
+				 && ( libqcow_cluster_table_get_subcluster_bitmap_by_index(
+				       second_level2_table,
+				       level2_table_index,
+				       &second_subcluster_bitmap,
+				       error ) != 1 ) )
+				{
+					libcerror_error_set(
+					 error,
+					 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+					 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+					 "%s: unable to retrieve subcluster allocation bitmap of second level 2 table entry: %d.",
+					 function,
+					 level2_table_index );
+
+					goto on_error;
+				}
+			}
+			if( ( ( ( first_reference ^ second_reference ) & reference_bit_mask ) == 0 )
+			 && ( first_subcluster_bitmap == second_subcluster_bitmap ) )
+			{
+				continue;
+			}
+			extent_offset = range_offset + ( (off64_t) level2_table_index * internal_file->cluster_block_size );
+			extent_size   = internal_file->cluster_block_size;
 
-		return( -1 );
-	}
-#endif
-	if( memory_set(
-	     internal_file->key_data,
-	     0,
-	     16 ) == NULL )
-	{
-		libcerror_error_set(
-		 error,
-		 LIBCERROR_ERROR_DOMAIN_MEMORY,
-		 LIBCERROR_MEMORY_ERROR_SET_FAILED,
-		 "%s: unable to clear key data.",
-		 function );
+			if( extent_size > ( compare_size - (size64_t) extent_offset ) )
+			{
+				extent_size = compare_size - (size64_t) extent_offset;
+			}
+			if( libqcow_changed_extents_append_extent(
+			     changed_extents,
+			     extent_offset,
+			     extent_size,
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_APPEND_FAILED,
+				 "%s: unable to append changed extent at offset: %" PRIi64 ".",
+				 function,
+				 extent_offset );
 
-		goto on_error;
-	}
-	if( libuna_byte_stream_copy_from_utf8(
-	     internal_file->key_data,
-	     16,
-	     LIBQCOW_CODEPAGE_US_ASCII,
-	     utf8_string,
-	     utf8_string_length,
-	     error ) != 1 )
-	{
-		libcerror_error_set(
-		 error,
-		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
-		 "%s: unable to copy password.",
-		 function );
+				goto on_error;
+			}
+		}
+		if( first_level2_table != NULL )
+		{
+			if( libqcow_cluster_table_free(
+			     &first_level2_table,
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+				 "%s: unable to free first level 2 table.",
+				 function );
 
-		goto on_error;
-	}
-	internal_file->key_data_is_set = 1;
+				goto on_error;
+			}
+		}
+		if( second_level2_table != NULL )
+		{
+			if( libqcow_cluster_table_free(
+			     &second_level2_table,
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+				 "%s: unable to free second level 2 table.",
+				 function );
 
-#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
-	if( libcthreads_read_write_lock_release_for_write(
-	     internal_file->read_write_lock,
-	     error ) != 1 )
+				goto on_error;
+			}
+		}
+	}
+	/* The data beyond the end of the smaller media is considered changed
+	 */
+	if( first_media_size != second_media_size )
 	{
-		libcerror_error_set(
-		 error,
-		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
-		 "%s: unable to release read/write lock for writing.",
-		 function );
+		if( first_media_size > second_media_size )
+		{
+			extent_size = first_media_size - compare_size;
+		}
+		else
+		{
+			extent_size = second_media_size - compare_size;
+		}
+		if( libqcow_changed_extents_append_extent(
+		     changed_extents,
+		     (off64_t) compare_size,
+		     extent_size,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_APPEND_FAILED,
+			 "%s: unable to append changed extent at offset: %" PRIu64 ".",
+			 function,
+			 compare_size );
 
-		return( -1 );
+			goto on_error;
+		}
 	}
-#endif
 	return( 1 );
 
 on_error:
-	memory_set(
-	 internal_file->key_data,
-	 0,
-	 16 );
-
-#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
-	libcthreads_read_write_lock_release_for_write(
-	 internal_file->read_write_lock,
-	 NULL );
-#endif
+	if( second_level2_table != NULL )
+	{
+		libqcow_cluster_table_free(
+		 &second_level2_table,
+		 NULL );
+	}
+	if( first_level2_table != NULL )
+	{
+		libqcow_cluster_table_free(
+		 &first_level2_table,
+		 NULL );
+	}
 	return( -1 );
 }
 
-/* Sets an UTF-16 formatted password
- * This function needs to be used before one of the open functions
- * Returns 1 if successful, 0 if password is invalid or -1 on error
+/* Retrieves the extents that differ between two snapshots
+ * A snapshot value of NULL refers to the current (active) state of the file
+ * The changed extents are determined from the level 1 and 2 tables only,
+ * an extent can therefore be reported as changed while its data is identical
+ * Returns 1 if successful or -1 on error
  */
-int libqcow_file_set_utf16_password(
+int libqcow_file_get_changed_extents(
      libqcow_file_t *file,
-     const uint16_t *utf16_string,
-     size_t utf16_string_length,
+     libqcow_snapshot_t *first_snapshot,
+     libqcow_snapshot_t *second_snapshot,
+     libqcow_changed_extents_t **changed_extents,
      libcerror_error_t **error )
 {
-	libqcow_internal_file_t *internal_file = NULL;
-	static char *function                  = "libqcow_file_set_utf16_password";
+	libqcow_cluster_table_t *first_level1_table    = NULL;
+	libqcow_cluster_table_t *second_level1_table   = NULL;
+	libqcow_internal_file_t *internal_file         = NULL;
+	libqcow_internal_snapshot_t *internal_snapshot = NULL;
+	static char *function                          = "libqcow_file_get_changed_extents";
+	size64_t first_media_size                      = 0;
+	size64_t second_media_size                     = 0;
+	uint32_t abort_generation                      = 0;
+	int result                                     = 1;
 
 	if( file == NULL )
 	{
@@ -3590,144 +15954,127 @@ int libqcow_file_set_utf16_password(
 	}
 	internal_file = (libqcow_internal_file_t *) file;
 
-	if( internal_file->file_io_handle != NULL )
+	if( internal_file->file_io_handle == NULL )
 	{
 		libcerror_error_set(
 		 error,
 		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-		 LIBCERROR_RUNTIME_ERROR_VALUE_ALREADY_SET,
-		 "%s: invalid file - file IO handle already set.",
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid file - missing file IO handle.",
 		 function );
 
 		return( -1 );
 	}
-#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
-	if( libcthreads_read_write_lock_grab_for_write(
-	     internal_file->read_write_lock,
-	     error ) != 1 )
+	if( internal_file->file_header == NULL )
 	{
 		libcerror_error_set(
 		 error,
 		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
-		 "%s: unable to grab read/write lock for writing.",
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid file - missing file header.",
 		 function );
 
 		return( -1 );
 	}
-#endif
-	if( memory_set(
-	     internal_file->key_data,
-	     0,
-	     16 ) == NULL )
-	{
-		libcerror_error_set(
-		 error,
-		 LIBCERROR_ERROR_DOMAIN_MEMORY,
-		 LIBCERROR_MEMORY_ERROR_SET_FAILED,
-		 "%s: unable to clear key data.",
-		 function );
-
-		goto on_error;
-	}
-	if( libuna_byte_stream_copy_from_utf16(
-	     internal_file->key_data,
-	     16,
-	     LIBQCOW_CODEPAGE_US_ASCII,
-	     utf16_string,
-	     utf16_string_length,
-	     error ) != 1 )
-	{
-		libcerror_error_set(
-		 error,
-		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
-		 "%s: unable to copy password.",
-		 function );
-
-		goto on_error;
-	}
-	internal_file->key_data_is_set = 1;
-
-#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
-	if( libcthreads_read_write_lock_release_for_write(
-	     internal_file->read_write_lock,
-	     error ) != 1 )
+	if( changed_extents == NULL )
 	{
 		libcerror_error_set(
 		 error,
-		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
-		 "%s: unable to release read/write lock for writing.",
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid changed extents.",
 		 function );
 
 		return( -1 );
 	}
-#endif
-	return( 1 );
-
-on_error:
-	memory_set(
-	 internal_file->key_data,
-	 0,
-	 16 );
-
-#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
-	libcthreads_read_write_lock_release_for_write(
-	 internal_file->read_write_lock,
-	 NULL );
-#endif
-	return( -1 );
-}
-
-/* Retrieves the media size
- * Returns 1 if successful or -1 on error
- */
-int libqcow_file_get_media_size(
-     libqcow_file_t *file,
-     size64_t *media_size,
-     libcerror_error_t **error )
-{
-	libqcow_internal_file_t *internal_file = NULL;
-	static char *function                  = "libqcow_file_get_media_size";
-
-	if( file == NULL )
+	if( *changed_extents != NULL )
 	{
 		libcerror_error_set(
 		 error,
-		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
-		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
-		 "%s: invalid file.",
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_ALREADY_SET,
+		 "%s: invalid changed extents value already set.",
 		 function );
 
 		return( -1 );
 	}
-	internal_file = (libqcow_internal_file_t *) file;
+	if( first_snapshot == NULL )
+	{
+		first_level1_table = internal_file->level1_table;
+		first_media_size   = internal_file->file_header->media_size;
+	}
+	else
+	{
+		internal_snapshot = (libqcow_internal_snapshot_t *) first_snapshot;
 
-	if( internal_file->file_header == NULL )
+		if( internal_snapshot->file != file )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+			 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+			 "%s: invalid first snapshot - not a snapshot of the file.",
+			 function );
+
+			return( -1 );
+		}
+		first_level1_table = internal_snapshot->level1_table;
+		first_media_size   = internal_snapshot->media_size;
+	}
+	if( second_snapshot == NULL )
+	{
+		second_level1_table = internal_file->level1_table;
+		second_media_size   = internal_file->file_header->media_size;
+	}
+	else
+	{
+		internal_snapshot = (libqcow_internal_snapshot_t *) second_snapshot;
+
+		if( internal_snapshot->file != file )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+			 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+			 "%s: invalid second snapshot - not a snapshot of the file.",
+			 function );
+
+			return( -1 );
+		}
+		second_level1_table = internal_snapshot->level1_table;
+		second_media_size   = internal_snapshot->media_size;
+	}
+	/* Determining the changed extents is stopped when the file is signalled to abort after this point
+	 */
+	if( libqcow_internal_file_get_abort_generation(
+	     internal_file,
+	     &abort_generation,
+	     error ) != 1 )
 	{
 		libcerror_error_set(
 		 error,
 		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
-		 "%s: invalid file - missing file header.",
+		 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+		 "%s: unable to retrieve abort generation.",
 		 function );
 
 		return( -1 );
 	}
-	if( media_size == NULL )
+	if( libqcow_changed_extents_initialize(
+	     changed_extents,
+	     error ) != 1 )
 	{
 		libcerror_error_set(
 		 error,
-		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
-		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
-		 "%s: invalid media size.",
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+		 "%s: unable to create changed extents.",
 		 function );
 
 		return( -1 );
 	}
 #if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
-	if( libcthreads_read_write_lock_grab_for_read(
+	if( libcthreads_read_write_lock_grab_for_write(
 	     internal_file->read_write_lock,
 	     error ) != 1 )
 	{
@@ -3735,16 +16082,38 @@ int libqcow_file_get_media_size(
 		 error,
 		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
 		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
-		 "%s: unable to grab read/write lock for reading.",
+		 "%s: unable to grab read/write lock for writing.",
 		 function );
 
+		libqcow_changed_extents_free(
+		 changed_extents,
+		 NULL );
+
 		return( -1 );
 	}
 #endif
-	*media_size = internal_file->file_header->media_size;
+	if( libqcow_internal_file_get_changed_extents(
+	     internal_file,
+	     internal_file->file_io_handle,
+	     first_level1_table,
+	     first_media_size,
+	     second_level1_table,
+	     second_media_size,
+	     *changed_extents,
+	     abort_generation,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+		 "%s: unable to determine changed extents.",
+		 function );
 
+		result = -1;
+	}
 #if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
-	if( libcthreads_read_write_lock_release_for_read(
+	if( libcthreads_read_write_lock_release_for_write(
 	     internal_file->read_write_lock,
 	     error ) != 1 )
 	{
@@ -3752,27 +16121,46 @@ int libqcow_file_get_media_size(
 		 error,
 		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
 		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
-		 "%s: unable to release read/write lock for reading.",
+		 "%s: unable to release read/write lock for writing.",
 		 function );
 
-		return( -1 );
+		result = -1;
 	}
 #endif
-	return( 1 );
+	if( result != 1 )
+	{
+		libqcow_changed_extents_free(
+		 changed_extents,
+		 NULL );
+	}
+	return( result );
 }
 
-/* Retrieves the format version
+
+/* Exports the (media) data of the file, including its backing chain, using an export writer
+ * The data is read in chunks by the calling thread and handed to the export writer,
+ * chunks that only contain sparse or zero cluster blocks in the backing chain are not read
+ * The read/write lock is grabbed per chunk so that the file can be read while exporting
  * Returns 1 if successful or -1 on error
  */
-int libqcow_file_get_format_version(
-     libqcow_file_t *file,
-     uint32_t *format_version,
+int libqcow_internal_file_export(
+     libqcow_internal_file_t *internal_file,
+     libqcow_export_writer_t *export_writer,
      libcerror_error_t **error )
 {
-	libqcow_internal_file_t *internal_file = NULL;
-	static char *function                  = "libqcow_file_get_format_version";
+	libqcow_export_chunk_t *export_chunk = NULL;
+	static char *function                = "libqcow_internal_file_export";
+	size64_t media_size                  = 0;
+	size64_t range_size                  = 0;
+	size_t chunk_size                    = 0;
+	ssize_t read_count                   = 0;
+	off64_t chunk_end_offset             = 0;
+	off64_t chunk_offset                 = 0;
+	off64_t range_offset                 = 0;
+	uint32_t abort_generation            = 0;
+	int result                           = 0;
 
-	if( file == NULL )
+	if( internal_file == NULL )
 	{
 		libcerror_error_set(
 		 error,
@@ -3783,8 +16171,6 @@ int libqcow_file_get_format_version(
 
 		return( -1 );
 	}
-	internal_file = (libqcow_internal_file_t *) file;
-
 	if( internal_file->file_header == NULL )
 	{
 		libcerror_error_set(
@@ -3796,62 +16182,263 @@ int libqcow_file_get_format_version(
 
 		return( -1 );
 	}
-	if( format_version == NULL )
+	if( internal_file->io_handle == NULL )
 	{
 		libcerror_error_set(
 		 error,
-		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
-		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
-		 "%s: invalid format version.",
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid file - missing IO handle.",
 		 function );
 
 		return( -1 );
 	}
-#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
-	if( libcthreads_read_write_lock_grab_for_read(
-	     internal_file->read_write_lock,
-	     error ) != 1 )
+	if( export_writer == NULL )
 	{
 		libcerror_error_set(
 		 error,
-		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
-		 "%s: unable to grab read/write lock for reading.",
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid export writer.",
 		 function );
 
 		return( -1 );
 	}
-#endif
-	*format_version = internal_file->file_header->format_version;
-
-#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
-	if( libcthreads_read_write_lock_release_for_read(
-	     internal_file->read_write_lock,
+	/* The export is stopped when the file is signalled to abort after this point
+	 */
+	if( libqcow_internal_file_get_abort_generation(
+	     internal_file,
+	     &abort_generation,
 	     error ) != 1 )
 	{
 		libcerror_error_set(
 		 error,
 		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
-		 "%s: unable to release read/write lock for reading.",
+		 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+		 "%s: unable to retrieve abort generation.",
 		 function );
 
 		return( -1 );
 	}
+	media_size = internal_file->file_header->media_size;
+
+	while( (size64_t) chunk_offset < media_size )
+	{
+		chunk_size = LIBQCOW_EXPORT_CHUNK_SIZE;
+
+		if( (size64_t) chunk_size > ( media_size - chunk_offset ) )
+		{
+			chunk_size = (size_t) ( media_size - chunk_offset );
+		}
+		chunk_end_offset = chunk_offset + (off64_t) chunk_size;
+		result           = 0;
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+		if( libcthreads_read_write_lock_grab_for_write(
+		     internal_file->read_write_lock,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+			 "%s: unable to grab read/write lock for writing.",
+			 function );
+
+			goto on_error;
+		}
 #endif
+		result = libqcow_internal_file_read_is_stopped(
+		          internal_file,
+		          NULL,
+		          abort_generation,
+		          error );
+
+		if( result == -1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+			 "%s: unable to determine if export is stopped.",
+			 function );
+		}
+		else if( result != 0 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_ABORT_REQUESTED,
+			 "%s: abort requested.",
+			 function );
+
+			result = -1;
+		}
+		/* Determine if any layer of the backing chain stores data in the chunk
+		 */
+		range_offset = chunk_offset;
+
+		while( ( result == 0 )
+		    && ( range_offset < chunk_end_offset ) )
+		{
+			range_size = (size64_t) ( chunk_end_offset - range_offset );
+
+			result = libqcow_internal_file_get_allocation_range(
+			          internal_file,
+			          range_offset,
+			          &range_size,
+			          error );
+
+			if( result == -1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+				 "%s: unable to determine allocation of range at offset: %" PRIi64 " (0x%08" PRIx64 ").",
+				 function,
+				 range_offset,
+				 range_offset );
+			}
+			else if( result == 0 )
+			{
+				range_offset += (off64_t) range_size;
+			}
+		}
+		if( result == 1 )
+		{
+			result = libqcow_export_chunk_initialize(
+			          &export_chunk,
+			          chunk_offset,
+			          chunk_size,
+			          export_writer->cluster_block_size,
+			          error );
+
+			if( result != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+				 "%s: unable to create export chunk.",
+				 function );
+
+				result = -1;
+			}
+		}
+		if( result == 1 )
+		{
+			/* Reading the chunk does not change the offset of the file
+			 */
+			read_count = libqcow_internal_file_read_buffer_from_file_io_handle(
+			              internal_file,
+			              internal_file->file_io_handle,
+			              export_chunk->data,
+			              chunk_size,
+			              chunk_offset,
+			              NULL,
+			              abort_generation,
+			              error );
+
+			if( read_count != (ssize_t) chunk_size )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_IO,
+				 LIBCERROR_IO_ERROR_READ_FAILED,
+				 "%s: unable to read chunk at offset: %" PRIi64 " (0x%08" PRIx64 ").",
+				 function,
+				 chunk_offset,
+				 chunk_offset );
+
+				result = -1;
+			}
+		}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+		if( libcthreads_read_write_lock_release_for_write(
+		     internal_file->read_write_lock,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+			 "%s: unable to release read/write lock for writing.",
+			 function );
+
+			goto on_error;
+		}
+#endif
+		if( result == -1 )
+		{
+			goto on_error;
+		}
+		/* The chunk is pushed without holding the read/write lock since the push
+		 * blocks while the export writer is behind
+		 */
+		if( export_chunk != NULL )
+		{
+			if( libqcow_export_writer_push_chunk(
+			     export_writer,
+			     &export_chunk,
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_APPEND_FAILED,
+				 "%s: unable to push export chunk.",
+				 function );
+
+				goto on_error;
+			}
+		}
+		/* The error of the export writer is returned when the export is finalized
+		 */
+		result = libqcow_export_writer_has_failed(
+		          export_writer,
+		          error );
+
+		if( result == -1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+			 "%s: unable to determine if export writer has failed.",
+			 function );
+
+			goto on_error;
+		}
+		else if( result != 0 )
+		{
+			break;
+		}
+		chunk_offset = chunk_end_offset;
+	}
 	return( 1 );
+
+on_error:
+	if( export_chunk != NULL )
+	{
+		libqcow_export_chunk_free(
+		 &export_chunk,
+		 NULL );
+	}
+	return( -1 );
 }
 
-/* Retrieves the encryption method
+/* Exports the (media) data of the file, including its backing chain, to a new file
  * Returns 1 if successful or -1 on error
  */
-int libqcow_file_get_encryption_method(
+int libqcow_file_export(
      libqcow_file_t *file,
-     uint32_t *encryption_method,
+     const char *filename,
+     int export_format,
      libcerror_error_t **error )
 {
-	libqcow_internal_file_t *internal_file = NULL;
-	static char *function                  = "libqcow_file_get_encryption_method";
+	libbfio_handle_t *file_io_handle = NULL;
+	static char *function            = "libqcow_file_export";
 
 	if( file == NULL )
 	{
@@ -3864,77 +16451,100 @@ int libqcow_file_get_encryption_method(
 
 		return( -1 );
 	}
-	internal_file = (libqcow_internal_file_t *) file;
+	if( filename == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid filename.",
+		 function );
 
-	if( internal_file->file_io_handle == NULL )
+		return( -1 );
+	}
+	if( libbfio_file_initialize(
+	     &file_io_handle,
+	     error ) != 1 )
 	{
 		libcerror_error_set(
 		 error,
 		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
-		 "%s: invalid file - missing file IO handle.",
+		 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+		 "%s: unable to create file IO handle.",
 		 function );
 
-		return( -1 );
+		goto on_error;
 	}
-	if( encryption_method == NULL )
+	if( libbfio_file_set_name(
+	     file_io_handle,
+	     filename,
+	     narrow_string_length(
+	      filename ) + 1,
+	     error ) != 1 )
 	{
-		libcerror_error_set(
-		 error,
-		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
-		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
-		 "%s: invalid encryption method.",
-		 function );
+                libcerror_error_set(
+                 error,
+                 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+                 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+                 "%s: unable to set filename in file IO handle.",
+                 function );
 
-		return( -1 );
+		goto on_error;
 	}
-#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
-	if( libcthreads_read_write_lock_grab_for_read(
-	     internal_file->read_write_lock,
+	if( libqcow_file_export_file_io_handle(
+	     file,
+	     file_io_handle,
+	     export_format,
 	     error ) != 1 )
 	{
 		libcerror_error_set(
 		 error,
-		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
-		 "%s: unable to grab read/write lock for reading.",
-		 function );
+		 LIBCERROR_ERROR_DOMAIN_IO,
+		 LIBCERROR_IO_ERROR_WRITE_FAILED,
+		 "%s: unable to export to file: %s.",
+		 function,
+		 filename );
 
-		return( -1 );
+		goto on_error;
 	}
-#endif
-	*encryption_method = internal_file->encryption_method;
-
-#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
-	if( libcthreads_read_write_lock_release_for_read(
-	     internal_file->read_write_lock,
+	if( libbfio_handle_free(
+	     &file_io_handle,
 	     error ) != 1 )
 	{
 		libcerror_error_set(
 		 error,
 		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
-		 "%s: unable to release read/write lock for reading.",
+		 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+		 "%s: unable to free file IO handle.",
 		 function );
 
-		return( -1 );
+		goto on_error;
 	}
-#endif
 	return( 1 );
+
+on_error:
+	if( file_io_handle != NULL )
+	{
+		libbfio_handle_free(
+		 &file_io_handle,
+		 NULL );
+	}
+	return( -1 );
 }
 
-/* Retrieves the size of the UTF-8 encoded backing filename
- * The returned size includes the end of string character
- * Returns 1 if successful, 0 if not available or -1 on error
+#if defined( HAVE_WIDE_CHARACTER_TYPE )
+
+/* Exports the (media) data of the file, including its backing chain, to a new file
+ * Returns 1 if successful or -1 on error
  */
-int libqcow_file_get_utf8_backing_filename_size(
+int libqcow_file_export_wide(
      libqcow_file_t *file,
-     size_t *utf8_string_size,
+     const wchar_t *filename,
+     int export_format,
      libcerror_error_t **error )
 {
-	libqcow_internal_file_t *internal_file = NULL;
-	static char *function                  = "libqcow_file_get_utf8_backing_filename_size";
-	int result                             = 0;
+	libbfio_handle_t *file_io_handle = NULL;
+	static char *function            = "libqcow_file_export_wide";
 
 	if( file == NULL )
 	{
@@ -3947,85 +16557,105 @@ int libqcow_file_get_utf8_backing_filename_size(
 
 		return( -1 );
 	}
-	internal_file = (libqcow_internal_file_t *) file;
-
-	if( internal_file->file_io_handle == NULL )
+	if( filename == NULL )
 	{
 		libcerror_error_set(
 		 error,
-		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
-		 "%s: invalid file - missing file IO handle.",
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid filename.",
 		 function );
 
 		return( -1 );
 	}
-#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
-	if( libcthreads_read_write_lock_grab_for_read(
-	     internal_file->read_write_lock,
+	if( libbfio_file_initialize(
+	     &file_io_handle,
 	     error ) != 1 )
 	{
 		libcerror_error_set(
 		 error,
 		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
-		 "%s: unable to grab read/write lock for reading.",
+		 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+		 "%s: unable to create file IO handle.",
 		 function );
 
-		return( -1 );
+		goto on_error;
 	}
-#endif
-	if( internal_file->backing_filename != NULL )
+	if( libbfio_file_set_name_wide(
+	     file_io_handle,
+	     filename,
+	     wide_string_length(
+	      filename ) + 1,
+	     error ) != 1 )
 	{
-		result = libuna_utf8_string_size_from_utf8_stream(
-		          internal_file->backing_filename,
-		          internal_file->backing_filename_size,
-		          utf8_string_size,
-		          error );
+                libcerror_error_set(
+                 error,
+                 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+                 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+                 "%s: unable to set filename in file IO handle.",
+                 function );
 
-		if( result != 1 )
-		{
-			libcerror_error_set(
-			 error,
-			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-			 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
-			 "%s: unable to retrieve UTF-8 string size of backing filename.",
-			 function );
+		goto on_error;
+	}
+	if( libqcow_file_export_file_io_handle(
+	     file,
+	     file_io_handle,
+	     export_format,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_IO,
+		 LIBCERROR_IO_ERROR_WRITE_FAILED,
+		 "%s: unable to export to file: %ls.",
+		 function,
+		 filename );
 
-			result = -1;
-		}
+		goto on_error;
 	}
-#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
-	if( libcthreads_read_write_lock_release_for_read(
-	     internal_file->read_write_lock,
+	if( libbfio_handle_free(
+	     &file_io_handle,
 	     error ) != 1 )
 	{
 		libcerror_error_set(
 		 error,
 		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
-		 "%s: unable to release read/write lock for reading.",
+		 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+		 "%s: unable to free file IO handle.",
 		 function );
 
-		return( -1 );
+		goto on_error;
 	}
-#endif
-	return( result );
+	return( 1 );
+
+on_error:
+	if( file_io_handle != NULL )
+	{
+		libbfio_handle_free(
+		 &file_io_handle,
+		 NULL );
+	}
+	return( -1 );
 }
 
-/* Retrieves the UTF-8 encoded backing filename
- * The size should include the end of string character
- * Returns 1 if successful, 0 if not available or -1 on error
+#endif /* defined( HAVE_WIDE_CHARACTER_TYPE ) */
+
+/* Exports the (media) data of the file, including its backing chain, using a Basic File IO (bfio) handle
+ * The file IO handle is opened for writing, with truncation, if it is not open
+ * Returns 1 if successful or -1 on error
  */
-int libqcow_file_get_utf8_backing_filename(
+int libqcow_file_export_file_io_handle(
      libqcow_file_t *file,
-     uint8_t *utf8_string,
-     size_t utf8_string_size,
+     libbfio_handle_t *file_io_handle,
+     int export_format,
      libcerror_error_t **error )
 {
+	libqcow_export_writer_t *export_writer = NULL;
 	libqcow_internal_file_t *internal_file = NULL;
-	static char *function                  = "libqcow_file_get_utf8_backing_filename";
-	int result                             = 0;
+	static char *function                  = "libqcow_file_export_file_io_handle";
+	int file_io_handle_is_open             = 0;
+	int file_io_handle_opened_in_library   = 0;
+	int result                             = 1;
 
 	if( file == NULL )
 	{
@@ -4051,165 +16681,188 @@ int libqcow_file_get_utf8_backing_filename(
 
 		return( -1 );
 	}
-#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
-	if( libcthreads_read_write_lock_grab_for_read(
-	     internal_file->read_write_lock,
-	     error ) != 1 )
+	if( internal_file->file_header == NULL )
 	{
 		libcerror_error_set(
 		 error,
 		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
-		 "%s: unable to grab read/write lock for reading.",
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid file - missing file header.",
 		 function );
 
 		return( -1 );
 	}
-#endif
-	if( internal_file->backing_filename != NULL )
+	if( file_io_handle == NULL )
 	{
-		result = libuna_utf8_string_copy_from_utf8_stream(
-		          utf8_string,
-		          utf8_string_size,
-		          internal_file->backing_filename,
-		          internal_file->backing_filename_size,
-		          error );
-
-		if( result != 1 )
-		{
-			libcerror_error_set(
-			 error,
-			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-			 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
-			 "%s: unable to retrieve UTF-8 string of backing filename.",
-			 function );
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file IO handle.",
+		 function );
 
-			result = -1;
-		}
+		return( -1 );
 	}
-#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
-	if( libcthreads_read_write_lock_release_for_read(
-	     internal_file->read_write_lock,
-	     error ) != 1 )
+	if( ( export_format != LIBQCOW_EXPORT_FORMAT_RAW )
+	 && ( export_format != LIBQCOW_EXPORT_FORMAT_QCOW2 ) )
 	{
 		libcerror_error_set(
 		 error,
-		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
-		 "%s: unable to release read/write lock for reading.",
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_UNSUPPORTED_VALUE,
+		 "%s: unsupported export format.",
 		 function );
 
 		return( -1 );
 	}
-#endif
-	return( result );
-}
-
-/* Retrieves the size of the UTF-16 encoded backing filename
- * The returned size includes the end of string character
- * Returns 1 if successful, 0 if not available or -1 on error
- */
-int libqcow_file_get_utf16_backing_filename_size(
-     libqcow_file_t *file,
-     size_t *utf16_string_size,
-     libcerror_error_t **error )
-{
-	libqcow_internal_file_t *internal_file = NULL;
-	static char *function                  = "libqcow_file_get_utf16_backing_filename_size";
-	int result                             = 0;
+	file_io_handle_is_open = libbfio_handle_is_open(
+	                          file_io_handle,
+	                          error );
 
-	if( file == NULL )
+	if( file_io_handle_is_open == -1 )
 	{
 		libcerror_error_set(
 		 error,
-		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
-		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
-		 "%s: invalid file.",
+		 LIBCERROR_ERROR_DOMAIN_IO,
+		 LIBCERROR_IO_ERROR_OPEN_FAILED,
+		 "%s: unable to determine if file IO handle is open.",
 		 function );
 
-		return( -1 );
+		goto on_error;
 	}
-	internal_file = (libqcow_internal_file_t *) file;
+	else if( file_io_handle_is_open == 0 )
+	{
+		if( libbfio_handle_open(
+		     file_io_handle,
+		     LIBBFIO_OPEN_WRITE_TRUNCATE,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_IO,
+			 LIBCERROR_IO_ERROR_OPEN_FAILED,
+			 "%s: unable to open file IO handle.",
+			 function );
 
-	if( internal_file->file_io_handle == NULL )
+			goto on_error;
+		}
+		file_io_handle_opened_in_library = 1;
+	}
+	if( libqcow_export_writer_initialize(
+	     &export_writer,
+	     file_io_handle,
+	     export_format,
+	     internal_file->file_header->media_size,
+	     error ) != 1 )
 	{
 		libcerror_error_set(
 		 error,
 		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
-		 "%s: invalid file - missing file IO handle.",
+		 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+		 "%s: unable to create export writer.",
 		 function );
 
-		return( -1 );
+		goto on_error;
 	}
-#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
-	if( libcthreads_read_write_lock_grab_for_read(
-	     internal_file->read_write_lock,
+	if( libqcow_internal_file_export(
+	     internal_file,
+	     export_writer,
 	     error ) != 1 )
 	{
 		libcerror_error_set(
 		 error,
-		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
-		 "%s: unable to grab read/write lock for reading.",
+		 LIBCERROR_ERROR_DOMAIN_IO,
+		 LIBCERROR_IO_ERROR_READ_FAILED,
+		 "%s: unable to export data.",
 		 function );
 
-		return( -1 );
+		result = -1;
 	}
-#endif
-	if( internal_file->backing_filename != NULL )
+	/* The export writer is finalized after a failed export to stop the write thread
+	 */
+	if( libqcow_export_writer_finalize(
+	     export_writer,
+	     ( result == 1 ) ? error : NULL ) != 1 )
 	{
-		result = libuna_utf16_string_size_from_utf8_stream(
-		          internal_file->backing_filename,
-		          internal_file->backing_filename_size,
-		          utf16_string_size,
-		          error );
-
-		if( result != 1 )
+		if( result == 1 )
 		{
 			libcerror_error_set(
 			 error,
-			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-			 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
-			 "%s: unable to retrieve UTF-16 string size of backing filename.",
+			 LIBCERROR_ERROR_DOMAIN_IO,
+			 LIBCERROR_IO_ERROR_WRITE_FAILED,
+			 "%s: unable to finalize export.",
 			 function );
-
-			result = -1;
 		}
+		result = -1;
 	}
-#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
-	if( libcthreads_read_write_lock_release_for_read(
-	     internal_file->read_write_lock,
+	if( libqcow_export_writer_free(
+	     &export_writer,
 	     error ) != 1 )
 	{
 		libcerror_error_set(
 		 error,
 		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
-		 "%s: unable to release read/write lock for reading.",
+		 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+		 "%s: unable to free export writer.",
 		 function );
 
-		return( -1 );
+		result = -1;
+	}
+	if( file_io_handle_opened_in_library != 0 )
+	{
+		if( libbfio_handle_close(
+		     file_io_handle,
+		     error ) != 0 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_IO,
+			 LIBCERROR_IO_ERROR_CLOSE_FAILED,
+			 "%s: unable to close file IO handle.",
+			 function );
+
+			result = -1;
+		}
 	}
-#endif
 	return( result );
+
+on_error:
+	if( export_writer != NULL )
+	{
+		libqcow_export_writer_free(
+		 &export_writer,
+		 NULL );
+	}
+	if( file_io_handle_opened_in_library != 0 )
+	{
+		libbfio_handle_close(
+		 file_io_handle,
+		 NULL );
+	}
+	return( -1 );
 }
 
-/* Retrieves the UTF-16 encoded backing filename
- * The size should include the end of string character
- * Returns 1 if successful, 0 if not available or -1 on error
+/* Scans the allocated (media) data of the file, including its backing chain, using a scanner
+ * The allocation is determined by the calling thread and the allocated ranges are pushed
+ * to the scanner in chunks, ranges that only contain sparse or zero cluster blocks in the
+ * backing chain are not pushed
+ * The read/write lock is grabbed per range so that the file can be read while scanning
+ * Returns 1 if successful or -1 on error
  */
-int libqcow_file_get_utf16_backing_filename(
-     libqcow_file_t *file,
-     uint16_t *utf16_string,
-     size_t utf16_string_size,
+int libqcow_internal_file_scan(
+     libqcow_internal_file_t *internal_file,
+     libqcow_scanner_t *scanner,
      libcerror_error_t **error )
 {
-	libqcow_internal_file_t *internal_file = NULL;
-	static char *function                  = "libqcow_file_get_utf16_backing_filename";
-	int result                             = 0;
+	static char *function = "libqcow_internal_file_scan";
+	size64_t media_size   = 0;
+	size64_t range_size   = 0;
+	size_t chunk_size     = 0;
+	off64_t chunk_offset  = 0;
+	off64_t range_offset  = 0;
+	int result            = 0;
 
-	if( file == NULL )
+	if( internal_file == NULL )
 	{
 		libcerror_error_set(
 		 error,
@@ -4220,83 +16873,204 @@ int libqcow_file_get_utf16_backing_filename(
 
 		return( -1 );
 	}
-	internal_file = (libqcow_internal_file_t *) file;
-
-	if( internal_file->file_io_handle == NULL )
+	if( internal_file->file_header == NULL )
 	{
 		libcerror_error_set(
 		 error,
 		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
 		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
-		 "%s: invalid file - missing file IO handle.",
+		 "%s: invalid file - missing file header.",
 		 function );
 
 		return( -1 );
 	}
-#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
-	if( libcthreads_read_write_lock_grab_for_read(
-	     internal_file->read_write_lock,
-	     error ) != 1 )
+	if( internal_file->io_handle == NULL )
 	{
 		libcerror_error_set(
 		 error,
 		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
-		 "%s: unable to grab read/write lock for reading.",
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid file - missing IO handle.",
 		 function );
 
 		return( -1 );
 	}
-#endif
-	if( internal_file->backing_filename != NULL )
+	if( scanner == NULL )
 	{
-		result = libuna_utf16_string_copy_from_utf8_stream(
-		          utf16_string,
-		          utf16_string_size,
-		          internal_file->backing_filename,
-		          internal_file->backing_filename_size,
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid scanner.",
+		 function );
+
+		return( -1 );
+	}
+	media_size = internal_file->file_header->media_size;
+
+	while( (size64_t) range_offset < media_size )
+	{
+		/* A chunk is extended with consecutive allocated ranges up to the chunk size
+		 */
+		range_size = media_size - (size64_t) range_offset;
+
+		if( range_size > (size64_t) ( LIBQCOW_SCAN_CHUNK_SIZE - chunk_size ) )
+		{
+			range_size = (size64_t) ( LIBQCOW_SCAN_CHUNK_SIZE - chunk_size );
+		}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+		if( libcthreads_read_write_lock_grab_for_write(
+		     internal_file->read_write_lock,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+			 "%s: unable to grab read/write lock for writing.",
+			 function );
+
+			return( -1 );
+		}
+#endif
+		/* The scan is stopped when the file was signalled to abort after the scanner was created
+		 */
+		result = libqcow_internal_file_read_is_stopped(
+		          internal_file,
+		          NULL,
+		          scanner->abort_generation,
 		          error );
 
-		if( result != 1 )
+		if( result == -1 )
 		{
 			libcerror_error_set(
 			 error,
 			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
 			 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
-			 "%s: unable to retrieve UTF-16 string of backing filename.",
+			 "%s: unable to determine if scan is stopped.",
+			 function );
+		}
+		else if( result != 0 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_ABORT_REQUESTED,
+			 "%s: abort requested.",
 			 function );
 
 			result = -1;
 		}
-	}
+		else
+		{
+			result = libqcow_internal_file_get_allocation_range(
+			          internal_file,
+			          range_offset,
+			          &range_size,
+			          error );
+
+			if( result == -1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+				 "%s: unable to determine allocation of range at offset: %" PRIi64 " (0x%08" PRIx64 ").",
+				 function,
+				 range_offset,
+				 range_offset );
+			}
+		}
 #if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
-	if( libcthreads_read_write_lock_release_for_read(
-	     internal_file->read_write_lock,
-	     error ) != 1 )
-	{
-		libcerror_error_set(
-		 error,
-		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
-		 "%s: unable to release read/write lock for reading.",
-		 function );
+		if( libcthreads_read_write_lock_release_for_write(
+		     internal_file->read_write_lock,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+			 "%s: unable to release read/write lock for writing.",
+			 function );
 
-		return( -1 );
-	}
+			return( -1 );
+		}
 #endif
-	return( result );
+		if( result == -1 )
+		{
+			return( -1 );
+		}
+		if( result != 0 )
+		{
+			if( chunk_size == 0 )
+			{
+				chunk_offset = range_offset;
+			}
+			chunk_size += (size_t) range_size;
+		}
+		range_offset += (off64_t) range_size;
+
+		/* The chunk is pushed without holding the read/write lock since the push
+		 * blocks while the scanner is behind
+		 */
+		if( ( chunk_size > 0 )
+		 && ( ( result == 0 )
+		  ||  ( chunk_size >= (size_t) LIBQCOW_SCAN_CHUNK_SIZE )
+		  ||  ( (size64_t) range_offset >= media_size ) ) )
+		{
+			result = libqcow_scanner_push_chunk(
+			          scanner,
+			          chunk_offset,
+			          chunk_size,
+			          error );
+
+			if( result == -1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_APPEND_FAILED,
+				 "%s: unable to push scan chunk.",
+				 function );
+
+				return( -1 );
+			}
+			/* The error of the scanner is returned when the scan is finalized
+			 */
+			else if( result == 0 )
+			{
+				break;
+			}
+			chunk_size = 0;
+		}
+	}
+	return( 1 );
 }
 
-/* Retrieves the number of snapshots
+/* Scans the allocated (media) data of the file, including its backing chain
+ * The data is read by a number of threads and passed to the callback function in chunks,
+ * in order of the (media) offset or, if LIBQCOW_SCAN_FLAG_UNORDERED is set, in order of completion
+ * The callback function is called by one thread at a time and returns 1 to continue the scan,
+ * 0 to stop the scan or -1 on error
+ * A number of threads of 0 represents the default number of threads
  * Returns 1 if successful or -1 on error
  */
-int libqcow_file_get_number_of_snapshots(
+int libqcow_file_scan(
      libqcow_file_t *file,
-     int *number_of_snapshots,
+     int (*callback_function)(
+            off64_t offset,
+            const uint8_t *data,
+            size_t data_size,
+            void *callback_data ),
+     void *callback_data,
+     int number_of_threads,
+     uint8_t scan_flags,
      libcerror_error_t **error )
 {
 	libqcow_internal_file_t *internal_file = NULL;
-	static char *function                  = "libqcow_file_get_number_of_snapshots";
+	libqcow_scanner_t *scanner             = NULL;
+	static char *function                  = "libqcow_file_scan";
+	int result                             = 1;
 
 	if( file == NULL )
 	{
@@ -4311,61 +17085,79 @@ int libqcow_file_get_number_of_snapshots(
 	}
 	internal_file = (libqcow_internal_file_t *) file;
 
-	if( internal_file->file_header == NULL )
+	if( internal_file->file_io_handle == NULL )
 	{
 		libcerror_error_set(
 		 error,
 		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
 		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
-		 "%s: invalid file - missing file header.",
+		 "%s: invalid file - missing file IO handle.",
 		 function );
 
 		return( -1 );
 	}
-	if( number_of_snapshots == NULL )
+	if( libqcow_scanner_initialize(
+	     &scanner,
+	     file,
+	     callback_function,
+	     callback_data,
+	     number_of_threads,
+	     scan_flags,
+	     error ) != 1 )
 	{
 		libcerror_error_set(
 		 error,
-		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
-		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
-		 "%s: invalid number of snapshots.",
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+		 "%s: unable to create scanner.",
 		 function );
 
 		return( -1 );
 	}
-#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
-	if( libcthreads_read_write_lock_grab_for_read(
-	     internal_file->read_write_lock,
+	if( libqcow_internal_file_scan(
+	     internal_file,
+	     scanner,
 	     error ) != 1 )
 	{
 		libcerror_error_set(
 		 error,
-		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
-		 "%s: unable to grab read/write lock for reading.",
+		 LIBCERROR_ERROR_DOMAIN_IO,
+		 LIBCERROR_IO_ERROR_READ_FAILED,
+		 "%s: unable to scan data.",
 		 function );
 
-		return( -1 );
+		result = -1;
 	}
-#endif
-	/* TODO retrieve number of snapshots from array */
-	*number_of_snapshots = (int) internal_file->file_header->number_of_snapshots;
-
-#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
-	if( libcthreads_read_write_lock_release_for_read(
-	     internal_file->read_write_lock,
+	/* The scanner is finalized after a failed scan to stop the read threads
+	 */
+	if( libqcow_scanner_finalize(
+	     scanner,
+	     ( result == 1 ) ? error : NULL ) != 1 )
+	{
+		if( result == 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_IO,
+			 LIBCERROR_IO_ERROR_READ_FAILED,
+			 "%s: unable to finalize scan.",
+			 function );
+		}
+		result = -1;
+	}
+	if( libqcow_scanner_free(
+	     &scanner,
 	     error ) != 1 )
 	{
 		libcerror_error_set(
 		 error,
 		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
-		 "%s: unable to release read/write lock for reading.",
+		 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+		 "%s: unable to free scanner.",
 		 function );
 
-		return( -1 );
+		result = -1;
 	}
-#endif
-	return( 1 );
+	return( result );
 }
 
@@ -25,17 +25,31 @@
 #include <common.h>
 #include <types.h>
 
+#include "libqcow_cache_pool.h"
+#include "libqcow_chain_index.h"
+#include "libqcow_changed_extents.h"
 #include "libqcow_cluster_block.h"
 #include "libqcow_cluster_table.h"
+#include "libqcow_data_pin.h"
+#include "libqcow_decode_job.h"
 #include "libqcow_encryption.h"
+#include "libqcow_export_writer.h"
+#include "libqcow_extent_index.h"
 #include "libqcow_extern.h"
 #include "libqcow_file_header.h"
+#include "libqcow_file_io_pool.h"
 #include "libqcow_io_handle.h"
 #include "libqcow_libbfio.h"
 #include "libqcow_libcerror.h"
 #include "libqcow_libcthreads.h"
 #include "libqcow_libfcache.h"
 #include "libqcow_libfdata.h"
+#include "libqcow_mapped_file.h"
+#include "libqcow_mapping_index.h"
+#include "libqcow_read_control.h"
+#include "libqcow_scanner.h"
+#include "libqcow_scheduler.h"
+#include "libqcow_snapshot_values.h"
 
 #if defined( __cplusplus )
 extern "C" {
@@ -49,6 +63,11 @@ struct libqcow_internal_file
 	 */
 	off64_t current_offset;
 
+	/* The abort generation
+	 * Incremented every time the file is signalled to abort
+	 */
+	uint32_t abort_generation;
+
 	/* The IO handle
 	 */
 	libqcow_io_handle_t *io_handle;
@@ -65,6 +84,43 @@ struct libqcow_internal_file
 	 */
 	uint8_t file_io_handle_opened_in_library;
 
+	/* The file IO pool
+	 * Contains clones of the file IO handle that are read from without the read/write lock
+	 */
+	libqcow_file_io_pool_t *file_io_pool;
+
+	/* Value to indicate the file IO handle cannot be cloned
+	 */
+	uint8_t file_io_handle_cannot_be_cloned;
+
+	/* The external data file IO handle
+	 */
+	libbfio_handle_t *data_file_io_handle;
+
+	/* Value to indicate if the external data file IO handle was created inside the library
+	 */
+	uint8_t data_file_io_handle_created_in_library;
+
+	/* Value to indicate if the external data file IO handle was opened inside the library
+	 */
+	uint8_t data_file_io_handle_opened_in_library;
+
+	/* The external data file size
+	 */
+	size64_t data_file_size;
+
+	/* The external data file cluster block vector
+	 */
+	libfdata_vector_t *data_file_cluster_block_vector;
+
+	/* Value to indicate the external data file contains the guest data 1:1
+	 */
+	uint8_t data_file_is_raw;
+
+	/* The access flags, including the open flags
+	 */
+	int access_flags;
+
 	/* The (file) size
 	 */
 	size64_t size;
@@ -117,6 +173,20 @@ struct libqcow_internal_file
 	 */
 	libfcache_cache_t *level2_table_cache;
 
+	/* The maximum number of level2 table cache entries
+	 */
+	int maximum_level2_table_cache_entries;
+
+	/* The published level 2 tables
+	 * Level 2 tables are published with the write lock grabbed and
+	 * can be looked up with the read lock grabbed
+	 */
+	libqcow_cluster_table_t **published_level2_tables;
+
+	/* The size of the published level 2 tables
+	 */
+	size_t published_level2_tables_size;
+
 	/* The cluster block size
  	 */
 	size64_t cluster_block_size;
@@ -125,10 +195,19 @@ struct libqcow_internal_file
  	 */
 	uint64_t cluster_block_bit_mask;
 
+	/* The subcluster size
+	 * Only set if the level 2 table entries are extended with subcluster allocation bitmaps
+ 	 */
+	size64_t subcluster_size;
+
 	/* The offset bit mask
  	 */
 	uint64_t offset_bit_mask;
 
+	/* The compressed cluster block descriptor bit mask
+ 	 */
+	uint64_t compressed_offset_bit_mask;
+
 	/* The compression flag bit mask
  	 */
 	uint64_t compression_flag_bit_mask;
@@ -141,9 +220,9 @@ struct libqcow_internal_file
  	 */
 	uint64_t compression_bit_shift;
 
-	/* The sparse flag bit mask
+	/* The zero flag bit mask
  	 */
-	uint64_t sparse_flag_bit_mask;
+	uint64_t zero_flag_bit_mask;
 
 	/* The cluster block vector
 	 */
@@ -157,6 +236,90 @@ struct libqcow_internal_file
 	 */
 	libfcache_cache_t *compressed_cluster_block_cache;
 
+	/* The maximum number of cluster block cache entries
+	 */
+	int maximum_cluster_block_cache_entries;
+
+	/* The number of cluster block reads
+	 * Used to apportion the cache entries across the layers of a backing chain
+	 */
+	uint64_t number_of_cluster_block_reads;
+
+	/* The cache pool
+	 */
+	libqcow_cache_pool_t *cache_pool;
+
+	/* Value to indicate if the cache pool was created inside the library
+	 */
+	uint8_t cache_pool_created_in_library;
+
+	/* The scheduler
+	 * The threads of the scheduler run the asynchronous reads, scans and decode jobs of the file
+	 */
+	libqcow_scheduler_t *scheduler;
+
+	/* The file identity
+	 * Used to share the cluster blocks with other files of the same file in the cache pool
+	 */
+	libqcow_file_identity_t file_identity;
+
+	/* Value to indicate the file identity is set
+	 */
+	uint8_t file_identity_is_set;
+
+	/* The cluster block of the cache pool that was read last
+	 * The cluster block remains pinned until the next cluster block is read or the file is closed
+	 */
+	libqcow_cluster_block_t *cache_pool_cluster_block;
+
+	/* The extent index
+	 */
+	libqcow_extent_index_t *extent_index;
+
+	/* The mapping index
+	 */
+	libqcow_mapping_index_t *mapping_index;
+
+	/* The mapping index filename
+	 */
+	char *mapping_index_filename;
+
+	/* The memory mapped file
+	 */
+	libqcow_mapped_file_t *mapped_file;
+
+	/* The sparse cluster block
+	 */
+	libqcow_cluster_block_t *sparse_cluster_block;
+
+	/* The number of data pins
+	 */
+	int number_of_data_pins;
+
+	/* The snapshot values array
+	 */
+	libqcow_snapshot_values_t **snapshot_values_array;
+
+	/* The number of snapshots
+	 */
+	int number_of_snapshots;
+
+	/* The number of open snapshots
+	 */
+	int number_of_open_snapshots;
+
+	/* The number of open cursors
+	 */
+	int number_of_open_cursors;
+
+	/* The number of open read requests
+	 */
+	int number_of_open_read_requests;
+
+	/* The number of concurrent reads in progress
+	 */
+	int number_of_concurrent_reads;
+
 	/* Value to indicate if the file is locked
 	 */
 	uint8_t is_locked;
@@ -165,10 +328,44 @@ struct libqcow_internal_file
 	 */
 	libqcow_file_t *parent_file;
 
+	/* Value to indicate if the parent file was created inside the library
+	 */
+	uint8_t parent_file_created_in_library;
+
+	/* The number of reads since the cache entries were apportioned across the backing chain
+	 */
+	int number_of_reads_since_cache_budget_update;
+
+	/* The backing chain index
+	 * Contains the layer of the backing chain that contains the data of ranges not stored in the file
+	 */
+	libqcow_chain_index_t *chain_index;
+
 #if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	/* The read thread pool
+	 * Created on the first asynchronous read
+	 */
+	libcthreads_thread_pool_t *read_thread_pool;
+
+	/* The read scheduler queue
+	 * Contains the asynchronous reads of the file when a scheduler is set
+	 */
+	libqcow_scheduler_queue_t *read_scheduler_queue;
+
+	/* The decode scheduler queue
+	 * Contains the decode jobs of the cluster blocks of the file when a scheduler is set
+	 */
+	libqcow_scheduler_queue_t *decode_scheduler_queue;
+
 	/* The read/write lock
 	 */
 	libcthreads_read_write_lock_t *read_write_lock;
+
+	/* The abort mutex
+	 * Protects the abort generation, which is not protected by the read/write lock
+	 * so that the file can be signalled to abort while it is being read
+	 */
+	libcthreads_mutex_t *abort_mutex;
 #endif
 };
 
@@ -205,6 +402,66 @@ int libqcow_file_open_wide(
 
 #endif /* defined( HAVE_WIDE_CHARACTER_TYPE ) */
 
+LIBQCOW_EXTERN \
+int libqcow_file_open_with_backing_chain(
+     libqcow_file_t *file,
+     const char *filename,
+     int access_flags,
+     libcerror_error_t **error );
+
+#if defined( HAVE_WIDE_CHARACTER_TYPE )
+
+LIBQCOW_EXTERN \
+int libqcow_file_open_with_backing_chain_wide(
+     libqcow_file_t *file,
+     const wchar_t *filename,
+     int access_flags,
+     libcerror_error_t **error );
+
+#endif /* defined( HAVE_WIDE_CHARACTER_TYPE ) */
+
+int libqcow_internal_file_get_backing_file_path(
+     libqcow_internal_file_t *internal_file,
+     const char *filename,
+     char **backing_file_path,
+     size_t *backing_file_path_size,
+     libcerror_error_t **error );
+
+int libqcow_internal_file_open_backing_chain(
+     libqcow_file_t *file,
+     const char *filename,
+     int access_flags,
+     int chain_depth,
+     libcerror_error_t **error );
+
+#if defined( HAVE_WIDE_CHARACTER_TYPE )
+
+int libqcow_internal_file_get_backing_file_path_wide(
+     libqcow_internal_file_t *internal_file,
+     const wchar_t *filename,
+     wchar_t **backing_file_path,
+     size_t *backing_file_path_size,
+     libcerror_error_t **error );
+
+int libqcow_internal_file_open_backing_chain_wide(
+     libqcow_file_t *file,
+     const wchar_t *filename,
+     int access_flags,
+     int chain_depth,
+     libcerror_error_t **error );
+
+#endif /* defined( HAVE_WIDE_CHARACTER_TYPE ) */
+
+int libqcow_internal_file_resize_caches(
+     libqcow_internal_file_t *internal_file,
+     int maximum_level2_table_cache_entries,
+     int maximum_cluster_block_cache_entries,
+     libcerror_error_t **error );
+
+int libqcow_internal_file_apportion_cache_budget(
+     libqcow_internal_file_t *internal_file,
+     libcerror_error_t **error );
+
 LIBQCOW_EXTERN \
 int libqcow_file_open_file_io_handle(
      libqcow_file_t *file,
@@ -217,11 +474,46 @@ int libqcow_file_close(
      libqcow_file_t *file,
      libcerror_error_t **error );
 
+LIBQCOW_EXTERN \
+int libqcow_file_open_data_file(
+     libqcow_file_t *file,
+     const char *filename,
+     libcerror_error_t **error );
+
+#if defined( HAVE_WIDE_CHARACTER_TYPE )
+
+LIBQCOW_EXTERN \
+int libqcow_file_open_data_file_wide(
+     libqcow_file_t *file,
+     const wchar_t *filename,
+     libcerror_error_t **error );
+
+#endif /* defined( HAVE_WIDE_CHARACTER_TYPE ) */
+
+LIBQCOW_EXTERN \
+int libqcow_file_open_data_file_io_handle(
+     libqcow_file_t *file,
+     libbfio_handle_t *file_io_handle,
+     libcerror_error_t **error );
+
+int libqcow_internal_file_close_data_file(
+     libqcow_internal_file_t *internal_file,
+     libcerror_error_t **error );
+
 int libqcow_internal_file_open_read(
      libqcow_internal_file_t *internal_file,
      libbfio_handle_t *file_io_handle,
      libcerror_error_t **error );
 
+int libqcow_internal_file_open_read_snapshot_table(
+     libqcow_internal_file_t *internal_file,
+     libbfio_handle_t *file_io_handle,
+     libcerror_error_t **error );
+
+int libqcow_internal_file_free_snapshot_table(
+     libqcow_internal_file_t *internal_file,
+     libcerror_error_t **error );
+
 int libqcow_internal_file_open_read_backing_filename(
      libqcow_internal_file_t *internal_file,
      libbfio_handle_t *file_io_handle,
@@ -229,34 +521,286 @@ int libqcow_internal_file_open_read_backing_filename(
      uint32_t backing_filename_size,
      libcerror_error_t **error );
 
+int libqcow_internal_file_open_mapped_file(
+     libqcow_internal_file_t *internal_file,
+     const char *filename,
+     libcerror_error_t **error );
+
+int libqcow_internal_file_open_file_io_pool(
+     libqcow_internal_file_t *internal_file,
+     libcerror_error_t **error );
+
+int libqcow_internal_file_open_mapping_index(
+     libqcow_internal_file_t *internal_file,
+     const char *filename,
+     libcerror_error_t **error );
+
 LIBQCOW_EXTERN \
 int libqcow_file_is_locked(
      libqcow_file_t *file,
      libcerror_error_t **error );
 
+LIBQCOW_EXTERN \
+int libqcow_file_write_mapping_index(
+     libqcow_file_t *file,
+     libcerror_error_t **error );
+
+int libqcow_internal_file_get_cluster_block_values(
+     libqcow_internal_file_t *internal_file,
+     uint64_t level2_table_reference,
+     uint64_t *cluster_block_offset,
+     uint32_t *cluster_block_flags,
+     libcerror_error_t **error );
+
+int libqcow_internal_file_index_level2_table(
+     libqcow_internal_file_t *internal_file,
+     int level1_table_index,
+     libqcow_cluster_table_t *level2_table,
+     libcerror_error_t **error );
+
+int libqcow_internal_file_index_level2_tables(
+     libqcow_internal_file_t *internal_file,
+     libbfio_handle_t *file_io_handle,
+     uint32_t abort_generation,
+     libcerror_error_t **error );
+
+int libqcow_internal_file_get_level2_table_cluster_block_values(
+     libqcow_internal_file_t *internal_file,
+     libqcow_cluster_table_t *level2_table,
+     int level2_table_index,
+     uint64_t cluster_block_data_offset,
+     uint64_t *cluster_block_offset,
+     size_t *cluster_block_data_size,
+     uint32_t *cluster_block_flags,
+     libcerror_error_t **error );
+
+int libqcow_internal_file_get_mapped_cluster_block_offset(
+     libqcow_internal_file_t *internal_file,
+     libqcow_cluster_table_t *level1_table,
+     off64_t offset,
+     uint64_t *cluster_block_offset,
+     uint64_t *cluster_block_data_offset,
+     size_t *cluster_block_data_size,
+     uint32_t *cluster_block_flags,
+     libcerror_error_t **error );
+
+int libqcow_internal_file_publish_level2_table(
+     libqcow_internal_file_t *internal_file,
+     int level1_table_index,
+     libqcow_cluster_table_t *level2_table,
+     libcerror_error_t **error );
+
+int libqcow_internal_file_free_published_level2_tables(
+     libqcow_internal_file_t *internal_file,
+     libcerror_error_t **error );
+
+int libqcow_internal_file_get_published_cluster_block_offset(
+     libqcow_internal_file_t *internal_file,
+     libqcow_cluster_table_t *level1_table,
+     off64_t offset,
+     uint64_t *cluster_block_offset,
+     uint64_t *cluster_block_data_offset,
+     size_t *cluster_block_data_size,
+     uint32_t *cluster_block_flags,
+     libcerror_error_t **error );
+
 int libqcow_internal_file_get_cluster_block_offset(
      libqcow_internal_file_t *internal_file,
      libbfio_handle_t *file_io_handle,
+     libqcow_cluster_table_t *level1_table,
      off64_t offset,
      uint64_t *cluster_block_offset,
      uint64_t *cluster_block_data_offset,
+     size_t *cluster_block_data_size,
      uint32_t *cluster_block_flags,
      libcerror_error_t **error );
 
+int libqcow_internal_file_get_compressed_cluster_block_range(
+     libqcow_internal_file_t *internal_file,
+     uint64_t cluster_block_offset,
+     uint64_t *compressed_data_offset,
+     size_t *compressed_data_size,
+     libcerror_error_t **error );
+
+int libqcow_internal_file_decode_data(
+     libqcow_internal_file_t *internal_file,
+     libqcow_scheduler_t *scheduler,
+     uint8_t decode_type,
+     const uint8_t *data,
+     size_t data_size,
+     uint8_t *buffer,
+     size_t buffer_size,
+     off64_t offset,
+     libcerror_error_t **error );
+
+int libqcow_internal_file_wait_for_decode_jobs(
+     libqcow_internal_file_t *internal_file,
+     libqcow_scheduler_batch_t *scheduler_batch,
+     libqcow_decode_job_t **decode_jobs,
+     libcerror_error_t **error );
+
+int libqcow_internal_file_decompress_cluster_block(
+     libqcow_internal_file_t *internal_file,
+     libbfio_handle_t *file_io_handle,
+     libqcow_scheduler_t *scheduler,
+     uint64_t compressed_data_offset,
+     size_t compressed_data_size,
+     libqcow_cluster_block_t **cluster_block,
+     libcerror_error_t **error );
+
 int libqcow_internal_file_read_cluster_block(
      libqcow_internal_file_t *internal_file,
      libbfio_handle_t *file_io_handle,
+     off64_t offset,
      uint64_t cluster_block_offset,
      uint64_t cluster_block_data_offset,
      uint32_t cluster_block_flags,
      libqcow_cluster_block_t **cluster_block,
      libcerror_error_t **error );
 
+int libqcow_internal_file_hold_cache_pool_cluster_block(
+     libqcow_internal_file_t *internal_file,
+     libqcow_cluster_block_t *cluster_block,
+     libcerror_error_t **error );
+
+ssize_t libqcow_internal_file_read_buffer_from_raw_data_file(
+         libqcow_internal_file_t *internal_file,
+         void *buffer,
+         size_t buffer_size,
+         off64_t offset,
+         libcerror_error_t **error );
+
+int libqcow_internal_file_resolve_offset(
+     libqcow_internal_file_t *internal_file,
+     off64_t offset,
+     libqcow_chain_index_entry_t *chain_index_entry,
+     libcerror_error_t **error );
+
+int libqcow_internal_file_get_parent_chain_index_entry(
+     libqcow_internal_file_t *internal_file,
+     off64_t offset,
+     libqcow_chain_index_entry_t *chain_index_entry,
+     libcerror_error_t **error );
+
+int libqcow_internal_file_get_allocation_range(
+     libqcow_internal_file_t *internal_file,
+     off64_t offset,
+     size64_t *range_size,
+     libcerror_error_t **error );
+
+int libqcow_internal_file_get_abort_generation(
+     libqcow_internal_file_t *internal_file,
+     uint32_t *abort_generation,
+     libcerror_error_t **error );
+
+int libqcow_internal_file_read_is_stopped(
+     libqcow_internal_file_t *internal_file,
+     libqcow_read_control_t *read_control,
+     uint32_t abort_generation,
+     libcerror_error_t **error );
+
+int libqcow_internal_file_chain_index_entry_is_direct(
+     libqcow_chain_index_entry_t *chain_index_entry,
+     libcerror_error_t **error );
+
+ssize_t libqcow_internal_file_read_buffer_from_parent_file(
+         libqcow_internal_file_t *internal_file,
+         void *buffer,
+         size_t buffer_size,
+         off64_t offset,
+         libqcow_read_control_t *read_control,
+         uint32_t abort_generation,
+         libcerror_error_t **error );
+
+ssize_t libqcow_internal_file_read_buffer_from_level1_table(
+         libqcow_internal_file_t *internal_file,
+         libbfio_handle_t *file_io_handle,
+         libqcow_cluster_table_t *level1_table,
+         size64_t media_size,
+         void *buffer,
+         size_t buffer_size,
+         off64_t offset,
+         libqcow_read_control_t *read_control,
+         uint32_t abort_generation,
+         libcerror_error_t **error );
+
+ssize_t libqcow_internal_file_read_mapped_buffer_at_offset(
+         libqcow_internal_file_t *internal_file,
+         uint8_t *buffer,
+         size_t buffer_size,
+         off64_t offset,
+         libcerror_error_t **error );
+
 ssize_t libqcow_internal_file_read_buffer_from_file_io_handle(
          libqcow_internal_file_t *internal_file,
          libbfio_handle_t *file_io_handle,
          void *buffer,
          size_t buffer_size,
+         off64_t offset,
+         libqcow_read_control_t *read_control,
+         uint32_t abort_generation,
+         libcerror_error_t **error );
+
+int libqcow_internal_file_get_direct_read_range(
+     libqcow_internal_file_t *internal_file,
+     off64_t offset,
+     size_t size,
+     uint8_t published_lookups_only,
+     off64_t *range_file_offset,
+     size_t *range_size,
+     libcerror_error_t **error );
+
+ssize_t libqcow_internal_file_read_compressed_buffer_at_offset(
+         libqcow_internal_file_t *internal_file,
+         libbfio_handle_t *file_io_handle,
+         uint64_t cluster_block_offset,
+         uint64_t cluster_block_data_offset,
+         uint8_t *buffer,
+         size_t buffer_size,
+         libcerror_error_t **error );
+
+ssize_t libqcow_internal_file_read_encrypted_buffer_at_offset(
+         libqcow_internal_file_t *internal_file,
+         libbfio_handle_t *file_io_handle,
+         off64_t range_file_offset,
+         off64_t offset,
+         uint8_t *buffer,
+         size_t buffer_size,
+         libcerror_error_t **error );
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+
+int libqcow_internal_file_push_read_decode_jobs(
+     libqcow_internal_file_t *internal_file,
+     libqcow_scheduler_batch_t *scheduler_batch,
+     libqcow_decode_job_t **decode_jobs,
+     uint8_t decode_type,
+     off64_t range_file_offset,
+     off64_t offset,
+     uint8_t *buffer,
+     size_t buffer_size,
+     libcerror_error_t **error );
+
+#endif /* defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT ) */
+
+ssize_t libqcow_internal_file_read_ranges_at_offset(
+         libqcow_internal_file_t *internal_file,
+         uint8_t *buffer,
+         size_t buffer_size,
+         off64_t offset,
+         libqcow_read_control_t *read_control,
+         uint32_t abort_generation,
+         libqcow_scheduler_batch_t *scheduler_batch,
+         libqcow_decode_job_t **decode_jobs,
+         libcerror_error_t **error );
+
+ssize_t libqcow_internal_file_read_buffer_at_offset(
+         libqcow_internal_file_t *internal_file,
+         uint8_t *buffer,
+         size_t buffer_size,
+         off64_t offset,
+         libqcow_read_control_t *read_control,
+         uint32_t abort_generation,
          libcerror_error_t **error );
 
 LIBQCOW_EXTERN \
@@ -274,6 +818,59 @@ ssize_t libqcow_file_read_buffer_at_offset(
          off64_t offset,
          libcerror_error_t **error );
 
+LIBQCOW_EXTERN \
+ssize_t libqcow_file_read_buffer_at_offset_concurrent(
+         libqcow_file_t *file,
+         void *buffer,
+         size_t buffer_size,
+         off64_t offset,
+         libcerror_error_t **error );
+
+LIBQCOW_EXTERN \
+ssize_t libqcow_file_read_buffer_at_offset_with_timeout(
+         libqcow_file_t *file,
+         void *buffer,
+         size_t buffer_size,
+         off64_t offset,
+         uint32_t timeout,
+         libcerror_error_t **error );
+
+int libqcow_internal_file_get_data_at_offset(
+     libqcow_internal_file_t *internal_file,
+     off64_t offset,
+     const uint8_t **data,
+     size_t *data_size,
+     libqcow_data_pin_t **data_pin,
+     libcerror_error_t **error );
+
+LIBQCOW_EXTERN \
+int libqcow_file_get_data_at_offset(
+     libqcow_file_t *file,
+     off64_t offset,
+     const uint8_t **data,
+     size_t *data_size,
+     libqcow_data_pin_t **data_pin,
+     libcerror_error_t **error );
+
+LIBQCOW_EXTERN \
+int libqcow_file_read_async(
+     libqcow_file_t *file,
+     void *buffer,
+     size_t buffer_size,
+     off64_t offset,
+     libqcow_read_request_t **read_request,
+     libcerror_error_t **error );
+
+LIBQCOW_EXTERN \
+int libqcow_file_read_async_with_timeout(
+     libqcow_file_t *file,
+     void *buffer,
+     size_t buffer_size,
+     off64_t offset,
+     uint32_t timeout,
+     libqcow_read_request_t **read_request,
+     libcerror_error_t **error );
+
 off64_t libqcow_internal_file_seek_offset(
          libqcow_internal_file_t *internal_file,
          off64_t offset,
@@ -293,12 +890,30 @@ int libqcow_file_get_offset(
      off64_t *offset,
      libcerror_error_t **error );
 
+LIBQCOW_EXTERN \
+int libqcow_file_create_cursor(
+     libqcow_file_t *file,
+     libqcow_cursor_t **cursor,
+     libcerror_error_t **error );
+
 LIBQCOW_EXTERN \
 int libqcow_file_set_parent_file(
      libqcow_file_t *file,
      libqcow_file_t *parent_file,
      libcerror_error_t **error );
 
+LIBQCOW_EXTERN \
+int libqcow_file_set_cache_pool(
+     libqcow_file_t *file,
+     libqcow_cache_pool_t *cache_pool,
+     libcerror_error_t **error );
+
+LIBQCOW_EXTERN \
+int libqcow_file_set_scheduler(
+     libqcow_file_t *file,
+     libqcow_scheduler_t *scheduler,
+     libcerror_error_t **error );
+
 LIBQCOW_EXTERN \
 int libqcow_file_set_keys(
      libqcow_file_t *file,
@@ -364,13 +979,111 @@ int libqcow_file_get_utf16_backing_filename(
      size_t utf16_string_size,
      libcerror_error_t **error );
 
+LIBQCOW_EXTERN \
+int libqcow_file_get_utf8_data_filename_size(
+     libqcow_file_t *file,
+     size_t *utf8_string_size,
+     libcerror_error_t **error );
+
+LIBQCOW_EXTERN \
+int libqcow_file_get_utf8_data_filename(
+     libqcow_file_t *file,
+     uint8_t *utf8_string,
+     size_t utf8_string_size,
+     libcerror_error_t **error );
+
+LIBQCOW_EXTERN \
+int libqcow_file_get_utf16_data_filename_size(
+     libqcow_file_t *file,
+     size_t *utf16_string_size,
+     libcerror_error_t **error );
+
+LIBQCOW_EXTERN \
+int libqcow_file_get_utf16_data_filename(
+     libqcow_file_t *file,
+     uint16_t *utf16_string,
+     size_t utf16_string_size,
+     libcerror_error_t **error );
+
 LIBQCOW_EXTERN \
 int libqcow_file_get_number_of_snapshots(
      libqcow_file_t *file,
      int *number_of_snapshots,
      libcerror_error_t **error );
 
-/* TODO add libqcow_file_get_snapshot_by_index */
+LIBQCOW_EXTERN \
+int libqcow_file_get_snapshot_by_index(
+     libqcow_file_t *file,
+     int snapshot_index,
+     libqcow_snapshot_t **snapshot,
+     libcerror_error_t **error );
+
+int libqcow_internal_file_get_changed_extents(
+     libqcow_internal_file_t *internal_file,
+     libbfio_handle_t *file_io_handle,
+     libqcow_cluster_table_t *first_level1_table,
+     size64_t first_media_size,
+     libqcow_cluster_table_t *second_level1_table,
+     size64_t second_media_size,
+     libqcow_changed_extents_t *changed_extents,
+     uint32_t abort_generation,
+     libcerror_error_t **error );
+
+LIBQCOW_EXTERN \
+int libqcow_file_get_changed_extents(
+     libqcow_file_t *file,
+     libqcow_snapshot_t *first_snapshot,
+     libqcow_snapshot_t *second_snapshot,
+     libqcow_changed_extents_t **changed_extents,
+     libcerror_error_t **error );
+
+int libqcow_internal_file_export(
+     libqcow_internal_file_t *internal_file,
+     libqcow_export_writer_t *export_writer,
+     libcerror_error_t **error );
+
+LIBQCOW_EXTERN \
+int libqcow_file_export(
+     libqcow_file_t *file,
+     const char *filename,
+     int export_format,
+     libcerror_error_t **error );
+
+#if defined( HAVE_WIDE_CHARACTER_TYPE )
+
+LIBQCOW_EXTERN \
+int libqcow_file_export_wide(
+     libqcow_file_t *file,
+     const wchar_t *filename,
+     int export_format,
+     libcerror_error_t **error );
+
+#endif /* defined( HAVE_WIDE_CHARACTER_TYPE ) */
+
+LIBQCOW_EXTERN \
+int libqcow_file_export_file_io_handle(
+     libqcow_file_t *file,
+     libbfio_handle_t *file_io_handle,
+     int export_format,
+     libcerror_error_t **error );
+
+int libqcow_internal_file_scan(
+     libqcow_internal_file_t *internal_file,
+     libqcow_scanner_t *scanner,
+     libcerror_error_t **error );
+
+LIBQCOW_EXTERN \
+int libqcow_file_scan(
+     libqcow_file_t *file,
+     int (*callback_function)(
+            off64_t offset,
+            const uint8_t *data,
+            size_t data_size,
+            void *callback_data ),
+     void *callback_data,
+     int number_of_threads,
+     uint8_t scan_flags,
+     libcerror_error_t **error );
 
 #if defined( __cplusplus )
 }
@@ -25,6 +25,7 @@
 #include <types.h>
 
 #include "libqcow_debug.h"
+#include "libqcow_definitions.h"
 #include "libqcow_file_header.h"
 #include "libqcow_io_handle.h"
 #include "libqcow_libcerror.h"
@@ -127,6 +128,11 @@ int libqcow_file_header_free(
 	}
 	if( *file_header != NULL )
 	{
+		if( ( *file_header )->data_filename != NULL )
+		{
+			memory_free(
+			 ( *file_header )->data_filename );
+		}
 		memory_free(
 		 *file_header );
 
@@ -146,6 +152,7 @@ int libqcow_file_header_read_data(
 {
 	static char *function               = "libqcow_file_header_read_data";
 	size_t file_header_data_size        = 0;
+	uint64_t auto_clear_feature_flags   = 0;
 	uint64_t compatible_feature_flags   = 0;
 	uint64_t incompatible_feature_flags = 0;
 	uint64_t safe_level1_table_offset   = 0;
@@ -480,6 +487,10 @@ int libqcow_file_header_read_data(
 		 ( (qcow_file_header_v3_t *) data )->compatible_feature_flags,
 		 compatible_feature_flags );
 
+		byte_stream_copy_to_uint64_big_endian(
+		 ( (qcow_file_header_v3_t *) data )->auto_clear_feature_flags,
+		 auto_clear_feature_flags );
+
 		byte_stream_copy_to_uint32_big_endian(
 		 ( (qcow_file_header_v3_t *) data )->header_size,
 		 file_header_size );
@@ -497,13 +508,10 @@ int libqcow_file_header_read_data(
 			 function,
 			 compatible_feature_flags );
 
-			byte_stream_copy_to_uint64_big_endian(
-			 ( (qcow_file_header_v3_t *) data )->auto_clear_feature_flags,
-			 value_64bit );
 			libcnotify_printf(
 			 "%s: auto-clear feature flags\t\t\t: 0x%08" PRIx64 "\n",
 			 function,
-			 value_64bit );
+			 auto_clear_feature_flags );
 
 			byte_stream_copy_to_uint32_big_endian(
 			 ( (qcow_file_header_v3_t *) data )->reference_count_order,
@@ -536,7 +544,9 @@ int libqcow_file_header_read_data(
 		}
 #endif /* defined( HAVE_DEBUG_OUTPUT ) */
 
-		supported_feature_flags = 0x00000001UL;
+		supported_feature_flags = LIBQCOW_INCOMPATIBLE_FEATURE_FLAG_DIRTY
+		                        | LIBQCOW_INCOMPATIBLE_FEATURE_FLAG_EXTERNAL_DATA_FILE
+		                        | LIBQCOW_INCOMPATIBLE_FEATURE_FLAG_EXTENDED_LEVEL2_ENTRIES;
 
 		if( ( incompatible_feature_flags & ~( supported_feature_flags ) ) != 0 )
 		{
@@ -589,10 +599,230 @@ int libqcow_file_header_read_data(
 		}
 	}
 #endif
-	file_header->level1_table_offset = (off64_t) safe_level1_table_offset;
-	file_header->snapshots_offset    = (off64_t) safe_snapshots_offset;
+	file_header->level1_table_offset        = (off64_t) safe_level1_table_offset;
+	file_header->snapshots_offset           = (off64_t) safe_snapshots_offset;
+	file_header->incompatible_feature_flags = incompatible_feature_flags;
+	file_header->file_header_size           = file_header_size;
+
+	/* The data file raw flag is only valid for an external data file
+	 */
+	if( ( incompatible_feature_flags & LIBQCOW_INCOMPATIBLE_FEATURE_FLAG_EXTERNAL_DATA_FILE ) != 0 )
+	{
+		file_header->auto_clear_feature_flags = auto_clear_feature_flags;
+	}
+	return( 1 );
+}
+
+/* Reads the file header extensions
+ * The extensions are stored after the (version 3) file header and
+ * within the first cluster block
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_file_header_read_extensions_file_io_handle(
+     libqcow_file_header_t *file_header,
+     libbfio_handle_t *file_io_handle,
+     libcerror_error_t **error )
+{
+	uint8_t extension_header_data[ sizeof( qcow_file_header_extension_t ) ];
+
+	static char *function     = "libqcow_file_header_read_extensions_file_io_handle";
+	size64_t cluster_size     = 0;
+	ssize_t read_count        = 0;
+	off64_t extension_offset  = 0;
+	uint32_t extension_size   = 0;
+	uint32_t extension_type   = 0;
+
+	if( file_header == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file header.",
+		 function );
+
+		return( -1 );
+	}
+	if( file_header->data_filename != NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_ALREADY_SET,
+		 "%s: invalid file header - data filename value already set.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( file_header->number_of_cluster_block_bits <= 8 )
+	 || ( file_header->number_of_cluster_block_bits > 63 ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid file header - number of cluster block bits value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	cluster_size     = (size64_t) 1 << file_header->number_of_cluster_block_bits;
+	extension_offset = (off64_t) file_header->file_header_size;
+
+	while( (size64_t) ( extension_offset + sizeof( qcow_file_header_extension_t ) ) <= cluster_size )
+	{
+#if defined( HAVE_DEBUG_OUTPUT )
+		if( libcnotify_verbose != 0 )
+		{
+			libcnotify_printf(
+			 "%s: reading file header extension at offset: %" PRIi64 " (0x%08" PRIx64 ")\n",
+			 function,
+			 extension_offset,
+			 extension_offset );
+		}
+#endif
+		read_count = libbfio_handle_read_buffer_at_offset(
+		              file_io_handle,
+		              extension_header_data,
+		              sizeof( qcow_file_header_extension_t ),
+		              extension_offset,
+		              error );
+
+		if( read_count != (ssize_t) sizeof( qcow_file_header_extension_t ) )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_IO,
+			 LIBCERROR_IO_ERROR_READ_FAILED,
+			 "%s: unable to read file header extension at offset: %" PRIi64 " (0x%08" PRIx64 ").",
+			 function,
+			 extension_offset,
+			 extension_offset );
+
+			goto on_error;
+		}
+		byte_stream_copy_to_uint32_big_endian(
+		 ( (qcow_file_header_extension_t *) extension_header_data )->extension_type,
+		 extension_type );
+
+		byte_stream_copy_to_uint32_big_endian(
+		 ( (qcow_file_header_extension_t *) extension_header_data )->data_size,
+		 extension_size );
 
+#if defined( HAVE_DEBUG_OUTPUT )
+		if( libcnotify_verbose != 0 )
+		{
+			libcnotify_printf(
+			 "%s: extension type\t\t\t\t: 0x%08" PRIx32 "\n",
+			 function,
+			 extension_type );
+
+			libcnotify_printf(
+			 "%s: extension data size\t\t\t: %" PRIu32 "\n",
+			 function,
+			 extension_size );
+
+			libcnotify_printf(
+			 "\n" );
+		}
+#endif
+		if( extension_type == LIBQCOW_FILE_HEADER_EXTENSION_TYPE_END_OF_EXTENSIONS )
+		{
+			break;
+		}
+		extension_offset += sizeof( qcow_file_header_extension_t );
+
+		if( (size64_t) extension_size > ( cluster_size - extension_offset ) )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+			 "%s: invalid file header extension data size value out of bounds.",
+			 function );
+
+			goto on_error;
+		}
+		if( ( extension_type == LIBQCOW_FILE_HEADER_EXTENSION_TYPE_EXTERNAL_DATA_FILE )
+		 && ( extension_size > 0 ) )
+		{
+			if( file_header->data_filename != NULL )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_VALUE_ALREADY_SET,
+				 "%s: invalid file header - multiple external data file extensions.",
+				 function );
+
+				goto on_error;
+			}
+			file_header->data_filename = (uint8_t *) memory_allocate(
+			                                          sizeof( uint8_t ) * extension_size );
+
+			if( file_header->data_filename == NULL )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_MEMORY,
+				 LIBCERROR_MEMORY_ERROR_INSUFFICIENT,
+				 "%s: unable to create data filename.",
+				 function );
+
+				goto on_error;
+			}
+			file_header->data_filename_size = (size_t) extension_size;
+
+			read_count = libbfio_handle_read_buffer_at_offset(
+			              file_io_handle,
+			              file_header->data_filename,
+			              (size_t) extension_size,
+			              extension_offset,
+			              error );
+
+			if( read_count != (ssize_t) extension_size )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_IO,
+				 LIBCERROR_IO_ERROR_READ_FAILED,
+				 "%s: unable to read data filename at offset: %" PRIi64 " (0x%08" PRIx64 ").",
+				 function,
+				 extension_offset,
+				 extension_offset );
+
+				goto on_error;
+			}
+#if defined( HAVE_DEBUG_OUTPUT )
+			if( libcnotify_verbose != 0 )
+			{
+				libcnotify_printf(
+				 "%s: data filename:\n",
+				 function );
+				libcnotify_print_data(
+				 file_header->data_filename,
+				 file_header->data_filename_size,
+				 0 );
+			}
+#endif
+		}
+		/* The extension data is padded to a multiple of 8 bytes
+		 */
+		extension_offset += ( (off64_t) extension_size + 7 ) & ~( (off64_t) 7 );
+	}
 	return( 1 );
+
+on_error:
+	if( file_header->data_filename != NULL )
+	{
+		memory_free(
+		 file_header->data_filename );
+
+		file_header->data_filename = NULL;
+	}
+	file_header->data_filename_size = 0;
+
+	return( -1 );
 }
 
 /* Reads the file header
@@ -660,6 +890,23 @@ int libqcow_file_header_read_file_io_handle(
 
 		return( -1 );
 	}
+	if( file_header->format_version == 3 )
+	{
+		if( libqcow_file_header_read_extensions_file_io_handle(
+		     file_header,
+		     file_io_handle,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_IO,
+			 LIBCERROR_IO_ERROR_READ_FAILED,
+			 "%s: unable to read file header extensions.",
+			 function );
+
+			return( -1 );
+		}
+	}
 	return( 1 );
 }
 
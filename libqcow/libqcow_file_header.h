@@ -79,6 +79,26 @@ struct libqcow_file_header
 	/* The snapshots offset
  	 */
 	off64_t snapshots_offset;
+
+	/* The incompatible feature flags
+ 	 */
+	uint64_t incompatible_feature_flags;
+
+	/* The auto-clear feature flags
+ 	 */
+	uint64_t auto_clear_feature_flags;
+
+	/* The file header size
+ 	 */
+	uint32_t file_header_size;
+
+	/* The external data filename
+	 */
+	uint8_t *data_filename;
+
+	/* The external data filename size
+	 */
+	size_t data_filename_size;
 };
 
 int libqcow_file_header_initialize(
@@ -95,6 +115,11 @@ int libqcow_file_header_read_data(
      size_t data_size,
      libcerror_error_t **error );
 
+int libqcow_file_header_read_extensions_file_io_handle(
+     libqcow_file_header_t *file_header,
+     libbfio_handle_t *file_io_handle,
+     libcerror_error_t **error );
+
 int libqcow_file_header_read_file_io_handle(
      libqcow_file_header_t *file_header,
      libbfio_handle_t *file_io_handle,
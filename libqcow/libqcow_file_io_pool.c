@@ -0,0 +1,708 @@
+/*
+ * File IO pool functions
+ *
+ * Copyright (C) 2010-2026, Joachim Metz <joachim.metz@gmail.com>
+ *
+ * Refer to AUTHORS for acknowledgements.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <common.h>
+#include <memory.h>
+#include <types.h>
+
+#include "libqcow_file_io_pool.h"
+#include "libqcow_libbfio.h"
+#include "libqcow_libcerror.h"
+#include "libqcow_libcnotify.h"
+#include "libqcow_libcthreads.h"
+
+/* Creates a file IO pool
+ * The file IO pool contains clones of the file IO handle, each with its own offset,
+ * so that multiple threads can read from the same file at the same time
+ * Make sure the value file_io_pool is referencing, is set to NULL
+ * Returns 1 if successful, 0 if the file IO handle cannot be cloned or -1 on error
+ */
+int libqcow_file_io_pool_initialize(
+     libqcow_file_io_pool_t **file_io_pool,
+     libbfio_handle_t *file_io_handle,
+     int maximum_number_of_handles,
+     libcerror_error_t **error )
+{
+	libbfio_handle_t *handle       = NULL;
+	libcerror_error_t *clone_error = NULL;
+	static char *function          = "libqcow_file_io_pool_initialize";
+	int result                     = 0;
+
+	if( file_io_pool == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file IO pool.",
+		 function );
+
+		return( -1 );
+	}
+	if( *file_io_pool != NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_ALREADY_SET,
+		 "%s: invalid file IO pool value already set.",
+		 function );
+
+		return( -1 );
+	}
+	if( file_io_handle == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file IO handle.",
+		 function );
+
+		return( -1 );
+	}
+	if( maximum_number_of_handles <= 0 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_ZERO_OR_LESS,
+		 "%s: invalid maximum number of handles value zero or less.",
+		 function );
+
+		return( -1 );
+	}
+	*file_io_pool = memory_allocate_structure(
+	                 libqcow_file_io_pool_t );
+
+	if( *file_io_pool == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_INSUFFICIENT,
+		 "%s: unable to create file IO pool.",
+		 function );
+
+		goto on_error;
+	}
+	if( memory_set(
+	     *file_io_pool,
+	     0,
+	     sizeof( libqcow_file_io_pool_t ) ) == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_SET_FAILED,
+		 "%s: unable to clear file IO pool.",
+		 function );
+
+		memory_free(
+		 *file_io_pool );
+
+		*file_io_pool = NULL;
+
+		return( -1 );
+	}
+	( *file_io_pool )->handles = (libbfio_handle_t **) memory_allocate(
+	                                                    sizeof( libbfio_handle_t * ) * maximum_number_of_handles );
+
+	if( ( *file_io_pool )->handles == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_INSUFFICIENT,
+		 "%s: unable to create handles.",
+		 function );
+
+		goto on_error;
+	}
+	( *file_io_pool )->available_handles = (libbfio_handle_t **) memory_allocate(
+	                                                              sizeof( libbfio_handle_t * ) * maximum_number_of_handles );
+
+	if( ( *file_io_pool )->available_handles == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_INSUFFICIENT,
+		 "%s: unable to create available handles.",
+		 function );
+
+		goto on_error;
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_mutex_initialize(
+	     &( ( *file_io_pool )->mutex ),
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+		 "%s: unable to initialize mutex.",
+		 function );
+
+		goto on_error;
+	}
+	if( libcthreads_condition_initialize(
+	     &( ( *file_io_pool )->condition ),
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+		 "%s: unable to initialize condition.",
+		 function );
+
+		goto on_error;
+	}
+#endif
+	( *file_io_pool )->file_io_handle            = file_io_handle;
+	( *file_io_pool )->maximum_number_of_handles = maximum_number_of_handles;
+
+	/* Not every type of file IO handle can be cloned, hence the first handle
+	 * is cloned on creation and a failure is not considered an error
+	 */
+	result = libqcow_file_io_pool_clone_handle(
+	          *file_io_pool,
+	          &handle,
+	          &clone_error );
+
+	if( result != 1 )
+	{
+#if defined( HAVE_DEBUG_OUTPUT )
+		if( libcnotify_verbose != 0 )
+		{
+			libcnotify_printf(
+			 "%s: file IO handle cannot be cloned.\n",
+			 function );
+		}
+#endif
+		libcerror_error_free(
+		 &clone_error );
+
+		if( libqcow_file_io_pool_free(
+		     file_io_pool,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+			 "%s: unable to free file IO pool.",
+			 function );
+
+			return( -1 );
+		}
+		return( 0 );
+	}
+	( *file_io_pool )->handles[ 0 ]                = handle;
+	( *file_io_pool )->number_of_handles           = 1;
+	( *file_io_pool )->available_handles[ 0 ]      = handle;
+	( *file_io_pool )->number_of_available_handles = 1;
+
+	return( 1 );
+
+on_error:
+	if( *file_io_pool != NULL )
+	{
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+		if( ( *file_io_pool )->mutex != NULL )
+		{
+			libcthreads_mutex_free(
+			 &( ( *file_io_pool )->mutex ),
+			 NULL );
+		}
+#endif
+		if( ( *file_io_pool )->available_handles != NULL )
+		{
+			memory_free(
+			 ( *file_io_pool )->available_handles );
+		}
+		if( ( *file_io_pool )->handles != NULL )
+		{
+			memory_free(
+			 ( *file_io_pool )->handles );
+		}
+		memory_free(
+		 *file_io_pool );
+
+		*file_io_pool = NULL;
+	}
+	return( -1 );
+}
+
+/* Frees a file IO pool
+ * The cloned file IO handles are closed, the file IO handle they are cloned from is not
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_file_io_pool_free(
+     libqcow_file_io_pool_t **file_io_pool,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_file_io_pool_free";
+	int handle_index      = 0;
+	int result            = 1;
+
+	if( file_io_pool == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file IO pool.",
+		 function );
+
+		return( -1 );
+	}
+	if( *file_io_pool != NULL )
+	{
+		for( handle_index = 0;
+		     handle_index < ( *file_io_pool )->number_of_handles;
+		     handle_index++ )
+		{
+			if( libbfio_handle_close(
+			     ( *file_io_pool )->handles[ handle_index ],
+			     error ) != 0 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_IO,
+				 LIBCERROR_IO_ERROR_CLOSE_FAILED,
+				 "%s: unable to close handle: %d.",
+				 function,
+				 handle_index );
+
+				result = -1;
+			}
+			if( libbfio_handle_free(
+			     &( ( *file_io_pool )->handles[ handle_index ] ),
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+				 "%s: unable to free handle: %d.",
+				 function,
+				 handle_index );
+
+				result = -1;
+			}
+		}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+		if( ( *file_io_pool )->condition != NULL )
+		{
+			if( libcthreads_condition_free(
+			     &( ( *file_io_pool )->condition ),
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+				 "%s: unable to free condition.",
+				 function );
+
+				result = -1;
+			}
+		}
+		if( ( *file_io_pool )->mutex != NULL )
+		{
+			if( libcthreads_mutex_free(
+			     &( ( *file_io_pool )->mutex ),
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+				 "%s: unable to free mutex.",
+				 function );
+
+				result = -1;
+			}
+		}
+#endif
+		memory_free(
+		 ( *file_io_pool )->available_handles );
+
+		memory_free(
+		 ( *file_io_pool )->handles );
+
+		memory_free(
+		 *file_io_pool );
+
+		*file_io_pool = NULL;
+	}
+	return( result );
+}
+
+/* Clones the file IO handle and opens the clone for reading
+ * This function is not multi-thread safe acquire the mutex before call
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_file_io_pool_clone_handle(
+     libqcow_file_io_pool_t *file_io_pool,
+     libbfio_handle_t **handle,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_file_io_pool_clone_handle";
+	int result            = 0;
+
+	if( file_io_pool == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file IO pool.",
+		 function );
+
+		return( -1 );
+	}
+	if( handle == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid handle.",
+		 function );
+
+		return( -1 );
+	}
+	if( libbfio_handle_clone(
+	     handle,
+	     file_io_pool->file_io_handle,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+		 "%s: unable to clone file IO handle.",
+		 function );
+
+		goto on_error;
+	}
+	if( *handle == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: missing handle.",
+		 function );
+
+		goto on_error;
+	}
+	result = libbfio_handle_is_open(
+	          *handle,
+	          error );
+
+	if( result == -1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_IO,
+		 LIBCERROR_IO_ERROR_OPEN_FAILED,
+		 "%s: unable to determine if handle is open.",
+		 function );
+
+		goto on_error;
+	}
+	else if( result == 0 )
+	{
+		if( libbfio_handle_open(
+		     *handle,
+		     LIBBFIO_ACCESS_FLAG_READ,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_IO,
+			 LIBCERROR_IO_ERROR_OPEN_FAILED,
+			 "%s: unable to open handle.",
+			 function );
+
+			goto on_error;
+		}
+	}
+	return( 1 );
+
+on_error:
+	if( *handle != NULL )
+	{
+		libbfio_handle_free(
+		 handle,
+		 NULL );
+	}
+	return( -1 );
+}
+
+/* Grabs a file IO handle that is not in use by another thread
+ * A file IO handle is cloned when all handles are in use and the maximum
+ * number of handles has not been reached, otherwise the function waits
+ * for a handle to be released
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_file_io_pool_grab_handle(
+     libqcow_file_io_pool_t *file_io_pool,
+     libbfio_handle_t **handle,
+     libcerror_error_t **error )
+{
+	libbfio_handle_t *safe_handle = NULL;
+	static char *function         = "libqcow_file_io_pool_grab_handle";
+	int result                    = 1;
+
+	if( file_io_pool == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file IO pool.",
+		 function );
+
+		return( -1 );
+	}
+	if( handle == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid handle.",
+		 function );
+
+		return( -1 );
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_mutex_grab(
+	     file_io_pool->mutex,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab mutex.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	while( file_io_pool->number_of_available_handles == 0 )
+	{
+		if( file_io_pool->number_of_handles < file_io_pool->maximum_number_of_handles )
+		{
+			if( libqcow_file_io_pool_clone_handle(
+			     file_io_pool,
+			     &safe_handle,
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+				 "%s: unable to clone handle.",
+				 function );
+
+				result = -1;
+			}
+			else
+			{
+				file_io_pool->handles[ file_io_pool->number_of_handles ] = safe_handle;
+
+				file_io_pool->number_of_handles += 1;
+			}
+			break;
+		}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+		if( libcthreads_condition_wait(
+		     file_io_pool->condition,
+		     file_io_pool->mutex,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+			 "%s: unable to wait for condition.",
+			 function );
+
+			result = -1;
+
+			break;
+		}
+#else
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid file IO pool - no handles available.",
+		 function );
+
+		result = -1;
+
+		break;
+#endif
+	}
+	if( ( result == 1 )
+	 && ( safe_handle == NULL ) )
+	{
+		file_io_pool->number_of_available_handles -= 1;
+
+		safe_handle = file_io_pool->available_handles[ file_io_pool->number_of_available_handles ];
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_mutex_release(
+	     file_io_pool->mutex,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release mutex.",
+		 function );
+
+		result = -1;
+	}
+#endif
+	if( result == 1 )
+	{
+		*handle = safe_handle;
+	}
+	else if( safe_handle != NULL )
+	{
+		libqcow_file_io_pool_release_handle(
+		 file_io_pool,
+		 safe_handle,
+		 NULL );
+	}
+	return( result );
+}
+
+/* Releases a file IO handle that was grabbed from the file IO pool
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_file_io_pool_release_handle(
+     libqcow_file_io_pool_t *file_io_pool,
+     libbfio_handle_t *handle,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_file_io_pool_release_handle";
+	int result            = 1;
+
+	if( file_io_pool == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file IO pool.",
+		 function );
+
+		return( -1 );
+	}
+	if( handle == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid handle.",
+		 function );
+
+		return( -1 );
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_mutex_grab(
+	     file_io_pool->mutex,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab mutex.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	if( file_io_pool->number_of_available_handles >= file_io_pool->number_of_handles )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid file IO pool - number of available handles value out of bounds.",
+		 function );
+
+		result = -1;
+	}
+	else
+	{
+		file_io_pool->available_handles[ file_io_pool->number_of_available_handles ] = handle;
+
+		file_io_pool->number_of_available_handles += 1;
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+		if( libcthreads_condition_signal(
+		     file_io_pool->condition,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+			 "%s: unable to signal condition.",
+			 function );
+
+			result = -1;
+		}
+#endif
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_mutex_release(
+	     file_io_pool->mutex,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release mutex.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	return( result );
+}
+
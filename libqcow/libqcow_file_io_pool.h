@@ -0,0 +1,105 @@
+/*
+ * File IO pool functions
+ *
+ * Copyright (C) 2010-2026, Joachim Metz <joachim.metz@gmail.com>
+ *
+ * Refer to AUTHORS for acknowledgements.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#if !defined( _LIBQCOW_FILE_IO_POOL_H )
+#define _LIBQCOW_FILE_IO_POOL_H
+
+#include <common.h>
+#include <types.h>
+
+#include "libqcow_libbfio.h"
+#include "libqcow_libcerror.h"
+#include "libqcow_libcthreads.h"
+
+#if defined( __cplusplus )
+extern "C" {
+#endif
+
+typedef struct libqcow_file_io_pool libqcow_file_io_pool_t;
+
+struct libqcow_file_io_pool
+{
+	/* The file IO handle the handles are cloned from
+	 */
+	libbfio_handle_t *file_io_handle;
+
+	/* The cloned file IO handles
+	 */
+	libbfio_handle_t **handles;
+
+	/* The number of cloned file IO handles
+	 */
+	int number_of_handles;
+
+	/* The maximum number of cloned file IO handles
+	 */
+	int maximum_number_of_handles;
+
+	/* The cloned file IO handles that are not in use
+	 */
+	libbfio_handle_t **available_handles;
+
+	/* The number of cloned file IO handles that are not in use
+	 */
+	int number_of_available_handles;
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	/* The mutex that protects the handles
+	 */
+	libcthreads_mutex_t *mutex;
+
+	/* The condition that is signalled when a handle is released
+	 */
+	libcthreads_condition_t *condition;
+#endif
+};
+
+int libqcow_file_io_pool_initialize(
+     libqcow_file_io_pool_t **file_io_pool,
+     libbfio_handle_t *file_io_handle,
+     int maximum_number_of_handles,
+     libcerror_error_t **error );
+
+int libqcow_file_io_pool_free(
+     libqcow_file_io_pool_t **file_io_pool,
+     libcerror_error_t **error );
+
+int libqcow_file_io_pool_clone_handle(
+     libqcow_file_io_pool_t *file_io_pool,
+     libbfio_handle_t **handle,
+     libcerror_error_t **error );
+
+int libqcow_file_io_pool_grab_handle(
+     libqcow_file_io_pool_t *file_io_pool,
+     libbfio_handle_t **handle,
+     libcerror_error_t **error );
+
+int libqcow_file_io_pool_release_handle(
+     libqcow_file_io_pool_t *file_io_pool,
+     libbfio_handle_t *handle,
+     libcerror_error_t **error );
+
+#if defined( __cplusplus )
+}
+#endif
+
+#endif /* !defined( _LIBQCOW_FILE_IO_POOL_H ) */
+
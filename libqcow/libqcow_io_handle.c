@@ -33,6 +33,7 @@
 #include "libqcow_libcerror.h"
 #include "libqcow_libcnotify.h"
 #include "libqcow_libfdata.h"
+#include "libqcow_mapped_file.h"
 #include "libqcow_unused.h"
 
 #include "qcow_file_header.h"
@@ -195,10 +196,12 @@ int libqcow_io_handle_clear(
 
 /* Reads a level 2 table
  * Callback function for the level 2 table vector
+ * The level 2 table vector and cache of a file are only used with the read/write lock
+ * of the file grabbed, hence concurrent misses on the same level 2 table are read once
  * Returns 1 if successful or -1 on error
  */
 int libqcow_io_handle_read_level2_table(
-     intptr_t *data_handle LIBQCOW_ATTRIBUTE_UNUSED,
+     libqcow_io_handle_t *io_handle,
      libbfio_handle_t *file_io_handle,
      libfdata_vector_t *vector,
      libfdata_cache_t *cache,
@@ -212,8 +215,8 @@ int libqcow_io_handle_read_level2_table(
 {
 	libqcow_cluster_table_t *level2_table = NULL;
 	static char *function                 = "libqcow_io_handle_read_level2_table";
+	size_t entry_size                     = 8;
 
-	LIBQCOW_UNREFERENCED_PARAMETER( data_handle );
 	LIBQCOW_UNREFERENCED_PARAMETER( element_data_file_index );
 	LIBQCOW_UNREFERENCED_PARAMETER( element_data_flags );
 	LIBQCOW_UNREFERENCED_PARAMETER( read_flags );
@@ -229,6 +232,11 @@ int libqcow_io_handle_read_level2_table(
 
 		return( -1 );
 	}
+	if( ( io_handle != NULL )
+	 && ( io_handle->has_extended_level2_entries != 0 ) )
+	{
+		entry_size = 16;
+	}
 	if( libqcow_cluster_table_initialize(
 	     &level2_table,
 	     error ) != 1 )
@@ -247,6 +255,7 @@ int libqcow_io_handle_read_level2_table(
 	     file_io_handle,
 	     element_data_offset,
 	     (size_t) element_data_size,
+	     entry_size,
 	     error ) != 1 )
 	{
 		libcerror_error_set(
@@ -294,7 +303,7 @@ on_error:
  * Returns 1 if successful or -1 on error
  */
 int libqcow_io_handle_read_cluster_block(
-     intptr_t *data_handle LIBQCOW_ATTRIBUTE_UNUSED,
+     libqcow_io_handle_t *io_handle,
      libbfio_handle_t *file_io_handle,
      libfdata_vector_t *vector,
      libfdata_cache_t *cache,
@@ -307,9 +316,10 @@ int libqcow_io_handle_read_cluster_block(
      libcerror_error_t **error )
 {
 	libqcow_cluster_block_t *cluster_block = NULL;
+	uint8_t *mapped_data                   = NULL;
 	static char *function                  = "libqcow_io_handle_read_cluster_block";
+	int result                             = 0;
 
-	LIBQCOW_UNREFERENCED_PARAMETER( data_handle );
 	LIBQCOW_UNREFERENCED_PARAMETER( element_data_file_index );
 	LIBQCOW_UNREFERENCED_PARAMETER( element_data_flags );
 	LIBQCOW_UNREFERENCED_PARAMETER( read_flags );
@@ -325,34 +335,80 @@ int libqcow_io_handle_read_cluster_block(
 
 		goto on_error;
 	}
-	if( libqcow_cluster_block_initialize(
-	     &cluster_block,
-	     (size_t) element_data_size,
-	     error ) != 1 )
+	if( ( io_handle != NULL )
+	 && ( io_handle->mapped_file != NULL ) )
 	{
-		libcerror_error_set(
-		 error,
-		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
-		 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
-		 "%s: unable to create cluster block.",
-		 function );
+		result = libqcow_mapped_file_get_data(
+		          io_handle->mapped_file,
+		          element_data_offset,
+		          element_data_size,
+		          &mapped_data,
+		          error );
+
+		if( result == -1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+			 "%s: unable to retrieve cluster block data from mapped file.",
+			 function );
 
-		goto on_error;
+			goto on_error;
+		}
 	}
-	if( libqcow_cluster_block_read(
-	     cluster_block,
-	     file_io_handle,
-             element_data_offset,
-	     error ) != 1 )
+	if( result != 0 )
 	{
-		libcerror_error_set(
-		 error,
-		 LIBCERROR_ERROR_DOMAIN_IO,
-		 LIBCERROR_IO_ERROR_READ_FAILED,
-		 "%s: unable to read cluster block.",
-		 function );
+		/* The cluster block references the memory mapped file,
+		 * the data is read from the file on first access
+		 */
+		if( libqcow_cluster_block_initialize_mapped(
+		     &cluster_block,
+		     mapped_data,
+		     (size_t) element_data_size,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+			 "%s: unable to create cluster block.",
+			 function );
 
-		goto on_error;
+			goto on_error;
+		}
+	}
+	else
+	{
+		if( libqcow_cluster_block_initialize(
+		     &cluster_block,
+		     (size_t) element_data_size,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+			 "%s: unable to create cluster block.",
+			 function );
+
+			goto on_error;
+		}
+		if( libqcow_cluster_block_read(
+		     cluster_block,
+		     file_io_handle,
+		     element_data_offset,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_IO,
+			 LIBCERROR_IO_ERROR_READ_FAILED,
+			 "%s: unable to read cluster block.",
+			 function );
+
+			goto on_error;
+		}
 	}
 	if( libfdata_vector_set_element_value_by_index(
 	     vector,
@@ -28,6 +28,7 @@
 #include "libqcow_libbfio.h"
 #include "libqcow_libcerror.h"
 #include "libqcow_libfdata.h"
+#include "libqcow_mapped_file.h"
 
 #if defined( __cplusplus )
 extern "C" {
@@ -39,9 +40,14 @@ typedef struct libqcow_io_handle libqcow_io_handle_t;
 
 struct libqcow_io_handle
 {
-	/* Value to indicate if abort was signalled
+	/* The memory mapped file, not owned by the IO handle
+	 * Only set if the cluster blocks can be served from the memory mapped file
 	 */
-	int abort;
+	libqcow_mapped_file_t *mapped_file;
+
+	/* Value to indicate the level 2 table entries are extended with subcluster allocation bitmaps
+	 */
+	uint8_t has_extended_level2_entries;
 };
 
 int libqcow_io_handle_initialize(
@@ -57,7 +63,7 @@ int libqcow_io_handle_clear(
      libcerror_error_t **error );
 
 int libqcow_io_handle_read_level2_table(
-     intptr_t *data_handle,
+     libqcow_io_handle_t *io_handle,
      libbfio_handle_t *file_io_handle,
      libfdata_vector_t *vector,
      libfdata_cache_t *cache,
@@ -70,7 +76,7 @@ int libqcow_io_handle_read_level2_table(
      libcerror_error_t **error );
 
 int libqcow_io_handle_read_cluster_block(
-     intptr_t *data_handle,
+     libqcow_io_handle_t *io_handle,
      libbfio_handle_t *file_io_handle,
      libfdata_vector_t *vector,
      libfdata_cache_t *cache,
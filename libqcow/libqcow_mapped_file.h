@@ -0,0 +1,76 @@
+/*
+ * Memory mapped file functions
+ *
+ * Copyright (C) 2010-2026, Joachim Metz <joachim.metz@gmail.com>
+ *
+ * Refer to AUTHORS for acknowledgements.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#if !defined( _LIBQCOW_MAPPED_FILE_H )
+#define _LIBQCOW_MAPPED_FILE_H
+
+#include <common.h>
+#include <types.h>
+
+#include "libqcow_libcerror.h"
+
+#if defined( __cplusplus )
+extern "C" {
+#endif
+
+#if defined( HAVE_MMAP ) && defined( HAVE_MUNMAP ) && defined( HAVE_SYS_MMAN_H ) && defined( HAVE_FCNTL_H ) && defined( HAVE_UNISTD_H ) && !defined( WINAPI )
+#define HAVE_LIBQCOW_MMAP_SUPPORT
+#endif
+
+typedef struct libqcow_mapped_file libqcow_mapped_file_t;
+
+struct libqcow_mapped_file
+{
+	/* The (memory mapped) data
+	 */
+	uint8_t *data;
+
+	/* The data size
+	 */
+	size64_t data_size;
+};
+
+int libqcow_mapped_file_initialize(
+     libqcow_mapped_file_t **mapped_file,
+     libcerror_error_t **error );
+
+int libqcow_mapped_file_free(
+     libqcow_mapped_file_t **mapped_file,
+     libcerror_error_t **error );
+
+int libqcow_mapped_file_open(
+     libqcow_mapped_file_t *mapped_file,
+     const char *filename,
+     libcerror_error_t **error );
+
+int libqcow_mapped_file_get_data(
+     libqcow_mapped_file_t *mapped_file,
+     off64_t offset,
+     size64_t size,
+     uint8_t **data,
+     libcerror_error_t **error );
+
+#if defined( __cplusplus )
+}
+#endif
+
+#endif /* !defined( _LIBQCOW_MAPPED_FILE_H ) */
+
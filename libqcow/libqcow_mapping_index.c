@@ -0,0 +1,1347 @@
+/*
+ * Mapping index (sidecar) file functions
+ *
+ * Copyright (C) 2010-2026, Joachim Metz <joachim.metz@gmail.com>
+ *
+ * Refer to AUTHORS for acknowledgements.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <common.h>
+#include <byte_stream.h>
+#include <file_stream.h>
+#include <memory.h>
+#include <narrow_string.h>
+#include <types.h>
+
+#if defined( HAVE_SYS_STAT_H )
+#include <sys/stat.h>
+#endif
+
+#if defined( HAVE_FCNTL_H )
+#include <fcntl.h>
+#endif
+
+#if defined( HAVE_UNISTD_H )
+#include <unistd.h>
+#endif
+
+#if defined( HAVE_SYS_MMAN_H )
+#include <sys/mman.h>
+#endif
+
+#include "libqcow_definitions.h"
+#include "libqcow_extent_index.h"
+#include "libqcow_libbfio.h"
+#include "libqcow_libcerror.h"
+#include "libqcow_libcnotify.h"
+#include "libqcow_mapping_index.h"
+
+#include "qcow_mapping_index.h"
+
+const uint8_t qcow_mapping_index_signature[ 8 ] = { 'L', 'Q', 'C', 'O', 'W', 'I', 'D', 'X' };
+
+/* Creates a mapping index
+ * Make sure the value mapping_index is referencing, is set to NULL
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_mapping_index_initialize(
+     libqcow_mapping_index_t **mapping_index,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_mapping_index_initialize";
+
+	if( mapping_index == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid mapping index.",
+		 function );
+
+		return( -1 );
+	}
+	if( *mapping_index != NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_ALREADY_SET,
+		 "%s: invalid mapping index value already set.",
+		 function );
+
+		return( -1 );
+	}
+	*mapping_index = memory_allocate_structure(
+	                  libqcow_mapping_index_t );
+
+	if( *mapping_index == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_INSUFFICIENT,
+		 "%s: unable to create mapping index.",
+		 function );
+
+		goto on_error;
+	}
+	if( memory_set(
+	     *mapping_index,
+	     0,
+	     sizeof( libqcow_mapping_index_t ) ) == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_SET_FAILED,
+		 "%s: unable to clear mapping index.",
+		 function );
+
+		goto on_error;
+	}
+	return( 1 );
+
+on_error:
+	if( *mapping_index != NULL )
+	{
+		memory_free(
+		 *mapping_index );
+
+		*mapping_index = NULL;
+	}
+	return( -1 );
+}
+
+/* Frees a mapping index
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_mapping_index_free(
+     libqcow_mapping_index_t **mapping_index,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_mapping_index_free";
+	int result            = 1;
+
+	if( mapping_index == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid mapping index.",
+		 function );
+
+		return( -1 );
+	}
+	if( *mapping_index != NULL )
+	{
+		if( ( *mapping_index )->data != NULL )
+		{
+#if defined( HAVE_LIBQCOW_MMAP_SUPPORT )
+			if( ( *mapping_index )->data_is_mapped != 0 )
+			{
+				if( munmap(
+				     ( *mapping_index )->data,
+				     ( *mapping_index )->data_size ) != 0 )
+				{
+					libcerror_error_set(
+					 error,
+					 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+					 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+					 "%s: unable to unmap data.",
+					 function );
+
+					result = -1;
+				}
+			}
+			else
+#endif
+			{
+				memory_free(
+				 ( *mapping_index )->data );
+			}
+		}
+		if( ( *mapping_index )->extents != NULL )
+		{
+			memory_free(
+			 ( *mapping_index )->extents );
+		}
+		memory_free(
+		 *mapping_index );
+
+		*mapping_index = NULL;
+	}
+	return( result );
+}
+
+/* Reads the image file values the mapping index is validated against
+ * The values consist of the file size, the modification time and a hash of the file header
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_mapping_index_read_file_values(
+     libqcow_mapping_index_t *mapping_index,
+     const char *filename,
+     libbfio_handle_t *file_io_handle,
+     libcerror_error_t **error )
+{
+	uint8_t header_data[ 512 ];
+
+	static char *function = "libqcow_mapping_index_read_file_values";
+	size_t data_offset    = 0;
+	ssize_t read_count    = 0;
+	uint64_t header_hash  = 0;
+
+#if defined( HAVE_SYS_STAT_H ) && defined( HAVE_STAT )
+	struct stat file_statistics;
+#endif
+
+	if( mapping_index == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid mapping index.",
+		 function );
+
+		return( -1 );
+	}
+	if( filename == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid filename.",
+		 function );
+
+		return( -1 );
+	}
+#if defined( HAVE_SYS_STAT_H ) && defined( HAVE_STAT )
+	if( stat(
+	     filename,
+	     &file_statistics ) != 0 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_IO,
+		 LIBCERROR_IO_ERROR_GENERIC,
+		 "%s: unable to retrieve file statistics of: %s.",
+		 function,
+		 filename );
+
+		return( -1 );
+	}
+	mapping_index->file_size         = (size64_t) file_statistics.st_size;
+	/* The modification time is stored in nanoseconds so that a modification
+	 * within the same second invalidates the mapping index
+	 */
+#if defined( HAVE_STRUCT_STAT_ST_MTIM_TV_NSEC )
+	mapping_index->modification_time = ( (int64_t) file_statistics.st_mtim.tv_sec * 1000000000 ) + (int64_t) file_statistics.st_mtim.tv_nsec;
+#elif defined( HAVE_STRUCT_STAT_ST_MTIMESPEC_TV_NSEC )
+	mapping_index->modification_time = ( (int64_t) file_statistics.st_mtimespec.tv_sec * 1000000000 ) + (int64_t) file_statistics.st_mtimespec.tv_nsec;
+#else
+	mapping_index->modification_time = (int64_t) file_statistics.st_mtime * 1000000000;
+#endif
+#else
+	libcerror_error_set(
+	 error,
+	 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+	 LIBCERROR_RUNTIME_ERROR_UNSUPPORTED_VALUE,
+	 "%s: file statistics not supported.",
+	 function );
+
+	return( -1 );
+#endif
+	read_count = libbfio_handle_read_buffer_at_offset(
+	              file_io_handle,
+	              header_data,
+	              512,
+	              0,
+	              error );
+
+	if( read_count != (ssize_t) 512 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_IO,
+		 LIBCERROR_IO_ERROR_READ_FAILED,
+		 "%s: unable to read file header data at offset: 0 (0x00000000).",
+		 function );
+
+		return( -1 );
+	}
+	/* Calculate a 64-bit Fowler-Noll-Vo (FNV-1a) hash of the file header data
+	 */
+	header_hash = 0xcbf29ce484222325ULL;
+
+	for( data_offset = 0;
+	     data_offset < 512;
+	     data_offset++ )
+	{
+		header_hash ^= header_data[ data_offset ];
+		header_hash *= 0x00000100000001b3ULL;
+	}
+	mapping_index->header_hash = header_hash;
+
+	return( 1 );
+}
+
+/* Reads the mapping index data and sets the extents of the level 2 tables in the extent index
+ * The extents are read into the mapping index and referenced by the extent index
+ * Returns 1 if successful, 0 if the data is not valid for the image file or -1 on error
+ */
+int libqcow_mapping_index_read_data(
+     libqcow_mapping_index_t *mapping_index,
+     libqcow_extent_index_t *extent_index,
+     libcerror_error_t **error )
+{
+	qcow_mapping_index_extent_t *mapping_index_extent = NULL;
+	qcow_mapping_index_header_t *mapping_index_header = NULL;
+	qcow_mapping_index_table_t *mapping_index_table   = NULL;
+	libqcow_extent_t *extent                          = NULL;
+	libqcow_extent_t *extents                         = NULL;
+	static char *function                             = "libqcow_mapping_index_read_data";
+	size64_t cluster_block_size                       = 0;
+	size64_t file_size                                = 0;
+	size_t data_offset                                = 0;
+	size_t extents_data_offset                        = 0;
+	uint64_t cluster_block_offset                     = 0;
+	uint64_t header_hash                              = 0;
+	uint64_t modification_time                        = 0;
+	uint32_t cluster_block_flags                      = 0;
+	uint32_t extent_size                              = 0;
+	uint32_t first_cluster_block_index                = 0;
+	uint32_t format_version                           = 0;
+	uint32_t header_size                              = 0;
+	uint32_t number_of_cluster_blocks                 = 0;
+	uint32_t number_of_extents                        = 0;
+	uint32_t number_of_level2_table_references        = 0;
+	uint32_t number_of_level2_tables                  = 0;
+	uint32_t number_of_table_extents                  = 0;
+	uint32_t table_flags                              = 0;
+	uint32_t total_number_of_extents                  = 0;
+	int extent_entry_index                            = 0;
+	int level2_table_index                            = 0;
+	int next_cluster_block_index                      = 0;
+	int table_extent_index                            = 0;
+
+	if( mapping_index == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid mapping index.",
+		 function );
+
+		return( -1 );
+	}
+	if( mapping_index->data == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid mapping index - missing data.",
+		 function );
+
+		return( -1 );
+	}
+	if( extent_index == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid extent index.",
+		 function );
+
+		return( -1 );
+	}
+	if( mapping_index->data_size < sizeof( qcow_mapping_index_header_t ) )
+	{
+		return( 0 );
+	}
+	mapping_index_header = (qcow_mapping_index_header_t *) mapping_index->data;
+
+	if( memory_compare(
+	     mapping_index_header->signature,
+	     qcow_mapping_index_signature,
+	     8 ) != 0 )
+	{
+		return( 0 );
+	}
+	byte_stream_copy_to_uint32_little_endian(
+	 mapping_index_header->format_version,
+	 format_version );
+
+	byte_stream_copy_to_uint32_little_endian(
+	 mapping_index_header->header_size,
+	 header_size );
+
+	byte_stream_copy_to_uint64_little_endian(
+	 mapping_index_header->file_size,
+	 file_size );
+
+	byte_stream_copy_to_uint64_little_endian(
+	 mapping_index_header->modification_time,
+	 modification_time );
+
+	byte_stream_copy_to_uint64_little_endian(
+	 mapping_index_header->header_hash,
+	 header_hash );
+
+	byte_stream_copy_to_uint64_little_endian(
+	 mapping_index_header->cluster_block_size,
+	 cluster_block_size );
+
+	byte_stream_copy_to_uint32_little_endian(
+	 mapping_index_header->number_of_level2_tables,
+	 number_of_level2_tables );
+
+	byte_stream_copy_to_uint32_little_endian(
+	 mapping_index_header->number_of_level2_table_references,
+	 number_of_level2_table_references );
+
+	byte_stream_copy_to_uint32_little_endian(
+	 mapping_index_header->number_of_extents,
+	 number_of_extents );
+
+	byte_stream_copy_to_uint32_little_endian(
+	 mapping_index_header->extent_size,
+	 extent_size );
+
+#if defined( HAVE_DEBUG_OUTPUT )
+	if( libcnotify_verbose != 0 )
+	{
+		libcnotify_printf(
+		 "%s: format version\t\t\t: %" PRIu32 "\n",
+		 function,
+		 format_version );
+
+		libcnotify_printf(
+		 "%s: header size\t\t\t\t: %" PRIu32 "\n",
+		 function,
+		 header_size );
+
+		libcnotify_printf(
+		 "%s: file size\t\t\t\t: %" PRIu64 "\n",
+		 function,
+		 file_size );
+
+		libcnotify_printf(
+		 "%s: modification time\t\t\t: %" PRIu64 "\n",
+		 function,
+		 modification_time );
+
+		libcnotify_printf(
+		 "%s: header hash\t\t\t\t: 0x%08" PRIx64 "\n",
+		 function,
+		 header_hash );
+
+		libcnotify_printf(
+		 "%s: cluster block size\t\t\t: %" PRIu64 "\n",
+		 function,
+		 cluster_block_size );
+
+		libcnotify_printf(
+		 "%s: number of level 2 tables\t\t: %" PRIu32 "\n",
+		 function,
+		 number_of_level2_tables );
+
+		libcnotify_printf(
+		 "%s: number of level 2 table references\t: %" PRIu32 "\n",
+		 function,
+		 number_of_level2_table_references );
+
+		libcnotify_printf(
+		 "%s: number of extents\t\t\t: %" PRIu32 "\n",
+		 function,
+		 number_of_extents );
+
+		libcnotify_printf(
+		 "%s: extent size\t\t\t\t: %" PRIu32 "\n",
+		 function,
+		 extent_size );
+
+		libcnotify_printf(
+		 "\n" );
+	}
+#endif /* defined( HAVE_DEBUG_OUTPUT ) */
+
+	/* A mapping index of another format version or that does not match the image file is stale
+	 */
+	if( ( format_version != 4 )
+	 || ( header_size != (uint32_t) sizeof( qcow_mapping_index_header_t ) )
+	 || ( file_size != mapping_index->file_size )
+	 || ( (int64_t) modification_time != mapping_index->modification_time )
+	 || ( header_hash != mapping_index->header_hash )
+	 || ( cluster_block_size != extent_index->cluster_block_size )
+	 || ( number_of_level2_tables != (uint32_t) extent_index->number_of_level2_tables )
+	 || ( number_of_level2_table_references != (uint32_t) extent_index->number_of_level2_table_references )
+	 || ( extent_size != (uint32_t) sizeof( qcow_mapping_index_extent_t ) ) )
+	{
+		return( 0 );
+	}
+	data_offset         = sizeof( qcow_mapping_index_header_t );
+	extents_data_offset = data_offset + ( (size_t) number_of_level2_tables * sizeof( qcow_mapping_index_table_t ) );
+
+	if( ( number_of_extents > (uint32_t) INT_MAX )
+	 || ( extents_data_offset > mapping_index->data_size )
+	 || ( (size_t) number_of_extents > ( ( mapping_index->data_size - extents_data_offset ) / sizeof( qcow_mapping_index_extent_t ) ) )
+	 || ( mapping_index->data_size != ( extents_data_offset + ( (size_t) number_of_extents * sizeof( qcow_mapping_index_extent_t ) ) ) ) )
+	{
+		return( 0 );
+	}
+	/* Validate all the tables before any extents are set
+	 */
+	mapping_index_extent = (qcow_mapping_index_extent_t *) &( mapping_index->data[ extents_data_offset ] );
+
+	for( level2_table_index = 0;
+	     level2_table_index < extent_index->number_of_level2_tables;
+	     level2_table_index++ )
+	{
+		mapping_index_table = (qcow_mapping_index_table_t *) &( mapping_index->data[ data_offset ] );
+
+		byte_stream_copy_to_uint32_little_endian(
+		 mapping_index_table->flags,
+		 table_flags );
+
+		byte_stream_copy_to_uint32_little_endian(
+		 mapping_index_table->number_of_extents,
+		 number_of_table_extents );
+
+		if( ( table_flags & ~( LIBQCOW_EXTENT_INDEX_TABLE_FLAG_IS_SCANNED | LIBQCOW_EXTENT_INDEX_TABLE_FLAG_IS_FRAGMENTED ) ) != 0 )
+		{
+			return( 0 );
+		}
+		if( ( number_of_table_extents > (uint32_t) extent_index->maximum_number_of_extents )
+		 || ( number_of_table_extents > ( number_of_extents - total_number_of_extents ) ) )
+		{
+			return( 0 );
+		}
+		if( ( ( table_flags & LIBQCOW_EXTENT_INDEX_TABLE_FLAG_IS_SCANNED ) == 0 )
+		 || ( ( table_flags & LIBQCOW_EXTENT_INDEX_TABLE_FLAG_IS_FRAGMENTED ) != 0 ) )
+		{
+			if( number_of_table_extents != 0 )
+			{
+				return( 0 );
+			}
+		}
+		/* The extents must be sorted, must not overlap and must be within
+		 * the level 2 table, otherwise the mapping index is not used
+		 */
+		next_cluster_block_index = 0;
+
+		for( table_extent_index = 0;
+		     table_extent_index < (int) number_of_table_extents;
+		     table_extent_index++ )
+		{
+			byte_stream_copy_to_uint32_little_endian(
+			 mapping_index_extent->first_cluster_block_index,
+			 first_cluster_block_index );
+
+			byte_stream_copy_to_uint32_little_endian(
+			 mapping_index_extent->number_of_cluster_blocks,
+			 number_of_cluster_blocks );
+
+			byte_stream_copy_to_uint32_little_endian(
+			 mapping_index_extent->cluster_block_flags,
+			 cluster_block_flags );
+
+			if( ( first_cluster_block_index < (uint32_t) next_cluster_block_index )
+			 || ( first_cluster_block_index >= (uint32_t) extent_index->number_of_level2_table_references )
+			 || ( number_of_cluster_blocks == 0 )
+			 || ( number_of_cluster_blocks > ( (uint32_t) extent_index->number_of_level2_table_references - first_cluster_block_index ) ) )
+			{
+				return( 0 );
+			}
+			if( ( cluster_block_flags & ~( LIBQCOW_CLUSTER_BLOCK_FLAG_IS_COMPRESSED | LIBQCOW_CLUSTER_BLOCK_FLAG_IS_SPARSE | LIBQCOW_CLUSTER_BLOCK_FLAG_IS_ZERO | LIBQCOW_CLUSTER_BLOCK_FLAG_IN_DATA_FILE ) ) != 0 )
+			{
+				return( 0 );
+			}
+			/* Compressed cluster blocks are never combined into a single extent
+			 */
+			if( ( ( cluster_block_flags & LIBQCOW_CLUSTER_BLOCK_FLAG_IS_COMPRESSED ) != 0 )
+			 && ( number_of_cluster_blocks != 1 ) )
+			{
+				return( 0 );
+			}
+			next_cluster_block_index = (int) ( first_cluster_block_index + number_of_cluster_blocks );
+
+			mapping_index_extent++;
+		}
+		if( ( ( table_flags & LIBQCOW_EXTENT_INDEX_TABLE_FLAG_IS_SCANNED ) != 0 )
+		 && ( extent_index->level2_tables[ level2_table_index ].flags != 0 ) )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_VALUE_ALREADY_SET,
+			 "%s: invalid extent index - level 2 table: %d already set.",
+			 function,
+			 level2_table_index );
+
+			return( -1 );
+		}
+		total_number_of_extents += number_of_table_extents;
+
+		data_offset += sizeof( qcow_mapping_index_table_t );
+	}
+	if( total_number_of_extents != number_of_extents )
+	{
+		return( 0 );
+	}
+	if( mapping_index->extents != NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_ALREADY_SET,
+		 "%s: invalid mapping index - extents value already set.",
+		 function );
+
+		return( -1 );
+	}
+	if( number_of_extents > 0 )
+	{
+		if( (size_t) number_of_extents > ( (size_t) MEMORY_MAXIMUM_ALLOCATION_SIZE / sizeof( libqcow_extent_t ) ) )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_VALUE_EXCEEDS_MAXIMUM,
+			 "%s: invalid number of extents value exceeds maximum allocation size.",
+			 function );
+
+			return( -1 );
+		}
+		mapping_index->extents = (libqcow_extent_t *) memory_allocate(
+		                                               sizeof( libqcow_extent_t ) * number_of_extents );
+
+		if( mapping_index->extents == NULL )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_MEMORY,
+			 LIBCERROR_MEMORY_ERROR_INSUFFICIENT,
+			 "%s: unable to create extents.",
+			 function );
+
+			return( -1 );
+		}
+		mapping_index->number_of_extents = (int) number_of_extents;
+
+		mapping_index_extent = (qcow_mapping_index_extent_t *) &( mapping_index->data[ extents_data_offset ] );
+
+		for( extent_entry_index = 0;
+		     extent_entry_index < (int) number_of_extents;
+		     extent_entry_index++ )
+		{
+			extent = &( mapping_index->extents[ extent_entry_index ] );
+
+			byte_stream_copy_to_uint32_little_endian(
+			 mapping_index_extent->first_cluster_block_index,
+			 first_cluster_block_index );
+
+			byte_stream_copy_to_uint32_little_endian(
+			 mapping_index_extent->number_of_cluster_blocks,
+			 number_of_cluster_blocks );
+
+			byte_stream_copy_to_uint64_little_endian(
+			 mapping_index_extent->cluster_block_offset,
+			 cluster_block_offset );
+
+			byte_stream_copy_to_uint32_little_endian(
+			 mapping_index_extent->cluster_block_flags,
+			 cluster_block_flags );
+
+			extent->first_cluster_block_index = (int) first_cluster_block_index;
+			extent->number_of_cluster_blocks  = (int) number_of_cluster_blocks;
+			extent->cluster_block_offset      = cluster_block_offset;
+			extent->cluster_block_flags       = cluster_block_flags;
+
+			mapping_index_extent++;
+		}
+	}
+	data_offset             = sizeof( qcow_mapping_index_header_t );
+	total_number_of_extents = 0;
+
+	for( level2_table_index = 0;
+	     level2_table_index < extent_index->number_of_level2_tables;
+	     level2_table_index++ )
+	{
+		mapping_index_table = (qcow_mapping_index_table_t *) &( mapping_index->data[ data_offset ] );
+
+		byte_stream_copy_to_uint32_little_endian(
+		 mapping_index_table->flags,
+		 table_flags );
+
+		byte_stream_copy_to_uint32_little_endian(
+		 mapping_index_table->number_of_extents,
+		 number_of_table_extents );
+
+		data_offset += sizeof( qcow_mapping_index_table_t );
+
+		if( ( table_flags & LIBQCOW_EXTENT_INDEX_TABLE_FLAG_IS_SCANNED ) == 0 )
+		{
+			continue;
+		}
+		extents = NULL;
+
+		if( number_of_table_extents > 0 )
+		{
+			extents = &( mapping_index->extents[ total_number_of_extents ] );
+		}
+		if( libqcow_extent_index_set_level2_table_extents(
+		     extent_index,
+		     level2_table_index,
+		     (uint8_t) table_flags,
+		     extents,
+		     (int) number_of_table_extents,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+			 "%s: unable to set extents of level 2 table: %d.",
+			 function,
+			 level2_table_index );
+
+			return( -1 );
+		}
+		total_number_of_extents += number_of_table_extents;
+	}
+	return( 1 );
+}
+
+/* Reads a mapping index file
+ * The file is memory mapped if supported
+ * Returns 1 if successful, 0 if the file is not available or not valid for the image file or -1 on error
+ */
+int libqcow_mapping_index_read_file(
+     libqcow_mapping_index_t *mapping_index,
+     const char *filename,
+     libqcow_extent_index_t *extent_index,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_mapping_index_read_file";
+	int result            = -1;
+
+#if defined( HAVE_LIBQCOW_MMAP_SUPPORT ) && defined( HAVE_FSTAT )
+	struct stat file_statistics;
+
+	void *mapped_data     = NULL;
+	int file_descriptor   = -1;
+
+#elif defined( HAVE_SYS_STAT_H ) && defined( HAVE_STAT )
+	struct stat file_statistics;
+
+	FILE *file_stream     = NULL;
+	size_t read_count     = 0;
+#endif
+
+	if( mapping_index == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid mapping index.",
+		 function );
+
+		return( -1 );
+	}
+	if( mapping_index->data != NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_ALREADY_SET,
+		 "%s: invalid mapping index - data value already set.",
+		 function );
+
+		return( -1 );
+	}
+	if( filename == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid filename.",
+		 function );
+
+		return( -1 );
+	}
+#if defined( HAVE_LIBQCOW_MMAP_SUPPORT ) && defined( HAVE_FSTAT )
+	file_descriptor = open(
+	                   filename,
+	                   O_RDONLY );
+
+	/* A missing mapping index file is not an error
+	 */
+	if( file_descriptor == -1 )
+	{
+		return( 0 );
+	}
+	if( fstat(
+	     file_descriptor,
+	     &file_statistics ) != 0 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_IO,
+		 LIBCERROR_IO_ERROR_GENERIC,
+		 "%s: unable to retrieve file statistics of: %s.",
+		 function,
+		 filename );
+
+		goto on_error;
+	}
+	if( ( file_statistics.st_size < (off_t) sizeof( qcow_mapping_index_header_t ) )
+	 || ( (size64_t) file_statistics.st_size > (size64_t) SSIZE_MAX ) )
+	{
+		close(
+		 file_descriptor );
+
+		return( 0 );
+	}
+	mapped_data = mmap(
+	               NULL,
+	               (size_t) file_statistics.st_size,
+	               PROT_READ,
+	               MAP_PRIVATE,
+	               file_descriptor,
+	               0 );
+
+	if( mapped_data == MAP_FAILED )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_IO,
+		 LIBCERROR_IO_ERROR_GENERIC,
+		 "%s: unable to map file: %s.",
+		 function,
+		 filename );
+
+		goto on_error;
+	}
+	close(
+	 file_descriptor );
+
+	file_descriptor = -1;
+
+	mapping_index->data           = (uint8_t *) mapped_data;
+	mapping_index->data_size      = (size_t) file_statistics.st_size;
+	mapping_index->data_is_mapped = 1;
+
+#elif defined( HAVE_SYS_STAT_H ) && defined( HAVE_STAT )
+	if( stat(
+	     filename,
+	     &file_statistics ) != 0 )
+	{
+		return( 0 );
+	}
+	if( ( file_statistics.st_size < (off_t) sizeof( qcow_mapping_index_header_t ) )
+	 || ( (size64_t) file_statistics.st_size > (size64_t) MEMORY_MAXIMUM_ALLOCATION_SIZE ) )
+	{
+		return( 0 );
+	}
+	file_stream = file_stream_open(
+	               filename,
+	               FILE_STREAM_BINARY_OPEN_READ );
+
+	if( file_stream == NULL )
+	{
+		return( 0 );
+	}
+	mapping_index->data_size = (size_t) file_statistics.st_size;
+
+	mapping_index->data = (uint8_t *) memory_allocate(
+	                                   sizeof( uint8_t ) * mapping_index->data_size );
+
+	if( mapping_index->data == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_INSUFFICIENT,
+		 "%s: unable to create data.",
+		 function );
+
+		goto on_error;
+	}
+	read_count = file_stream_read(
+	              file_stream,
+	              mapping_index->data,
+	              mapping_index->data_size );
+
+	if( read_count != mapping_index->data_size )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_IO,
+		 LIBCERROR_IO_ERROR_READ_FAILED,
+		 "%s: unable to read file: %s.",
+		 function,
+		 filename );
+
+		goto on_error;
+	}
+	file_stream_close(
+	 file_stream );
+
+	file_stream = NULL;
+
+	mapping_index->data_is_mapped = 0;
+#else
+	return( 0 );
+#endif
+	result = libqcow_mapping_index_read_data(
+	          mapping_index,
+	          extent_index,
+	          error );
+
+	if( result == -1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_IO,
+		 LIBCERROR_IO_ERROR_READ_FAILED,
+		 "%s: unable to read mapping index data.",
+		 function );
+
+		goto on_error;
+	}
+	else if( result == 0 )
+	{
+#if defined( HAVE_DEBUG_OUTPUT )
+		if( libcnotify_verbose != 0 )
+		{
+			libcnotify_printf(
+			 "%s: mapping index file: %s is stale.\n",
+			 function,
+			 filename );
+		}
+#endif
+	}
+	/* The extents are read from the data, hence the data is no longer needed
+	 */
+on_error:
+#if defined( HAVE_LIBQCOW_MMAP_SUPPORT ) && defined( HAVE_FSTAT )
+	if( file_descriptor != -1 )
+	{
+		close(
+		 file_descriptor );
+	}
+	if( mapping_index->data != NULL )
+	{
+		munmap(
+		 mapping_index->data,
+		 mapping_index->data_size );
+	}
+#elif defined( HAVE_SYS_STAT_H ) && defined( HAVE_STAT )
+	if( file_stream != NULL )
+	{
+		file_stream_close(
+		 file_stream );
+	}
+	if( mapping_index->data != NULL )
+	{
+		memory_free(
+		 mapping_index->data );
+	}
+#endif
+	mapping_index->data           = NULL;
+	mapping_index->data_size      = 0;
+	mapping_index->data_is_mapped = 0;
+
+	if( result == 1 )
+	{
+		return( 1 );
+	}
+	else if( result == 0 )
+	{
+		return( 0 );
+	}
+	return( -1 );
+}
+
+/* Writes a mapping index file
+ * The file is first written to a temporary file that replaces the mapping index file
+ * when complete, so that the data of a mapping index file that is in use remains valid
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_mapping_index_write_file(
+     libqcow_mapping_index_t *mapping_index,
+     const char *filename,
+     libqcow_extent_index_t *extent_index,
+     libcerror_error_t **error )
+{
+	qcow_mapping_index_extent_t mapping_index_extent;
+	qcow_mapping_index_header_t mapping_index_header;
+	qcow_mapping_index_table_t mapping_index_table;
+
+	libqcow_extent_index_table_t *level2_table = NULL;
+	libqcow_extent_t *extent                   = NULL;
+	FILE *file_stream                          = NULL;
+	char *temporary_filename                   = NULL;
+	static char *function                      = "libqcow_mapping_index_write_file";
+	size_t filename_length                     = 0;
+	size_t write_count                         = 0;
+	uint32_t number_of_extents                 = 0;
+	uint8_t table_flags                        = 0;
+	int level2_table_index                     = 0;
+	int table_extent_index                     = 0;
+
+	if( mapping_index == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid mapping index.",
+		 function );
+
+		return( -1 );
+	}
+	if( filename == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid filename.",
+		 function );
+
+		return( -1 );
+	}
+	if( extent_index == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid extent index.",
+		 function );
+
+		return( -1 );
+	}
+	for( level2_table_index = 0;
+	     level2_table_index < extent_index->number_of_level2_tables;
+	     level2_table_index++ )
+	{
+		level2_table = &( extent_index->level2_tables[ level2_table_index ] );
+
+		if( level2_table->number_of_extents > (int) ( INT_MAX - number_of_extents ) )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_VALUE_EXCEEDS_MAXIMUM,
+			 "%s: invalid number of extents value exceeds maximum.",
+			 function );
+
+			return( -1 );
+		}
+		number_of_extents += (uint32_t) level2_table->number_of_extents;
+	}
+	filename_length = narrow_string_length(
+	                   filename );
+
+	temporary_filename = narrow_string_allocate(
+	                      filename_length + 5 );
+
+	if( temporary_filename == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_INSUFFICIENT,
+		 "%s: unable to create temporary filename.",
+		 function );
+
+		goto on_error;
+	}
+	if( narrow_string_copy(
+	     temporary_filename,
+	     filename,
+	     filename_length ) == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_COPY_FAILED,
+		 "%s: unable to copy filename.",
+		 function );
+
+		goto on_error;
+	}
+	if( narrow_string_copy(
+	     &( temporary_filename[ filename_length ] ),
+	     ".tmp",
+	     4 ) == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_COPY_FAILED,
+		 "%s: unable to copy filename suffix.",
+		 function );
+
+		goto on_error;
+	}
+	temporary_filename[ filename_length + 4 ] = 0;
+
+	if( memory_set(
+	     &mapping_index_header,
+	     0,
+	     sizeof( qcow_mapping_index_header_t ) ) == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_SET_FAILED,
+		 "%s: unable to clear mapping index header.",
+		 function );
+
+		goto on_error;
+	}
+	if( memory_copy(
+	     mapping_index_header.signature,
+	     qcow_mapping_index_signature,
+	     8 ) == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_COPY_FAILED,
+		 "%s: unable to copy signature.",
+		 function );
+
+		goto on_error;
+	}
+	byte_stream_copy_from_uint32_little_endian(
+	 mapping_index_header.format_version,
+	 4 );
+
+	byte_stream_copy_from_uint32_little_endian(
+	 mapping_index_header.header_size,
+	 (uint32_t) sizeof( qcow_mapping_index_header_t ) );
+
+	byte_stream_copy_from_uint64_little_endian(
+	 mapping_index_header.file_size,
+	 mapping_index->file_size );
+
+	byte_stream_copy_from_uint64_little_endian(
+	 mapping_index_header.modification_time,
+	 (uint64_t) mapping_index->modification_time );
+
+	byte_stream_copy_from_uint64_little_endian(
+	 mapping_index_header.header_hash,
+	 mapping_index->header_hash );
+
+	byte_stream_copy_from_uint64_little_endian(
+	 mapping_index_header.cluster_block_size,
+	 extent_index->cluster_block_size );
+
+	byte_stream_copy_from_uint32_little_endian(
+	 mapping_index_header.number_of_level2_tables,
+	 (uint32_t) extent_index->number_of_level2_tables );
+
+	byte_stream_copy_from_uint32_little_endian(
+	 mapping_index_header.number_of_level2_table_references,
+	 (uint32_t) extent_index->number_of_level2_table_references );
+
+	byte_stream_copy_from_uint32_little_endian(
+	 mapping_index_header.number_of_extents,
+	 number_of_extents );
+
+	byte_stream_copy_from_uint32_little_endian(
+	 mapping_index_header.extent_size,
+	 (uint32_t) sizeof( qcow_mapping_index_extent_t ) );
+
+	file_stream = file_stream_open(
+	               temporary_filename,
+	               FILE_STREAM_BINARY_OPEN_WRITE );
+
+	if( file_stream == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_IO,
+		 LIBCERROR_IO_ERROR_OPEN_FAILED,
+		 "%s: unable to open file: %s.",
+		 function,
+		 temporary_filename );
+
+		goto on_error;
+	}
+	write_count = file_stream_write(
+	               file_stream,
+	               &mapping_index_header,
+	               sizeof( qcow_mapping_index_header_t ) );
+
+	if( write_count != sizeof( qcow_mapping_index_header_t ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_IO,
+		 LIBCERROR_IO_ERROR_WRITE_FAILED,
+		 "%s: unable to write mapping index header.",
+		 function );
+
+		goto on_error;
+	}
+	for( level2_table_index = 0;
+	     level2_table_index < extent_index->number_of_level2_tables;
+	     level2_table_index++ )
+	{
+		level2_table = &( extent_index->level2_tables[ level2_table_index ] );
+
+		table_flags = level2_table->flags & ( LIBQCOW_EXTENT_INDEX_TABLE_FLAG_IS_SCANNED | LIBQCOW_EXTENT_INDEX_TABLE_FLAG_IS_FRAGMENTED );
+
+		byte_stream_copy_from_uint32_little_endian(
+		 mapping_index_table.flags,
+		 (uint32_t) table_flags );
+
+		byte_stream_copy_from_uint32_little_endian(
+		 mapping_index_table.number_of_extents,
+		 (uint32_t) level2_table->number_of_extents );
+
+		write_count = file_stream_write(
+		               file_stream,
+		               &mapping_index_table,
+		               sizeof( qcow_mapping_index_table_t ) );
+
+		if( write_count != sizeof( qcow_mapping_index_table_t ) )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_IO,
+			 LIBCERROR_IO_ERROR_WRITE_FAILED,
+			 "%s: unable to write mapping index table: %d.",
+			 function,
+			 level2_table_index );
+
+			goto on_error;
+		}
+	}
+	for( level2_table_index = 0;
+	     level2_table_index < extent_index->number_of_level2_tables;
+	     level2_table_index++ )
+	{
+		level2_table = &( extent_index->level2_tables[ level2_table_index ] );
+
+		for( table_extent_index = 0;
+		     table_extent_index < level2_table->number_of_extents;
+		     table_extent_index++ )
+		{
+			extent = &( level2_table->extents[ table_extent_index ] );
+
+			byte_stream_copy_from_uint32_little_endian(
+			 mapping_index_extent.first_cluster_block_index,
+			 (uint32_t) extent->first_cluster_block_index );
+
+			byte_stream_copy_from_uint32_little_endian(
+			 mapping_index_extent.number_of_cluster_blocks,
+			 (uint32_t) extent->number_of_cluster_blocks );
+
+			byte_stream_copy_from_uint64_little_endian(
+			 mapping_index_extent.cluster_block_offset,
+			 extent->cluster_block_offset );
+
+			byte_stream_copy_from_uint32_little_endian(
+			 mapping_index_extent.cluster_block_flags,
+			 extent->cluster_block_flags );
+
+			write_count = file_stream_write(
+			               file_stream,
+			               &mapping_index_extent,
+			               sizeof( qcow_mapping_index_extent_t ) );
+
+			if( write_count != sizeof( qcow_mapping_index_extent_t ) )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_IO,
+				 LIBCERROR_IO_ERROR_WRITE_FAILED,
+				 "%s: unable to write extent: %d of level 2 table: %d.",
+				 function,
+				 table_extent_index,
+				 level2_table_index );
+
+				goto on_error;
+			}
+		}
+	}
+	if( file_stream_close(
+	     file_stream ) != 0 )
+	{
+		file_stream = NULL;
+
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_IO,
+		 LIBCERROR_IO_ERROR_CLOSE_FAILED,
+		 "%s: unable to close file: %s.",
+		 function,
+		 temporary_filename );
+
+		goto on_error;
+	}
+	file_stream = NULL;
+
+	if( rename(
+	     temporary_filename,
+	     filename ) != 0 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_IO,
+		 LIBCERROR_IO_ERROR_WRITE_FAILED,
+		 "%s: unable to replace file: %s.",
+		 function,
+		 filename );
+
+		goto on_error;
+	}
+	memory_free(
+	 temporary_filename );
+
+	return( 1 );
+
+on_error:
+	if( file_stream != NULL )
+	{
+		file_stream_close(
+		 file_stream );
+	}
+	if( temporary_filename != NULL )
+	{
+		remove(
+		 temporary_filename );
+
+		memory_free(
+		 temporary_filename );
+	}
+	return( -1 );
+}
+
@@ -0,0 +1,113 @@
+/*
+ * Mapping index (sidecar) file functions
+ *
+ * Copyright (C) 2010-2026, Joachim Metz <joachim.metz@gmail.com>
+ *
+ * Refer to AUTHORS for acknowledgements.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#if !defined( _LIBQCOW_MAPPING_INDEX_H )
+#define _LIBQCOW_MAPPING_INDEX_H
+
+#include <common.h>
+#include <types.h>
+
+#include "libqcow_extent_index.h"
+#include "libqcow_libbfio.h"
+#include "libqcow_libcerror.h"
+#include "libqcow_mapped_file.h"
+
+#if defined( __cplusplus )
+extern "C" {
+#endif
+
+extern const uint8_t qcow_mapping_index_signature[ 8 ];
+
+typedef struct libqcow_mapping_index libqcow_mapping_index_t;
+
+struct libqcow_mapping_index
+{
+	/* The image file size
+	 */
+	size64_t file_size;
+
+	/* The image file modification time, in nanoseconds
+	 */
+	int64_t modification_time;
+
+	/* The image file header hash
+	 */
+	uint64_t header_hash;
+
+	/* The data
+	 */
+	uint8_t *data;
+
+	/* The data size
+	 */
+	size_t data_size;
+
+	/* Value to indicate the data is memory mapped
+	 */
+	uint8_t data_is_mapped;
+
+	/* The extents read from the data
+	 * The extents of the level 2 tables in the extent index reference these
+	 */
+	libqcow_extent_t *extents;
+
+	/* The number of extents
+	 */
+	int number_of_extents;
+};
+
+int libqcow_mapping_index_initialize(
+     libqcow_mapping_index_t **mapping_index,
+     libcerror_error_t **error );
+
+int libqcow_mapping_index_free(
+     libqcow_mapping_index_t **mapping_index,
+     libcerror_error_t **error );
+
+int libqcow_mapping_index_read_file_values(
+     libqcow_mapping_index_t *mapping_index,
+     const char *filename,
+     libbfio_handle_t *file_io_handle,
+     libcerror_error_t **error );
+
+int libqcow_mapping_index_read_data(
+     libqcow_mapping_index_t *mapping_index,
+     libqcow_extent_index_t *extent_index,
+     libcerror_error_t **error );
+
+int libqcow_mapping_index_read_file(
+     libqcow_mapping_index_t *mapping_index,
+     const char *filename,
+     libqcow_extent_index_t *extent_index,
+     libcerror_error_t **error );
+
+int libqcow_mapping_index_write_file(
+     libqcow_mapping_index_t *mapping_index,
+     const char *filename,
+     libqcow_extent_index_t *extent_index,
+     libcerror_error_t **error );
+
+#if defined( __cplusplus )
+}
+#endif
+
+#endif /* !defined( _LIBQCOW_MAPPING_INDEX_H ) */
+
@@ -0,0 +1,225 @@
+/*
+ * Read control functions
+ *
+ * Copyright (C) 2010-2026, Joachim Metz <joachim.metz@gmail.com>
+ *
+ * Refer to AUTHORS for acknowledgements.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <common.h>
+#include <types.h>
+
+#include <time.h>
+
+#include "libqcow_libcerror.h"
+#include "libqcow_read_control.h"
+
+/* Retrieves the current time of the monotonic clock in milliseconds
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_read_control_get_current_time(
+     uint64_t *current_time,
+     libcerror_error_t **error )
+{
+#if !defined( WINAPI ) && defined( HAVE_CLOCK_GETTIME ) && defined( CLOCK_MONOTONIC )
+	struct timespec time_value;
+#elif !defined( WINAPI )
+	time_t time_value     = 0;
+#endif
+
+	static char *function = "libqcow_read_control_get_current_time";
+
+	if( current_time == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid current time.",
+		 function );
+
+		return( -1 );
+	}
+#if defined( WINAPI ) && ( WINVER >= 0x0600 )
+	*current_time = (uint64_t) GetTickCount64();
+
+#elif defined( WINAPI )
+	/* GetTickCount wraps around after 49.7 days
+	 */
+	*current_time = (uint64_t) GetTickCount();
+
+#elif defined( HAVE_CLOCK_GETTIME ) && defined( CLOCK_MONOTONIC )
+	if( clock_gettime(
+	     CLOCK_MONOTONIC,
+	     &time_value ) != 0 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+		 "%s: unable to retrieve monotonic clock time.",
+		 function );
+
+		return( -1 );
+	}
+	*current_time = ( (uint64_t) time_value.tv_sec * 1000 ) + ( (uint64_t) time_value.tv_nsec / 1000000 );
+
+#else
+	/* Without a monotonic clock the deadline has a granularity of a second
+	 */
+	time_value = time(
+	              NULL );
+
+	if( time_value == (time_t) -1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+		 "%s: unable to retrieve current time.",
+		 function );
+
+		return( -1 );
+	}
+	*current_time = (uint64_t) time_value * 1000;
+
+#endif
+	return( 1 );
+}
+
+/* Sets the timeout of a read
+ * The deadline of the read is the current time plus the timeout in milliseconds
+ * A timeout of 0 removes the deadline
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_read_control_set_timeout(
+     libqcow_read_control_t *read_control,
+     uint32_t timeout,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_read_control_set_timeout";
+	uint64_t current_time = 0;
+
+	if( read_control == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid read control.",
+		 function );
+
+		return( -1 );
+	}
+	if( timeout == 0 )
+	{
+		read_control->deadline = 0;
+
+		return( 1 );
+	}
+	if( libqcow_read_control_get_current_time(
+	     &current_time,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+		 "%s: unable to retrieve current time.",
+		 function );
+
+		return( -1 );
+	}
+	read_control->deadline = current_time + timeout;
+
+	return( 1 );
+}
+
+/* Cancels a read
+ * The read stops the next time it checks the read control
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_read_control_cancel(
+     libqcow_read_control_t *read_control,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_read_control_cancel";
+
+	if( read_control == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid read control.",
+		 function );
+
+		return( -1 );
+	}
+	read_control->cancelled = 1;
+
+	return( 1 );
+}
+
+/* Determines if a read was cancelled or has passed its deadline
+ * Returns 1 if stopped, 0 if not or -1 on error
+ */
+int libqcow_read_control_is_stopped(
+     libqcow_read_control_t *read_control,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_read_control_is_stopped";
+	uint64_t current_time = 0;
+
+	if( read_control == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid read control.",
+		 function );
+
+		return( -1 );
+	}
+	if( read_control->cancelled != 0 )
+	{
+		return( 1 );
+	}
+	if( read_control->deadline == 0 )
+	{
+		return( 0 );
+	}
+	if( libqcow_read_control_get_current_time(
+	     &current_time,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+		 "%s: unable to retrieve current time.",
+		 function );
+
+		return( -1 );
+	}
+	if( current_time >= read_control->deadline )
+	{
+		return( 1 );
+	}
+	return( 0 );
+}
+
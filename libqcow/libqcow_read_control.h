@@ -0,0 +1,70 @@
+/*
+ * Read control functions
+ *
+ * Copyright (C) 2010-2026, Joachim Metz <joachim.metz@gmail.com>
+ *
+ * Refer to AUTHORS for acknowledgements.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#if !defined( _LIBQCOW_READ_CONTROL_H )
+#define _LIBQCOW_READ_CONTROL_H
+
+#include <common.h>
+#include <types.h>
+
+#include "libqcow_libcerror.h"
+
+#if defined( __cplusplus )
+extern "C" {
+#endif
+
+typedef struct libqcow_read_control libqcow_read_control_t;
+
+struct libqcow_read_control
+{
+	/* The deadline, in milliseconds of the monotonic clock
+	 * Contains 0 if the read has no deadline
+	 */
+	uint64_t deadline;
+
+	/* Value to indicate if the read was cancelled
+	 */
+	int cancelled;
+};
+
+int libqcow_read_control_get_current_time(
+     uint64_t *current_time,
+     libcerror_error_t **error );
+
+int libqcow_read_control_set_timeout(
+     libqcow_read_control_t *read_control,
+     uint32_t timeout,
+     libcerror_error_t **error );
+
+int libqcow_read_control_cancel(
+     libqcow_read_control_t *read_control,
+     libcerror_error_t **error );
+
+int libqcow_read_control_is_stopped(
+     libqcow_read_control_t *read_control,
+     libcerror_error_t **error );
+
+#if defined( __cplusplus )
+}
+#endif
+
+#endif /* !defined( _LIBQCOW_READ_CONTROL_H ) */
+
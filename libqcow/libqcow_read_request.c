@@ -0,0 +1,1106 @@
+/*
+ * Read request functions
+ *
+ * Copyright (C) 2010-2026, Joachim Metz <joachim.metz@gmail.com>
+ *
+ * Refer to AUTHORS for acknowledgements.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <common.h>
+#include <memory.h>
+#include <types.h>
+
+#include "libqcow_file.h"
+#include "libqcow_libcerror.h"
+#include "libqcow_libcthreads.h"
+#include "libqcow_read_control.h"
+#include "libqcow_read_request.h"
+#include "libqcow_types.h"
+#include "libqcow_unused.h"
+
+/* Creates a read request
+ * Make sure the value read_request is referencing, is set to NULL
+ * The read is split into parts at the (media) offsets that are a multiple of the part size,
+ * a part size of 0 means the read consists of a single part
+ * The deadline of the read is the current time plus the timeout in milliseconds,
+ * a timeout of 0 means the read has no deadline
+ * This function is not multi-thread safe acquire write lock of the file before call
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_read_request_initialize(
+     libqcow_read_request_t **read_request,
+     libqcow_file_t *file,
+     uint8_t *buffer,
+     size_t buffer_size,
+     off64_t offset,
+     size_t part_size,
+     uint32_t timeout,
+     libcerror_error_t **error )
+{
+	libqcow_internal_read_request_t *internal_read_request = NULL;
+	static char *function                                  = "libqcow_read_request_initialize";
+	size64_t number_of_parts                               = 1;
+	size_t buffer_offset                                   = 0;
+	size_t part_buffer_size                                = 0;
+	size_t part_remainder_size                             = 0;
+	int part_index                                         = 0;
+
+	if( read_request == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid read request.",
+		 function );
+
+		return( -1 );
+	}
+	if( *read_request != NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_ALREADY_SET,
+		 "%s: invalid read request value already set.",
+		 function );
+
+		return( -1 );
+	}
+	if( file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	if( buffer == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid buffer.",
+		 function );
+
+		return( -1 );
+	}
+	if( buffer_size > (size_t) SSIZE_MAX )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_EXCEEDS_MAXIMUM,
+		 "%s: invalid buffer size value exceeds maximum.",
+		 function );
+
+		return( -1 );
+	}
+	if( offset < 0 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_LESS_THAN_ZERO,
+		 "%s: invalid offset value less than zero.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( part_size != 0 )
+	 && ( buffer_size != 0 ) )
+	{
+		number_of_parts = ( ( (size64_t) offset % part_size ) + buffer_size + part_size - 1 ) / part_size;
+	}
+	if( number_of_parts > (size64_t) ( MEMORY_MAXIMUM_ALLOCATION_SIZE / sizeof( libqcow_read_request_part_t ) ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid number of parts value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	internal_read_request = memory_allocate_structure(
+	                         libqcow_internal_read_request_t );
+
+	if( internal_read_request == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_INSUFFICIENT,
+		 "%s: unable to create read request.",
+		 function );
+
+		goto on_error;
+	}
+	if( memory_set(
+	     internal_read_request,
+	     0,
+	     sizeof( libqcow_internal_read_request_t ) ) == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_SET_FAILED,
+		 "%s: unable to clear read request.",
+		 function );
+
+		memory_free(
+		 internal_read_request );
+
+		return( -1 );
+	}
+	internal_read_request->parts = (libqcow_read_request_part_t *) memory_allocate(
+	                                                                sizeof( libqcow_read_request_part_t ) * (size_t) number_of_parts );
+
+	if( internal_read_request->parts == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_INSUFFICIENT,
+		 "%s: unable to create parts.",
+		 function );
+
+		goto on_error;
+	}
+	internal_read_request->number_of_parts = (int) number_of_parts;
+
+	for( part_index = 0;
+	     part_index < internal_read_request->number_of_parts;
+	     part_index++ )
+	{
+		part_buffer_size = buffer_size - buffer_offset;
+
+		if( part_size != 0 )
+		{
+			part_remainder_size = part_size - (size_t) ( (size64_t) ( offset + buffer_offset ) % part_size );
+
+			if( part_buffer_size > part_remainder_size )
+			{
+				part_buffer_size = part_remainder_size;
+			}
+		}
+		internal_read_request->parts[ part_index ].read_request  = internal_read_request;
+		internal_read_request->parts[ part_index ].buffer_offset = buffer_offset;
+		internal_read_request->parts[ part_index ].buffer_size   = part_buffer_size;
+		internal_read_request->parts[ part_index ].read_count    = 0;
+		internal_read_request->parts[ part_index ].read_error    = NULL;
+
+		buffer_offset += part_buffer_size;
+	}
+	if( libqcow_read_control_set_timeout(
+	     &( internal_read_request->read_control ),
+	     timeout,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to set timeout.",
+		 function );
+
+		goto on_error;
+	}
+	/* The read request is stopped when the file is signalled to abort after it was created
+	 */
+	if( libqcow_internal_file_get_abort_generation(
+	     (libqcow_internal_file_t *) file,
+	     &( internal_read_request->abort_generation ),
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+		 "%s: unable to retrieve abort generation.",
+		 function );
+
+		goto on_error;
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_mutex_initialize(
+	     &( internal_read_request->mutex ),
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+		 "%s: unable to initialize mutex.",
+		 function );
+
+		goto on_error;
+	}
+	if( libcthreads_condition_initialize(
+	     &( internal_read_request->condition ),
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+		 "%s: unable to initialize condition.",
+		 function );
+
+		goto on_error;
+	}
+#endif
+	internal_read_request->file        = file;
+	internal_read_request->buffer      = buffer;
+	internal_read_request->buffer_size = buffer_size;
+	internal_read_request->offset      = offset;
+
+	*read_request = (libqcow_read_request_t *) internal_read_request;
+
+	return( 1 );
+
+on_error:
+	if( internal_read_request != NULL )
+	{
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+		if( internal_read_request->mutex != NULL )
+		{
+			libcthreads_mutex_free(
+			 &( internal_read_request->mutex ),
+			 NULL );
+		}
+#endif
+		if( internal_read_request->parts != NULL )
+		{
+			memory_free(
+			 internal_read_request->parts );
+		}
+		memory_free(
+		 internal_read_request );
+	}
+	return( -1 );
+}
+
+/* Frees a read request
+ * Waits for the read to complete before the read request is freed
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_read_request_free(
+     libqcow_read_request_t **read_request,
+     libcerror_error_t **error )
+{
+	libqcow_internal_read_request_t *internal_read_request = NULL;
+	libqcow_internal_file_t *internal_file                 = NULL;
+	static char *function                                  = "libqcow_read_request_free";
+	int result                                             = 1;
+
+	if( read_request == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid read request.",
+		 function );
+
+		return( -1 );
+	}
+	if( *read_request == NULL )
+	{
+		return( 1 );
+	}
+	internal_read_request = (libqcow_internal_read_request_t *) *read_request;
+	internal_file         = (libqcow_internal_file_t *) internal_read_request->file;
+
+	/* The read thread references the read request until the read has completed
+	 */
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_mutex_grab(
+	     internal_read_request->mutex,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab mutex.",
+		 function );
+
+		return( -1 );
+	}
+	while( internal_read_request->is_complete == 0 )
+	{
+		if( libcthreads_condition_wait(
+		     internal_read_request->condition,
+		     internal_read_request->mutex,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+			 "%s: unable to wait for condition.",
+			 function );
+
+			libcthreads_mutex_release(
+			 internal_read_request->mutex,
+			 NULL );
+
+			return( -1 );
+		}
+	}
+	if( libcthreads_mutex_release(
+	     internal_read_request->mutex,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release mutex.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	*read_request = NULL;
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_read_write_lock_grab_for_write(
+	     internal_file->read_write_lock,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab read/write lock for writing.",
+		 function );
+
+		result = -1;
+	}
+	else
+#endif
+	{
+		internal_file->number_of_open_read_requests -= 1;
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+		if( libcthreads_read_write_lock_release_for_write(
+		     internal_file->read_write_lock,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+			 "%s: unable to release read/write lock for writing.",
+			 function );
+
+			result = -1;
+		}
+#endif
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_condition_free(
+	     &( internal_read_request->condition ),
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+		 "%s: unable to free condition.",
+		 function );
+
+		result = -1;
+	}
+	if( libcthreads_mutex_free(
+	     &( internal_read_request->mutex ),
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+		 "%s: unable to free mutex.",
+		 function );
+
+		result = -1;
+	}
+#endif
+	if( internal_read_request->read_error != NULL )
+	{
+		libcerror_error_free(
+		 &( internal_read_request->read_error ) );
+	}
+	memory_free(
+	 internal_read_request->parts );
+
+	memory_free(
+	 internal_read_request );
+
+	return( result );
+}
+
+/* Reads the (media) data of a read request and signals its completion
+ * The parts of the read request are read one after the other
+ * The read error is retained by the read request
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_internal_read_request_read(
+     libqcow_internal_read_request_t *internal_read_request,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_internal_read_request_read";
+	int part_index        = 0;
+
+	if( internal_read_request == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid read request.",
+		 function );
+
+		return( -1 );
+	}
+	if( internal_read_request->is_complete != 0 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_ALREADY_SET,
+		 "%s: invalid read request - already complete.",
+		 function );
+
+		return( -1 );
+	}
+	for( part_index = 0;
+	     part_index < internal_read_request->number_of_parts;
+	     part_index++ )
+	{
+		if( libqcow_internal_read_request_read_part(
+		     internal_read_request,
+		     &( internal_read_request->parts[ part_index ] ),
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_IO,
+			 LIBCERROR_IO_ERROR_READ_FAILED,
+			 "%s: unable to read part: %d.",
+			 function,
+			 part_index );
+
+			return( -1 );
+		}
+	}
+	return( 1 );
+}
+
+/* Reads the (media) data of a part of a read request
+ * The read request is completed when the part is the last part to complete
+ * The read error is retained by the part
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_internal_read_request_read_part(
+     libqcow_internal_read_request_t *internal_read_request,
+     libqcow_read_request_part_t *read_request_part,
+     libcerror_error_t **error )
+{
+	libcerror_error_t *read_error = NULL;
+	static char *function         = "libqcow_internal_read_request_read_part";
+	ssize_t read_count            = 0;
+
+	if( internal_read_request == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid read request.",
+		 function );
+
+		return( -1 );
+	}
+	if( read_request_part == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid read request part.",
+		 function );
+
+		return( -1 );
+	}
+	/* The file cannot be closed while the read request is open
+	 */
+	read_count = libqcow_internal_file_read_buffer_at_offset(
+	              (libqcow_internal_file_t *) internal_read_request->file,
+	              &( internal_read_request->buffer[ read_request_part->buffer_offset ] ),
+	              read_request_part->buffer_size,
+	              internal_read_request->offset + (off64_t) read_request_part->buffer_offset,
+	              &( internal_read_request->read_control ),
+	              internal_read_request->abort_generation,
+	              &read_error );
+
+	if( read_count == -1 )
+	{
+		libcerror_error_set(
+		 &read_error,
+		 LIBCERROR_ERROR_DOMAIN_IO,
+		 LIBCERROR_IO_ERROR_READ_FAILED,
+		 "%s: unable to read buffer at offset: %" PRIi64 " (0x%08" PRIx64 ").",
+		 function,
+		 internal_read_request->offset + (off64_t) read_request_part->buffer_offset,
+		 internal_read_request->offset + (off64_t) read_request_part->buffer_offset );
+	}
+	if( libqcow_internal_read_request_complete_part(
+	     internal_read_request,
+	     read_request_part,
+	     read_count,
+	     read_error,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to complete part.",
+		 function );
+
+		return( -1 );
+	}
+	return( 1 );
+}
+
+/* Completes a part of a read request
+ * The part takes over the read error
+ * The read request is completed when the part is the last part to complete
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_internal_read_request_complete_part(
+     libqcow_internal_read_request_t *internal_read_request,
+     libqcow_read_request_part_t *read_request_part,
+     ssize_t read_count,
+     libcerror_error_t *read_error,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_internal_read_request_complete_part";
+	int is_last_part      = 0;
+
+	if( internal_read_request == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid read request.",
+		 function );
+
+		return( -1 );
+	}
+	if( read_request_part == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid read request part.",
+		 function );
+
+		return( -1 );
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_mutex_grab(
+	     internal_read_request->mutex,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab mutex.",
+		 function );
+
+		if( read_error != NULL )
+		{
+			libcerror_error_free(
+			 &read_error );
+		}
+		return( -1 );
+	}
+#endif
+	read_request_part->read_count = read_count;
+	read_request_part->read_error = read_error;
+
+	internal_read_request->number_of_completed_parts += 1;
+
+	if( internal_read_request->number_of_completed_parts == internal_read_request->number_of_parts )
+	{
+		is_last_part = 1;
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_mutex_release(
+	     internal_read_request->mutex,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release mutex.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	/* The parts are no longer referenced by the other threads once the last part has completed
+	 */
+	if( is_last_part != 0 )
+	{
+		if( libqcow_internal_read_request_complete(
+		     internal_read_request,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+			 "%s: unable to complete read request.",
+			 function );
+
+			return( -1 );
+		}
+	}
+	return( 1 );
+}
+
+/* Completes a read request of which all parts have completed and signals its completion
+ * The number of bytes read is that of the parts up to and including the first part that
+ * was not read entirely, such as at the end of the media. When a part failed after bytes
+ * were read by the preceding parts, because the read was stopped, the number of bytes read
+ * so far is the result of the read, like it is for a read that is not split into parts
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_internal_read_request_complete(
+     libqcow_internal_read_request_t *internal_read_request,
+     libcerror_error_t **error )
+{
+	libqcow_read_request_part_t *read_request_part = NULL;
+	libcerror_error_t *read_error                  = NULL;
+	static char *function                          = "libqcow_internal_read_request_complete";
+	ssize_t read_count                             = 0;
+	int part_index                                 = 0;
+	int result                                     = 0;
+
+	if( internal_read_request == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid read request.",
+		 function );
+
+		return( -1 );
+	}
+	for( part_index = 0;
+	     part_index < internal_read_request->number_of_parts;
+	     part_index++ )
+	{
+		read_request_part = &( internal_read_request->parts[ part_index ] );
+
+		if( read_request_part->read_count == -1 )
+		{
+			if( read_count > 0 )
+			{
+				result = libqcow_internal_file_read_is_stopped(
+				          (libqcow_internal_file_t *) internal_read_request->file,
+				          &( internal_read_request->read_control ),
+				          internal_read_request->abort_generation,
+				          &read_error );
+
+				if( result == -1 )
+				{
+					libcerror_error_set(
+					 &read_error,
+					 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+					 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+					 "%s: unable to determine if read is stopped.",
+					 function );
+				}
+			}
+			if( result != 1 )
+			{
+				if( read_error == NULL )
+				{
+					read_error = read_request_part->read_error;
+
+					read_request_part->read_error = NULL;
+				}
+				read_count = -1;
+			}
+			break;
+		}
+		read_count += read_request_part->read_count;
+
+		if( (size_t) read_request_part->read_count < read_request_part->buffer_size )
+		{
+			break;
+		}
+	}
+	for( part_index = 0;
+	     part_index < internal_read_request->number_of_parts;
+	     part_index++ )
+	{
+		if( internal_read_request->parts[ part_index ].read_error != NULL )
+		{
+			libcerror_error_free(
+			 &( internal_read_request->parts[ part_index ].read_error ) );
+		}
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_mutex_grab(
+	     internal_read_request->mutex,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab mutex.",
+		 function );
+
+		goto on_error;
+	}
+#endif
+	internal_read_request->read_count  = read_count;
+	internal_read_request->read_error  = read_error;
+	internal_read_request->is_complete = 1;
+
+	read_error = NULL;
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	/* The read request can be freed as soon as the mutex is released
+	 * hence it is not referenced after the release
+	 */
+	if( libcthreads_condition_broadcast(
+	     internal_read_request->condition,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to broadcast condition.",
+		 function );
+
+		libcthreads_mutex_release(
+		 internal_read_request->mutex,
+		 NULL );
+
+		return( -1 );
+	}
+	if( libcthreads_mutex_release(
+	     internal_read_request->mutex,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release mutex.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	return( 1 );
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+on_error:
+	if( read_error != NULL )
+	{
+		libcerror_error_free(
+		 &read_error );
+	}
+	return( -1 );
+#endif
+}
+
+/* Reads the (media) data of a part of a read request from the read thread pool or the scheduler
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_read_request_part_read_callback(
+     libqcow_read_request_part_t *read_request_part,
+     void *arguments LIBQCOW_ATTRIBUTE_UNUSED )
+{
+	libcerror_error_t *error = NULL;
+
+	LIBQCOW_UNREFERENCED_PARAMETER( arguments )
+
+	if( read_request_part == NULL )
+	{
+		return( -1 );
+	}
+	if( libqcow_internal_read_request_read_part(
+	     read_request_part->read_request,
+	     read_request_part,
+	     &error ) != 1 )
+	{
+		libcerror_error_free(
+		 &error );
+
+		return( -1 );
+	}
+	return( 1 );
+}
+
+/* Determines if the read of a read request has completed
+ * Returns 1 if complete, 0 if not or -1 on error
+ */
+int libqcow_read_request_is_complete(
+     libqcow_read_request_t *read_request,
+     libcerror_error_t **error )
+{
+	libqcow_internal_read_request_t *internal_read_request = NULL;
+	static char *function                                  = "libqcow_read_request_is_complete";
+	int result                                             = 0;
+
+	if( read_request == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid read request.",
+		 function );
+
+		return( -1 );
+	}
+	internal_read_request = (libqcow_internal_read_request_t *) read_request;
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_mutex_grab(
+	     internal_read_request->mutex,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab mutex.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	if( internal_read_request->is_complete != 0 )
+	{
+		result = 1;
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_mutex_release(
+	     internal_read_request->mutex,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release mutex.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	return( result );
+}
+
+/* Waits for the read of a read request to complete
+ * The error of a failed read is handed over to the caller once
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_read_request_wait(
+     libqcow_read_request_t *read_request,
+     ssize_t *read_count,
+     libcerror_error_t **error )
+{
+	libqcow_internal_read_request_t *internal_read_request = NULL;
+	libcerror_error_t *read_error                          = NULL;
+	static char *function                                  = "libqcow_read_request_wait";
+
+	if( read_request == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid read request.",
+		 function );
+
+		return( -1 );
+	}
+	internal_read_request = (libqcow_internal_read_request_t *) read_request;
+
+	if( read_count == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid read count.",
+		 function );
+
+		return( -1 );
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_mutex_grab(
+	     internal_read_request->mutex,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab mutex.",
+		 function );
+
+		return( -1 );
+	}
+	while( internal_read_request->is_complete == 0 )
+	{
+		if( libcthreads_condition_wait(
+		     internal_read_request->condition,
+		     internal_read_request->mutex,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+			 "%s: unable to wait for condition.",
+			 function );
+
+			libcthreads_mutex_release(
+			 internal_read_request->mutex,
+			 NULL );
+
+			return( -1 );
+		}
+	}
+#endif
+	*read_count = internal_read_request->read_count;
+	read_error  = internal_read_request->read_error;
+
+	internal_read_request->read_error = NULL;
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_mutex_release(
+	     internal_read_request->mutex,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release mutex.",
+		 function );
+
+		if( read_error != NULL )
+		{
+			libcerror_error_free(
+			 &read_error );
+		}
+		return( -1 );
+	}
+#endif
+	if( *read_count == -1 )
+	{
+		if( ( error != NULL )
+		 && ( *error == NULL ) )
+		{
+			*error = read_error;
+
+			read_error = NULL;
+		}
+		if( read_error != NULL )
+		{
+			libcerror_error_free(
+			 &read_error );
+		}
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_IO,
+		 LIBCERROR_IO_ERROR_READ_FAILED,
+		 "%s: unable to read buffer.",
+		 function );
+
+		return( -1 );
+	}
+	return( 1 );
+}
+
+/* Cancels the read of a read request
+ * The read stops between cluster blocks and between the layers of the backing chain,
+ * the number of bytes read so far is then the result of the read, or an error if no
+ * bytes were read. Cancelling a read that has completed has no effect
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_read_request_cancel(
+     libqcow_read_request_t *read_request,
+     libcerror_error_t **error )
+{
+	libqcow_internal_read_request_t *internal_read_request = NULL;
+	static char *function                                  = "libqcow_read_request_cancel";
+
+	if( read_request == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid read request.",
+		 function );
+
+		return( -1 );
+	}
+	internal_read_request = (libqcow_internal_read_request_t *) read_request;
+
+	if( libqcow_read_control_cancel(
+	     &( internal_read_request->read_control ),
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to cancel read control.",
+		 function );
+
+		return( -1 );
+	}
+	return( 1 );
+}
+
@@ -0,0 +1,187 @@
+/*
+ * Read request functions
+ *
+ * Copyright (C) 2010-2026, Joachim Metz <joachim.metz@gmail.com>
+ *
+ * Refer to AUTHORS for acknowledgements.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#if !defined( _LIBQCOW_INTERNAL_READ_REQUEST_H )
+#define _LIBQCOW_INTERNAL_READ_REQUEST_H
+
+#include <common.h>
+#include <types.h>
+
+#include "libqcow_extern.h"
+#include "libqcow_libcerror.h"
+#include "libqcow_libcthreads.h"
+#include "libqcow_read_control.h"
+#include "libqcow_types.h"
+
+#if defined( __cplusplus )
+extern "C" {
+#endif
+
+typedef struct libqcow_internal_read_request libqcow_internal_read_request_t;
+
+typedef struct libqcow_read_request_part libqcow_read_request_part_t;
+
+struct libqcow_read_request_part
+{
+	/* The read request that contains the part
+	 */
+	libqcow_internal_read_request_t *read_request;
+
+	/* The offset of the part relative to the start of the buffer
+	 */
+	size_t buffer_offset;
+
+	/* The size of the part
+	 */
+	size_t buffer_size;
+
+	/* The number of bytes read of the part
+	 */
+	ssize_t read_count;
+
+	/* The error of the read of the part
+	 */
+	libcerror_error_t *read_error;
+};
+
+struct libqcow_internal_read_request
+{
+	/* The file that contains the read request
+	 */
+	libqcow_file_t *file;
+
+	/* The buffer
+	 */
+	uint8_t *buffer;
+
+	/* The buffer size
+	 */
+	size_t buffer_size;
+
+	/* The (storage media) offset
+	 */
+	off64_t offset;
+
+	/* The read control
+	 */
+	libqcow_read_control_t read_control;
+
+	/* The abort generation of the file when the read request was created
+	 */
+	uint32_t abort_generation;
+
+	/* The parts
+	 * The parts are ranges of whole cluster blocks that are read concurrently
+	 */
+	libqcow_read_request_part_t *parts;
+
+	/* The number of parts
+	 */
+	int number_of_parts;
+
+	/* The number of parts that have completed
+	 */
+	int number_of_completed_parts;
+
+	/* The number of bytes read
+	 */
+	ssize_t read_count;
+
+	/* The error of the read
+	 */
+	libcerror_error_t *read_error;
+
+	/* Value to indicate if the read has completed
+	 */
+	uint8_t is_complete;
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	/* The mutex that protects the completion values
+	 */
+	libcthreads_mutex_t *mutex;
+
+	/* The condition that is signalled on completion
+	 */
+	libcthreads_condition_t *condition;
+#endif
+};
+
+int libqcow_read_request_initialize(
+     libqcow_read_request_t **read_request,
+     libqcow_file_t *file,
+     uint8_t *buffer,
+     size_t buffer_size,
+     off64_t offset,
+     size_t part_size,
+     uint32_t timeout,
+     libcerror_error_t **error );
+
+LIBQCOW_EXTERN \
+int libqcow_read_request_free(
+     libqcow_read_request_t **read_request,
+     libcerror_error_t **error );
+
+int libqcow_internal_read_request_read(
+     libqcow_internal_read_request_t *internal_read_request,
+     libcerror_error_t **error );
+
+int libqcow_internal_read_request_read_part(
+     libqcow_internal_read_request_t *internal_read_request,
+     libqcow_read_request_part_t *read_request_part,
+     libcerror_error_t **error );
+
+int libqcow_internal_read_request_complete_part(
+     libqcow_internal_read_request_t *internal_read_request,
+     libqcow_read_request_part_t *read_request_part,
+     ssize_t read_count,
+     libcerror_error_t *read_error,
+     libcerror_error_t **error );
+
+int libqcow_internal_read_request_complete(
+     libqcow_internal_read_request_t *internal_read_request,
+     libcerror_error_t **error );
+
+int libqcow_read_request_part_read_callback(
+     libqcow_read_request_part_t *read_request_part,
+     void *arguments );
+
+LIBQCOW_EXTERN \
+int libqcow_read_request_is_complete(
+     libqcow_read_request_t *read_request,
+     libcerror_error_t **error );
+
+LIBQCOW_EXTERN \
+int libqcow_read_request_wait(
+     libqcow_read_request_t *read_request,
+     ssize_t *read_count,
+     libcerror_error_t **error );
+
+LIBQCOW_EXTERN \
+int libqcow_read_request_cancel(
+     libqcow_read_request_t *read_request,
+     libcerror_error_t **error );
+
+#if defined( __cplusplus )
+}
+#endif
+
+#endif /* !defined( _LIBQCOW_INTERNAL_READ_REQUEST_H ) */
+
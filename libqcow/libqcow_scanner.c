@@ -0,0 +1,1287 @@
+/*
+ * Scanner functions
+ *
+ * Copyright (C) 2010-2026, Joachim Metz <joachim.metz@gmail.com>
+ *
+ * Refer to AUTHORS for acknowledgements.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <common.h>
+#include <memory.h>
+#include <types.h>
+
+#include "libqcow_definitions.h"
+#include "libqcow_file.h"
+#include "libqcow_libcerror.h"
+#include "libqcow_libcthreads.h"
+#include "libqcow_scanner.h"
+#include "libqcow_scheduler.h"
+#include "libqcow_types.h"
+
+/* Creates a scan chunk
+ * Make sure the value scan_chunk is referencing, is set to NULL
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_scan_chunk_initialize(
+     libqcow_scan_chunk_t **scan_chunk,
+     off64_t offset,
+     size_t data_size,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_scan_chunk_initialize";
+
+	if( scan_chunk == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid scan chunk.",
+		 function );
+
+		return( -1 );
+	}
+	if( *scan_chunk != NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_ALREADY_SET,
+		 "%s: invalid scan chunk value already set.",
+		 function );
+
+		return( -1 );
+	}
+	if( offset < 0 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_LESS_THAN_ZERO,
+		 "%s: invalid offset value less than zero.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( data_size == 0 )
+	 || ( data_size > (size_t) MEMORY_MAXIMUM_ALLOCATION_SIZE ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid data size value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	*scan_chunk = memory_allocate_structure(
+	               libqcow_scan_chunk_t );
+
+	if( *scan_chunk == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_INSUFFICIENT,
+		 "%s: unable to create scan chunk.",
+		 function );
+
+		goto on_error;
+	}
+	if( memory_set(
+	     *scan_chunk,
+	     0,
+	     sizeof( libqcow_scan_chunk_t ) ) == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_SET_FAILED,
+		 "%s: unable to clear scan chunk.",
+		 function );
+
+		memory_free(
+		 *scan_chunk );
+
+		*scan_chunk = NULL;
+
+		return( -1 );
+	}
+	( *scan_chunk )->data = (uint8_t *) memory_allocate(
+	                                     sizeof( uint8_t ) * data_size );
+
+	if( ( *scan_chunk )->data == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_INSUFFICIENT,
+		 "%s: unable to create data.",
+		 function );
+
+		goto on_error;
+	}
+	( *scan_chunk )->offset    = offset;
+	( *scan_chunk )->data_size = data_size;
+
+	return( 1 );
+
+on_error:
+	if( *scan_chunk != NULL )
+	{
+		memory_free(
+		 *scan_chunk );
+
+		*scan_chunk = NULL;
+	}
+	return( -1 );
+}
+
+/* Frees a scan chunk
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_scan_chunk_free(
+     libqcow_scan_chunk_t **scan_chunk,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_scan_chunk_free";
+
+	if( scan_chunk == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid scan chunk.",
+		 function );
+
+		return( -1 );
+	}
+	if( *scan_chunk != NULL )
+	{
+		if( ( *scan_chunk )->data != NULL )
+		{
+			memory_free(
+			 ( *scan_chunk )->data );
+		}
+		memory_free(
+		 *scan_chunk );
+
+		*scan_chunk = NULL;
+	}
+	return( 1 );
+}
+
+/* Creates a scanner
+ * Make sure the value scanner is referencing, is set to NULL
+ * A number of threads of 0 represents the default number of threads
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_scanner_initialize(
+     libqcow_scanner_t **scanner,
+     libqcow_file_t *file,
+     int (*callback_function)(
+            off64_t offset,
+            const uint8_t *data,
+            size_t data_size,
+            void *callback_data ),
+     void *callback_data,
+     int number_of_threads,
+     uint8_t scan_flags,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_scanner_initialize";
+
+	if( scanner == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid scanner.",
+		 function );
+
+		return( -1 );
+	}
+	if( *scanner != NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_ALREADY_SET,
+		 "%s: invalid scanner value already set.",
+		 function );
+
+		return( -1 );
+	}
+	if( file == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid file.",
+		 function );
+
+		return( -1 );
+	}
+	if( callback_function == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid callback function.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( number_of_threads < 0 )
+	 || ( number_of_threads > LIBQCOW_SCAN_MAXIMUM_NUMBER_OF_THREADS ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid number of threads value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( scan_flags & ~( LIBQCOW_SCAN_FLAG_UNORDERED ) ) != 0 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_UNSUPPORTED_VALUE,
+		 "%s: unsupported scan flags: 0x%02" PRIx8 ".",
+		 function,
+		 scan_flags );
+
+		return( -1 );
+	}
+	if( number_of_threads == 0 )
+	{
+		number_of_threads = LIBQCOW_SCAN_NUMBER_OF_THREADS;
+	}
+	*scanner = memory_allocate_structure(
+	            libqcow_scanner_t );
+
+	if( *scanner == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_INSUFFICIENT,
+		 "%s: unable to create scanner.",
+		 function );
+
+		goto on_error;
+	}
+	if( memory_set(
+	     *scanner,
+	     0,
+	     sizeof( libqcow_scanner_t ) ) == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_SET_FAILED,
+		 "%s: unable to clear scanner.",
+		 function );
+
+		memory_free(
+		 *scanner );
+
+		*scanner = NULL;
+
+		return( -1 );
+	}
+	( *scanner )->file                     = file;
+	( *scanner )->callback_function        = callback_function;
+	( *scanner )->callback_data            = callback_data;
+	( *scanner )->scan_flags               = scan_flags;
+	( *scanner )->maximum_number_of_chunks = number_of_threads * LIBQCOW_SCAN_NUMBER_OF_CHUNKS_PER_THREAD;
+
+	/* The scan is stopped when the file is signalled to abort after the scanner was created
+	 */
+	if( libqcow_internal_file_get_abort_generation(
+	     (libqcow_internal_file_t *) file,
+	     &( ( *scanner )->abort_generation ),
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+		 "%s: unable to retrieve abort generation.",
+		 function );
+
+		goto on_error;
+	}
+	( *scanner )->read_chunks = (libqcow_scan_chunk_t **) memory_allocate(
+	                                                       sizeof( libqcow_scan_chunk_t * ) * ( *scanner )->maximum_number_of_chunks );
+
+	if( ( *scanner )->read_chunks == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_INSUFFICIENT,
+		 "%s: unable to create read chunks.",
+		 function );
+
+		goto on_error;
+	}
+	if( memory_set(
+	     ( *scanner )->read_chunks,
+	     0,
+	     sizeof( libqcow_scan_chunk_t * ) * ( *scanner )->maximum_number_of_chunks ) == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_SET_FAILED,
+		 "%s: unable to clear read chunks.",
+		 function );
+
+		goto on_error;
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_mutex_initialize(
+	     &( ( *scanner )->mutex ),
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+		 "%s: unable to initialize mutex.",
+		 function );
+
+		goto on_error;
+	}
+	if( libcthreads_condition_initialize(
+	     &( ( *scanner )->condition ),
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+		 "%s: unable to initialize condition.",
+		 function );
+
+		goto on_error;
+	}
+	/* Since no more than the maximum number of chunks is pushed the push does not block
+	 */
+	( *scanner )->scheduler = ( (libqcow_internal_file_t *) file )->scheduler;
+
+	if( ( *scanner )->scheduler != NULL )
+	{
+		if( libqcow_scheduler_queue_initialize(
+		     &( ( *scanner )->scheduler_queue ),
+		     ( *scanner )->maximum_number_of_chunks,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+			 "%s: unable to create scheduler queue.",
+			 function );
+
+			goto on_error;
+		}
+	}
+	else if( libcthreads_thread_pool_create(
+	          &( ( *scanner )->read_thread_pool ),
+	          NULL,
+	          number_of_threads,
+	          ( *scanner )->maximum_number_of_chunks,
+	          (int (*)(intptr_t *, void *)) &libqcow_scanner_read_chunk_callback,
+	          (void *) *scanner,
+	          error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+		 "%s: unable to create read thread pool.",
+		 function );
+
+		goto on_error;
+	}
+#endif
+	return( 1 );
+
+on_error:
+	if( *scanner != NULL )
+	{
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+		if( ( *scanner )->condition != NULL )
+		{
+			libcthreads_condition_free(
+			 &( ( *scanner )->condition ),
+			 NULL );
+		}
+		if( ( *scanner )->mutex != NULL )
+		{
+			libcthreads_mutex_free(
+			 &( ( *scanner )->mutex ),
+			 NULL );
+		}
+#endif
+		if( ( *scanner )->read_chunks != NULL )
+		{
+			memory_free(
+			 ( *scanner )->read_chunks );
+		}
+		memory_free(
+		 *scanner );
+
+		*scanner = NULL;
+	}
+	return( -1 );
+}
+
+/* Frees a scanner
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_scanner_free(
+     libqcow_scanner_t **scanner,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_scanner_free";
+	int chunk_slot_index  = 0;
+	int result            = 1;
+
+	if( scanner == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid scanner.",
+		 function );
+
+		return( -1 );
+	}
+	if( *scanner != NULL )
+	{
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+		/* The read thread pool and scheduler queue are normally finalized by finalize
+		 */
+		if( ( *scanner )->read_thread_pool != NULL )
+		{
+			if( libcthreads_thread_pool_join(
+			     &( ( *scanner )->read_thread_pool ),
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+				 "%s: unable to join read thread pool.",
+				 function );
+
+				result = -1;
+			}
+		}
+		if( ( *scanner )->scheduler_queue != NULL )
+		{
+			if( libqcow_scheduler_wait_for_queue(
+			     ( *scanner )->scheduler,
+			     ( *scanner )->scheduler_queue,
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+				 "%s: unable to wait for scheduler queue.",
+				 function );
+
+				result = -1;
+			}
+			else if( libqcow_scheduler_queue_free(
+			          &( ( *scanner )->scheduler_queue ),
+			          error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+				 "%s: unable to free scheduler queue.",
+				 function );
+
+				result = -1;
+			}
+		}
+		if( libcthreads_condition_free(
+		     &( ( *scanner )->condition ),
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+			 "%s: unable to free condition.",
+			 function );
+
+			result = -1;
+		}
+		if( libcthreads_mutex_free(
+		     &( ( *scanner )->mutex ),
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+			 "%s: unable to free mutex.",
+			 function );
+
+			result = -1;
+		}
+#endif
+		/* Chunks that were read after a chunk that could not be pushed
+		 * are never passed to the callback function
+		 */
+		for( chunk_slot_index = 0;
+		     chunk_slot_index < ( *scanner )->maximum_number_of_chunks;
+		     chunk_slot_index++ )
+		{
+			if( ( *scanner )->read_chunks[ chunk_slot_index ] != NULL )
+			{
+				libqcow_scan_chunk_free(
+				 &( ( *scanner )->read_chunks[ chunk_slot_index ] ),
+				 NULL );
+			}
+		}
+		memory_free(
+		 ( *scanner )->read_chunks );
+
+		if( ( *scanner )->scan_error != NULL )
+		{
+			libcerror_error_free(
+			 &( ( *scanner )->scan_error ) );
+		}
+		memory_free(
+		 *scanner );
+
+		*scanner = NULL;
+	}
+	return( result );
+}
+
+/* Pushes a chunk to be read and passed to the callback function
+ * The push blocks while the maximum number of chunks is read or waits to be passed to the callback function
+ * Returns 1 if successful, 0 if the scan was stopped or failed or -1 on error
+ */
+int libqcow_scanner_push_chunk(
+     libqcow_scanner_t *scanner,
+     off64_t offset,
+     size_t data_size,
+     libcerror_error_t **error )
+{
+	libqcow_scan_chunk_t *scan_chunk = NULL;
+	static char *function            = "libqcow_scanner_push_chunk";
+	int result                       = 1;
+
+	if( scanner == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid scanner.",
+		 function );
+
+		return( -1 );
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( ( scanner->read_thread_pool == NULL )
+	 && ( scanner->scheduler_queue == NULL ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: invalid scanner - missing read thread pool and scheduler queue.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	if( libqcow_scan_chunk_initialize(
+	     &scan_chunk,
+	     offset,
+	     data_size,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+		 "%s: unable to create scan chunk.",
+		 function );
+
+		goto on_error;
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_mutex_grab(
+	     scanner->mutex,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab mutex.",
+		 function );
+
+		goto on_error;
+	}
+	while( ( scanner->number_of_chunks >= scanner->maximum_number_of_chunks )
+	    && ( scanner->is_stopped == 0 )
+	    && ( scanner->scan_error == NULL ) )
+	{
+		if( libcthreads_condition_wait(
+		     scanner->condition,
+		     scanner->mutex,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+			 "%s: unable to wait for condition.",
+			 function );
+
+			libcthreads_mutex_release(
+			 scanner->mutex,
+			 NULL );
+
+			goto on_error;
+		}
+	}
+#endif
+	if( ( scanner->is_stopped != 0 )
+	 || ( scanner->scan_error != NULL ) )
+	{
+		result = 0;
+	}
+	else
+	{
+		scan_chunk->chunk_index = scanner->next_chunk_index;
+
+		scanner->next_chunk_index += 1;
+		scanner->number_of_chunks += 1;
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_mutex_release(
+	     scanner->mutex,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release mutex.",
+		 function );
+
+		goto on_error;
+	}
+#endif
+	if( result == 0 )
+	{
+		libqcow_scan_chunk_free(
+		 &scan_chunk,
+		 NULL );
+
+		return( 0 );
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( scanner->scheduler_queue != NULL )
+	{
+		result = libqcow_scheduler_push_job(
+		          scanner->scheduler,
+		          scanner->scheduler_queue,
+		          (int (*)(intptr_t *, void *)) &libqcow_scanner_read_chunk_callback,
+		          (intptr_t *) scan_chunk,
+		          (void *) scanner,
+		          error );
+	}
+	else
+	{
+		result = libcthreads_thread_pool_push(
+		          scanner->read_thread_pool,
+		          (intptr_t *) scan_chunk,
+		          error );
+	}
+	if( result != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_APPEND_FAILED,
+		 "%s: unable to push scan chunk onto read threads.",
+		 function );
+
+		goto on_error;
+	}
+#else
+	/* The error of a chunk is retained by the scanner
+	 */
+	libqcow_scanner_read_chunk_callback(
+	 scan_chunk,
+	 scanner );
+#endif
+	return( 1 );
+
+on_error:
+	if( scan_chunk != NULL )
+	{
+		libqcow_scan_chunk_free(
+		 &scan_chunk,
+		 NULL );
+	}
+	return( -1 );
+}
+
+/* Reads a chunk from the read thread pool and passes the chunks that were read to the callback function
+ * The error of the first chunk that could not be read is retained by the scanner,
+ * chunks are no longer read after the scan was stopped or failed
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_scanner_read_chunk_callback(
+     libqcow_scan_chunk_t *scan_chunk,
+     libqcow_scanner_t *scanner )
+{
+	libcerror_error_t *error = NULL;
+	static char *function    = "libqcow_scanner_read_chunk_callback";
+	int result               = 1;
+
+	if( scan_chunk == NULL )
+	{
+		return( -1 );
+	}
+	if( scanner == NULL )
+	{
+		libqcow_scan_chunk_free(
+		 &scan_chunk,
+		 NULL );
+
+		return( -1 );
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_mutex_grab(
+	     scanner->mutex,
+	     &error ) != 1 )
+	{
+		result = -1;
+	}
+	else
+#endif
+	{
+		if( ( scanner->is_stopped != 0 )
+		 || ( scanner->scan_error != NULL ) )
+		{
+			result = 0;
+		}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+		if( libcthreads_mutex_release(
+		     scanner->mutex,
+		     &error ) != 1 )
+		{
+			result = -1;
+		}
+#endif
+	}
+	if( result == 1 )
+	{
+		result = libqcow_scanner_read_chunk(
+		          scanner,
+		          scan_chunk,
+		          &error );
+
+		if( result != 1 )
+		{
+			libcerror_error_set(
+			 &error,
+			 LIBCERROR_ERROR_DOMAIN_IO,
+			 LIBCERROR_IO_ERROR_READ_FAILED,
+			 "%s: unable to read chunk at offset: %" PRIi64 " (0x%08" PRIx64 ").",
+			 function,
+			 scan_chunk->offset,
+			 scan_chunk->offset );
+		}
+	}
+	if( error != NULL )
+	{
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+		if( libcthreads_mutex_grab(
+		     scanner->mutex,
+		     NULL ) == 1 )
+#endif
+		{
+			if( scanner->scan_error == NULL )
+			{
+				scanner->scan_error = error;
+
+				error = NULL;
+			}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+			libcthreads_mutex_release(
+			 scanner->mutex,
+			 NULL );
+#endif
+		}
+		if( error != NULL )
+		{
+			libcerror_error_free(
+			 &error );
+		}
+	}
+	/* A chunk that was not read is completed for the callback function to pass over it
+	 */
+	if( libqcow_scanner_complete_chunk(
+	     scanner,
+	     scan_chunk,
+	     NULL ) != 1 )
+	{
+		return( -1 );
+	}
+	if( result == -1 )
+	{
+		return( -1 );
+	}
+	return( 1 );
+}
+
+/* Reads the data of a chunk
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_scanner_read_chunk(
+     libqcow_scanner_t *scanner,
+     libqcow_scan_chunk_t *scan_chunk,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_scanner_read_chunk";
+	ssize_t read_count    = 0;
+
+	if( scanner == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid scanner.",
+		 function );
+
+		return( -1 );
+	}
+	if( scan_chunk == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid scan chunk.",
+		 function );
+
+		return( -1 );
+	}
+	read_count = libqcow_internal_file_read_buffer_at_offset(
+	              (libqcow_internal_file_t *) scanner->file,
+	              scan_chunk->data,
+	              scan_chunk->data_size,
+	              scan_chunk->offset,
+	              NULL,
+	              scanner->abort_generation,
+	              error );
+
+	if( read_count != (ssize_t) scan_chunk->data_size )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_IO,
+		 LIBCERROR_IO_ERROR_READ_FAILED,
+		 "%s: unable to read buffer.",
+		 function );
+
+		return( -1 );
+	}
+	return( 1 );
+}
+
+/* Completes a chunk and passes the chunks that were read to the callback function
+ * The scanner takes over management of the chunk
+ * Only one thread at a time calls the callback function, other threads hand over their chunk
+ * and continue reading. For an ordered scan the chunks are passed in order of the chunk index
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_scanner_complete_chunk(
+     libqcow_scanner_t *scanner,
+     libqcow_scan_chunk_t *scan_chunk,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_scanner_complete_chunk";
+	int callback_result   = 0;
+	int chunk_slot_index  = 0;
+	int result            = 1;
+
+	if( scanner == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid scanner.",
+		 function );
+
+		return( -1 );
+	}
+	if( scan_chunk == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid scan chunk.",
+		 function );
+
+		return( -1 );
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_mutex_grab(
+	     scanner->mutex,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab mutex.",
+		 function );
+
+		libqcow_scan_chunk_free(
+		 &scan_chunk,
+		 NULL );
+
+		return( -1 );
+	}
+#endif
+	/* The chunks that are read or wait to be passed to the callback function
+	 * never exceed the maximum number of chunks hence a slot is always available
+	 */
+	if( ( scanner->scan_flags & LIBQCOW_SCAN_FLAG_UNORDERED ) == 0 )
+	{
+		chunk_slot_index = (int) ( scan_chunk->chunk_index % (uint64_t) scanner->maximum_number_of_chunks );
+	}
+	else
+	{
+		for( chunk_slot_index = 0;
+		     chunk_slot_index < scanner->maximum_number_of_chunks;
+		     chunk_slot_index++ )
+		{
+			if( scanner->read_chunks[ chunk_slot_index ] == NULL )
+			{
+				break;
+			}
+		}
+	}
+	if( ( chunk_slot_index >= scanner->maximum_number_of_chunks )
+	 || ( scanner->read_chunks[ chunk_slot_index ] != NULL ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_ALREADY_SET,
+		 "%s: invalid scanner - missing available read chunk slot.",
+		 function );
+
+		libqcow_scan_chunk_free(
+		 &scan_chunk,
+		 NULL );
+
+		result = -1;
+	}
+	else
+	{
+		scanner->read_chunks[ chunk_slot_index ] = scan_chunk;
+
+		scan_chunk = NULL;
+	}
+	if( ( result == 1 )
+	 && ( scanner->is_calling_back == 0 ) )
+	{
+		scanner->is_calling_back = 1;
+
+		while( result == 1 )
+		{
+			if( ( scanner->scan_flags & LIBQCOW_SCAN_FLAG_UNORDERED ) == 0 )
+			{
+				chunk_slot_index = (int) ( scanner->next_callback_chunk_index % (uint64_t) scanner->maximum_number_of_chunks );
+			}
+			else
+			{
+				for( chunk_slot_index = 0;
+				     chunk_slot_index < scanner->maximum_number_of_chunks;
+				     chunk_slot_index++ )
+				{
+					if( scanner->read_chunks[ chunk_slot_index ] != NULL )
+					{
+						break;
+					}
+				}
+				if( chunk_slot_index >= scanner->maximum_number_of_chunks )
+				{
+					break;
+				}
+			}
+			scan_chunk = scanner->read_chunks[ chunk_slot_index ];
+
+			if( scan_chunk == NULL )
+			{
+				break;
+			}
+			scanner->read_chunks[ chunk_slot_index ] = NULL;
+
+			callback_result = 1;
+
+			if( ( scanner->is_stopped != 0 )
+			 || ( scanner->scan_error != NULL ) )
+			{
+				callback_result = 0;
+			}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+			/* The callback function is called without holding the mutex
+			 * so that the other threads can continue to read chunks
+			 */
+			if( libcthreads_mutex_release(
+			     scanner->mutex,
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+				 "%s: unable to release mutex.",
+				 function );
+
+				libqcow_scan_chunk_free(
+				 &scan_chunk,
+				 NULL );
+
+				return( -1 );
+			}
+#endif
+			if( callback_result == 1 )
+			{
+				callback_result = scanner->callback_function(
+				                   scan_chunk->offset,
+				                   scan_chunk->data,
+				                   scan_chunk->data_size,
+				                   scanner->callback_data );
+			}
+			else
+			{
+				callback_result = 1;
+			}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+			if( libcthreads_mutex_grab(
+			     scanner->mutex,
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+				 "%s: unable to grab mutex.",
+				 function );
+
+				libqcow_scan_chunk_free(
+				 &scan_chunk,
+				 NULL );
+
+				return( -1 );
+			}
+#endif
+			if( callback_result == 0 )
+			{
+				scanner->is_stopped = 1;
+			}
+			else if( ( callback_result != 1 )
+			      && ( scanner->scan_error == NULL ) )
+			{
+				libcerror_error_set(
+				 &( scanner->scan_error ),
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_GENERIC,
+				 "%s: callback function failed for chunk at offset: %" PRIi64 " (0x%08" PRIx64 ").",
+				 function,
+				 scan_chunk->offset,
+				 scan_chunk->offset );
+			}
+			libqcow_scan_chunk_free(
+			 &scan_chunk,
+			 NULL );
+
+			scanner->next_callback_chunk_index += 1;
+			scanner->number_of_chunks          -= 1;
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+			if( libcthreads_condition_broadcast(
+			     scanner->condition,
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+				 "%s: unable to broadcast condition.",
+				 function );
+
+				result = -1;
+			}
+#endif
+		}
+		scanner->is_calling_back = 0;
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_mutex_release(
+	     scanner->mutex,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release mutex.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	return( result );
+}
+
+/* Finalizes the scan
+ * Waits for the chunks that were pushed to be read and passed to the callback function
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_scanner_finalize(
+     libqcow_scanner_t *scanner,
+     libcerror_error_t **error )
+{
+	libcerror_error_t *scan_error = NULL;
+	static char *function         = "libqcow_scanner_finalize";
+
+	if( scanner == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid scanner.",
+		 function );
+
+		return( -1 );
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( scanner->read_thread_pool != NULL )
+	{
+		if( libcthreads_thread_pool_join(
+		     &( scanner->read_thread_pool ),
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+			 "%s: unable to join read thread pool.",
+			 function );
+
+			return( -1 );
+		}
+	}
+	if( scanner->scheduler_queue != NULL )
+	{
+		if( libqcow_scheduler_wait_for_queue(
+		     scanner->scheduler,
+		     scanner->scheduler_queue,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+			 "%s: unable to wait for scheduler queue.",
+			 function );
+
+			return( -1 );
+		}
+		if( libqcow_scheduler_queue_free(
+		     &( scanner->scheduler_queue ),
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+			 "%s: unable to free scheduler queue.",
+			 function );
+
+			return( -1 );
+		}
+	}
+#endif
+	/* After the join no thread references the scanner
+	 */
+	if( scanner->scan_error != NULL )
+	{
+		scan_error = scanner->scan_error;
+
+		scanner->scan_error = NULL;
+
+		if( ( error != NULL )
+		 && ( *error == NULL ) )
+		{
+			*error = scan_error;
+
+			scan_error = NULL;
+		}
+		if( scan_error != NULL )
+		{
+			libcerror_error_free(
+			 &scan_error );
+		}
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+		 "%s: unable to scan chunk.",
+		 function );
+
+		return( -1 );
+	}
+	return( 1 );
+}
+
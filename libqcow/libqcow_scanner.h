@@ -0,0 +1,198 @@
+/*
+ * Scanner functions
+ *
+ * Copyright (C) 2010-2026, Joachim Metz <joachim.metz@gmail.com>
+ *
+ * Refer to AUTHORS for acknowledgements.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#if !defined( _LIBQCOW_SCANNER_H )
+#define _LIBQCOW_SCANNER_H
+
+#include <common.h>
+#include <types.h>
+
+#include "libqcow_libcerror.h"
+#include "libqcow_libcthreads.h"
+#include "libqcow_scheduler.h"
+#include "libqcow_types.h"
+
+#if defined( __cplusplus )
+extern "C" {
+#endif
+
+typedef struct libqcow_scan_chunk libqcow_scan_chunk_t;
+
+struct libqcow_scan_chunk
+{
+	/* The index of the chunk in order of the (storage media) offset
+	 */
+	uint64_t chunk_index;
+
+	/* The (storage media) offset of the chunk
+	 */
+	off64_t offset;
+
+	/* The data
+	 */
+	uint8_t *data;
+
+	/* The data size
+	 */
+	size_t data_size;
+};
+
+typedef struct libqcow_scanner libqcow_scanner_t;
+
+struct libqcow_scanner
+{
+	/* The file that is scanned
+	 */
+	libqcow_file_t *file;
+
+	/* The abort generation of the file when the scanner was created
+	 */
+	uint32_t abort_generation;
+
+	/* The callback function
+	 */
+	int (*callback_function)(
+	       off64_t offset,
+	       const uint8_t *data,
+	       size_t data_size,
+	       void *callback_data );
+
+	/* The callback data
+	 */
+	void *callback_data;
+
+	/* The scan flags
+	 */
+	uint8_t scan_flags;
+
+	/* The maximum number of chunks that are read or wait to be passed to the callback function
+	 */
+	int maximum_number_of_chunks;
+
+	/* The number of chunks that are read or wait to be passed to the callback function
+	 */
+	int number_of_chunks;
+
+	/* The chunks that were read and wait to be passed to the callback function
+	 * For an ordered scan the chunk is stored at its chunk index modulo the maximum number of chunks
+	 */
+	libqcow_scan_chunk_t **read_chunks;
+
+	/* The index of the next chunk that is pushed
+	 */
+	uint64_t next_chunk_index;
+
+	/* The index of the next chunk that is passed to the callback function
+	 */
+	uint64_t next_callback_chunk_index;
+
+	/* Value to indicate a thread is passing chunks to the callback function
+	 */
+	uint8_t is_calling_back;
+
+	/* Value to indicate the callback function stopped the scan
+	 */
+	uint8_t is_stopped;
+
+	/* The error of the first chunk that could not be read or passed to the callback function
+	 */
+	libcerror_error_t *scan_error;
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	/* The thread pool that reads the chunks if the file has no scheduler
+	 */
+	libcthreads_thread_pool_t *read_thread_pool;
+
+	/* The scheduler of the file
+	 */
+	libqcow_scheduler_t *scheduler;
+
+	/* The scheduler queue that contains the chunks to be read if the file has a scheduler
+	 */
+	libqcow_scheduler_queue_t *scheduler_queue;
+
+	/* The mutex that protects the chunk and state values
+	 */
+	libcthreads_mutex_t *mutex;
+
+	/* The condition that is signalled when a chunk was passed to the callback function
+	 */
+	libcthreads_condition_t *condition;
+#endif
+};
+
+int libqcow_scan_chunk_initialize(
+     libqcow_scan_chunk_t **scan_chunk,
+     off64_t offset,
+     size_t data_size,
+     libcerror_error_t **error );
+
+int libqcow_scan_chunk_free(
+     libqcow_scan_chunk_t **scan_chunk,
+     libcerror_error_t **error );
+
+int libqcow_scanner_initialize(
+     libqcow_scanner_t **scanner,
+     libqcow_file_t *file,
+     int (*callback_function)(
+            off64_t offset,
+            const uint8_t *data,
+            size_t data_size,
+            void *callback_data ),
+     void *callback_data,
+     int number_of_threads,
+     uint8_t scan_flags,
+     libcerror_error_t **error );
+
+int libqcow_scanner_free(
+     libqcow_scanner_t **scanner,
+     libcerror_error_t **error );
+
+int libqcow_scanner_push_chunk(
+     libqcow_scanner_t *scanner,
+     off64_t offset,
+     size_t data_size,
+     libcerror_error_t **error );
+
+int libqcow_scanner_read_chunk_callback(
+     libqcow_scan_chunk_t *scan_chunk,
+     libqcow_scanner_t *scanner );
+
+int libqcow_scanner_read_chunk(
+     libqcow_scanner_t *scanner,
+     libqcow_scan_chunk_t *scan_chunk,
+     libcerror_error_t **error );
+
+int libqcow_scanner_complete_chunk(
+     libqcow_scanner_t *scanner,
+     libqcow_scan_chunk_t *scan_chunk,
+     libcerror_error_t **error );
+
+int libqcow_scanner_finalize(
+     libqcow_scanner_t *scanner,
+     libcerror_error_t **error );
+
+#if defined( __cplusplus )
+}
+#endif
+
+#endif /* !defined( _LIBQCOW_SCANNER_H ) */
+
@@ -0,0 +1,2506 @@
+/*
+ * Scheduler functions
+ *
+ * Copyright (C) 2010-2026, Joachim Metz <joachim.metz@gmail.com>
+ *
+ * Refer to AUTHORS for acknowledgements.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <common.h>
+#include <memory.h>
+#include <types.h>
+
+#include "libqcow_definitions.h"
+#include "libqcow_libcerror.h"
+#include "libqcow_libcthreads.h"
+#include "libqcow_scheduler.h"
+#include "libqcow_types.h"
+
+/* Creates a scheduler
+ * Make sure the value scheduler is referencing, is set to NULL
+ * A number of threads of 0 represents the default number of threads
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_scheduler_initialize(
+     libqcow_scheduler_t **scheduler,
+     int number_of_threads,
+     libcerror_error_t **error )
+{
+	libqcow_internal_scheduler_t *internal_scheduler = NULL;
+	static char *function                            = "libqcow_scheduler_initialize";
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	int worker_index                                 = 0;
+#endif
+
+	if( scheduler == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid scheduler.",
+		 function );
+
+		return( -1 );
+	}
+	if( *scheduler != NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_ALREADY_SET,
+		 "%s: invalid scheduler value already set.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( number_of_threads < 0 )
+	 || ( number_of_threads > LIBQCOW_SCHEDULER_MAXIMUM_NUMBER_OF_THREADS ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid number of threads value out of bounds.",
+		 function );
+
+		return( -1 );
+	}
+	if( number_of_threads == 0 )
+	{
+		number_of_threads = LIBQCOW_SCHEDULER_NUMBER_OF_THREADS;
+	}
+	internal_scheduler = memory_allocate_structure(
+	                      libqcow_internal_scheduler_t );
+
+	if( internal_scheduler == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_INSUFFICIENT,
+		 "%s: unable to create scheduler.",
+		 function );
+
+		goto on_error;
+	}
+	if( memory_set(
+	     internal_scheduler,
+	     0,
+	     sizeof( libqcow_internal_scheduler_t ) ) == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_SET_FAILED,
+		 "%s: unable to clear scheduler.",
+		 function );
+
+		memory_free(
+		 internal_scheduler );
+
+		return( -1 );
+	}
+	internal_scheduler->number_of_threads    = number_of_threads;
+	internal_scheduler->number_of_references = 1;
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_mutex_initialize(
+	     &( internal_scheduler->mutex ),
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+		 "%s: unable to initialize mutex.",
+		 function );
+
+		goto on_error;
+	}
+	if( libcthreads_condition_initialize(
+	     &( internal_scheduler->job_condition ),
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+		 "%s: unable to initialize job condition.",
+		 function );
+
+		goto on_error;
+	}
+	internal_scheduler->workers = (libqcow_scheduler_worker_t *) memory_allocate(
+	                                                              sizeof( libqcow_scheduler_worker_t ) * number_of_threads );
+
+	if( internal_scheduler->workers == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_INSUFFICIENT,
+		 "%s: unable to create workers.",
+		 function );
+
+		goto on_error;
+	}
+	if( memory_set(
+	     internal_scheduler->workers,
+	     0,
+	     sizeof( libqcow_scheduler_worker_t ) * number_of_threads ) == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_SET_FAILED,
+		 "%s: unable to clear workers.",
+		 function );
+
+		memory_free(
+		 internal_scheduler->workers );
+
+		internal_scheduler->workers = NULL;
+
+		goto on_error;
+	}
+	for( worker_index = 0;
+	     worker_index < number_of_threads;
+	     worker_index++ )
+	{
+		internal_scheduler->workers[ worker_index ].internal_scheduler = internal_scheduler;
+		internal_scheduler->workers[ worker_index ].worker_index       = worker_index;
+
+		if( libcthreads_mutex_initialize(
+		     &( internal_scheduler->workers[ worker_index ].mutex ),
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+			 "%s: unable to initialize mutex of worker: %d.",
+			 function,
+			 worker_index );
+
+			goto on_error;
+		}
+	}
+	/* The threads are created once all the workers are initialized since
+	 * a thread steals from the deques of the other workers
+	 */
+	for( worker_index = 0;
+	     worker_index < number_of_threads;
+	     worker_index++ )
+	{
+		if( libcthreads_thread_create(
+		     &( internal_scheduler->workers[ worker_index ].thread ),
+		     NULL,
+		     (int (*)(void *)) &libqcow_scheduler_thread_callback,
+		     (void *) &( internal_scheduler->workers[ worker_index ] ),
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+			 "%s: unable to create thread: %d.",
+			 function,
+			 worker_index );
+
+			goto on_error;
+		}
+	}
+#endif
+	*scheduler = (libqcow_scheduler_t *) internal_scheduler;
+
+	return( 1 );
+
+on_error:
+	if( internal_scheduler != NULL )
+	{
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+		if( internal_scheduler->workers != NULL )
+		{
+			/* Stop the threads that were created
+			 */
+			if( libcthreads_mutex_grab(
+			     internal_scheduler->mutex,
+			     NULL ) == 1 )
+			{
+				internal_scheduler->is_stopping = 1;
+
+				libcthreads_condition_broadcast(
+				 internal_scheduler->job_condition,
+				 NULL );
+
+				libcthreads_mutex_release(
+				 internal_scheduler->mutex,
+				 NULL );
+			}
+			for( worker_index = 0;
+			     worker_index < number_of_threads;
+			     worker_index++ )
+			{
+				if( internal_scheduler->workers[ worker_index ].thread != NULL )
+				{
+					libcthreads_thread_join(
+					 &( internal_scheduler->workers[ worker_index ].thread ),
+					 NULL );
+				}
+			}
+			for( worker_index = 0;
+			     worker_index < number_of_threads;
+			     worker_index++ )
+			{
+				if( internal_scheduler->workers[ worker_index ].mutex != NULL )
+				{
+					libcthreads_mutex_free(
+					 &( internal_scheduler->workers[ worker_index ].mutex ),
+					 NULL );
+				}
+			}
+			memory_free(
+			 internal_scheduler->workers );
+		}
+		if( internal_scheduler->job_condition != NULL )
+		{
+			libcthreads_condition_free(
+			 &( internal_scheduler->job_condition ),
+			 NULL );
+		}
+		if( internal_scheduler->mutex != NULL )
+		{
+			libcthreads_mutex_free(
+			 &( internal_scheduler->mutex ),
+			 NULL );
+		}
+#endif
+		memory_free(
+		 internal_scheduler );
+	}
+	return( -1 );
+}
+
+/* Frees a scheduler
+ * Releases a reference to the scheduler, the threads of the scheduler
+ * are stopped and the scheduler is freed when the last reference is released
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_scheduler_free(
+     libqcow_scheduler_t **scheduler,
+     libcerror_error_t **error )
+{
+	libqcow_internal_scheduler_t *internal_scheduler = NULL;
+	static char *function                            = "libqcow_scheduler_free";
+	int number_of_references                         = 0;
+	int result                                       = 1;
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	int worker_index                                 = 0;
+#endif
+
+	if( scheduler == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid scheduler.",
+		 function );
+
+		return( -1 );
+	}
+	if( *scheduler == NULL )
+	{
+		return( 1 );
+	}
+	internal_scheduler = (libqcow_internal_scheduler_t *) *scheduler;
+	*scheduler         = NULL;
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_mutex_grab(
+	     internal_scheduler->mutex,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab mutex.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	internal_scheduler->number_of_references -= 1;
+
+	number_of_references = internal_scheduler->number_of_references;
+
+	if( number_of_references == 0 )
+	{
+		internal_scheduler->is_stopping = 1;
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+		if( libcthreads_condition_broadcast(
+		     internal_scheduler->job_condition,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+			 "%s: unable to broadcast job condition.",
+			 function );
+
+			result = -1;
+		}
+#endif
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_mutex_release(
+	     internal_scheduler->mutex,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release mutex.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	if( number_of_references > 0 )
+	{
+		return( result );
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	/* The threads run the jobs that are still queued before they stop
+	 */
+	for( worker_index = 0;
+	     worker_index < internal_scheduler->number_of_threads;
+	     worker_index++ )
+	{
+		if( libcthreads_thread_join(
+		     &( internal_scheduler->workers[ worker_index ].thread ),
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+			 "%s: unable to join thread: %d.",
+			 function,
+			 worker_index );
+
+			result = -1;
+		}
+	}
+	for( worker_index = 0;
+	     worker_index < internal_scheduler->number_of_threads;
+	     worker_index++ )
+	{
+		if( libcthreads_mutex_free(
+		     &( internal_scheduler->workers[ worker_index ].mutex ),
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+			 "%s: unable to free mutex of worker: %d.",
+			 function,
+			 worker_index );
+
+			result = -1;
+		}
+	}
+	memory_free(
+	 internal_scheduler->workers );
+
+	if( libcthreads_condition_free(
+	     &( internal_scheduler->job_condition ),
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+		 "%s: unable to free job condition.",
+		 function );
+
+		result = -1;
+	}
+	if( libcthreads_mutex_free(
+	     &( internal_scheduler->mutex ),
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+		 "%s: unable to free mutex.",
+		 function );
+
+		result = -1;
+	}
+#endif
+	memory_free(
+	 internal_scheduler );
+
+	return( result );
+}
+
+/* Adds a reference to a scheduler
+ * The reference is released by libqcow_scheduler_free
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_scheduler_reference(
+     libqcow_scheduler_t *scheduler,
+     libcerror_error_t **error )
+{
+	libqcow_internal_scheduler_t *internal_scheduler = NULL;
+	static char *function                            = "libqcow_scheduler_reference";
+	int result                                       = 1;
+
+	if( scheduler == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid scheduler.",
+		 function );
+
+		return( -1 );
+	}
+	internal_scheduler = (libqcow_internal_scheduler_t *) scheduler;
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_mutex_grab(
+	     internal_scheduler->mutex,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab mutex.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	if( internal_scheduler->number_of_references == INT_MAX )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_EXCEEDS_MAXIMUM,
+		 "%s: invalid scheduler - number of references value exceeds maximum.",
+		 function );
+
+		result = -1;
+	}
+	else
+	{
+		internal_scheduler->number_of_references += 1;
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_mutex_release(
+	     internal_scheduler->mutex,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release mutex.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	return( result );
+}
+
+/* Retrieves the number of threads
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_scheduler_get_number_of_threads(
+     libqcow_scheduler_t *scheduler,
+     int *number_of_threads,
+     libcerror_error_t **error )
+{
+	libqcow_internal_scheduler_t *internal_scheduler = NULL;
+	static char *function                            = "libqcow_scheduler_get_number_of_threads";
+
+	if( scheduler == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid scheduler.",
+		 function );
+
+		return( -1 );
+	}
+	internal_scheduler = (libqcow_internal_scheduler_t *) scheduler;
+
+	if( number_of_threads == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid number of threads.",
+		 function );
+
+		return( -1 );
+	}
+	/* The number of threads does not change after initialization
+	 */
+	*number_of_threads = internal_scheduler->number_of_threads;
+
+	return( 1 );
+}
+
+/* Creates a scheduler queue
+ * Make sure the value scheduler_queue is referencing, is set to NULL
+ * A maximum number of queued jobs of 0 represents no maximum
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_scheduler_queue_initialize(
+     libqcow_scheduler_queue_t **scheduler_queue,
+     int maximum_number_of_queued_jobs,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_scheduler_queue_initialize";
+
+	if( scheduler_queue == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid scheduler queue.",
+		 function );
+
+		return( -1 );
+	}
+	if( *scheduler_queue != NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_ALREADY_SET,
+		 "%s: invalid scheduler queue value already set.",
+		 function );
+
+		return( -1 );
+	}
+	if( maximum_number_of_queued_jobs < 0 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_VALUE_LESS_THAN_ZERO,
+		 "%s: invalid maximum number of queued jobs value less than zero.",
+		 function );
+
+		return( -1 );
+	}
+	*scheduler_queue = memory_allocate_structure(
+	                    libqcow_scheduler_queue_t );
+
+	if( *scheduler_queue == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_INSUFFICIENT,
+		 "%s: unable to create scheduler queue.",
+		 function );
+
+		goto on_error;
+	}
+	if( memory_set(
+	     *scheduler_queue,
+	     0,
+	     sizeof( libqcow_scheduler_queue_t ) ) == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_SET_FAILED,
+		 "%s: unable to clear scheduler queue.",
+		 function );
+
+		memory_free(
+		 *scheduler_queue );
+
+		*scheduler_queue = NULL;
+
+		return( -1 );
+	}
+	( *scheduler_queue )->maximum_number_of_queued_jobs = maximum_number_of_queued_jobs;
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_mutex_initialize(
+	     &( ( *scheduler_queue )->mutex ),
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+		 "%s: unable to initialize mutex.",
+		 function );
+
+		goto on_error;
+	}
+	if( libcthreads_condition_initialize(
+	     &( ( *scheduler_queue )->condition ),
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+		 "%s: unable to initialize condition.",
+		 function );
+
+		goto on_error;
+	}
+#endif
+	return( 1 );
+
+on_error:
+	if( *scheduler_queue != NULL )
+	{
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+		if( ( *scheduler_queue )->mutex != NULL )
+		{
+			libcthreads_mutex_free(
+			 &( ( *scheduler_queue )->mutex ),
+			 NULL );
+		}
+#endif
+		memory_free(
+		 *scheduler_queue );
+
+		*scheduler_queue = NULL;
+	}
+	return( -1 );
+}
+
+/* Frees a scheduler queue
+ * Use libqcow_scheduler_wait_for_queue to wait for the jobs of the queue to complete
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_scheduler_queue_free(
+     libqcow_scheduler_queue_t **scheduler_queue,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_scheduler_queue_free";
+	int result            = 1;
+
+	if( scheduler_queue == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid scheduler queue.",
+		 function );
+
+		return( -1 );
+	}
+	if( *scheduler_queue != NULL )
+	{
+		/* A queue with queued or running jobs or that is in the deque
+		 * of a worker is still referenced by the scheduler
+		 */
+		if( ( ( *scheduler_queue )->number_of_queued_jobs != 0 )
+		 || ( ( *scheduler_queue )->number_of_running_jobs != 0 )
+		 || ( ( *scheduler_queue )->is_ready != 0 ) )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+			 "%s: invalid scheduler queue - jobs still queued or running.",
+			 function );
+
+			return( -1 );
+		}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+		if( libcthreads_condition_free(
+		     &( ( *scheduler_queue )->condition ),
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+			 "%s: unable to free condition.",
+			 function );
+
+			result = -1;
+		}
+		if( libcthreads_mutex_free(
+		     &( ( *scheduler_queue )->mutex ),
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+			 "%s: unable to free mutex.",
+			 function );
+
+			result = -1;
+		}
+#endif
+		memory_free(
+		 *scheduler_queue );
+
+		*scheduler_queue = NULL;
+	}
+	return( result );
+}
+
+/* Pushes a job onto a queue of the scheduler
+ * The push blocks while the maximum number of jobs is queued on the queue
+ * Without multi-thread support the job is run before the function returns
+ * The result of the callback function is not retained, the job is expected
+ * to retain its own result
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_scheduler_push_job(
+     libqcow_scheduler_t *scheduler,
+     libqcow_scheduler_queue_t *scheduler_queue,
+     int (*callback_function)(
+            intptr_t *value,
+            void *arguments ),
+     intptr_t *value,
+     void *arguments,
+     libcerror_error_t **error )
+{
+	libqcow_internal_scheduler_t *internal_scheduler = NULL;
+	static char *function                            = "libqcow_scheduler_push_job";
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	libqcow_scheduler_job_t *scheduler_job           = NULL;
+	uint8_t queue_is_ready                           = 0;
+#endif
+
+	if( scheduler == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid scheduler.",
+		 function );
+
+		return( -1 );
+	}
+	internal_scheduler = (libqcow_internal_scheduler_t *) scheduler;
+
+	if( scheduler_queue == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid scheduler queue.",
+		 function );
+
+		return( -1 );
+	}
+	if( callback_function == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid callback function.",
+		 function );
+
+		return( -1 );
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	scheduler_job = memory_allocate_structure(
+	                 libqcow_scheduler_job_t );
+
+	if( scheduler_job == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_INSUFFICIENT,
+		 "%s: unable to create scheduler job.",
+		 function );
+
+		return( -1 );
+	}
+	if( memory_set(
+	     scheduler_job,
+	     0,
+	     sizeof( libqcow_scheduler_job_t ) ) == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_SET_FAILED,
+		 "%s: unable to clear scheduler job.",
+		 function );
+
+		memory_free(
+		 scheduler_job );
+
+		return( -1 );
+	}
+	scheduler_job->callback_function = callback_function;
+	scheduler_job->value             = value;
+	scheduler_job->arguments         = arguments;
+
+	if( libqcow_scheduler_queue_append_job(
+	     scheduler_queue,
+	     scheduler_job,
+	     &queue_is_ready,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_APPEND_FAILED,
+		 "%s: unable to append job to queue.",
+		 function );
+
+		memory_free(
+		 scheduler_job );
+
+		return( -1 );
+	}
+	/* The job is owned by the queue once it was appended
+	 */
+	if( queue_is_ready != 0 )
+	{
+		if( libqcow_scheduler_add_ready_queue(
+		     internal_scheduler,
+		     NULL,
+		     scheduler_queue,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_APPEND_FAILED,
+			 "%s: unable to add queue to the deque of a worker.",
+			 function );
+
+			return( -1 );
+		}
+	}
+	return( 1 );
+#else
+	if( internal_scheduler->is_stopping != 0 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_OUT_OF_BOUNDS,
+		 "%s: invalid scheduler - stopping.",
+		 function );
+
+		return( -1 );
+	}
+	callback_function(
+	 value,
+	 arguments );
+
+	return( 1 );
+#endif
+}
+
+/* Waits for the jobs that were pushed onto a queue of the scheduler to complete
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_scheduler_wait_for_queue(
+     libqcow_scheduler_t *scheduler,
+     libqcow_scheduler_queue_t *scheduler_queue,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_scheduler_wait_for_queue";
+
+	if( scheduler == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid scheduler.",
+		 function );
+
+		return( -1 );
+	}
+	if( scheduler_queue == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid scheduler queue.",
+		 function );
+
+		return( -1 );
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_mutex_grab(
+	     scheduler_queue->mutex,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab mutex.",
+		 function );
+
+		return( -1 );
+	}
+	/* The queue is referenced by a worker until the worker takes it from its deque
+	 * and finds no queued jobs
+	 */
+	while( ( scheduler_queue->number_of_queued_jobs != 0 )
+	    || ( scheduler_queue->number_of_running_jobs != 0 )
+	    || ( scheduler_queue->is_ready != 0 ) )
+	{
+		if( libcthreads_condition_wait(
+		     scheduler_queue->condition,
+		     scheduler_queue->mutex,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+			 "%s: unable to wait for condition.",
+			 function );
+
+			libcthreads_mutex_release(
+			 scheduler_queue->mutex,
+			 NULL );
+
+			return( -1 );
+		}
+	}
+	if( libcthreads_mutex_release(
+	     scheduler_queue->mutex,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release mutex.",
+		 function );
+
+		return( -1 );
+	}
+#endif
+	return( 1 );
+}
+
+/* Creates a scheduler batch
+ * A batch tracks the completion of a group of jobs that are pushed onto a queue of the scheduler
+ * Make sure the value scheduler_batch is referencing, is set to NULL
+ * A scheduler value of NULL represents that the jobs are run when they are pushed
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_scheduler_batch_initialize(
+     libqcow_scheduler_batch_t **scheduler_batch,
+     libqcow_scheduler_t *scheduler,
+     libqcow_scheduler_queue_t *scheduler_queue,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_scheduler_batch_initialize";
+
+	if( scheduler_batch == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid scheduler batch.",
+		 function );
+
+		return( -1 );
+	}
+	if( *scheduler_batch != NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_ALREADY_SET,
+		 "%s: invalid scheduler batch value already set.",
+		 function );
+
+		return( -1 );
+	}
+	if( ( scheduler != NULL )
+	 && ( scheduler_queue == NULL ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid scheduler queue.",
+		 function );
+
+		return( -1 );
+	}
+	*scheduler_batch = memory_allocate_structure(
+	                    libqcow_scheduler_batch_t );
+
+	if( *scheduler_batch == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_INSUFFICIENT,
+		 "%s: unable to create scheduler batch.",
+		 function );
+
+		goto on_error;
+	}
+	if( memory_set(
+	     *scheduler_batch,
+	     0,
+	     sizeof( libqcow_scheduler_batch_t ) ) == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_SET_FAILED,
+		 "%s: unable to clear scheduler batch.",
+		 function );
+
+		memory_free(
+		 *scheduler_batch );
+
+		*scheduler_batch = NULL;
+
+		return( -1 );
+	}
+	( *scheduler_batch )->scheduler       = scheduler;
+	( *scheduler_batch )->scheduler_queue = scheduler_queue;
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( libcthreads_mutex_initialize(
+	     &( ( *scheduler_batch )->mutex ),
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+		 "%s: unable to initialize mutex.",
+		 function );
+
+		goto on_error;
+	}
+	if( libcthreads_condition_initialize(
+	     &( ( *scheduler_batch )->condition ),
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+		 "%s: unable to initialize condition.",
+		 function );
+
+		goto on_error;
+	}
+#endif
+	return( 1 );
+
+on_error:
+	if( *scheduler_batch != NULL )
+	{
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+		if( ( *scheduler_batch )->mutex != NULL )
+		{
+			libcthreads_mutex_free(
+			 &( ( *scheduler_batch )->mutex ),
+			 NULL );
+		}
+#endif
+		memory_free(
+		 *scheduler_batch );
+
+		*scheduler_batch = NULL;
+	}
+	return( -1 );
+}
+
+/* Frees a scheduler batch
+ * Waits for the jobs of the batch that did not complete
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_scheduler_batch_free(
+     libqcow_scheduler_batch_t **scheduler_batch,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_scheduler_batch_free";
+	int result            = 1;
+
+	if( scheduler_batch == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid scheduler batch.",
+		 function );
+
+		return( -1 );
+	}
+	if( *scheduler_batch != NULL )
+	{
+		if( ( *scheduler_batch )->number_of_jobs != 0 )
+		{
+			if( libqcow_scheduler_batch_wait(
+			     *scheduler_batch,
+			     error ) == -1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+				 "%s: unable to wait for jobs.",
+				 function );
+
+				return( -1 );
+			}
+		}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+		if( libcthreads_condition_free(
+		     &( ( *scheduler_batch )->condition ),
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+			 "%s: unable to free condition.",
+			 function );
+
+			result = -1;
+		}
+		if( libcthreads_mutex_free(
+		     &( ( *scheduler_batch )->mutex ),
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_FINALIZE_FAILED,
+			 "%s: unable to free mutex.",
+			 function );
+
+			result = -1;
+		}
+#endif
+		memory_free(
+		 *scheduler_batch );
+
+		*scheduler_batch = NULL;
+	}
+	return( result );
+}
+
+/* Pushes a job of a batch onto the queue of the scheduler
+ * Without a scheduler or multi-thread support the job is run before the function returns
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_scheduler_batch_push_job(
+     libqcow_scheduler_batch_t *scheduler_batch,
+     int (*callback_function)(
+            intptr_t *value,
+            void *arguments ),
+     intptr_t *value,
+     void *arguments,
+     libcerror_error_t **error )
+{
+	static char *function                  = "libqcow_scheduler_batch_push_job";
+	int result                             = 0;
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	libqcow_scheduler_job_t *scheduler_job = NULL;
+	uint8_t queue_is_ready                 = 0;
+#endif
+
+	if( scheduler_batch == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid scheduler batch.",
+		 function );
+
+		return( -1 );
+	}
+	if( callback_function == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid callback function.",
+		 function );
+
+		return( -1 );
+	}
+	if( scheduler_batch->number_of_jobs == INT_MAX )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_EXCEEDS_MAXIMUM,
+		 "%s: invalid scheduler batch - number of jobs value exceeds maximum.",
+		 function );
+
+		return( -1 );
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	if( scheduler_batch->scheduler != NULL )
+	{
+		scheduler_job = memory_allocate_structure(
+		                 libqcow_scheduler_job_t );
+
+		if( scheduler_job == NULL )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_MEMORY,
+			 LIBCERROR_MEMORY_ERROR_INSUFFICIENT,
+			 "%s: unable to create scheduler job.",
+			 function );
+
+			return( -1 );
+		}
+		if( memory_set(
+		     scheduler_job,
+		     0,
+		     sizeof( libqcow_scheduler_job_t ) ) == NULL )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_MEMORY,
+			 LIBCERROR_MEMORY_ERROR_SET_FAILED,
+			 "%s: unable to clear scheduler job.",
+			 function );
+
+			memory_free(
+			 scheduler_job );
+
+			return( -1 );
+		}
+		scheduler_job->callback_function = callback_function;
+		scheduler_job->value             = value;
+		scheduler_job->arguments         = arguments;
+		scheduler_job->batch             = scheduler_batch;
+
+		if( libqcow_scheduler_queue_append_job(
+		     scheduler_batch->scheduler_queue,
+		     scheduler_job,
+		     &queue_is_ready,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_APPEND_FAILED,
+			 "%s: unable to append job to queue.",
+			 function );
+
+			memory_free(
+			 scheduler_job );
+
+			return( -1 );
+		}
+		/* The job remains owned by the batch, the batch frees its jobs
+		 * when they have completed
+		 */
+		if( scheduler_batch->last_job == NULL )
+		{
+			scheduler_batch->first_job = scheduler_job;
+		}
+		else
+		{
+			scheduler_batch->last_job->next_batch_job = scheduler_job;
+		}
+		scheduler_batch->last_job        = scheduler_job;
+		scheduler_batch->number_of_jobs += 1;
+
+		if( queue_is_ready != 0 )
+		{
+			if( libqcow_scheduler_add_ready_queue(
+			     (libqcow_internal_scheduler_t *) scheduler_batch->scheduler,
+			     NULL,
+			     scheduler_batch->scheduler_queue,
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_APPEND_FAILED,
+				 "%s: unable to add queue to the deque of a worker.",
+				 function );
+
+				return( -1 );
+			}
+		}
+		return( 1 );
+	}
+#endif
+	result = callback_function(
+	          value,
+	          arguments );
+
+	scheduler_batch->number_of_jobs           += 1;
+	scheduler_batch->number_of_completed_jobs += 1;
+
+	if( result != 1 )
+	{
+		scheduler_batch->number_of_failed_jobs += 1;
+	}
+	return( 1 );
+}
+
+/* Waits for the jobs of a batch to complete
+ * The jobs of the batch that are still queued are taken from the queue and run
+ * by the calling thread, hence a batch does not wait for the workers to become
+ * available and the calling thread only runs jobs of its own batch
+ * The batch can be reused afterwards
+ * Returns 1 if all the jobs were successful, 0 if one or more jobs failed or -1 on error
+ */
+int libqcow_scheduler_batch_wait(
+     libqcow_scheduler_batch_t *scheduler_batch,
+     libcerror_error_t **error )
+{
+	static char *function                  = "libqcow_scheduler_batch_wait";
+	int number_of_failed_jobs              = 0;
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	libqcow_scheduler_job_t *next_job      = NULL;
+	libqcow_scheduler_job_t *scheduler_job = NULL;
+	int result                             = 0;
+#endif
+
+	if( scheduler_batch == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid scheduler batch.",
+		 function );
+
+		return( -1 );
+	}
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	for( scheduler_job = scheduler_batch->first_job;
+	     scheduler_job != NULL;
+	     scheduler_job = scheduler_job->next_batch_job )
+	{
+		result = libqcow_scheduler_queue_remove_job(
+		          scheduler_batch->scheduler_queue,
+		          scheduler_job,
+		          error );
+
+		if( result == -1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_REMOVE_FAILED,
+			 "%s: unable to remove job from queue.",
+			 function );
+
+			return( -1 );
+		}
+		else if( result != 0 )
+		{
+			result = scheduler_job->callback_function(
+			          scheduler_job->value,
+			          scheduler_job->arguments );
+
+			if( libqcow_scheduler_complete_job(
+			     scheduler_job,
+			     result,
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+				 "%s: unable to complete job.",
+				 function );
+
+				return( -1 );
+			}
+		}
+	}
+	if( libcthreads_mutex_grab(
+	     scheduler_batch->mutex,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab mutex.",
+		 function );
+
+		return( -1 );
+	}
+	while( scheduler_batch->number_of_completed_jobs < scheduler_batch->number_of_jobs )
+	{
+		if( libcthreads_condition_wait(
+		     scheduler_batch->condition,
+		     scheduler_batch->mutex,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+			 "%s: unable to wait for condition.",
+			 function );
+
+			libcthreads_mutex_release(
+			 scheduler_batch->mutex,
+			 NULL );
+
+			return( -1 );
+		}
+	}
+	number_of_failed_jobs = scheduler_batch->number_of_failed_jobs;
+
+	if( libcthreads_mutex_release(
+	     scheduler_batch->mutex,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release mutex.",
+		 function );
+
+		return( -1 );
+	}
+	/* The workers do not reference the jobs once they have completed
+	 */
+	scheduler_job = scheduler_batch->first_job;
+
+	while( scheduler_job != NULL )
+	{
+		next_job = scheduler_job->next_batch_job;
+
+		memory_free(
+		 scheduler_job );
+
+		scheduler_job = next_job;
+	}
+	scheduler_batch->first_job = NULL;
+	scheduler_batch->last_job  = NULL;
+#else
+	number_of_failed_jobs = scheduler_batch->number_of_failed_jobs;
+#endif
+	scheduler_batch->number_of_jobs           = 0;
+	scheduler_batch->number_of_completed_jobs = 0;
+	scheduler_batch->number_of_failed_jobs    = 0;
+
+	if( number_of_failed_jobs != 0 )
+	{
+		return( 0 );
+	}
+	return( 1 );
+}
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+
+/* Appends a job to a queue
+ * The append blocks while the maximum number of jobs is queued on the queue
+ * The queue is ready when it needs to be added to the deque of a worker
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_scheduler_queue_append_job(
+     libqcow_scheduler_queue_t *scheduler_queue,
+     libqcow_scheduler_job_t *scheduler_job,
+     uint8_t *queue_is_ready,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_scheduler_queue_append_job";
+
+	if( scheduler_queue == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid scheduler queue.",
+		 function );
+
+		return( -1 );
+	}
+	if( scheduler_job == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid scheduler job.",
+		 function );
+
+		return( -1 );
+	}
+	if( queue_is_ready == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid queue is ready.",
+		 function );
+
+		return( -1 );
+	}
+	if( libcthreads_mutex_grab(
+	     scheduler_queue->mutex,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab mutex.",
+		 function );
+
+		return( -1 );
+	}
+	while( ( scheduler_queue->maximum_number_of_queued_jobs != 0 )
+	    && ( scheduler_queue->number_of_queued_jobs >= scheduler_queue->maximum_number_of_queued_jobs ) )
+	{
+		if( libcthreads_condition_wait(
+		     scheduler_queue->condition,
+		     scheduler_queue->mutex,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+			 "%s: unable to wait for condition.",
+			 function );
+
+			libcthreads_mutex_release(
+			 scheduler_queue->mutex,
+			 NULL );
+
+			return( -1 );
+		}
+	}
+	scheduler_job->previous_job = scheduler_queue->last_job;
+	scheduler_job->next_job     = NULL;
+	scheduler_job->is_queued    = 1;
+
+	if( scheduler_queue->last_job == NULL )
+	{
+		scheduler_queue->first_job = scheduler_job;
+	}
+	else
+	{
+		scheduler_queue->last_job->next_job = scheduler_job;
+	}
+	scheduler_queue->last_job               = scheduler_job;
+	scheduler_queue->number_of_queued_jobs += 1;
+
+	/* A queue that is not in the deque of a worker becomes ready
+	 */
+	*queue_is_ready = 0;
+
+	if( scheduler_queue->is_ready == 0 )
+	{
+		scheduler_queue->is_ready = 1;
+
+		*queue_is_ready = 1;
+	}
+	if( libcthreads_mutex_release(
+	     scheduler_queue->mutex,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release mutex.",
+		 function );
+
+		return( -1 );
+	}
+	return( 1 );
+}
+
+/* Removes a job from a queue if the job is still queued
+ * Returns 1 if the job was removed, 0 if the job was no longer queued or -1 on error
+ */
+int libqcow_scheduler_queue_remove_job(
+     libqcow_scheduler_queue_t *scheduler_queue,
+     libqcow_scheduler_job_t *scheduler_job,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_scheduler_queue_remove_job";
+	int result            = 0;
+
+	if( scheduler_queue == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid scheduler queue.",
+		 function );
+
+		return( -1 );
+	}
+	if( scheduler_job == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid scheduler job.",
+		 function );
+
+		return( -1 );
+	}
+	if( libcthreads_mutex_grab(
+	     scheduler_queue->mutex,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab mutex.",
+		 function );
+
+		return( -1 );
+	}
+	if( scheduler_job->is_queued != 0 )
+	{
+		if( scheduler_job->previous_job == NULL )
+		{
+			scheduler_queue->first_job = scheduler_job->next_job;
+		}
+		else
+		{
+			scheduler_job->previous_job->next_job = scheduler_job->next_job;
+		}
+		if( scheduler_job->next_job == NULL )
+		{
+			scheduler_queue->last_job = scheduler_job->previous_job;
+		}
+		else
+		{
+			scheduler_job->next_job->previous_job = scheduler_job->previous_job;
+		}
+		scheduler_job->previous_job = NULL;
+		scheduler_job->next_job     = NULL;
+		scheduler_job->is_queued    = 0;
+
+		scheduler_queue->number_of_queued_jobs -= 1;
+
+		/* The queue remains in the deque of its worker until the worker
+		 * takes it and finds no queued jobs
+		 */
+		if( scheduler_queue->maximum_number_of_queued_jobs != 0 )
+		{
+			if( libcthreads_condition_broadcast(
+			     scheduler_queue->condition,
+			     error ) != 1 )
+			{
+				libcerror_error_set(
+				 error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+				 "%s: unable to broadcast condition.",
+				 function );
+
+				libcthreads_mutex_release(
+				 scheduler_queue->mutex,
+				 NULL );
+
+				return( -1 );
+			}
+		}
+		result = 1;
+	}
+	if( libcthreads_mutex_release(
+	     scheduler_queue->mutex,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release mutex.",
+		 function );
+
+		return( -1 );
+	}
+	return( result );
+}
+
+/* Adds a ready queue to the end of the deque of a worker
+ * A worker value of NULL represents the next worker in turn, so that the queues
+ * are spread over the workers
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_scheduler_add_ready_queue(
+     libqcow_internal_scheduler_t *internal_scheduler,
+     libqcow_scheduler_worker_t *scheduler_worker,
+     libqcow_scheduler_queue_t *scheduler_queue,
+     libcerror_error_t **error )
+{
+	static char *function = "libqcow_scheduler_add_ready_queue";
+	int result            = 1;
+
+	if( internal_scheduler == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid scheduler.",
+		 function );
+
+		return( -1 );
+	}
+	if( scheduler_queue == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid scheduler queue.",
+		 function );
+
+		return( -1 );
+	}
+	if( scheduler_worker == NULL )
+	{
+		if( libcthreads_mutex_grab(
+		     internal_scheduler->mutex,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+			 "%s: unable to grab mutex.",
+			 function );
+
+			return( -1 );
+		}
+		scheduler_worker = &( internal_scheduler->workers[ internal_scheduler->next_worker_index ] );
+
+		internal_scheduler->next_worker_index += 1;
+
+		if( internal_scheduler->next_worker_index >= internal_scheduler->number_of_threads )
+		{
+			internal_scheduler->next_worker_index = 0;
+		}
+		if( libcthreads_mutex_release(
+		     internal_scheduler->mutex,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+			 "%s: unable to release mutex.",
+			 function );
+
+			return( -1 );
+		}
+	}
+	if( libcthreads_mutex_grab(
+	     scheduler_worker->mutex,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab mutex of worker: %d.",
+		 function,
+		 scheduler_worker->worker_index );
+
+		return( -1 );
+	}
+	scheduler_queue->previous_ready_queue = scheduler_worker->last_ready_queue;
+	scheduler_queue->next_ready_queue     = NULL;
+
+	if( scheduler_worker->last_ready_queue == NULL )
+	{
+		scheduler_worker->first_ready_queue = scheduler_queue;
+	}
+	else
+	{
+		scheduler_worker->last_ready_queue->next_ready_queue = scheduler_queue;
+	}
+	scheduler_worker->last_ready_queue = scheduler_queue;
+
+	if( libcthreads_mutex_release(
+	     scheduler_worker->mutex,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release mutex of worker: %d.",
+		 function,
+		 scheduler_worker->worker_index );
+
+		return( -1 );
+	}
+	/* Wake up an idle thread, which takes the queue from the deque
+	 * of the worker if the worker is busy
+	 */
+	if( libcthreads_mutex_grab(
+	     internal_scheduler->mutex,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab mutex.",
+		 function );
+
+		return( -1 );
+	}
+	internal_scheduler->job_generation += 1;
+
+	if( internal_scheduler->number_of_waiting_threads > 0 )
+	{
+		if( libcthreads_condition_signal(
+		     internal_scheduler->job_condition,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+			 "%s: unable to signal job condition.",
+			 function );
+
+			result = -1;
+		}
+	}
+	if( libcthreads_mutex_release(
+	     internal_scheduler->mutex,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release mutex.",
+		 function );
+
+		return( -1 );
+	}
+	return( result );
+}
+
+/* Takes a ready queue from the front of the deque of the worker or, if the deque
+ * of the worker is empty, steals one from the end of the deque of another worker
+ * Returns 1 if successful, 0 if no queue is ready or -1 on error
+ */
+int libqcow_scheduler_take_ready_queue(
+     libqcow_internal_scheduler_t *internal_scheduler,
+     libqcow_scheduler_worker_t *scheduler_worker,
+     libqcow_scheduler_queue_t **scheduler_queue,
+     libcerror_error_t **error )
+{
+	libqcow_scheduler_queue_t *safe_scheduler_queue = NULL;
+	libqcow_scheduler_worker_t *victim_worker       = NULL;
+	static char *function                           = "libqcow_scheduler_take_ready_queue";
+	int victim_index                                = 0;
+	int worker_offset                               = 0;
+
+	if( internal_scheduler == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid scheduler.",
+		 function );
+
+		return( -1 );
+	}
+	if( scheduler_worker == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid scheduler worker.",
+		 function );
+
+		return( -1 );
+	}
+	if( scheduler_queue == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid scheduler queue.",
+		 function );
+
+		return( -1 );
+	}
+	for( worker_offset = 0;
+	     worker_offset < internal_scheduler->number_of_threads;
+	     worker_offset++ )
+	{
+		victim_index = ( scheduler_worker->worker_index + worker_offset ) % internal_scheduler->number_of_threads;
+		victim_worker = &( internal_scheduler->workers[ victim_index ] );
+
+		if( libcthreads_mutex_grab(
+		     victim_worker->mutex,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+			 "%s: unable to grab mutex of worker: %d.",
+			 function,
+			 victim_index );
+
+			return( -1 );
+		}
+		/* The worker takes from the front of its own deque, which it serves in turn,
+		 * and steals the most recently added queue from the deque of another worker
+		 */
+		if( worker_offset == 0 )
+		{
+			safe_scheduler_queue = victim_worker->first_ready_queue;
+
+			if( safe_scheduler_queue != NULL )
+			{
+				victim_worker->first_ready_queue = safe_scheduler_queue->next_ready_queue;
+
+				if( victim_worker->first_ready_queue == NULL )
+				{
+					victim_worker->last_ready_queue = NULL;
+				}
+				else
+				{
+					victim_worker->first_ready_queue->previous_ready_queue = NULL;
+				}
+			}
+		}
+		else
+		{
+			safe_scheduler_queue = victim_worker->last_ready_queue;
+
+			if( safe_scheduler_queue != NULL )
+			{
+				victim_worker->last_ready_queue = safe_scheduler_queue->previous_ready_queue;
+
+				if( victim_worker->last_ready_queue == NULL )
+				{
+					victim_worker->first_ready_queue = NULL;
+				}
+				else
+				{
+					victim_worker->last_ready_queue->next_ready_queue = NULL;
+				}
+			}
+		}
+		if( safe_scheduler_queue != NULL )
+		{
+			safe_scheduler_queue->previous_ready_queue = NULL;
+			safe_scheduler_queue->next_ready_queue     = NULL;
+		}
+		if( libcthreads_mutex_release(
+		     victim_worker->mutex,
+		     error ) != 1 )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+			 "%s: unable to release mutex of worker: %d.",
+			 function,
+			 victim_index );
+
+			return( -1 );
+		}
+		if( safe_scheduler_queue != NULL )
+		{
+			*scheduler_queue = safe_scheduler_queue;
+
+			return( 1 );
+		}
+	}
+	return( 0 );
+}
+
+/* Completes a job that was run
+ * A job of a batch is marked as completed in the batch, other jobs are freed
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_scheduler_complete_job(
+     libqcow_scheduler_job_t *scheduler_job,
+     int result,
+     libcerror_error_t **error )
+{
+	libqcow_scheduler_batch_t *scheduler_batch = NULL;
+	static char *function                      = "libqcow_scheduler_complete_job";
+
+	if( scheduler_job == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid scheduler job.",
+		 function );
+
+		return( -1 );
+	}
+	scheduler_batch = scheduler_job->batch;
+
+	if( scheduler_batch == NULL )
+	{
+		memory_free(
+		 scheduler_job );
+
+		return( 1 );
+	}
+	if( libcthreads_mutex_grab(
+	     scheduler_batch->mutex,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to grab mutex.",
+		 function );
+
+		return( -1 );
+	}
+	scheduler_batch->number_of_completed_jobs += 1;
+
+	if( result != 1 )
+	{
+		scheduler_batch->number_of_failed_jobs += 1;
+	}
+	/* The batch and its jobs can be freed once the mutex is released
+	 */
+	if( libcthreads_condition_broadcast(
+	     scheduler_batch->condition,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to broadcast condition.",
+		 function );
+
+		libcthreads_mutex_release(
+		 scheduler_batch->mutex,
+		 NULL );
+
+		return( -1 );
+	}
+	if( libcthreads_mutex_release(
+	     scheduler_batch->mutex,
+	     error ) != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+		 "%s: unable to release mutex.",
+		 function );
+
+		return( -1 );
+	}
+	return( 1 );
+}
+
+/* Runs the jobs of the scheduler
+ * The thread takes one job at a time of the first queue in the deque of its worker
+ * and moves the queue to the end of the deque, hence a queue with many queued jobs
+ * does not hold up the jobs of the other queues. When the deque of its worker is empty
+ * the thread steals a queue from the deque of another worker, hence an idle thread picks
+ * up the next job of any queue
+ * Returns 1 if successful or -1 on error
+ */
+int libqcow_scheduler_thread_callback(
+     libqcow_scheduler_worker_t *scheduler_worker )
+{
+	libcerror_error_t *error                         = NULL;
+	libqcow_internal_scheduler_t *internal_scheduler = NULL;
+	libqcow_scheduler_job_t *scheduler_job           = NULL;
+	libqcow_scheduler_queue_t *scheduler_queue       = NULL;
+	static char *function                            = "libqcow_scheduler_thread_callback";
+	uint32_t job_generation                          = 0;
+	uint8_t is_stopped                               = 0;
+	uint8_t queue_is_ready                           = 0;
+	int result                                       = 0;
+
+	if( scheduler_worker == NULL )
+	{
+		return( -1 );
+	}
+	internal_scheduler = scheduler_worker->internal_scheduler;
+
+	if( internal_scheduler == NULL )
+	{
+		return( -1 );
+	}
+	while( is_stopped == 0 )
+	{
+		if( libcthreads_mutex_grab(
+		     internal_scheduler->mutex,
+		     &error ) != 1 )
+		{
+			libcerror_error_set(
+			 &error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+			 "%s: unable to grab mutex.",
+			 function );
+
+			goto on_error;
+		}
+		job_generation = internal_scheduler->job_generation;
+
+		if( libcthreads_mutex_release(
+		     internal_scheduler->mutex,
+		     &error ) != 1 )
+		{
+			libcerror_error_set(
+			 &error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+			 "%s: unable to release mutex.",
+			 function );
+
+			goto on_error;
+		}
+		scheduler_queue = NULL;
+
+		result = libqcow_scheduler_take_ready_queue(
+		          internal_scheduler,
+		          scheduler_worker,
+		          &scheduler_queue,
+		          &error );
+
+		if( result == -1 )
+		{
+			libcerror_error_set(
+			 &error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+			 "%s: unable to take ready queue.",
+			 function );
+
+			goto on_error;
+		}
+		else if( result == 0 )
+		{
+			/* Wait for a queue to become ready unless one was added
+			 * while the deques were searched
+			 */
+			if( libcthreads_mutex_grab(
+			     internal_scheduler->mutex,
+			     &error ) != 1 )
+			{
+				libcerror_error_set(
+				 &error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+				 "%s: unable to grab mutex.",
+				 function );
+
+				goto on_error;
+			}
+			if( job_generation == internal_scheduler->job_generation )
+			{
+				if( internal_scheduler->is_stopping != 0 )
+				{
+					is_stopped = 1;
+				}
+				else
+				{
+					internal_scheduler->number_of_waiting_threads += 1;
+
+					result = libcthreads_condition_wait(
+					          internal_scheduler->job_condition,
+					          internal_scheduler->mutex,
+					          &error );
+
+					internal_scheduler->number_of_waiting_threads -= 1;
+
+					if( result != 1 )
+					{
+						libcerror_error_set(
+						 &error,
+						 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+						 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+						 "%s: unable to wait for job condition.",
+						 function );
+
+						libcthreads_mutex_release(
+						 internal_scheduler->mutex,
+						 NULL );
+
+						goto on_error;
+					}
+				}
+			}
+			if( libcthreads_mutex_release(
+			     internal_scheduler->mutex,
+			     &error ) != 1 )
+			{
+				libcerror_error_set(
+				 &error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+				 "%s: unable to release mutex.",
+				 function );
+
+				goto on_error;
+			}
+			continue;
+		}
+		if( libcthreads_mutex_grab(
+		     scheduler_queue->mutex,
+		     &error ) != 1 )
+		{
+			libcerror_error_set(
+			 &error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+			 "%s: unable to grab mutex of queue.",
+			 function );
+
+			goto on_error;
+		}
+		scheduler_job = scheduler_queue->first_job;
+
+		if( scheduler_job != NULL )
+		{
+			scheduler_queue->first_job = scheduler_job->next_job;
+
+			if( scheduler_queue->first_job == NULL )
+			{
+				scheduler_queue->last_job = NULL;
+			}
+			else
+			{
+				scheduler_queue->first_job->previous_job = NULL;
+			}
+			scheduler_job->next_job  = NULL;
+			scheduler_job->is_queued = 0;
+
+			scheduler_queue->number_of_queued_jobs  -= 1;
+			scheduler_queue->number_of_running_jobs += 1;
+		}
+		/* A queue without queued jobs is no longer ready, the queue can be freed
+		 * once it is no longer ready and its jobs have completed
+		 */
+		queue_is_ready = 1;
+
+		if( scheduler_queue->first_job == NULL )
+		{
+			scheduler_queue->is_ready = 0;
+
+			queue_is_ready = 0;
+		}
+		if( ( scheduler_job == NULL )
+		 || ( scheduler_queue->maximum_number_of_queued_jobs != 0 ) )
+		{
+			if( libcthreads_condition_broadcast(
+			     scheduler_queue->condition,
+			     &error ) != 1 )
+			{
+				libcerror_error_set(
+				 &error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+				 "%s: unable to broadcast condition of queue.",
+				 function );
+
+				libcthreads_mutex_release(
+				 scheduler_queue->mutex,
+				 NULL );
+
+				goto on_error;
+			}
+		}
+		if( libcthreads_mutex_release(
+		     scheduler_queue->mutex,
+		     &error ) != 1 )
+		{
+			libcerror_error_set(
+			 &error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+			 "%s: unable to release mutex of queue.",
+			 function );
+
+			goto on_error;
+		}
+		if( scheduler_job == NULL )
+		{
+			continue;
+		}
+		/* The queue is moved to the end of the deque before the job is run,
+		 * so that other threads can steal the remaining jobs of the queue
+		 */
+		if( queue_is_ready != 0 )
+		{
+			if( libqcow_scheduler_add_ready_queue(
+			     internal_scheduler,
+			     scheduler_worker,
+			     scheduler_queue,
+			     &error ) != 1 )
+			{
+				libcerror_error_set(
+				 &error,
+				 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+				 LIBCERROR_RUNTIME_ERROR_APPEND_FAILED,
+				 "%s: unable to add queue to deque.",
+				 function );
+
+				goto on_error;
+			}
+		}
+		result = scheduler_job->callback_function(
+		          scheduler_job->value,
+		          scheduler_job->arguments );
+
+		if( libcthreads_mutex_grab(
+		     scheduler_queue->mutex,
+		     &error ) != 1 )
+		{
+			libcerror_error_set(
+			 &error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+			 "%s: unable to grab mutex of queue.",
+			 function );
+
+			goto on_error;
+		}
+		scheduler_queue->number_of_running_jobs -= 1;
+
+		/* The queue can be freed once the mutex is released
+		 */
+		if( libcthreads_condition_broadcast(
+		     scheduler_queue->condition,
+		     &error ) != 1 )
+		{
+			libcerror_error_set(
+			 &error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+			 "%s: unable to broadcast condition of queue.",
+			 function );
+
+			libcthreads_mutex_release(
+			 scheduler_queue->mutex,
+			 NULL );
+
+			goto on_error;
+		}
+		if( libcthreads_mutex_release(
+		     scheduler_queue->mutex,
+		     &error ) != 1 )
+		{
+			libcerror_error_set(
+			 &error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+			 "%s: unable to release mutex of queue.",
+			 function );
+
+			goto on_error;
+		}
+		if( libqcow_scheduler_complete_job(
+		     scheduler_job,
+		     result,
+		     &error ) != 1 )
+		{
+			libcerror_error_set(
+			 &error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_SET_FAILED,
+			 "%s: unable to complete job.",
+			 function );
+
+			goto on_error;
+		}
+		scheduler_job = NULL;
+	}
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	return( -1 );
+}
+
+#endif /* defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT ) */
@@ -0,0 +1,356 @@
+/*
+ * Scheduler functions
+ *
+ * Copyright (C) 2010-2026, Joachim Metz <joachim.metz@gmail.com>
+ *
+ * Refer to AUTHORS for acknowledgements.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#if !defined( _LIBQCOW_INTERNAL_SCHEDULER_H )
+#define _LIBQCOW_INTERNAL_SCHEDULER_H
+
+#include <common.h>
+#include <types.h>
+
+#include "libqcow_extern.h"
+#include "libqcow_libcerror.h"
+#include "libqcow_libcthreads.h"
+#include "libqcow_types.h"
+
+#if defined( __cplusplus )
+extern "C" {
+#endif
+
+typedef struct libqcow_internal_scheduler libqcow_internal_scheduler_t;
+
+typedef struct libqcow_scheduler_batch libqcow_scheduler_batch_t;
+
+typedef struct libqcow_scheduler_job libqcow_scheduler_job_t;
+
+struct libqcow_scheduler_job
+{
+	/* The callback function
+	 */
+	int (*callback_function)(
+	       intptr_t *value,
+	       void *arguments );
+
+	/* The value that is passed to the callback function
+	 */
+	intptr_t *value;
+
+	/* The arguments that are passed to the callback function
+	 */
+	void *arguments;
+
+	/* The batch that contains the job, the job is owned by the batch
+	 */
+	libqcow_scheduler_batch_t *batch;
+
+	/* Value to indicate the job is queued
+	 */
+	uint8_t is_queued;
+
+	/* The previous (less recently queued) job
+	 */
+	libqcow_scheduler_job_t *previous_job;
+
+	/* The next (more recently queued) job
+	 */
+	libqcow_scheduler_job_t *next_job;
+
+	/* The next job in the batch
+	 */
+	libqcow_scheduler_job_t *next_batch_job;
+};
+
+typedef struct libqcow_scheduler_queue libqcow_scheduler_queue_t;
+
+struct libqcow_scheduler_queue
+{
+	/* The maximum number of queued jobs, 0 represents no maximum
+	 */
+	int maximum_number_of_queued_jobs;
+
+	/* The number of queued jobs
+	 */
+	int number_of_queued_jobs;
+
+	/* The number of jobs that are running
+	 */
+	int number_of_running_jobs;
+
+	/* The first (least recently queued) job
+	 */
+	libqcow_scheduler_job_t *first_job;
+
+	/* The last (most recently queued) job
+	 */
+	libqcow_scheduler_job_t *last_job;
+
+	/* Value to indicate the queue is in the deque of one of the workers
+	 * The queue remains ready until a worker takes it from the deque
+	 * and finds no queued jobs
+	 */
+	uint8_t is_ready;
+
+	/* The previous queue in the deque of the worker
+	 */
+	libqcow_scheduler_queue_t *previous_ready_queue;
+
+	/* The next queue in the deque of the worker
+	 */
+	libqcow_scheduler_queue_t *next_ready_queue;
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	/* The mutex that protects the jobs and state values
+	 */
+	libcthreads_mutex_t *mutex;
+
+	/* The condition that is signalled when a job was taken or completed
+	 */
+	libcthreads_condition_t *condition;
+#endif
+};
+
+typedef struct libqcow_scheduler_worker libqcow_scheduler_worker_t;
+
+struct libqcow_scheduler_worker
+{
+	/* The scheduler
+	 */
+	libqcow_internal_scheduler_t *internal_scheduler;
+
+	/* The index of the worker
+	 */
+	int worker_index;
+
+	/* The first queue in the deque of queues with queued jobs
+	 * The worker takes one job at a time from the first queue and moves
+	 * the queue to the end of its deque, hence the queues are served in turn
+	 */
+	libqcow_scheduler_queue_t *first_ready_queue;
+
+	/* The last queue in the deque of queues with queued jobs
+	 * Other workers steal from the end of the deque
+	 */
+	libqcow_scheduler_queue_t *last_ready_queue;
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	/* The thread
+	 */
+	libcthreads_thread_t *thread;
+
+	/* The mutex that protects the deque
+	 */
+	libcthreads_mutex_t *mutex;
+#endif
+};
+
+struct libqcow_internal_scheduler
+{
+	/* The number of threads
+	 */
+	int number_of_threads;
+
+	/* The number of references
+	 */
+	int number_of_references;
+
+	/* The workers
+	 * Every thread has a worker with its own deque of queues with queued jobs
+	 */
+	libqcow_scheduler_worker_t *workers;
+
+	/* The index of the worker of which the deque receives the next queue that becomes ready
+	 */
+	int next_worker_index;
+
+	/* The job generation
+	 * Changes every time a queue is added to a deque, so that an idle thread
+	 * does not wait for a job that was added while it was looking for one
+	 */
+	uint32_t job_generation;
+
+	/* The number of threads that wait for a job
+	 */
+	int number_of_waiting_threads;
+
+	/* Value to indicate the threads should stop once no jobs are queued
+	 */
+	uint8_t is_stopping;
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	/* The mutex that protects the state values
+	 */
+	libcthreads_mutex_t *mutex;
+
+	/* The condition that is signalled when a job was queued
+	 */
+	libcthreads_condition_t *job_condition;
+#endif
+};
+
+struct libqcow_scheduler_batch
+{
+	/* The scheduler, NULL if the jobs are run when they are pushed
+	 */
+	libqcow_scheduler_t *scheduler;
+
+	/* The scheduler queue
+	 */
+	libqcow_scheduler_queue_t *scheduler_queue;
+
+	/* The first job
+	 */
+	libqcow_scheduler_job_t *first_job;
+
+	/* The last job
+	 */
+	libqcow_scheduler_job_t *last_job;
+
+	/* The number of jobs
+	 */
+	int number_of_jobs;
+
+	/* The number of completed jobs
+	 */
+	int number_of_completed_jobs;
+
+	/* The number of jobs of which the callback function did not return 1
+	 */
+	int number_of_failed_jobs;
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	/* The mutex that protects the completion values
+	 */
+	libcthreads_mutex_t *mutex;
+
+	/* The condition that is signalled when a job was completed
+	 */
+	libcthreads_condition_t *condition;
+#endif
+};
+
+LIBQCOW_EXTERN \
+int libqcow_scheduler_initialize(
+     libqcow_scheduler_t **scheduler,
+     int number_of_threads,
+     libcerror_error_t **error );
+
+LIBQCOW_EXTERN \
+int libqcow_scheduler_free(
+     libqcow_scheduler_t **scheduler,
+     libcerror_error_t **error );
+
+int libqcow_scheduler_reference(
+     libqcow_scheduler_t *scheduler,
+     libcerror_error_t **error );
+
+LIBQCOW_EXTERN \
+int libqcow_scheduler_get_number_of_threads(
+     libqcow_scheduler_t *scheduler,
+     int *number_of_threads,
+     libcerror_error_t **error );
+
+int libqcow_scheduler_queue_initialize(
+     libqcow_scheduler_queue_t **scheduler_queue,
+     int maximum_number_of_queued_jobs,
+     libcerror_error_t **error );
+
+int libqcow_scheduler_queue_free(
+     libqcow_scheduler_queue_t **scheduler_queue,
+     libcerror_error_t **error );
+
+int libqcow_scheduler_push_job(
+     libqcow_scheduler_t *scheduler,
+     libqcow_scheduler_queue_t *scheduler_queue,
+     int (*callback_function)(
+            intptr_t *value,
+            void *arguments ),
+     intptr_t *value,
+     void *arguments,
+     libcerror_error_t **error );
+
+int libqcow_scheduler_wait_for_queue(
+     libqcow_scheduler_t *scheduler,
+     libqcow_scheduler_queue_t *scheduler_queue,
+     libcerror_error_t **error );
+
+int libqcow_scheduler_batch_initialize(
+     libqcow_scheduler_batch_t **scheduler_batch,
+     libqcow_scheduler_t *scheduler,
+     libqcow_scheduler_queue_t *scheduler_queue,
+     libcerror_error_t **error );
+
+int libqcow_scheduler_batch_free(
+     libqcow_scheduler_batch_t **scheduler_batch,
+     libcerror_error_t **error );
+
+int libqcow_scheduler_batch_push_job(
+     libqcow_scheduler_batch_t *scheduler_batch,
+     int (*callback_function)(
+            intptr_t *value,
+            void *arguments ),
+     intptr_t *value,
+     void *arguments,
+     libcerror_error_t **error );
+
+int libqcow_scheduler_batch_wait(
+     libqcow_scheduler_batch_t *scheduler_batch,
+     libcerror_error_t **error );
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+
+int libqcow_scheduler_queue_append_job(
+     libqcow_scheduler_queue_t *scheduler_queue,
+     libqcow_scheduler_job_t *scheduler_job,
+     uint8_t *queue_is_ready,
+     libcerror_error_t **error );
+
+int libqcow_scheduler_queue_remove_job(
+     libqcow_scheduler_queue_t *scheduler_queue,
+     libqcow_scheduler_job_t *scheduler_job,
+     libcerror_error_t **error );
+
+int libqcow_scheduler_add_ready_queue(
+     libqcow_internal_scheduler_t *internal_scheduler,
+     libqcow_scheduler_worker_t *scheduler_worker,
+     libqcow_scheduler_queue_t *scheduler_queue,
+     libcerror_error_t **error );
+
+int libqcow_scheduler_take_ready_queue(
+     libqcow_internal_scheduler_t *internal_scheduler,
+     libqcow_scheduler_worker_t *scheduler_worker,
+     libqcow_scheduler_queue_t **scheduler_queue,
+     libcerror_error_t **error );
+
+int libqcow_scheduler_complete_job(
+     libqcow_scheduler_job_t *scheduler_job,
+     int result,
+     libcerror_error_t **error );
+
+int libqcow_scheduler_thread_callback(
+     libqcow_scheduler_worker_t *scheduler_worker );
+
+#endif
+
+#if defined( __cplusplus )
+}
+#endif
+
+#endif /* !defined( _LIBQCOW_INTERNAL_SCHEDULER_H ) */
+
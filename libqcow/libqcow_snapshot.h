@@ -0,0 +1,192 @@
+/*
+ * Snapshot functions
+ *
+ * Copyright (C) 2010-2026, Joachim Metz <joachim.metz@gmail.com>
+ *
+ * Refer to AUTHORS for acknowledgements.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#if !defined( _LIBQCOW_INTERNAL_SNAPSHOT_H )
+#define _LIBQCOW_INTERNAL_SNAPSHOT_H
+
+#include <common.h>
+#include <types.h>
+
+#include "libqcow_cluster_table.h"
+#include "libqcow_extern.h"
+#include "libqcow_libbfio.h"
+#include "libqcow_libcerror.h"
+#include "libqcow_libcthreads.h"
+#include "libqcow_snapshot_values.h"
+#include "libqcow_types.h"
+
+#if defined( __cplusplus )
+extern "C" {
+#endif
+
+typedef struct libqcow_internal_snapshot libqcow_internal_snapshot_t;
+
+struct libqcow_internal_snapshot
+{
+	/* The file that contains the snapshot
+	 */
+	libqcow_file_t *file;
+
+	/* The snapshot values
+	 */
+	libqcow_snapshot_values_t *snapshot_values;
+
+	/* The level 1 table of the snapshot
+	 */
+	libqcow_cluster_table_t *level1_table;
+
+	/* The media size of the snapshot
+	 */
+	size64_t media_size;
+
+	/* The current (storage media) offset
+	 */
+	off64_t current_offset;
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	/* The read/write lock
+	 */
+	libcthreads_read_write_lock_t *read_write_lock;
+#endif
+};
+
+int libqcow_snapshot_initialize(
+     libqcow_snapshot_t **snapshot,
+     libqcow_file_t *file,
+     libbfio_handle_t *file_io_handle,
+     libqcow_snapshot_values_t *snapshot_values,
+     libcerror_error_t **error );
+
+LIBQCOW_EXTERN \
+int libqcow_snapshot_free(
+     libqcow_snapshot_t **snapshot,
+     libcerror_error_t **error );
+
+ssize_t libqcow_internal_snapshot_read_buffer(
+         libqcow_internal_snapshot_t *internal_snapshot,
+         void *buffer,
+         size_t buffer_size,
+         libcerror_error_t **error );
+
+LIBQCOW_EXTERN \
+ssize_t libqcow_snapshot_read_buffer(
+         libqcow_snapshot_t *snapshot,
+         void *buffer,
+         size_t buffer_size,
+         libcerror_error_t **error );
+
+LIBQCOW_EXTERN \
+ssize_t libqcow_snapshot_read_buffer_at_offset(
+         libqcow_snapshot_t *snapshot,
+         void *buffer,
+         size_t buffer_size,
+         off64_t offset,
+         libcerror_error_t **error );
+
+off64_t libqcow_internal_snapshot_seek_offset(
+         libqcow_internal_snapshot_t *internal_snapshot,
+         off64_t offset,
+         int whence,
+         libcerror_error_t **error );
+
+LIBQCOW_EXTERN \
+off64_t libqcow_snapshot_seek_offset(
+         libqcow_snapshot_t *snapshot,
+         off64_t offset,
+         int whence,
+         libcerror_error_t **error );
+
+LIBQCOW_EXTERN \
+int libqcow_snapshot_get_offset(
+     libqcow_snapshot_t *snapshot,
+     off64_t *offset,
+     libcerror_error_t **error );
+
+LIBQCOW_EXTERN \
+int libqcow_snapshot_get_media_size(
+     libqcow_snapshot_t *snapshot,
+     size64_t *media_size,
+     libcerror_error_t **error );
+
+LIBQCOW_EXTERN \
+int libqcow_snapshot_get_creation_time(
+     libqcow_snapshot_t *snapshot,
+     int64_t *posix_time,
+     libcerror_error_t **error );
+
+LIBQCOW_EXTERN \
+int libqcow_snapshot_get_utf8_identifier_size(
+     libqcow_snapshot_t *snapshot,
+     size_t *utf8_string_size,
+     libcerror_error_t **error );
+
+LIBQCOW_EXTERN \
+int libqcow_snapshot_get_utf8_identifier(
+     libqcow_snapshot_t *snapshot,
+     uint8_t *utf8_string,
+     size_t utf8_string_size,
+     libcerror_error_t **error );
+
+LIBQCOW_EXTERN \
+int libqcow_snapshot_get_utf16_identifier_size(
+     libqcow_snapshot_t *snapshot,
+     size_t *utf16_string_size,
+     libcerror_error_t **error );
+
+LIBQCOW_EXTERN \
+int libqcow_snapshot_get_utf16_identifier(
+     libqcow_snapshot_t *snapshot,
+     uint16_t *utf16_string,
+     size_t utf16_string_size,
+     libcerror_error_t **error );
+
+LIBQCOW_EXTERN \
+int libqcow_snapshot_get_utf8_name_size(
+     libqcow_snapshot_t *snapshot,
+     size_t *utf8_string_size,
+     libcerror_error_t **error );
+
+LIBQCOW_EXTERN \
+int libqcow_snapshot_get_utf8_name(
+     libqcow_snapshot_t *snapshot,
+     uint8_t *utf8_string,
+     size_t utf8_string_size,
+     libcerror_error_t **error );
+
+LIBQCOW_EXTERN \
+int libqcow_snapshot_get_utf16_name_size(
+     libqcow_snapshot_t *snapshot,
+     size_t *utf16_string_size,
+     libcerror_error_t **error );
+
+LIBQCOW_EXTERN \
+int libqcow_snapshot_get_utf16_name(
+     libqcow_snapshot_t *snapshot,
+     uint16_t *utf16_string,
+     size_t utf16_string_size,
+     libcerror_error_t **error );
+
+#if defined( __cplusplus )
+}
+#endif
+
+#endif /* !defined( _LIBQCOW_INTERNAL_SNAPSHOT_H ) */
+
@@ -0,0 +1,114 @@
+/*
+ * Snapshot values functions
+ *
+ * Copyright (C) 2010-2026, Joachim Metz <joachim.metz@gmail.com>
+ *
+ * Refer to AUTHORS for acknowledgements.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#if !defined( _LIBQCOW_SNAPSHOT_VALUES_H )
+#define _LIBQCOW_SNAPSHOT_VALUES_H
+
+#include <common.h>
+#include <types.h>
+
+#include "libqcow_libbfio.h"
+#include "libqcow_libcerror.h"
+
+#if defined( __cplusplus )
+extern "C" {
+#endif
+
+typedef struct libqcow_snapshot_values libqcow_snapshot_values_t;
+
+struct libqcow_snapshot_values
+{
+	/* The level 1 table offset
+	 */
+	off64_t level1_table_offset;
+
+	/* The number of level 1 table references
+	 */
+	uint32_t number_of_level1_table_references;
+
+	/* The identifier
+	 */
+	uint8_t *identifier;
+
+	/* The identifier size
+	 */
+	size_t identifier_size;
+
+	/* The name
+	 */
+	uint8_t *name;
+
+	/* The name size
+	 */
+	size_t name_size;
+
+	/* The creation date and time in seconds
+	 */
+	uint32_t creation_time_seconds;
+
+	/* The creation date and time nano seconds fraction
+	 */
+	uint32_t creation_time_nano_seconds;
+
+	/* The virtual machine clock in nano seconds
+	 */
+	uint64_t virtual_machine_clock;
+
+	/* The virtual machine state size
+	 */
+	uint64_t virtual_machine_state_size;
+
+	/* The media size
+	 * Contains 0 if not stored in the snapshot table entry
+	 */
+	size64_t media_size;
+
+	/* The (snapshot table entry) data size, including the alignment padding
+	 */
+	size_t data_size;
+};
+
+int libqcow_snapshot_values_initialize(
+     libqcow_snapshot_values_t **snapshot_values,
+     libcerror_error_t **error );
+
+int libqcow_snapshot_values_free(
+     libqcow_snapshot_values_t **snapshot_values,
+     libcerror_error_t **error );
+
+int libqcow_snapshot_values_read_data(
+     libqcow_snapshot_values_t *snapshot_values,
+     const uint8_t *data,
+     size_t data_size,
+     libcerror_error_t **error );
+
+int libqcow_snapshot_values_read_file_io_handle(
+     libqcow_snapshot_values_t *snapshot_values,
+     libbfio_handle_t *file_io_handle,
+     off64_t file_offset,
+     libcerror_error_t **error );
+
+#if defined( __cplusplus )
+}
+#endif
+
+#endif /* !defined( _LIBQCOW_SNAPSHOT_VALUES_H ) */
+
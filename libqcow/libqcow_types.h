@@ -34,10 +34,24 @@
 /* The following type definitions hide internal data structures
  */
 #if defined( HAVE_DEBUG_OUTPUT ) && !defined( WINAPI )
-typedef struct libqcow_file {}	libqcow_file_t;
+typedef struct libqcow_cache_pool {}		libqcow_cache_pool_t;
+typedef struct libqcow_changed_extents {}	libqcow_changed_extents_t;
+typedef struct libqcow_cursor {}		libqcow_cursor_t;
+typedef struct libqcow_data_pin {}		libqcow_data_pin_t;
+typedef struct libqcow_file {}			libqcow_file_t;
+typedef struct libqcow_read_request {}		libqcow_read_request_t;
+typedef struct libqcow_scheduler {}		libqcow_scheduler_t;
+typedef struct libqcow_snapshot {}		libqcow_snapshot_t;
 
 #else
+typedef intptr_t libqcow_cache_pool_t;
+typedef intptr_t libqcow_changed_extents_t;
+typedef intptr_t libqcow_cursor_t;
+typedef intptr_t libqcow_data_pin_t;
 typedef intptr_t libqcow_file_t;
+typedef intptr_t libqcow_read_request_t;
+typedef intptr_t libqcow_scheduler_t;
+typedef intptr_t libqcow_snapshot_t;
 
 #endif /* defined( HAVE_DEBUG_OUTPUT ) && !defined( WINAPI ) */
 
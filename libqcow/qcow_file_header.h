@@ -267,6 +267,21 @@ struct qcow_file_header_v3
 	uint8_t unknown1[ 7 ];
 };
 
+typedef struct qcow_file_header_extension qcow_file_header_extension_t;
+
+struct qcow_file_header_extension
+{
+	/* The extension type
+	 * Consists of 4 bytes
+	 */
+	uint8_t extension_type[ 4 ];
+
+	/* The extension data size
+	 * Consists of 4 bytes
+	 */
+	uint8_t data_size[ 4 ];
+};
+
 #if defined( __cplusplus )
 }
 #endif
@@ -0,0 +1,144 @@
+/*
+ * The mapping index (sidecar) file definition of a QEMU Copy-On-Write (QCOW) image file
+ *
+ * Copyright (C) 2010-2026, Joachim Metz <joachim.metz@gmail.com>
+ *
+ * Refer to AUTHORS for acknowledgements.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#if !defined( _QCOW_MAPPING_INDEX_H )
+#define _QCOW_MAPPING_INDEX_H
+
+#include <common.h>
+#include <types.h>
+
+#if defined( __cplusplus )
+extern "C" {
+#endif
+
+/* The mapping index file consists of:
+ * the mapping index header
+ * a mapping index table for every level 2 table
+ * a mapping index extent for every extent of all level 2 tables
+ */
+typedef struct qcow_mapping_index_header qcow_mapping_index_header_t;
+
+struct qcow_mapping_index_header
+{
+	/* The signature
+	 * Consists of 8 bytes
+	 * Consists of: "LQCOWIDX"
+	 */
+	uint8_t signature[ 8 ];
+
+	/* The format version
+	 * Consists of 4 bytes
+	 */
+	uint8_t format_version[ 4 ];
+
+	/* The header size
+	 * Consists of 4 bytes
+	 */
+	uint8_t header_size[ 4 ];
+
+	/* The image file size
+	 * Consists of 8 bytes
+	 */
+	uint8_t file_size[ 8 ];
+
+	/* The image file modification time
+	 * Consists of 8 bytes
+	 * Contains the number of nanoseconds since January 1, 1970 (POSIX epoch)
+	 */
+	uint8_t modification_time[ 8 ];
+
+	/* The image file header hash
+	 * Consists of 8 bytes
+	 */
+	uint8_t header_hash[ 8 ];
+
+	/* The cluster block size
+	 * Consists of 8 bytes
+	 */
+	uint8_t cluster_block_size[ 8 ];
+
+	/* The number of level 2 tables
+	 * Consists of 4 bytes
+	 */
+	uint8_t number_of_level2_tables[ 4 ];
+
+	/* The number of level 2 table references
+	 * Consists of 4 bytes
+	 */
+	uint8_t number_of_level2_table_references[ 4 ];
+
+	/* The number of extents
+	 * Consists of 4 bytes
+	 */
+	uint8_t number_of_extents[ 4 ];
+
+	/* The extent size
+	 * Consists of 4 bytes
+	 */
+	uint8_t extent_size[ 4 ];
+};
+
+typedef struct qcow_mapping_index_table qcow_mapping_index_table_t;
+
+struct qcow_mapping_index_table
+{
+	/* The flags
+	 * Consists of 4 bytes
+	 */
+	uint8_t flags[ 4 ];
+
+	/* The number of extents
+	 * Consists of 4 bytes
+	 */
+	uint8_t number_of_extents[ 4 ];
+};
+
+typedef struct qcow_mapping_index_extent qcow_mapping_index_extent_t;
+
+struct qcow_mapping_index_extent
+{
+	/* The first cluster block index, relative to the level 2 table
+	 * Consists of 4 bytes
+	 */
+	uint8_t first_cluster_block_index[ 4 ];
+
+	/* The number of cluster blocks
+	 * Consists of 4 bytes
+	 */
+	uint8_t number_of_cluster_blocks[ 4 ];
+
+	/* The cluster block (file) offset of the first cluster block
+	 * Consists of 8 bytes
+	 */
+	uint8_t cluster_block_offset[ 8 ];
+
+	/* The cluster block flags
+	 * Consists of 4 bytes
+	 */
+	uint8_t cluster_block_flags[ 4 ];
+};
+
+#if defined( __cplusplus )
+}
+#endif
+
+#endif /* !defined( _QCOW_MAPPING_INDEX_H ) */
+
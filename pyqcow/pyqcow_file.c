@@ -102,6 +102,19 @@ PyMethodDef pyqcow_file_object_methods[] = {
 	  "\n"
 	  "Reads a buffer of data at a specific offset." },
 
+	{ "read_buffer_at_offset_concurrent",
+	  (PyCFunction) pyqcow_file_read_buffer_at_offset_concurrent,
+	  METH_VARARGS | METH_KEYWORDS,
+	  "read_buffer_at_offset_concurrent(size, offset, timeout=0)-> Bytes\n"
+	  "\n"
+	  "Reads a buffer of data at a specific offset.\n"
+	  "\n"
+	  "Unlike read_buffer_at_offset this method does not change the current offset\n"
+	  "and is safe to call from multiple threads on the same file at the same time.\n"
+	  "The file cannot be closed while such a read is in progress.\n"
+	  "The timeout is in milliseconds, 0 means no timeout. When the timeout has\n"
+	  "passed the data read so far is returned." },
+
 	{ "seek_offset",
 	  (PyCFunction) pyqcow_file_seek_offset,
 	  METH_VARARGS | METH_KEYWORDS,
@@ -1371,6 +1384,214 @@ PyObject *pyqcow_file_read_buffer_at_offset(
 	return( string_object );
 }
 
+/* Reads data at a specific offset into a buffer, safe to use from multiple threads
+ * The GIL is released during the read and the current offset of the file is not changed
+ * Returns a Python object if successful or NULL on error
+ */
+PyObject *pyqcow_file_read_buffer_at_offset_concurrent(
+           pyqcow_file_t *pyqcow_file,
+           PyObject *arguments,
+           PyObject *keywords )
+{
+	PyObject *integer_object    = NULL;
+	PyObject *string_object     = NULL;
+	libcerror_error_t *error    = NULL;
+	char *buffer                = NULL;
+	static char *function       = "pyqcow_file_read_buffer_at_offset_concurrent";
+	static char *keyword_list[] = { "size", "offset", "timeout", NULL };
+	ssize_t read_count          = 0;
+	off64_t read_offset         = 0;
+	int64_t read_size           = 0;
+	unsigned int timeout        = 0;
+	int result                  = 0;
+
+	if( pyqcow_file == NULL )
+	{
+		PyErr_Format(
+		 PyExc_ValueError,
+		 "%s: invalid file.",
+		 function );
+
+		return( NULL );
+	}
+	if( PyArg_ParseTupleAndKeywords(
+	     arguments,
+	     keywords,
+	     "OL|I",
+	     keyword_list,
+	     &integer_object,
+	     &read_offset,
+	     &timeout ) == 0 )
+	{
+		return( NULL );
+	}
+	result = PyObject_IsInstance(
+	          integer_object,
+	          (PyObject *) &PyLong_Type );
+
+	if( result == -1 )
+	{
+		pyqcow_error_fetch_and_raise(
+		 PyExc_RuntimeError,
+		 "%s: unable to determine if integer object is of type long.",
+		 function );
+
+		return( NULL );
+	}
+#if PY_MAJOR_VERSION < 3
+	else if( result == 0 )
+	{
+		PyErr_Clear();
+
+		result = PyObject_IsInstance(
+		          integer_object,
+		          (PyObject *) &PyInt_Type );
+
+		if( result == -1 )
+		{
+			pyqcow_error_fetch_and_raise(
+			 PyExc_RuntimeError,
+			 "%s: unable to determine if integer object is of type int.",
+			 function );
+
+			return( NULL );
+		}
+	}
+#endif
+	if( result != 0 )
+	{
+		if( pyqcow_integer_signed_copy_to_64bit(
+		     integer_object,
+		     &read_size,
+		     &error ) != 1 )
+		{
+			pyqcow_error_raise(
+			 error,
+			 PyExc_IOError,
+			 "%s: unable to convert integer object into read size.",
+			 function );
+
+			libcerror_error_free(
+			 &error );
+
+			return( NULL );
+		}
+	}
+	else
+	{
+		PyErr_Format(
+		 PyExc_TypeError,
+		 "%s: unsupported integer object type.",
+		 function );
+
+		return( NULL );
+	}
+	if( read_size == 0 )
+	{
+#if PY_MAJOR_VERSION >= 3
+		string_object = PyBytes_FromString(
+		                 "" );
+#else
+		string_object = PyString_FromString(
+		                 "" );
+#endif
+		return( string_object );
+	}
+	if( read_size < 0 )
+	{
+		PyErr_Format(
+		 PyExc_ValueError,
+		 "%s: invalid read size value less than zero.",
+		 function );
+
+		return( NULL );
+	}
+	/* Make sure the data fits into a memory buffer
+	 */
+	if( ( read_size > (int64_t) INT_MAX )
+	 || ( read_size > (int64_t) SSIZE_MAX ) )
+	{
+		PyErr_Format(
+		 PyExc_ValueError,
+		 "%s: invalid argument read size value exceeds maximum.",
+		 function );
+
+		return( NULL );
+	}
+	if( read_offset < 0 )
+	{
+		PyErr_Format(
+		 PyExc_ValueError,
+		 "%s: invalid read offset value less than zero.",
+		 function );
+
+		return( NULL );
+	}
+#if PY_MAJOR_VERSION >= 3
+	string_object = PyBytes_FromStringAndSize(
+	                 NULL,
+	                 (Py_ssize_t) read_size );
+
+	buffer = PyBytes_AsString(
+	          string_object );
+#else
+	/* Note that a size of 0 is not supported
+	 */
+	string_object = PyString_FromStringAndSize(
+	                 NULL,
+	                 (Py_ssize_t) read_size );
+
+	buffer = PyString_AsString(
+	          string_object );
+#endif
+	Py_BEGIN_ALLOW_THREADS
+
+	read_count = libqcow_file_read_buffer_at_offset_with_timeout(
+	              pyqcow_file->file,
+	              (uint8_t *) buffer,
+	              (size_t) read_size,
+	              (off64_t) read_offset,
+	              (uint32_t) timeout,
+	              &error );
+
+	Py_END_ALLOW_THREADS
+
+	if( read_count == -1 )
+	{
+		pyqcow_error_raise(
+		 error,
+		 PyExc_IOError,
+		 "%s: unable to read data.",
+		 function );
+
+		libcerror_error_free(
+		 &error );
+
+		Py_DecRef(
+		 (PyObject *) string_object );
+
+		return( NULL );
+	}
+	/* Need to resize the string here in case read_size was not fully read.
+	 */
+#if PY_MAJOR_VERSION >= 3
+	if( _PyBytes_Resize(
+	     &string_object,
+	     (Py_ssize_t) read_count ) != 0 )
+#else
+	if( _PyString_Resize(
+	     &string_object,
+	     (Py_ssize_t) read_count ) != 0 )
+#endif
+	{
+		Py_DecRef(
+		 (PyObject *) string_object );
+
+		return( NULL );
+	}
+	return( string_object );
+}
+
 /* Seeks a certain offset
  * Returns a Python object if successful or NULL on error
  */
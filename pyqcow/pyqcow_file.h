@@ -95,6 +95,11 @@ PyObject *pyqcow_file_read_buffer_at_offset(
            PyObject *arguments,
            PyObject *keywords );
 
+PyObject *pyqcow_file_read_buffer_at_offset_concurrent(
+           pyqcow_file_t *pyqcow_file,
+           PyObject *arguments,
+           PyObject *keywords );
+
 PyObject *pyqcow_file_seek_offset(
            pyqcow_file_t *pyqcow_file,
            PyObject *arguments,
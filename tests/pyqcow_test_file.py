@@ -23,6 +23,7 @@ import argparse
 import os
 import random
 import sys
+import threading
 import unittest
 
 import pyqcow
@@ -379,6 +380,189 @@ class FileTypeTests(unittest.TestCase):
     with self.assertRaises(IOError):
       qcow_file.read_buffer_at_offset(4096, 0)
 
+  def test_read_buffer_at_offset_concurrent(self):
+    """Tests the read_buffer_at_offset_concurrent function."""
+    test_source = getattr(unittest, "source", None)
+    if not test_source:
+      raise unittest.SkipTest("missing source")
+
+    qcow_file = pyqcow.file()
+
+    test_password = getattr(unittest, "password", None)
+    if test_password:
+      qcow_file.set_password(test_password)
+
+    qcow_file.open(test_source)
+
+    qcow_parent_file = None
+    if qcow_file.backing_filename:
+      qcow_parent_file = pyqcow.file()
+
+      parent_filename = os.path.join(
+        os.path.dirname(test_source), qcow_file.backing_filename)
+      qcow_parent_file.open(parent_filename, "r")
+
+      qcow_file.set_parent(qcow_parent_file)
+
+    media_size = qcow_file.get_media_size()
+
+    # Test normal read.
+    data = qcow_file.read_buffer_at_offset_concurrent(4096, 0)
+
+    self.assertIsNotNone(data)
+    self.assertEqual(len(data), min(media_size, 4096))
+
+    # Test that the current offset is not changed.
+    offset = qcow_file.get_offset()
+    self.assertEqual(offset, 0)
+
+    if media_size > 8:
+      # Read buffer beyond media_size boundary.
+      data = qcow_file.read_buffer_at_offset_concurrent(4096, media_size + 8)
+
+      self.assertIsNotNone(data)
+      self.assertEqual(len(data), 0)
+
+    # Test parallel readers against data read sequentially.
+    random_generator = random.Random(media_size)
+
+    read_ranges = []
+    for _ in range(256):
+      media_offset = random_generator.randrange(0, max(media_size, 1))
+      read_size = random_generator.randrange(1, 65536)
+      read_ranges.append((media_offset, read_size))
+
+    expected_data = [
+        qcow_file.read_buffer_at_offset(read_size, media_offset)
+        for media_offset, read_size in read_ranges]
+
+    qcow_file.seek_offset(0, os.SEEK_SET)
+
+    number_of_threads = 8
+    errors = []
+    results = [None] * len(read_ranges)
+
+    def read_ranges_in_thread(thread_index):
+      try:
+        for range_index in range(
+            thread_index, len(read_ranges), number_of_threads):
+          media_offset, read_size = read_ranges[range_index]
+          results[range_index] = qcow_file.read_buffer_at_offset_concurrent(
+              read_size, media_offset)
+      except Exception as exception:  # pylint: disable=broad-except
+        errors.append(exception)
+
+    threads = [
+        threading.Thread(target=read_ranges_in_thread, args=(thread_index,))
+        for thread_index in range(number_of_threads)]
+    for thread in threads:
+      thread.start()
+    for thread in threads:
+      thread.join()
+
+    self.assertEqual(errors, [])
+    self.assertEqual(results, expected_data)
+
+    offset = qcow_file.get_offset()
+    self.assertEqual(offset, 0)
+
+    # Test read with a timeout.
+    media_offset, read_size = read_ranges[0]
+    data = qcow_file.read_buffer_at_offset_concurrent(
+        read_size, media_offset, timeout=60000)
+
+    self.assertEqual(data, expected_data[0])
+
+    with self.assertRaises(ValueError):
+      qcow_file.read_buffer_at_offset_concurrent(-1, 0)
+
+    with self.assertRaises(ValueError):
+      qcow_file.read_buffer_at_offset_concurrent(4096, -1)
+
+    qcow_file.close()
+
+    # Test read on a closed file.
+    with self.assertRaises(IOError):
+      qcow_file.read_buffer_at_offset_concurrent(4096, 0)
+
+    if qcow_parent_file:
+      qcow_parent_file.close()
+
+  def test_read_buffer_at_offset_concurrent_file_object(self):
+    """Tests the read_buffer_at_offset_concurrent function on a file-like
+    object."""
+    test_source = getattr(unittest, "source", None)
+    if not test_source:
+      raise unittest.SkipTest("missing source")
+
+    if not os.path.isfile(test_source):
+      raise unittest.SkipTest("source not a regular file")
+
+    qcow_file = pyqcow.file()
+
+    test_password = getattr(unittest, "password", None)
+    if test_password:
+      qcow_file.set_password(test_password)
+
+    with open(test_source, "rb") as file_object:
+      qcow_file.open_file_object(file_object)
+
+      qcow_parent_file = None
+      if qcow_file.backing_filename:
+        qcow_parent_file = pyqcow.file()
+
+        parent_filename = os.path.join(
+          os.path.dirname(test_source), qcow_file.backing_filename)
+        qcow_parent_file.open(parent_filename, "r")
+
+        qcow_file.set_parent(qcow_parent_file)
+
+      media_size = qcow_file.get_media_size()
+
+      # Test parallel readers against data read sequentially, where all
+      # readers share the offset of the same file-like object.
+      random_generator = random.Random(media_size)
+
+      read_ranges = []
+      for _ in range(256):
+        media_offset = random_generator.randrange(0, max(media_size, 1))
+        read_size = random_generator.randrange(1, 65536)
+        read_ranges.append((media_offset, read_size))
+
+      expected_data = [
+          qcow_file.read_buffer_at_offset(read_size, media_offset)
+          for media_offset, read_size in read_ranges]
+
+      number_of_threads = 8
+      errors = []
+      results = [None] * len(read_ranges)
+
+      def read_ranges_in_thread(thread_index):
+        try:
+          for range_index in range(
+              thread_index, len(read_ranges), number_of_threads):
+            media_offset, read_size = read_ranges[range_index]
+            results[range_index] = qcow_file.read_buffer_at_offset_concurrent(
+                read_size, media_offset)
+        except Exception as exception:  # pylint: disable=broad-except
+          errors.append(exception)
+
+      threads = [
+          threading.Thread(target=read_ranges_in_thread, args=(thread_index,))
+          for thread_index in range(number_of_threads)]
+      for thread in threads:
+        thread.start()
+      for thread in threads:
+        thread.join()
+
+      self.assertEqual(errors, [])
+      self.assertEqual(results, expected_data)
+
+      qcow_file.close()
+
+      if qcow_parent_file:
+        qcow_parent_file.close()
+
   def test_seek_offset(self):
     """Tests the seek_offset function."""
     test_source = getattr(unittest, "source", None)
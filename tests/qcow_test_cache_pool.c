@@ -0,0 +1,1426 @@
+/*
+ * Library cache_pool type test program
+ *
+ * Copyright (C) 2010-2026, Joachim Metz <joachim.metz@gmail.com>
+ *
+ * Refer to AUTHORS for acknowledgements.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <common.h>
+#include <memory.h>
+#include <types.h>
+
+#if defined( HAVE_STDLIB_H ) || defined( WINAPI )
+#include <stdlib.h>
+#endif
+
+#include "qcow_test_libcerror.h"
+#include "qcow_test_libqcow.h"
+#include "qcow_test_macros.h"
+#include "qcow_test_memory.h"
+#include "qcow_test_unused.h"
+
+#include "../libqcow/libqcow_cache_pool.h"
+#include "../libqcow/libqcow_cluster_block.h"
+#include "../libqcow/libqcow_definitions.h"
+
+/* Tests the libqcow_cache_pool_initialize function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_cache_pool_initialize(
+     void )
+{
+	libcerror_error_t *error         = NULL;
+	libqcow_cache_pool_t *cache_pool = NULL;
+	int result                       = 0;
+
+#if defined( HAVE_QCOW_TEST_MEMORY )
+	int number_of_malloc_fail_tests  = 2;
+	int number_of_memset_fail_tests  = 2;
+	int test_number                  = 0;
+#endif
+
+	/* Test regular cases
+	 */
+	result = libqcow_cache_pool_initialize(
+	          &cache_pool,
+	          1024 * 1024,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "cache_pool",
+	 cache_pool );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_cache_pool_free(
+	          &cache_pool,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "cache_pool",
+	 cache_pool );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test error cases
+	 */
+	result = libqcow_cache_pool_initialize(
+	          NULL,
+	          1024 * 1024,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	cache_pool = (libqcow_cache_pool_t *) 0x12345678UL;
+
+	result = libqcow_cache_pool_initialize(
+	          &cache_pool,
+	          1024 * 1024,
+	          &error );
+
+	cache_pool = NULL;
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_cache_pool_initialize(
+	          &cache_pool,
+	          0,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "cache_pool",
+	 cache_pool );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+#if defined( HAVE_QCOW_TEST_MEMORY )
+
+	for( test_number = 0;
+	     test_number < number_of_malloc_fail_tests;
+	     test_number++ )
+	{
+		/* Test libqcow_cache_pool_initialize with malloc failing
+		 */
+		qcow_test_malloc_attempts_before_fail = test_number;
+
+		result = libqcow_cache_pool_initialize(
+		          &cache_pool,
+		          1024 * 1024,
+		          &error );
+
+		if( qcow_test_malloc_attempts_before_fail != -1 )
+		{
+			qcow_test_malloc_attempts_before_fail = -1;
+
+			if( cache_pool != NULL )
+			{
+				libqcow_cache_pool_free(
+				 &cache_pool,
+				 NULL );
+			}
+		}
+		else
+		{
+			QCOW_TEST_ASSERT_EQUAL_INT(
+			 "result",
+			 result,
+			 -1 );
+
+			QCOW_TEST_ASSERT_IS_NULL(
+			 "cache_pool",
+			 cache_pool );
+
+			QCOW_TEST_ASSERT_IS_NOT_NULL(
+			 "error",
+			 error );
+
+			libcerror_error_free(
+			 &error );
+		}
+	}
+	for( test_number = 0;
+	     test_number < number_of_memset_fail_tests;
+	     test_number++ )
+	{
+		/* Test libqcow_cache_pool_initialize with memset failing
+		 */
+		qcow_test_memset_attempts_before_fail = test_number;
+
+		result = libqcow_cache_pool_initialize(
+		          &cache_pool,
+		          1024 * 1024,
+		          &error );
+
+		if( qcow_test_memset_attempts_before_fail != -1 )
+		{
+			qcow_test_memset_attempts_before_fail = -1;
+
+			if( cache_pool != NULL )
+			{
+				libqcow_cache_pool_free(
+				 &cache_pool,
+				 NULL );
+			}
+		}
+		else
+		{
+			QCOW_TEST_ASSERT_EQUAL_INT(
+			 "result",
+			 result,
+			 -1 );
+
+			QCOW_TEST_ASSERT_IS_NULL(
+			 "cache_pool",
+			 cache_pool );
+
+			QCOW_TEST_ASSERT_IS_NOT_NULL(
+			 "error",
+			 error );
+
+			libcerror_error_free(
+			 &error );
+		}
+	}
+#endif /* defined( HAVE_QCOW_TEST_MEMORY ) */
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	if( cache_pool != NULL )
+	{
+		libqcow_cache_pool_free(
+		 &cache_pool,
+		 NULL );
+	}
+	return( 0 );
+}
+
+/* Tests the libqcow_cache_pool_free function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_cache_pool_free(
+     void )
+{
+	libcerror_error_t *error = NULL;
+	int result               = 0;
+
+	/* Test error cases
+	 */
+	result = libqcow_cache_pool_free(
+	          NULL,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	return( 0 );
+}
+
+/* Tests the libqcow_cache_pool_get_size function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_cache_pool_get_size(
+     void )
+{
+	libcerror_error_t *error         = NULL;
+	libqcow_cache_pool_t *cache_pool = NULL;
+	size64_t size                    = 0;
+	int result                       = 0;
+
+	/* Initialize test
+	 */
+	result = libqcow_cache_pool_initialize(
+	          &cache_pool,
+	          1024 * 1024,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "cache_pool",
+	 cache_pool );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test regular cases
+	 */
+	result = libqcow_cache_pool_get_size(
+	          cache_pool,
+	          &size,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT64(
+	 "size",
+	 (uint64_t) size,
+	 (uint64_t) 0 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test error cases
+	 */
+	result = libqcow_cache_pool_get_size(
+	          NULL,
+	          &size,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_cache_pool_get_size(
+	          cache_pool,
+	          NULL,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	/* Clean up
+	 */
+	result = libqcow_cache_pool_free(
+	          &cache_pool,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "cache_pool",
+	 cache_pool );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	if( cache_pool != NULL )
+	{
+		libqcow_cache_pool_free(
+		 &cache_pool,
+		 NULL );
+	}
+	return( 0 );
+}
+
+#if defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT )
+
+/* Tests the libqcow_cache_pool_set_cluster_block function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_cache_pool_set_cluster_block(
+     void )
+{
+	libqcow_file_identity_t file_identity   = { 1, 2, 4096 };
+	libcerror_error_t *error                = NULL;
+	libqcow_cache_pool_t *cache_pool        = NULL;
+	libqcow_cluster_block_t *cluster_block  = NULL;
+	libqcow_cluster_block_t *cached_block   = NULL;
+	size64_t size                           = 0;
+	uint64_t offset                         = 0;
+	int result                              = 0;
+
+	/* Initialize test
+	 */
+	result = libqcow_cache_pool_initialize(
+	          &cache_pool,
+	          2048,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "cache_pool",
+	 cache_pool );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test regular cases
+	 */
+	result = libqcow_cache_pool_get_cluster_block(
+	          cache_pool,
+	          &file_identity,
+	          LIBQCOW_CACHE_POOL_VALUE_TYPE_CLUSTER_BLOCK,
+	          0,
+	          &cached_block,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "cached_block",
+	 cached_block );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Cache 3 values of 1024 bytes in a pool of 2048 bytes
+	 */
+	for( offset = 0;
+	     offset < 3 * 1024;
+	     offset += 1024 )
+	{
+		result = libqcow_cluster_block_initialize(
+		          &cluster_block,
+		          1024,
+		          &error );
+
+		QCOW_TEST_ASSERT_EQUAL_INT(
+		 "result",
+		 result,
+		 1 );
+
+		QCOW_TEST_ASSERT_IS_NOT_NULL(
+		 "cluster_block",
+		 cluster_block );
+
+		QCOW_TEST_ASSERT_IS_NULL(
+		 "error",
+		 error );
+
+		result = libqcow_cache_pool_set_cluster_block(
+		          cache_pool,
+		          &file_identity,
+		          LIBQCOW_CACHE_POOL_VALUE_TYPE_CLUSTER_BLOCK,
+		          offset,
+		          cluster_block,
+		          1024,
+		          &error );
+
+		QCOW_TEST_ASSERT_EQUAL_INT(
+		 "result",
+		 result,
+		 1 );
+
+		QCOW_TEST_ASSERT_IS_NULL(
+		 "error",
+		 error );
+
+		QCOW_TEST_ASSERT_EQUAL_INT(
+		 "cluster_block->number_of_pins",
+		 cluster_block->number_of_pins,
+		 1 );
+
+		result = libqcow_cache_pool_unpin_cluster_block(
+		          cache_pool,
+		          &cluster_block,
+		          &error );
+
+		QCOW_TEST_ASSERT_EQUAL_INT(
+		 "result",
+		 result,
+		 1 );
+
+		QCOW_TEST_ASSERT_IS_NULL(
+		 "cluster_block",
+		 cluster_block );
+
+		QCOW_TEST_ASSERT_IS_NULL(
+		 "error",
+		 error );
+	}
+	result = libqcow_cache_pool_get_size(
+	          cache_pool,
+	          &size,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT64(
+	 "size",
+	 (uint64_t) size,
+	 (uint64_t) 2048 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* The least recently used value was evicted
+	 */
+	result = libqcow_cache_pool_get_cluster_block(
+	          cache_pool,
+	          &file_identity,
+	          LIBQCOW_CACHE_POOL_VALUE_TYPE_CLUSTER_BLOCK,
+	          0,
+	          &cached_block,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* A value of another type or file is not shared
+	 */
+	result = libqcow_cache_pool_get_cluster_block(
+	          cache_pool,
+	          &file_identity,
+	          LIBQCOW_CACHE_POOL_VALUE_TYPE_COMPRESSED_CLUSTER_BLOCK,
+	          1024,
+	          &cached_block,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	file_identity.inode_number = 3;
+
+	result = libqcow_cache_pool_get_cluster_block(
+	          cache_pool,
+	          &file_identity,
+	          LIBQCOW_CACHE_POOL_VALUE_TYPE_CLUSTER_BLOCK,
+	          1024,
+	          &cached_block,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	file_identity.inode_number = 2;
+
+	result = libqcow_cache_pool_get_cluster_block(
+	          cache_pool,
+	          &file_identity,
+	          LIBQCOW_CACHE_POOL_VALUE_TYPE_CLUSTER_BLOCK,
+	          1024,
+	          &cached_block,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "cached_block",
+	 cached_block );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "cached_block->number_of_pins",
+	 cached_block->number_of_pins,
+	 1 );
+
+	/* A pinned value is not evicted
+	 */
+	result = libqcow_cluster_block_initialize(
+	          &cluster_block,
+	          1024,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_cache_pool_set_cluster_block(
+	          cache_pool,
+	          &file_identity,
+	          LIBQCOW_CACHE_POOL_VALUE_TYPE_CLUSTER_BLOCK,
+	          4096,
+	          cluster_block,
+	          1024,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test error cases
+	 */
+	result = libqcow_cache_pool_set_cluster_block(
+	          cache_pool,
+	          &file_identity,
+	          LIBQCOW_CACHE_POOL_VALUE_TYPE_CLUSTER_BLOCK,
+	          8192,
+	          cluster_block,
+	          1024,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_cache_pool_unpin_cluster_block(
+	          cache_pool,
+	          &cluster_block,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_cache_pool_get_cluster_block(
+	          cache_pool,
+	          &file_identity,
+	          LIBQCOW_CACHE_POOL_VALUE_TYPE_CLUSTER_BLOCK,
+	          1024,
+	          &cluster_block,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "cluster_block->number_of_pins",
+	 cluster_block->number_of_pins,
+	 2 );
+
+	result = libqcow_cache_pool_unpin_cluster_block(
+	          cache_pool,
+	          &cluster_block,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_cache_pool_unpin_cluster_block(
+	          cache_pool,
+	          &cached_block,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "cached_block",
+	 cached_block );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_cache_pool_set_cluster_block(
+	          NULL,
+	          &file_identity,
+	          LIBQCOW_CACHE_POOL_VALUE_TYPE_CLUSTER_BLOCK,
+	          0,
+	          cluster_block,
+	          1024,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_cache_pool_get_cluster_block(
+	          NULL,
+	          &file_identity,
+	          LIBQCOW_CACHE_POOL_VALUE_TYPE_CLUSTER_BLOCK,
+	          0,
+	          &cached_block,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	/* Clean up
+	 */
+	result = libqcow_cache_pool_free(
+	          &cache_pool,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "cache_pool",
+	 cache_pool );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	if( cache_pool != NULL )
+	{
+		libqcow_cache_pool_free(
+		 &cache_pool,
+		 NULL );
+	}
+	return( 0 );
+}
+
+/* Tests the libqcow_cache_pool_get_cluster_block_or_begin_load function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_cache_pool_get_cluster_block_or_begin_load(
+     void )
+{
+	libqcow_file_identity_t file_identity  = { 1, 2, 4096 };
+	libcerror_error_t *error               = NULL;
+	libqcow_cache_pool_t *cache_pool       = NULL;
+	libqcow_cluster_block_t *cluster_block = NULL;
+	libqcow_cluster_block_t *cached_block  = NULL;
+	uint8_t is_loading                     = 0;
+	int result                             = 0;
+
+	/* Initialize test
+	 */
+	result = libqcow_cache_pool_initialize(
+	          &cache_pool,
+	          1024 * 1024,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "cache_pool",
+	 cache_pool );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test regular cases
+	 */
+	result = libqcow_cache_pool_get_cluster_block_or_begin_load(
+	          cache_pool,
+	          &file_identity,
+	          LIBQCOW_CACHE_POOL_VALUE_TYPE_COMPRESSED_CLUSTER_BLOCK,
+	          8192,
+	          &cached_block,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "cached_block",
+	 cached_block );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	is_loading = 1;
+
+	result = libqcow_cluster_block_initialize(
+	          &cluster_block,
+	          1024,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_cache_pool_set_cluster_block(
+	          cache_pool,
+	          &file_identity,
+	          LIBQCOW_CACHE_POOL_VALUE_TYPE_COMPRESSED_CLUSTER_BLOCK,
+	          8192,
+	          cluster_block,
+	          1024,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_cache_pool_unpin_cluster_block(
+	          cache_pool,
+	          &cluster_block,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_cache_pool_end_load(
+	          cache_pool,
+	          &file_identity,
+	          LIBQCOW_CACHE_POOL_VALUE_TYPE_COMPRESSED_CLUSTER_BLOCK,
+	          8192,
+	          &error );
+
+	is_loading = 0;
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_cache_pool_get_cluster_block_or_begin_load(
+	          cache_pool,
+	          &file_identity,
+	          LIBQCOW_CACHE_POOL_VALUE_TYPE_COMPRESSED_CLUSTER_BLOCK,
+	          8192,
+	          &cached_block,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "cached_block",
+	 cached_block );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_cache_pool_unpin_cluster_block(
+	          cache_pool,
+	          &cached_block,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test error cases
+	 */
+	result = libqcow_cache_pool_get_cluster_block_or_begin_load(
+	          NULL,
+	          &file_identity,
+	          LIBQCOW_CACHE_POOL_VALUE_TYPE_COMPRESSED_CLUSTER_BLOCK,
+	          8192,
+	          &cached_block,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_cache_pool_end_load(
+	          NULL,
+	          &file_identity,
+	          LIBQCOW_CACHE_POOL_VALUE_TYPE_COMPRESSED_CLUSTER_BLOCK,
+	          8192,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+#if defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT )
+	/* Test libqcow_cache_pool_end_load without a load
+	 */
+	result = libqcow_cache_pool_end_load(
+	          cache_pool,
+	          &file_identity,
+	          LIBQCOW_CACHE_POOL_VALUE_TYPE_COMPRESSED_CLUSTER_BLOCK,
+	          8192,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+#endif /* defined( HAVE_LIBQCOW_MULTI_THREAD_SUPPORT ) */
+
+	/* Clean up
+	 */
+	result = libqcow_cache_pool_free(
+	          &cache_pool,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	if( is_loading != 0 )
+	{
+		libqcow_cache_pool_end_load(
+		 cache_pool,
+		 &file_identity,
+		 LIBQCOW_CACHE_POOL_VALUE_TYPE_COMPRESSED_CLUSTER_BLOCK,
+		 8192,
+		 NULL );
+	}
+	if( cluster_block != NULL )
+	{
+		libqcow_cluster_block_free(
+		 &cluster_block,
+		 NULL );
+	}
+	if( cache_pool != NULL )
+	{
+		libqcow_cache_pool_free(
+		 &cache_pool,
+		 NULL );
+	}
+	return( 0 );
+}
+
+/* Tests the libqcow_internal_cache_pool_get_shard function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_internal_cache_pool_get_shard(
+     void )
+{
+	libqcow_file_identity_t file_identity = { 1, 2, 4096 };
+	libcerror_error_t *error              = NULL;
+	libqcow_cache_pool_t *cache_pool      = NULL;
+	uint64_t offset                       = 0;
+	int bucket_index                      = 0;
+	int first_shard_index                 = 0;
+	int result                            = 0;
+	int shard_index                       = 0;
+	int spread_over_shards                = 0;
+
+	/* Initialize test
+	 */
+	result = libqcow_cache_pool_initialize(
+	          &cache_pool,
+	          64 * 1024 * 1024,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "cache_pool",
+	 cache_pool );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "number_of_shards",
+	 ( (libqcow_internal_cache_pool_t *) cache_pool )->number_of_shards,
+	 LIBQCOW_CACHE_POOL_MAXIMUM_NUMBER_OF_SHARDS );
+
+	/* Test regular cases
+	 */
+	result = libqcow_internal_cache_pool_get_shard(
+	          (libqcow_internal_cache_pool_t *) cache_pool,
+	          &file_identity,
+	          LIBQCOW_CACHE_POOL_VALUE_TYPE_CLUSTER_BLOCK,
+	          0,
+	          &first_shard_index,
+	          &bucket_index,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	QCOW_TEST_ASSERT_GREATER_THAN_INT(
+	 "first_shard_index",
+	 first_shard_index,
+	 -1 );
+
+	QCOW_TEST_ASSERT_LESS_THAN_INT(
+	 "first_shard_index",
+	 first_shard_index,
+	 LIBQCOW_CACHE_POOL_MAXIMUM_NUMBER_OF_SHARDS );
+
+	/* The same value must always map onto the same shard
+	 */
+	result = libqcow_internal_cache_pool_get_shard(
+	          (libqcow_internal_cache_pool_t *) cache_pool,
+	          &file_identity,
+	          LIBQCOW_CACHE_POOL_VALUE_TYPE_CLUSTER_BLOCK,
+	          0,
+	          &shard_index,
+	          &bucket_index,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "shard_index",
+	 shard_index,
+	 first_shard_index );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Consecutive cluster blocks must be spread over the shards
+	 */
+	for( offset = 65536;
+	     offset < 64 * 65536;
+	     offset += 65536 )
+	{
+		result = libqcow_internal_cache_pool_get_shard(
+		          (libqcow_internal_cache_pool_t *) cache_pool,
+		          &file_identity,
+		          LIBQCOW_CACHE_POOL_VALUE_TYPE_CLUSTER_BLOCK,
+		          offset,
+		          &shard_index,
+		          &bucket_index,
+		          &error );
+
+		QCOW_TEST_ASSERT_EQUAL_INT(
+		 "result",
+		 result,
+		 1 );
+
+		QCOW_TEST_ASSERT_IS_NULL(
+		 "error",
+		 error );
+
+		if( shard_index != first_shard_index )
+		{
+			spread_over_shards = 1;
+		}
+	}
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "spread_over_shards",
+	 spread_over_shards,
+	 1 );
+
+	/* Test error cases
+	 */
+	result = libqcow_internal_cache_pool_get_shard(
+	          NULL,
+	          &file_identity,
+	          LIBQCOW_CACHE_POOL_VALUE_TYPE_CLUSTER_BLOCK,
+	          0,
+	          &shard_index,
+	          &bucket_index,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_internal_cache_pool_get_shard(
+	          (libqcow_internal_cache_pool_t *) cache_pool,
+	          NULL,
+	          LIBQCOW_CACHE_POOL_VALUE_TYPE_CLUSTER_BLOCK,
+	          0,
+	          &shard_index,
+	          &bucket_index,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_internal_cache_pool_get_shard(
+	          (libqcow_internal_cache_pool_t *) cache_pool,
+	          &file_identity,
+	          LIBQCOW_CACHE_POOL_VALUE_TYPE_CLUSTER_BLOCK,
+	          0,
+	          NULL,
+	          &bucket_index,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_internal_cache_pool_get_shard(
+	          (libqcow_internal_cache_pool_t *) cache_pool,
+	          &file_identity,
+	          LIBQCOW_CACHE_POOL_VALUE_TYPE_CLUSTER_BLOCK,
+	          0,
+	          &shard_index,
+	          NULL,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	/* Clean up
+	 */
+	result = libqcow_cache_pool_free(
+	          &cache_pool,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "cache_pool",
+	 cache_pool );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	if( cache_pool != NULL )
+	{
+		libqcow_cache_pool_free(
+		 &cache_pool,
+		 NULL );
+	}
+	return( 0 );
+}
+
+#endif /* defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT ) */
+
+/* The main program
+ */
+#if defined( HAVE_WIDE_SYSTEM_CHARACTER )
+int wmain(
+     int argc QCOW_TEST_ATTRIBUTE_UNUSED,
+     wchar_t * const argv[] QCOW_TEST_ATTRIBUTE_UNUSED )
+#else
+int main(
+     int argc QCOW_TEST_ATTRIBUTE_UNUSED,
+     char * const argv[] QCOW_TEST_ATTRIBUTE_UNUSED )
+#endif
+{
+	QCOW_TEST_UNREFERENCED_PARAMETER( argc )
+	QCOW_TEST_UNREFERENCED_PARAMETER( argv )
+
+	QCOW_TEST_RUN(
+	 "libqcow_cache_pool_initialize",
+	 qcow_test_cache_pool_initialize );
+
+	QCOW_TEST_RUN(
+	 "libqcow_cache_pool_free",
+	 qcow_test_cache_pool_free );
+
+	QCOW_TEST_RUN(
+	 "libqcow_cache_pool_get_size",
+	 qcow_test_cache_pool_get_size );
+
+#if defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT )
+
+	QCOW_TEST_RUN(
+	 "libqcow_cache_pool_set_cluster_block",
+	 qcow_test_cache_pool_set_cluster_block );
+
+	QCOW_TEST_RUN(
+	 "libqcow_cache_pool_get_cluster_block_or_begin_load",
+	 qcow_test_cache_pool_get_cluster_block_or_begin_load );
+
+	QCOW_TEST_RUN(
+	 "libqcow_internal_cache_pool_get_shard",
+	 qcow_test_internal_cache_pool_get_shard );
+
+#endif /* defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT ) */
+
+	return( EXIT_SUCCESS );
+
+on_error:
+	return( EXIT_FAILURE );
+}
+
@@ -0,0 +1,768 @@
+/*
+ * Library chain_index type test program
+ *
+ * Copyright (C) 2010-2026, Joachim Metz <joachim.metz@gmail.com>
+ *
+ * Refer to AUTHORS for acknowledgements.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <common.h>
+#include <memory.h>
+#include <types.h>
+
+#if defined( HAVE_STDLIB_H ) || defined( WINAPI )
+#include <stdlib.h>
+#endif
+
+#include "qcow_test_libcerror.h"
+#include "qcow_test_libqcow.h"
+#include "qcow_test_macros.h"
+#include "qcow_test_memory.h"
+#include "qcow_test_unused.h"
+
+#include "../libqcow/libqcow_chain_index.h"
+
+#if defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT )
+
+/* Tests the libqcow_chain_index_initialize function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_chain_index_initialize(
+     void )
+{
+	libcerror_error_t *error           = NULL;
+	libqcow_chain_index_t *chain_index = NULL;
+	int result                         = 0;
+
+#if defined( HAVE_QCOW_TEST_MEMORY )
+	int number_of_malloc_fail_tests    = 2;
+	int number_of_memset_fail_tests    = 2;
+	int test_number                    = 0;
+#endif
+
+	/* Test regular cases
+	 */
+	result = libqcow_chain_index_initialize(
+	          &chain_index,
+	          16,
+	          16,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "chain_index",
+	 chain_index );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_chain_index_free(
+	          &chain_index,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "chain_index",
+	 chain_index );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test error cases
+	 */
+	result = libqcow_chain_index_initialize(
+	          NULL,
+	          16,
+	          16,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	chain_index = (libqcow_chain_index_t *) 0x12345678UL;
+
+	result = libqcow_chain_index_initialize(
+	          &chain_index,
+	          16,
+	          16,
+	          &error );
+
+	chain_index = NULL;
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_chain_index_initialize(
+	          &chain_index,
+	          0,
+	          16,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "chain_index",
+	 chain_index );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_chain_index_initialize(
+	          &chain_index,
+	          16,
+	          64,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "chain_index",
+	 chain_index );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+#if defined( HAVE_QCOW_TEST_MEMORY )
+
+	for( test_number = 0;
+	     test_number < number_of_malloc_fail_tests;
+	     test_number++ )
+	{
+		/* Test libqcow_chain_index_initialize with malloc failing
+		 */
+		qcow_test_malloc_attempts_before_fail = test_number;
+
+		result = libqcow_chain_index_initialize(
+		          &chain_index,
+		          16,
+		          16,
+		          &error );
+
+		if( qcow_test_malloc_attempts_before_fail != -1 )
+		{
+			qcow_test_malloc_attempts_before_fail = -1;
+
+			if( chain_index != NULL )
+			{
+				libqcow_chain_index_free(
+				 &chain_index,
+				 NULL );
+			}
+		}
+		else
+		{
+			QCOW_TEST_ASSERT_EQUAL_INT(
+			 "result",
+			 result,
+			 -1 );
+
+			QCOW_TEST_ASSERT_IS_NULL(
+			 "chain_index",
+			 chain_index );
+
+			QCOW_TEST_ASSERT_IS_NOT_NULL(
+			 "error",
+			 error );
+
+			libcerror_error_free(
+			 &error );
+		}
+	}
+	for( test_number = 0;
+	     test_number < number_of_memset_fail_tests;
+	     test_number++ )
+	{
+		/* Test libqcow_chain_index_initialize with memset failing
+		 */
+		qcow_test_memset_attempts_before_fail = test_number;
+
+		result = libqcow_chain_index_initialize(
+		          &chain_index,
+		          16,
+		          16,
+		          &error );
+
+		if( qcow_test_memset_attempts_before_fail != -1 )
+		{
+			qcow_test_memset_attempts_before_fail = -1;
+
+			if( chain_index != NULL )
+			{
+				libqcow_chain_index_free(
+				 &chain_index,
+				 NULL );
+			}
+		}
+		else
+		{
+			QCOW_TEST_ASSERT_EQUAL_INT(
+			 "result",
+			 result,
+			 -1 );
+
+			QCOW_TEST_ASSERT_IS_NULL(
+			 "chain_index",
+			 chain_index );
+
+			QCOW_TEST_ASSERT_IS_NOT_NULL(
+			 "error",
+			 error );
+
+			libcerror_error_free(
+			 &error );
+		}
+	}
+#endif /* defined( HAVE_QCOW_TEST_MEMORY ) */
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	if( chain_index != NULL )
+	{
+		libqcow_chain_index_free(
+		 &chain_index,
+		 NULL );
+	}
+	return( 0 );
+}
+
+/* Tests the libqcow_chain_index_free function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_chain_index_free(
+     void )
+{
+	libcerror_error_t *error = NULL;
+	int result               = 0;
+
+	/* Test error cases
+	 */
+	result = libqcow_chain_index_free(
+	          NULL,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	return( 0 );
+}
+
+/* Tests the libqcow_chain_index_get_entry_by_offset function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_chain_index_get_entry_by_offset(
+     void )
+{
+	libqcow_chain_index_entry_t chain_index_entry;
+
+	libcerror_error_t *error           = NULL;
+	libqcow_chain_index_t *chain_index = NULL;
+	int result                         = 0;
+
+	/* Initialize test
+	 */
+	result = libqcow_chain_index_initialize(
+	          &chain_index,
+	          16,
+	          16,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "chain_index",
+	 chain_index );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = memory_set(
+	          &chain_index_entry,
+	          0,
+	          sizeof( libqcow_chain_index_entry_t ) ) != NULL;
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	chain_index_entry.offset                    = 0x00020000;
+	chain_index_entry.size                      = 0x00008000;
+	chain_index_entry.file                      = (libqcow_file_t *) 0x12345678UL;
+	chain_index_entry.cluster_block_offset      = 0x00050000;
+	chain_index_entry.cluster_block_data_offset = 0x00001000;
+
+	result = libqcow_chain_index_set_entry(
+	          chain_index,
+	          &chain_index_entry,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test regular cases
+	 */
+	result = libqcow_chain_index_get_entry_by_offset(
+	          chain_index,
+	          0x00024000,
+	          &chain_index_entry,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT64(
+	 "chain_index_entry.offset",
+	 (int64_t) chain_index_entry.offset,
+	 (int64_t) 0x00024000 );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT64(
+	 "chain_index_entry.size",
+	 (uint64_t) chain_index_entry.size,
+	 (uint64_t) 0x00004000 );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT64(
+	 "chain_index_entry.cluster_block_data_offset",
+	 chain_index_entry.cluster_block_data_offset,
+	 (uint64_t) 0x00005000 );
+
+	result = libqcow_chain_index_get_entry_by_offset(
+	          chain_index,
+	          0x00028000,
+	          &chain_index_entry,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_chain_index_get_entry_by_offset(
+	          chain_index,
+	          0x00030000,
+	          &chain_index_entry,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test error cases
+	 */
+	result = libqcow_chain_index_get_entry_by_offset(
+	          NULL,
+	          0,
+	          &chain_index_entry,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_chain_index_get_entry_by_offset(
+	          chain_index,
+	          -1,
+	          &chain_index_entry,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_chain_index_get_entry_by_offset(
+	          chain_index,
+	          0,
+	          NULL,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	/* Clean up
+	 */
+	result = libqcow_chain_index_free(
+	          &chain_index,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "chain_index",
+	 chain_index );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	if( chain_index != NULL )
+	{
+		libqcow_chain_index_free(
+		 &chain_index,
+		 NULL );
+	}
+	return( 0 );
+}
+
+/* Tests the libqcow_chain_index_set_entry function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_chain_index_set_entry(
+     void )
+{
+	libqcow_chain_index_entry_t chain_index_entry;
+
+	libcerror_error_t *error           = NULL;
+	libqcow_chain_index_t *chain_index = NULL;
+	int result                         = 0;
+
+	/* Initialize test
+	 */
+	result = libqcow_chain_index_initialize(
+	          &chain_index,
+	          4,
+	          16,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "chain_index",
+	 chain_index );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = memory_set(
+	          &chain_index_entry,
+	          0,
+	          sizeof( libqcow_chain_index_entry_t ) ) != NULL;
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	/* Test regular cases
+	 */
+	chain_index_entry.offset = 0;
+	chain_index_entry.size   = 0x00100000;
+
+	result = libqcow_chain_index_set_entry(
+	          chain_index,
+	          &chain_index_entry,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* A range larger than the index is only retrievable from the slots it was stored in
+	 */
+	result = libqcow_chain_index_get_entry_by_offset(
+	          chain_index,
+	          0x00030000,
+	          &chain_index_entry,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "chain_index_entry.file",
+	 chain_index_entry.file );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT64(
+	 "chain_index_entry.size",
+	 (uint64_t) chain_index_entry.size,
+	 (uint64_t) 0x000d0000 );
+
+	/* Test error cases
+	 */
+	chain_index_entry.offset = 0;
+	chain_index_entry.size   = 0x00010000;
+
+	result = libqcow_chain_index_set_entry(
+	          NULL,
+	          &chain_index_entry,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_chain_index_set_entry(
+	          chain_index,
+	          NULL,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	chain_index_entry.size = 0;
+
+	result = libqcow_chain_index_set_entry(
+	          chain_index,
+	          &chain_index_entry,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	/* Clean up
+	 */
+	result = libqcow_chain_index_free(
+	          &chain_index,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "chain_index",
+	 chain_index );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	if( chain_index != NULL )
+	{
+		libqcow_chain_index_free(
+		 &chain_index,
+		 NULL );
+	}
+	return( 0 );
+}
+
+#endif /* defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT ) */
+
+/* The main program
+ */
+#if defined( HAVE_WIDE_SYSTEM_CHARACTER )
+int wmain(
+     int argc QCOW_TEST_ATTRIBUTE_UNUSED,
+     wchar_t * const argv[] QCOW_TEST_ATTRIBUTE_UNUSED )
+#else
+int main(
+     int argc QCOW_TEST_ATTRIBUTE_UNUSED,
+     char * const argv[] QCOW_TEST_ATTRIBUTE_UNUSED )
+#endif
+{
+	QCOW_TEST_UNREFERENCED_PARAMETER( argc )
+	QCOW_TEST_UNREFERENCED_PARAMETER( argv )
+
+#if defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT )
+
+	QCOW_TEST_RUN(
+	 "libqcow_chain_index_initialize",
+	 qcow_test_chain_index_initialize );
+
+	QCOW_TEST_RUN(
+	 "libqcow_chain_index_free",
+	 qcow_test_chain_index_free );
+
+	QCOW_TEST_RUN(
+	 "libqcow_chain_index_get_entry_by_offset",
+	 qcow_test_chain_index_get_entry_by_offset );
+
+	QCOW_TEST_RUN(
+	 "libqcow_chain_index_set_entry",
+	 qcow_test_chain_index_set_entry );
+
+#endif /* defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT ) */
+
+	return( EXIT_SUCCESS );
+
+on_error:
+	return( EXIT_FAILURE );
+}
+
@@ -254,6 +254,154 @@ on_error:
 	return( 0 );
 }
 
+/* Tests the libqcow_cluster_block_initialize_mapped function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_cluster_block_initialize_mapped(
+     void )
+{
+	uint8_t data[ 512 ];
+
+	libcerror_error_t *error               = NULL;
+	libqcow_cluster_block_t *cluster_block = NULL;
+	int result                             = 0;
+
+	/* Test regular cases
+	 */
+	result = libqcow_cluster_block_initialize_mapped(
+	          &cluster_block,
+	          data,
+	          512,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "cluster_block",
+	 cluster_block );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "cluster_block->data_is_mapped",
+	 (int) cluster_block->data_is_mapped,
+	 1 );
+
+	/* Test read of a cluster block with mapped data
+	 */
+	result = libqcow_cluster_block_read(
+	          cluster_block,
+	          NULL,
+	          0,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_cluster_block_free(
+	          &cluster_block,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "cluster_block",
+	 cluster_block );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test error cases
+	 */
+	result = libqcow_cluster_block_initialize_mapped(
+	          NULL,
+	          data,
+	          512,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_cluster_block_initialize_mapped(
+	          &cluster_block,
+	          NULL,
+	          512,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_cluster_block_initialize_mapped(
+	          &cluster_block,
+	          data,
+	          0,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	if( cluster_block != NULL )
+	{
+		libqcow_cluster_block_free(
+		 &cluster_block,
+		 NULL );
+	}
+	return( 0 );
+}
+
 /* Tests the libqcow_cluster_block_free function
  * Returns 1 if successful or 0 if not
  */
@@ -292,6 +440,228 @@ on_error:
 	return( 0 );
 }
 
+/* Tests the libqcow_cluster_block_pin and libqcow_cluster_block_unpin functions
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_cluster_block_pin(
+     void )
+{
+	libcerror_error_t *error               = NULL;
+	libqcow_cluster_block_t *cluster_block = NULL;
+	libqcow_cluster_block_t *pinned_block  = NULL;
+	int result                             = 0;
+
+	/* Initialize test
+	 */
+	result = libqcow_cluster_block_initialize(
+	          &cluster_block,
+	          512,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "cluster_block",
+	 cluster_block );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test regular cases
+	 */
+	result = libqcow_cluster_block_pin(
+	          cluster_block,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "cluster_block->number_of_pins",
+	 cluster_block->number_of_pins,
+	 1 );
+
+	pinned_block = cluster_block;
+
+	/* Test free of a pinned cluster block is deferred
+	 */
+	result = libqcow_cluster_block_free(
+	          &cluster_block,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "cluster_block",
+	 cluster_block );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT8(
+	 "pinned_block->is_released",
+	 pinned_block->is_released,
+	 1 );
+
+	/* Test pin of a released cluster block
+	 */
+	result = libqcow_cluster_block_pin(
+	          pinned_block,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	/* Test the last unpin frees the released cluster block
+	 */
+	result = libqcow_cluster_block_unpin(
+	          &pinned_block,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "pinned_block",
+	 pinned_block );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test error cases
+	 */
+	result = libqcow_cluster_block_pin(
+	          NULL,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_cluster_block_unpin(
+	          NULL,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_cluster_block_initialize(
+	          &cluster_block,
+	          512,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	pinned_block = cluster_block;
+
+	result = libqcow_cluster_block_unpin(
+	          &pinned_block,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	/* Clean up
+	 */
+	result = libqcow_cluster_block_free(
+	          &cluster_block,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "cluster_block",
+	 cluster_block );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	if( pinned_block != NULL )
+	{
+		libqcow_cluster_block_unpin(
+		 &pinned_block,
+		 NULL );
+	}
+	if( cluster_block != NULL )
+	{
+		libqcow_cluster_block_free(
+		 &cluster_block,
+		 NULL );
+	}
+	return( 0 );
+}
+
 /* Tests the libqcow_cluster_block_read function
  * Returns 1 if successful or 0 if not
  */
@@ -441,10 +811,18 @@ int main(
 	 "libqcow_cluster_block_initialize",
 	 qcow_test_cluster_block_initialize );
 
+	QCOW_TEST_RUN(
+	 "libqcow_cluster_block_initialize_mapped",
+	 qcow_test_cluster_block_initialize_mapped );
+
 	QCOW_TEST_RUN(
 	 "libqcow_cluster_block_free",
 	 qcow_test_cluster_block_free );
 
+	QCOW_TEST_RUN(
+	 "libqcow_cluster_block_pin",
+	 qcow_test_cluster_block_pin );
+
 	QCOW_TEST_RUN(
 	 "libqcow_cluster_block_read",
 	 qcow_test_cluster_block_read );
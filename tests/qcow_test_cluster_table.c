@@ -27,6 +27,8 @@
 #include <stdlib.h>
 #endif
 
+#include "qcow_test_functions.h"
+#include "qcow_test_libbfio.h"
 #include "qcow_test_libcerror.h"
 #include "qcow_test_libqcow.h"
 #include "qcow_test_macros.h"
@@ -35,6 +37,10 @@
 
 #include "../libqcow/libqcow_cluster_table.h"
 
+uint8_t qcow_test_cluster_table_data1[ 32 ] = {
+	0x80, 0x00, 0x00, 0x00, 0x00, 0x05, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xff,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xff, 0xff, 0xff, 0x00, 0x00, 0x00, 0x00 };
+
 #if defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT )
 
 /* Tests the libqcow_cluster_table_initialize function
@@ -270,6 +276,230 @@ on_error:
 	return( 0 );
 }
 
+/* Tests the libqcow_cluster_table_clone function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_cluster_table_clone(
+     void )
+{
+	libcerror_error_t *error                           = NULL;
+	libqcow_cluster_table_t *destination_cluster_table = NULL;
+	libqcow_cluster_table_t *source_cluster_table      = NULL;
+	uint64_t reference                                 = 0;
+	int result                                         = 0;
+
+	/* Initialize test
+	 */
+	result = libqcow_cluster_table_initialize(
+	          &source_cluster_table,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "source_cluster_table",
+	 source_cluster_table );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_cluster_table_set_references_data(
+	          source_cluster_table,
+	          qcow_test_cluster_table_data1,
+	          32,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test regular cases
+	 */
+	result = libqcow_cluster_table_clone(
+	          &destination_cluster_table,
+	          source_cluster_table,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "destination_cluster_table",
+	 destination_cluster_table );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "destination_cluster_table->references",
+	 destination_cluster_table->references );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "destination_cluster_table->number_of_references",
+	 destination_cluster_table->number_of_references,
+	 4 );
+
+	result = libqcow_cluster_table_get_reference_by_index(
+	          destination_cluster_table,
+	          0,
+	          &reference,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT64(
+	 "reference",
+	 reference,
+	 (uint64_t) 0x8000000000050000ULL );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_cluster_table_get_reference_by_index(
+	          destination_cluster_table,
+	          3,
+	          &reference,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT64(
+	 "reference",
+	 reference,
+	 (uint64_t) 0xffffffff00000000ULL );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_cluster_table_free(
+	          &destination_cluster_table,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_cluster_table_clone(
+	          &destination_cluster_table,
+	          NULL,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "destination_cluster_table",
+	 destination_cluster_table );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test error cases
+	 */
+	result = libqcow_cluster_table_clone(
+	          NULL,
+	          source_cluster_table,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	destination_cluster_table = (libqcow_cluster_table_t *) 0x12345678UL;
+
+	result = libqcow_cluster_table_clone(
+	          &destination_cluster_table,
+	          source_cluster_table,
+	          &error );
+
+	destination_cluster_table = NULL;
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	/* Clean up
+	 */
+	result = libqcow_cluster_table_free(
+	          &source_cluster_table,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	if( destination_cluster_table != NULL )
+	{
+		libqcow_cluster_table_free(
+		 &destination_cluster_table,
+		 NULL );
+	}
+	if( source_cluster_table != NULL )
+	{
+		libqcow_cluster_table_free(
+		 &source_cluster_table,
+		 NULL );
+	}
+	return( 0 );
+}
+
 /* Tests the libqcow_cluster_table_get_number_of_references function
  * Returns 1 if successful or 0 if not
  */
@@ -544,14 +774,20 @@ on_error:
 	return( 0 );
 }
 
-/* Tests the libqcow_cluster_table_read function
+/* Tests the libqcow_cluster_table_set_references_data function
  * Returns 1 if successful or 0 if not
  */
-int qcow_test_cluster_table_read(
+int qcow_test_cluster_table_set_references_data(
      void )
 {
+	uint8_t references_data[ 16 ] = {
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x05, 0x00, 0x00,
+		0x80, 0x00, 0x00, 0x00, 0x00, 0x07, 0x00, 0x00 };
+
 	libcerror_error_t *error               = NULL;
 	libqcow_cluster_table_t *cluster_table = NULL;
+	uint64_t reference                     = 0;
+	int number_of_references               = 0;
 	int result                             = 0;
 
 	/* Initialize test
@@ -573,13 +809,66 @@ int qcow_test_cluster_table_read(
 	 "error",
 	 error );
 
-	/* Test error cases
+	/* Test regular cases
 	 */
-	result = libqcow_cluster_table_read(
-	          NULL,
-	          NULL,
-	          0,
-	          0,
+	result = libqcow_cluster_table_set_references_data(
+	          cluster_table,
+	          references_data,
+	          16,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_cluster_table_get_number_of_references(
+	          cluster_table,
+	          &number_of_references,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "number_of_references",
+	 number_of_references,
+	 2 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_cluster_table_get_reference_by_index(
+	          cluster_table,
+	          1,
+	          &reference,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT64(
+	 "reference",
+	 reference,
+	 (uint64_t) 0x8000000000070000ULL );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_cluster_table_get_reference_by_index(
+	          cluster_table,
+	          2,
+	          &reference,
 	          &error );
 
 	QCOW_TEST_ASSERT_EQUAL_INT(
@@ -594,11 +883,12 @@ int qcow_test_cluster_table_read(
 	libcerror_error_free(
 	 &error );
 
-	result = libqcow_cluster_table_read(
-	          cluster_table,
+	/* Test error cases
+	 */
+	result = libqcow_cluster_table_set_references_data(
 	          NULL,
-	          0,
-	          0,
+	          references_data,
+	          16,
 	          &error );
 
 	QCOW_TEST_ASSERT_EQUAL_INT(
@@ -613,11 +903,10 @@ int qcow_test_cluster_table_read(
 	libcerror_error_free(
 	 &error );
 
-	result = libqcow_cluster_table_read(
+	result = libqcow_cluster_table_set_references_data(
 	          cluster_table,
-	          NULL,
-	          -1,
-	          0,
+	          references_data,
+	          16,
 	          &error );
 
 	QCOW_TEST_ASSERT_EQUAL_INT(
@@ -644,8 +933,243 @@ int qcow_test_cluster_table_read(
 	 1 );
 
 	QCOW_TEST_ASSERT_IS_NULL(
-	 "cluster_table",
-	 cluster_table );
+	 "error",
+	 error );
+
+	/* Initialize test
+	 */
+	result = libqcow_cluster_table_initialize(
+	          &cluster_table,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test error cases
+	 */
+	result = libqcow_cluster_table_set_references_data(
+	          cluster_table,
+	          NULL,
+	          16,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_cluster_table_set_references_data(
+	          cluster_table,
+	          references_data,
+	          12,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	/* Clean up
+	 */
+	result = libqcow_cluster_table_free(
+	          &cluster_table,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "cluster_table",
+	 cluster_table );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	if( cluster_table != NULL )
+	{
+		libqcow_cluster_table_free(
+		 &cluster_table,
+		 NULL );
+	}
+	return( 0 );
+}
+
+/* Tests the libqcow_cluster_table_read function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_cluster_table_read(
+     void )
+{
+	libcerror_error_t *error               = NULL;
+	libqcow_cluster_table_t *cluster_table = NULL;
+	int result                             = 0;
+
+	/* Initialize test
+	 */
+	result = libqcow_cluster_table_initialize(
+	          &cluster_table,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "cluster_table",
+	 cluster_table );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test error cases
+	 */
+	result = libqcow_cluster_table_read(
+	          NULL,
+	          NULL,
+	          0,
+	          0,
+	          8,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_cluster_table_read(
+	          cluster_table,
+	          NULL,
+	          0,
+	          0,
+	          8,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_cluster_table_read(
+	          cluster_table,
+	          NULL,
+	          -1,
+	          0,
+	          8,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_cluster_table_read(
+	          cluster_table,
+	          NULL,
+	          0,
+	          32,
+	          12,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_cluster_table_read(
+	          cluster_table,
+	          NULL,
+	          0,
+	          24,
+	          16,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	/* Clean up
+	 */
+	result = libqcow_cluster_table_free(
+	          &cluster_table,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "cluster_table",
+	 cluster_table );
 
 	QCOW_TEST_ASSERT_IS_NULL(
 	 "error",
@@ -668,6 +1192,310 @@ on_error:
 	return( 0 );
 }
 
+/* Tests the libqcow_cluster_table_get_subcluster_bitmap_by_index function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_cluster_table_get_subcluster_bitmap_by_index(
+     void )
+{
+	libbfio_handle_t *file_io_handle       = NULL;
+	libcerror_error_t *error               = NULL;
+	libqcow_cluster_table_t *cluster_table = NULL;
+	uint64_t subcluster_bitmap             = 0;
+	int result                             = 0;
+
+	/* Initialize test
+	 */
+	result = libqcow_cluster_table_initialize(
+	          &cluster_table,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "cluster_table",
+	 cluster_table );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = qcow_test_open_file_io_handle(
+	          &file_io_handle,
+	          qcow_test_cluster_table_data1,
+	          32,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "file_io_handle",
+	 file_io_handle );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_cluster_table_read(
+	          cluster_table,
+	          file_io_handle,
+	          0,
+	          32,
+	          16,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test regular cases
+	 */
+	result = libqcow_cluster_table_get_subcluster_bitmap_by_index(
+	          cluster_table,
+	          0,
+	          &subcluster_bitmap,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT64(
+	 "subcluster_bitmap",
+	 subcluster_bitmap,
+	 (uint64_t) 0x000000000000ffffULL );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_cluster_table_get_subcluster_bitmap_by_index(
+	          cluster_table,
+	          1,
+	          &subcluster_bitmap,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT64(
+	 "subcluster_bitmap",
+	 subcluster_bitmap,
+	 (uint64_t) 0xffffffff00000000ULL );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test error cases
+	 */
+	result = libqcow_cluster_table_get_subcluster_bitmap_by_index(
+	          NULL,
+	          0,
+	          &subcluster_bitmap,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_cluster_table_get_subcluster_bitmap_by_index(
+	          cluster_table,
+	          -1,
+	          &subcluster_bitmap,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_cluster_table_get_subcluster_bitmap_by_index(
+	          cluster_table,
+	          2,
+	          &subcluster_bitmap,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_cluster_table_get_subcluster_bitmap_by_index(
+	          cluster_table,
+	          0,
+	          NULL,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	/* Clean up
+	 */
+	result = libqcow_cluster_table_free(
+	          &cluster_table,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "cluster_table",
+	 cluster_table );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test cluster table without subcluster allocation bitmaps
+	 */
+	result = libqcow_cluster_table_initialize(
+	          &cluster_table,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_cluster_table_read(
+	          cluster_table,
+	          file_io_handle,
+	          0,
+	          32,
+	          8,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_cluster_table_get_subcluster_bitmap_by_index(
+	          cluster_table,
+	          0,
+	          &subcluster_bitmap,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Clean up
+	 */
+	result = libqcow_cluster_table_free(
+	          &cluster_table,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "cluster_table",
+	 cluster_table );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = qcow_test_close_file_io_handle(
+	          &file_io_handle,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	if( cluster_table != NULL )
+	{
+		libqcow_cluster_table_free(
+		 &cluster_table,
+		 NULL );
+	}
+	if( file_io_handle != NULL )
+	{
+		libbfio_handle_free(
+		 &file_io_handle,
+		 NULL );
+	}
+	return( 0 );
+}
+
 #endif /* defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT ) */
 
 /* The main program
@@ -695,6 +1523,10 @@ int main(
 	 "libqcow_cluster_table_free",
 	 qcow_test_cluster_table_free );
 
+	QCOW_TEST_RUN(
+	 "libqcow_cluster_table_clone",
+	 qcow_test_cluster_table_clone );
+
 	QCOW_TEST_RUN(
 	 "libqcow_cluster_table_get_number_of_references",
 	 qcow_test_cluster_table_get_number_of_references );
@@ -703,10 +1535,18 @@ int main(
 	 "libqcow_cluster_table_get_reference_by_index",
 	 qcow_test_cluster_table_get_reference_by_index );
 
+	QCOW_TEST_RUN(
+	 "libqcow_cluster_table_set_references_data",
+	 qcow_test_cluster_table_set_references_data );
+
 	QCOW_TEST_RUN(
 	 "libqcow_cluster_table_read",
 	 qcow_test_cluster_table_read );
 
+	QCOW_TEST_RUN(
+	 "libqcow_cluster_table_get_subcluster_bitmap_by_index",
+	 qcow_test_cluster_table_get_subcluster_bitmap_by_index );
+
 #endif /* defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT ) */
 
 	return( EXIT_SUCCESS );
@@ -0,0 +1,1194 @@
+/*
+ * Library export_writer type test program
+ *
+ * Copyright (C) 2010-2026, Joachim Metz <joachim.metz@gmail.com>
+ *
+ * Refer to AUTHORS for acknowledgements.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <common.h>
+#include <byte_stream.h>
+#include <memory.h>
+#include <types.h>
+
+#if defined( HAVE_STDLIB_H ) || defined( WINAPI )
+#include <stdlib.h>
+#endif
+
+#include "qcow_test_libbfio.h"
+#include "qcow_test_libcerror.h"
+#include "qcow_test_libqcow.h"
+#include "qcow_test_macros.h"
+#include "qcow_test_memory.h"
+#include "qcow_test_unused.h"
+
+#include "../libqcow/libqcow_definitions.h"
+#include "../libqcow/libqcow_export_writer.h"
+
+#if defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT )
+
+#define QCOW_TEST_EXPORT_WRITER_CLUSTER_BLOCK_SIZE	65536
+#define QCOW_TEST_EXPORT_WRITER_MEDIA_SIZE		( 2 * QCOW_TEST_EXPORT_WRITER_CLUSTER_BLOCK_SIZE ) + 512
+#define QCOW_TEST_EXPORT_WRITER_OUTPUT_SIZE		( 8 * QCOW_TEST_EXPORT_WRITER_CLUSTER_BLOCK_SIZE )
+
+/* Opens a memory range file IO handle for writing
+ * Returns 1 if successful or -1 on error
+ */
+int qcow_test_export_writer_open_file_io_handle(
+     libbfio_handle_t **file_io_handle,
+     uint8_t *data,
+     size_t data_size,
+     libcerror_error_t **error )
+{
+	if( libbfio_memory_range_initialize(
+	     file_io_handle,
+	     error ) != 1 )
+	{
+		return( -1 );
+	}
+	if( libbfio_memory_range_set(
+	     *file_io_handle,
+	     data,
+	     data_size,
+	     error ) != 1 )
+	{
+		goto on_error;
+	}
+	if( libbfio_handle_open(
+	     *file_io_handle,
+	     LIBBFIO_OPEN_WRITE,
+	     error ) != 1 )
+	{
+		goto on_error;
+	}
+	return( 1 );
+
+on_error:
+	libbfio_handle_free(
+	 file_io_handle,
+	 NULL );
+
+	return( -1 );
+}
+
+/* Creates a chunk with a zero cluster block followed by a non-zero cluster block
+ * Returns 1 if successful or -1 on error
+ */
+int qcow_test_export_writer_create_chunk(
+     libqcow_export_chunk_t **export_chunk,
+     libcerror_error_t **error )
+{
+	if( libqcow_export_chunk_initialize(
+	     export_chunk,
+	     0,
+	     QCOW_TEST_EXPORT_WRITER_MEDIA_SIZE,
+	     QCOW_TEST_EXPORT_WRITER_CLUSTER_BLOCK_SIZE,
+	     error ) != 1 )
+	{
+		return( -1 );
+	}
+	if( memory_set(
+	     ( *export_chunk )->data,
+	     0,
+	     QCOW_TEST_EXPORT_WRITER_CLUSTER_BLOCK_SIZE ) == NULL )
+	{
+		goto on_error;
+	}
+	if( memory_set(
+	     &( ( ( *export_chunk )->data )[ QCOW_TEST_EXPORT_WRITER_CLUSTER_BLOCK_SIZE ] ),
+	     0x5a,
+	     QCOW_TEST_EXPORT_WRITER_MEDIA_SIZE - QCOW_TEST_EXPORT_WRITER_CLUSTER_BLOCK_SIZE ) == NULL )
+	{
+		goto on_error;
+	}
+	return( 1 );
+
+on_error:
+	libqcow_export_chunk_free(
+	 export_chunk,
+	 NULL );
+
+	return( -1 );
+}
+
+/* Tests the libqcow_export_chunk_initialize function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_export_chunk_initialize(
+     void )
+{
+	libcerror_error_t *error             = NULL;
+	libqcow_export_chunk_t *export_chunk = NULL;
+	int result                           = 0;
+
+#if defined( HAVE_QCOW_TEST_MEMORY )
+	int number_of_malloc_fail_tests      = 2;
+	int number_of_memset_fail_tests      = 2;
+	int test_number                      = 0;
+#endif
+
+	/* Test regular cases
+	 */
+	result = libqcow_export_chunk_initialize(
+	          &export_chunk,
+	          0,
+	          1000,
+	          512,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "export_chunk",
+	 export_chunk );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	QCOW_TEST_ASSERT_EQUAL_SIZE(
+	 "export_chunk->data_size",
+	 export_chunk->data_size,
+	 (size_t) 1000 );
+
+	/* The padding up to the cluster block size is zero
+	 */
+	QCOW_TEST_ASSERT_EQUAL_UINT8(
+	 "export_chunk->data[ 1023 ]",
+	 export_chunk->data[ 1023 ],
+	 0 );
+
+	result = libqcow_export_chunk_free(
+	          &export_chunk,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "export_chunk",
+	 export_chunk );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test error cases
+	 */
+	result = libqcow_export_chunk_initialize(
+	          NULL,
+	          0,
+	          1000,
+	          512,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	export_chunk = (libqcow_export_chunk_t *) 0x12345678UL;
+
+	result = libqcow_export_chunk_initialize(
+	          &export_chunk,
+	          0,
+	          1000,
+	          512,
+	          &error );
+
+	export_chunk = NULL;
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_export_chunk_initialize(
+	          &export_chunk,
+	          -1,
+	          1000,
+	          512,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "export_chunk",
+	 export_chunk );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_export_chunk_initialize(
+	          &export_chunk,
+	          0,
+	          0,
+	          512,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "export_chunk",
+	 export_chunk );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_export_chunk_initialize(
+	          &export_chunk,
+	          0,
+	          1000,
+	          0,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "export_chunk",
+	 export_chunk );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+#if defined( HAVE_QCOW_TEST_MEMORY )
+
+	for( test_number = 0;
+	     test_number < number_of_malloc_fail_tests;
+	     test_number++ )
+	{
+		/* Test libqcow_export_chunk_initialize with malloc failing
+		 */
+		qcow_test_malloc_attempts_before_fail = test_number;
+
+		result = libqcow_export_chunk_initialize(
+		          &export_chunk,
+		          0,
+		          1000,
+		          512,
+		          &error );
+
+		if( qcow_test_malloc_attempts_before_fail != -1 )
+		{
+			qcow_test_malloc_attempts_before_fail = -1;
+
+			if( export_chunk != NULL )
+			{
+				libqcow_export_chunk_free(
+				 &export_chunk,
+				 NULL );
+			}
+		}
+		else
+		{
+			QCOW_TEST_ASSERT_EQUAL_INT(
+			 "result",
+			 result,
+			 -1 );
+
+			QCOW_TEST_ASSERT_IS_NULL(
+			 "export_chunk",
+			 export_chunk );
+
+			QCOW_TEST_ASSERT_IS_NOT_NULL(
+			 "error",
+			 error );
+
+			libcerror_error_free(
+			 &error );
+		}
+	}
+	for( test_number = 0;
+	     test_number < number_of_memset_fail_tests;
+	     test_number++ )
+	{
+		/* Test libqcow_export_chunk_initialize with memset failing
+		 */
+		qcow_test_memset_attempts_before_fail = test_number;
+
+		result = libqcow_export_chunk_initialize(
+		          &export_chunk,
+		          0,
+		          1000,
+		          512,
+		          &error );
+
+		if( qcow_test_memset_attempts_before_fail != -1 )
+		{
+			qcow_test_memset_attempts_before_fail = -1;
+
+			if( export_chunk != NULL )
+			{
+				libqcow_export_chunk_free(
+				 &export_chunk,
+				 NULL );
+			}
+		}
+		else
+		{
+			QCOW_TEST_ASSERT_EQUAL_INT(
+			 "result",
+			 result,
+			 -1 );
+
+			QCOW_TEST_ASSERT_IS_NULL(
+			 "export_chunk",
+			 export_chunk );
+
+			QCOW_TEST_ASSERT_IS_NOT_NULL(
+			 "error",
+			 error );
+
+			libcerror_error_free(
+			 &error );
+		}
+	}
+#endif /* defined( HAVE_QCOW_TEST_MEMORY ) */
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	if( export_chunk != NULL )
+	{
+		libqcow_export_chunk_free(
+		 &export_chunk,
+		 NULL );
+	}
+	return( 0 );
+}
+
+/* Tests the libqcow_export_chunk_free function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_export_chunk_free(
+     void )
+{
+	libcerror_error_t *error = NULL;
+	int result               = 0;
+
+	/* Test error cases
+	 */
+	result = libqcow_export_chunk_free(
+	          NULL,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	return( 0 );
+}
+
+/* Tests the libqcow_export_writer_initialize function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_export_writer_initialize(
+     void )
+{
+	uint8_t output_data[ 16 ];
+
+	libbfio_handle_t *file_io_handle       = NULL;
+	libcerror_error_t *error               = NULL;
+	libqcow_export_writer_t *export_writer = NULL;
+	int result                             = 0;
+
+	/* Initialize test
+	 */
+	result = qcow_test_export_writer_open_file_io_handle(
+	          &file_io_handle,
+	          output_data,
+	          16,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "file_io_handle",
+	 file_io_handle );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test regular cases
+	 */
+	result = libqcow_export_writer_initialize(
+	          &export_writer,
+	          file_io_handle,
+	          LIBQCOW_EXPORT_FORMAT_QCOW2,
+	          QCOW_TEST_EXPORT_WRITER_MEDIA_SIZE,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "export_writer",
+	 export_writer );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT32(
+	 "export_writer->number_of_level1_table_references",
+	 export_writer->number_of_level1_table_references,
+	 1 );
+
+	result = libqcow_export_writer_free(
+	          &export_writer,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "export_writer",
+	 export_writer );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test error cases
+	 */
+	result = libqcow_export_writer_initialize(
+	          NULL,
+	          file_io_handle,
+	          LIBQCOW_EXPORT_FORMAT_QCOW2,
+	          QCOW_TEST_EXPORT_WRITER_MEDIA_SIZE,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	export_writer = (libqcow_export_writer_t *) 0x12345678UL;
+
+	result = libqcow_export_writer_initialize(
+	          &export_writer,
+	          file_io_handle,
+	          LIBQCOW_EXPORT_FORMAT_QCOW2,
+	          QCOW_TEST_EXPORT_WRITER_MEDIA_SIZE,
+	          &error );
+
+	export_writer = NULL;
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_export_writer_initialize(
+	          &export_writer,
+	          NULL,
+	          LIBQCOW_EXPORT_FORMAT_QCOW2,
+	          QCOW_TEST_EXPORT_WRITER_MEDIA_SIZE,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "export_writer",
+	 export_writer );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_export_writer_initialize(
+	          &export_writer,
+	          file_io_handle,
+	          0,
+	          QCOW_TEST_EXPORT_WRITER_MEDIA_SIZE,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "export_writer",
+	 export_writer );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	/* Clean up
+	 */
+	result = libbfio_handle_free(
+	          &file_io_handle,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	if( export_writer != NULL )
+	{
+		libqcow_export_writer_free(
+		 &export_writer,
+		 NULL );
+	}
+	if( file_io_handle != NULL )
+	{
+		libbfio_handle_free(
+		 &file_io_handle,
+		 NULL );
+	}
+	return( 0 );
+}
+
+/* Tests the libqcow_export_writer_free function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_export_writer_free(
+     void )
+{
+	libcerror_error_t *error = NULL;
+	int result               = 0;
+
+	/* Test error cases
+	 */
+	result = libqcow_export_writer_free(
+	          NULL,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	return( 0 );
+}
+
+/* Tests exporting a chunk to a raw image
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_export_writer_raw(
+     void )
+{
+	libbfio_handle_t *file_io_handle       = NULL;
+	libcerror_error_t *error               = NULL;
+	libqcow_export_chunk_t *export_chunk   = NULL;
+	libqcow_export_writer_t *export_writer = NULL;
+	uint8_t *output_data                   = NULL;
+	int result                             = 0;
+
+	/* Initialize test
+	 */
+	output_data = (uint8_t *) memory_allocate(
+	                           QCOW_TEST_EXPORT_WRITER_OUTPUT_SIZE );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "output_data",
+	 output_data );
+
+	/* The zero cluster block is not written and retains the fill bytes
+	 */
+	result = ( memory_set(
+	            output_data,
+	            0xff,
+	            QCOW_TEST_EXPORT_WRITER_OUTPUT_SIZE ) != NULL );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	result = qcow_test_export_writer_open_file_io_handle(
+	          &file_io_handle,
+	          output_data,
+	          QCOW_TEST_EXPORT_WRITER_OUTPUT_SIZE,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_export_writer_initialize(
+	          &export_writer,
+	          file_io_handle,
+	          LIBQCOW_EXPORT_FORMAT_RAW,
+	          QCOW_TEST_EXPORT_WRITER_MEDIA_SIZE,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = qcow_test_export_writer_create_chunk(
+	          &export_chunk,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test regular cases
+	 */
+	result = libqcow_export_writer_push_chunk(
+	          export_writer,
+	          &export_chunk,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "export_chunk",
+	 export_chunk );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_export_writer_finalize(
+	          export_writer,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT8(
+	 "output_data[ 0 ]",
+	 output_data[ 0 ],
+	 0xff );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT8(
+	 "output_data[ 65536 ]",
+	 output_data[ QCOW_TEST_EXPORT_WRITER_CLUSTER_BLOCK_SIZE ],
+	 0x5a );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT8(
+	 "output_data[ media_size - 1 ]",
+	 output_data[ QCOW_TEST_EXPORT_WRITER_MEDIA_SIZE - 1 ],
+	 0x5a );
+
+	/* The padding of the last chunk is not written
+	 */
+	QCOW_TEST_ASSERT_EQUAL_UINT8(
+	 "output_data[ media_size ]",
+	 output_data[ QCOW_TEST_EXPORT_WRITER_MEDIA_SIZE ],
+	 0xff );
+
+	/* Clean up
+	 */
+	result = libqcow_export_writer_free(
+	          &export_writer,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libbfio_handle_free(
+	          &file_io_handle,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	memory_free(
+	 output_data );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	if( export_chunk != NULL )
+	{
+		libqcow_export_chunk_free(
+		 &export_chunk,
+		 NULL );
+	}
+	if( export_writer != NULL )
+	{
+		libqcow_export_writer_free(
+		 &export_writer,
+		 NULL );
+	}
+	if( file_io_handle != NULL )
+	{
+		libbfio_handle_free(
+		 &file_io_handle,
+		 NULL );
+	}
+	if( output_data != NULL )
+	{
+		memory_free(
+		 output_data );
+	}
+	return( 0 );
+}
+
+/* Tests exporting a chunk to a QCOW2 image
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_export_writer_qcow2(
+     void )
+{
+	libbfio_handle_t *file_io_handle       = NULL;
+	libcerror_error_t *error               = NULL;
+	libqcow_export_chunk_t *export_chunk   = NULL;
+	libqcow_export_writer_t *export_writer = NULL;
+	uint8_t *output_data                   = NULL;
+	uint64_t value_64bit                   = 0;
+	uint32_t value_32bit                   = 0;
+	uint16_t value_16bit                   = 0;
+	int result                             = 0;
+
+	/* Initialize test
+	 */
+	output_data = (uint8_t *) memory_allocate(
+	                           QCOW_TEST_EXPORT_WRITER_OUTPUT_SIZE );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "output_data",
+	 output_data );
+
+	result = ( memory_set(
+	            output_data,
+	            0,
+	            QCOW_TEST_EXPORT_WRITER_OUTPUT_SIZE ) != NULL );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	result = qcow_test_export_writer_open_file_io_handle(
+	          &file_io_handle,
+	          output_data,
+	          QCOW_TEST_EXPORT_WRITER_OUTPUT_SIZE,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_export_writer_initialize(
+	          &export_writer,
+	          file_io_handle,
+	          LIBQCOW_EXPORT_FORMAT_QCOW2,
+	          QCOW_TEST_EXPORT_WRITER_MEDIA_SIZE,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = qcow_test_export_writer_create_chunk(
+	          &export_chunk,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test regular cases
+	 */
+	result = libqcow_export_writer_push_chunk(
+	          export_writer,
+	          &export_chunk,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_export_writer_finalize(
+	          export_writer,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* The layout is: file header, level 1 table, 2 data cluster blocks,
+	 * level 2 table, reference count table and reference count block
+	 */
+	byte_stream_copy_to_uint32_big_endian(
+	 &( output_data[ 4 ] ),
+	 value_32bit );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT32(
+	 "format_version",
+	 value_32bit,
+	 2 );
+
+	byte_stream_copy_to_uint64_big_endian(
+	 &( output_data[ 24 ] ),
+	 value_64bit );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT64(
+	 "media_size",
+	 value_64bit,
+	 (uint64_t) QCOW_TEST_EXPORT_WRITER_MEDIA_SIZE );
+
+	byte_stream_copy_to_uint64_big_endian(
+	 &( output_data[ 65536 ] ),
+	 value_64bit );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT64(
+	 "level1_table[ 0 ]",
+	 value_64bit,
+	 (uint64_t) 0x8000000000040000ULL );
+
+	/* The zero cluster block is sparse
+	 */
+	byte_stream_copy_to_uint64_big_endian(
+	 &( output_data[ 0x40000 ] ),
+	 value_64bit );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT64(
+	 "level2_table[ 0 ]",
+	 value_64bit,
+	 (uint64_t) 0 );
+
+	byte_stream_copy_to_uint64_big_endian(
+	 &( output_data[ 0x40008 ] ),
+	 value_64bit );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT64(
+	 "level2_table[ 1 ]",
+	 value_64bit,
+	 (uint64_t) 0x8000000000020000ULL );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT8(
+	 "output_data[ 0x20000 ]",
+	 output_data[ 0x20000 ],
+	 0x5a );
+
+	byte_stream_copy_to_uint16_big_endian(
+	 &( output_data[ 0x60000 + ( 6 * 2 ) ] ),
+	 value_16bit );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT16(
+	 "reference_count[ 6 ]",
+	 value_16bit,
+	 1 );
+
+	byte_stream_copy_to_uint16_big_endian(
+	 &( output_data[ 0x60000 + ( 7 * 2 ) ] ),
+	 value_16bit );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT16(
+	 "reference_count[ 7 ]",
+	 value_16bit,
+	 0 );
+
+	/* Clean up
+	 */
+	result = libqcow_export_writer_free(
+	          &export_writer,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libbfio_handle_free(
+	          &file_io_handle,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	memory_free(
+	 output_data );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	if( export_chunk != NULL )
+	{
+		libqcow_export_chunk_free(
+		 &export_chunk,
+		 NULL );
+	}
+	if( export_writer != NULL )
+	{
+		libqcow_export_writer_free(
+		 &export_writer,
+		 NULL );
+	}
+	if( file_io_handle != NULL )
+	{
+		libbfio_handle_free(
+		 &file_io_handle,
+		 NULL );
+	}
+	if( output_data != NULL )
+	{
+		memory_free(
+		 output_data );
+	}
+	return( 0 );
+}
+
+#endif /* defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT ) */
+
+/* The main program
+ */
+#if defined( HAVE_WIDE_SYSTEM_CHARACTER )
+int wmain(
+     int argc QCOW_TEST_ATTRIBUTE_UNUSED,
+     wchar_t * const argv[] QCOW_TEST_ATTRIBUTE_UNUSED )
+#else
+int main(
+     int argc QCOW_TEST_ATTRIBUTE_UNUSED,
+     char * const argv[] QCOW_TEST_ATTRIBUTE_UNUSED )
+#endif
+{
+	QCOW_TEST_UNREFERENCED_PARAMETER( argc )
+	QCOW_TEST_UNREFERENCED_PARAMETER( argv )
+
+#if defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT )
+
+	QCOW_TEST_RUN(
+	 "libqcow_export_chunk_initialize",
+	 qcow_test_export_chunk_initialize );
+
+	QCOW_TEST_RUN(
+	 "libqcow_export_chunk_free",
+	 qcow_test_export_chunk_free );
+
+	QCOW_TEST_RUN(
+	 "libqcow_export_writer_initialize",
+	 qcow_test_export_writer_initialize );
+
+	QCOW_TEST_RUN(
+	 "libqcow_export_writer_free",
+	 qcow_test_export_writer_free );
+
+	QCOW_TEST_RUN(
+	 "libqcow_export_writer_raw",
+	 qcow_test_export_writer_raw );
+
+	QCOW_TEST_RUN(
+	 "libqcow_export_writer_qcow2",
+	 qcow_test_export_writer_qcow2 );
+
+#endif /* defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT ) */
+
+	return( EXIT_SUCCESS );
+
+on_error:
+	return( EXIT_FAILURE );
+}
+
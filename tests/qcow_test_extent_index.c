@@ -0,0 +1,1210 @@
+/*
+ * Library extent_index type test program
+ *
+ * Copyright (C) 2010-2026, Joachim Metz <joachim.metz@gmail.com>
+ *
+ * Refer to AUTHORS for acknowledgements.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <common.h>
+#include <file_stream.h>
+#include <types.h>
+
+#if defined( HAVE_STDLIB_H ) || defined( WINAPI )
+#include <stdlib.h>
+#endif
+
+#include "qcow_test_libcerror.h"
+#include "qcow_test_libqcow.h"
+#include "qcow_test_macros.h"
+#include "qcow_test_memory.h"
+#include "qcow_test_unused.h"
+
+#include "../libqcow/libqcow_definitions.h"
+#include "../libqcow/libqcow_extent_index.h"
+
+#if defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT )
+
+/* Tests the libqcow_extent_index_initialize function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_extent_index_initialize(
+     void )
+{
+	libcerror_error_t *error             = NULL;
+	libqcow_extent_index_t *extent_index = NULL;
+	int result                           = 0;
+
+#if defined( HAVE_QCOW_TEST_MEMORY )
+	int number_of_malloc_fail_tests      = 2;
+	int number_of_memset_fail_tests      = 2;
+	int test_number                      = 0;
+#endif
+
+	/* Test regular cases
+	 */
+	result = libqcow_extent_index_initialize(
+	          &extent_index,
+	          4,
+	          512,
+	          65536,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "extent_index",
+	 extent_index );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_extent_index_free(
+	          &extent_index,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "extent_index",
+	 extent_index );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test error cases
+	 */
+	result = libqcow_extent_index_initialize(
+	          NULL,
+	          4,
+	          512,
+	          65536,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	extent_index = (libqcow_extent_index_t *) 0x12345678UL;
+
+	result = libqcow_extent_index_initialize(
+	          &extent_index,
+	          4,
+	          512,
+	          65536,
+	          &error );
+
+	extent_index = NULL;
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_extent_index_initialize(
+	          &extent_index,
+	          0,
+	          512,
+	          65536,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_extent_index_initialize(
+	          &extent_index,
+	          4,
+	          0,
+	          65536,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_extent_index_initialize(
+	          &extent_index,
+	          4,
+	          512,
+	          0,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+#if defined( HAVE_QCOW_TEST_MEMORY )
+
+	for( test_number = 0;
+	     test_number < number_of_malloc_fail_tests;
+	     test_number++ )
+	{
+		/* Test libqcow_extent_index_initialize with malloc failing
+		 */
+		qcow_test_malloc_attempts_before_fail = test_number;
+
+		result = libqcow_extent_index_initialize(
+		          &extent_index,
+		          4,
+		          512,
+		          65536,
+		          &error );
+
+		if( qcow_test_malloc_attempts_before_fail != -1 )
+		{
+			qcow_test_malloc_attempts_before_fail = -1;
+
+			if( extent_index != NULL )
+			{
+				libqcow_extent_index_free(
+				 &extent_index,
+				 NULL );
+			}
+		}
+		else
+		{
+			QCOW_TEST_ASSERT_EQUAL_INT(
+			 "result",
+			 result,
+			 -1 );
+
+			QCOW_TEST_ASSERT_IS_NULL(
+			 "extent_index",
+			 extent_index );
+
+			QCOW_TEST_ASSERT_IS_NOT_NULL(
+			 "error",
+			 error );
+
+			libcerror_error_free(
+			 &error );
+		}
+	}
+	for( test_number = 0;
+	     test_number < number_of_memset_fail_tests;
+	     test_number++ )
+	{
+		/* Test libqcow_extent_index_initialize with memset failing
+		 */
+		qcow_test_memset_attempts_before_fail = test_number;
+
+		result = libqcow_extent_index_initialize(
+		          &extent_index,
+		          4,
+		          512,
+		          65536,
+		          &error );
+
+		if( qcow_test_memset_attempts_before_fail != -1 )
+		{
+			qcow_test_memset_attempts_before_fail = -1;
+
+			if( extent_index != NULL )
+			{
+				libqcow_extent_index_free(
+				 &extent_index,
+				 NULL );
+			}
+		}
+		else
+		{
+			QCOW_TEST_ASSERT_EQUAL_INT(
+			 "result",
+			 result,
+			 -1 );
+
+			QCOW_TEST_ASSERT_IS_NULL(
+			 "extent_index",
+			 extent_index );
+
+			QCOW_TEST_ASSERT_IS_NOT_NULL(
+			 "error",
+			 error );
+
+			libcerror_error_free(
+			 &error );
+		}
+	}
+#endif /* defined( HAVE_QCOW_TEST_MEMORY ) */
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	if( extent_index != NULL )
+	{
+		libqcow_extent_index_free(
+		 &extent_index,
+		 NULL );
+	}
+	return( 0 );
+}
+
+/* Tests the libqcow_extent_index_free function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_extent_index_free(
+     void )
+{
+	libcerror_error_t *error = NULL;
+	int result               = 0;
+
+	/* Test error cases
+	 */
+	result = libqcow_extent_index_free(
+	          NULL,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	return( 0 );
+}
+
+/* Tests the libqcow_extent_index_append_extent function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_extent_index_append_extent(
+     void )
+{
+	libcerror_error_t *error             = NULL;
+	libqcow_extent_index_t *extent_index = NULL;
+	int number_of_extents                = 0;
+	int result                           = 0;
+
+	/* Initialize test
+	 */
+	result = libqcow_extent_index_initialize(
+	          &extent_index,
+	          4,
+	          512,
+	          65536,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "extent_index",
+	 extent_index );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test regular cases
+	 */
+	result = libqcow_extent_index_append_extent(
+	          extent_index,
+	          0,
+	          0,
+	          0x00050000UL,
+	          0,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Contiguous cluster blocks are merged into the same extent
+	 */
+	result = libqcow_extent_index_append_extent(
+	          extent_index,
+	          0,
+	          1,
+	          0x00060000UL,
+	          0,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Compressed cluster blocks are never merged
+	 */
+	result = libqcow_extent_index_append_extent(
+	          extent_index,
+	          0,
+	          2,
+	          0x00070000UL,
+	          LIBQCOW_CLUSTER_BLOCK_FLAG_IS_COMPRESSED,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_extent_index_append_extent(
+	          extent_index,
+	          0,
+	          3,
+	          0x00071000UL,
+	          LIBQCOW_CLUSTER_BLOCK_FLAG_IS_COMPRESSED,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_extent_index_get_number_of_extents(
+	          extent_index,
+	          &number_of_extents,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "number_of_extents",
+	 number_of_extents,
+	 3 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test error cases
+	 */
+	result = libqcow_extent_index_append_extent(
+	          NULL,
+	          0,
+	          4,
+	          0x00080000UL,
+	          0,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_extent_index_append_extent(
+	          extent_index,
+	          -1,
+	          4,
+	          0x00080000UL,
+	          0,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_extent_index_append_extent(
+	          extent_index,
+	          4,
+	          4,
+	          0x00080000UL,
+	          0,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	/* Cluster blocks must be appended in increasing order
+	 */
+	result = libqcow_extent_index_append_extent(
+	          extent_index,
+	          0,
+	          1,
+	          0x00080000UL,
+	          0,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	/* Clean up
+	 */
+	result = libqcow_extent_index_free(
+	          &extent_index,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "extent_index",
+	 extent_index );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	if( extent_index != NULL )
+	{
+		libqcow_extent_index_free(
+		 &extent_index,
+		 NULL );
+	}
+	return( 0 );
+}
+
+/* Tests the libqcow_extent_index_finalize_level2_table function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_extent_index_finalize_level2_table(
+     void )
+{
+	libcerror_error_t *error             = NULL;
+	libqcow_extent_index_t *extent_index = NULL;
+	int cluster_block_index              = 0;
+	int number_of_extents                = 0;
+	int result                           = 0;
+
+	/* Initialize test
+	 */
+	result = libqcow_extent_index_initialize(
+	          &extent_index,
+	          4,
+	          512,
+	          65536,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "extent_index",
+	 extent_index );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test regular cases
+	 */
+	result = libqcow_extent_index_is_level2_table_scanned(
+	          extent_index,
+	          1,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_extent_index_finalize_level2_table(
+	          extent_index,
+	          1,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_extent_index_is_level2_table_scanned(
+	          extent_index,
+	          1,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* A fragmented level 2 table is not indexed
+	 */
+	for( cluster_block_index = 0;
+	     cluster_block_index < 512;
+	     cluster_block_index += 2 )
+	{
+		result = libqcow_extent_index_append_extent(
+		          extent_index,
+		          2,
+		          cluster_block_index,
+		          0x00100000UL + ( (uint64_t) ( 512 - cluster_block_index ) * 65536 ),
+		          0,
+		          &error );
+
+		QCOW_TEST_ASSERT_EQUAL_INT(
+		 "result",
+		 result,
+		 1 );
+
+		QCOW_TEST_ASSERT_IS_NULL(
+		 "error",
+		 error );
+	}
+	result = libqcow_extent_index_finalize_level2_table(
+	          extent_index,
+	          2,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_extent_index_get_number_of_extents(
+	          extent_index,
+	          &number_of_extents,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "number_of_extents",
+	 number_of_extents,
+	 0 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test error cases
+	 */
+	result = libqcow_extent_index_finalize_level2_table(
+	          NULL,
+	          1,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_extent_index_finalize_level2_table(
+	          extent_index,
+	          -1,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_extent_index_append_extent(
+	          extent_index,
+	          1,
+	          0,
+	          0x00050000UL,
+	          0,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_extent_index_is_level2_table_scanned(
+	          NULL,
+	          1,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	/* Clean up
+	 */
+	result = libqcow_extent_index_free(
+	          &extent_index,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "extent_index",
+	 extent_index );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	if( extent_index != NULL )
+	{
+		libqcow_extent_index_free(
+		 &extent_index,
+		 NULL );
+	}
+	return( 0 );
+}
+
+/* Tests the libqcow_extent_index_get_cluster_block_by_index function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_extent_index_get_cluster_block_by_index(
+     void )
+{
+	libcerror_error_t *error             = NULL;
+	libqcow_extent_index_t *extent_index = NULL;
+	uint64_t cluster_block_offset        = 0;
+	uint32_t cluster_block_flags         = 0;
+	int cluster_block_index              = 0;
+	int result                           = 0;
+
+	/* Initialize test
+	 */
+	result = libqcow_extent_index_initialize(
+	          &extent_index,
+	          4,
+	          512,
+	          65536,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "extent_index",
+	 extent_index );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	for( cluster_block_index = 8;
+	     cluster_block_index < 16;
+	     cluster_block_index++ )
+	{
+		result = libqcow_extent_index_append_extent(
+		          extent_index,
+		          0,
+		          cluster_block_index,
+		          0x00050000UL + ( (uint64_t) ( cluster_block_index - 8 ) * 65536 ),
+		          0,
+		          &error );
+
+		QCOW_TEST_ASSERT_EQUAL_INT(
+		 "result",
+		 result,
+		 1 );
+
+		QCOW_TEST_ASSERT_IS_NULL(
+		 "error",
+		 error );
+	}
+	result = libqcow_extent_index_append_extent(
+	          extent_index,
+	          0,
+	          20,
+	          0,
+	          LIBQCOW_CLUSTER_BLOCK_FLAG_IS_SPARSE,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test regular cases
+	 */
+	result = libqcow_extent_index_get_cluster_block_by_index(
+	          extent_index,
+	          0,
+	          10,
+	          &cluster_block_offset,
+	          &cluster_block_flags,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_extent_index_finalize_level2_table(
+	          extent_index,
+	          0,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_extent_index_get_cluster_block_by_index(
+	          extent_index,
+	          0,
+	          10,
+	          &cluster_block_offset,
+	          &cluster_block_flags,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT64(
+	 "cluster_block_offset",
+	 cluster_block_offset,
+	 (uint64_t) 0x00070000UL );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT32(
+	 "cluster_block_flags",
+	 cluster_block_flags,
+	 (uint32_t) 0 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_extent_index_get_cluster_block_by_index(
+	          extent_index,
+	          0,
+	          20,
+	          &cluster_block_offset,
+	          &cluster_block_flags,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT64(
+	 "cluster_block_offset",
+	 cluster_block_offset,
+	 (uint64_t) 0 );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT32(
+	 "cluster_block_flags",
+	 cluster_block_flags,
+	 (uint32_t) LIBQCOW_CLUSTER_BLOCK_FLAG_IS_SPARSE );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Cluster blocks that were not appended are unallocated
+	 */
+	cluster_block_flags = LIBQCOW_CLUSTER_BLOCK_FLAG_IS_SPARSE;
+
+	result = libqcow_extent_index_get_cluster_block_by_index(
+	          extent_index,
+	          0,
+	          2,
+	          &cluster_block_offset,
+	          &cluster_block_flags,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT64(
+	 "cluster_block_offset",
+	 cluster_block_offset,
+	 (uint64_t) 0 );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT32(
+	 "cluster_block_flags",
+	 cluster_block_flags,
+	 (uint32_t) 0 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test error cases
+	 */
+	result = libqcow_extent_index_get_cluster_block_by_index(
+	          NULL,
+	          0,
+	          10,
+	          &cluster_block_offset,
+	          &cluster_block_flags,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_extent_index_get_cluster_block_by_index(
+	          extent_index,
+	          -1,
+	          10,
+	          &cluster_block_offset,
+	          &cluster_block_flags,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_extent_index_get_cluster_block_by_index(
+	          extent_index,
+	          0,
+	          -1,
+	          &cluster_block_offset,
+	          &cluster_block_flags,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_extent_index_get_cluster_block_by_index(
+	          extent_index,
+	          0,
+	          10,
+	          NULL,
+	          &cluster_block_flags,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_extent_index_get_cluster_block_by_index(
+	          extent_index,
+	          0,
+	          10,
+	          &cluster_block_offset,
+	          NULL,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	/* Clean up
+	 */
+	result = libqcow_extent_index_free(
+	          &extent_index,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "extent_index",
+	 extent_index );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	if( extent_index != NULL )
+	{
+		libqcow_extent_index_free(
+		 &extent_index,
+		 NULL );
+	}
+	return( 0 );
+}
+
+#endif /* defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT ) */
+
+/* The main program
+ */
+#if defined( HAVE_WIDE_SYSTEM_CHARACTER )
+int wmain(
+     int argc QCOW_TEST_ATTRIBUTE_UNUSED,
+     wchar_t * const argv[] QCOW_TEST_ATTRIBUTE_UNUSED )
+#else
+int main(
+     int argc QCOW_TEST_ATTRIBUTE_UNUSED,
+     char * const argv[] QCOW_TEST_ATTRIBUTE_UNUSED )
+#endif
+{
+	QCOW_TEST_UNREFERENCED_PARAMETER( argc )
+	QCOW_TEST_UNREFERENCED_PARAMETER( argv )
+
+#if defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT )
+
+	QCOW_TEST_RUN(
+	 "libqcow_extent_index_initialize",
+	 qcow_test_extent_index_initialize );
+
+	QCOW_TEST_RUN(
+	 "libqcow_extent_index_free",
+	 qcow_test_extent_index_free );
+
+	QCOW_TEST_RUN(
+	 "libqcow_extent_index_append_extent",
+	 qcow_test_extent_index_append_extent );
+
+	QCOW_TEST_RUN(
+	 "libqcow_extent_index_finalize_level2_table",
+	 qcow_test_extent_index_finalize_level2_table );
+
+	QCOW_TEST_RUN(
+	 "libqcow_extent_index_get_cluster_block_by_index",
+	 qcow_test_extent_index_get_cluster_block_by_index );
+
+#endif /* defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT ) */
+
+	return( EXIT_SUCCESS );
+
+on_error:
+	return( EXIT_FAILURE );
+}
+
@@ -20,7 +20,9 @@
  */
 
 #include <common.h>
+#include <byte_stream.h>
 #include <file_stream.h>
+#include <memory.h>
 #include <narrow_string.h>
 #include <system_string.h>
 #include <types.h>
@@ -36,6 +38,10 @@
 
 #include <time.h>
 
+#if defined( HAVE_MULTI_THREAD_SUPPORT ) && defined( HAVE_PTHREAD_H ) && !defined( WINAPI )
+#include <pthread.h>
+#endif
+
 #include "qcow_test_functions.h"
 #include "qcow_test_getopt.h"
 #include "qcow_test_libbfio.h"
@@ -46,17 +52,132 @@
 #include "qcow_test_memory.h"
 #include "qcow_test_rwlock.h"
 
+#include "../libqcow/libqcow_definitions.h"
 #include "../libqcow/libqcow_file.h"
 
 #if defined( HAVE_WIDE_SYSTEM_CHARACTER ) && SIZEOF_WCHAR_T != 2 && SIZEOF_WCHAR_T != 4
 #error Unsupported size of wchar_t
 #endif
 
+#if defined( HAVE_MULTI_THREAD_SUPPORT ) && defined( HAVE_PTHREAD_H ) && !defined( WINAPI )
+#define HAVE_QCOW_TEST_FILE_THREADS	1
+#endif
+
 /* Define to make qcow_test_file generate verbose output
 #define QCOW_TEST_FILE_VERBOSE
  */
 
-#define QCOW_TEST_FILE_READ_BUFFER_SIZE	4096
+#define QCOW_TEST_FILE_READ_BUFFER_SIZE		4096
+#define QCOW_TEST_FILE_NUMBER_OF_READ_REQUESTS	8
+#define QCOW_TEST_FILE_MAXIMUM_NUMBER_OF_SCAN_CHUNKS	16
+
+typedef struct qcow_test_file_scan_values qcow_test_file_scan_values_t;
+
+struct qcow_test_file_scan_values
+{
+	/* The file
+	 */
+	libqcow_file_t *file;
+
+	/* The end offset of the previous chunk
+	 */
+	off64_t end_offset;
+
+	/* The number of chunks
+	 */
+	int number_of_chunks;
+
+	/* The value the callback function returns
+	 */
+	int callback_result;
+
+	/* Value to indicate the chunks are expected in order of the offset
+	 */
+	uint8_t is_ordered;
+
+	/* Value to indicate a chunk did not match
+	 */
+	uint8_t has_mismatch;
+};
+
+#if defined( HAVE_QCOW_TEST_FILE_THREADS )
+
+#define QCOW_TEST_FILE_NUMBER_OF_READ_RANGES		256
+#define QCOW_TEST_FILE_MAXIMUM_READ_RANGE_SIZE		65536
+#define QCOW_TEST_FILE_NUMBER_OF_READ_THREADS		8
+
+typedef struct qcow_test_file_read_range qcow_test_file_read_range_t;
+
+struct qcow_test_file_read_range
+{
+	/* The offset
+	 */
+	off64_t offset;
+
+	/* The size
+	 */
+	size_t size;
+
+	/* The data read sequentially
+	 */
+	uint8_t *expected_data;
+
+	/* The number of bytes read sequentially
+	 */
+	ssize_t expected_read_count;
+};
+
+typedef struct qcow_test_file_read_thread_values qcow_test_file_read_thread_values_t;
+
+struct qcow_test_file_read_thread_values
+{
+	/* The file
+	 */
+	libqcow_file_t *file;
+
+	/* The read ranges
+	 */
+	qcow_test_file_read_range_t *read_ranges;
+
+	/* The index of the thread
+	 */
+	int thread_index;
+
+	/* Value to indicate a read failed or did not match
+	 */
+	uint8_t has_mismatch;
+};
+
+typedef struct qcow_test_file_stopped_read_values qcow_test_file_stopped_read_values_t;
+
+struct qcow_test_file_stopped_read_values
+{
+	/* The file
+	 */
+	libqcow_file_t *file;
+
+	/* The buffer
+	 */
+	uint8_t *buffer;
+
+	/* The buffer size
+	 */
+	size_t buffer_size;
+
+	/* The timeout in milliseconds
+	 */
+	uint32_t timeout;
+
+	/* The number of bytes read
+	 */
+	ssize_t read_count;
+
+	/* Value to indicate the read failed with an error
+	 */
+	uint8_t has_error;
+};
+
+#endif /* defined( HAVE_QCOW_TEST_FILE_THREADS ) */
 
 #if !defined( LIBQCOW_HAVE_BFIO )
 
@@ -152,10 +273,12 @@ int qcow_test_file_open_source(
 			goto on_error;
 		}
 	}
+	/* The clones of a libbfio file handle keep an offset of their own
+	 */
 	result = libqcow_file_open_file_io_handle(
 	          *file,
 	          file_io_handle,
-	          LIBQCOW_OPEN_READ,
+	          LIBQCOW_OPEN_READ | LIBQCOW_OPEN_FLAG_CLONE_FILE_IO_HANDLE,
 	          error );
 
 	if( result != 1 )
@@ -447,6 +570,225 @@ on_error:
 	return( -1 );
 }
 
+/* Opens the external data file
+ * Returns 1 if successful, 0 if no data file or -1 on error
+ */
+int qcow_test_file_open_data_file(
+     const system_character_t *source,
+     libqcow_file_t *file,
+     libcerror_error_t **error )
+{
+	system_character_t *data_file_path     = NULL;
+	system_character_t *data_filename      = NULL;
+	const system_character_t *basename_end = NULL;
+	static char *function                  = "qcow_test_file_open_data_file";
+	size_t basename_length                 = 0;
+	size_t data_basename_length            = 0;
+	size_t data_file_path_size             = 0;
+	size_t data_filename_size              = 0;
+	size_t source_length                   = 0;
+	int result                             = 0;
+
+	if( source == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid source.",
+		 function );
+
+		return( -1 );
+	}
+	source_length = system_string_length(
+	                 source );
+
+	basename_end = system_string_search_character_reverse(
+	                source,
+	                (system_character_t) LIBCPATH_SEPARATOR,
+	                source_length + 1 );
+
+	if( basename_end != NULL )
+	{
+		basename_length = (size_t) ( basename_end - source );
+	}
+#if defined( HAVE_WIDE_SYSTEM_CHARACTER )
+	result = libqcow_file_get_utf16_data_filename_size(
+		  file,
+		  &data_filename_size,
+		  error );
+#else
+	result = libqcow_file_get_utf8_data_filename_size(
+		  file,
+		  &data_filename_size,
+		  error );
+#endif
+	if( result == -1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+		 "%s: unable to retrieve data filename size.",
+		 function );
+
+		goto on_error;
+	}
+	else if( result == 0 )
+	{
+		return( 0 );
+	}
+	if( data_filename_size == 0 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_MISSING,
+		 "%s: missing data filename.",
+		 function );
+
+		goto on_error;
+	}
+	if( data_filename_size > (size_t) ( SSIZE_MAX / sizeof( system_character_t ) ) )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_VALUE_EXCEEDS_MAXIMUM,
+		 "%s: invalid data filename size value exceeds maximum.",
+		 function );
+
+		goto on_error;
+	}
+	data_filename = system_string_allocate(
+	                    data_filename_size );
+
+	if( data_filename == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_INSUFFICIENT,
+		 "%s: unable to create data filename string.",
+		 function );
+
+		goto on_error;
+	}
+#if defined( HAVE_WIDE_SYSTEM_CHARACTER )
+	result = libqcow_file_get_utf16_data_filename(
+		  file,
+		  (uint16_t *) data_filename,
+		  data_filename_size,
+		  error );
+#else
+	result = libqcow_file_get_utf8_data_filename(
+		  file,
+		  (uint8_t *) data_filename,
+		  data_filename_size,
+		  error );
+#endif
+	if( result != 1 )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+		 LIBCERROR_RUNTIME_ERROR_GET_FAILED,
+		 "%s: unable to retrieve data filename.",
+		 function );
+
+		goto on_error;
+	}
+	if( basename_length == 0 )
+	{
+		data_file_path      = &( data_filename[ data_basename_length ] );
+		data_file_path_size = data_filename_size - ( data_basename_length + 1 );
+	}
+	else
+	{
+#if defined( HAVE_WIDE_SYSTEM_CHARACTER )
+		if( libcpath_path_join_wide(
+		     &data_file_path,
+		     &data_file_path_size,
+		     source,
+		     basename_length,
+		     &( data_filename[ data_basename_length ] ),
+		     data_filename_size - ( data_basename_length + 1 ),
+		     error ) != 1 )
+#else
+		if( libcpath_path_join(
+		     &data_file_path,
+		     &data_file_path_size,
+		     source,
+		     basename_length,
+		     &( data_filename[ data_basename_length ] ),
+		     data_filename_size - ( data_basename_length + 1 ),
+		     error ) != 1 )
+#endif
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_RUNTIME,
+			 LIBCERROR_RUNTIME_ERROR_INITIALIZE_FAILED,
+			 "%s: unable to create data file path.",
+			 function );
+
+			goto on_error;
+		}
+	}
+#if defined( HAVE_WIDE_SYSTEM_CHARACTER )
+	if( libqcow_file_open_data_file_wide(
+	     file,
+	     data_file_path,
+	     error ) != 1 )
+#else
+	if( libqcow_file_open_data_file(
+	     file,
+	     data_file_path,
+	     error ) != 1 )
+#endif
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_IO,
+		 LIBCERROR_IO_ERROR_OPEN_FAILED,
+		 "%s: unable to open data file: %" PRIs_SYSTEM ".",
+		 function,
+		 data_file_path );
+
+		goto on_error;
+	}
+	if( ( basename_length != 0 )
+	 && ( data_file_path != NULL ) )
+	{
+		memory_free(
+		 data_file_path );
+
+		data_file_path = NULL;
+	}
+	if( data_filename != NULL )
+	{
+		memory_free(
+		 data_filename );
+
+		data_filename = NULL;
+	}
+	return( 1 );
+
+on_error:
+	if( ( basename_length != 0 )
+	 && ( data_file_path != NULL ) )
+	{
+		memory_free(
+		 data_file_path );
+	}
+	if( data_filename != NULL )
+	{
+		memory_free(
+		 data_filename );
+	}
+	return( -1 );
+}
+
 /* Closes and frees a source file
  * Returns 1 if successful or -1 on error
  */
@@ -497,30 +839,339 @@ int qcow_test_file_close_source(
 	return( result );
 }
 
-/* Tests the libqcow_file_initialize function
- * Returns 1 if successful or 0 if not
+/* Creates the data of a version 3 image with cluster blocks of 4096 bytes
+ * The cluster types contain a character per cluster block of the media:
+ * 'd' a cluster block with data, of which every byte contains the data byte plus the cluster block index
+ * 'u' an unallocated cluster block
+ * 'z' a zero cluster block
+ * 'p' a preallocated zero cluster block, of which the data in the image file is not zero
+ * 'c' a compressed cluster block with the same data as 'd', of which the compressed data
+ *     is stored at an odd offset and spans 2 cluster blocks in the image file
+ * Returns 1 if successful or -1 on error
  */
-int qcow_test_file_initialize(
-     void )
+int qcow_test_file_create_image_data(
+     const char *cluster_types,
+     uint8_t data_byte,
+     const char *backing_filename,
+     uint8_t **image_data,
+     size_t *image_data_size,
+     libcerror_error_t **error )
 {
-	libcerror_error_t *error        = NULL;
-	libqcow_file_t *file            = NULL;
-	int result                      = 0;
-
-#if defined( HAVE_QCOW_TEST_MEMORY )
-	int number_of_malloc_fail_tests = 1;
-	int number_of_memset_fail_tests = 1;
-	int test_number                 = 0;
-#endif
+	uint8_t *level2_table_entry       = NULL;
+	static char *function             = "qcow_test_file_create_image_data";
+	size_t backing_filename_size      = 0;
+	size_t cluster_block_size         = 4096;
+	size_t data_offset                = 0;
+	uint64_t level2_table_entry_value = 0;
+	int cluster_block_index           = 0;
+	int number_of_cluster_blocks      = 0;
+	int number_of_data_cluster_blocks = 0;
+
+	if( cluster_types == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid cluster types.",
+		 function );
 
-	/* Test regular cases
-	 */
-	result = libqcow_file_initialize(
-	          &file,
-	          &error );
+		return( -1 );
+	}
+	if( image_data == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid image data.",
+		 function );
 
-	QCOW_TEST_ASSERT_EQUAL_INT(
-	 "result",
+		return( -1 );
+	}
+	if( image_data_size == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_ARGUMENTS,
+		 LIBCERROR_ARGUMENT_ERROR_INVALID_VALUE,
+		 "%s: invalid image data size.",
+		 function );
+
+		return( -1 );
+	}
+	number_of_cluster_blocks = (int) narrow_string_length(
+	                                  cluster_types );
+
+	for( cluster_block_index = 0;
+	     cluster_block_index < number_of_cluster_blocks;
+	     cluster_block_index++ )
+	{
+		if( ( cluster_types[ cluster_block_index ] == 'd' )
+		 || ( cluster_types[ cluster_block_index ] == 'p' ) )
+		{
+			number_of_data_cluster_blocks++;
+		}
+		else if( cluster_types[ cluster_block_index ] == 'c' )
+		{
+			number_of_data_cluster_blocks += 2;
+		}
+	}
+	/* The image consists of the file header, the level 1 table, a single level 2 table
+	 * and the data cluster blocks
+	 */
+	*image_data_size = (size_t) ( 3 + number_of_data_cluster_blocks ) * cluster_block_size;
+
+	*image_data = (uint8_t *) memory_allocate(
+	                           sizeof( uint8_t ) * *image_data_size );
+
+	if( *image_data == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_INSUFFICIENT,
+		 "%s: unable to create image data.",
+		 function );
+
+		return( -1 );
+	}
+	if( memory_set(
+	     *image_data,
+	     0,
+	     *image_data_size ) == NULL )
+	{
+		libcerror_error_set(
+		 error,
+		 LIBCERROR_ERROR_DOMAIN_MEMORY,
+		 LIBCERROR_MEMORY_ERROR_SET_FAILED,
+		 "%s: unable to clear image data.",
+		 function );
+
+		goto on_error;
+	}
+	( *image_data )[ 0 ] = 'Q';
+	( *image_data )[ 1 ] = 'F';
+	( *image_data )[ 2 ] = 'I';
+	( *image_data )[ 3 ] = 0xfb;
+
+	/* The format version
+	 */
+	byte_stream_copy_from_uint32_big_endian(
+	 &( ( *image_data )[ 4 ] ),
+	 3 );
+
+	if( backing_filename != NULL )
+	{
+		backing_filename_size = narrow_string_length(
+		                         backing_filename );
+
+		if( memory_copy(
+		     &( ( *image_data )[ 512 ] ),
+		     backing_filename,
+		     backing_filename_size ) == NULL )
+		{
+			libcerror_error_set(
+			 error,
+			 LIBCERROR_ERROR_DOMAIN_MEMORY,
+			 LIBCERROR_MEMORY_ERROR_COPY_FAILED,
+			 "%s: unable to copy backing filename.",
+			 function );
+
+			goto on_error;
+		}
+		byte_stream_copy_from_uint64_big_endian(
+		 &( ( *image_data )[ 8 ] ),
+		 (uint64_t) 512 );
+
+		byte_stream_copy_from_uint32_big_endian(
+		 &( ( *image_data )[ 16 ] ),
+		 (uint32_t) backing_filename_size );
+	}
+	/* The number of cluster block bits
+	 */
+	byte_stream_copy_from_uint32_big_endian(
+	 &( ( *image_data )[ 20 ] ),
+	 12 );
+
+	/* The media size
+	 */
+	byte_stream_copy_from_uint64_big_endian(
+	 &( ( *image_data )[ 24 ] ),
+	 (uint64_t) number_of_cluster_blocks * cluster_block_size );
+
+	/* The number of level 1 table references and the level 1 table offset
+	 */
+	byte_stream_copy_from_uint32_big_endian(
+	 &( ( *image_data )[ 36 ] ),
+	 1 );
+
+	byte_stream_copy_from_uint64_big_endian(
+	 &( ( *image_data )[ 40 ] ),
+	 (uint64_t) cluster_block_size );
+
+	/* The reference count order and the header size
+	 */
+	byte_stream_copy_from_uint32_big_endian(
+	 &( ( *image_data )[ 96 ] ),
+	 4 );
+
+	byte_stream_copy_from_uint32_big_endian(
+	 &( ( *image_data )[ 100 ] ),
+	 104 );
+
+	/* The level 1 table entry refers to the level 2 table and has the copied flag set
+	 */
+	byte_stream_copy_from_uint64_big_endian(
+	 &( ( *image_data )[ cluster_block_size ] ),
+	 0x8000000000000000ULL | ( 2 * cluster_block_size ) );
+
+	data_offset = 3 * cluster_block_size;
+
+	for( cluster_block_index = 0;
+	     cluster_block_index < number_of_cluster_blocks;
+	     cluster_block_index++ )
+	{
+		level2_table_entry = &( ( *image_data )[ ( 2 * cluster_block_size ) + ( cluster_block_index * 8 ) ] );
+
+		switch( cluster_types[ cluster_block_index ] )
+		{
+			case 'd':
+				level2_table_entry_value = 0x8000000000000000ULL | (uint64_t) data_offset;
+
+				if( memory_set(
+				     &( ( *image_data )[ data_offset ] ),
+				     (uint8_t) ( data_byte + cluster_block_index ),
+				     cluster_block_size ) == NULL )
+				{
+					libcerror_error_set(
+					 error,
+					 LIBCERROR_ERROR_DOMAIN_MEMORY,
+					 LIBCERROR_MEMORY_ERROR_SET_FAILED,
+					 "%s: unable to set cluster block: %d data.",
+					 function,
+					 cluster_block_index );
+
+					goto on_error;
+				}
+				data_offset += cluster_block_size;
+
+				break;
+
+			case 'p':
+				level2_table_entry_value = 0x8000000000000001ULL | (uint64_t) data_offset;
+
+				if( memory_set(
+				     &( ( *image_data )[ data_offset ] ),
+				     0xee,
+				     cluster_block_size ) == NULL )
+				{
+					libcerror_error_set(
+					 error,
+					 LIBCERROR_ERROR_DOMAIN_MEMORY,
+					 LIBCERROR_MEMORY_ERROR_SET_FAILED,
+					 "%s: unable to set cluster block: %d data.",
+					 function,
+					 cluster_block_index );
+
+					goto on_error;
+				}
+				data_offset += cluster_block_size;
+
+				break;
+
+			case 'c':
+				/* The compressed data consists of a single deflate block of uncompressed data
+				 * of 5 + 4096 bytes that starts 1 byte after the start of the cluster block.
+				 * The first byte is not valid deflate data, so that the compressed data
+				 * cannot be read from an offset of which bit 0 was cleared. The number
+				 * of additional 512-byte sectors of the compressed data is 8.
+				 */
+				level2_table_entry_value = 0x4000000000000000ULL
+				                         | ( (uint64_t) 8 << 58 )
+				                         | (uint64_t) ( data_offset + 1 );
+
+				( *image_data )[ data_offset ]     = 0xff;
+				( *image_data )[ data_offset + 1 ] = 0x01;
+
+				byte_stream_copy_from_uint16_little_endian(
+				 &( ( *image_data )[ data_offset + 2 ] ),
+				 (uint16_t) cluster_block_size );
+
+				byte_stream_copy_from_uint16_little_endian(
+				 &( ( *image_data )[ data_offset + 4 ] ),
+				 (uint16_t) ~cluster_block_size );
+
+				if( memory_set(
+				     &( ( *image_data )[ data_offset + 6 ] ),
+				     (uint8_t) ( data_byte + cluster_block_index ),
+				     cluster_block_size ) == NULL )
+				{
+					libcerror_error_set(
+					 error,
+					 LIBCERROR_ERROR_DOMAIN_MEMORY,
+					 LIBCERROR_MEMORY_ERROR_SET_FAILED,
+					 "%s: unable to set cluster block: %d data.",
+					 function,
+					 cluster_block_index );
+
+					goto on_error;
+				}
+				data_offset += 2 * cluster_block_size;
+
+				break;
+
+			case 'z':
+				level2_table_entry_value = 0x0000000000000001ULL;
+
+				break;
+
+			default:
+				level2_table_entry_value = 0;
+
+				break;
+		}
+		byte_stream_copy_from_uint64_big_endian(
+		 level2_table_entry,
+		 level2_table_entry_value );
+	}
+	return( 1 );
+
+on_error:
+	if( *image_data != NULL )
+	{
+		memory_free(
+		 *image_data );
+
+		*image_data = NULL;
+	}
+	return( -1 );
+}
+
+/* Tests the libqcow_file_initialize function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_file_initialize(
+     void )
+{
+	libcerror_error_t *error        = NULL;
+	libqcow_file_t *file            = NULL;
+	int result                      = 0;
+
+#if defined( HAVE_QCOW_TEST_MEMORY )
+	int number_of_malloc_fail_tests = 1;
+	int number_of_memset_fail_tests = 1;
+	int test_number                 = 0;
+#endif
+
+	/* Test regular cases
+	 */
+	result = libqcow_file_initialize(
+	          &file,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
 	 result,
 	 1 );
 
@@ -730,26 +1381,39 @@ on_error:
 	return( 0 );
 }
 
-/* Tests the libqcow_file_open function
+/* Tests reading the zero cluster blocks of a version 3 image
  * Returns 1 if successful or 0 if not
  */
-int qcow_test_file_open(
-     const system_character_t *source,
-     const system_character_t *password )
+int qcow_test_file_read_zero_cluster_blocks(
+     void )
 {
-	char narrow_source[ 256 ];
-
-	libcerror_error_t *error = NULL;
-	libqcow_file_t *file     = NULL;
-	size_t string_length     = 0;
-	int result               = 0;
+	uint8_t *data                            = NULL;
+	uint8_t *expected_data                   = NULL;
+	uint8_t *image_data                      = NULL;
+	uint8_t *parent_image_data               = NULL;
+	libbfio_handle_t *file_io_handle         = NULL;
+	libbfio_handle_t *parent_file_io_handle  = NULL;
+	libcerror_error_t *error                 = NULL;
+	libqcow_file_t *file                     = NULL;
+	libqcow_file_t *parent_file              = NULL;
+	size_t cluster_block_size                = 4096;
+	size_t image_data_size                   = 0;
+	size_t media_size                        = 8 * 4096;
+	size_t parent_image_data_size            = 0;
+	ssize_t read_count                       = 0;
+	int cluster_block_index                  = 0;
+	int result                               = 0;
 
 	/* Initialize test
+	 * The images contain cluster blocks with data, unallocated cluster blocks,
+	 * zero cluster blocks and a preallocated zero cluster block
 	 */
-	result = qcow_test_get_narrow_source(
-	          source,
-	          narrow_source,
-	          256,
+	result = qcow_test_file_create_image_data(
+	          "dddddddd",
+	          0x10,
+	          NULL,
+	          &parent_image_data,
+	          &parent_image_data_size,
 	          &error );
 
 	QCOW_TEST_ASSERT_EQUAL_INT(
@@ -761,8 +1425,12 @@ int qcow_test_file_open(
 	 "error",
 	 error );
 
-	result = libqcow_file_initialize(
-	          &file,
+	result = qcow_test_file_create_image_data(
+	          "duzpuuzu",
+	          0x80,
+	          NULL,
+	          &image_data,
+	          &image_data_size,
 	          &error );
 
 	QCOW_TEST_ASSERT_EQUAL_INT(
@@ -770,47 +1438,14 @@ int qcow_test_file_open(
 	 result,
 	 1 );
 
-	QCOW_TEST_ASSERT_IS_NOT_NULL(
-	 "file",
-	 file );
-
 	QCOW_TEST_ASSERT_IS_NULL(
 	 "error",
 	 error );
 
-	if( password != NULL )
-	{
-		string_length = system_string_length(
-		                 password );
-
-#if defined( HAVE_WIDE_SYSTEM_CHARACTER )
-		result = libqcow_file_set_utf16_password(
-		          file,
-		          (uint16_t *) password,
-		          string_length,
-		          &error );
-#else
-		result = libqcow_file_set_utf8_password(
-		          file,
-		          (uint8_t *) password,
-		          string_length,
-		          &error );
-#endif
-		QCOW_TEST_ASSERT_EQUAL_INT(
-		 "result",
-		 result,
-		 1 );
-
-	        QCOW_TEST_ASSERT_IS_NULL(
-	         "error",
-		 error );
-	}
-	/* Test open
-	 */
-	result = libqcow_file_open(
-	          file,
-	          narrow_source,
-	          LIBQCOW_OPEN_READ,
+	result = qcow_test_open_file_io_handle(
+	          &parent_file_io_handle,
+	          parent_image_data,
+	          parent_image_data_size,
 	          &error );
 
 	QCOW_TEST_ASSERT_EQUAL_INT(
@@ -822,140 +1457,170 @@ int qcow_test_file_open(
 	 "error",
 	 error );
 
-	/* Test error cases
-	 */
-	result = libqcow_file_open(
+	result = qcow_test_file_open_source(
+	          &parent_file,
+	          parent_file_io_handle,
 	          NULL,
-	          narrow_source,
-	          LIBQCOW_OPEN_READ,
 	          &error );
 
 	QCOW_TEST_ASSERT_EQUAL_INT(
 	 "result",
 	 result,
-	 -1 );
+	 1 );
 
-	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	QCOW_TEST_ASSERT_IS_NULL(
 	 "error",
 	 error );
 
-	libcerror_error_free(
-	 &error );
-
-	result = libqcow_file_open(
-	          file,
-	          NULL,
-	          LIBQCOW_OPEN_READ,
+	result = qcow_test_open_file_io_handle(
+	          &file_io_handle,
+	          image_data,
+	          image_data_size,
 	          &error );
 
 	QCOW_TEST_ASSERT_EQUAL_INT(
 	 "result",
 	 result,
-	 -1 );
+	 1 );
 
-	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	QCOW_TEST_ASSERT_IS_NULL(
 	 "error",
 	 error );
 
-	libcerror_error_free(
-	 &error );
-
-	result = libqcow_file_open(
-	          file,
-	          narrow_source,
-	          -1,
+	result = qcow_test_file_open_source(
+	          &file,
+	          file_io_handle,
+	          NULL,
 	          &error );
 
 	QCOW_TEST_ASSERT_EQUAL_INT(
 	 "result",
 	 result,
-	 -1 );
+	 1 );
 
-	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	QCOW_TEST_ASSERT_IS_NULL(
 	 "error",
 	 error );
 
-	libcerror_error_free(
-	 &error );
+	data = (uint8_t *) memory_allocate(
+	                    sizeof( uint8_t ) * media_size );
 
-	/* Test open when already opened
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "data",
+	 data );
+
+	expected_data = (uint8_t *) memory_allocate(
+	                             sizeof( uint8_t ) * media_size );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "expected_data",
+	 expected_data );
+
+	/* Test regular cases
+	 * The zero cluster blocks of an image without a parent file read as zero bytes,
+	 * including the preallocated zero cluster block
 	 */
-	result = libqcow_file_open(
-	          file,
-	          narrow_source,
-	          LIBQCOW_OPEN_READ,
-	          &error );
+	result = ( memory_set(
+	            expected_data,
+	            0,
+	            media_size ) != NULL );
 
 	QCOW_TEST_ASSERT_EQUAL_INT(
 	 "result",
 	 result,
-	 -1 );
+	 1 );
 
-	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	result = ( memory_set(
+	            expected_data,
+	            0x80,
+	            cluster_block_size ) != NULL );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	read_count = libqcow_file_read_buffer_at_offset(
+	              file,
+	              data,
+	              media_size,
+	              0,
+	              &error );
+
+	QCOW_TEST_ASSERT_EQUAL_SSIZE(
+	 "read_count",
+	 read_count,
+	 (ssize_t) media_size );
+
+	QCOW_TEST_ASSERT_IS_NULL(
 	 "error",
 	 error );
 
-	libcerror_error_free(
-	 &error );
+	result = memory_compare(
+	          data,
+	          expected_data,
+	          media_size );
 
-	/* Clean up
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
+
+	/* Test a differential image of which the zero cluster blocks do not fall
+	 * through to the parent file, while the unallocated cluster blocks do
 	 */
-	result = libqcow_file_free(
+	result = qcow_test_file_close_source(
 	          &file,
 	          &error );
 
 	QCOW_TEST_ASSERT_EQUAL_INT(
 	 "result",
 	 result,
-	 1 );
+	 0 );
 
 	QCOW_TEST_ASSERT_IS_NULL(
-	 "file",
-	 file );
+	 "error",
+	 error );
+
+	result = qcow_test_close_file_io_handle(
+	          &file_io_handle,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
 
 	QCOW_TEST_ASSERT_IS_NULL(
 	 "error",
 	 error );
 
-	return( 1 );
+	memory_free(
+	 image_data );
 
-on_error:
-	if( error != NULL )
-	{
-		libcerror_error_free(
-		 &error );
-	}
-	if( file != NULL )
-	{
-		libqcow_file_free(
-		 &file,
-		 NULL );
-	}
-	return( 0 );
-}
+	image_data = NULL;
 
-#if defined( HAVE_WIDE_CHARACTER_TYPE )
+	result = qcow_test_file_create_image_data(
+	          "duzpuuzu",
+	          0x80,
+	          "parent.qcow2",
+	          &image_data,
+	          &image_data_size,
+	          &error );
 
-/* Tests the libqcow_file_open_wide function
- * Returns 1 if successful or 0 if not
- */
-int qcow_test_file_open_wide(
-     const system_character_t *source,
-     const system_character_t *password )
-{
-	wchar_t wide_source[ 256 ];
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
 
-	libcerror_error_t *error = NULL;
-	libqcow_file_t *file     = NULL;
-	size_t string_length     = 0;
-	int result               = 0;
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
 
-	/* Initialize test
-	 */
-	result = qcow_test_get_wide_source(
-	          source,
-	          wide_source,
-	          256,
+	result = qcow_test_open_file_io_handle(
+	          &file_io_handle,
+	          image_data,
+	          image_data_size,
 	          &error );
 
 	QCOW_TEST_ASSERT_EQUAL_INT(
@@ -967,8 +1632,10 @@ int qcow_test_file_open_wide(
 	 "error",
 	 error );
 
-	result = libqcow_file_initialize(
+	result = qcow_test_file_open_source(
 	          &file,
+	          file_io_handle,
+	          NULL,
 	          &error );
 
 	QCOW_TEST_ASSERT_EQUAL_INT(
@@ -976,47 +1643,15 @@ int qcow_test_file_open_wide(
 	 result,
 	 1 );
 
-	QCOW_TEST_ASSERT_IS_NOT_NULL(
-	 "file",
-	 file );
-
 	QCOW_TEST_ASSERT_IS_NULL(
 	 "error",
 	 error );
 
-	if( password != NULL )
-	{
-		string_length = system_string_length(
-		                 password );
-
-#if defined( HAVE_WIDE_SYSTEM_CHARACTER )
-		result = libqcow_file_set_utf16_password(
-		          file,
-		          (uint16_t *) password,
-		          string_length,
-		          &error );
-#else
-		result = libqcow_file_set_utf8_password(
-		          file,
-		          (uint8_t *) password,
-		          string_length,
-		          &error );
-#endif
-		QCOW_TEST_ASSERT_EQUAL_INT(
-		 "result",
-		 result,
-		 1 );
-
-	        QCOW_TEST_ASSERT_IS_NULL(
-	         "error",
-		 error );
-	}
-	/* Test open
+	/* With a parent file only the unallocated cluster blocks are read from the parent file
 	 */
-	result = libqcow_file_open_wide(
+	result = libqcow_file_set_parent_file(
 	          file,
-	          wide_source,
-	          LIBQCOW_OPEN_READ,
+	          parent_file,
 	          &error );
 
 	QCOW_TEST_ASSERT_EQUAL_INT(
@@ -1028,101 +1663,154 @@ int qcow_test_file_open_wide(
 	 "error",
 	 error );
 
-	/* Test error cases
-	 */
-	result = libqcow_file_open_wide(
-	          NULL,
-	          wide_source,
-	          LIBQCOW_OPEN_READ,
-	          &error );
+	for( cluster_block_index = 0;
+	     cluster_block_index < 8;
+	     cluster_block_index++ )
+	{
+		if( ( cluster_block_index == 1 )
+		 || ( cluster_block_index == 4 )
+		 || ( cluster_block_index == 5 )
+		 || ( cluster_block_index == 7 ) )
+		{
+			result = ( memory_set(
+			            &( expected_data[ cluster_block_index * cluster_block_size ] ),
+			            0x10 + cluster_block_index,
+			            cluster_block_size ) != NULL );
+
+			QCOW_TEST_ASSERT_EQUAL_INT(
+			 "result",
+			 result,
+			 1 );
+		}
+	}
+	read_count = libqcow_file_read_buffer_at_offset(
+	              file,
+	              data,
+	              media_size,
+	              0,
+	              &error );
+
+	QCOW_TEST_ASSERT_EQUAL_SSIZE(
+	 "read_count",
+	 read_count,
+	 (ssize_t) media_size );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = memory_compare(
+	          data,
+	          expected_data,
+	          media_size );
 
 	QCOW_TEST_ASSERT_EQUAL_INT(
 	 "result",
 	 result,
-	 -1 );
+	 0 );
 
-	QCOW_TEST_ASSERT_IS_NOT_NULL(
-	 "error",
-	 error );
+	/* Read the cluster blocks one at a time
+	 */
+	for( cluster_block_index = 0;
+	     cluster_block_index < 8;
+	     cluster_block_index++ )
+	{
+		read_count = libqcow_file_read_buffer_at_offset(
+		              file,
+		              data,
+		              cluster_block_size,
+		              (off64_t) ( cluster_block_index * cluster_block_size ),
+		              &error );
 
-	libcerror_error_free(
-	 &error );
+		QCOW_TEST_ASSERT_EQUAL_SSIZE(
+		 "read_count",
+		 read_count,
+		 (ssize_t) cluster_block_size );
 
-	result = libqcow_file_open_wide(
-	          file,
-	          NULL,
-	          LIBQCOW_OPEN_READ,
+		QCOW_TEST_ASSERT_IS_NULL(
+		 "error",
+		 error );
+
+		result = memory_compare(
+		          data,
+		          &( expected_data[ cluster_block_index * cluster_block_size ] ),
+		          cluster_block_size );
+
+		QCOW_TEST_ASSERT_EQUAL_INT(
+		 "result",
+		 result,
+		 0 );
+	}
+	/* Clean up
+	 */
+	memory_free(
+	 expected_data );
+
+	expected_data = NULL;
+
+	memory_free(
+	 data );
+
+	data = NULL;
+
+	result = qcow_test_file_close_source(
+	          &file,
 	          &error );
 
 	QCOW_TEST_ASSERT_EQUAL_INT(
 	 "result",
 	 result,
-	 -1 );
+	 0 );
 
-	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	QCOW_TEST_ASSERT_IS_NULL(
 	 "error",
 	 error );
 
-	libcerror_error_free(
-	 &error );
-
-	result = libqcow_file_open_wide(
-	          file,
-	          wide_source,
-	          -1,
+	result = qcow_test_close_file_io_handle(
+	          &file_io_handle,
 	          &error );
 
 	QCOW_TEST_ASSERT_EQUAL_INT(
 	 "result",
 	 result,
-	 -1 );
+	 0 );
 
-	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	QCOW_TEST_ASSERT_IS_NULL(
 	 "error",
 	 error );
 
-	libcerror_error_free(
-	 &error );
-
-	/* Test open when already opened
-	 */
-	result = libqcow_file_open_wide(
-	          file,
-	          wide_source,
-	          LIBQCOW_OPEN_READ,
+	result = qcow_test_file_close_source(
+	          &parent_file,
 	          &error );
 
 	QCOW_TEST_ASSERT_EQUAL_INT(
 	 "result",
 	 result,
-	 -1 );
+	 0 );
 
-	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	QCOW_TEST_ASSERT_IS_NULL(
 	 "error",
 	 error );
 
-	libcerror_error_free(
-	 &error );
-
-	/* Clean up
-	 */
-	result = libqcow_file_free(
-	          &file,
+	result = qcow_test_close_file_io_handle(
+	          &parent_file_io_handle,
 	          &error );
 
 	QCOW_TEST_ASSERT_EQUAL_INT(
 	 "result",
 	 result,
-	 1 );
-
-	QCOW_TEST_ASSERT_IS_NULL(
-	 "file",
-	 file );
+	 0 );
 
 	QCOW_TEST_ASSERT_IS_NULL(
 	 "error",
 	 error );
 
+	memory_free(
+	 image_data );
+
+	memory_free(
+	 parent_image_data );
+
 	return( 1 );
 
 on_error:
@@ -1131,34 +1819,81 @@ on_error:
 		libcerror_error_free(
 		 &error );
 	}
+	if( expected_data != NULL )
+	{
+		memory_free(
+		 expected_data );
+	}
+	if( data != NULL )
+	{
+		memory_free(
+		 data );
+	}
 	if( file != NULL )
 	{
-		libqcow_file_free(
+		qcow_test_file_close_source(
 		 &file,
 		 NULL );
 	}
+	if( file_io_handle != NULL )
+	{
+		libbfio_handle_free(
+		 &file_io_handle,
+		 NULL );
+	}
+	if( parent_file != NULL )
+	{
+		qcow_test_file_close_source(
+		 &parent_file,
+		 NULL );
+	}
+	if( parent_file_io_handle != NULL )
+	{
+		libbfio_handle_free(
+		 &parent_file_io_handle,
+		 NULL );
+	}
+	if( image_data != NULL )
+	{
+		memory_free(
+		 image_data );
+	}
+	if( parent_image_data != NULL )
+	{
+		memory_free(
+		 parent_image_data );
+	}
 	return( 0 );
 }
 
-#endif /* defined( HAVE_WIDE_CHARACTER_TYPE ) */
-
-/* Tests the libqcow_file_open_file_io_handle function
+/* Tests reading the compressed cluster blocks of a version 3 image
  * Returns 1 if successful or 0 if not
  */
-int qcow_test_file_open_file_io_handle(
-     const system_character_t *source,
-     const system_character_t *password )
+int qcow_test_file_read_compressed_cluster_blocks(
+     void )
 {
+	uint8_t *data                    = NULL;
+	uint8_t *expected_data           = NULL;
+	uint8_t *image_data              = NULL;
 	libbfio_handle_t *file_io_handle = NULL;
 	libcerror_error_t *error         = NULL;
 	libqcow_file_t *file             = NULL;
-	size_t string_length             = 0;
+	size_t cluster_block_size        = 4096;
+	size_t image_data_size           = 0;
+	size_t media_size                = 4 * 4096;
+	ssize_t read_count               = 0;
+	int cluster_block_index          = 0;
 	int result                       = 0;
 
 	/* Initialize test
+	 * The compressed data of the compressed cluster blocks is stored at an odd offset
 	 */
-	result = libbfio_file_initialize(
-	          &file_io_handle,
+	result = qcow_test_file_create_image_data(
+	          "dcuc",
+	          0x80,
+	          NULL,
+	          &image_data,
+	          &image_data_size,
 	          &error );
 
 	QCOW_TEST_ASSERT_EQUAL_INT(
@@ -1166,30 +1901,16 @@ int qcow_test_file_open_file_io_handle(
 	 result,
 	 1 );
 
-	QCOW_TEST_ASSERT_IS_NOT_NULL(
-	 "file_io_handle",
-	 file_io_handle );
-
 	QCOW_TEST_ASSERT_IS_NULL(
 	 "error",
 	 error );
 
-	string_length = system_string_length(
-	                 source );
-
-#if defined( HAVE_WIDE_SYSTEM_CHARACTER )
-	result = libbfio_file_set_name_wide(
-	          file_io_handle,
-	          source,
-	          string_length,
+	result = qcow_test_open_file_io_handle(
+	          &file_io_handle,
+	          image_data,
+	          image_data_size,
 	          &error );
-#else
-	result = libbfio_file_set_name(
-	          file_io_handle,
-	          source,
-	          string_length,
-	          &error );
-#endif
+
 	QCOW_TEST_ASSERT_EQUAL_INT(
 	 "result",
 	 result,
@@ -1199,8 +1920,10 @@ int qcow_test_file_open_file_io_handle(
 	 "error",
 	 error );
 
-	result = libqcow_file_initialize(
+	result = qcow_test_file_open_source(
 	          &file,
+	          file_io_handle,
+	          NULL,
 	          &error );
 
 	QCOW_TEST_ASSERT_EQUAL_INT(
@@ -1208,170 +1931,152 @@ int qcow_test_file_open_file_io_handle(
 	 result,
 	 1 );
 
-	QCOW_TEST_ASSERT_IS_NOT_NULL(
-	 "file",
-	 file );
-
 	QCOW_TEST_ASSERT_IS_NULL(
 	 "error",
 	 error );
 
-	if( password != NULL )
-	{
-		string_length = system_string_length(
-		                 password );
+	data = (uint8_t *) memory_allocate(
+	                    sizeof( uint8_t ) * media_size );
 
-#if defined( HAVE_WIDE_SYSTEM_CHARACTER )
-		result = libqcow_file_set_utf16_password(
-		          file,
-		          (uint16_t *) password,
-		          string_length,
-		          &error );
-#else
-		result = libqcow_file_set_utf8_password(
-		          file,
-		          (uint8_t *) password,
-		          string_length,
-		          &error );
-#endif
-		QCOW_TEST_ASSERT_EQUAL_INT(
-		 "result",
-		 result,
-		 1 );
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "data",
+	 data );
 
-	        QCOW_TEST_ASSERT_IS_NULL(
-	         "error",
-		 error );
-	}
-	/* Test open
-	 */
-	result = libqcow_file_open_file_io_handle(
-	          file,
-	          file_io_handle,
-	          LIBQCOW_OPEN_READ,
-	          &error );
+	expected_data = (uint8_t *) memory_allocate(
+	                             sizeof( uint8_t ) * media_size );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "expected_data",
+	 expected_data );
+
+	result = ( memory_set(
+	            expected_data,
+	            0,
+	            media_size ) != NULL );
 
 	QCOW_TEST_ASSERT_EQUAL_INT(
 	 "result",
 	 result,
 	 1 );
 
-	QCOW_TEST_ASSERT_IS_NULL(
-	 "error",
-	 error );
+	for( cluster_block_index = 0;
+	     cluster_block_index < 4;
+	     cluster_block_index++ )
+	{
+		if( cluster_block_index != 2 )
+		{
+			result = ( memory_set(
+			            &( expected_data[ cluster_block_index * cluster_block_size ] ),
+			            0x80 + cluster_block_index,
+			            cluster_block_size ) != NULL );
 
-	/* Test error cases
+			QCOW_TEST_ASSERT_EQUAL_INT(
+			 "result",
+			 result,
+			 1 );
+		}
+	}
+	/* Test regular cases
 	 */
-	result = libqcow_file_open_file_io_handle(
-	          NULL,
-	          file_io_handle,
-	          LIBQCOW_OPEN_READ,
-	          &error );
+	read_count = libqcow_file_read_buffer_at_offset(
+	              file,
+	              data,
+	              media_size,
+	              0,
+	              &error );
 
-	QCOW_TEST_ASSERT_EQUAL_INT(
-	 "result",
-	 result,
-	 -1 );
+	QCOW_TEST_ASSERT_EQUAL_SSIZE(
+	 "read_count",
+	 read_count,
+	 (ssize_t) media_size );
 
-	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	QCOW_TEST_ASSERT_IS_NULL(
 	 "error",
 	 error );
 
-	libcerror_error_free(
-	 &error );
-
-	result = libqcow_file_open_file_io_handle(
-	          file,
-	          NULL,
-	          LIBQCOW_OPEN_READ,
-	          &error );
+	result = memory_compare(
+	          data,
+	          expected_data,
+	          media_size );
 
 	QCOW_TEST_ASSERT_EQUAL_INT(
 	 "result",
 	 result,
-	 -1 );
-
-	QCOW_TEST_ASSERT_IS_NOT_NULL(
-	 "error",
-	 error );
-
-	libcerror_error_free(
-	 &error );
+	 0 );
 
-	result = libqcow_file_open_file_io_handle(
-	          file,
-	          file_io_handle,
-	          -1,
-	          &error );
+	/* Read the cluster blocks one at a time
+	 */
+	for( cluster_block_index = 0;
+	     cluster_block_index < 4;
+	     cluster_block_index++ )
+	{
+		read_count = libqcow_file_read_buffer_at_offset(
+		              file,
+		              data,
+		              cluster_block_size,
+		              (off64_t) ( cluster_block_index * cluster_block_size ),
+		              &error );
 
-	QCOW_TEST_ASSERT_EQUAL_INT(
-	 "result",
-	 result,
-	 -1 );
+		QCOW_TEST_ASSERT_EQUAL_SSIZE(
+		 "read_count",
+		 read_count,
+		 (ssize_t) cluster_block_size );
 
-	QCOW_TEST_ASSERT_IS_NOT_NULL(
-	 "error",
-	 error );
+		QCOW_TEST_ASSERT_IS_NULL(
+		 "error",
+		 error );
 
-	libcerror_error_free(
-	 &error );
+		result = memory_compare(
+		          data,
+		          &( expected_data[ cluster_block_index * cluster_block_size ] ),
+		          cluster_block_size );
 
-	/* Test open when already opened
+		QCOW_TEST_ASSERT_EQUAL_INT(
+		 "result",
+		 result,
+		 0 );
+	}
+	/* Clean up
 	 */
-	result = libqcow_file_open_file_io_handle(
-	          file,
-	          file_io_handle,
-	          LIBQCOW_OPEN_READ,
-	          &error );
+	memory_free(
+	 expected_data );
 
-	QCOW_TEST_ASSERT_EQUAL_INT(
-	 "result",
-	 result,
-	 -1 );
+	expected_data = NULL;
 
-	QCOW_TEST_ASSERT_IS_NOT_NULL(
-	 "error",
-	 error );
+	memory_free(
+	 data );
 
-	libcerror_error_free(
-	 &error );
+	data = NULL;
 
-	/* Clean up
-	 */
-	result = libqcow_file_free(
+	result = qcow_test_file_close_source(
 	          &file,
 	          &error );
 
 	QCOW_TEST_ASSERT_EQUAL_INT(
 	 "result",
 	 result,
-	 1 );
-
-	QCOW_TEST_ASSERT_IS_NULL(
-	 "file",
-	 file );
+	 0 );
 
 	QCOW_TEST_ASSERT_IS_NULL(
 	 "error",
 	 error );
 
-	result = libbfio_handle_free(
+	result = qcow_test_close_file_io_handle(
 	          &file_io_handle,
 	          &error );
 
 	QCOW_TEST_ASSERT_EQUAL_INT(
 	 "result",
 	 result,
-	 1 );
-
-	QCOW_TEST_ASSERT_IS_NULL(
-	 "file_io_handle",
-	 file_io_handle );
+	 0 );
 
 	QCOW_TEST_ASSERT_IS_NULL(
 	 "error",
 	 error );
 
+	memory_free(
+	 image_data );
+
 	return( 1 );
 
 on_error:
@@ -1380,9 +2085,19 @@ on_error:
 		libcerror_error_free(
 		 &error );
 	}
+	if( expected_data != NULL )
+	{
+		memory_free(
+		 expected_data );
+	}
+	if( data != NULL )
+	{
+		memory_free(
+		 data );
+	}
 	if( file != NULL )
 	{
-		libqcow_file_free(
+		qcow_test_file_close_source(
 		 &file,
 		 NULL );
 	}
@@ -1392,63 +2107,102 @@ on_error:
 		 &file_io_handle,
 		 NULL );
 	}
+	if( image_data != NULL )
+	{
+		memory_free(
+		 image_data );
+	}
 	return( 0 );
 }
 
-/* Tests the libqcow_file_close function
+/* Tests reading consecutive cluster blocks that are stored in the parent file
  * Returns 1 if successful or 0 if not
  */
-int qcow_test_file_close(
+int qcow_test_file_read_parent_cluster_blocks(
      void )
 {
-	libcerror_error_t *error = NULL;
-	int result               = 0;
+	const char *cluster_types                = "duuuduuuuzud";
+	const char *parent_cluster_types         = "ddcdddudddzd";
+	uint8_t *cluster_block_data              = NULL;
+	uint8_t *data                            = NULL;
+	uint8_t *expected_data                   = NULL;
+	uint8_t *image_data                      = NULL;
+	uint8_t *parent_image_data               = NULL;
+	libbfio_handle_t *file_io_handle         = NULL;
+	libbfio_handle_t *parent_file_io_handle  = NULL;
+	libcerror_error_t *error                 = NULL;
+	libqcow_file_t *file                     = NULL;
+	libqcow_file_t *parent_file              = NULL;
+	size_t cluster_block_size                = 4096;
+	size_t image_data_size                   = 0;
+	size_t media_size                        = 12 * 4096;
+	size_t parent_image_data_size            = 0;
+	size_t read_size                         = 0;
+	ssize_t read_count                       = 0;
+	off64_t read_offset                      = 0;
+	uint8_t expected_byte                    = 0;
+	int cluster_block_index                  = 0;
+	int result                               = 0;
 
-	/* Test error cases
+	/* Initialize test
+	 * The runs of unallocated cluster blocks of the differential image are read
+	 * from the parent file at once, in between cluster blocks with data and
+	 * a zero cluster block, where the runs in the parent file are split by
+	 * a compressed, an unallocated and a zero cluster block
 	 */
-	result = libqcow_file_close(
+	result = qcow_test_file_create_image_data(
+	          parent_cluster_types,
+	          0x10,
 	          NULL,
+	          &parent_image_data,
+	          &parent_image_data_size,
 	          &error );
 
 	QCOW_TEST_ASSERT_EQUAL_INT(
 	 "result",
 	 result,
-	 -1 );
+	 1 );
 
-	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	QCOW_TEST_ASSERT_IS_NULL(
 	 "error",
 	 error );
 
-	libcerror_error_free(
-	 &error );
+	result = qcow_test_file_create_image_data(
+	          cluster_types,
+	          0x80,
+	          "parent.qcow2",
+	          &image_data,
+	          &image_data_size,
+	          &error );
 
-	return( 1 );
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
 
-on_error:
-	if( error != NULL )
-	{
-		libcerror_error_free(
-		 &error );
-	}
-	return( 0 );
-}
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
 
-/* Tests the libqcow_file_open and libqcow_file_close functions
- * Returns 1 if successful or 0 if not
- */
-int qcow_test_file_open_close(
-     const system_character_t *source,
-     const system_character_t *password )
-{
-	libcerror_error_t *error = NULL;
-	libqcow_file_t *file     = NULL;
-	size_t string_length     = 0;
-	int result               = 0;
+	result = qcow_test_open_file_io_handle(
+	          &parent_file_io_handle,
+	          parent_image_data,
+	          parent_image_data_size,
+	          &error );
 
-	/* Initialize test
-	 */
-	result = libqcow_file_initialize(
-	          &file,
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = qcow_test_file_open_source(
+	          &parent_file,
+	          parent_file_io_handle,
+	          NULL,
 	          &error );
 
 	QCOW_TEST_ASSERT_EQUAL_INT(
@@ -1456,68 +2210,217 @@ int qcow_test_file_open_close(
 	 result,
 	 1 );
 
-	QCOW_TEST_ASSERT_IS_NOT_NULL(
-	 "file",
-	 file );
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = qcow_test_open_file_io_handle(
+	          &file_io_handle,
+	          image_data,
+	          image_data_size,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
 
 	QCOW_TEST_ASSERT_IS_NULL(
 	 "error",
 	 error );
 
-	if( password != NULL )
-	{
-		string_length = system_string_length(
-		                 password );
+	result = qcow_test_file_open_source(
+	          &file,
+	          file_io_handle,
+	          NULL,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_file_set_parent_file(
+	          file,
+	          parent_file,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	data = (uint8_t *) memory_allocate(
+	                    sizeof( uint8_t ) * media_size );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "data",
+	 data );
+
+	cluster_block_data = (uint8_t *) memory_allocate(
+	                                  sizeof( uint8_t ) * cluster_block_size );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "cluster_block_data",
+	 cluster_block_data );
+
+	expected_data = (uint8_t *) memory_allocate(
+	                             sizeof( uint8_t ) * media_size );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "expected_data",
+	 expected_data );
+
+	/* Read the cluster blocks one at a time to determine the expected data
+	 */
+	for( cluster_block_index = 0;
+	     cluster_block_index < 12;
+	     cluster_block_index++ )
+	{
+		read_count = libqcow_file_read_buffer_at_offset(
+		              file,
+		              &( expected_data[ cluster_block_index * cluster_block_size ] ),
+		              cluster_block_size,
+		              (off64_t) ( cluster_block_index * cluster_block_size ),
+		              &error );
+
+		QCOW_TEST_ASSERT_EQUAL_SSIZE(
+		 "read_count",
+		 read_count,
+		 (ssize_t) cluster_block_size );
+
+		QCOW_TEST_ASSERT_IS_NULL(
+		 "error",
+		 error );
+
+		switch( cluster_types[ cluster_block_index ] )
+		{
+			case 'd':
+				expected_byte = (uint8_t) ( 0x80 + cluster_block_index );
+				break;
+
+			case 'u':
+				if( ( parent_cluster_types[ cluster_block_index ] == 'd' )
+				 || ( parent_cluster_types[ cluster_block_index ] == 'c' ) )
+				{
+					expected_byte = (uint8_t) ( 0x10 + cluster_block_index );
+				}
+				else
+				{
+					expected_byte = 0;
+				}
+				break;
+
+			default:
+				expected_byte = 0;
+				break;
+		}
+		result = ( memory_set(
+		            cluster_block_data,
+		            expected_byte,
+		            cluster_block_size ) != NULL );
 
-#if defined( HAVE_WIDE_SYSTEM_CHARACTER )
-		result = libqcow_file_set_utf16_password(
-		          file,
-		          (uint16_t *) password,
-		          string_length,
-		          &error );
-#else
-		result = libqcow_file_set_utf8_password(
-		          file,
-		          (uint8_t *) password,
-		          string_length,
-		          &error );
-#endif
 		QCOW_TEST_ASSERT_EQUAL_INT(
 		 "result",
 		 result,
 		 1 );
 
-	        QCOW_TEST_ASSERT_IS_NULL(
-	         "error",
-		 error );
+		result = memory_compare(
+		          &( expected_data[ cluster_block_index * cluster_block_size ] ),
+		          cluster_block_data,
+		          cluster_block_size );
+
+		QCOW_TEST_ASSERT_EQUAL_INT(
+		 "result",
+		 result,
+		 0 );
 	}
-	/* Test open and close
+	/* Test regular cases
 	 */
-#if defined( HAVE_WIDE_SYSTEM_CHARACTER )
-	result = libqcow_file_open_wide(
-	          file,
-	          source,
-	          LIBQCOW_OPEN_READ,
-	          &error );
-#else
-	result = libqcow_file_open(
-	          file,
-	          source,
-	          LIBQCOW_OPEN_READ,
-	          &error );
-#endif
+	read_count = libqcow_file_read_buffer_at_offset(
+	              file,
+	              data,
+	              media_size,
+	              0,
+	              &error );
+
+	QCOW_TEST_ASSERT_EQUAL_SSIZE(
+	 "read_count",
+	 read_count,
+	 (ssize_t) media_size );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = memory_compare(
+	          data,
+	          expected_data,
+	          media_size );
 
 	QCOW_TEST_ASSERT_EQUAL_INT(
 	 "result",
 	 result,
-	 1 );
+	 0 );
+
+	/* Test a read that starts and ends within a run of unallocated cluster blocks
+	 */
+	read_offset = (off64_t) ( cluster_block_size + 1000 );
+	read_size   = ( 10 * cluster_block_size ) - 3000;
+
+	read_count = libqcow_file_read_buffer_at_offset(
+	              file,
+	              data,
+	              read_size,
+	              read_offset,
+	              &error );
+
+	QCOW_TEST_ASSERT_EQUAL_SSIZE(
+	 "read_count",
+	 read_count,
+	 (ssize_t) read_size );
 
 	QCOW_TEST_ASSERT_IS_NULL(
 	 "error",
 	 error );
 
-	result = libqcow_file_close(
-	          file,
+	result = memory_compare(
+	          data,
+	          &( expected_data[ read_offset ] ),
+	          read_size );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
+
+	/* Clean up
+	 */
+	memory_free(
+	 expected_data );
+
+	expected_data = NULL;
+
+	memory_free(
+	 cluster_block_data );
+
+	cluster_block_data = NULL;
+
+	memory_free(
+	 data );
+
+	data = NULL;
+
+	result = qcow_test_file_close_source(
+	          &file,
 	          &error );
 
 	QCOW_TEST_ASSERT_EQUAL_INT(
@@ -1529,33 +2432,21 @@ int qcow_test_file_open_close(
 	 "error",
 	 error );
 
-	/* Test open and close a second time to validate clean up on close
-	 */
-#if defined( HAVE_WIDE_SYSTEM_CHARACTER )
-	result = libqcow_file_open_wide(
-	          file,
-	          source,
-	          LIBQCOW_OPEN_READ,
-	          &error );
-#else
-	result = libqcow_file_open(
-	          file,
-	          source,
-	          LIBQCOW_OPEN_READ,
+	result = qcow_test_close_file_io_handle(
+	          &file_io_handle,
 	          &error );
-#endif
 
 	QCOW_TEST_ASSERT_EQUAL_INT(
 	 "result",
 	 result,
-	 1 );
+	 0 );
 
 	QCOW_TEST_ASSERT_IS_NULL(
 	 "error",
 	 error );
 
-	result = libqcow_file_close(
-	          file,
+	result = qcow_test_file_close_source(
+	          &parent_file,
 	          &error );
 
 	QCOW_TEST_ASSERT_EQUAL_INT(
@@ -1567,25 +2458,25 @@ int qcow_test_file_open_close(
 	 "error",
 	 error );
 
-	/* Clean up
-	 */
-	result = libqcow_file_free(
-	          &file,
+	result = qcow_test_close_file_io_handle(
+	          &parent_file_io_handle,
 	          &error );
 
 	QCOW_TEST_ASSERT_EQUAL_INT(
 	 "result",
 	 result,
-	 1 );
-
-	QCOW_TEST_ASSERT_IS_NULL(
-	 "file",
-	 file );
+	 0 );
 
 	QCOW_TEST_ASSERT_IS_NULL(
 	 "error",
 	 error );
 
+	memory_free(
+	 image_data );
+
+	memory_free(
+	 parent_image_data );
+
 	return( 1 );
 
 on_error:
@@ -1594,28 +2485,87 @@ on_error:
 		libcerror_error_free(
 		 &error );
 	}
+	if( expected_data != NULL )
+	{
+		memory_free(
+		 expected_data );
+	}
+	if( cluster_block_data != NULL )
+	{
+		memory_free(
+		 cluster_block_data );
+	}
+	if( data != NULL )
+	{
+		memory_free(
+		 data );
+	}
 	if( file != NULL )
 	{
-		libqcow_file_free(
+		qcow_test_file_close_source(
 		 &file,
 		 NULL );
 	}
+	if( file_io_handle != NULL )
+	{
+		libbfio_handle_free(
+		 &file_io_handle,
+		 NULL );
+	}
+	if( parent_file != NULL )
+	{
+		qcow_test_file_close_source(
+		 &parent_file,
+		 NULL );
+	}
+	if( parent_file_io_handle != NULL )
+	{
+		libbfio_handle_free(
+		 &parent_file_io_handle,
+		 NULL );
+	}
+	if( image_data != NULL )
+	{
+		memory_free(
+		 image_data );
+	}
+	if( parent_image_data != NULL )
+	{
+		memory_free(
+		 parent_image_data );
+	}
 	return( 0 );
 }
 
-/* Tests the libqcow_file_signal_abort function
+#if defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT )
+
+/* Tests the libqcow_internal_file_get_published_cluster_block_offset function
  * Returns 1 if successful or 0 if not
  */
-int qcow_test_file_signal_abort(
-     libqcow_file_t *file )
+int qcow_test_internal_file_get_published_cluster_block_offset(
+     void )
 {
-	libcerror_error_t *error = NULL;
-	int result               = 0;
+	uint8_t *image_data                      = NULL;
+	libbfio_handle_t *file_io_handle         = NULL;
+	libcerror_error_t *error                 = NULL;
+	libqcow_file_t *file                     = NULL;
+	libqcow_internal_file_t *internal_file   = NULL;
+	size_t cluster_block_data_size           = 0;
+	size_t image_data_size                   = 0;
+	uint64_t cluster_block_data_offset       = 0;
+	uint64_t cluster_block_offset            = 0;
+	uint64_t published_cluster_block_offset  = 0;
+	uint32_t cluster_block_flags             = 0;
+	int result                               = 0;
 
-	/* Test regular cases
+	/* Initialize test
 	 */
-	result = libqcow_file_signal_abort(
-	          file,
+	result = qcow_test_file_create_image_data(
+	          "dzud",
+	          0x40,
+	          NULL,
+	          &image_data,
+	          &image_data_size,
 	          &error );
 
 	QCOW_TEST_ASSERT_EQUAL_INT(
@@ -1627,116 +2577,163 @@ int qcow_test_file_signal_abort(
 	 "error",
 	 error );
 
-	/* Test error cases
-	 */
-	result = libqcow_file_signal_abort(
-	          NULL,
+	result = qcow_test_open_file_io_handle(
+	          &file_io_handle,
+	          image_data,
+	          image_data_size,
 	          &error );
 
 	QCOW_TEST_ASSERT_EQUAL_INT(
 	 "result",
 	 result,
-	 -1 );
+	 1 );
 
-	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	QCOW_TEST_ASSERT_IS_NULL(
 	 "error",
 	 error );
 
-	libcerror_error_free(
-	 &error );
+	result = qcow_test_file_open_source(
+	          &file,
+	          file_io_handle,
+	          NULL,
+	          &error );
 
-	return( 1 );
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
 
-on_error:
-	if( error != NULL )
-	{
-		libcerror_error_free(
-		 &error );
-	}
-	return( 0 );
-}
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
 
-/* Tests the libqcow_file_is_locked function
- * Returns 1 if successful or 0 if not
- */
-int qcow_test_file_is_locked(
-     libqcow_file_t *file )
-{
-	libcerror_error_t *error = NULL;
-	int result               = 0;
+	internal_file = (libqcow_internal_file_t *) file;
 
-	/* Test regular cases
+	/* Test that the level 2 table is not published before it is read
 	 */
-	result = libqcow_file_is_locked(
-	          file,
+	result = libqcow_internal_file_get_published_cluster_block_offset(
+	          internal_file,
+	          internal_file->level1_table,
+	          0,
+	          &cluster_block_offset,
+	          &cluster_block_data_offset,
+	          &cluster_block_data_size,
+	          &cluster_block_flags,
 	          &error );
 
-	QCOW_TEST_ASSERT_NOT_EQUAL_INT(
+	QCOW_TEST_ASSERT_EQUAL_INT(
 	 "result",
 	 result,
-	 -1 );
+	 0 );
 
 	QCOW_TEST_ASSERT_IS_NULL(
 	 "error",
 	 error );
 
-	/* Test error cases
+	/* Test regular cases
 	 */
-	result = libqcow_file_is_locked(
-	          NULL,
+	result = libqcow_internal_file_get_cluster_block_offset(
+	          internal_file,
+	          internal_file->file_io_handle,
+	          internal_file->level1_table,
+	          ( 3 * 4096 ) + 16,
+	          &cluster_block_offset,
+	          &cluster_block_data_offset,
+	          &cluster_block_data_size,
+	          &cluster_block_flags,
 	          &error );
 
 	QCOW_TEST_ASSERT_EQUAL_INT(
 	 "result",
 	 result,
-	 -1 );
+	 1 );
 
-	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	QCOW_TEST_ASSERT_IS_NULL(
 	 "error",
 	 error );
 
-	libcerror_error_free(
-	 &error );
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "internal_file->published_level2_tables",
+	 internal_file->published_level2_tables );
+
+	QCOW_TEST_ASSERT_EQUAL_SIZE(
+	 "internal_file->published_level2_tables_size",
+	 internal_file->published_level2_tables_size,
+	 (size_t) 4096 );
+
+	published_cluster_block_offset = cluster_block_offset;
+
+	result = libqcow_internal_file_get_published_cluster_block_offset(
+	          internal_file,
+	          internal_file->level1_table,
+	          ( 3 * 4096 ) + 16,
+	          &cluster_block_offset,
+	          &cluster_block_data_offset,
+	          &cluster_block_data_size,
+	          &cluster_block_flags,
+	          &error );
 
-	return( 1 );
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
 
-on_error:
-	if( error != NULL )
-	{
-		libcerror_error_free(
-		 &error );
-	}
-	return( 0 );
-}
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
 
-#if defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT )
+	QCOW_TEST_ASSERT_EQUAL_UINT64(
+	 "cluster_block_offset",
+	 cluster_block_offset,
+	 published_cluster_block_offset );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT64(
+	 "cluster_block_data_offset",
+	 cluster_block_data_offset,
+	 (uint64_t) 16 );
+
+	QCOW_TEST_ASSERT_EQUAL_SIZE(
+	 "cluster_block_data_size",
+	 cluster_block_data_size,
+	 (size_t) ( 4096 - 16 ) );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT32(
+	 "cluster_block_flags",
+	 cluster_block_flags,
+	 (uint32_t) 0 );
+
+	result = libqcow_internal_file_get_published_cluster_block_offset(
+	          internal_file,
+	          internal_file->level1_table,
+	          4096,
+	          &cluster_block_offset,
+	          &cluster_block_data_offset,
+	          &cluster_block_data_size,
+	          &cluster_block_flags,
+	          &error );
 
-/* Tests the libqcow_internal_file_read_buffer_from_file_io_handle function
- * Returns 1 if successful or 0 if not
- */
-int qcow_test_internal_file_read_buffer_from_file_io_handle(
-     libqcow_file_t *file )
-{
-	uint8_t buffer[ QCOW_TEST_FILE_READ_BUFFER_SIZE ];
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
 
-	libcerror_error_t *error      = NULL;
-	time_t timestamp              = 0;
-	size64_t media_size           = 0;
-	size64_t remaining_media_size = 0;
-	size_t read_size              = 0;
-	ssize_t read_count            = 0;
-	off64_t offset                = 0;
-	off64_t read_offset           = 0;
-	int number_of_tests           = 1024;
-	int random_number             = 0;
-	int result                    = 0;
-	int test_number               = 0;
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
 
-	/* Determine size
-	 */
-	result = libqcow_file_get_media_size(
-	          file,
-	          &media_size,
+	QCOW_TEST_ASSERT_EQUAL_UINT32(
+	 "cluster_block_flags",
+	 ( cluster_block_flags & LIBQCOW_CLUSTER_BLOCK_FLAG_IS_ZERO ),
+	 (uint32_t) LIBQCOW_CLUSTER_BLOCK_FLAG_IS_ZERO );
+
+	result = libqcow_internal_file_get_published_cluster_block_offset(
+	          internal_file,
+	          internal_file->level1_table,
+	          2 * 4096,
+	          &cluster_block_offset,
+	          &cluster_block_data_offset,
+	          &cluster_block_data_size,
+	          &cluster_block_flags,
 	          &error );
 
 	QCOW_TEST_ASSERT_EQUAL_INT(
@@ -1748,328 +2745,377 @@ int qcow_test_internal_file_read_buffer_from_file_io_handle(
 	 "error",
 	 error );
 
-	/* Reset offset to 0
+	QCOW_TEST_ASSERT_EQUAL_UINT64(
+	 "cluster_block_offset",
+	 cluster_block_offset,
+	 (uint64_t) 0 );
+
+	/* Test error cases
 	 */
-	offset = libqcow_file_seek_offset(
-	          file,
+	result = libqcow_internal_file_get_published_cluster_block_offset(
+	          NULL,
+	          internal_file->level1_table,
 	          0,
-	          SEEK_SET,
+	          &cluster_block_offset,
+	          &cluster_block_data_offset,
+	          &cluster_block_data_size,
+	          &cluster_block_flags,
 	          &error );
 
-	QCOW_TEST_ASSERT_EQUAL_INT64(
-	 "offset",
-	 offset,
-	 (int64_t) 0 );
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
 
-	QCOW_TEST_ASSERT_IS_NULL(
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
 	 "error",
 	 error );
 
-	/* Test regular cases
-	 */
-	read_size = QCOW_TEST_FILE_READ_BUFFER_SIZE;
+	libcerror_error_free(
+	 &error );
 
-	if( media_size < QCOW_TEST_FILE_READ_BUFFER_SIZE )
-	{
-		read_size = (size_t) media_size;
-	}
-	read_count = libqcow_internal_file_read_buffer_from_file_io_handle(
-	              (libqcow_internal_file_t *) file,
-	              ( (libqcow_internal_file_t *) file )->file_io_handle,
-	              buffer,
-	              QCOW_TEST_FILE_READ_BUFFER_SIZE,
-	              &error );
+	result = libqcow_internal_file_get_published_cluster_block_offset(
+	          internal_file,
+	          NULL,
+	          0,
+	          &cluster_block_offset,
+	          &cluster_block_data_offset,
+	          &cluster_block_data_size,
+	          &cluster_block_flags,
+	          &error );
 
-	QCOW_TEST_ASSERT_EQUAL_SSIZE(
-	 "read_count",
-	 read_count,
-	 (ssize_t) read_size );
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
 
-	QCOW_TEST_ASSERT_IS_NULL(
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
 	 "error",
 	 error );
 
-	if( media_size > 8 )
-	{
-		/* Set offset to media_size - 8
-		 */
-		offset = libqcow_file_seek_offset(
-		          file,
-		          -8,
-		          SEEK_END,
-		          &error );
-
-		QCOW_TEST_ASSERT_EQUAL_INT64(
-		 "offset",
-		 offset,
-		 (int64_t) media_size - 8 );
+	libcerror_error_free(
+	 &error );
 
-		QCOW_TEST_ASSERT_IS_NULL(
-		 "error",
-		 error );
+	result = libqcow_internal_file_get_published_cluster_block_offset(
+	          internal_file,
+	          internal_file->level1_table,
+	          -1,
+	          &cluster_block_offset,
+	          &cluster_block_data_offset,
+	          &cluster_block_data_size,
+	          &cluster_block_flags,
+	          &error );
 
-		/* Read buffer on media_size boundary
-		 */
-		read_count = libqcow_internal_file_read_buffer_from_file_io_handle(
-		              (libqcow_internal_file_t *) file,
-		              ( (libqcow_internal_file_t *) file )->file_io_handle,
-		              buffer,
-		              QCOW_TEST_FILE_READ_BUFFER_SIZE,
-		              &error );
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
 
-		QCOW_TEST_ASSERT_EQUAL_SSIZE(
-		 "read_count",
-		 read_count,
-		 (ssize_t) 8 );
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
 
-		QCOW_TEST_ASSERT_IS_NULL(
-		 "error",
-		 error );
+	libcerror_error_free(
+	 &error );
 
-		/* Read buffer beyond media_size boundary
-		 */
-		read_count = libqcow_internal_file_read_buffer_from_file_io_handle(
-		              (libqcow_internal_file_t *) file,
-		              ( (libqcow_internal_file_t *) file )->file_io_handle,
-		              buffer,
-		              QCOW_TEST_FILE_READ_BUFFER_SIZE,
-		              &error );
+	result = libqcow_internal_file_get_published_cluster_block_offset(
+	          internal_file,
+	          internal_file->level1_table,
+	          0,
+	          NULL,
+	          &cluster_block_data_offset,
+	          &cluster_block_data_size,
+	          &cluster_block_flags,
+	          &error );
 
-		QCOW_TEST_ASSERT_EQUAL_SSIZE(
-		 "read_count",
-		 read_count,
-		 (ssize_t) 0 );
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
 
-		QCOW_TEST_ASSERT_IS_NULL(
-		 "error",
-		 error );
-	}
-	/* Stress test read buffer
-	 */
-	timestamp = time(
-	             NULL );
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
 
-	srand(
-	 (unsigned int) timestamp );
+	libcerror_error_free(
+	 &error );
 
-	offset = libqcow_file_seek_offset(
-	          file,
+	result = libqcow_internal_file_get_published_cluster_block_offset(
+	          internal_file,
+	          internal_file->level1_table,
 	          0,
-	          SEEK_SET,
+	          &cluster_block_offset,
+	          NULL,
+	          &cluster_block_data_size,
+	          &cluster_block_flags,
 	          &error );
 
-	QCOW_TEST_ASSERT_EQUAL_INT64(
-	 "offset",
-	 offset,
-	 (int64_t) 0 );
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
 
-	QCOW_TEST_ASSERT_IS_NULL(
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
 	 "error",
 	 error );
 
-	remaining_media_size = media_size;
+	libcerror_error_free(
+	 &error );
 
-	for( test_number = 0;
-	     test_number < number_of_tests;
-	     test_number++ )
-	{
-		random_number = rand();
+	result = libqcow_internal_file_get_published_cluster_block_offset(
+	          internal_file,
+	          internal_file->level1_table,
+	          0,
+	          &cluster_block_offset,
+	          &cluster_block_data_offset,
+	          NULL,
+	          &cluster_block_flags,
+	          &error );
 
-		QCOW_TEST_ASSERT_GREATER_THAN_INT(
-		 "random_number",
-		 random_number,
-		 -1 );
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
 
-		read_size = (size_t) random_number % QCOW_TEST_FILE_READ_BUFFER_SIZE;
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
 
-#if defined( QCOW_TEST_FILE_VERBOSE )
-		fprintf(
-		 stdout,
-		 "libqcow_file_read_buffer: at offset: %" PRIi64 " (0x%08" PRIx64 ") of size: %" PRIzd "\n",
-		 read_offset,
-		 read_offset,
-		 read_size );
-#endif
-		read_count = libqcow_internal_file_read_buffer_from_file_io_handle(
-		              (libqcow_internal_file_t *) file,
-		              ( (libqcow_internal_file_t *) file )->file_io_handle,
-		              buffer,
-		              read_size,
-		              &error );
+	libcerror_error_free(
+	 &error );
 
-		if( read_size > remaining_media_size )
-		{
-			read_size = (size_t) remaining_media_size;
-		}
-		QCOW_TEST_ASSERT_EQUAL_SSIZE(
-		 "read_count",
-		 read_count,
-		 (ssize_t) read_size );
+	result = libqcow_internal_file_get_published_cluster_block_offset(
+	          internal_file,
+	          internal_file->level1_table,
+	          0,
+	          &cluster_block_offset,
+	          &cluster_block_data_offset,
+	          &cluster_block_data_size,
+	          NULL,
+	          &error );
 
-		QCOW_TEST_ASSERT_IS_NULL(
-		 "error",
-		 error );
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
 
-		read_offset += read_count;
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
 
-		result = libqcow_file_get_offset(
-		          file,
-		          &offset,
-		          &error );
+	libcerror_error_free(
+	 &error );
 
-		QCOW_TEST_ASSERT_EQUAL_INT(
-		 "result",
-		 result,
-		 1 );
+	/* Clean up
+	 */
+	internal_file = NULL;
 
-		QCOW_TEST_ASSERT_EQUAL_INT64(
-		 "offset",
-		 offset,
-		 read_offset );
+	result = qcow_test_file_close_source(
+	          &file,
+	          &error );
 
-		QCOW_TEST_ASSERT_IS_NULL(
-		 "error",
-		 error );
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
 
-		remaining_media_size -= read_count;
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
 
-		if( remaining_media_size == 0 )
-		{
-			offset = libqcow_file_seek_offset(
-			          file,
-			          0,
-			          SEEK_SET,
-			          &error );
+	result = qcow_test_close_file_io_handle(
+	          &file_io_handle,
+	          &error );
 
-			QCOW_TEST_ASSERT_EQUAL_INT64(
-			 "offset",
-			 offset,
-			 (int64_t) 0 );
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
 
-			QCOW_TEST_ASSERT_IS_NULL(
-			 "error",
-			 error );
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
 
-			read_offset = 0;
+	memory_free(
+	 image_data );
 
-			remaining_media_size = media_size;
-		}
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
 	}
-	/* Reset offset to 0
+	if( file != NULL )
+	{
+		qcow_test_file_close_source(
+		 &file,
+		 NULL );
+	}
+	if( file_io_handle != NULL )
+	{
+		libbfio_handle_free(
+		 &file_io_handle,
+		 NULL );
+	}
+	if( image_data != NULL )
+	{
+		memory_free(
+		 image_data );
+	}
+	return( 0 );
+}
+
+#endif /* defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT ) */
+
+#if defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT ) && defined( HAVE_QCOW_TEST_FILE_THREADS )
+
+/* Reads the media data using libqcow_file_read_buffer_at_offset_with_timeout
+ * Returns NULL
+ */
+void *qcow_test_file_stopped_read_thread(
+       void *arguments )
+{
+	qcow_test_file_stopped_read_values_t *read_values = NULL;
+	libcerror_error_t *error                          = NULL;
+
+	read_values = (qcow_test_file_stopped_read_values_t *) arguments;
+
+	read_values->read_count = libqcow_file_read_buffer_at_offset_with_timeout(
+	                           read_values->file,
+	                           read_values->buffer,
+	                           read_values->buffer_size,
+	                           0,
+	                           read_values->timeout,
+	                           &error );
+
+	if( error != NULL )
+	{
+		read_values->has_error = 1;
+
+		libcerror_error_free(
+		 &error );
+	}
+	return( NULL );
+}
+
+/* Tests stopping a libqcow_file_read_buffer_at_offset_with_timeout read in progress
+ * The read is held up by grabbing the read/write lock of the parent file or the file,
+ * after which the file is signalled to abort or the deadline of the read passes
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_file_read_buffer_at_offset_with_timeout_stopped(
+     void )
+{
+	struct timespec sleep_time;
+
+	qcow_test_file_stopped_read_values_t read_values;
+
+	uint8_t *data                            = NULL;
+	uint8_t *expected_data                   = NULL;
+	uint8_t *image_data                      = NULL;
+	uint8_t *parent_image_data               = NULL;
+	libbfio_handle_t *file_io_handle         = NULL;
+	libbfio_handle_t *parent_file_io_handle  = NULL;
+	libcerror_error_t *error                 = NULL;
+	libcthreads_read_write_lock_t *held_lock = NULL;
+	libqcow_file_t *file                     = NULL;
+	libqcow_file_t *parent_file              = NULL;
+	pthread_t thread;
+	size_t image_data_size                   = 0;
+	size_t media_size                        = 8 * 4096;
+	size_t parent_image_data_size            = 0;
+	ssize_t read_count                       = 0;
+	int result                               = 0;
+	int thread_is_running                    = 0;
+
+	/* Initialize test
+	 * The first cluster block is stored in the file, the next 3 in the parent file
 	 */
-	offset = libqcow_file_seek_offset(
-	          file,
-	          0,
-	          SEEK_SET,
+	result = qcow_test_file_create_image_data(
+	          "dddddddd",
+	          0x10,
+	          NULL,
+	          &parent_image_data,
+	          &parent_image_data_size,
 	          &error );
 
-	QCOW_TEST_ASSERT_EQUAL_INT64(
-	 "offset",
-	 offset,
-	 (int64_t) 0 );
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
 
 	QCOW_TEST_ASSERT_IS_NULL(
 	 "error",
 	 error );
 
-	/* Test error cases
-	 */
-	read_count = libqcow_internal_file_read_buffer_from_file_io_handle(
-	              NULL,
-	              ( (libqcow_internal_file_t *) file )->file_io_handle,
-	              buffer,
-	              QCOW_TEST_FILE_READ_BUFFER_SIZE,
-	              &error );
+	result = qcow_test_file_create_image_data(
+	          "duuudddd",
+	          0x80,
+	          "parent.qcow2",
+	          &image_data,
+	          &image_data_size,
+	          &error );
 
-	QCOW_TEST_ASSERT_EQUAL_SSIZE(
-	 "read_count",
-	 read_count,
-	 (ssize_t) -1 );
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
 
-	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	QCOW_TEST_ASSERT_IS_NULL(
 	 "error",
 	 error );
 
-	libcerror_error_free(
-	 &error );
-
-	read_count = libqcow_internal_file_read_buffer_from_file_io_handle(
-	              (libqcow_internal_file_t *) file,
-	              ( (libqcow_internal_file_t *) file )->file_io_handle,
-	              NULL,
-	              QCOW_TEST_FILE_READ_BUFFER_SIZE,
-	              &error );
+	result = qcow_test_open_file_io_handle(
+	          &parent_file_io_handle,
+	          parent_image_data,
+	          parent_image_data_size,
+	          &error );
 
-	QCOW_TEST_ASSERT_EQUAL_SSIZE(
-	 "read_count",
-	 read_count,
-	 (ssize_t) -1 );
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
 
-	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	QCOW_TEST_ASSERT_IS_NULL(
 	 "error",
 	 error );
 
-	libcerror_error_free(
-	 &error );
-
-	read_count = libqcow_internal_file_read_buffer_from_file_io_handle(
-	              (libqcow_internal_file_t *) file,
-	              ( (libqcow_internal_file_t *) file )->file_io_handle,
-	              buffer,
-	              (size_t) SSIZE_MAX + 1,
-	              &error );
+	result = qcow_test_file_open_source(
+	          &parent_file,
+	          parent_file_io_handle,
+	          NULL,
+	          &error );
 
-	QCOW_TEST_ASSERT_EQUAL_SSIZE(
-	 "read_count",
-	 read_count,
-	 (ssize_t) -1 );
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
 
-	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	QCOW_TEST_ASSERT_IS_NULL(
 	 "error",
 	 error );
 
-	libcerror_error_free(
-	 &error );
-
-	return( 1 );
-
-on_error:
-	if( error != NULL )
-	{
-		libcerror_error_free(
-		 &error );
-	}
-	return( 0 );
-}
-
-#endif /* defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT ) */
+	result = qcow_test_open_file_io_handle(
+	          &file_io_handle,
+	          image_data,
+	          image_data_size,
+	          &error );
 
-/* Tests the libqcow_file_read_buffer function
- * Returns 1 if successful or 0 if not
- */
-int qcow_test_file_read_buffer(
-     libqcow_file_t *file )
-{
-	uint8_t buffer[ QCOW_TEST_FILE_READ_BUFFER_SIZE ];
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
 
-	libcerror_error_t *error      = NULL;
-	time_t timestamp              = 0;
-	size64_t media_size           = 0;
-	size64_t remaining_media_size = 0;
-	size_t read_size              = 0;
-	ssize_t read_count            = 0;
-	off64_t offset                = 0;
-	off64_t read_offset           = 0;
-	int number_of_tests           = 1024;
-	int random_number             = 0;
-	int result                    = 0;
-	int test_number               = 0;
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
 
-	/* Determine size
-	 */
-	result = libqcow_file_get_media_size(
-	          file,
-	          &media_size,
+	result = qcow_test_file_open_source(
+	          &file,
+	          file_io_handle,
+	          NULL,
 	          &error );
 
 	QCOW_TEST_ASSERT_EQUAL_INT(
@@ -2081,344 +3127,5790 @@ int qcow_test_file_read_buffer(
 	 "error",
 	 error );
 
-	/* Reset offset to 0
-	 */
-	offset = libqcow_file_seek_offset(
+	result = libqcow_file_set_parent_file(
 	          file,
-	          0,
-	          SEEK_SET,
+	          parent_file,
 	          &error );
 
-	QCOW_TEST_ASSERT_EQUAL_INT64(
-	 "offset",
-	 offset,
-	 (int64_t) 0 );
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
 
 	QCOW_TEST_ASSERT_IS_NULL(
 	 "error",
 	 error );
 
-	/* Test regular cases
-	 */
-	read_size = QCOW_TEST_FILE_READ_BUFFER_SIZE;
+	data = (uint8_t *) memory_allocate(
+	                    sizeof( uint8_t ) * media_size );
 
-	if( media_size < QCOW_TEST_FILE_READ_BUFFER_SIZE )
-	{
-		read_size = (size_t) media_size;
-	}
-	read_count = libqcow_file_read_buffer(
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "data",
+	 data );
+
+	expected_data = (uint8_t *) memory_allocate(
+	                             sizeof( uint8_t ) * media_size );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "expected_data",
+	 expected_data );
+
+	read_count = libqcow_file_read_buffer_at_offset(
 	              file,
-	              buffer,
-	              QCOW_TEST_FILE_READ_BUFFER_SIZE,
+	              expected_data,
+	              media_size,
+	              0,
 	              &error );
 
 	QCOW_TEST_ASSERT_EQUAL_SSIZE(
 	 "read_count",
 	 read_count,
-	 (ssize_t) read_size );
+	 (ssize_t) media_size );
 
 	QCOW_TEST_ASSERT_IS_NULL(
 	 "error",
 	 error );
 
-	if( media_size > 8 )
-	{
-		/* Set offset to media_size - 8
-		 */
-		offset = libqcow_file_seek_offset(
-		          file,
-		          -8,
-		          SEEK_END,
-		          &error );
+	sleep_time.tv_sec  = 0;
+	sleep_time.tv_nsec = 200000000;
 
-		QCOW_TEST_ASSERT_EQUAL_INT64(
-		 "offset",
-		 offset,
-		 (int64_t) media_size - 8 );
+	/* Test a read that is signalled to abort while it waits for the parent file
+	 * The read stops after the run of cluster blocks stored in the parent file
+	 */
+	held_lock = ( (libqcow_internal_file_t *) parent_file )->read_write_lock;
 
-		QCOW_TEST_ASSERT_IS_NULL(
-		 "error",
-		 error );
+	result = libcthreads_read_write_lock_grab_for_write(
+	          held_lock,
+	          &error );
 
-		/* Read buffer on media_size boundary
-		 */
-		read_count = libqcow_file_read_buffer(
-		              file,
-		              buffer,
-		              QCOW_TEST_FILE_READ_BUFFER_SIZE,
-		              &error );
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
 
-		QCOW_TEST_ASSERT_EQUAL_SSIZE(
-		 "read_count",
-		 read_count,
-		 (ssize_t) 8 );
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
 
-		QCOW_TEST_ASSERT_IS_NULL(
-		 "error",
-		 error );
+	read_values.file        = file;
+	read_values.buffer      = data;
+	read_values.buffer_size = media_size;
+	read_values.timeout     = 0;
+	read_values.read_count  = 0;
+	read_values.has_error   = 0;
 
-		/* Read buffer beyond media_size boundary
-		 */
-		read_count = libqcow_file_read_buffer(
-		              file,
-		              buffer,
-		              QCOW_TEST_FILE_READ_BUFFER_SIZE,
-		              &error );
+	result = pthread_create(
+	          &thread,
+	          NULL,
+	          &qcow_test_file_stopped_read_thread,
+	          &read_values );
 
-		QCOW_TEST_ASSERT_EQUAL_SSIZE(
-		 "read_count",
-		 read_count,
-		 (ssize_t) 0 );
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
 
-		QCOW_TEST_ASSERT_IS_NULL(
-		 "error",
-		 error );
-	}
-	/* Stress test read buffer
-	 */
-	timestamp = time(
-	             NULL );
+	thread_is_running = 1;
 
-	srand(
-	 (unsigned int) timestamp );
+	nanosleep(
+	 &sleep_time,
+	 NULL );
 
-	offset = libqcow_file_seek_offset(
+	result = libqcow_file_signal_abort(
 	          file,
-	          0,
-	          SEEK_SET,
 	          &error );
 
-	QCOW_TEST_ASSERT_EQUAL_INT64(
-	 "offset",
-	 offset,
-	 (int64_t) 0 );
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
 
 	QCOW_TEST_ASSERT_IS_NULL(
 	 "error",
 	 error );
 
-	remaining_media_size = media_size;
+	result = libcthreads_read_write_lock_release_for_write(
+	          held_lock,
+	          &error );
 
-	for( test_number = 0;
-	     test_number < number_of_tests;
-	     test_number++ )
-	{
-		random_number = rand();
+	held_lock = NULL;
 
-		QCOW_TEST_ASSERT_GREATER_THAN_INT(
-		 "random_number",
-		 random_number,
-		 -1 );
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
 
-		read_size = (size_t) random_number % QCOW_TEST_FILE_READ_BUFFER_SIZE;
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
 
-#if defined( QCOW_TEST_FILE_VERBOSE )
-		fprintf(
-		 stdout,
-		 "libqcow_file_read_buffer: at offset: %" PRIi64 " (0x%08" PRIx64 ") of size: %" PRIzd "\n",
-		 read_offset,
-		 read_offset,
-		 read_size );
-#endif
-		read_count = libqcow_file_read_buffer(
-		              file,
-		              buffer,
-		              read_size,
-		              &error );
+	result = pthread_join(
+	          thread,
+	          NULL );
 
-		if( read_size > remaining_media_size )
-		{
-			read_size = (size_t) remaining_media_size;
-		}
-		QCOW_TEST_ASSERT_EQUAL_SSIZE(
-		 "read_count",
-		 read_count,
-		 (ssize_t) read_size );
+	thread_is_running = 0;
 
-		QCOW_TEST_ASSERT_IS_NULL(
-		 "error",
-		 error );
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
 
-		read_offset += read_count;
+	QCOW_TEST_ASSERT_EQUAL_SSIZE(
+	 "read_values.read_count",
+	 read_values.read_count,
+	 (ssize_t) ( 4 * 4096 ) );
 
-		result = libqcow_file_get_offset(
-		          file,
-		          &offset,
-		          &error );
+	QCOW_TEST_ASSERT_EQUAL_UINT8(
+	 "read_values.has_error",
+	 read_values.has_error,
+	 (uint8_t) 0 );
 
-		QCOW_TEST_ASSERT_EQUAL_INT(
-		 "result",
-		 result,
-		 1 );
+	result = memory_compare(
+	          data,
+	          expected_data,
+	          4 * 4096 );
 
-		QCOW_TEST_ASSERT_EQUAL_INT64(
-		 "offset",
-		 offset,
-		 read_offset );
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
 
-		QCOW_TEST_ASSERT_IS_NULL(
-		 "error",
-		 error );
+	/* Test a read of which the deadline passes while it waits for the file
+	 * The read stops before any data was read
+	 */
+	held_lock = ( (libqcow_internal_file_t *) file )->read_write_lock;
 
-		remaining_media_size -= read_count;
+	result = libcthreads_read_write_lock_grab_for_write(
+	          held_lock,
+	          &error );
 
-		if( remaining_media_size == 0 )
-		{
-			offset = libqcow_file_seek_offset(
-			          file,
-			          0,
-			          SEEK_SET,
-			          &error );
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
 
-			QCOW_TEST_ASSERT_EQUAL_INT64(
-			 "offset",
-			 offset,
-			 (int64_t) 0 );
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
 
-			QCOW_TEST_ASSERT_IS_NULL(
-			 "error",
-			 error );
+	read_values.timeout    = 20;
+	read_values.read_count = 0;
+	read_values.has_error  = 0;
 
-			read_offset = 0;
+	result = pthread_create(
+	          &thread,
+	          NULL,
+	          &qcow_test_file_stopped_read_thread,
+	          &read_values );
 
-			remaining_media_size = media_size;
-		}
-	}
-	/* Reset offset to 0
-	 */
-	offset = libqcow_file_seek_offset(
-	          file,
-	          0,
-	          SEEK_SET,
-	          &error );
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
 
-	QCOW_TEST_ASSERT_EQUAL_INT64(
-	 "offset",
-	 offset,
-	 (int64_t) 0 );
+	thread_is_running = 1;
 
-	QCOW_TEST_ASSERT_IS_NULL(
-	 "error",
-	 error );
+	nanosleep(
+	 &sleep_time,
+	 NULL );
 
-	/* Test error cases
-	 */
-	read_count = libqcow_file_read_buffer(
-	              NULL,
-	              buffer,
-	              QCOW_TEST_FILE_READ_BUFFER_SIZE,
-	              &error );
+	result = libcthreads_read_write_lock_release_for_write(
+	          held_lock,
+	          &error );
 
-	QCOW_TEST_ASSERT_EQUAL_SSIZE(
-	 "read_count",
-	 read_count,
-	 (ssize_t) -1 );
+	held_lock = NULL;
 
-	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
 	 "error",
 	 error );
 
-	libcerror_error_free(
-	 &error );
+	result = pthread_join(
+	          thread,
+	          NULL );
 
-	read_count = libqcow_file_read_buffer(
-	              file,
-	              NULL,
-	              QCOW_TEST_FILE_READ_BUFFER_SIZE,
-	              &error );
+	thread_is_running = 0;
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
 
 	QCOW_TEST_ASSERT_EQUAL_SSIZE(
-	 "read_count",
-	 read_count,
+	 "read_values.read_count",
+	 read_values.read_count,
 	 (ssize_t) -1 );
 
-	QCOW_TEST_ASSERT_IS_NOT_NULL(
-	 "error",
-	 error );
-
-	libcerror_error_free(
-	 &error );
+	QCOW_TEST_ASSERT_EQUAL_UINT8(
+	 "read_values.has_error",
+	 read_values.has_error,
+	 (uint8_t) 1 );
 
-	read_count = libqcow_file_read_buffer(
+	/* Test a read started after the stopped reads
+	 */
+	read_count = libqcow_file_read_buffer_at_offset_with_timeout(
 	              file,
-	              buffer,
-	              (size_t) SSIZE_MAX + 1,
+	              data,
+	              media_size,
+	              0,
+	              0,
 	              &error );
 
 	QCOW_TEST_ASSERT_EQUAL_SSIZE(
 	 "read_count",
 	 read_count,
-	 (ssize_t) -1 );
+	 (ssize_t) media_size );
 
-	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	QCOW_TEST_ASSERT_IS_NULL(
 	 "error",
 	 error );
 
-	libcerror_error_free(
-	 &error );
+	result = memory_compare(
+	          data,
+	          expected_data,
+	          media_size );
 
-#if defined( HAVE_QCOW_TEST_RWLOCK_HOOK )
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
 
-	/* Test libqcow_file_read_buffer with pthread_rwlock_wrlock failing in libcthreads_read_write_lock_grab_for_write
+	/* Clean up
 	 */
-	qcow_test_pthread_rwlock_wrlock_attempts_before_fail = 0;
+	memory_free(
+	 expected_data );
 
-	read_count = libqcow_file_read_buffer(
-	              file,
-	              buffer,
-	              QCOW_TEST_FILE_READ_BUFFER_SIZE,
-	              &error );
+	expected_data = NULL;
+
+	memory_free(
+	 data );
+
+	data = NULL;
+
+	result = qcow_test_file_close_source(
+	          &file,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = qcow_test_close_file_io_handle(
+	          &file_io_handle,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = qcow_test_file_close_source(
+	          &parent_file,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = qcow_test_close_file_io_handle(
+	          &parent_file_io_handle,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	memory_free(
+	 image_data );
+
+	memory_free(
+	 parent_image_data );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	if( held_lock != NULL )
+	{
+		libcthreads_read_write_lock_release_for_write(
+		 held_lock,
+		 NULL );
+	}
+	if( thread_is_running != 0 )
+	{
+		pthread_join(
+		 thread,
+		 NULL );
+	}
+	if( expected_data != NULL )
+	{
+		memory_free(
+		 expected_data );
+	}
+	if( data != NULL )
+	{
+		memory_free(
+		 data );
+	}
+	if( file != NULL )
+	{
+		qcow_test_file_close_source(
+		 &file,
+		 NULL );
+	}
+	if( file_io_handle != NULL )
+	{
+		libbfio_handle_free(
+		 &file_io_handle,
+		 NULL );
+	}
+	if( parent_file != NULL )
+	{
+		qcow_test_file_close_source(
+		 &parent_file,
+		 NULL );
+	}
+	if( parent_file_io_handle != NULL )
+	{
+		libbfio_handle_free(
+		 &parent_file_io_handle,
+		 NULL );
+	}
+	if( image_data != NULL )
+	{
+		memory_free(
+		 image_data );
+	}
+	if( parent_image_data != NULL )
+	{
+		memory_free(
+		 parent_image_data );
+	}
+	return( 0 );
+}
+
+#endif /* defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT ) && defined( HAVE_QCOW_TEST_FILE_THREADS ) */
+
+/* Tests the libqcow_file_open function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_file_open(
+     const system_character_t *source,
+     const system_character_t *password )
+{
+	char narrow_source[ 256 ];
+
+	libcerror_error_t *error = NULL;
+	libqcow_file_t *file     = NULL;
+	size_t string_length     = 0;
+	int result               = 0;
+
+	/* Initialize test
+	 */
+	result = qcow_test_get_narrow_source(
+	          source,
+	          narrow_source,
+	          256,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_file_initialize(
+	          &file,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "file",
+	 file );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	if( password != NULL )
+	{
+		string_length = system_string_length(
+		                 password );
+
+#if defined( HAVE_WIDE_SYSTEM_CHARACTER )
+		result = libqcow_file_set_utf16_password(
+		          file,
+		          (uint16_t *) password,
+		          string_length,
+		          &error );
+#else
+		result = libqcow_file_set_utf8_password(
+		          file,
+		          (uint8_t *) password,
+		          string_length,
+		          &error );
+#endif
+		QCOW_TEST_ASSERT_EQUAL_INT(
+		 "result",
+		 result,
+		 1 );
+
+	        QCOW_TEST_ASSERT_IS_NULL(
+	         "error",
+		 error );
+	}
+	/* Test open
+	 */
+	result = libqcow_file_open(
+	          file,
+	          narrow_source,
+	          LIBQCOW_OPEN_READ,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test error cases
+	 */
+	result = libqcow_file_open(
+	          NULL,
+	          narrow_source,
+	          LIBQCOW_OPEN_READ,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_file_open(
+	          file,
+	          NULL,
+	          LIBQCOW_OPEN_READ,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_file_open(
+	          file,
+	          narrow_source,
+	          -1,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	/* Test open when already opened
+	 */
+	result = libqcow_file_open(
+	          file,
+	          narrow_source,
+	          LIBQCOW_OPEN_READ,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	/* Clean up
+	 */
+	result = libqcow_file_free(
+	          &file,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "file",
+	 file );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	if( file != NULL )
+	{
+		libqcow_file_free(
+		 &file,
+		 NULL );
+	}
+	return( 0 );
+}
+
+#if defined( HAVE_WIDE_CHARACTER_TYPE )
+
+/* Tests the libqcow_file_open_wide function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_file_open_wide(
+     const system_character_t *source,
+     const system_character_t *password )
+{
+	wchar_t wide_source[ 256 ];
+
+	libcerror_error_t *error = NULL;
+	libqcow_file_t *file     = NULL;
+	size_t string_length     = 0;
+	int result               = 0;
+
+	/* Initialize test
+	 */
+	result = qcow_test_get_wide_source(
+	          source,
+	          wide_source,
+	          256,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_file_initialize(
+	          &file,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "file",
+	 file );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	if( password != NULL )
+	{
+		string_length = system_string_length(
+		                 password );
+
+#if defined( HAVE_WIDE_SYSTEM_CHARACTER )
+		result = libqcow_file_set_utf16_password(
+		          file,
+		          (uint16_t *) password,
+		          string_length,
+		          &error );
+#else
+		result = libqcow_file_set_utf8_password(
+		          file,
+		          (uint8_t *) password,
+		          string_length,
+		          &error );
+#endif
+		QCOW_TEST_ASSERT_EQUAL_INT(
+		 "result",
+		 result,
+		 1 );
+
+	        QCOW_TEST_ASSERT_IS_NULL(
+	         "error",
+		 error );
+	}
+	/* Test open
+	 */
+	result = libqcow_file_open_wide(
+	          file,
+	          wide_source,
+	          LIBQCOW_OPEN_READ,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test error cases
+	 */
+	result = libqcow_file_open_wide(
+	          NULL,
+	          wide_source,
+	          LIBQCOW_OPEN_READ,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_file_open_wide(
+	          file,
+	          NULL,
+	          LIBQCOW_OPEN_READ,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_file_open_wide(
+	          file,
+	          wide_source,
+	          -1,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	/* Test open when already opened
+	 */
+	result = libqcow_file_open_wide(
+	          file,
+	          wide_source,
+	          LIBQCOW_OPEN_READ,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	/* Clean up
+	 */
+	result = libqcow_file_free(
+	          &file,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "file",
+	 file );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	if( file != NULL )
+	{
+		libqcow_file_free(
+		 &file,
+		 NULL );
+	}
+	return( 0 );
+}
+
+#endif /* defined( HAVE_WIDE_CHARACTER_TYPE ) */
+
+/* Tests the libqcow_file_open_with_backing_chain function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_file_open_with_backing_chain(
+     const system_character_t *source,
+     const system_character_t *password )
+{
+	char narrow_source[ 256 ];
+
+	libcerror_error_t *error = NULL;
+	libqcow_file_t *file     = NULL;
+	size_t string_length     = 0;
+	int result               = 0;
+
+	/* Initialize test
+	 */
+	result = qcow_test_get_narrow_source(
+	          source,
+	          narrow_source,
+	          256,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_file_initialize(
+	          &file,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "file",
+	 file );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	if( password != NULL )
+	{
+		string_length = system_string_length(
+		                 password );
+
+#if defined( HAVE_WIDE_SYSTEM_CHARACTER )
+		result = libqcow_file_set_utf16_password(
+		          file,
+		          (uint16_t *) password,
+		          string_length,
+		          &error );
+#else
+		result = libqcow_file_set_utf8_password(
+		          file,
+		          (uint8_t *) password,
+		          string_length,
+		          &error );
+#endif
+		QCOW_TEST_ASSERT_EQUAL_INT(
+		 "result",
+		 result,
+		 1 );
+
+	        QCOW_TEST_ASSERT_IS_NULL(
+	         "error",
+		 error );
+	}
+	/* Test open
+	 */
+	result = libqcow_file_open_with_backing_chain(
+	          file,
+	          narrow_source,
+	          LIBQCOW_OPEN_READ,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test error cases
+	 */
+	result = libqcow_file_open_with_backing_chain(
+	          NULL,
+	          narrow_source,
+	          LIBQCOW_OPEN_READ,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_file_open_with_backing_chain(
+	          file,
+	          NULL,
+	          LIBQCOW_OPEN_READ,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_file_open_with_backing_chain(
+	          file,
+	          narrow_source,
+	          -1,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	/* Test open when already opened
+	 */
+	result = libqcow_file_open_with_backing_chain(
+	          file,
+	          narrow_source,
+	          LIBQCOW_OPEN_READ,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	/* Clean up
+	 */
+	result = libqcow_file_free(
+	          &file,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "file",
+	 file );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	if( file != NULL )
+	{
+		libqcow_file_free(
+		 &file,
+		 NULL );
+	}
+	return( 0 );
+}
+
+/* Tests the libqcow_file_open_file_io_handle function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_file_open_file_io_handle(
+     const system_character_t *source,
+     const system_character_t *password )
+{
+	libbfio_handle_t *file_io_handle = NULL;
+	libcerror_error_t *error         = NULL;
+	libqcow_file_t *file             = NULL;
+	size_t string_length             = 0;
+	int result                       = 0;
+
+	/* Initialize test
+	 */
+	result = libbfio_file_initialize(
+	          &file_io_handle,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "file_io_handle",
+	 file_io_handle );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	string_length = system_string_length(
+	                 source );
+
+#if defined( HAVE_WIDE_SYSTEM_CHARACTER )
+	result = libbfio_file_set_name_wide(
+	          file_io_handle,
+	          source,
+	          string_length,
+	          &error );
+#else
+	result = libbfio_file_set_name(
+	          file_io_handle,
+	          source,
+	          string_length,
+	          &error );
+#endif
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_file_initialize(
+	          &file,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "file",
+	 file );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	if( password != NULL )
+	{
+		string_length = system_string_length(
+		                 password );
+
+#if defined( HAVE_WIDE_SYSTEM_CHARACTER )
+		result = libqcow_file_set_utf16_password(
+		          file,
+		          (uint16_t *) password,
+		          string_length,
+		          &error );
+#else
+		result = libqcow_file_set_utf8_password(
+		          file,
+		          (uint8_t *) password,
+		          string_length,
+		          &error );
+#endif
+		QCOW_TEST_ASSERT_EQUAL_INT(
+		 "result",
+		 result,
+		 1 );
+
+	        QCOW_TEST_ASSERT_IS_NULL(
+	         "error",
+		 error );
+	}
+	/* Test open
+	 */
+	result = libqcow_file_open_file_io_handle(
+	          file,
+	          file_io_handle,
+	          LIBQCOW_OPEN_READ,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test error cases
+	 */
+	result = libqcow_file_open_file_io_handle(
+	          NULL,
+	          file_io_handle,
+	          LIBQCOW_OPEN_READ,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_file_open_file_io_handle(
+	          file,
+	          NULL,
+	          LIBQCOW_OPEN_READ,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_file_open_file_io_handle(
+	          file,
+	          file_io_handle,
+	          -1,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	/* Test open when already opened
+	 */
+	result = libqcow_file_open_file_io_handle(
+	          file,
+	          file_io_handle,
+	          LIBQCOW_OPEN_READ,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+#if defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT )
+
+	/* Test that the file IO handle is not cloned without the clone file IO handle open flag
+	 */
+	result = libqcow_internal_file_open_file_io_pool(
+	          (libqcow_internal_file_t *) file,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "internal_file->file_io_pool",
+	 ( (libqcow_internal_file_t *) file )->file_io_pool );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT8(
+	 "internal_file->file_io_handle_cannot_be_cloned",
+	 ( (libqcow_internal_file_t *) file )->file_io_handle_cannot_be_cloned,
+	 1 );
+
+	result = libqcow_file_close(
+	          file,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test that the file IO handle is cloned with the clone file IO handle open flag
+	 */
+	result = libqcow_file_open_file_io_handle(
+	          file,
+	          file_io_handle,
+	          LIBQCOW_OPEN_READ | LIBQCOW_OPEN_FLAG_CLONE_FILE_IO_HANDLE,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_internal_file_open_file_io_pool(
+	          (libqcow_internal_file_t *) file,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "internal_file->file_io_pool",
+	 ( (libqcow_internal_file_t *) file )->file_io_pool );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT8(
+	 "internal_file->file_io_handle_cannot_be_cloned",
+	 ( (libqcow_internal_file_t *) file )->file_io_handle_cannot_be_cloned,
+	 0 );
+
+#endif /* defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT ) */
+
+	/* Clean up
+	 */
+	result = libqcow_file_free(
+	          &file,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "file",
+	 file );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libbfio_handle_free(
+	          &file_io_handle,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "file_io_handle",
+	 file_io_handle );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	if( file != NULL )
+	{
+		libqcow_file_free(
+		 &file,
+		 NULL );
+	}
+	if( file_io_handle != NULL )
+	{
+		libbfio_handle_free(
+		 &file_io_handle,
+		 NULL );
+	}
+	return( 0 );
+}
+
+/* Tests the libqcow_file_close function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_file_close(
+     void )
+{
+	libcerror_error_t *error = NULL;
+	int result               = 0;
+
+	/* Test error cases
+	 */
+	result = libqcow_file_close(
+	          NULL,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	return( 0 );
+}
+
+/* Tests the libqcow_file_open and libqcow_file_close functions
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_file_open_close(
+     const system_character_t *source,
+     const system_character_t *password )
+{
+	libcerror_error_t *error = NULL;
+	libqcow_file_t *file     = NULL;
+	size_t string_length     = 0;
+	int result               = 0;
+
+	/* Initialize test
+	 */
+	result = libqcow_file_initialize(
+	          &file,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "file",
+	 file );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	if( password != NULL )
+	{
+		string_length = system_string_length(
+		                 password );
+
+#if defined( HAVE_WIDE_SYSTEM_CHARACTER )
+		result = libqcow_file_set_utf16_password(
+		          file,
+		          (uint16_t *) password,
+		          string_length,
+		          &error );
+#else
+		result = libqcow_file_set_utf8_password(
+		          file,
+		          (uint8_t *) password,
+		          string_length,
+		          &error );
+#endif
+		QCOW_TEST_ASSERT_EQUAL_INT(
+		 "result",
+		 result,
+		 1 );
+
+	        QCOW_TEST_ASSERT_IS_NULL(
+	         "error",
+		 error );
+	}
+	/* Test open and close
+	 */
+#if defined( HAVE_WIDE_SYSTEM_CHARACTER )
+	result = libqcow_file_open_wide(
+	          file,
+	          source,
+	          LIBQCOW_OPEN_READ,
+	          &error );
+#else
+	result = libqcow_file_open(
+	          file,
+	          source,
+	          LIBQCOW_OPEN_READ,
+	          &error );
+#endif
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+#if defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT )
+
+	/* Without a cache pool the file creates a cache pool of its own
+	 */
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "internal_file->cache_pool",
+	 ( (libqcow_internal_file_t *) file )->cache_pool );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT8(
+	 "internal_file->cache_pool_created_in_library",
+	 ( (libqcow_internal_file_t *) file )->cache_pool_created_in_library,
+	 1 );
+
+#endif /* defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT ) */
+
+	result = libqcow_file_close(
+	          file,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+#if defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT )
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "internal_file->cache_pool",
+	 ( (libqcow_internal_file_t *) file )->cache_pool );
+
+#endif /* defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT ) */
+
+	/* Test open and close a second time to validate clean up on close
+	 */
+#if defined( HAVE_WIDE_SYSTEM_CHARACTER )
+	result = libqcow_file_open_wide(
+	          file,
+	          source,
+	          LIBQCOW_OPEN_READ,
+	          &error );
+#else
+	result = libqcow_file_open(
+	          file,
+	          source,
+	          LIBQCOW_OPEN_READ,
+	          &error );
+#endif
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_file_close(
+	          file,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Clean up
+	 */
+	result = libqcow_file_free(
+	          &file,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "file",
+	 file );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	if( file != NULL )
+	{
+		libqcow_file_free(
+		 &file,
+		 NULL );
+	}
+	return( 0 );
+}
+
+/* Tests the libqcow_file_signal_abort function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_file_signal_abort(
+     libqcow_file_t *file )
+{
+	uint8_t buffer[ 16 ];
+
+	libcerror_error_t *error  = NULL;
+	ssize_t read_count        = 0;
+	uint32_t abort_generation = 0;
+	int result                = 0;
+
+#if defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT )
+	abort_generation = ( (libqcow_internal_file_t *) file )->abort_generation;
+
+#endif /* defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT ) */
+	/* Test regular cases
+	 */
+	result = libqcow_file_signal_abort(
+	          file,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+#if defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT )
+	QCOW_TEST_ASSERT_EQUAL_UINT32(
+	 "abort_generation",
+	 ( (libqcow_internal_file_t *) file )->abort_generation,
+	 abort_generation + 1 );
+
+#endif /* defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT ) */
+	/* The abort only applies to reads in progress, a read started afterwards succeeds
+	 */
+	read_count = libqcow_file_read_buffer_at_offset(
+	              file,
+	              buffer,
+	              16,
+	              0,
+	              &error );
+
+	QCOW_TEST_ASSERT_EQUAL_SSIZE(
+	 "read_count",
+	 read_count,
+	 (ssize_t) 16 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test error cases
+	 */
+	result = libqcow_file_signal_abort(
+	          NULL,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	return( 0 );
+}
+
+/* Tests the libqcow_file_is_locked function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_file_is_locked(
+     libqcow_file_t *file )
+{
+	libcerror_error_t *error = NULL;
+	int result               = 0;
+
+	/* Test regular cases
+	 */
+	result = libqcow_file_is_locked(
+	          file,
+	          &error );
+
+	QCOW_TEST_ASSERT_NOT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test error cases
+	 */
+	result = libqcow_file_is_locked(
+	          NULL,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	return( 0 );
+}
+
+#if defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT )
+
+/* Tests the libqcow_internal_file_read_buffer_from_file_io_handle function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_internal_file_read_buffer_from_file_io_handle(
+     libqcow_file_t *file )
+{
+	uint8_t buffer[ QCOW_TEST_FILE_READ_BUFFER_SIZE ];
+
+	libcerror_error_t *error      = NULL;
+	time_t timestamp              = 0;
+	size64_t media_size           = 0;
+	size64_t remaining_media_size = 0;
+	size_t read_size              = 0;
+	ssize_t read_count            = 0;
+	off64_t offset                = 0;
+	off64_t read_offset           = 0;
+	uint32_t abort_generation     = 0;
+	int number_of_tests           = 1024;
+	int random_number             = 0;
+	int result                    = 0;
+	int test_number               = 0;
+
+	/* Determine size
+	 */
+	result = libqcow_file_get_media_size(
+	          file,
+	          &media_size,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Determine the abort generation
+	 */
+	result = libqcow_internal_file_get_abort_generation(
+	          (libqcow_internal_file_t *) file,
+	          &abort_generation,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Reset offset to 0
+	 */
+	offset = libqcow_file_seek_offset(
+	          file,
+	          0,
+	          SEEK_SET,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT64(
+	 "offset",
+	 offset,
+	 (int64_t) 0 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test regular cases
+	 */
+	read_size = QCOW_TEST_FILE_READ_BUFFER_SIZE;
+
+	if( media_size < QCOW_TEST_FILE_READ_BUFFER_SIZE )
+	{
+		read_size = (size_t) media_size;
+	}
+	read_count = libqcow_internal_file_read_buffer_from_file_io_handle(
+	              (libqcow_internal_file_t *) file,
+	              ( (libqcow_internal_file_t *) file )->file_io_handle,
+	              buffer,
+	              QCOW_TEST_FILE_READ_BUFFER_SIZE,
+	              0,
+	              NULL,
+	              abort_generation,
+	              &error );
+
+	QCOW_TEST_ASSERT_EQUAL_SSIZE(
+	 "read_count",
+	 read_count,
+	 (ssize_t) read_size );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	if( media_size > 8 )
+	{
+		/* Read buffer on media_size boundary
+		 */
+		read_count = libqcow_internal_file_read_buffer_from_file_io_handle(
+		              (libqcow_internal_file_t *) file,
+		              ( (libqcow_internal_file_t *) file )->file_io_handle,
+		              buffer,
+		              QCOW_TEST_FILE_READ_BUFFER_SIZE,
+		              (off64_t) media_size - 8,
+		              NULL,
+		              abort_generation,
+		              &error );
+
+		QCOW_TEST_ASSERT_EQUAL_SSIZE(
+		 "read_count",
+		 read_count,
+		 (ssize_t) 8 );
+
+		QCOW_TEST_ASSERT_IS_NULL(
+		 "error",
+		 error );
+
+		/* Read buffer beyond media_size boundary
+		 */
+		read_count = libqcow_internal_file_read_buffer_from_file_io_handle(
+		              (libqcow_internal_file_t *) file,
+		              ( (libqcow_internal_file_t *) file )->file_io_handle,
+		              buffer,
+		              QCOW_TEST_FILE_READ_BUFFER_SIZE,
+		              (off64_t) media_size,
+		              NULL,
+		              abort_generation,
+		              &error );
+
+		QCOW_TEST_ASSERT_EQUAL_SSIZE(
+		 "read_count",
+		 read_count,
+		 (ssize_t) 0 );
+
+		QCOW_TEST_ASSERT_IS_NULL(
+		 "error",
+		 error );
+	}
+	/* Stress test read buffer
+	 */
+	timestamp = time(
+	             NULL );
+
+	srand(
+	 (unsigned int) timestamp );
+
+	remaining_media_size = media_size;
+
+	for( test_number = 0;
+	     test_number < number_of_tests;
+	     test_number++ )
+	{
+		random_number = rand();
+
+		QCOW_TEST_ASSERT_GREATER_THAN_INT(
+		 "random_number",
+		 random_number,
+		 -1 );
+
+		read_size = (size_t) random_number % QCOW_TEST_FILE_READ_BUFFER_SIZE;
+
+#if defined( QCOW_TEST_FILE_VERBOSE )
+		fprintf(
+		 stdout,
+		 "libqcow_file_read_buffer: at offset: %" PRIi64 " (0x%08" PRIx64 ") of size: %" PRIzd "\n",
+		 read_offset,
+		 read_offset,
+		 read_size );
+#endif
+		read_count = libqcow_internal_file_read_buffer_from_file_io_handle(
+		              (libqcow_internal_file_t *) file,
+		              ( (libqcow_internal_file_t *) file )->file_io_handle,
+		              buffer,
+		              read_size,
+		              read_offset,
+		              NULL,
+		              abort_generation,
+		              &error );
+
+		if( read_size > remaining_media_size )
+		{
+			read_size = (size_t) remaining_media_size;
+		}
+		QCOW_TEST_ASSERT_EQUAL_SSIZE(
+		 "read_count",
+		 read_count,
+		 (ssize_t) read_size );
+
+		QCOW_TEST_ASSERT_IS_NULL(
+		 "error",
+		 error );
+
+		read_offset += read_count;
+
+		/* The read does not change the current offset of the file
+		 */
+		result = libqcow_file_get_offset(
+		          file,
+		          &offset,
+		          &error );
+
+		QCOW_TEST_ASSERT_EQUAL_INT(
+		 "result",
+		 result,
+		 1 );
+
+		QCOW_TEST_ASSERT_EQUAL_INT64(
+		 "offset",
+		 offset,
+		 (int64_t) 0 );
+
+		QCOW_TEST_ASSERT_IS_NULL(
+		 "error",
+		 error );
+
+		remaining_media_size -= read_count;
+
+		if( remaining_media_size == 0 )
+		{
+			read_offset = 0;
+
+			remaining_media_size = media_size;
+		}
+	}
+	/* Test error cases
+	 */
+	read_count = libqcow_internal_file_read_buffer_from_file_io_handle(
+	              NULL,
+	              ( (libqcow_internal_file_t *) file )->file_io_handle,
+	              buffer,
+	              QCOW_TEST_FILE_READ_BUFFER_SIZE,
+	              0,
+	              NULL,
+	              abort_generation,
+	              &error );
+
+	QCOW_TEST_ASSERT_EQUAL_SSIZE(
+	 "read_count",
+	 read_count,
+	 (ssize_t) -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	read_count = libqcow_internal_file_read_buffer_from_file_io_handle(
+	              (libqcow_internal_file_t *) file,
+	              ( (libqcow_internal_file_t *) file )->file_io_handle,
+	              NULL,
+	              QCOW_TEST_FILE_READ_BUFFER_SIZE,
+	              0,
+	              NULL,
+	              abort_generation,
+	              &error );
+
+	QCOW_TEST_ASSERT_EQUAL_SSIZE(
+	 "read_count",
+	 read_count,
+	 (ssize_t) -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	read_count = libqcow_internal_file_read_buffer_from_file_io_handle(
+	              (libqcow_internal_file_t *) file,
+	              ( (libqcow_internal_file_t *) file )->file_io_handle,
+	              buffer,
+	              (size_t) SSIZE_MAX + 1,
+	              0,
+	              NULL,
+	              abort_generation,
+	              &error );
+
+	QCOW_TEST_ASSERT_EQUAL_SSIZE(
+	 "read_count",
+	 read_count,
+	 (ssize_t) -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	read_count = libqcow_internal_file_read_buffer_from_file_io_handle(
+	              (libqcow_internal_file_t *) file,
+	              ( (libqcow_internal_file_t *) file )->file_io_handle,
+	              buffer,
+	              QCOW_TEST_FILE_READ_BUFFER_SIZE,
+	              -1,
+	              NULL,
+	              abort_generation,
+	              &error );
+
+	QCOW_TEST_ASSERT_EQUAL_SSIZE(
+	 "read_count",
+	 read_count,
+	 (ssize_t) -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	return( 0 );
+}
+
+#endif /* defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT ) */
+
+/* Tests the libqcow_file_read_buffer function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_file_read_buffer(
+     libqcow_file_t *file )
+{
+	uint8_t buffer[ QCOW_TEST_FILE_READ_BUFFER_SIZE ];
+
+	libcerror_error_t *error      = NULL;
+	time_t timestamp              = 0;
+	size64_t media_size           = 0;
+	size64_t remaining_media_size = 0;
+	size_t read_size              = 0;
+	ssize_t read_count            = 0;
+	off64_t offset                = 0;
+	off64_t read_offset           = 0;
+	int number_of_tests           = 1024;
+	int random_number             = 0;
+	int result                    = 0;
+	int test_number               = 0;
+
+	/* Determine size
+	 */
+	result = libqcow_file_get_media_size(
+	          file,
+	          &media_size,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Reset offset to 0
+	 */
+	offset = libqcow_file_seek_offset(
+	          file,
+	          0,
+	          SEEK_SET,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT64(
+	 "offset",
+	 offset,
+	 (int64_t) 0 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test regular cases
+	 */
+	read_size = QCOW_TEST_FILE_READ_BUFFER_SIZE;
+
+	if( media_size < QCOW_TEST_FILE_READ_BUFFER_SIZE )
+	{
+		read_size = (size_t) media_size;
+	}
+	read_count = libqcow_file_read_buffer(
+	              file,
+	              buffer,
+	              QCOW_TEST_FILE_READ_BUFFER_SIZE,
+	              &error );
+
+	QCOW_TEST_ASSERT_EQUAL_SSIZE(
+	 "read_count",
+	 read_count,
+	 (ssize_t) read_size );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	if( media_size > 8 )
+	{
+		/* Set offset to media_size - 8
+		 */
+		offset = libqcow_file_seek_offset(
+		          file,
+		          -8,
+		          SEEK_END,
+		          &error );
+
+		QCOW_TEST_ASSERT_EQUAL_INT64(
+		 "offset",
+		 offset,
+		 (int64_t) media_size - 8 );
+
+		QCOW_TEST_ASSERT_IS_NULL(
+		 "error",
+		 error );
+
+		/* Read buffer on media_size boundary
+		 */
+		read_count = libqcow_file_read_buffer(
+		              file,
+		              buffer,
+		              QCOW_TEST_FILE_READ_BUFFER_SIZE,
+		              &error );
+
+		QCOW_TEST_ASSERT_EQUAL_SSIZE(
+		 "read_count",
+		 read_count,
+		 (ssize_t) 8 );
+
+		QCOW_TEST_ASSERT_IS_NULL(
+		 "error",
+		 error );
+
+		/* Read buffer beyond media_size boundary
+		 */
+		read_count = libqcow_file_read_buffer(
+		              file,
+		              buffer,
+		              QCOW_TEST_FILE_READ_BUFFER_SIZE,
+		              &error );
+
+		QCOW_TEST_ASSERT_EQUAL_SSIZE(
+		 "read_count",
+		 read_count,
+		 (ssize_t) 0 );
+
+		QCOW_TEST_ASSERT_IS_NULL(
+		 "error",
+		 error );
+	}
+	/* Stress test read buffer
+	 */
+	timestamp = time(
+	             NULL );
+
+	srand(
+	 (unsigned int) timestamp );
+
+	offset = libqcow_file_seek_offset(
+	          file,
+	          0,
+	          SEEK_SET,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT64(
+	 "offset",
+	 offset,
+	 (int64_t) 0 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	remaining_media_size = media_size;
+
+	for( test_number = 0;
+	     test_number < number_of_tests;
+	     test_number++ )
+	{
+		random_number = rand();
+
+		QCOW_TEST_ASSERT_GREATER_THAN_INT(
+		 "random_number",
+		 random_number,
+		 -1 );
+
+		read_size = (size_t) random_number % QCOW_TEST_FILE_READ_BUFFER_SIZE;
+
+#if defined( QCOW_TEST_FILE_VERBOSE )
+		fprintf(
+		 stdout,
+		 "libqcow_file_read_buffer: at offset: %" PRIi64 " (0x%08" PRIx64 ") of size: %" PRIzd "\n",
+		 read_offset,
+		 read_offset,
+		 read_size );
+#endif
+		read_count = libqcow_file_read_buffer(
+		              file,
+		              buffer,
+		              read_size,
+		              &error );
+
+		if( read_size > remaining_media_size )
+		{
+			read_size = (size_t) remaining_media_size;
+		}
+		QCOW_TEST_ASSERT_EQUAL_SSIZE(
+		 "read_count",
+		 read_count,
+		 (ssize_t) read_size );
+
+		QCOW_TEST_ASSERT_IS_NULL(
+		 "error",
+		 error );
+
+		read_offset += read_count;
+
+		result = libqcow_file_get_offset(
+		          file,
+		          &offset,
+		          &error );
+
+		QCOW_TEST_ASSERT_EQUAL_INT(
+		 "result",
+		 result,
+		 1 );
+
+		QCOW_TEST_ASSERT_EQUAL_INT64(
+		 "offset",
+		 offset,
+		 read_offset );
+
+		QCOW_TEST_ASSERT_IS_NULL(
+		 "error",
+		 error );
+
+		remaining_media_size -= read_count;
+
+		if( remaining_media_size == 0 )
+		{
+			offset = libqcow_file_seek_offset(
+			          file,
+			          0,
+			          SEEK_SET,
+			          &error );
+
+			QCOW_TEST_ASSERT_EQUAL_INT64(
+			 "offset",
+			 offset,
+			 (int64_t) 0 );
+
+			QCOW_TEST_ASSERT_IS_NULL(
+			 "error",
+			 error );
+
+			read_offset = 0;
+
+			remaining_media_size = media_size;
+		}
+	}
+	/* Reset offset to 0
+	 */
+	offset = libqcow_file_seek_offset(
+	          file,
+	          0,
+	          SEEK_SET,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT64(
+	 "offset",
+	 offset,
+	 (int64_t) 0 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test error cases
+	 */
+	read_count = libqcow_file_read_buffer(
+	              NULL,
+	              buffer,
+	              QCOW_TEST_FILE_READ_BUFFER_SIZE,
+	              &error );
+
+	QCOW_TEST_ASSERT_EQUAL_SSIZE(
+	 "read_count",
+	 read_count,
+	 (ssize_t) -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	read_count = libqcow_file_read_buffer(
+	              file,
+	              NULL,
+	              QCOW_TEST_FILE_READ_BUFFER_SIZE,
+	              &error );
+
+	QCOW_TEST_ASSERT_EQUAL_SSIZE(
+	 "read_count",
+	 read_count,
+	 (ssize_t) -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	read_count = libqcow_file_read_buffer(
+	              file,
+	              buffer,
+	              (size_t) SSIZE_MAX + 1,
+	              &error );
+
+	QCOW_TEST_ASSERT_EQUAL_SSIZE(
+	 "read_count",
+	 read_count,
+	 (ssize_t) -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+#if defined( HAVE_QCOW_TEST_RWLOCK_HOOK )
+
+	/* Test libqcow_file_read_buffer with pthread_rwlock_wrlock failing in libcthreads_read_write_lock_grab_for_write
+	 */
+	qcow_test_pthread_rwlock_wrlock_attempts_before_fail = 0;
+
+	read_count = libqcow_file_read_buffer(
+	              file,
+	              buffer,
+	              QCOW_TEST_FILE_READ_BUFFER_SIZE,
+	              &error );
+
+	if( qcow_test_pthread_rwlock_wrlock_attempts_before_fail != -1 )
+	{
+		qcow_test_pthread_rwlock_wrlock_attempts_before_fail = -1;
+	}
+	else
+	{
+		QCOW_TEST_ASSERT_EQUAL_SSIZE(
+		 "read_count",
+		 read_count,
+		 (ssize_t) -1 );
+
+		QCOW_TEST_ASSERT_IS_NOT_NULL(
+		 "error",
+		 error );
+
+		libcerror_error_free(
+		 &error );
+	}
+#if defined( HAVE_PTHREAD_RWLOCK_UNLOCK_HOOK )
+
+	/* Test libqcow_file_read_buffer with pthread_rwlock_unlock failing in libcthreads_read_write_lock_release_for_write
+	 */
+	qcow_test_pthread_rwlock_unlock_attempts_before_fail = 0;
+
+	read_count = libqcow_file_read_buffer(
+	              file,
+	              buffer,
+	              QCOW_TEST_FILE_READ_BUFFER_SIZE,
+	              &error );
+
+	if( qcow_test_pthread_rwlock_unlock_attempts_before_fail != -1 )
+	{
+		qcow_test_pthread_rwlock_unlock_attempts_before_fail = -1;
+	}
+	else
+	{
+		QCOW_TEST_ASSERT_EQUAL_SSIZE(
+		 "read_count",
+		 read_count,
+		 (ssize_t) -1 );
+
+		QCOW_TEST_ASSERT_IS_NOT_NULL(
+		 "error",
+		 error );
+
+		libcerror_error_free(
+		 &error );
+	}
+#endif /* defined( HAVE_PTHREAD_RWLOCK_UNLOCK_HOOK ) */
+#endif /* defined( HAVE_QCOW_TEST_RWLOCK_HOOK ) */
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	return( 0 );
+}
+
+/* Tests the libqcow_file_read_buffer_at_offset function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_file_read_buffer_at_offset(
+     libqcow_file_t *file )
+{
+	uint8_t buffer[ QCOW_TEST_FILE_READ_BUFFER_SIZE ];
+
+	libcerror_error_t *error      = NULL;
+	time_t timestamp              = 0;
+	size64_t media_size           = 0;
+	size64_t remaining_media_size = 0;
+	size_t read_size              = 0;
+	ssize_t read_count            = 0;
+	off64_t offset                = 0;
+	off64_t read_offset           = 0;
+	int number_of_tests           = 1024;
+	int random_number             = 0;
+	int result                    = 0;
+	int test_number               = 0;
+
+	/* Determine size
+	 */
+	result = libqcow_file_get_media_size(
+	          file,
+	          &media_size,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test regular cases
+	 */
+	read_size = QCOW_TEST_FILE_READ_BUFFER_SIZE;
+
+	if( media_size < QCOW_TEST_FILE_READ_BUFFER_SIZE )
+	{
+		read_size = (size_t) media_size;
+	}
+	read_count = libqcow_file_read_buffer_at_offset(
+	              file,
+	              buffer,
+	              QCOW_TEST_FILE_READ_BUFFER_SIZE,
+	              0,
+	              &error );
+
+	QCOW_TEST_ASSERT_EQUAL_SSIZE(
+	 "read_count",
+	 read_count,
+	 (ssize_t) read_size );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	if( media_size > 8 )
+	{
+		/* Read buffer on media_size boundary
+		 */
+		read_count = libqcow_file_read_buffer_at_offset(
+		              file,
+		              buffer,
+		              QCOW_TEST_FILE_READ_BUFFER_SIZE,
+		              media_size - 8,
+		              &error );
+
+		QCOW_TEST_ASSERT_EQUAL_SSIZE(
+		 "read_count",
+		 read_count,
+		 (ssize_t) 8 );
+
+		QCOW_TEST_ASSERT_IS_NULL(
+		 "error",
+		 error );
+
+		/* Read buffer beyond media_size boundary
+		 */
+		read_count = libqcow_file_read_buffer_at_offset(
+		              file,
+		              buffer,
+		              QCOW_TEST_FILE_READ_BUFFER_SIZE,
+		              media_size + 8,
+		              &error );
+
+		QCOW_TEST_ASSERT_EQUAL_SSIZE(
+		 "read_count",
+		 read_count,
+		 (ssize_t) 0 );
+
+		QCOW_TEST_ASSERT_IS_NULL(
+		 "error",
+		 error );
+	}
+	/* Stress test read buffer
+	 */
+	timestamp = time(
+	             NULL );
+
+	srand(
+	 (unsigned int) timestamp );
+
+	for( test_number = 0;
+	     test_number < number_of_tests;
+	     test_number++ )
+	{
+		random_number = rand();
+
+		QCOW_TEST_ASSERT_GREATER_THAN_INT(
+		 "random_number",
+		 random_number,
+		 -1 );
+
+		if( media_size > 0 )
+		{
+			read_offset = (off64_t) random_number % media_size;
+		}
+		read_size = (size_t) random_number % QCOW_TEST_FILE_READ_BUFFER_SIZE;
+
+#if defined( QCOW_TEST_FILE_VERBOSE )
+		fprintf(
+		 stdout,
+		 "libqcow_file_read_buffer_at_offset: at offset: %" PRIi64 " (0x%08" PRIx64 ") of size: %" PRIzd "\n",
+		 read_offset,
+		 read_offset,
+		 read_size );
+#endif
+		read_count = libqcow_file_read_buffer_at_offset(
+		              file,
+		              buffer,
+		              read_size,
+		              read_offset,
+		              &error );
+
+		remaining_media_size = media_size - read_offset;
+
+		if( read_size > remaining_media_size )
+		{
+			read_size = (size_t) remaining_media_size;
+		}
+		QCOW_TEST_ASSERT_EQUAL_SSIZE(
+		 "read_count",
+		 read_count,
+		 (ssize_t) read_size );
+
+		QCOW_TEST_ASSERT_IS_NULL(
+		 "error",
+		 error );
+
+		read_offset += read_count;
+
+		result = libqcow_file_get_offset(
+		          file,
+		          &offset,
+		          &error );
+
+		QCOW_TEST_ASSERT_EQUAL_INT(
+		 "result",
+		 result,
+		 1 );
+
+		QCOW_TEST_ASSERT_EQUAL_INT64(
+		 "offset",
+		 offset,
+		 read_offset );
+
+		QCOW_TEST_ASSERT_IS_NULL(
+		 "error",
+		 error );
+	}
+	/* Test error cases
+	 */
+	read_count = libqcow_file_read_buffer_at_offset(
+	              NULL,
+	              buffer,
+	              QCOW_TEST_FILE_READ_BUFFER_SIZE,
+	              0,
+	              &error );
+
+	QCOW_TEST_ASSERT_EQUAL_SSIZE(
+	 "read_count",
+	 read_count,
+	 (ssize_t) -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	read_count = libqcow_file_read_buffer_at_offset(
+	              file,
+	              NULL,
+	              QCOW_TEST_FILE_READ_BUFFER_SIZE,
+	              0,
+	              &error );
+
+	QCOW_TEST_ASSERT_EQUAL_SSIZE(
+	 "read_count",
+	 read_count,
+	 (ssize_t) -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	read_count = libqcow_file_read_buffer_at_offset(
+	              file,
+	              buffer,
+	              (size_t) SSIZE_MAX + 1,
+	              0,
+	              &error );
+
+	QCOW_TEST_ASSERT_EQUAL_SSIZE(
+	 "read_count",
+	 read_count,
+	 (ssize_t) -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	read_count = libqcow_file_read_buffer_at_offset(
+	              file,
+	              buffer,
+	              QCOW_TEST_FILE_READ_BUFFER_SIZE,
+	              -1,
+	              &error );
+
+	QCOW_TEST_ASSERT_EQUAL_SSIZE(
+	 "read_count",
+	 read_count,
+	 (ssize_t) -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+#if defined( HAVE_QCOW_TEST_RWLOCK_HOOK )
+
+	/* Test libqcow_file_read_buffer_at_offset with pthread_rwlock_wrlock failing in libcthreads_read_write_lock_grab_for_write
+	 */
+	qcow_test_pthread_rwlock_wrlock_attempts_before_fail = 0;
+
+	read_count = libqcow_file_read_buffer_at_offset(
+	              file,
+	              buffer,
+	              QCOW_TEST_FILE_READ_BUFFER_SIZE,
+	              0,
+	              &error );
+
+	if( qcow_test_pthread_rwlock_wrlock_attempts_before_fail != -1 )
+	{
+		qcow_test_pthread_rwlock_wrlock_attempts_before_fail = -1;
+	}
+	else
+	{
+		QCOW_TEST_ASSERT_EQUAL_SSIZE(
+		 "read_count",
+		 read_count,
+		 (ssize_t) -1 );
+
+		QCOW_TEST_ASSERT_IS_NOT_NULL(
+		 "error",
+		 error );
+
+		libcerror_error_free(
+		 &error );
+	}
+#if defined( HAVE_PTHREAD_RWLOCK_UNLOCK_HOOK )
+
+	/* Test libqcow_file_read_buffer_at_offset with pthread_rwlock_unlock failing in libcthreads_read_write_lock_release_for_write
+	 */
+/* TODO flaky test disabled for now
+	qcow_test_pthread_rwlock_unlock_attempts_before_fail = 0;
+
+	read_count = libqcow_file_read_buffer_at_offset(
+	              file,
+	              buffer,
+	              QCOW_TEST_FILE_READ_BUFFER_SIZE,
+	              0,
+	              &error );
+
+	if( qcow_test_pthread_rwlock_unlock_attempts_before_fail != -1 )
+	{
+		qcow_test_pthread_rwlock_unlock_attempts_before_fail = -1;
+	}
+	else
+	{
+		QCOW_TEST_ASSERT_EQUAL_SSIZE(
+		 "read_count",
+		 read_count,
+		 (ssize_t) -1 );
+
+		QCOW_TEST_ASSERT_IS_NOT_NULL(
+		 "error",
+		 error );
+
+		libcerror_error_free(
+		 &error );
+	}
+*/
+#endif /* defined( HAVE_PTHREAD_RWLOCK_UNLOCK_HOOK ) */
+#endif /* defined( HAVE_QCOW_TEST_RWLOCK_HOOK ) */
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	return( 0 );
+}
+
+/* Tests the libqcow_file_read_buffer_at_offset_concurrent function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_file_read_buffer_at_offset_concurrent(
+     libqcow_file_t *file )
+{
+	uint8_t buffer[ QCOW_TEST_FILE_READ_BUFFER_SIZE ];
+	uint8_t expected_buffer[ QCOW_TEST_FILE_READ_BUFFER_SIZE ];
+
+	libcerror_error_t *error      = NULL;
+	size64_t media_size           = 0;
+	size64_t remaining_media_size = 0;
+	size_t read_size              = 0;
+	ssize_t read_count            = 0;
+	off64_t expected_offset       = 0;
+	off64_t offset                = 0;
+	off64_t read_offset           = 0;
+	int number_of_tests           = 256;
+	int random_number             = 0;
+	int result                    = 0;
+	int test_number               = 0;
+
+	/* Determine size
+	 */
+	result = libqcow_file_get_media_size(
+	          file,
+	          &media_size,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_file_get_offset(
+	          file,
+	          &expected_offset,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test regular cases
+	 */
+	for( test_number = 0;
+	     test_number < number_of_tests;
+	     test_number++ )
+	{
+		random_number = rand();
+
+		QCOW_TEST_ASSERT_GREATER_THAN_INT(
+		 "random_number",
+		 random_number,
+		 -1 );
+
+		if( media_size > 0 )
+		{
+			read_offset = (off64_t) random_number % media_size;
+		}
+		read_size = (size_t) random_number % QCOW_TEST_FILE_READ_BUFFER_SIZE;
+
+		read_count = libqcow_file_read_buffer_at_offset(
+		              file,
+		              expected_buffer,
+		              read_size,
+		              read_offset,
+		              &error );
+
+		QCOW_TEST_ASSERT_NOT_EQUAL_SSIZE(
+		 "read_count",
+		 read_count,
+		 (ssize_t) -1 );
+
+		QCOW_TEST_ASSERT_IS_NULL(
+		 "error",
+		 error );
+
+		expected_offset = read_offset + read_count;
+
+		read_count = libqcow_file_read_buffer_at_offset_concurrent(
+		              file,
+		              buffer,
+		              read_size,
+		              read_offset,
+		              &error );
+
+		remaining_media_size = media_size - read_offset;
+
+		if( read_size > remaining_media_size )
+		{
+			read_size = (size_t) remaining_media_size;
+		}
+		QCOW_TEST_ASSERT_EQUAL_SSIZE(
+		 "read_count",
+		 read_count,
+		 (ssize_t) read_size );
+
+		QCOW_TEST_ASSERT_IS_NULL(
+		 "error",
+		 error );
+
+		result = memory_compare(
+		          buffer,
+		          expected_buffer,
+		          read_size );
+
+		QCOW_TEST_ASSERT_EQUAL_INT(
+		 "result",
+		 result,
+		 0 );
+
+		/* The current offset is not changed
+		 */
+		result = libqcow_file_get_offset(
+		          file,
+		          &offset,
+		          &error );
+
+		QCOW_TEST_ASSERT_EQUAL_INT(
+		 "result",
+		 result,
+		 1 );
+
+		QCOW_TEST_ASSERT_EQUAL_INT64(
+		 "offset",
+		 offset,
+		 expected_offset );
+
+		QCOW_TEST_ASSERT_IS_NULL(
+		 "error",
+		 error );
+	}
+	/* Read buffer beyond media_size boundary
+	 */
+	read_count = libqcow_file_read_buffer_at_offset_concurrent(
+	              file,
+	              buffer,
+	              QCOW_TEST_FILE_READ_BUFFER_SIZE,
+	              media_size + 8,
+	              &error );
+
+	QCOW_TEST_ASSERT_EQUAL_SSIZE(
+	 "read_count",
+	 read_count,
+	 (ssize_t) 0 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test error cases
+	 */
+	read_count = libqcow_file_read_buffer_at_offset_concurrent(
+	              NULL,
+	              buffer,
+	              QCOW_TEST_FILE_READ_BUFFER_SIZE,
+	              0,
+	              &error );
+
+	QCOW_TEST_ASSERT_EQUAL_SSIZE(
+	 "read_count",
+	 read_count,
+	 (ssize_t) -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	read_count = libqcow_file_read_buffer_at_offset_concurrent(
+	              file,
+	              NULL,
+	              QCOW_TEST_FILE_READ_BUFFER_SIZE,
+	              0,
+	              &error );
+
+	QCOW_TEST_ASSERT_EQUAL_SSIZE(
+	 "read_count",
+	 read_count,
+	 (ssize_t) -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	read_count = libqcow_file_read_buffer_at_offset_concurrent(
+	              file,
+	              buffer,
+	              (size_t) SSIZE_MAX + 1,
+	              0,
+	              &error );
+
+	QCOW_TEST_ASSERT_EQUAL_SSIZE(
+	 "read_count",
+	 read_count,
+	 (ssize_t) -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	read_count = libqcow_file_read_buffer_at_offset_concurrent(
+	              file,
+	              buffer,
+	              QCOW_TEST_FILE_READ_BUFFER_SIZE,
+	              -1,
+	              &error );
+
+	QCOW_TEST_ASSERT_EQUAL_SSIZE(
+	 "read_count",
+	 read_count,
+	 (ssize_t) -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	return( 0 );
+}
+
+#if defined( HAVE_QCOW_TEST_FILE_THREADS )
+
+/* Reads the read ranges of a thread using libqcow_file_read_buffer_at_offset_concurrent
+ * The thread reads every read range of which the index modulo the number of threads
+ * matches the index of the thread
+ * Returns NULL
+ */
+void *qcow_test_file_read_ranges_thread(
+       void *arguments )
+{
+	qcow_test_file_read_range_t *read_range           = NULL;
+	qcow_test_file_read_thread_values_t *thread_values = NULL;
+	libcerror_error_t *error                           = NULL;
+	uint8_t *data                                      = NULL;
+	ssize_t read_count                                 = 0;
+	int range_index                                    = 0;
+
+	thread_values = (qcow_test_file_read_thread_values_t *) arguments;
+
+	data = (uint8_t *) memory_allocate(
+	                    sizeof( uint8_t ) * QCOW_TEST_FILE_MAXIMUM_READ_RANGE_SIZE );
+
+	if( data == NULL )
+	{
+		thread_values->has_mismatch = 1;
+
+		return( NULL );
+	}
+	for( range_index = thread_values->thread_index;
+	     range_index < QCOW_TEST_FILE_NUMBER_OF_READ_RANGES;
+	     range_index += QCOW_TEST_FILE_NUMBER_OF_READ_THREADS )
+	{
+		read_range = &( thread_values->read_ranges[ range_index ] );
+
+		read_count = libqcow_file_read_buffer_at_offset_concurrent(
+		              thread_values->file,
+		              data,
+		              read_range->size,
+		              read_range->offset,
+		              &error );
+
+		if( read_count != read_range->expected_read_count )
+		{
+			thread_values->has_mismatch = 1;
+
+			break;
+		}
+		if( memory_compare(
+		     data,
+		     read_range->expected_data,
+		     (size_t) read_count ) != 0 )
+		{
+			thread_values->has_mismatch = 1;
+
+			break;
+		}
+	}
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	memory_free(
+	 data );
+
+	return( NULL );
+}
+
+/* Tests the libqcow_file_read_buffer_at_offset_concurrent function from multiple threads
+ * The threads read random ranges at the same time, of which the data is
+ * compared with the data read sequentially
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_file_read_buffer_at_offset_concurrent_threaded(
+     libqcow_file_t *file )
+{
+	pthread_t threads[ QCOW_TEST_FILE_NUMBER_OF_READ_THREADS ];
+	qcow_test_file_read_thread_values_t thread_values[ QCOW_TEST_FILE_NUMBER_OF_READ_THREADS ];
+
+	qcow_test_file_read_range_t *read_ranges = NULL;
+	libcerror_error_t *error                 = NULL;
+	size64_t media_size                      = 0;
+	off64_t expected_offset                  = 0;
+	off64_t offset                           = 0;
+	int number_of_threads                    = 0;
+	int range_index                          = 0;
+	int result                               = 0;
+	int thread_index                         = 0;
+
+	/* Initialize test
+	 */
+	result = libqcow_file_get_media_size(
+	          file,
+	          &media_size,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	read_ranges = (qcow_test_file_read_range_t *) memory_allocate(
+	                                               sizeof( qcow_test_file_read_range_t ) * QCOW_TEST_FILE_NUMBER_OF_READ_RANGES );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "read_ranges",
+	 read_ranges );
+
+	result = ( memory_set(
+	            read_ranges,
+	            0,
+	            sizeof( qcow_test_file_read_range_t ) * QCOW_TEST_FILE_NUMBER_OF_READ_RANGES ) != NULL );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	/* Read the random ranges sequentially to determine the expected data
+	 */
+	for( range_index = 0;
+	     range_index < QCOW_TEST_FILE_NUMBER_OF_READ_RANGES;
+	     range_index++ )
+	{
+		if( media_size > 0 )
+		{
+			read_ranges[ range_index ].offset = (off64_t) ( (size64_t) rand() % media_size );
+		}
+		read_ranges[ range_index ].size = 1 + ( (size_t) rand() % ( QCOW_TEST_FILE_MAXIMUM_READ_RANGE_SIZE - 1 ) );
+
+		read_ranges[ range_index ].expected_data = (uint8_t *) memory_allocate(
+		                                                        sizeof( uint8_t ) * read_ranges[ range_index ].size );
+
+		QCOW_TEST_ASSERT_IS_NOT_NULL(
+		 "read_ranges[ range_index ].expected_data",
+		 read_ranges[ range_index ].expected_data );
+
+		read_ranges[ range_index ].expected_read_count = libqcow_file_read_buffer_at_offset(
+		                                                  file,
+		                                                  read_ranges[ range_index ].expected_data,
+		                                                  read_ranges[ range_index ].size,
+		                                                  read_ranges[ range_index ].offset,
+		                                                  &error );
+
+		QCOW_TEST_ASSERT_NOT_EQUAL_SSIZE(
+		 "read_ranges[ range_index ].expected_read_count",
+		 read_ranges[ range_index ].expected_read_count,
+		 (ssize_t) -1 );
+
+		QCOW_TEST_ASSERT_IS_NULL(
+		 "error",
+		 error );
+	}
+	result = libqcow_file_get_offset(
+	          file,
+	          &expected_offset,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test regular cases
+	 */
+	for( thread_index = 0;
+	     thread_index < QCOW_TEST_FILE_NUMBER_OF_READ_THREADS;
+	     thread_index++ )
+	{
+		thread_values[ thread_index ].file         = file;
+		thread_values[ thread_index ].read_ranges  = read_ranges;
+		thread_values[ thread_index ].thread_index = thread_index;
+		thread_values[ thread_index ].has_mismatch = 0;
+
+		result = pthread_create(
+		          &( threads[ thread_index ] ),
+		          NULL,
+		          &qcow_test_file_read_ranges_thread,
+		          &( thread_values[ thread_index ] ) );
+
+		QCOW_TEST_ASSERT_EQUAL_INT(
+		 "result",
+		 result,
+		 0 );
+
+		number_of_threads++;
+	}
+	while( number_of_threads > 0 )
+	{
+		number_of_threads--;
+
+		result = pthread_join(
+		          threads[ number_of_threads ],
+		          NULL );
+
+		QCOW_TEST_ASSERT_EQUAL_INT(
+		 "result",
+		 result,
+		 0 );
+
+		QCOW_TEST_ASSERT_EQUAL_UINT8(
+		 "thread_values[ number_of_threads ].has_mismatch",
+		 thread_values[ number_of_threads ].has_mismatch,
+		 (uint8_t) 0 );
+	}
+	/* The current offset is not changed
+	 */
+	result = libqcow_file_get_offset(
+	          file,
+	          &offset,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_EQUAL_INT64(
+	 "offset",
+	 offset,
+	 expected_offset );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Clean up
+	 */
+	for( range_index = 0;
+	     range_index < QCOW_TEST_FILE_NUMBER_OF_READ_RANGES;
+	     range_index++ )
+	{
+		memory_free(
+		 read_ranges[ range_index ].expected_data );
+	}
+	memory_free(
+	 read_ranges );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	while( number_of_threads > 0 )
+	{
+		number_of_threads--;
+
+		pthread_join(
+		 threads[ number_of_threads ],
+		 NULL );
+	}
+	if( read_ranges != NULL )
+	{
+		for( range_index = 0;
+		     range_index < QCOW_TEST_FILE_NUMBER_OF_READ_RANGES;
+		     range_index++ )
+		{
+			if( read_ranges[ range_index ].expected_data != NULL )
+			{
+				memory_free(
+				 read_ranges[ range_index ].expected_data );
+			}
+		}
+		memory_free(
+		 read_ranges );
+	}
+	return( 0 );
+}
+
+#endif /* defined( HAVE_QCOW_TEST_FILE_THREADS ) */
+
+/* Tests the libqcow_file_read_buffer_at_offset_with_timeout function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_file_read_buffer_at_offset_with_timeout(
+     libqcow_file_t *file )
+{
+	uint8_t buffer[ QCOW_TEST_FILE_READ_BUFFER_SIZE ];
+	uint8_t expected_buffer[ QCOW_TEST_FILE_READ_BUFFER_SIZE ];
+
+	libcerror_error_t *error = NULL;
+	size64_t media_size      = 0;
+	size_t read_size         = 0;
+	ssize_t read_count       = 0;
+	int result               = 0;
+
+	/* Determine size
+	 */
+	result = libqcow_file_get_media_size(
+	          file,
+	          &media_size,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	read_size = QCOW_TEST_FILE_READ_BUFFER_SIZE;
+
+	if( media_size < (size64_t) read_size )
+	{
+		read_size = (size_t) media_size;
+	}
+	/* Test regular cases
+	 */
+	read_count = libqcow_file_read_buffer_at_offset(
+	              file,
+	              expected_buffer,
+	              read_size,
+	              0,
+	              &error );
+
+	QCOW_TEST_ASSERT_EQUAL_SSIZE(
+	 "read_count",
+	 read_count,
+	 (ssize_t) read_size );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	read_count = libqcow_file_read_buffer_at_offset_with_timeout(
+	              file,
+	              buffer,
+	              read_size,
+	              0,
+	              60000,
+	              &error );
+
+	QCOW_TEST_ASSERT_EQUAL_SSIZE(
+	 "read_count",
+	 read_count,
+	 (ssize_t) read_size );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = memory_compare(
+	          buffer,
+	          expected_buffer,
+	          read_size );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
+
+	/* The abort only applies to reads in progress, a read started afterwards succeeds
+	 */
+	result = libqcow_file_signal_abort(
+	          file,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	read_count = libqcow_file_read_buffer_at_offset_with_timeout(
+	              file,
+	              buffer,
+	              read_size,
+	              0,
+	              60000,
+	              &error );
+
+	QCOW_TEST_ASSERT_EQUAL_SSIZE(
+	 "read_count",
+	 read_count,
+	 (ssize_t) read_size );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = memory_compare(
+	          buffer,
+	          expected_buffer,
+	          read_size );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
+
+	read_count = libqcow_file_read_buffer_at_offset(
+	              file,
+	              buffer,
+	              read_size,
+	              0,
+	              &error );
+
+	QCOW_TEST_ASSERT_EQUAL_SSIZE(
+	 "read_count",
+	 read_count,
+	 (ssize_t) read_size );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test error cases
+	 */
+	read_count = libqcow_file_read_buffer_at_offset_with_timeout(
+	              NULL,
+	              buffer,
+	              QCOW_TEST_FILE_READ_BUFFER_SIZE,
+	              0,
+	              60000,
+	              &error );
+
+	QCOW_TEST_ASSERT_EQUAL_SSIZE(
+	 "read_count",
+	 read_count,
+	 (ssize_t) -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	return( 0 );
+}
+
+#if defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT )
+
+/* Tests the libqcow_internal_file_read_is_stopped function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_internal_file_read_is_stopped(
+     libqcow_file_t *file )
+{
+	libcerror_error_t *error            = NULL;
+	libqcow_read_control_t read_control;
+	uint32_t abort_generation           = 0;
+	int result                          = 0;
+
+	if( memory_set(
+	     &read_control,
+	     0,
+	     sizeof( libqcow_read_control_t ) ) == NULL )
+	{
+		return( 0 );
+	}
+	abort_generation = ( (libqcow_internal_file_t *) file )->abort_generation;
+
+	/* Test regular cases
+	 */
+	result = libqcow_internal_file_read_is_stopped(
+	          (libqcow_internal_file_t *) file,
+	          NULL,
+	          abort_generation,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_internal_file_read_is_stopped(
+	          (libqcow_internal_file_t *) file,
+	          &read_control,
+	          abort_generation,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* A read is stopped when the file was signalled to abort after it started
+	 */
+	result = libqcow_internal_file_read_is_stopped(
+	          (libqcow_internal_file_t *) file,
+	          &read_control,
+	          abort_generation - 1,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	read_control.cancelled = 1;
+
+	result = libqcow_internal_file_read_is_stopped(
+	          (libqcow_internal_file_t *) file,
+	          &read_control,
+	          abort_generation,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test error cases
+	 */
+	result = libqcow_internal_file_read_is_stopped(
+	          NULL,
+	          &read_control,
+	          abort_generation,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	return( 0 );
+}
+
+/* Tests the libqcow_internal_file_read_buffer_at_offset function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_internal_file_read_buffer_at_offset(
+     libqcow_file_t *file )
+{
+	uint8_t buffer[ QCOW_TEST_FILE_READ_BUFFER_SIZE ];
+
+	libcerror_error_t *error            = NULL;
+	libqcow_read_control_t read_control;
+	size64_t media_size                 = 0;
+	ssize_t read_count                  = 0;
+	uint32_t abort_generation           = 0;
+	int result                          = 0;
+
+	if( memory_set(
+	     &read_control,
+	     0,
+	     sizeof( libqcow_read_control_t ) ) == NULL )
+	{
+		return( 0 );
+	}
+	result = libqcow_file_get_media_size(
+	          file,
+	          &media_size,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	if( media_size == 0 )
+	{
+		return( 1 );
+	}
+	abort_generation = ( (libqcow_internal_file_t *) file )->abort_generation;
+
+	/* Test a read that has passed its deadline
+	 */
+	read_control.deadline = 1;
+
+	read_count = libqcow_internal_file_read_buffer_at_offset(
+	              (libqcow_internal_file_t *) file,
+	              buffer,
+	              QCOW_TEST_FILE_READ_BUFFER_SIZE,
+	              0,
+	              &read_control,
+	              abort_generation,
+	              &error );
+
+	QCOW_TEST_ASSERT_EQUAL_SSIZE(
+	 "read_count",
+	 read_count,
+	 (ssize_t) -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	/* Test a read that was cancelled
+	 */
+	read_control.deadline  = 0;
+	read_control.cancelled = 1;
+
+	read_count = libqcow_internal_file_read_buffer_at_offset(
+	              (libqcow_internal_file_t *) file,
+	              buffer,
+	              QCOW_TEST_FILE_READ_BUFFER_SIZE,
+	              0,
+	              &read_control,
+	              abort_generation,
+	              &error );
+
+	QCOW_TEST_ASSERT_EQUAL_SSIZE(
+	 "read_count",
+	 read_count,
+	 (ssize_t) -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	/* Test a read that was started before the file was signalled to abort
+	 */
+	read_count = libqcow_internal_file_read_buffer_at_offset(
+	              (libqcow_internal_file_t *) file,
+	              buffer,
+	              QCOW_TEST_FILE_READ_BUFFER_SIZE,
+	              0,
+	              NULL,
+	              abort_generation - 1,
+	              &error );
+
+	QCOW_TEST_ASSERT_EQUAL_SSIZE(
+	 "read_count",
+	 read_count,
+	 (ssize_t) -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	/* A stopped read beyond the media size returns 0
+	 */
+	read_count = libqcow_internal_file_read_buffer_at_offset(
+	              (libqcow_internal_file_t *) file,
+	              buffer,
+	              QCOW_TEST_FILE_READ_BUFFER_SIZE,
+	              (off64_t) media_size,
+	              &read_control,
+	              abort_generation,
+	              &error );
+
+	QCOW_TEST_ASSERT_EQUAL_SSIZE(
+	 "read_count",
+	 read_count,
+	 (ssize_t) 0 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	return( 0 );
+}
+
+#endif /* defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT ) */
+
+/* Tests the libqcow_file_get_data_at_offset function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_file_get_data_at_offset(
+     libqcow_file_t *file )
+{
+	uint8_t buffer[ QCOW_TEST_FILE_READ_BUFFER_SIZE ];
+
+	libcerror_error_t *error       = NULL;
+	libqcow_data_pin_t *data_pin   = NULL;
+	const uint8_t *data            = NULL;
+	size64_t media_size            = 0;
+	size_t data_size               = 0;
+	size_t read_size               = 0;
+	ssize_t read_count             = 0;
+	int result                     = 0;
+
+	/* Determine size
+	 */
+	result = libqcow_file_get_media_size(
+	          file,
+	          &media_size,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test regular cases
+	 */
+	if( media_size > 0 )
+	{
+		result = libqcow_file_get_data_at_offset(
+		          file,
+		          0,
+		          &data,
+		          &data_size,
+		          &data_pin,
+		          &error );
+
+		QCOW_TEST_ASSERT_EQUAL_INT(
+		 "result",
+		 result,
+		 1 );
+
+		QCOW_TEST_ASSERT_IS_NOT_NULL(
+		 "data",
+		 data );
+
+		QCOW_TEST_ASSERT_IS_NOT_NULL(
+		 "data_pin",
+		 data_pin );
+
+		QCOW_TEST_ASSERT_IS_NULL(
+		 "error",
+		 error );
+
+		QCOW_TEST_ASSERT_NOT_EQUAL_INT(
+		 "data_size",
+		 (int) data_size,
+		 0 );
+
+		read_size = data_size;
+
+		if( read_size > QCOW_TEST_FILE_READ_BUFFER_SIZE )
+		{
+			read_size = QCOW_TEST_FILE_READ_BUFFER_SIZE;
+		}
+		read_count = libqcow_file_read_buffer_at_offset(
+		              file,
+		              buffer,
+		              read_size,
+		              0,
+		              &error );
+
+		QCOW_TEST_ASSERT_EQUAL_SSIZE(
+		 "read_count",
+		 read_count,
+		 (ssize_t) read_size );
+
+		QCOW_TEST_ASSERT_IS_NULL(
+		 "error",
+		 error );
+
+		result = memory_compare(
+		          data,
+		          buffer,
+		          read_size );
+
+		QCOW_TEST_ASSERT_EQUAL_INT(
+		 "result",
+		 result,
+		 0 );
+
+		result = libqcow_data_pin_free(
+		          &data_pin,
+		          &error );
+
+		QCOW_TEST_ASSERT_EQUAL_INT(
+		 "result",
+		 result,
+		 1 );
+
+		QCOW_TEST_ASSERT_IS_NULL(
+		 "data_pin",
+		 data_pin );
+
+		QCOW_TEST_ASSERT_IS_NULL(
+		 "error",
+		 error );
+	}
+	if( media_size > 8 )
+	{
+		/* Get data on media_size boundary
+		 */
+		result = libqcow_file_get_data_at_offset(
+		          file,
+		          media_size - 8,
+		          &data,
+		          &data_size,
+		          &data_pin,
+		          &error );
+
+		QCOW_TEST_ASSERT_EQUAL_INT(
+		 "result",
+		 result,
+		 1 );
+
+		QCOW_TEST_ASSERT_IS_NULL(
+		 "error",
+		 error );
+
+		QCOW_TEST_ASSERT_EQUAL_SIZE(
+		 "data_size",
+		 data_size,
+		 (size_t) 8 );
+
+		result = libqcow_data_pin_free(
+		          &data_pin,
+		          &error );
+
+		QCOW_TEST_ASSERT_EQUAL_INT(
+		 "result",
+		 result,
+		 1 );
+
+		QCOW_TEST_ASSERT_IS_NULL(
+		 "error",
+		 error );
+
+		/* Get data beyond media_size boundary
+		 */
+		result = libqcow_file_get_data_at_offset(
+		          file,
+		          media_size + 8,
+		          &data,
+		          &data_size,
+		          &data_pin,
+		          &error );
+
+		QCOW_TEST_ASSERT_EQUAL_INT(
+		 "result",
+		 result,
+		 0 );
+
+		QCOW_TEST_ASSERT_IS_NULL(
+		 "data_pin",
+		 data_pin );
+
+		QCOW_TEST_ASSERT_IS_NULL(
+		 "error",
+		 error );
+	}
+	/* Test error cases
+	 */
+	result = libqcow_file_get_data_at_offset(
+	          NULL,
+	          0,
+	          &data,
+	          &data_size,
+	          &data_pin,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_file_get_data_at_offset(
+	          file,
+	          -1,
+	          &data,
+	          &data_size,
+	          &data_pin,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_file_get_data_at_offset(
+	          file,
+	          0,
+	          NULL,
+	          &data_size,
+	          &data_pin,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_file_get_data_at_offset(
+	          file,
+	          0,
+	          &data,
+	          NULL,
+	          &data_pin,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_file_get_data_at_offset(
+	          file,
+	          0,
+	          &data,
+	          &data_size,
+	          NULL,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_data_pin_free(
+	          NULL,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	if( data_pin != NULL )
+	{
+		libqcow_data_pin_free(
+		 &data_pin,
+		 NULL );
+	}
+	return( 0 );
+}
+
+/* Tests the libqcow_file_seek_offset function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_file_seek_offset(
+     libqcow_file_t *file )
+{
+	libcerror_error_t *error = NULL;
+	size64_t size            = 0;
+	off64_t offset           = 0;
+
+	/* Test regular cases
+	 */
+	offset = libqcow_file_seek_offset(
+	          file,
+	          0,
+	          SEEK_END,
+	          &error );
+
+	QCOW_TEST_ASSERT_NOT_EQUAL_INT64(
+	 "offset",
+	 offset,
+	 (int64_t) -1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	size = (size64_t) offset;
+
+	offset = libqcow_file_seek_offset(
+	          file,
+	          1024,
+	          SEEK_SET,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT64(
+	 "offset",
+	 offset,
+	 (int64_t) 1024 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	offset = libqcow_file_seek_offset(
+	          file,
+	          -512,
+	          SEEK_CUR,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT64(
+	 "offset",
+	 offset,
+	 (int64_t) 512 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	offset = libqcow_file_seek_offset(
+	          file,
+	          (off64_t) ( size + 512 ),
+	          SEEK_SET,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT64(
+	 "offset",
+	 offset,
+	 (int64_t) ( size + 512 ) );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Reset offset to 0
+	 */
+	offset = libqcow_file_seek_offset(
+	          file,
+	          0,
+	          SEEK_SET,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT64(
+	 "offset",
+	 offset,
+	 (int64_t) 0 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test error cases
+	 */
+	offset = libqcow_file_seek_offset(
+	          NULL,
+	          0,
+	          SEEK_SET,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT64(
+	 "offset",
+	 offset,
+	 (int64_t) -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	offset = libqcow_file_seek_offset(
+	          file,
+	          -1,
+	          SEEK_SET,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT64(
+	 "offset",
+	 offset,
+	 (int64_t) -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	offset = libqcow_file_seek_offset(
+	          file,
+	          -1,
+	          SEEK_CUR,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT64(
+	 "offset",
+	 offset,
+	 (int64_t) -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	offset = libqcow_file_seek_offset(
+	          file,
+	          (off64_t) ( -1 * ( size + 1 ) ),
+	          SEEK_END,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT64(
+	 "offset",
+	 offset,
+	 (int64_t) -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+#if defined( HAVE_QCOW_TEST_RWLOCK_HOOK )
+
+	/* Test libqcow_file_seek_offset with pthread_rwlock_wrlock failing in libcthreads_read_write_lock_grab_for_write
+	 */
+	qcow_test_pthread_rwlock_wrlock_attempts_before_fail = 0;
+
+	offset = libqcow_file_seek_offset(
+	          file,
+	          0,
+	          SEEK_SET,
+	          &error );
 
 	if( qcow_test_pthread_rwlock_wrlock_attempts_before_fail != -1 )
 	{
-		qcow_test_pthread_rwlock_wrlock_attempts_before_fail = -1;
+		qcow_test_pthread_rwlock_wrlock_attempts_before_fail = -1;
+	}
+	else
+	{
+		QCOW_TEST_ASSERT_EQUAL_INT64(
+		 "offset",
+		 (int64_t) offset,
+		 (int64_t) -1 );
+
+		QCOW_TEST_ASSERT_IS_NOT_NULL(
+		 "error",
+		 error );
+
+		libcerror_error_free(
+		 &error );
+	}
+#if defined( HAVE_PTHREAD_RWLOCK_UNLOCK_HOOK )
+
+	/* Test libqcow_file_seek_offset with pthread_rwlock_unlock failing in libcthreads_read_write_lock_release_for_write
+	 */
+	qcow_test_pthread_rwlock_unlock_attempts_before_fail = 0;
+
+	offset = libqcow_file_seek_offset(
+	          file,
+	          0,
+	          SEEK_SET,
+	          &error );
+
+	if( qcow_test_pthread_rwlock_unlock_attempts_before_fail != -1 )
+	{
+		qcow_test_pthread_rwlock_unlock_attempts_before_fail = -1;
+	}
+	else
+	{
+		QCOW_TEST_ASSERT_EQUAL_INT64(
+		 "offset",
+		 (int64_t) offset,
+		 (int64_t) -1 );
+
+		QCOW_TEST_ASSERT_IS_NOT_NULL(
+		 "error",
+		 error );
+
+		libcerror_error_free(
+		 &error );
+	}
+#endif /* defined( HAVE_PTHREAD_RWLOCK_UNLOCK_HOOK ) */
+#endif /* defined( HAVE_QCOW_TEST_RWLOCK_HOOK ) */
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	return( 0 );
+}
+
+/* Tests the libqcow_file_get_offset function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_file_get_offset(
+     libqcow_file_t *file )
+{
+	libcerror_error_t *error = NULL;
+	off64_t offset           = 0;
+	int result               = 0;
+
+	/* Test regular cases
+	 */
+	result = libqcow_file_get_offset(
+	          file,
+	          &offset,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test error cases
+	 */
+	result = libqcow_file_get_offset(
+	          NULL,
+	          &offset,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_file_get_offset(
+	          file,
+	          NULL,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+#if defined( HAVE_QCOW_TEST_RWLOCK_HOOK )
+
+	/* Test libqcow_file_get_offset with pthread_rwlock_rdlock failing in libcthreads_read_write_lock_grab_for_read
+	 */
+	qcow_test_pthread_rwlock_rdlock_attempts_before_fail = 0;
+
+	result = libqcow_file_get_offset(
+	          file,
+	          &offset,
+	          &error );
+
+	if( qcow_test_pthread_rwlock_rdlock_attempts_before_fail != -1 )
+	{
+		qcow_test_pthread_rwlock_rdlock_attempts_before_fail = -1;
+	}
+	else
+	{
+		QCOW_TEST_ASSERT_EQUAL_INT(
+		 "result",
+		 result,
+		 -1 );
+
+		QCOW_TEST_ASSERT_IS_NOT_NULL(
+		 "error",
+		 error );
+
+		libcerror_error_free(
+		 &error );
+	}
+#if defined( HAVE_PTHREAD_RWLOCK_UNLOCK_HOOK )
+
+	/* Test libqcow_file_get_offset with pthread_rwlock_unlock failing in libcthreads_read_write_lock_release_for_read
+	 */
+	qcow_test_pthread_rwlock_unlock_attempts_before_fail = 0;
+
+	result = libqcow_file_get_offset(
+	          file,
+	          &offset,
+	          &error );
+
+	if( qcow_test_pthread_rwlock_unlock_attempts_before_fail != -1 )
+	{
+		qcow_test_pthread_rwlock_unlock_attempts_before_fail = -1;
+	}
+	else
+	{
+		QCOW_TEST_ASSERT_EQUAL_INT(
+		 "result",
+		 result,
+		 -1 );
+
+		QCOW_TEST_ASSERT_IS_NOT_NULL(
+		 "error",
+		 error );
+
+		libcerror_error_free(
+		 &error );
+	}
+#endif /* defined( HAVE_PTHREAD_RWLOCK_UNLOCK_HOOK ) */
+#endif /* defined( HAVE_QCOW_TEST_RWLOCK_HOOK ) */
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	return( 0 );
+}
+
+#if defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT )
+
+/* Tests the libqcow_internal_file_read_mapped_buffer_at_offset function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_internal_file_read_mapped_buffer_at_offset(
+     libqcow_file_t *file )
+{
+	uint8_t buffer[ QCOW_TEST_FILE_READ_BUFFER_SIZE ];
+	uint8_t mapped_buffer[ QCOW_TEST_FILE_READ_BUFFER_SIZE ];
+
+	libcerror_error_t *error  = NULL;
+	size64_t media_size       = 0;
+	size_t read_size          = 0;
+	ssize_t mapped_read_count = 0;
+	ssize_t read_count        = 0;
+	off64_t file_offset       = 0;
+	off64_t offset            = 0;
+	int result                = 0;
+
+	/* Determine size and offset
+	 */
+	result = libqcow_file_get_media_size(
+	          file,
+	          &media_size,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_file_get_offset(
+	          file,
+	          &file_offset,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test regular cases
+	 */
+	for( offset = 0;
+	     offset < (off64_t) media_size;
+	     offset += (off64_t) ( media_size / 4 ) + 1 )
+	{
+		read_size = QCOW_TEST_FILE_READ_BUFFER_SIZE;
+
+		if( (size64_t) read_size > ( media_size - offset ) )
+		{
+			read_size = (size_t) ( media_size - offset );
+		}
+		mapped_read_count = libqcow_internal_file_read_mapped_buffer_at_offset(
+		                     (libqcow_internal_file_t *) file,
+		                     mapped_buffer,
+		                     read_size,
+		                     offset,
+		                     &error );
+
+		QCOW_TEST_ASSERT_GREATER_THAN_INT(
+		 "mapped_read_count",
+		 (int) mapped_read_count,
+		 -1 );
+
+		QCOW_TEST_ASSERT_IS_NULL(
+		 "error",
+		 error );
+
+		QCOW_TEST_ASSERT_LESS_THAN_INT(
+		 "mapped_read_count",
+		 (int) mapped_read_count,
+		 (int) read_size + 1 );
+
+		if( mapped_read_count > 0 )
+		{
+			read_count = libqcow_file_read_buffer_at_offset(
+			              file,
+			              buffer,
+			              (size_t) mapped_read_count,
+			              offset,
+			              &error );
+
+			QCOW_TEST_ASSERT_EQUAL_SSIZE(
+			 "read_count",
+			 read_count,
+			 mapped_read_count );
+
+			QCOW_TEST_ASSERT_IS_NULL(
+			 "error",
+			 error );
+
+			result = memory_compare(
+			          buffer,
+			          mapped_buffer,
+			          (size_t) mapped_read_count );
+
+			QCOW_TEST_ASSERT_EQUAL_INT(
+			 "result",
+			 result,
+			 0 );
+		}
+	}
+	/* Test error cases
+	 */
+	mapped_read_count = libqcow_internal_file_read_mapped_buffer_at_offset(
+	                     NULL,
+	                     mapped_buffer,
+	                     QCOW_TEST_FILE_READ_BUFFER_SIZE,
+	                     0,
+	                     &error );
+
+	QCOW_TEST_ASSERT_EQUAL_SSIZE(
+	 "mapped_read_count",
+	 mapped_read_count,
+	 (ssize_t) -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	mapped_read_count = libqcow_internal_file_read_mapped_buffer_at_offset(
+	                     (libqcow_internal_file_t *) file,
+	                     NULL,
+	                     QCOW_TEST_FILE_READ_BUFFER_SIZE,
+	                     0,
+	                     &error );
+
+	QCOW_TEST_ASSERT_EQUAL_SSIZE(
+	 "mapped_read_count",
+	 mapped_read_count,
+	 (ssize_t) -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	mapped_read_count = libqcow_internal_file_read_mapped_buffer_at_offset(
+	                     (libqcow_internal_file_t *) file,
+	                     mapped_buffer,
+	                     (size_t) SSIZE_MAX + 1,
+	                     0,
+	                     &error );
+
+	QCOW_TEST_ASSERT_EQUAL_SSIZE(
+	 "mapped_read_count",
+	 mapped_read_count,
+	 (ssize_t) -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	mapped_read_count = libqcow_internal_file_read_mapped_buffer_at_offset(
+	                     (libqcow_internal_file_t *) file,
+	                     mapped_buffer,
+	                     QCOW_TEST_FILE_READ_BUFFER_SIZE,
+	                     -1,
+	                     &error );
+
+	QCOW_TEST_ASSERT_EQUAL_SSIZE(
+	 "mapped_read_count",
+	 mapped_read_count,
+	 (ssize_t) -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	/* Restore the offset
+	 */
+	offset = libqcow_file_seek_offset(
+	          file,
+	          file_offset,
+	          SEEK_SET,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT64(
+	 "offset",
+	 offset,
+	 file_offset );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	return( 0 );
+}
+
+#endif /* defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT ) */
+
+/* Tests the libqcow_file_create_cursor function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_file_create_cursor(
+     libqcow_file_t *file )
+{
+	uint8_t buffer[ 1000 ];
+
+	libcerror_error_t *error  = NULL;
+	libqcow_cursor_t *cursor  = NULL;
+	libqcow_cursor_t *cursor2 = NULL;
+	uint8_t *expected_data    = NULL;
+	size64_t media_size       = 0;
+	size_t read_size          = 0;
+	size_t test_size          = 0;
+	ssize_t read_count        = 0;
+	off64_t cursor2_offset    = 0;
+	off64_t file_offset       = 0;
+	off64_t offset            = 0;
+	int result                = 0;
+
+	result = libqcow_file_get_media_size(
+	          file,
+	          &media_size,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	test_size = 2 * 1024 * 1024;
+
+	if( media_size < (size64_t) test_size )
+	{
+		test_size = (size_t) media_size;
+	}
+	expected_data = (uint8_t *) memory_allocate(
+	                             sizeof( uint8_t ) * ( test_size + 1 ) );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "expected_data",
+	 expected_data );
+
+	read_count = libqcow_file_read_buffer_at_offset(
+	              file,
+	              expected_data,
+	              test_size,
+	              0,
+	              &error );
+
+	QCOW_TEST_ASSERT_EQUAL_SSIZE(
+	 "read_count",
+	 read_count,
+	 (ssize_t) test_size );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_file_get_offset(
+	          file,
+	          &file_offset,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test regular cases
+	 */
+	result = libqcow_file_create_cursor(
+	          file,
+	          &cursor,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "cursor",
+	 cursor );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_file_create_cursor(
+	          file,
+	          &cursor2,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "cursor2",
+	 cursor2 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	cursor2_offset = libqcow_cursor_seek_offset(
+	                  cursor2,
+	                  (off64_t) ( test_size / 2 ),
+	                  SEEK_SET,
+	                  &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT64(
+	 "cursor2_offset",
+	 (int64_t) cursor2_offset,
+	 (int64_t) ( test_size / 2 ) );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Interleave sequential reads of both cursors, the read size does not align
+	 * with the readahead size
+	 */
+	for( offset = 0;
+	     offset < (off64_t) ( test_size / 2 );
+	     offset += (off64_t) read_size )
+	{
+		read_size = 1000;
+
+		if( read_size > ( ( test_size / 2 ) - (size_t) offset ) )
+		{
+			read_size = ( test_size / 2 ) - (size_t) offset;
+		}
+		read_count = libqcow_cursor_read_buffer(
+		              cursor,
+		              buffer,
+		              read_size,
+		              &error );
+
+		QCOW_TEST_ASSERT_EQUAL_SSIZE(
+		 "read_count",
+		 read_count,
+		 (ssize_t) read_size );
+
+		QCOW_TEST_ASSERT_IS_NULL(
+		 "error",
+		 error );
+
+		result = memory_compare(
+		          buffer,
+		          &( expected_data[ offset ] ),
+		          read_size );
+
+		QCOW_TEST_ASSERT_EQUAL_INT(
+		 "result",
+		 result,
+		 0 );
+
+		read_count = libqcow_cursor_read_buffer(
+		              cursor2,
+		              buffer,
+		              read_size,
+		              &error );
+
+		QCOW_TEST_ASSERT_EQUAL_SSIZE(
+		 "read_count",
+		 read_count,
+		 (ssize_t) read_size );
+
+		QCOW_TEST_ASSERT_IS_NULL(
+		 "error",
+		 error );
+
+		result = memory_compare(
+		          buffer,
+		          &( expected_data[ cursor2_offset ] ),
+		          read_size );
+
+		QCOW_TEST_ASSERT_EQUAL_INT(
+		 "result",
+		 result,
+		 0 );
+
+		cursor2_offset += (off64_t) read_size;
+	}
+	/* Test a read that does not continue the previous read
+	 */
+	read_size = 512;
+
+	if( read_size > ( test_size - ( test_size / 3 ) ) )
+	{
+		read_size = test_size - ( test_size / 3 );
+	}
+	read_count = libqcow_cursor_read_buffer_at_offset(
+	              cursor,
+	              buffer,
+	              read_size,
+	              (off64_t) ( test_size / 3 ),
+	              &error );
+
+	QCOW_TEST_ASSERT_EQUAL_SSIZE(
+	 "read_count",
+	 read_count,
+	 (ssize_t) read_size );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = memory_compare(
+	          buffer,
+	          &( expected_data[ test_size / 3 ] ),
+	          (size_t) read_count );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
+
+	result = libqcow_cursor_get_offset(
+	          cursor,
+	          &offset,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_EQUAL_INT64(
+	 "offset",
+	 (int64_t) offset,
+	 (int64_t) ( ( test_size / 3 ) + read_count ) );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test a read beyond the media size
+	 */
+	read_count = libqcow_cursor_read_buffer_at_offset(
+	              cursor,
+	              buffer,
+	              512,
+	              (off64_t) media_size,
+	              &error );
+
+	QCOW_TEST_ASSERT_EQUAL_SSIZE(
+	 "read_count",
+	 read_count,
+	 (ssize_t) 0 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* The cursors do not change the current offset of the file
+	 */
+	result = libqcow_file_get_offset(
+	          file,
+	          &offset,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_EQUAL_INT64(
+	 "offset",
+	 (int64_t) offset,
+	 (int64_t) file_offset );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* The file cannot be closed while the cursors are in use
+	 */
+	result = libqcow_file_close(
+	          file,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	/* Test error cases
+	 */
+	read_count = libqcow_cursor_read_buffer(
+	              NULL,
+	              buffer,
+	              512,
+	              &error );
+
+	QCOW_TEST_ASSERT_EQUAL_SSIZE(
+	 "read_count",
+	 read_count,
+	 (ssize_t) -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	read_count = libqcow_cursor_read_buffer(
+	              cursor,
+	              NULL,
+	              512,
+	              &error );
+
+	QCOW_TEST_ASSERT_EQUAL_SSIZE(
+	 "read_count",
+	 read_count,
+	 (ssize_t) -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	offset = libqcow_cursor_seek_offset(
+	          cursor,
+	          0,
+	          -1,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT64(
+	 "offset",
+	 (int64_t) offset,
+	 (int64_t) -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	offset = libqcow_cursor_seek_offset(
+	          cursor,
+	          -1,
+	          SEEK_SET,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT64(
+	 "offset",
+	 (int64_t) offset,
+	 (int64_t) -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_cursor_get_offset(
+	          cursor,
+	          NULL,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_file_create_cursor(
+	          NULL,
+	          &cursor,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_file_create_cursor(
+	          file,
+	          NULL,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_file_create_cursor(
+	          file,
+	          &cursor,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	/* Clean up
+	 */
+	result = libqcow_cursor_free(
+	          &cursor2,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "cursor2",
+	 cursor2 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_cursor_free(
+	          &cursor,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "cursor",
+	 cursor );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	memory_free(
+	 expected_data );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
 	}
-	else
+	if( cursor2 != NULL )
+	{
+		libqcow_cursor_free(
+		 &cursor2,
+		 NULL );
+	}
+	if( cursor != NULL )
+	{
+		libqcow_cursor_free(
+		 &cursor,
+		 NULL );
+	}
+	if( expected_data != NULL )
+	{
+		memory_free(
+		 expected_data );
+	}
+	return( 0 );
+}
+
+/* Tests the libqcow_file_read_async function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_file_read_async(
+     libqcow_file_t *file )
+{
+	uint8_t buffer[ 16 ];
+
+	libqcow_read_request_t *read_requests[ QCOW_TEST_FILE_NUMBER_OF_READ_REQUESTS ];
+
+	libcerror_error_t *error             = NULL;
+	libqcow_read_request_t *read_request = NULL;
+	uint8_t *data                        = NULL;
+	uint8_t *expected_data               = NULL;
+	size64_t media_size                  = 0;
+	size_t read_size                     = 0;
+	size_t test_size                     = 0;
+	ssize_t read_count                   = 0;
+	off64_t file_offset                  = 0;
+	off64_t offset                       = 0;
+	int read_request_index               = 0;
+	int result                           = 0;
+
+	for( read_request_index = 0;
+	     read_request_index < QCOW_TEST_FILE_NUMBER_OF_READ_REQUESTS;
+	     read_request_index++ )
+	{
+		read_requests[ read_request_index ] = NULL;
+	}
+	result = libqcow_file_get_media_size(
+	          file,
+	          &media_size,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	test_size = 2 * 1024 * 1024;
+
+	if( media_size < (size64_t) test_size )
+	{
+		test_size = (size_t) media_size;
+	}
+	expected_data = (uint8_t *) memory_allocate(
+	                             sizeof( uint8_t ) * ( test_size + 1 ) );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "expected_data",
+	 expected_data );
+
+	data = (uint8_t *) memory_allocate(
+	                    sizeof( uint8_t ) * ( test_size + 1 ) );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "data",
+	 data );
+
+	read_count = libqcow_file_read_buffer_at_offset(
+	              file,
+	              expected_data,
+	              test_size,
+	              0,
+	              &error );
+
+	QCOW_TEST_ASSERT_EQUAL_SSIZE(
+	 "read_count",
+	 read_count,
+	 (ssize_t) test_size );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_file_get_offset(
+	          file,
+	          &file_offset,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test regular cases
+	 * Submit all read requests before waiting for any of them, the last read request
+	 * reads the remainder of the test data
+	 */
+	read_size = test_size / QCOW_TEST_FILE_NUMBER_OF_READ_REQUESTS;
+
+	for( read_request_index = 0;
+	     read_request_index < QCOW_TEST_FILE_NUMBER_OF_READ_REQUESTS;
+	     read_request_index++ )
+	{
+		offset = (off64_t) read_request_index * read_size;
+
+		if( read_request_index == ( QCOW_TEST_FILE_NUMBER_OF_READ_REQUESTS - 1 ) )
+		{
+			read_size = test_size - (size_t) offset;
+		}
+		result = libqcow_file_read_async(
+		          file,
+		          &( data[ offset ] ),
+		          read_size,
+		          offset,
+		          &( read_requests[ read_request_index ] ),
+		          &error );
+
+		QCOW_TEST_ASSERT_EQUAL_INT(
+		 "result",
+		 result,
+		 1 );
+
+		QCOW_TEST_ASSERT_IS_NOT_NULL(
+		 "read_requests[ read_request_index ]",
+		 read_requests[ read_request_index ] );
+
+		QCOW_TEST_ASSERT_IS_NULL(
+		 "error",
+		 error );
+	}
+	result = libqcow_read_request_is_complete(
+	          read_requests[ 0 ],
+	          &error );
+
+	QCOW_TEST_ASSERT_NOT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* The file cannot be closed while the read requests are in use
+	 */
+	result = libqcow_file_close(
+	          file,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	read_size = test_size / QCOW_TEST_FILE_NUMBER_OF_READ_REQUESTS;
+
+	for( read_request_index = QCOW_TEST_FILE_NUMBER_OF_READ_REQUESTS - 1;
+	     read_request_index >= 0;
+	     read_request_index-- )
+	{
+		offset = (off64_t) read_request_index * read_size;
+
+		result = libqcow_read_request_wait(
+		          read_requests[ read_request_index ],
+		          &read_count,
+		          &error );
+
+		QCOW_TEST_ASSERT_EQUAL_INT(
+		 "result",
+		 result,
+		 1 );
+
+		QCOW_TEST_ASSERT_IS_NULL(
+		 "error",
+		 error );
+
+		if( read_request_index == ( QCOW_TEST_FILE_NUMBER_OF_READ_REQUESTS - 1 ) )
+		{
+			QCOW_TEST_ASSERT_EQUAL_SSIZE(
+			 "read_count",
+			 read_count,
+			 (ssize_t) ( test_size - (size_t) offset ) );
+		}
+		else
+		{
+			QCOW_TEST_ASSERT_EQUAL_SSIZE(
+			 "read_count",
+			 read_count,
+			 (ssize_t) read_size );
+		}
+		result = libqcow_read_request_is_complete(
+		          read_requests[ read_request_index ],
+		          &error );
+
+		QCOW_TEST_ASSERT_EQUAL_INT(
+		 "result",
+		 result,
+		 1 );
+
+		QCOW_TEST_ASSERT_IS_NULL(
+		 "error",
+		 error );
+
+		result = libqcow_read_request_free(
+		          &( read_requests[ read_request_index ] ),
+		          &error );
+
+		QCOW_TEST_ASSERT_EQUAL_INT(
+		 "result",
+		 result,
+		 1 );
+
+		QCOW_TEST_ASSERT_IS_NULL(
+		 "read_requests[ read_request_index ]",
+		 read_requests[ read_request_index ] );
+
+		QCOW_TEST_ASSERT_IS_NULL(
+		 "error",
+		 error );
+	}
+	result = memory_compare(
+	          data,
+	          expected_data,
+	          test_size );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
+
+	/* Test a single read request that is split into parts, that start and end
+	 * within a cluster block
+	 */
+	if( test_size > 2 )
 	{
+		result = libqcow_file_read_async(
+		          file,
+		          data,
+		          test_size - 2,
+		          1,
+		          &read_request,
+		          &error );
+
+		QCOW_TEST_ASSERT_EQUAL_INT(
+		 "result",
+		 result,
+		 1 );
+
+		QCOW_TEST_ASSERT_IS_NOT_NULL(
+		 "read_request",
+		 read_request );
+
+		QCOW_TEST_ASSERT_IS_NULL(
+		 "error",
+		 error );
+
+		result = libqcow_read_request_wait(
+		          read_request,
+		          &read_count,
+		          &error );
+
+		QCOW_TEST_ASSERT_EQUAL_INT(
+		 "result",
+		 result,
+		 1 );
+
 		QCOW_TEST_ASSERT_EQUAL_SSIZE(
 		 "read_count",
 		 read_count,
-		 (ssize_t) -1 );
+		 (ssize_t) ( test_size - 2 ) );
+
+		QCOW_TEST_ASSERT_IS_NULL(
+		 "error",
+		 error );
+
+		result = libqcow_read_request_free(
+		          &read_request,
+		          &error );
+
+		QCOW_TEST_ASSERT_EQUAL_INT(
+		 "result",
+		 result,
+		 1 );
+
+		QCOW_TEST_ASSERT_IS_NULL(
+		 "error",
+		 error );
+
+		result = memory_compare(
+		          data,
+		          &( expected_data[ 1 ] ),
+		          test_size - 2 );
+
+		QCOW_TEST_ASSERT_EQUAL_INT(
+		 "result",
+		 result,
+		 0 );
+	}
+	/* Test a read request of which the parts after the end of the media read no data
+	 */
+	result = libqcow_file_read_async(
+	          file,
+	          data,
+	          test_size,
+	          (off64_t) ( media_size - ( test_size / 2 ) ),
+	          &read_request,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "read_request",
+	 read_request );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_read_request_wait(
+	          read_request,
+	          &read_count,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_EQUAL_SSIZE(
+	 "read_count",
+	 read_count,
+	 (ssize_t) ( test_size / 2 ) );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_read_request_free(
+	          &read_request,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Read beyond the media size
+	 */
+	result = libqcow_file_read_async(
+	          file,
+	          buffer,
+	          16,
+	          (off64_t) media_size,
+	          &read_request,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "read_request",
+	 read_request );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_read_request_wait(
+	          read_request,
+	          &read_count,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_EQUAL_SSIZE(
+	 "read_count",
+	 read_count,
+	 (ssize_t) 0 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* The read requests do not change the current offset of the file
+	 */
+	result = libqcow_file_get_offset(
+	          file,
+	          &offset,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_EQUAL_INT64(
+	 "offset",
+	 (int64_t) offset,
+	 (int64_t) file_offset );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test error cases
+	 */
+	result = libqcow_read_request_is_complete(
+	          NULL,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_read_request_wait(
+	          NULL,
+	          &read_count,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_read_request_wait(
+	          read_request,
+	          NULL,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_file_read_async(
+	          NULL,
+	          buffer,
+	          16,
+	          0,
+	          &read_request,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	/* The read request value is already set
+	 */
+	result = libqcow_file_read_async(
+	          file,
+	          buffer,
+	          16,
+	          0,
+	          &read_request,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_read_request_free(
+	          &read_request,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "read_request",
+	 read_request );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_file_read_async(
+	          file,
+	          NULL,
+	          16,
+	          0,
+	          &read_request,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "read_request",
+	 read_request );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_file_read_async(
+	          file,
+	          buffer,
+	          (size_t) SSIZE_MAX + 1,
+	          0,
+	          &read_request,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "read_request",
+	 read_request );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_file_read_async(
+	          file,
+	          buffer,
+	          16,
+	          -1,
+	          &read_request,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
 
-		QCOW_TEST_ASSERT_IS_NOT_NULL(
-		 "error",
-		 error );
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "read_request",
+	 read_request );
 
-		libcerror_error_free(
-		 &error );
-	}
-#if defined( HAVE_PTHREAD_RWLOCK_UNLOCK_HOOK )
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
 
-	/* Test libqcow_file_read_buffer with pthread_rwlock_unlock failing in libcthreads_read_write_lock_release_for_write
-	 */
-	qcow_test_pthread_rwlock_unlock_attempts_before_fail = 0;
+	libcerror_error_free(
+	 &error );
 
-	read_count = libqcow_file_read_buffer(
-	              file,
-	              buffer,
-	              QCOW_TEST_FILE_READ_BUFFER_SIZE,
-	              &error );
+	result = libqcow_file_read_async(
+	          file,
+	          buffer,
+	          16,
+	          0,
+	          NULL,
+	          &error );
 
-	if( qcow_test_pthread_rwlock_unlock_attempts_before_fail != -1 )
-	{
-		qcow_test_pthread_rwlock_unlock_attempts_before_fail = -1;
-	}
-	else
-	{
-		QCOW_TEST_ASSERT_EQUAL_SSIZE(
-		 "read_count",
-		 read_count,
-		 (ssize_t) -1 );
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
 
-		QCOW_TEST_ASSERT_IS_NOT_NULL(
-		 "error",
-		 error );
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
 
-		libcerror_error_free(
-		 &error );
-	}
-#endif /* defined( HAVE_PTHREAD_RWLOCK_UNLOCK_HOOK ) */
-#endif /* defined( HAVE_QCOW_TEST_RWLOCK_HOOK ) */
+	libcerror_error_free(
+	 &error );
+
+	/* Clean up
+	 */
+	memory_free(
+	 data );
+
+	memory_free(
+	 expected_data );
 
 	return( 1 );
 
@@ -2428,32 +8920,52 @@ on_error:
 		libcerror_error_free(
 		 &error );
 	}
+	if( read_request != NULL )
+	{
+		libqcow_read_request_free(
+		 &read_request,
+		 NULL );
+	}
+	for( read_request_index = 0;
+	     read_request_index < QCOW_TEST_FILE_NUMBER_OF_READ_REQUESTS;
+	     read_request_index++ )
+	{
+		if( read_requests[ read_request_index ] != NULL )
+		{
+			libqcow_read_request_free(
+			 &( read_requests[ read_request_index ] ),
+			 NULL );
+		}
+	}
+	if( data != NULL )
+	{
+		memory_free(
+		 data );
+	}
+	if( expected_data != NULL )
+	{
+		memory_free(
+		 expected_data );
+	}
 	return( 0 );
 }
 
-/* Tests the libqcow_file_read_buffer_at_offset function
+/* Tests the libqcow_file_read_async_with_timeout and libqcow_read_request_cancel functions
  * Returns 1 if successful or 0 if not
  */
-int qcow_test_file_read_buffer_at_offset(
+int qcow_test_file_read_async_with_timeout(
      libqcow_file_t *file )
 {
 	uint8_t buffer[ QCOW_TEST_FILE_READ_BUFFER_SIZE ];
+	uint8_t expected_buffer[ QCOW_TEST_FILE_READ_BUFFER_SIZE ];
 
-	libcerror_error_t *error      = NULL;
-	time_t timestamp              = 0;
-	size64_t media_size           = 0;
-	size64_t remaining_media_size = 0;
-	size_t read_size              = 0;
-	ssize_t read_count            = 0;
-	off64_t offset                = 0;
-	off64_t read_offset           = 0;
-	int number_of_tests           = 1024;
-	int random_number             = 0;
-	int result                    = 0;
-	int test_number               = 0;
+	libcerror_error_t *error             = NULL;
+	libqcow_read_request_t *read_request = NULL;
+	size64_t media_size                  = 0;
+	size_t read_size                     = 0;
+	ssize_t read_count                   = 0;
+	int result                           = 0;
 
-	/* Determine size
-	 */
 	result = libqcow_file_get_media_size(
 	          file,
 	          &media_size,
@@ -2468,18 +8980,16 @@ int qcow_test_file_read_buffer_at_offset(
 	 "error",
 	 error );
 
-	/* Test regular cases
-	 */
 	read_size = QCOW_TEST_FILE_READ_BUFFER_SIZE;
 
-	if( media_size < QCOW_TEST_FILE_READ_BUFFER_SIZE )
+	if( media_size < (size64_t) read_size )
 	{
 		read_size = (size_t) media_size;
 	}
 	read_count = libqcow_file_read_buffer_at_offset(
 	              file,
-	              buffer,
-	              QCOW_TEST_FILE_READ_BUFFER_SIZE,
+	              expected_buffer,
+	              read_size,
 	              0,
 	              &error );
 
@@ -2492,133 +9002,356 @@ int qcow_test_file_read_buffer_at_offset(
 	 "error",
 	 error );
 
-	if( media_size > 8 )
+	/* Test regular cases
+	 */
+	result = libqcow_file_read_async_with_timeout(
+	          file,
+	          buffer,
+	          read_size,
+	          0,
+	          60000,
+	          &read_request,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "read_request",
+	 read_request );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_read_request_wait(
+	          read_request,
+	          &read_count,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_EQUAL_SSIZE(
+	 "read_count",
+	 read_count,
+	 (ssize_t) read_size );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = memory_compare(
+	          buffer,
+	          expected_buffer,
+	          read_size );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
+
+	/* Cancelling a completed read request does not change its result
+	 */
+	result = libqcow_read_request_cancel(
+	          read_request,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_read_request_wait(
+	          read_request,
+	          &read_count,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_EQUAL_SSIZE(
+	 "read_count",
+	 read_count,
+	 (ssize_t) read_size );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_read_request_free(
+	          &read_request,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test error cases
+	 */
+	result = libqcow_file_read_async_with_timeout(
+	          NULL,
+	          buffer,
+	          read_size,
+	          0,
+	          60000,
+	          &read_request,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_read_request_cancel(
+	          NULL,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
 	{
-		/* Read buffer on media_size boundary
-		 */
-		read_count = libqcow_file_read_buffer_at_offset(
-		              file,
-		              buffer,
-		              QCOW_TEST_FILE_READ_BUFFER_SIZE,
-		              media_size - 8,
-		              &error );
+		libcerror_error_free(
+		 &error );
+	}
+	if( read_request != NULL )
+	{
+		libqcow_read_request_free(
+		 &read_request,
+		 NULL );
+	}
+	return( 0 );
+}
 
-		QCOW_TEST_ASSERT_EQUAL_SSIZE(
-		 "read_count",
-		 read_count,
-		 (ssize_t) 8 );
+/* Callback function that compares the chunks of a scan with the data read by a cursor
+ * Returns 1 to continue the scan, 0 to stop or -1 on error
+ */
+int qcow_test_file_scan_callback(
+     off64_t offset,
+     const uint8_t *data,
+     size_t data_size,
+     void *callback_data )
+{
+	qcow_test_file_scan_values_t *scan_values = NULL;
+	libqcow_cursor_t *cursor                  = NULL;
+	uint8_t *expected_data                    = NULL;
+	ssize_t read_count                        = 0;
 
-		QCOW_TEST_ASSERT_IS_NULL(
-		 "error",
-		 error );
+	scan_values = (qcow_test_file_scan_values_t *) callback_data;
 
-		/* Read buffer beyond media_size boundary
-		 */
-		read_count = libqcow_file_read_buffer_at_offset(
-		              file,
-		              buffer,
-		              QCOW_TEST_FILE_READ_BUFFER_SIZE,
-		              media_size + 8,
-		              &error );
+	if( scan_values == NULL )
+	{
+		return( -1 );
+	}
+	if( ( scan_values->is_ordered != 0 )
+	 && ( offset < scan_values->end_offset ) )
+	{
+		scan_values->has_mismatch = 1;
+	}
+	expected_data = (uint8_t *) memory_allocate(
+	                             sizeof( uint8_t ) * data_size );
+
+	if( expected_data == NULL )
+	{
+		return( -1 );
+	}
+	if( libqcow_file_create_cursor(
+	     scan_values->file,
+	     &cursor,
+	     NULL ) == 1 )
+	{
+		read_count = libqcow_cursor_read_buffer_at_offset(
+		              cursor,
+		              expected_data,
+		              data_size,
+		              offset,
+		              NULL );
+
+		libqcow_cursor_free(
+		 &cursor,
+		 NULL );
+	}
+	if( ( read_count != (ssize_t) data_size )
+	 || ( memory_compare(
+	       data,
+	       expected_data,
+	       data_size ) != 0 ) )
+	{
+		scan_values->has_mismatch = 1;
+	}
+	memory_free(
+	 expected_data );
 
-		QCOW_TEST_ASSERT_EQUAL_SSIZE(
-		 "read_count",
-		 read_count,
-		 (ssize_t) 0 );
+	scan_values->end_offset        = offset + (off64_t) data_size;
+	scan_values->number_of_chunks += 1;
 
-		QCOW_TEST_ASSERT_IS_NULL(
-		 "error",
-		 error );
+	if( scan_values->callback_result != 1 )
+	{
+		return( scan_values->callback_result );
 	}
-	/* Stress test read buffer
-	 */
-	timestamp = time(
-	             NULL );
+	if( scan_values->number_of_chunks >= QCOW_TEST_FILE_MAXIMUM_NUMBER_OF_SCAN_CHUNKS )
+	{
+		return( 0 );
+	}
+	return( 1 );
+}
 
-	srand(
-	 (unsigned int) timestamp );
+/* Tests the libqcow_file_scan function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_file_scan(
+     libqcow_file_t *file )
+{
+	qcow_test_file_scan_values_t scan_values;
 
-	for( test_number = 0;
-	     test_number < number_of_tests;
-	     test_number++ )
+	libcerror_error_t *error = NULL;
+	int result               = 0;
+
+	/* Test regular cases
+	 */
+	if( memory_set(
+	     &scan_values,
+	     0,
+	     sizeof( qcow_test_file_scan_values_t ) ) == NULL )
 	{
-		random_number = rand();
+		return( 0 );
+	}
+	scan_values.file            = file;
+	scan_values.callback_result = 1;
+	scan_values.is_ordered      = 1;
 
-		QCOW_TEST_ASSERT_GREATER_THAN_INT(
-		 "random_number",
-		 random_number,
-		 -1 );
+	result = libqcow_file_scan(
+	          file,
+	          &qcow_test_file_scan_callback,
+	          &scan_values,
+	          0,
+	          0,
+	          &error );
 
-		if( media_size > 0 )
-		{
-			read_offset = (off64_t) random_number % media_size;
-		}
-		read_size = (size_t) random_number % QCOW_TEST_FILE_READ_BUFFER_SIZE;
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
 
-#if defined( QCOW_TEST_FILE_VERBOSE )
-		fprintf(
-		 stdout,
-		 "libqcow_file_read_buffer_at_offset: at offset: %" PRIi64 " (0x%08" PRIx64 ") of size: %" PRIzd "\n",
-		 read_offset,
-		 read_offset,
-		 read_size );
-#endif
-		read_count = libqcow_file_read_buffer_at_offset(
-		              file,
-		              buffer,
-		              read_size,
-		              read_offset,
-		              &error );
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
 
-		remaining_media_size = media_size - read_offset;
+	QCOW_TEST_ASSERT_EQUAL_UINT8(
+	 "scan_values.has_mismatch",
+	 scan_values.has_mismatch,
+	 0 );
 
-		if( read_size > remaining_media_size )
-		{
-			read_size = (size_t) remaining_media_size;
-		}
-		QCOW_TEST_ASSERT_EQUAL_SSIZE(
-		 "read_count",
-		 read_count,
-		 (ssize_t) read_size );
+	QCOW_TEST_ASSERT_LESS_THAN_INT(
+	 "scan_values.number_of_chunks",
+	 scan_values.number_of_chunks,
+	 QCOW_TEST_FILE_MAXIMUM_NUMBER_OF_SCAN_CHUNKS + 1 );
 
-		QCOW_TEST_ASSERT_IS_NULL(
-		 "error",
-		 error );
+	scan_values.end_offset       = 0;
+	scan_values.number_of_chunks = 0;
+	scan_values.is_ordered       = 0;
 
-		read_offset += read_count;
+	result = libqcow_file_scan(
+	          file,
+	          &qcow_test_file_scan_callback,
+	          &scan_values,
+	          2,
+	          LIBQCOW_SCAN_FLAG_UNORDERED,
+	          &error );
 
-		result = libqcow_file_get_offset(
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT8(
+	 "scan_values.has_mismatch",
+	 scan_values.has_mismatch,
+	 0 );
+
+	/* Test error cases
+	 */
+	if( scan_values.number_of_chunks > 0 )
+	{
+		scan_values.number_of_chunks = 0;
+		scan_values.callback_result  = -1;
+
+		result = libqcow_file_scan(
 		          file,
-		          &offset,
+		          &qcow_test_file_scan_callback,
+		          &scan_values,
+		          0,
+		          0,
 		          &error );
 
 		QCOW_TEST_ASSERT_EQUAL_INT(
 		 "result",
 		 result,
-		 1 );
-
-		QCOW_TEST_ASSERT_EQUAL_INT64(
-		 "offset",
-		 offset,
-		 read_offset );
+		 -1 );
 
-		QCOW_TEST_ASSERT_IS_NULL(
+		QCOW_TEST_ASSERT_IS_NOT_NULL(
 		 "error",
 		 error );
+
+		libcerror_error_free(
+		 &error );
+
+		QCOW_TEST_ASSERT_EQUAL_INT(
+		 "scan_values.number_of_chunks",
+		 scan_values.number_of_chunks,
+		 1 );
 	}
-	/* Test error cases
-	 */
-	read_count = libqcow_file_read_buffer_at_offset(
-	              NULL,
-	              buffer,
-	              QCOW_TEST_FILE_READ_BUFFER_SIZE,
-	              0,
-	              &error );
+	result = libqcow_file_scan(
+	          NULL,
+	          &qcow_test_file_scan_callback,
+	          &scan_values,
+	          0,
+	          0,
+	          &error );
 
-	QCOW_TEST_ASSERT_EQUAL_SSIZE(
-	 "read_count",
-	 read_count,
-	 (ssize_t) -1 );
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
 
 	QCOW_TEST_ASSERT_IS_NOT_NULL(
 	 "error",
@@ -2627,17 +9360,18 @@ int qcow_test_file_read_buffer_at_offset(
 	libcerror_error_free(
 	 &error );
 
-	read_count = libqcow_file_read_buffer_at_offset(
-	              file,
-	              NULL,
-	              QCOW_TEST_FILE_READ_BUFFER_SIZE,
-	              0,
-	              &error );
+	result = libqcow_file_scan(
+	          file,
+	          NULL,
+	          &scan_values,
+	          0,
+	          0,
+	          &error );
 
-	QCOW_TEST_ASSERT_EQUAL_SSIZE(
-	 "read_count",
-	 read_count,
-	 (ssize_t) -1 );
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
 
 	QCOW_TEST_ASSERT_IS_NOT_NULL(
 	 "error",
@@ -2646,17 +9380,18 @@ int qcow_test_file_read_buffer_at_offset(
 	libcerror_error_free(
 	 &error );
 
-	read_count = libqcow_file_read_buffer_at_offset(
-	              file,
-	              buffer,
-	              (size_t) SSIZE_MAX + 1,
-	              0,
-	              &error );
+	result = libqcow_file_scan(
+	          file,
+	          &qcow_test_file_scan_callback,
+	          &scan_values,
+	          -1,
+	          0,
+	          &error );
 
-	QCOW_TEST_ASSERT_EQUAL_SSIZE(
-	 "read_count",
-	 read_count,
-	 (ssize_t) -1 );
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
 
 	QCOW_TEST_ASSERT_IS_NOT_NULL(
 	 "error",
@@ -2665,17 +9400,91 @@ int qcow_test_file_read_buffer_at_offset(
 	libcerror_error_free(
 	 &error );
 
-	read_count = libqcow_file_read_buffer_at_offset(
-	              file,
-	              buffer,
-	              QCOW_TEST_FILE_READ_BUFFER_SIZE,
-	              -1,
-	              &error );
+	result = libqcow_file_scan(
+	          file,
+	          &qcow_test_file_scan_callback,
+	          &scan_values,
+	          0,
+	          0x80,
+	          &error );
 
-	QCOW_TEST_ASSERT_EQUAL_SSIZE(
-	 "read_count",
-	 read_count,
-	 (ssize_t) -1 );
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	return( 0 );
+}
+
+/* Tests the libqcow_file_get_media_size function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_file_get_media_size(
+     libqcow_file_t *file )
+{
+	libcerror_error_t *error = NULL;
+	size64_t media_size      = 0;
+	int result               = 0;
+
+	/* Test regular cases
+	 */
+	result = libqcow_file_get_media_size(
+	          file,
+	          &media_size,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test error cases
+	 */
+	result = libqcow_file_get_media_size(
+	          NULL,
+	          &media_size,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_file_get_media_size(
+	          file,
+	          NULL,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
 
 	QCOW_TEST_ASSERT_IS_NOT_NULL(
 	 "error",
@@ -2686,27 +9495,25 @@ int qcow_test_file_read_buffer_at_offset(
 
 #if defined( HAVE_QCOW_TEST_RWLOCK_HOOK )
 
-	/* Test libqcow_file_read_buffer_at_offset with pthread_rwlock_wrlock failing in libcthreads_read_write_lock_grab_for_write
+	/* Test libqcow_file_get_media_size with pthread_rwlock_rdlock failing in libcthreads_read_write_lock_grab_for_read
 	 */
-	qcow_test_pthread_rwlock_wrlock_attempts_before_fail = 0;
+	qcow_test_pthread_rwlock_rdlock_attempts_before_fail = 0;
 
-	read_count = libqcow_file_read_buffer_at_offset(
-	              file,
-	              buffer,
-	              QCOW_TEST_FILE_READ_BUFFER_SIZE,
-	              0,
-	              &error );
+	result = libqcow_file_get_media_size(
+	          file,
+	          &media_size,
+	          &error );
 
-	if( qcow_test_pthread_rwlock_wrlock_attempts_before_fail != -1 )
+	if( qcow_test_pthread_rwlock_rdlock_attempts_before_fail != -1 )
 	{
-		qcow_test_pthread_rwlock_wrlock_attempts_before_fail = -1;
+		qcow_test_pthread_rwlock_rdlock_attempts_before_fail = -1;
 	}
 	else
 	{
-		QCOW_TEST_ASSERT_EQUAL_SSIZE(
-		 "read_count",
-		 read_count,
-		 (ssize_t) -1 );
+		QCOW_TEST_ASSERT_EQUAL_INT(
+		 "result",
+		 result,
+		 -1 );
 
 		QCOW_TEST_ASSERT_IS_NOT_NULL(
 		 "error",
@@ -2717,17 +9524,14 @@ int qcow_test_file_read_buffer_at_offset(
 	}
 #if defined( HAVE_PTHREAD_RWLOCK_UNLOCK_HOOK )
 
-	/* Test libqcow_file_read_buffer_at_offset with pthread_rwlock_unlock failing in libcthreads_read_write_lock_release_for_write
+	/* Test libqcow_file_get_media_size with pthread_rwlock_unlock failing in libcthreads_read_write_lock_release_for_read
 	 */
-/* TODO flaky test disabled for now
 	qcow_test_pthread_rwlock_unlock_attempts_before_fail = 0;
 
-	read_count = libqcow_file_read_buffer_at_offset(
-	              file,
-	              buffer,
-	              QCOW_TEST_FILE_READ_BUFFER_SIZE,
-	              0,
-	              &error );
+	result = libqcow_file_get_media_size(
+	          file,
+	          &media_size,
+	          &error );
 
 	if( qcow_test_pthread_rwlock_unlock_attempts_before_fail != -1 )
 	{
@@ -2735,10 +9539,10 @@ int qcow_test_file_read_buffer_at_offset(
 	}
 	else
 	{
-		QCOW_TEST_ASSERT_EQUAL_SSIZE(
-		 "read_count",
-		 read_count,
-		 (ssize_t) -1 );
+		QCOW_TEST_ASSERT_EQUAL_INT(
+		 "result",
+		 result,
+		 -1 );
 
 		QCOW_TEST_ASSERT_IS_NOT_NULL(
 		 "error",
@@ -2747,7 +9551,6 @@ int qcow_test_file_read_buffer_at_offset(
 		libcerror_error_free(
 		 &error );
 	}
-*/
 #endif /* defined( HAVE_PTHREAD_RWLOCK_UNLOCK_HOOK ) */
 #endif /* defined( HAVE_QCOW_TEST_RWLOCK_HOOK ) */
 
@@ -2762,92 +9565,285 @@ on_error:
 	return( 0 );
 }
 
-/* Tests the libqcow_file_seek_offset function
+/* Tests the libqcow_file_get_format_version function
  * Returns 1 if successful or 0 if not
  */
-int qcow_test_file_seek_offset(
+int qcow_test_file_get_format_version(
      libqcow_file_t *file )
 {
 	libcerror_error_t *error = NULL;
-	size64_t size            = 0;
-	off64_t offset           = 0;
+	uint32_t format_version  = 0;
+	int result               = 0;
 
 	/* Test regular cases
 	 */
-	offset = libqcow_file_seek_offset(
+	result = libqcow_file_get_format_version(
 	          file,
-	          0,
-	          SEEK_END,
+	          &format_version,
 	          &error );
 
-	QCOW_TEST_ASSERT_NOT_EQUAL_INT64(
-	 "offset",
-	 offset,
-	 (int64_t) -1 );
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
 
 	QCOW_TEST_ASSERT_IS_NULL(
 	 "error",
 	 error );
 
-	size = (size64_t) offset;
+	/* Test error cases
+	 */
+	result = libqcow_file_get_format_version(
+	          NULL,
+	          &format_version,
+	          &error );
 
-	offset = libqcow_file_seek_offset(
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_file_get_format_version(
 	          file,
-	          1024,
-	          SEEK_SET,
+	          NULL,
 	          &error );
 
-	QCOW_TEST_ASSERT_EQUAL_INT64(
-	 "offset",
-	 offset,
-	 (int64_t) 1024 );
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	return( 0 );
+}
+
+/* Tests the libqcow_file_get_encryption_method function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_file_get_encryption_method(
+     libqcow_file_t *file )
+{
+	libcerror_error_t *error   = NULL;
+	uint32_t encryption_method = 0;
+	int result                 = 0;
+
+	/* Test regular cases
+	 */
+	result = libqcow_file_get_encryption_method(
+	          file,
+	          &encryption_method,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
 
 	QCOW_TEST_ASSERT_IS_NULL(
 	 "error",
 	 error );
 
-	offset = libqcow_file_seek_offset(
+	/* Test error cases
+	 */
+	result = libqcow_file_get_encryption_method(
+	          NULL,
+	          &encryption_method,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_file_get_encryption_method(
+	          file,
+	          NULL,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	return( 0 );
+}
+
+/* Tests the libqcow_file_open_data_file_io_handle function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_file_open_data_file_io_handle(
+     libqcow_file_t *file )
+{
+	libcerror_error_t *error = NULL;
+	int result               = 0;
+
+	/* Test error cases
+	 */
+	result = libqcow_file_open_data_file_io_handle(
+	          NULL,
+	          NULL,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_file_open_data_file_io_handle(
+	          file,
+	          NULL,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	return( 0 );
+}
+
+/* Tests the libqcow_file_get_utf8_data_filename_size function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_file_get_utf8_data_filename_size(
+     libqcow_file_t *file )
+{
+	libcerror_error_t *error = NULL;
+	size_t utf8_string_size  = 0;
+	int result               = 0;
+
+	/* Test regular cases
+	 */
+	result = libqcow_file_get_utf8_data_filename_size(
 	          file,
-	          -512,
-	          SEEK_CUR,
+	          &utf8_string_size,
 	          &error );
 
-	QCOW_TEST_ASSERT_EQUAL_INT64(
-	 "offset",
-	 offset,
-	 (int64_t) 512 );
+	QCOW_TEST_ASSERT_NOT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
 
 	QCOW_TEST_ASSERT_IS_NULL(
 	 "error",
 	 error );
 
-	offset = libqcow_file_seek_offset(
-	          file,
-	          (off64_t) ( size + 512 ),
-	          SEEK_SET,
+	/* Test error cases
+	 */
+	result = libqcow_file_get_utf8_data_filename_size(
+	          NULL,
+	          &utf8_string_size,
 	          &error );
 
-	QCOW_TEST_ASSERT_EQUAL_INT64(
-	 "offset",
-	 offset,
-	 (int64_t) ( size + 512 ) );
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
 
-	QCOW_TEST_ASSERT_IS_NULL(
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
 	 "error",
 	 error );
 
-	/* Reset offset to 0
+	libcerror_error_free(
+	 &error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	return( 0 );
+}
+
+/* Tests the libqcow_file_get_number_of_snapshots function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_file_get_number_of_snapshots(
+     libqcow_file_t *file )
+{
+	libcerror_error_t *error = NULL;
+	int number_of_snapshots  = 0;
+	int result               = 0;
+
+	/* Test regular cases
 	 */
-	offset = libqcow_file_seek_offset(
+	result = libqcow_file_get_number_of_snapshots(
 	          file,
-	          0,
-	          SEEK_SET,
+	          &number_of_snapshots,
 	          &error );
 
-	QCOW_TEST_ASSERT_EQUAL_INT64(
-	 "offset",
-	 offset,
-	 (int64_t) 0 );
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
 
 	QCOW_TEST_ASSERT_IS_NULL(
 	 "error",
@@ -2855,16 +9851,15 @@ int qcow_test_file_seek_offset(
 
 	/* Test error cases
 	 */
-	offset = libqcow_file_seek_offset(
+	result = libqcow_file_get_number_of_snapshots(
 	          NULL,
-	          0,
-	          SEEK_SET,
+	          &number_of_snapshots,
 	          &error );
 
-	QCOW_TEST_ASSERT_EQUAL_INT64(
-	 "offset",
-	 offset,
-	 (int64_t) -1 );
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
 
 	QCOW_TEST_ASSERT_IS_NOT_NULL(
 	 "error",
@@ -2873,16 +9868,15 @@ int qcow_test_file_seek_offset(
 	libcerror_error_free(
 	 &error );
 
-	offset = libqcow_file_seek_offset(
+	result = libqcow_file_get_number_of_snapshots(
 	          file,
-	          -1,
-	          SEEK_SET,
+	          NULL,
 	          &error );
 
-	QCOW_TEST_ASSERT_EQUAL_INT64(
-	 "offset",
-	 offset,
-	 (int64_t) -1 );
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
 
 	QCOW_TEST_ASSERT_IS_NOT_NULL(
 	 "error",
@@ -2891,144 +9885,164 @@ int qcow_test_file_seek_offset(
 	libcerror_error_free(
 	 &error );
 
-	offset = libqcow_file_seek_offset(
-	          file,
-	          -1,
-	          SEEK_CUR,
-	          &error );
+	return( 1 );
 
-	QCOW_TEST_ASSERT_EQUAL_INT64(
-	 "offset",
-	 offset,
-	 (int64_t) -1 );
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	return( 0 );
+}
 
-	QCOW_TEST_ASSERT_IS_NOT_NULL(
-	 "error",
-	 error );
+/* Tests the libqcow_file_get_snapshot_by_index function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_file_get_snapshot_by_index(
+     libqcow_file_t *file )
+{
+	uint8_t buffer[ 4096 ];
 
-	offset = libqcow_file_seek_offset(
+	libcerror_error_t *error     = NULL;
+	libqcow_snapshot_t *snapshot = NULL;
+	size64_t media_size          = 0;
+	ssize_t read_count           = 0;
+	off64_t offset               = 0;
+	int number_of_snapshots      = 0;
+	int result                   = 0;
+
+	result = libqcow_file_get_number_of_snapshots(
 	          file,
-	          (off64_t) ( -1 * ( size + 1 ) ),
-	          SEEK_END,
+	          &number_of_snapshots,
 	          &error );
 
-	QCOW_TEST_ASSERT_EQUAL_INT64(
-	 "offset",
-	 offset,
-	 (int64_t) -1 );
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
 
-	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	QCOW_TEST_ASSERT_IS_NULL(
 	 "error",
 	 error );
 
-	libcerror_error_free(
-	 &error );
+	if( number_of_snapshots > 0 )
+	{
+		/* Test regular cases
+		 */
+		result = libqcow_file_get_snapshot_by_index(
+		          file,
+		          0,
+		          &snapshot,
+		          &error );
 
-#if defined( HAVE_QCOW_TEST_RWLOCK_HOOK )
+		QCOW_TEST_ASSERT_EQUAL_INT(
+		 "result",
+		 result,
+		 1 );
 
-	/* Test libqcow_file_seek_offset with pthread_rwlock_wrlock failing in libcthreads_read_write_lock_grab_for_write
-	 */
-	qcow_test_pthread_rwlock_wrlock_attempts_before_fail = 0;
+		QCOW_TEST_ASSERT_IS_NOT_NULL(
+		 "snapshot",
+		 snapshot );
 
-	offset = libqcow_file_seek_offset(
-	          file,
-	          0,
-	          SEEK_SET,
-	          &error );
+		QCOW_TEST_ASSERT_IS_NULL(
+		 "error",
+		 error );
 
-	if( qcow_test_pthread_rwlock_wrlock_attempts_before_fail != -1 )
-	{
-		qcow_test_pthread_rwlock_wrlock_attempts_before_fail = -1;
-	}
-	else
-	{
-		QCOW_TEST_ASSERT_EQUAL_INT64(
-		 "offset",
-		 (int64_t) offset,
-		 (int64_t) -1 );
+		result = libqcow_snapshot_get_media_size(
+		          snapshot,
+		          &media_size,
+		          &error );
 
-		QCOW_TEST_ASSERT_IS_NOT_NULL(
+		QCOW_TEST_ASSERT_EQUAL_INT(
+		 "result",
+		 result,
+		 1 );
+
+		QCOW_TEST_ASSERT_IS_NULL(
 		 "error",
 		 error );
 
-		libcerror_error_free(
-		 &error );
-	}
-#if defined( HAVE_PTHREAD_RWLOCK_UNLOCK_HOOK )
+		if( media_size > 4096 )
+		{
+			media_size = 4096;
+		}
+		read_count = libqcow_snapshot_read_buffer_at_offset(
+		              snapshot,
+		              buffer,
+		              4096,
+		              0,
+		              &error );
 
-	/* Test libqcow_file_seek_offset with pthread_rwlock_unlock failing in libcthreads_read_write_lock_release_for_write
-	 */
-	qcow_test_pthread_rwlock_unlock_attempts_before_fail = 0;
+		QCOW_TEST_ASSERT_EQUAL_SSIZE(
+		 "read_count",
+		 read_count,
+		 (ssize_t) media_size );
 
-	offset = libqcow_file_seek_offset(
-	          file,
-	          0,
-	          SEEK_SET,
-	          &error );
+		QCOW_TEST_ASSERT_IS_NULL(
+		 "error",
+		 error );
+
+		result = libqcow_snapshot_get_offset(
+		          snapshot,
+		          &offset,
+		          &error );
+
+		QCOW_TEST_ASSERT_EQUAL_INT(
+		 "result",
+		 result,
+		 1 );
 
-	if( qcow_test_pthread_rwlock_unlock_attempts_before_fail != -1 )
-	{
-		qcow_test_pthread_rwlock_unlock_attempts_before_fail = -1;
-	}
-	else
-	{
 		QCOW_TEST_ASSERT_EQUAL_INT64(
 		 "offset",
 		 (int64_t) offset,
-		 (int64_t) -1 );
+		 (int64_t) media_size );
 
-		QCOW_TEST_ASSERT_IS_NOT_NULL(
+		QCOW_TEST_ASSERT_IS_NULL(
 		 "error",
 		 error );
 
-		libcerror_error_free(
-		 &error );
-	}
-#endif /* defined( HAVE_PTHREAD_RWLOCK_UNLOCK_HOOK ) */
-#endif /* defined( HAVE_QCOW_TEST_RWLOCK_HOOK ) */
+		/* The file cannot be closed while the snapshot is in use
+		 */
+		result = libqcow_file_close(
+		          file,
+		          &error );
 
-	return( 1 );
+		QCOW_TEST_ASSERT_EQUAL_INT(
+		 "result",
+		 result,
+		 -1 );
+
+		QCOW_TEST_ASSERT_IS_NOT_NULL(
+		 "error",
+		 error );
 
-on_error:
-	if( error != NULL )
-	{
 		libcerror_error_free(
 		 &error );
-	}
-	return( 0 );
-}
-
-/* Tests the libqcow_file_get_offset function
- * Returns 1 if successful or 0 if not
- */
-int qcow_test_file_get_offset(
-     libqcow_file_t *file )
-{
-	libcerror_error_t *error = NULL;
-	off64_t offset           = 0;
-	int result               = 0;
 
-	/* Test regular cases
-	 */
-	result = libqcow_file_get_offset(
-	          file,
-	          &offset,
-	          &error );
+		result = libqcow_snapshot_free(
+		          &snapshot,
+		          &error );
 
-	QCOW_TEST_ASSERT_EQUAL_INT(
-	 "result",
-	 result,
-	 1 );
+		QCOW_TEST_ASSERT_EQUAL_INT(
+		 "result",
+		 result,
+		 1 );
 
-	QCOW_TEST_ASSERT_IS_NULL(
-	 "error",
-	 error );
+		QCOW_TEST_ASSERT_IS_NULL(
+		 "snapshot",
+		 snapshot );
 
+		QCOW_TEST_ASSERT_IS_NULL(
+		 "error",
+		 error );
+	}
 	/* Test error cases
 	 */
-	result = libqcow_file_get_offset(
+	result = libqcow_file_get_snapshot_by_index(
 	          NULL,
-	          &offset,
+	          0,
+	          &snapshot,
 	          &error );
 
 	QCOW_TEST_ASSERT_EQUAL_INT(
@@ -3043,9 +10057,10 @@ int qcow_test_file_get_offset(
 	libcerror_error_free(
 	 &error );
 
-	result = libqcow_file_get_offset(
+	result = libqcow_file_get_snapshot_by_index(
 	          file,
-	          NULL,
+	          -1,
+	          &snapshot,
 	          &error );
 
 	QCOW_TEST_ASSERT_EQUAL_INT(
@@ -3060,66 +10075,41 @@ int qcow_test_file_get_offset(
 	libcerror_error_free(
 	 &error );
 
-#if defined( HAVE_QCOW_TEST_RWLOCK_HOOK )
-
-	/* Test libqcow_file_get_offset with pthread_rwlock_rdlock failing in libcthreads_read_write_lock_grab_for_read
-	 */
-	qcow_test_pthread_rwlock_rdlock_attempts_before_fail = 0;
-
-	result = libqcow_file_get_offset(
+	result = libqcow_file_get_snapshot_by_index(
 	          file,
-	          &offset,
+	          number_of_snapshots,
+	          &snapshot,
 	          &error );
 
-	if( qcow_test_pthread_rwlock_rdlock_attempts_before_fail != -1 )
-	{
-		qcow_test_pthread_rwlock_rdlock_attempts_before_fail = -1;
-	}
-	else
-	{
-		QCOW_TEST_ASSERT_EQUAL_INT(
-		 "result",
-		 result,
-		 -1 );
-
-		QCOW_TEST_ASSERT_IS_NOT_NULL(
-		 "error",
-		 error );
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
 
-		libcerror_error_free(
-		 &error );
-	}
-#if defined( HAVE_PTHREAD_RWLOCK_UNLOCK_HOOK )
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
 
-	/* Test libqcow_file_get_offset with pthread_rwlock_unlock failing in libcthreads_read_write_lock_release_for_read
-	 */
-	qcow_test_pthread_rwlock_unlock_attempts_before_fail = 0;
+	libcerror_error_free(
+	 &error );
 
-	result = libqcow_file_get_offset(
+	result = libqcow_file_get_snapshot_by_index(
 	          file,
-	          &offset,
+	          0,
+	          NULL,
 	          &error );
 
-	if( qcow_test_pthread_rwlock_unlock_attempts_before_fail != -1 )
-	{
-		qcow_test_pthread_rwlock_unlock_attempts_before_fail = -1;
-	}
-	else
-	{
-		QCOW_TEST_ASSERT_EQUAL_INT(
-		 "result",
-		 result,
-		 -1 );
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
 
-		QCOW_TEST_ASSERT_IS_NOT_NULL(
-		 "error",
-		 error );
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
 
-		libcerror_error_free(
-		 &error );
-	}
-#endif /* defined( HAVE_PTHREAD_RWLOCK_UNLOCK_HOOK ) */
-#endif /* defined( HAVE_QCOW_TEST_RWLOCK_HOOK ) */
+	libcerror_error_free(
+	 &error );
 
 	return( 1 );
 
@@ -3129,24 +10119,35 @@ on_error:
 		libcerror_error_free(
 		 &error );
 	}
+	if( snapshot != NULL )
+	{
+		libqcow_snapshot_free(
+		 &snapshot,
+		 NULL );
+	}
 	return( 0 );
 }
 
-/* Tests the libqcow_file_get_media_size function
+/* Tests the libqcow_file_get_changed_extents function
  * Returns 1 if successful or 0 if not
  */
-int qcow_test_file_get_media_size(
+int qcow_test_file_get_changed_extents(
      libqcow_file_t *file )
 {
-	libcerror_error_t *error = NULL;
-	size64_t media_size      = 0;
-	int result               = 0;
+	libcerror_error_t *error                   = NULL;
+	libqcow_changed_extents_t *changed_extents = NULL;
+	libqcow_snapshot_t *snapshot               = NULL;
+	int number_of_extents                      = 0;
+	int number_of_snapshots                    = 0;
+	int result                                 = 0;
 
 	/* Test regular cases
 	 */
-	result = libqcow_file_get_media_size(
+	result = libqcow_file_get_changed_extents(
 	          file,
-	          &media_size,
+	          NULL,
+	          NULL,
+	          &changed_extents,
 	          &error );
 
 	QCOW_TEST_ASSERT_EQUAL_INT(
@@ -3154,106 +10155,210 @@ int qcow_test_file_get_media_size(
 	 result,
 	 1 );
 
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "changed_extents",
+	 changed_extents );
+
 	QCOW_TEST_ASSERT_IS_NULL(
 	 "error",
 	 error );
 
-	/* Test error cases
-	 */
-	result = libqcow_file_get_media_size(
-	          NULL,
-	          &media_size,
+	result = libqcow_changed_extents_get_number_of_extents(
+	          changed_extents,
+	          &number_of_extents,
 	          &error );
 
 	QCOW_TEST_ASSERT_EQUAL_INT(
 	 "result",
 	 result,
-	 -1 );
+	 1 );
 
-	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "number_of_extents",
+	 number_of_extents,
+	 0 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
 	 "error",
 	 error );
 
-	libcerror_error_free(
-	 &error );
+	result = libqcow_changed_extents_free(
+	          &changed_extents,
+	          &error );
 
-	result = libqcow_file_get_media_size(
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_file_get_number_of_snapshots(
 	          file,
-	          NULL,
+	          &number_of_snapshots,
 	          &error );
 
 	QCOW_TEST_ASSERT_EQUAL_INT(
 	 "result",
 	 result,
-	 -1 );
+	 1 );
 
-	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	QCOW_TEST_ASSERT_IS_NULL(
 	 "error",
 	 error );
 
-	libcerror_error_free(
-	 &error );
+	if( number_of_snapshots > 0 )
+	{
+		result = libqcow_file_get_snapshot_by_index(
+		          file,
+		          0,
+		          &snapshot,
+		          &error );
 
-#if defined( HAVE_QCOW_TEST_RWLOCK_HOOK )
+		QCOW_TEST_ASSERT_EQUAL_INT(
+		 "result",
+		 result,
+		 1 );
 
-	/* Test libqcow_file_get_media_size with pthread_rwlock_rdlock failing in libcthreads_read_write_lock_grab_for_read
-	 */
-	qcow_test_pthread_rwlock_rdlock_attempts_before_fail = 0;
+		QCOW_TEST_ASSERT_IS_NULL(
+		 "error",
+		 error );
 
-	result = libqcow_file_get_media_size(
-	          file,
-	          &media_size,
-	          &error );
+		result = libqcow_file_get_changed_extents(
+		          file,
+		          snapshot,
+		          snapshot,
+		          &changed_extents,
+		          &error );
 
-	if( qcow_test_pthread_rwlock_rdlock_attempts_before_fail != -1 )
-	{
-		qcow_test_pthread_rwlock_rdlock_attempts_before_fail = -1;
-	}
-	else
-	{
 		QCOW_TEST_ASSERT_EQUAL_INT(
 		 "result",
 		 result,
-		 -1 );
+		 1 );
 
-		QCOW_TEST_ASSERT_IS_NOT_NULL(
+		QCOW_TEST_ASSERT_IS_NULL(
 		 "error",
 		 error );
 
-		libcerror_error_free(
-		 &error );
-	}
-#if defined( HAVE_PTHREAD_RWLOCK_UNLOCK_HOOK )
+		result = libqcow_changed_extents_get_number_of_extents(
+		          changed_extents,
+		          &number_of_extents,
+		          &error );
 
-	/* Test libqcow_file_get_media_size with pthread_rwlock_unlock failing in libcthreads_read_write_lock_release_for_read
-	 */
-	qcow_test_pthread_rwlock_unlock_attempts_before_fail = 0;
+		QCOW_TEST_ASSERT_EQUAL_INT(
+		 "result",
+		 result,
+		 1 );
 
-	result = libqcow_file_get_media_size(
-	          file,
-	          &media_size,
-	          &error );
+		QCOW_TEST_ASSERT_EQUAL_INT(
+		 "number_of_extents",
+		 number_of_extents,
+		 0 );
+
+		QCOW_TEST_ASSERT_IS_NULL(
+		 "error",
+		 error );
+
+		result = libqcow_changed_extents_free(
+		          &changed_extents,
+		          &error );
 
-	if( qcow_test_pthread_rwlock_unlock_attempts_before_fail != -1 )
-	{
-		qcow_test_pthread_rwlock_unlock_attempts_before_fail = -1;
-	}
-	else
-	{
 		QCOW_TEST_ASSERT_EQUAL_INT(
 		 "result",
 		 result,
-		 -1 );
+		 1 );
+
+		QCOW_TEST_ASSERT_IS_NULL(
+		 "error",
+		 error );
+
+		result = libqcow_file_get_changed_extents(
+		          file,
+		          snapshot,
+		          NULL,
+		          &changed_extents,
+		          &error );
+
+		QCOW_TEST_ASSERT_EQUAL_INT(
+		 "result",
+		 result,
+		 1 );
 
 		QCOW_TEST_ASSERT_IS_NOT_NULL(
+		 "changed_extents",
+		 changed_extents );
+
+		QCOW_TEST_ASSERT_IS_NULL(
 		 "error",
 		 error );
 
-		libcerror_error_free(
-		 &error );
+		result = libqcow_changed_extents_free(
+		          &changed_extents,
+		          &error );
+
+		QCOW_TEST_ASSERT_EQUAL_INT(
+		 "result",
+		 result,
+		 1 );
+
+		QCOW_TEST_ASSERT_IS_NULL(
+		 "error",
+		 error );
+
+		result = libqcow_snapshot_free(
+		          &snapshot,
+		          &error );
+
+		QCOW_TEST_ASSERT_EQUAL_INT(
+		 "result",
+		 result,
+		 1 );
+
+		QCOW_TEST_ASSERT_IS_NULL(
+		 "error",
+		 error );
 	}
-#endif /* defined( HAVE_PTHREAD_RWLOCK_UNLOCK_HOOK ) */
-#endif /* defined( HAVE_QCOW_TEST_RWLOCK_HOOK ) */
+	/* Test error cases
+	 */
+	result = libqcow_file_get_changed_extents(
+	          NULL,
+	          NULL,
+	          NULL,
+	          &changed_extents,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_file_get_changed_extents(
+	          file,
+	          NULL,
+	          NULL,
+	          NULL,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
 
 	return( 1 );
 
@@ -3263,24 +10368,43 @@ on_error:
 		libcerror_error_free(
 		 &error );
 	}
+	if( changed_extents != NULL )
+	{
+		libqcow_changed_extents_free(
+		 &changed_extents,
+		 NULL );
+	}
+	if( snapshot != NULL )
+	{
+		libqcow_snapshot_free(
+		 &snapshot,
+		 NULL );
+	}
 	return( 0 );
 }
 
-/* Tests the libqcow_file_get_format_version function
+/* Tests the libqcow_file_export_file_io_handle function
  * Returns 1 if successful or 0 if not
  */
-int qcow_test_file_get_format_version(
+int qcow_test_file_export_file_io_handle(
      libqcow_file_t *file )
 {
-	libcerror_error_t *error = NULL;
-	uint32_t format_version  = 0;
-	int result               = 0;
+	uint8_t read_buffer[ QCOW_TEST_FILE_READ_BUFFER_SIZE ];
 
-	/* Test regular cases
+	libbfio_handle_t *file_io_handle = NULL;
+	libcerror_error_t *error         = NULL;
+	uint8_t *export_data             = NULL;
+	size64_t media_size              = 0;
+	size_t read_size                 = 0;
+	ssize_t read_count               = 0;
+	off64_t offset                   = 0;
+	int result                       = 0;
+
+	/* Initialize test
 	 */
-	result = libqcow_file_get_format_version(
+	result = libqcow_file_get_media_size(
 	          file,
-	          &format_version,
+	          &media_size,
 	          &error );
 
 	QCOW_TEST_ASSERT_EQUAL_INT(
@@ -3292,68 +10416,78 @@ int qcow_test_file_get_format_version(
 	 "error",
 	 error );
 
-	/* Test error cases
+	/* The test exports to memory hence it is limited to small media
 	 */
-	result = libqcow_file_get_format_version(
-	          NULL,
-	          &format_version,
+	if( ( media_size == 0 )
+	 || ( media_size > (size64_t) ( 64 * 1024 * 1024 ) ) )
+	{
+		return( 1 );
+	}
+	export_data = (uint8_t *) memory_allocate(
+	                           (size_t) media_size );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "export_data",
+	 export_data );
+
+	result = ( memory_set(
+	            export_data,
+	            0,
+	            (size_t) media_size ) != NULL );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	result = libbfio_memory_range_initialize(
+	          &file_io_handle,
 	          &error );
 
 	QCOW_TEST_ASSERT_EQUAL_INT(
 	 "result",
 	 result,
-	 -1 );
+	 1 );
 
-	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	QCOW_TEST_ASSERT_IS_NULL(
 	 "error",
 	 error );
 
-	libcerror_error_free(
-	 &error );
-
-	result = libqcow_file_get_format_version(
-	          file,
-	          NULL,
+	result = libbfio_memory_range_set(
+	          file_io_handle,
+	          export_data,
+	          (size_t) media_size,
 	          &error );
 
 	QCOW_TEST_ASSERT_EQUAL_INT(
 	 "result",
 	 result,
-	 -1 );
+	 1 );
 
-	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	QCOW_TEST_ASSERT_IS_NULL(
 	 "error",
 	 error );
 
-	libcerror_error_free(
-	 &error );
-
-	return( 1 );
+	result = libbfio_handle_open(
+	          file_io_handle,
+	          LIBBFIO_OPEN_WRITE,
+	          &error );
 
-on_error:
-	if( error != NULL )
-	{
-		libcerror_error_free(
-		 &error );
-	}
-	return( 0 );
-}
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
 
-/* Tests the libqcow_file_get_encryption_method function
- * Returns 1 if successful or 0 if not
- */
-int qcow_test_file_get_encryption_method(
-     libqcow_file_t *file )
-{
-	libcerror_error_t *error   = NULL;
-	uint32_t encryption_method = 0;
-	int result                 = 0;
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
 
 	/* Test regular cases
 	 */
-	result = libqcow_file_get_encryption_method(
+	result = libqcow_file_export_file_io_handle(
 	          file,
-	          &encryption_method,
+	          file_io_handle,
+	          LIBQCOW_EXPORT_FORMAT_RAW,
 	          &error );
 
 	QCOW_TEST_ASSERT_EQUAL_INT(
@@ -3365,11 +10499,48 @@ int qcow_test_file_get_encryption_method(
 	 "error",
 	 error );
 
+	while( (size64_t) offset < media_size )
+	{
+		read_size = QCOW_TEST_FILE_READ_BUFFER_SIZE;
+
+		if( (size64_t) read_size > ( media_size - offset ) )
+		{
+			read_size = (size_t) ( media_size - offset );
+		}
+		read_count = libqcow_file_read_buffer_at_offset(
+		              file,
+		              read_buffer,
+		              read_size,
+		              offset,
+		              &error );
+
+		QCOW_TEST_ASSERT_EQUAL_SSIZE(
+		 "read_count",
+		 read_count,
+		 (ssize_t) read_size );
+
+		QCOW_TEST_ASSERT_IS_NULL(
+		 "error",
+		 error );
+
+		result = memory_compare(
+		          read_buffer,
+		          &( export_data[ offset ] ),
+		          read_size );
+
+		QCOW_TEST_ASSERT_EQUAL_INT(
+		 "result",
+		 result,
+		 0 );
+
+		offset += (off64_t) read_size;
+	}
 	/* Test error cases
 	 */
-	result = libqcow_file_get_encryption_method(
+	result = libqcow_file_export_file_io_handle(
 	          NULL,
-	          &encryption_method,
+	          file_io_handle,
+	          LIBQCOW_EXPORT_FORMAT_RAW,
 	          &error );
 
 	QCOW_TEST_ASSERT_EQUAL_INT(
@@ -3384,9 +10555,28 @@ int qcow_test_file_get_encryption_method(
 	libcerror_error_free(
 	 &error );
 
-	result = libqcow_file_get_encryption_method(
+	result = libqcow_file_export_file_io_handle(
 	          file,
 	          NULL,
+	          LIBQCOW_EXPORT_FORMAT_RAW,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_file_export_file_io_handle(
+	          file,
+	          file_io_handle,
+	          -1,
 	          &error );
 
 	QCOW_TEST_ASSERT_EQUAL_INT(
@@ -3401,6 +10591,24 @@ int qcow_test_file_get_encryption_method(
 	libcerror_error_free(
 	 &error );
 
+	/* Clean up
+	 */
+	result = libbfio_handle_free(
+	          &file_io_handle,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	memory_free(
+	 export_data );
+
 	return( 1 );
 
 on_error:
@@ -3409,6 +10617,17 @@ on_error:
 		libcerror_error_free(
 		 &error );
 	}
+	if( file_io_handle != NULL )
+	{
+		libbfio_handle_free(
+		 &file_io_handle,
+		 NULL );
+	}
+	if( export_data != NULL )
+	{
+		memory_free(
+		 export_data );
+	}
 	return( 0 );
 }
 
@@ -3476,6 +10695,34 @@ int main(
 	 "libqcow_file_free",
 	 qcow_test_file_free );
 
+	QCOW_TEST_RUN(
+	 "libqcow_file_read_buffer_at_offset with zero cluster blocks",
+	 qcow_test_file_read_zero_cluster_blocks );
+
+	QCOW_TEST_RUN(
+	 "libqcow_file_read_buffer_at_offset with compressed cluster blocks",
+	 qcow_test_file_read_compressed_cluster_blocks );
+
+	QCOW_TEST_RUN(
+	 "libqcow_file_read_buffer_at_offset with cluster blocks stored in the parent file",
+	 qcow_test_file_read_parent_cluster_blocks );
+
+#if defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT )
+
+	QCOW_TEST_RUN(
+	 "libqcow_internal_file_get_published_cluster_block_offset",
+	 qcow_test_internal_file_get_published_cluster_block_offset );
+
+#endif /* defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT ) */
+
+#if defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT ) && defined( HAVE_QCOW_TEST_FILE_THREADS )
+
+	QCOW_TEST_RUN(
+	 "libqcow_file_read_buffer_at_offset_with_timeout stopped during the read",
+	 qcow_test_file_read_buffer_at_offset_with_timeout_stopped );
+
+#endif /* defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT ) && defined( HAVE_QCOW_TEST_FILE_THREADS ) */
+
 #if !defined( __BORLANDC__ ) || ( __BORLANDC__ >= 0x0560 )
 	if( source != NULL )
 	{
@@ -3552,6 +10799,12 @@ int main(
 
 #endif /* defined( HAVE_WIDE_CHARACTER_TYPE ) */
 
+		QCOW_TEST_RUN_WITH_ARGS(
+		 "libqcow_file_open_with_backing_chain",
+		 qcow_test_file_open_with_backing_chain,
+		 source,
+		 option_password );
+
 		QCOW_TEST_RUN_WITH_ARGS(
 		 "libqcow_file_open_file_io_handle",
 		 qcow_test_file_open_file_io_handle,
@@ -3604,6 +10857,20 @@ int main(
 	         "error",
 	         error );
 
+		result = qcow_test_file_open_data_file(
+		          source,
+		          file,
+		          &error );
+
+		QCOW_TEST_ASSERT_NOT_EQUAL_INT(
+		 "result",
+		 result,
+		 -1 );
+
+	        QCOW_TEST_ASSERT_IS_NULL(
+	         "error",
+	         error );
+
 		QCOW_TEST_RUN_WITH_ARGS(
 		 "libqcow_file_signal_abort",
 		 qcow_test_file_signal_abort,
@@ -3620,6 +10887,11 @@ int main(
 		 qcow_test_file_is_locked,
 		 file );
 
+		QCOW_TEST_RUN_WITH_ARGS(
+		 "libqcow_file_open_data_file_io_handle",
+		 qcow_test_file_open_data_file_io_handle,
+		 file );
+
 #if defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT )
 
 		QCOW_TEST_RUN_WITH_ARGS(
@@ -3639,6 +10911,44 @@ int main(
 		 qcow_test_file_read_buffer_at_offset,
 		 file );
 
+		QCOW_TEST_RUN_WITH_ARGS(
+		 "libqcow_file_read_buffer_at_offset_concurrent",
+		 qcow_test_file_read_buffer_at_offset_concurrent,
+		 file );
+
+#if defined( HAVE_QCOW_TEST_FILE_THREADS )
+
+		QCOW_TEST_RUN_WITH_ARGS(
+		 "libqcow_file_read_buffer_at_offset_concurrent from multiple threads",
+		 qcow_test_file_read_buffer_at_offset_concurrent_threaded,
+		 file );
+
+#endif /* defined( HAVE_QCOW_TEST_FILE_THREADS ) */
+
+		QCOW_TEST_RUN_WITH_ARGS(
+		 "libqcow_file_read_buffer_at_offset_with_timeout",
+		 qcow_test_file_read_buffer_at_offset_with_timeout,
+		 file );
+
+#if defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT )
+
+		QCOW_TEST_RUN_WITH_ARGS(
+		 "libqcow_internal_file_read_is_stopped",
+		 qcow_test_internal_file_read_is_stopped,
+		 file );
+
+		QCOW_TEST_RUN_WITH_ARGS(
+		 "libqcow_internal_file_read_buffer_at_offset",
+		 qcow_test_internal_file_read_buffer_at_offset,
+		 file );
+
+#endif /* defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT ) */
+
+		QCOW_TEST_RUN_WITH_ARGS(
+		 "libqcow_file_get_data_at_offset",
+		 qcow_test_file_get_data_at_offset,
+		 file );
+
 #if defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT )
 
 		/* TODO: add tests for libqcow_internal_file_write_buffer_to_file_io_handle */
@@ -3665,6 +10975,35 @@ int main(
 		 qcow_test_file_get_offset,
 		 file );
 
+		QCOW_TEST_RUN_WITH_ARGS(
+		 "libqcow_file_create_cursor",
+		 qcow_test_file_create_cursor,
+		 file );
+
+#if defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT )
+
+		QCOW_TEST_RUN_WITH_ARGS(
+		 "libqcow_internal_file_read_mapped_buffer_at_offset",
+		 qcow_test_internal_file_read_mapped_buffer_at_offset,
+		 file );
+
+#endif /* defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT ) */
+
+		QCOW_TEST_RUN_WITH_ARGS(
+		 "libqcow_file_read_async",
+		 qcow_test_file_read_async,
+		 file );
+
+		QCOW_TEST_RUN_WITH_ARGS(
+		 "libqcow_file_read_async_with_timeout",
+		 qcow_test_file_read_async_with_timeout,
+		 file );
+
+		QCOW_TEST_RUN_WITH_ARGS(
+		 "libqcow_file_scan",
+		 qcow_test_file_scan,
+		 file );
+
 		/* TODO: add tests for libqcow_file_set_keys */
 
 		/* TODO: add tests for libqcow_file_set_utf8_password */
@@ -3686,6 +11025,31 @@ int main(
 		 qcow_test_file_get_encryption_method,
 		 file );
 
+		QCOW_TEST_RUN_WITH_ARGS(
+		 "libqcow_file_get_utf8_data_filename_size",
+		 qcow_test_file_get_utf8_data_filename_size,
+		 file );
+
+		QCOW_TEST_RUN_WITH_ARGS(
+		 "libqcow_file_get_number_of_snapshots",
+		 qcow_test_file_get_number_of_snapshots,
+		 file );
+
+		QCOW_TEST_RUN_WITH_ARGS(
+		 "libqcow_file_get_snapshot_by_index",
+		 qcow_test_file_get_snapshot_by_index,
+		 file );
+
+		QCOW_TEST_RUN_WITH_ARGS(
+		 "libqcow_file_get_changed_extents",
+		 qcow_test_file_get_changed_extents,
+		 file );
+
+		QCOW_TEST_RUN_WITH_ARGS(
+		 "libqcow_file_export_file_io_handle",
+		 qcow_test_file_export_file_io_handle,
+		 file );
+
 		/* Clean up
 		 */
 		result = qcow_test_file_close_source(
@@ -0,0 +1,1068 @@
+/*
+ * Library mapping_index type test program
+ *
+ * Copyright (C) 2010-2026, Joachim Metz <joachim.metz@gmail.com>
+ *
+ * Refer to AUTHORS for acknowledgements.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <byte_stream.h>
+#include <common.h>
+#include <file_stream.h>
+#include <memory.h>
+#include <types.h>
+
+#if defined( HAVE_STDLIB_H ) || defined( WINAPI )
+#include <stdlib.h>
+#endif
+
+#include "qcow_test_libcerror.h"
+#include "qcow_test_libqcow.h"
+#include "qcow_test_macros.h"
+#include "qcow_test_memory.h"
+#include "qcow_test_unused.h"
+
+#include "../libqcow/libqcow_definitions.h"
+#include "../libqcow/libqcow_extent_index.h"
+#include "../libqcow/libqcow_mapping_index.h"
+#include "../libqcow/qcow_mapping_index.h"
+
+#if defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT )
+
+/* Creates mapping index data for an extent index of 2 level 2 tables
+ * where the first level 2 table contains 2 extents
+ * Returns 1 if successful or -1 on error
+ */
+int qcow_test_mapping_index_create_data(
+     libqcow_mapping_index_t *mapping_index )
+{
+	qcow_mapping_index_extent_t *mapping_index_extent = NULL;
+	qcow_mapping_index_header_t *mapping_index_header = NULL;
+	qcow_mapping_index_table_t *mapping_index_table   = NULL;
+	size_t data_size                                  = 0;
+
+	data_size = sizeof( qcow_mapping_index_header_t )
+	          + ( 2 * sizeof( qcow_mapping_index_table_t ) )
+	          + ( 2 * sizeof( qcow_mapping_index_extent_t ) );
+
+	mapping_index->data = (uint8_t *) memory_allocate(
+	                                   data_size );
+
+	if( mapping_index->data == NULL )
+	{
+		return( -1 );
+	}
+	mapping_index->data_size         = data_size;
+	mapping_index->data_is_mapped    = 0;
+	mapping_index->file_size         = 1048576;
+	mapping_index->modification_time = 1234567890;
+	mapping_index->header_hash       = 0x0123456789abcdefULL;
+
+	if( memory_set(
+	     mapping_index->data,
+	     0,
+	     data_size ) == NULL )
+	{
+		return( -1 );
+	}
+	mapping_index_header = (qcow_mapping_index_header_t *) mapping_index->data;
+
+	if( memory_copy(
+	     mapping_index_header->signature,
+	     qcow_mapping_index_signature,
+	     8 ) == NULL )
+	{
+		return( -1 );
+	}
+	byte_stream_copy_from_uint32_little_endian(
+	 mapping_index_header->format_version,
+	 4 );
+
+	byte_stream_copy_from_uint32_little_endian(
+	 mapping_index_header->header_size,
+	 (uint32_t) sizeof( qcow_mapping_index_header_t ) );
+
+	byte_stream_copy_from_uint64_little_endian(
+	 mapping_index_header->file_size,
+	 mapping_index->file_size );
+
+	byte_stream_copy_from_uint64_little_endian(
+	 mapping_index_header->modification_time,
+	 (uint64_t) mapping_index->modification_time );
+
+	byte_stream_copy_from_uint64_little_endian(
+	 mapping_index_header->header_hash,
+	 mapping_index->header_hash );
+
+	byte_stream_copy_from_uint64_little_endian(
+	 mapping_index_header->cluster_block_size,
+	 (uint64_t) 65536 );
+
+	byte_stream_copy_from_uint32_little_endian(
+	 mapping_index_header->number_of_level2_tables,
+	 2 );
+
+	byte_stream_copy_from_uint32_little_endian(
+	 mapping_index_header->number_of_level2_table_references,
+	 512 );
+
+	byte_stream_copy_from_uint32_little_endian(
+	 mapping_index_header->number_of_extents,
+	 2 );
+
+	byte_stream_copy_from_uint32_little_endian(
+	 mapping_index_header->extent_size,
+	 (uint32_t) sizeof( qcow_mapping_index_extent_t ) );
+
+	mapping_index_table = (qcow_mapping_index_table_t *) &( mapping_index->data[ sizeof( qcow_mapping_index_header_t ) ] );
+
+	byte_stream_copy_from_uint32_little_endian(
+	 mapping_index_table[ 0 ].flags,
+	 LIBQCOW_EXTENT_INDEX_TABLE_FLAG_IS_SCANNED );
+
+	byte_stream_copy_from_uint32_little_endian(
+	 mapping_index_table[ 0 ].number_of_extents,
+	 2 );
+
+	mapping_index_extent = (qcow_mapping_index_extent_t *) &( mapping_index->data[ sizeof( qcow_mapping_index_header_t ) + ( 2 * sizeof( qcow_mapping_index_table_t ) ) ] );
+
+	byte_stream_copy_from_uint32_little_endian(
+	 mapping_index_extent[ 0 ].first_cluster_block_index,
+	 8 );
+
+	byte_stream_copy_from_uint32_little_endian(
+	 mapping_index_extent[ 0 ].number_of_cluster_blocks,
+	 4 );
+
+	byte_stream_copy_from_uint64_little_endian(
+	 mapping_index_extent[ 0 ].cluster_block_offset,
+	 0x00050000UL );
+
+	byte_stream_copy_from_uint32_little_endian(
+	 mapping_index_extent[ 1 ].first_cluster_block_index,
+	 16 );
+
+	byte_stream_copy_from_uint32_little_endian(
+	 mapping_index_extent[ 1 ].number_of_cluster_blocks,
+	 2 );
+
+	byte_stream_copy_from_uint64_little_endian(
+	 mapping_index_extent[ 1 ].cluster_block_offset,
+	 0x00100000UL );
+
+	byte_stream_copy_from_uint32_little_endian(
+	 mapping_index_extent[ 1 ].cluster_block_flags,
+	 LIBQCOW_CLUSTER_BLOCK_FLAG_IS_ZERO );
+
+	return( 1 );
+}
+
+/* Tests the libqcow_mapping_index_initialize function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_mapping_index_initialize(
+     void )
+{
+	libcerror_error_t *error               = NULL;
+	libqcow_mapping_index_t *mapping_index = NULL;
+	int result                             = 0;
+
+#if defined( HAVE_QCOW_TEST_MEMORY )
+	int number_of_malloc_fail_tests        = 1;
+	int number_of_memset_fail_tests        = 1;
+	int test_number                        = 0;
+#endif
+
+	/* Test regular cases
+	 */
+	result = libqcow_mapping_index_initialize(
+	          &mapping_index,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "mapping_index",
+	 mapping_index );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_mapping_index_free(
+	          &mapping_index,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "mapping_index",
+	 mapping_index );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test error cases
+	 */
+	result = libqcow_mapping_index_initialize(
+	          NULL,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	mapping_index = (libqcow_mapping_index_t *) 0x12345678UL;
+
+	result = libqcow_mapping_index_initialize(
+	          &mapping_index,
+	          &error );
+
+	mapping_index = NULL;
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+#if defined( HAVE_QCOW_TEST_MEMORY )
+
+	for( test_number = 0;
+	     test_number < number_of_malloc_fail_tests;
+	     test_number++ )
+	{
+		/* Test libqcow_mapping_index_initialize with malloc failing
+		 */
+		qcow_test_malloc_attempts_before_fail = test_number;
+
+		result = libqcow_mapping_index_initialize(
+		          &mapping_index,
+		          &error );
+
+		if( qcow_test_malloc_attempts_before_fail != -1 )
+		{
+			qcow_test_malloc_attempts_before_fail = -1;
+
+			if( mapping_index != NULL )
+			{
+				libqcow_mapping_index_free(
+				 &mapping_index,
+				 NULL );
+			}
+		}
+		else
+		{
+			QCOW_TEST_ASSERT_EQUAL_INT(
+			 "result",
+			 result,
+			 -1 );
+
+			QCOW_TEST_ASSERT_IS_NULL(
+			 "mapping_index",
+			 mapping_index );
+
+			QCOW_TEST_ASSERT_IS_NOT_NULL(
+			 "error",
+			 error );
+
+			libcerror_error_free(
+			 &error );
+		}
+	}
+	for( test_number = 0;
+	     test_number < number_of_memset_fail_tests;
+	     test_number++ )
+	{
+		/* Test libqcow_mapping_index_initialize with memset failing
+		 */
+		qcow_test_memset_attempts_before_fail = test_number;
+
+		result = libqcow_mapping_index_initialize(
+		          &mapping_index,
+		          &error );
+
+		if( qcow_test_memset_attempts_before_fail != -1 )
+		{
+			qcow_test_memset_attempts_before_fail = -1;
+
+			if( mapping_index != NULL )
+			{
+				libqcow_mapping_index_free(
+				 &mapping_index,
+				 NULL );
+			}
+		}
+		else
+		{
+			QCOW_TEST_ASSERT_EQUAL_INT(
+			 "result",
+			 result,
+			 -1 );
+
+			QCOW_TEST_ASSERT_IS_NULL(
+			 "mapping_index",
+			 mapping_index );
+
+			QCOW_TEST_ASSERT_IS_NOT_NULL(
+			 "error",
+			 error );
+
+			libcerror_error_free(
+			 &error );
+		}
+	}
+#endif /* defined( HAVE_QCOW_TEST_MEMORY ) */
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	if( mapping_index != NULL )
+	{
+		libqcow_mapping_index_free(
+		 &mapping_index,
+		 NULL );
+	}
+	return( 0 );
+}
+
+/* Tests the libqcow_mapping_index_free function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_mapping_index_free(
+     void )
+{
+	libcerror_error_t *error = NULL;
+	int result               = 0;
+
+	/* Test error cases
+	 */
+	result = libqcow_mapping_index_free(
+	          NULL,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	return( 0 );
+}
+
+/* Tests the libqcow_mapping_index_read_data function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_mapping_index_read_data(
+     void )
+{
+	qcow_mapping_index_extent_t *mapping_index_extent = NULL;
+	qcow_mapping_index_header_t *mapping_index_header = NULL;
+	libcerror_error_t *error                          = NULL;
+	libqcow_extent_index_t *extent_index              = NULL;
+	libqcow_mapping_index_t *mapping_index            = NULL;
+	uint64_t cluster_block_offset                     = 0;
+	uint32_t cluster_block_flags                      = 0;
+	int result                                        = 0;
+
+	/* Initialize test
+	 */
+	result = libqcow_mapping_index_initialize(
+	          &mapping_index,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "mapping_index",
+	 mapping_index );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = qcow_test_mapping_index_create_data(
+	          mapping_index );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	result = libqcow_extent_index_initialize(
+	          &extent_index,
+	          2,
+	          512,
+	          65536,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "extent_index",
+	 extent_index );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test regular cases
+	 */
+	result = libqcow_mapping_index_read_data(
+	          mapping_index,
+	          extent_index,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_extent_index_is_level2_table_scanned(
+	          extent_index,
+	          0,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_extent_index_is_level2_table_scanned(
+	          extent_index,
+	          1,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_extent_index_get_cluster_block_by_index(
+	          extent_index,
+	          0,
+	          10,
+	          &cluster_block_offset,
+	          &cluster_block_flags,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT64(
+	 "cluster_block_offset",
+	 cluster_block_offset,
+	 (uint64_t) 0x00070000UL );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_extent_index_get_cluster_block_by_index(
+	          extent_index,
+	          0,
+	          17,
+	          &cluster_block_offset,
+	          &cluster_block_flags,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT64(
+	 "cluster_block_offset",
+	 cluster_block_offset,
+	 (uint64_t) 0x00110000UL );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT32(
+	 "cluster_block_flags",
+	 cluster_block_flags,
+	 (uint32_t) LIBQCOW_CLUSTER_BLOCK_FLAG_IS_ZERO );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test error cases
+	 */
+	result = libqcow_mapping_index_read_data(
+	          NULL,
+	          extent_index,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_mapping_index_read_data(
+	          mapping_index,
+	          NULL,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	/* Test read data on an extent index that already contains the level 2 table
+	 */
+	result = libqcow_mapping_index_read_data(
+	          mapping_index,
+	          extent_index,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	/* Clean up
+	 */
+	result = libqcow_extent_index_free(
+	          &extent_index,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test read data with a mapping index that does not match the image file
+	 */
+	result = libqcow_extent_index_initialize(
+	          &extent_index,
+	          2,
+	          512,
+	          65536,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	mapping_index->file_size = 2097152;
+
+	result = libqcow_mapping_index_read_data(
+	          mapping_index,
+	          extent_index,
+	          &error );
+
+	mapping_index->file_size = 1048576;
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test read data with an invalid signature
+	 */
+	mapping_index_header = (qcow_mapping_index_header_t *) mapping_index->data;
+
+	mapping_index_header->signature[ 0 ] = 0xff;
+
+	result = libqcow_mapping_index_read_data(
+	          mapping_index,
+	          extent_index,
+	          &error );
+
+	mapping_index_header->signature[ 0 ] = qcow_mapping_index_signature[ 0 ];
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test read data with a mapping index of a previous format version
+	 */
+	byte_stream_copy_from_uint32_little_endian(
+	 mapping_index_header->format_version,
+	 3 );
+
+	result = libqcow_mapping_index_read_data(
+	          mapping_index,
+	          extent_index,
+	          &error );
+
+	byte_stream_copy_from_uint32_little_endian(
+	 mapping_index_header->format_version,
+	 4 );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test read data with an invalid header size
+	 */
+	byte_stream_copy_from_uint32_little_endian(
+	 mapping_index_header->header_size,
+	 (uint32_t) sizeof( qcow_mapping_index_header_t ) + 4 );
+
+	result = libqcow_mapping_index_read_data(
+	          mapping_index,
+	          extent_index,
+	          &error );
+
+	byte_stream_copy_from_uint32_little_endian(
+	 mapping_index_header->header_size,
+	 (uint32_t) sizeof( qcow_mapping_index_header_t ) );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test read data with an invalid extent size
+	 */
+	byte_stream_copy_from_uint32_little_endian(
+	 mapping_index_header->extent_size,
+	 (uint32_t) sizeof( qcow_mapping_index_extent_t ) + 1 );
+
+	result = libqcow_mapping_index_read_data(
+	          mapping_index,
+	          extent_index,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test read data with truncated data
+	 */
+	byte_stream_copy_from_uint32_little_endian(
+	 mapping_index_header->extent_size,
+	 (uint32_t) sizeof( qcow_mapping_index_extent_t ) );
+
+	mapping_index->data_size -= 1;
+
+	result = libqcow_mapping_index_read_data(
+	          mapping_index,
+	          extent_index,
+	          &error );
+
+	mapping_index->data_size += 1;
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test read data with a negative first cluster block index
+	 */
+	mapping_index_extent = (qcow_mapping_index_extent_t *) &( mapping_index->data[ sizeof( qcow_mapping_index_header_t ) + ( 2 * sizeof( qcow_mapping_index_table_t ) ) ] );
+
+	byte_stream_copy_from_uint32_little_endian(
+	 mapping_index_extent[ 0 ].first_cluster_block_index,
+	 0xffffffffUL );
+
+	result = libqcow_mapping_index_read_data(
+	          mapping_index,
+	          extent_index,
+	          &error );
+
+	byte_stream_copy_from_uint32_little_endian(
+	 mapping_index_extent[ 0 ].first_cluster_block_index,
+	 8 );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test read data with an empty extent
+	 */
+	byte_stream_copy_from_uint32_little_endian(
+	 mapping_index_extent[ 0 ].number_of_cluster_blocks,
+	 0 );
+
+	result = libqcow_mapping_index_read_data(
+	          mapping_index,
+	          extent_index,
+	          &error );
+
+	byte_stream_copy_from_uint32_little_endian(
+	 mapping_index_extent[ 0 ].number_of_cluster_blocks,
+	 4 );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test read data with an extent beyond the level 2 table
+	 */
+	byte_stream_copy_from_uint32_little_endian(
+	 mapping_index_extent[ 1 ].number_of_cluster_blocks,
+	 497 );
+
+	result = libqcow_mapping_index_read_data(
+	          mapping_index,
+	          extent_index,
+	          &error );
+
+	byte_stream_copy_from_uint32_little_endian(
+	 mapping_index_extent[ 1 ].number_of_cluster_blocks,
+	 2 );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test read data with an extent of which the end overflows
+	 */
+	byte_stream_copy_from_uint32_little_endian(
+	 mapping_index_extent[ 1 ].number_of_cluster_blocks,
+	 INT_MAX );
+
+	result = libqcow_mapping_index_read_data(
+	          mapping_index,
+	          extent_index,
+	          &error );
+
+	byte_stream_copy_from_uint32_little_endian(
+	 mapping_index_extent[ 1 ].number_of_cluster_blocks,
+	 2 );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test read data with overlapping extents
+	 */
+	byte_stream_copy_from_uint32_little_endian(
+	 mapping_index_extent[ 1 ].first_cluster_block_index,
+	 10 );
+
+	result = libqcow_mapping_index_read_data(
+	          mapping_index,
+	          extent_index,
+	          &error );
+
+	byte_stream_copy_from_uint32_little_endian(
+	 mapping_index_extent[ 1 ].first_cluster_block_index,
+	 16 );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test read data with unsorted extents
+	 */
+	byte_stream_copy_from_uint32_little_endian(
+	 mapping_index_extent[ 1 ].first_cluster_block_index,
+	 2 );
+
+	result = libqcow_mapping_index_read_data(
+	          mapping_index,
+	          extent_index,
+	          &error );
+
+	byte_stream_copy_from_uint32_little_endian(
+	 mapping_index_extent[ 1 ].first_cluster_block_index,
+	 16 );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test read data with unsupported cluster block flags
+	 */
+	byte_stream_copy_from_uint32_little_endian(
+	 mapping_index_extent[ 1 ].cluster_block_flags,
+	 0x00000100UL );
+
+	result = libqcow_mapping_index_read_data(
+	          mapping_index,
+	          extent_index,
+	          &error );
+
+	byte_stream_copy_from_uint32_little_endian(
+	 mapping_index_extent[ 1 ].cluster_block_flags,
+	 LIBQCOW_CLUSTER_BLOCK_FLAG_IS_ZERO );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test read data with a compressed extent of multiple cluster blocks
+	 */
+	byte_stream_copy_from_uint32_little_endian(
+	 mapping_index_extent[ 0 ].cluster_block_flags,
+	 LIBQCOW_CLUSTER_BLOCK_FLAG_IS_COMPRESSED );
+
+	result = libqcow_mapping_index_read_data(
+	          mapping_index,
+	          extent_index,
+	          &error );
+
+	byte_stream_copy_from_uint32_little_endian(
+	 mapping_index_extent[ 0 ].cluster_block_flags,
+	 0 );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Clean up
+	 */
+	result = libqcow_extent_index_free(
+	          &extent_index,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_mapping_index_free(
+	          &mapping_index,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "mapping_index",
+	 mapping_index );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	if( extent_index != NULL )
+	{
+		libqcow_extent_index_free(
+		 &extent_index,
+		 NULL );
+	}
+	if( mapping_index != NULL )
+	{
+		libqcow_mapping_index_free(
+		 &mapping_index,
+		 NULL );
+	}
+	return( 0 );
+}
+
+#endif /* defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT ) */
+
+/* The main program
+ */
+#if defined( HAVE_WIDE_SYSTEM_CHARACTER )
+int wmain(
+     int argc QCOW_TEST_ATTRIBUTE_UNUSED,
+     wchar_t * const argv[] QCOW_TEST_ATTRIBUTE_UNUSED )
+#else
+int main(
+     int argc QCOW_TEST_ATTRIBUTE_UNUSED,
+     char * const argv[] QCOW_TEST_ATTRIBUTE_UNUSED )
+#endif
+{
+	QCOW_TEST_UNREFERENCED_PARAMETER( argc )
+	QCOW_TEST_UNREFERENCED_PARAMETER( argv )
+
+#if defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT )
+
+	QCOW_TEST_RUN(
+	 "libqcow_mapping_index_initialize",
+	 qcow_test_mapping_index_initialize );
+
+	QCOW_TEST_RUN(
+	 "libqcow_mapping_index_free",
+	 qcow_test_mapping_index_free );
+
+	QCOW_TEST_RUN(
+	 "libqcow_mapping_index_read_data",
+	 qcow_test_mapping_index_read_data );
+
+#endif /* defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT ) */
+
+	return( EXIT_SUCCESS );
+
+on_error:
+	return( EXIT_FAILURE );
+}
+
@@ -0,0 +1,462 @@
+/*
+ * Library read_control functions test program
+ *
+ * Copyright (C) 2010-2026, Joachim Metz <joachim.metz@gmail.com>
+ *
+ * Refer to AUTHORS for acknowledgements.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <common.h>
+#include <memory.h>
+#include <types.h>
+
+#if defined( HAVE_STDLIB_H ) || defined( WINAPI )
+#include <stdlib.h>
+#endif
+
+#include "qcow_test_libcerror.h"
+#include "qcow_test_libqcow.h"
+#include "qcow_test_macros.h"
+#include "qcow_test_unused.h"
+
+#include "../libqcow/libqcow_read_control.h"
+
+#if defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT )
+
+/* Tests the libqcow_read_control_get_current_time function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_read_control_get_current_time(
+     void )
+{
+	libcerror_error_t *error = NULL;
+	uint64_t current_time    = 0;
+	uint64_t previous_time   = 0;
+	int result               = 0;
+
+	/* Test regular cases
+	 */
+	result = libqcow_read_control_get_current_time(
+	          &previous_time,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_read_control_get_current_time(
+	          &current_time,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* The clock is monotonic
+	 */
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "current_time >= previous_time",
+	 (int) ( current_time >= previous_time ),
+	 1 );
+
+	/* Test error cases
+	 */
+	result = libqcow_read_control_get_current_time(
+	          NULL,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	return( 0 );
+}
+
+/* Tests the libqcow_read_control_set_timeout function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_read_control_set_timeout(
+     void )
+{
+	libcerror_error_t *error            = NULL;
+	libqcow_read_control_t read_control;
+	uint64_t current_time               = 0;
+	int result                          = 0;
+
+	if( memory_set(
+	     &read_control,
+	     0,
+	     sizeof( libqcow_read_control_t ) ) == NULL )
+	{
+		return( 0 );
+	}
+	/* Test regular cases
+	 */
+	result = libqcow_read_control_get_current_time(
+	          &current_time,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_read_control_set_timeout(
+	          &read_control,
+	          60000,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "read_control.deadline >= current_time + 60000",
+	 (int) ( read_control.deadline >= ( current_time + 60000 ) ),
+	 1 );
+
+	/* A timeout of 0 removes the deadline
+	 */
+	result = libqcow_read_control_set_timeout(
+	          &read_control,
+	          0,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	QCOW_TEST_ASSERT_EQUAL_UINT64(
+	 "read_control.deadline",
+	 read_control.deadline,
+	 (uint64_t) 0 );
+
+	/* Test error cases
+	 */
+	result = libqcow_read_control_set_timeout(
+	          NULL,
+	          60000,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	return( 0 );
+}
+
+/* Tests the libqcow_read_control_cancel function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_read_control_cancel(
+     void )
+{
+	libcerror_error_t *error            = NULL;
+	libqcow_read_control_t read_control;
+	int result                          = 0;
+
+	if( memory_set(
+	     &read_control,
+	     0,
+	     sizeof( libqcow_read_control_t ) ) == NULL )
+	{
+		return( 0 );
+	}
+	/* Test regular cases
+	 */
+	result = libqcow_read_control_cancel(
+	          &read_control,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	QCOW_TEST_ASSERT_NOT_EQUAL_INT(
+	 "read_control.cancelled",
+	 read_control.cancelled,
+	 0 );
+
+	/* Test error cases
+	 */
+	result = libqcow_read_control_cancel(
+	          NULL,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	return( 0 );
+}
+
+/* Tests the libqcow_read_control_is_stopped function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_read_control_is_stopped(
+     void )
+{
+	libcerror_error_t *error            = NULL;
+	libqcow_read_control_t read_control;
+	int result                          = 0;
+
+	if( memory_set(
+	     &read_control,
+	     0,
+	     sizeof( libqcow_read_control_t ) ) == NULL )
+	{
+		return( 0 );
+	}
+	/* Test regular cases
+	 */
+	result = libqcow_read_control_is_stopped(
+	          &read_control,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* A deadline in the future does not stop the read
+	 */
+	result = libqcow_read_control_set_timeout(
+	          &read_control,
+	          60000,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_read_control_is_stopped(
+	          &read_control,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 0 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* A deadline in the past stops the read
+	 */
+	read_control.deadline = 1;
+
+	result = libqcow_read_control_is_stopped(
+	          &read_control,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* A cancelled read is stopped regardless of the deadline
+	 */
+	read_control.deadline = 0;
+
+	result = libqcow_read_control_cancel(
+	          &read_control,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_read_control_is_stopped(
+	          &read_control,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test error cases
+	 */
+	result = libqcow_read_control_is_stopped(
+	          NULL,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	return( 0 );
+}
+
+#endif /* defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT ) */
+
+/* The main program
+ */
+#if defined( HAVE_WIDE_SYSTEM_CHARACTER )
+int wmain(
+     int argc QCOW_TEST_ATTRIBUTE_UNUSED,
+     wchar_t * const argv[] QCOW_TEST_ATTRIBUTE_UNUSED )
+#else
+int main(
+     int argc QCOW_TEST_ATTRIBUTE_UNUSED,
+     char * const argv[] QCOW_TEST_ATTRIBUTE_UNUSED )
+#endif
+{
+	QCOW_TEST_UNREFERENCED_PARAMETER( argc )
+	QCOW_TEST_UNREFERENCED_PARAMETER( argv )
+
+#if defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT )
+
+	QCOW_TEST_RUN(
+	 "libqcow_read_control_get_current_time",
+	 qcow_test_read_control_get_current_time );
+
+	QCOW_TEST_RUN(
+	 "libqcow_read_control_set_timeout",
+	 qcow_test_read_control_set_timeout );
+
+	QCOW_TEST_RUN(
+	 "libqcow_read_control_cancel",
+	 qcow_test_read_control_cancel );
+
+	QCOW_TEST_RUN(
+	 "libqcow_read_control_is_stopped",
+	 qcow_test_read_control_is_stopped );
+
+#endif /* defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT ) */
+
+	return( EXIT_SUCCESS );
+
+on_error:
+	return( EXIT_FAILURE );
+}
+
@@ -0,0 +1,942 @@
+/*
+ * Library scanner type test program
+ *
+ * Copyright (C) 2010-2026, Joachim Metz <joachim.metz@gmail.com>
+ *
+ * Refer to AUTHORS for acknowledgements.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <common.h>
+#include <memory.h>
+#include <types.h>
+
+#if defined( HAVE_STDLIB_H ) || defined( WINAPI )
+#include <stdlib.h>
+#endif
+
+#include "qcow_test_libcerror.h"
+#include "qcow_test_libqcow.h"
+#include "qcow_test_macros.h"
+#include "qcow_test_memory.h"
+#include "qcow_test_unused.h"
+
+#include "../libqcow/libqcow_definitions.h"
+#include "../libqcow/libqcow_scanner.h"
+
+#if defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT )
+
+/* Callback function that counts the chunks
+ * Returns 1
+ */
+int qcow_test_scanner_callback(
+     off64_t offset QCOW_TEST_ATTRIBUTE_UNUSED,
+     const uint8_t *data QCOW_TEST_ATTRIBUTE_UNUSED,
+     size_t data_size QCOW_TEST_ATTRIBUTE_UNUSED,
+     void *callback_data )
+{
+	QCOW_TEST_UNREFERENCED_PARAMETER( offset )
+	QCOW_TEST_UNREFERENCED_PARAMETER( data )
+	QCOW_TEST_UNREFERENCED_PARAMETER( data_size )
+
+	if( callback_data != NULL )
+	{
+		*( (int *) callback_data ) += 1;
+	}
+	return( 1 );
+}
+
+/* Tests the libqcow_scan_chunk_initialize function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_scan_chunk_initialize(
+     void )
+{
+	libcerror_error_t *error         = NULL;
+	libqcow_scan_chunk_t *scan_chunk = NULL;
+	int result                       = 0;
+
+#if defined( HAVE_QCOW_TEST_MEMORY )
+	int number_of_malloc_fail_tests  = 2;
+	int number_of_memset_fail_tests  = 1;
+	int test_number                  = 0;
+#endif
+
+	/* Test regular cases
+	 */
+	result = libqcow_scan_chunk_initialize(
+	          &scan_chunk,
+	          4096,
+	          1000,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "scan_chunk",
+	 scan_chunk );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT64(
+	 "scan_chunk->offset",
+	 (int64_t) scan_chunk->offset,
+	 (int64_t) 4096 );
+
+	QCOW_TEST_ASSERT_EQUAL_SIZE(
+	 "scan_chunk->data_size",
+	 scan_chunk->data_size,
+	 (size_t) 1000 );
+
+	result = libqcow_scan_chunk_free(
+	          &scan_chunk,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "scan_chunk",
+	 scan_chunk );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test error cases
+	 */
+	result = libqcow_scan_chunk_initialize(
+	          NULL,
+	          4096,
+	          1000,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	scan_chunk = (libqcow_scan_chunk_t *) 0x12345678UL;
+
+	result = libqcow_scan_chunk_initialize(
+	          &scan_chunk,
+	          4096,
+	          1000,
+	          &error );
+
+	scan_chunk = NULL;
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_scan_chunk_initialize(
+	          &scan_chunk,
+	          -1,
+	          1000,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "scan_chunk",
+	 scan_chunk );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_scan_chunk_initialize(
+	          &scan_chunk,
+	          4096,
+	          0,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "scan_chunk",
+	 scan_chunk );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+#if defined( HAVE_QCOW_TEST_MEMORY )
+
+	for( test_number = 0;
+	     test_number < number_of_malloc_fail_tests;
+	     test_number++ )
+	{
+		/* Test libqcow_scan_chunk_initialize with malloc failing
+		 */
+		qcow_test_malloc_attempts_before_fail = test_number;
+
+		result = libqcow_scan_chunk_initialize(
+		          &scan_chunk,
+		          4096,
+		          1000,
+		          &error );
+
+		if( qcow_test_malloc_attempts_before_fail != -1 )
+		{
+			qcow_test_malloc_attempts_before_fail = -1;
+
+			if( scan_chunk != NULL )
+			{
+				libqcow_scan_chunk_free(
+				 &scan_chunk,
+				 NULL );
+			}
+		}
+		else
+		{
+			QCOW_TEST_ASSERT_EQUAL_INT(
+			 "result",
+			 result,
+			 -1 );
+
+			QCOW_TEST_ASSERT_IS_NULL(
+			 "scan_chunk",
+			 scan_chunk );
+
+			QCOW_TEST_ASSERT_IS_NOT_NULL(
+			 "error",
+			 error );
+
+			libcerror_error_free(
+			 &error );
+		}
+	}
+	for( test_number = 0;
+	     test_number < number_of_memset_fail_tests;
+	     test_number++ )
+	{
+		/* Test libqcow_scan_chunk_initialize with memset failing
+		 */
+		qcow_test_memset_attempts_before_fail = test_number;
+
+		result = libqcow_scan_chunk_initialize(
+		          &scan_chunk,
+		          4096,
+		          1000,
+		          &error );
+
+		if( qcow_test_memset_attempts_before_fail != -1 )
+		{
+			qcow_test_memset_attempts_before_fail = -1;
+
+			if( scan_chunk != NULL )
+			{
+				libqcow_scan_chunk_free(
+				 &scan_chunk,
+				 NULL );
+			}
+		}
+		else
+		{
+			QCOW_TEST_ASSERT_EQUAL_INT(
+			 "result",
+			 result,
+			 -1 );
+
+			QCOW_TEST_ASSERT_IS_NULL(
+			 "scan_chunk",
+			 scan_chunk );
+
+			QCOW_TEST_ASSERT_IS_NOT_NULL(
+			 "error",
+			 error );
+
+			libcerror_error_free(
+			 &error );
+		}
+	}
+#endif /* defined( HAVE_QCOW_TEST_MEMORY ) */
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	if( scan_chunk != NULL )
+	{
+		libqcow_scan_chunk_free(
+		 &scan_chunk,
+		 NULL );
+	}
+	return( 0 );
+}
+
+/* Tests the libqcow_scan_chunk_free function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_scan_chunk_free(
+     void )
+{
+	libcerror_error_t *error = NULL;
+	int result               = 0;
+
+	/* Test error cases
+	 */
+	result = libqcow_scan_chunk_free(
+	          NULL,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	return( 0 );
+}
+
+/* Tests the libqcow_scanner_initialize function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_scanner_initialize(
+     void )
+{
+	libcerror_error_t *error   = NULL;
+	libqcow_file_t *file       = NULL;
+	libqcow_scanner_t *scanner = NULL;
+	int result                 = 0;
+
+	/* Initialize test
+	 */
+	result = libqcow_file_initialize(
+	          &file,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "file",
+	 file );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test regular cases
+	 */
+	result = libqcow_scanner_initialize(
+	          &scanner,
+	          file,
+	          &qcow_test_scanner_callback,
+	          NULL,
+	          0,
+	          0,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "scanner",
+	 scanner );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "scanner->maximum_number_of_chunks",
+	 scanner->maximum_number_of_chunks,
+	 LIBQCOW_SCAN_NUMBER_OF_THREADS * LIBQCOW_SCAN_NUMBER_OF_CHUNKS_PER_THREAD );
+
+	result = libqcow_scanner_free(
+	          &scanner,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "scanner",
+	 scanner );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_scanner_initialize(
+	          &scanner,
+	          file,
+	          &qcow_test_scanner_callback,
+	          NULL,
+	          1,
+	          LIBQCOW_SCAN_FLAG_UNORDERED,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "scanner",
+	 scanner );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "scanner->maximum_number_of_chunks",
+	 scanner->maximum_number_of_chunks,
+	 LIBQCOW_SCAN_NUMBER_OF_CHUNKS_PER_THREAD );
+
+	result = libqcow_scanner_free(
+	          &scanner,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test error cases
+	 */
+	result = libqcow_scanner_initialize(
+	          NULL,
+	          file,
+	          &qcow_test_scanner_callback,
+	          NULL,
+	          0,
+	          0,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	scanner = (libqcow_scanner_t *) 0x12345678UL;
+
+	result = libqcow_scanner_initialize(
+	          &scanner,
+	          file,
+	          &qcow_test_scanner_callback,
+	          NULL,
+	          0,
+	          0,
+	          &error );
+
+	scanner = NULL;
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_scanner_initialize(
+	          &scanner,
+	          NULL,
+	          &qcow_test_scanner_callback,
+	          NULL,
+	          0,
+	          0,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_scanner_initialize(
+	          &scanner,
+	          file,
+	          NULL,
+	          NULL,
+	          0,
+	          0,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_scanner_initialize(
+	          &scanner,
+	          file,
+	          &qcow_test_scanner_callback,
+	          NULL,
+	          -1,
+	          0,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_scanner_initialize(
+	          &scanner,
+	          file,
+	          &qcow_test_scanner_callback,
+	          NULL,
+	          LIBQCOW_SCAN_MAXIMUM_NUMBER_OF_THREADS + 1,
+	          0,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_scanner_initialize(
+	          &scanner,
+	          file,
+	          &qcow_test_scanner_callback,
+	          NULL,
+	          0,
+	          0x80,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	/* Clean up
+	 */
+	result = libqcow_file_free(
+	          &file,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	if( scanner != NULL )
+	{
+		libqcow_scanner_free(
+		 &scanner,
+		 NULL );
+	}
+	if( file != NULL )
+	{
+		libqcow_file_free(
+		 &file,
+		 NULL );
+	}
+	return( 0 );
+}
+
+/* Tests the libqcow_scanner_free function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_scanner_free(
+     void )
+{
+	libcerror_error_t *error = NULL;
+	int result               = 0;
+
+	/* Test error cases
+	 */
+	result = libqcow_scanner_free(
+	          NULL,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	return( 0 );
+}
+
+/* Tests the libqcow_scanner_push_chunk and libqcow_scanner_finalize functions
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_scanner_push_chunk(
+     void )
+{
+	libcerror_error_t *error   = NULL;
+	libqcow_file_t *file       = NULL;
+	libqcow_scanner_t *scanner = NULL;
+	int number_of_chunks       = 0;
+	int result                 = 0;
+
+	/* Initialize test
+	 */
+	result = libqcow_file_initialize(
+	          &file,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_scanner_initialize(
+	          &scanner,
+	          file,
+	          &qcow_test_scanner_callback,
+	          &number_of_chunks,
+	          1,
+	          0,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test error cases
+	 */
+	result = libqcow_scanner_push_chunk(
+	          NULL,
+	          0,
+	          512,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_scanner_push_chunk(
+	          scanner,
+	          -1,
+	          512,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	/* The chunk cannot be read since the file is not open
+	 * hence the error is returned when the scan is finalized
+	 */
+	result = libqcow_scanner_push_chunk(
+	          scanner,
+	          0,
+	          512,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_scanner_finalize(
+	          scanner,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "number_of_chunks",
+	 number_of_chunks,
+	 0 );
+
+	result = libqcow_scanner_finalize(
+	          NULL,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	/* Clean up
+	 */
+	result = libqcow_scanner_free(
+	          &scanner,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_file_free(
+	          &file,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	if( scanner != NULL )
+	{
+		libqcow_scanner_free(
+		 &scanner,
+		 NULL );
+	}
+	if( file != NULL )
+	{
+		libqcow_file_free(
+		 &file,
+		 NULL );
+	}
+	return( 0 );
+}
+
+#endif /* defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT ) */
+
+/* The main program
+ */
+#if defined( HAVE_WIDE_SYSTEM_CHARACTER )
+int wmain(
+     int argc QCOW_TEST_ATTRIBUTE_UNUSED,
+     wchar_t * const argv[] QCOW_TEST_ATTRIBUTE_UNUSED )
+#else
+int main(
+     int argc QCOW_TEST_ATTRIBUTE_UNUSED,
+     char * const argv[] QCOW_TEST_ATTRIBUTE_UNUSED )
+#endif
+{
+	QCOW_TEST_UNREFERENCED_PARAMETER( argc )
+	QCOW_TEST_UNREFERENCED_PARAMETER( argv )
+
+#if defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT )
+
+	QCOW_TEST_RUN(
+	 "libqcow_scan_chunk_initialize",
+	 qcow_test_scan_chunk_initialize );
+
+	QCOW_TEST_RUN(
+	 "libqcow_scan_chunk_free",
+	 qcow_test_scan_chunk_free );
+
+	QCOW_TEST_RUN(
+	 "libqcow_scanner_initialize",
+	 qcow_test_scanner_initialize );
+
+	QCOW_TEST_RUN(
+	 "libqcow_scanner_free",
+	 qcow_test_scanner_free );
+
+	QCOW_TEST_RUN(
+	 "libqcow_scanner_push_chunk",
+	 qcow_test_scanner_push_chunk );
+
+#endif /* defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT ) */
+
+	return( EXIT_SUCCESS );
+
+#if defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT )
+
+on_error:
+	return( EXIT_FAILURE );
+
+#endif /* defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT ) */
+}
+
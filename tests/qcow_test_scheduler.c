@@ -0,0 +1,1034 @@
+/*
+ * Library scheduler type test program
+ *
+ * Copyright (C) 2010-2026, Joachim Metz <joachim.metz@gmail.com>
+ *
+ * Refer to AUTHORS for acknowledgements.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <common.h>
+#include <memory.h>
+#include <types.h>
+
+#if defined( HAVE_STDLIB_H ) || defined( WINAPI )
+#include <stdlib.h>
+#endif
+
+#include "qcow_test_libcerror.h"
+#include "qcow_test_libqcow.h"
+#include "qcow_test_macros.h"
+#include "qcow_test_memory.h"
+#include "qcow_test_unused.h"
+
+#include "../libqcow/libqcow_definitions.h"
+#include "../libqcow/libqcow_scheduler.h"
+
+#define QCOW_TEST_SCHEDULER_NUMBER_OF_JOBS	64
+
+/* Tests the libqcow_scheduler_initialize function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_scheduler_initialize(
+     void )
+{
+	libcerror_error_t *error       = NULL;
+	libqcow_scheduler_t *scheduler = NULL;
+	int result                     = 0;
+
+	/* Test regular cases
+	 */
+	result = libqcow_scheduler_initialize(
+	          &scheduler,
+	          2,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "scheduler",
+	 scheduler );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_scheduler_free(
+	          &scheduler,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "scheduler",
+	 scheduler );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test error cases
+	 */
+	result = libqcow_scheduler_initialize(
+	          NULL,
+	          2,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	scheduler = (libqcow_scheduler_t *) 0x12345678UL;
+
+	result = libqcow_scheduler_initialize(
+	          &scheduler,
+	          2,
+	          &error );
+
+	scheduler = NULL;
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_scheduler_initialize(
+	          &scheduler,
+	          -1,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "scheduler",
+	 scheduler );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_scheduler_initialize(
+	          &scheduler,
+	          LIBQCOW_SCHEDULER_MAXIMUM_NUMBER_OF_THREADS + 1,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "scheduler",
+	 scheduler );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	if( scheduler != NULL )
+	{
+		libqcow_scheduler_free(
+		 &scheduler,
+		 NULL );
+	}
+	return( 0 );
+}
+
+/* Tests the libqcow_scheduler_free function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_scheduler_free(
+     void )
+{
+	libcerror_error_t *error = NULL;
+	int result               = 0;
+
+	/* Test error cases
+	 */
+	result = libqcow_scheduler_free(
+	          NULL,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	return( 0 );
+}
+
+/* Tests the libqcow_scheduler_get_number_of_threads function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_scheduler_get_number_of_threads(
+     void )
+{
+	libcerror_error_t *error       = NULL;
+	libqcow_scheduler_t *scheduler = NULL;
+	int number_of_threads          = 0;
+	int result                     = 0;
+
+	/* Initialize test
+	 */
+	result = libqcow_scheduler_initialize(
+	          &scheduler,
+	          0,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "scheduler",
+	 scheduler );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test regular cases
+	 */
+	result = libqcow_scheduler_get_number_of_threads(
+	          scheduler,
+	          &number_of_threads,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "number_of_threads",
+	 number_of_threads,
+	 LIBQCOW_SCHEDULER_NUMBER_OF_THREADS );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test error cases
+	 */
+	result = libqcow_scheduler_get_number_of_threads(
+	          NULL,
+	          &number_of_threads,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_scheduler_get_number_of_threads(
+	          scheduler,
+	          NULL,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	/* Clean up
+	 */
+	result = libqcow_scheduler_free(
+	          &scheduler,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "scheduler",
+	 scheduler );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	if( scheduler != NULL )
+	{
+		libqcow_scheduler_free(
+		 &scheduler,
+		 NULL );
+	}
+	return( 0 );
+}
+
+#if defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT )
+
+/* The scheduler job test callback, marks the job as run
+ * Returns 1 if successful or -1 on error
+ */
+int qcow_test_scheduler_job_callback(
+     intptr_t *value,
+     void *arguments QCOW_TEST_ATTRIBUTE_UNUSED )
+{
+	QCOW_TEST_UNREFERENCED_PARAMETER( arguments )
+
+	if( value == NULL )
+	{
+		return( -1 );
+	}
+	*( (uint8_t *) value ) += 1;
+
+	return( 1 );
+}
+
+/* Tests the libqcow_scheduler_push_job function
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_scheduler_push_job(
+     void )
+{
+	uint8_t job_values[ QCOW_TEST_SCHEDULER_NUMBER_OF_JOBS ];
+
+	libcerror_error_t *error                         = NULL;
+	libqcow_scheduler_queue_t *scheduler_queues[ 2 ] = { NULL, NULL };
+	libqcow_scheduler_t *scheduler                   = NULL;
+	int job_index                                    = 0;
+	int queue_index                                  = 0;
+	int result                                       = 0;
+
+	/* Initialize test
+	 */
+	result = libqcow_scheduler_initialize(
+	          &scheduler,
+	          2,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "scheduler",
+	 scheduler );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	for( queue_index = 0;
+	     queue_index < 2;
+	     queue_index++ )
+	{
+		result = libqcow_scheduler_queue_initialize(
+		          &( scheduler_queues[ queue_index ] ),
+		          4 * queue_index,
+		          &error );
+
+		QCOW_TEST_ASSERT_EQUAL_INT(
+		 "result",
+		 result,
+		 1 );
+
+		QCOW_TEST_ASSERT_IS_NOT_NULL(
+		 "scheduler_queue",
+		 scheduler_queues[ queue_index ] );
+
+		QCOW_TEST_ASSERT_IS_NULL(
+		 "error",
+		 error );
+	}
+	memory_set(
+	 job_values,
+	 0,
+	 sizeof( uint8_t ) * QCOW_TEST_SCHEDULER_NUMBER_OF_JOBS );
+
+	/* Test regular cases
+	 * Interleave the jobs of a queue without a maximum and a queue with a maximum
+	 */
+	for( job_index = 0;
+	     job_index < QCOW_TEST_SCHEDULER_NUMBER_OF_JOBS;
+	     job_index++ )
+	{
+		result = libqcow_scheduler_push_job(
+		          scheduler,
+		          scheduler_queues[ job_index % 2 ],
+		          &qcow_test_scheduler_job_callback,
+		          (intptr_t *) &( job_values[ job_index ] ),
+		          NULL,
+		          &error );
+
+		QCOW_TEST_ASSERT_EQUAL_INT(
+		 "result",
+		 result,
+		 1 );
+
+		QCOW_TEST_ASSERT_IS_NULL(
+		 "error",
+		 error );
+	}
+	for( queue_index = 0;
+	     queue_index < 2;
+	     queue_index++ )
+	{
+		result = libqcow_scheduler_wait_for_queue(
+		          scheduler,
+		          scheduler_queues[ queue_index ],
+		          &error );
+
+		QCOW_TEST_ASSERT_EQUAL_INT(
+		 "result",
+		 result,
+		 1 );
+
+		QCOW_TEST_ASSERT_IS_NULL(
+		 "error",
+		 error );
+	}
+	for( job_index = 0;
+	     job_index < QCOW_TEST_SCHEDULER_NUMBER_OF_JOBS;
+	     job_index++ )
+	{
+		QCOW_TEST_ASSERT_EQUAL_UINT8(
+		 "job_value",
+		 job_values[ job_index ],
+		 (uint8_t) 1 );
+	}
+	/* Test error cases
+	 */
+	result = libqcow_scheduler_push_job(
+	          NULL,
+	          scheduler_queues[ 0 ],
+	          &qcow_test_scheduler_job_callback,
+	          (intptr_t *) &( job_values[ 0 ] ),
+	          NULL,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_scheduler_push_job(
+	          scheduler,
+	          NULL,
+	          &qcow_test_scheduler_job_callback,
+	          (intptr_t *) &( job_values[ 0 ] ),
+	          NULL,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_scheduler_push_job(
+	          scheduler,
+	          scheduler_queues[ 0 ],
+	          NULL,
+	          (intptr_t *) &( job_values[ 0 ] ),
+	          NULL,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	/* Clean up
+	 */
+	for( queue_index = 0;
+	     queue_index < 2;
+	     queue_index++ )
+	{
+		result = libqcow_scheduler_queue_free(
+		          &( scheduler_queues[ queue_index ] ),
+		          &error );
+
+		QCOW_TEST_ASSERT_EQUAL_INT(
+		 "result",
+		 result,
+		 1 );
+
+		QCOW_TEST_ASSERT_IS_NULL(
+		 "scheduler_queue",
+		 scheduler_queues[ queue_index ] );
+
+		QCOW_TEST_ASSERT_IS_NULL(
+		 "error",
+		 error );
+	}
+	result = libqcow_scheduler_free(
+	          &scheduler,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "scheduler",
+	 scheduler );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	if( scheduler != NULL )
+	{
+		for( queue_index = 0;
+		     queue_index < 2;
+		     queue_index++ )
+		{
+			if( scheduler_queues[ queue_index ] != NULL )
+			{
+				libqcow_scheduler_wait_for_queue(
+				 scheduler,
+				 scheduler_queues[ queue_index ],
+				 NULL );
+			}
+		}
+		libqcow_scheduler_free(
+		 &scheduler,
+		 NULL );
+	}
+	for( queue_index = 0;
+	     queue_index < 2;
+	     queue_index++ )
+	{
+		if( scheduler_queues[ queue_index ] != NULL )
+		{
+			libqcow_scheduler_queue_free(
+			 &( scheduler_queues[ queue_index ] ),
+			 NULL );
+		}
+	}
+	return( 0 );
+}
+
+/* Tests the libqcow_scheduler_batch functions
+ * Returns 1 if successful or 0 if not
+ */
+int qcow_test_scheduler_batch(
+     void )
+{
+	uint8_t job_values[ QCOW_TEST_SCHEDULER_NUMBER_OF_JOBS ];
+
+	libcerror_error_t *error                   = NULL;
+	libqcow_scheduler_batch_t *scheduler_batch = NULL;
+	libqcow_scheduler_queue_t *scheduler_queue = NULL;
+	libqcow_scheduler_t *scheduler             = NULL;
+	int job_index                              = 0;
+	int pass_index                             = 0;
+	int result                                 = 0;
+
+	/* Initialize test
+	 */
+	result = libqcow_scheduler_initialize(
+	          &scheduler,
+	          2,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "scheduler",
+	 scheduler );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_scheduler_queue_initialize(
+	          &scheduler_queue,
+	          0,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "scheduler_queue",
+	 scheduler_queue );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	/* Test regular cases
+	 * The first pass runs the jobs on the scheduler, the second pass runs the jobs when they are pushed
+	 */
+	for( pass_index = 0;
+	     pass_index < 2;
+	     pass_index++ )
+	{
+		if( pass_index == 0 )
+		{
+			result = libqcow_scheduler_batch_initialize(
+			          &scheduler_batch,
+			          scheduler,
+			          scheduler_queue,
+			          &error );
+		}
+		else
+		{
+			result = libqcow_scheduler_batch_initialize(
+			          &scheduler_batch,
+			          NULL,
+			          NULL,
+			          &error );
+		}
+		QCOW_TEST_ASSERT_EQUAL_INT(
+		 "result",
+		 result,
+		 1 );
+
+		QCOW_TEST_ASSERT_IS_NOT_NULL(
+		 "scheduler_batch",
+		 scheduler_batch );
+
+		QCOW_TEST_ASSERT_IS_NULL(
+		 "error",
+		 error );
+
+		memory_set(
+		 job_values,
+		 0,
+		 sizeof( uint8_t ) * QCOW_TEST_SCHEDULER_NUMBER_OF_JOBS );
+
+		for( job_index = 0;
+		     job_index < QCOW_TEST_SCHEDULER_NUMBER_OF_JOBS;
+		     job_index++ )
+		{
+			result = libqcow_scheduler_batch_push_job(
+			          scheduler_batch,
+			          &qcow_test_scheduler_job_callback,
+			          (intptr_t *) &( job_values[ job_index ] ),
+			          NULL,
+			          &error );
+
+			QCOW_TEST_ASSERT_EQUAL_INT(
+			 "result",
+			 result,
+			 1 );
+
+			QCOW_TEST_ASSERT_IS_NULL(
+			 "error",
+			 error );
+		}
+		result = libqcow_scheduler_batch_wait(
+		          scheduler_batch,
+		          &error );
+
+		QCOW_TEST_ASSERT_EQUAL_INT(
+		 "result",
+		 result,
+		 1 );
+
+		QCOW_TEST_ASSERT_IS_NULL(
+		 "error",
+		 error );
+
+		for( job_index = 0;
+		     job_index < QCOW_TEST_SCHEDULER_NUMBER_OF_JOBS;
+		     job_index++ )
+		{
+			QCOW_TEST_ASSERT_EQUAL_UINT8(
+			 "job_value",
+			 job_values[ job_index ],
+			 (uint8_t) 1 );
+		}
+		/* A job that fails is reported by the wait
+		 */
+		result = libqcow_scheduler_batch_push_job(
+		          scheduler_batch,
+		          &qcow_test_scheduler_job_callback,
+		          NULL,
+		          NULL,
+		          &error );
+
+		QCOW_TEST_ASSERT_EQUAL_INT(
+		 "result",
+		 result,
+		 1 );
+
+		QCOW_TEST_ASSERT_IS_NULL(
+		 "error",
+		 error );
+
+		result = libqcow_scheduler_batch_wait(
+		          scheduler_batch,
+		          &error );
+
+		QCOW_TEST_ASSERT_EQUAL_INT(
+		 "result",
+		 result,
+		 0 );
+
+		QCOW_TEST_ASSERT_IS_NULL(
+		 "error",
+		 error );
+
+		result = libqcow_scheduler_batch_free(
+		          &scheduler_batch,
+		          &error );
+
+		QCOW_TEST_ASSERT_EQUAL_INT(
+		 "result",
+		 result,
+		 1 );
+
+		QCOW_TEST_ASSERT_IS_NULL(
+		 "scheduler_batch",
+		 scheduler_batch );
+
+		QCOW_TEST_ASSERT_IS_NULL(
+		 "error",
+		 error );
+	}
+	/* Test error cases
+	 */
+	result = libqcow_scheduler_batch_initialize(
+	          NULL,
+	          scheduler,
+	          scheduler_queue,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_scheduler_batch_initialize(
+	          &scheduler_batch,
+	          scheduler,
+	          NULL,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "scheduler_batch",
+	 scheduler_batch );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_scheduler_batch_push_job(
+	          NULL,
+	          &qcow_test_scheduler_job_callback,
+	          (intptr_t *) &( job_values[ 0 ] ),
+	          NULL,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_scheduler_batch_wait(
+	          NULL,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	result = libqcow_scheduler_batch_free(
+	          NULL,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 -1 );
+
+	QCOW_TEST_ASSERT_IS_NOT_NULL(
+	 "error",
+	 error );
+
+	libcerror_error_free(
+	 &error );
+
+	/* Clean up
+	 */
+	result = libqcow_scheduler_wait_for_queue(
+	          scheduler,
+	          scheduler_queue,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_scheduler_queue_free(
+	          &scheduler_queue,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "scheduler_queue",
+	 scheduler_queue );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	result = libqcow_scheduler_free(
+	          &scheduler,
+	          &error );
+
+	QCOW_TEST_ASSERT_EQUAL_INT(
+	 "result",
+	 result,
+	 1 );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "scheduler",
+	 scheduler );
+
+	QCOW_TEST_ASSERT_IS_NULL(
+	 "error",
+	 error );
+
+	return( 1 );
+
+on_error:
+	if( error != NULL )
+	{
+		libcerror_error_free(
+		 &error );
+	}
+	if( scheduler_batch != NULL )
+	{
+		libqcow_scheduler_batch_free(
+		 &scheduler_batch,
+		 NULL );
+	}
+	if( scheduler != NULL )
+	{
+		if( scheduler_queue != NULL )
+		{
+			libqcow_scheduler_wait_for_queue(
+			 scheduler,
+			 scheduler_queue,
+			 NULL );
+		}
+		libqcow_scheduler_free(
+		 &scheduler,
+		 NULL );
+	}
+	if( scheduler_queue != NULL )
+	{
+		libqcow_scheduler_queue_free(
+		 &scheduler_queue,
+		 NULL );
+	}
+	return( 0 );
+}
+
+#endif /* defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT ) */
+
+/* The main program
+ */
+#if defined( HAVE_WIDE_SYSTEM_CHARACTER )
+int wmain(
+     int argc QCOW_TEST_ATTRIBUTE_UNUSED,
+     wchar_t * const argv[] QCOW_TEST_ATTRIBUTE_UNUSED )
+#else
+int main(
+     int argc QCOW_TEST_ATTRIBUTE_UNUSED,
+     char * const argv[] QCOW_TEST_ATTRIBUTE_UNUSED )
+#endif
+{
+	QCOW_TEST_UNREFERENCED_PARAMETER( argc )
+	QCOW_TEST_UNREFERENCED_PARAMETER( argv )
+
+	QCOW_TEST_RUN(
+	 "libqcow_scheduler_initialize",
+	 qcow_test_scheduler_initialize );
+
+	QCOW_TEST_RUN(
+	 "libqcow_scheduler_free",
+	 qcow_test_scheduler_free );
+
+	QCOW_TEST_RUN(
+	 "libqcow_scheduler_get_number_of_threads",
+	 qcow_test_scheduler_get_number_of_threads );
+
+#if defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT )
+
+	QCOW_TEST_RUN(
+	 "libqcow_scheduler_push_job",
+	 qcow_test_scheduler_push_job );
+
+	QCOW_TEST_RUN(
+	 "libqcow_scheduler_batch",
+	 qcow_test_scheduler_batch );
+
+#endif /* defined( __GNUC__ ) && !defined( LIBQCOW_DLL_IMPORT ) */
+
+	return( EXIT_SUCCESS );
+
+on_error:
+	return( EXIT_FAILURE );
+}
+
@@ -1,6 +1,6 @@
 # Tests library functions and types.
 
-$LibraryTests = "bit_stream cluster_block cluster_table deflate error file_header huffman_tree io_handle notify"
+$LibraryTests = "bit_stream cache_pool chain_index changed_extents cluster_block cluster_table deflate error export_writer extent_index file_header file_io_pool huffman_tree io_handle mapped_file mapping_index notify read_control scanner scheduler snapshot_values"
 $LibraryTestsWithInput = "file support"
 $OptionSets = "" -split " "
 